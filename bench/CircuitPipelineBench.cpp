@@ -0,0 +1,101 @@
+#include <thread>
+#include <benchmark/benchmark.h>
+
+#include <chowdsp_wdf/util/circuit_pipeline.h>
+
+#include "PerfCounters.h"
+#include "SyntheticCircuits.h"
+
+/**
+ * Measures the throughput of a heavy chain of circuits, processed in series
+ * on one thread, or with each stage on its own thread using the CircuitPipeline.
+ */
+namespace
+{
+namespace wdft = chowdsp::wdft;
+
+constexpr int blockSize = 256;
+constexpr int numStages = 4;
+
+template <uint32_t Seed>
+struct Stage
+{
+    Stage() { circuit.prepare (48000.0f); }
+
+    void processBlock (float* buffer, int numSamples) noexcept
+    {
+        for (int n = 0; n < numSamples; ++n)
+            buffer[n] = circuit.processSample (buffer[n]);
+    }
+
+    synthetic_circuits::SyntheticCircuitT<float, 64, Seed> circuit;
+};
+
+struct Chain
+{
+    Stage<1> stage1;
+    Stage<2> stage2;
+    Stage<3> stage3;
+    Stage<4> stage4;
+};
+
+void fillInput (float* buffer) noexcept
+{
+    for (int n = 0; n < blockSize; ++n)
+        buffer[n] = (n & 32) == 0 ? 0.5f : -0.5f;
+}
+
+void serialChain (benchmark::State& state)
+{
+    Chain chain;
+    float buffer[blockSize];
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        fillInput (buffer);
+        chain.stage1.processBlock (buffer, blockSize);
+        chain.stage2.processBlock (buffer, blockSize);
+        chain.stage3.processBlock (buffer, blockSize);
+        chain.stage4.processBlock (buffer, blockSize);
+        benchmark::DoNotOptimize (buffer);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+
+void pipelinedChain (benchmark::State& state)
+{
+    if (std::thread::hardware_concurrency() < numStages + 1)
+    {
+        state.SkipWithError ("Not enough cores!");
+        return;
+    }
+
+    Chain chain;
+    wdft::CircuitPipeline<float> pipeline { blockSize, (int) state.range (0) };
+    pipeline.addStage (chain.stage1);
+    pipeline.addStage (chain.stage2);
+    pipeline.addStage (chain.stage3);
+    pipeline.addStage (chain.stage4);
+    pipeline.start();
+
+    float buffer[blockSize];
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        fillInput (buffer);
+        pipeline.process (buffer, blockSize);
+        benchmark::DoNotOptimize (buffer);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+    state.counters["latency"] = (double) pipeline.getLatencySamples();
+    state.counters["late_blocks"] = (double) pipeline.getNumLateBlocks();
+}
+} // namespace
+
+BENCHMARK (serialChain)->MinTime (0.5)->UseRealTime();
+BENCHMARK (pipelinedChain)->ArgName ("extra_blocks")->Arg (0)->Arg (1)->Arg (4)->MinTime (0.5)->UseRealTime();
+
+BENCHMARK_MAIN();
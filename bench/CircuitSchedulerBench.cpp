@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <benchmark/benchmark.h>
+
+#include <chowdsp_wdf/util/circuit_scheduler.h>
+
+#include "PerfCounters.h"
+#include "SyntheticCircuits.h"
+
+/**
+ * Measures the throughput of processing many independent circuits (e.g. one per
+ * voice) with the CircuitScheduler, for different numbers of worker threads.
+ * Worker thread counts beyond the number of available cores are skipped.
+ *
+ * The blocks are processed back-to-back, and with a gap between blocks (like the
+ * gaps between audio callbacks), where only the processing time is measured. With
+ * gaps, the workers have gone idle by the time each block starts, so this also
+ * measures how quickly they wake up.
+ */
+namespace
+{
+namespace wdft = chowdsp::wdft;
+
+constexpr int blockSize = 256;
+constexpr size_t numVoices = 256;
+
+struct Voice
+{
+    void processBlock (int numSamples) noexcept
+    {
+        for (int n = 0; n < numSamples; ++n)
+            buffer[n] = circuit.processSample ((n & 32) == 0 ? 0.5f : -0.5f);
+    }
+
+    synthetic_circuits::SyntheticCircuitT<float, 16> circuit;
+    float buffer[blockSize] {};
+};
+
+bool hasEnoughCores (benchmark::State& state, int numWorkerThreads)
+{
+    if ((unsigned) numWorkerThreads < std::max (1U, std::thread::hardware_concurrency()))
+        return true;
+
+    state.SkipWithError ("Not enough cores!");
+    return false;
+}
+
+void prepareVoices (wdft::CacheLineSeparatedArray<Voice>& voices, wdft::CircuitScheduler& scheduler)
+{
+    for (size_t i = 0; i < voices.size(); ++i)
+    {
+        voices[i].circuit.prepare (48000.0f);
+        scheduler.addProcessor (voices[i]);
+    }
+}
+
+void processVoices (benchmark::State& state)
+{
+    const auto numWorkerThreads = (int) state.range (0);
+    if (! hasEnoughCores (state, numWorkerThreads))
+        return;
+
+    wdft::CacheLineSeparatedArray<Voice> voices { numVoices };
+    wdft::CircuitScheduler scheduler { numWorkerThreads, numVoices };
+    prepareVoices (voices, scheduler);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+        scheduler.process (blockSize);
+
+    // items = samples (for all voices)
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize * (int64_t) numVoices);
+}
+
+void processVoicesWithGaps (benchmark::State& state)
+{
+    const auto numWorkerThreads = (int) state.range (0);
+    const auto gap = std::chrono::microseconds (state.range (1));
+    if (! hasEnoughCores (state, numWorkerThreads))
+        return;
+
+    wdft::CacheLineSeparatedArray<Voice> voices { numVoices };
+    wdft::CircuitScheduler scheduler { numWorkerThreads, numVoices };
+    prepareVoices (voices, scheduler);
+
+    for (auto _ : state)
+    {
+        std::this_thread::sleep_for (gap);
+
+        const auto start = std::chrono::steady_clock::now();
+        scheduler.process (blockSize);
+        state.SetIterationTime (std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count());
+    }
+
+    // items = samples (for all voices)
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize * (int64_t) numVoices);
+}
+} // namespace
+
+BENCHMARK (processVoices)->ArgName ("workers")->Arg (0)->Arg (1)->Arg (3)->Arg (7)->Arg (15)->Arg (31)->MinTime (0.5)->UseRealTime();
+BENCHMARK (processVoicesWithGaps)->ArgNames ({ "workers", "gap_us" })->ArgsProduct ({ { 0, 1, 3, 7, 15, 31 }, { 2000 } })->MinTime (0.5)->UseManualTime();
+
+BENCHMARK_MAIN();
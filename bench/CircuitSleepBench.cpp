@@ -0,0 +1,62 @@
+#include <cmath>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "DiodeClipper.h"
+#include "PerfCounters.h"
+
+/**
+ * Measures the cost of a channel strip (a diode clipper), with and without
+ * wdft::CircuitSleepMode (items = samples).
+ *
+ * - <Input>NoSleep processes every block through the circuit.
+ * - <Input>Sleep processes the blocks through CircuitSleepMode, which skips the
+ *   circuit while it is asleep.
+ *
+ * The Silence benchmarks measure the cost of an idle channel, while the Signal
+ * benchmarks measure the overhead of checking for silence on an active channel.
+ */
+namespace
+{
+namespace wdft = chowdsp::wdft;
+
+constexpr int blockSize = 512;
+constexpr float fs = 48000.0f;
+
+template <bool useSleepMode, bool silentInput>
+void circuitSleep (benchmark::State& state)
+{
+    DiodeClipper<float> circuit { (double) fs };
+    wdft::CircuitSleepMode sleepMode;
+
+    std::vector<float> input ((size_t) blockSize, 0.0f);
+    if (! silentInput)
+        for (int n = 0; n < blockSize; ++n)
+            input[(size_t) n] = std::sin (0.03f * (float) n);
+    std::vector<float> buffer ((size_t) blockSize);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        std::copy (input.begin(), input.end(), buffer.begin());
+        if (useSleepMode)
+            sleepMode.process (circuit.getRoot(), buffer.data(), blockSize, [&circuit] (float* data, int numSamples)
+                               { circuit.processBlock (data, numSamples); });
+        else
+            circuit.processBlock (buffer.data(), blockSize);
+
+        benchmark::DoNotOptimize (buffer[0]);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+} // namespace
+
+#define CIRCUIT_SLEEP_BENCHMARKS(Input, silentInput)                                                                   \
+    BENCHMARK_TEMPLATE (circuitSleep, false, silentInput)->Name ("circuitSleep/" #Input "NoSleep")->MinTime (0.5); \
+    BENCHMARK_TEMPLATE (circuitSleep, true, silentInput)->Name ("circuitSleep/" #Input "Sleep")->MinTime (0.5);
+
+CIRCUIT_SLEEP_BENCHMARKS (Silence, true)
+CIRCUIT_SLEEP_BENCHMARKS (Signal, false)
+
+BENCHMARK_MAIN();
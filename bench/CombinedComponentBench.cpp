@@ -0,0 +1,211 @@
+#include <cmath>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include <chowdsp_wdf/chowdsp_wdf.h>
+
+#include "PerfCounters.h"
+
+/**
+ * Measures the cost of the fused one-port elements (e.g. ResistorInductorSeriesT),
+ * compared to the equivalent tree of elements and adaptors.
+ *
+ * Each one-port is driven by an ideal voltage source, and the benchmarks come in
+ * pairs: <Element>Tree uses the separate elements and adaptors, and <Element>Fused
+ * uses the fused element (items = samples). The <Element>String benchmarks compare
+ * a chain of 3-port adaptors to a single N-port adaptor (WDFSeriesNT/WDFParallelNT).
+ */
+namespace
+{
+namespace wdft = chowdsp::wdft;
+
+constexpr int blockSize = 512;
+constexpr float fs = 48000.0f;
+
+struct RLSeriesTree
+{
+    wdft::ResistorT<float> r { 1.0e3f };
+    wdft::InductorT<float> l { 10.0e-3f, fs };
+    wdft::WDFSeriesT<float, decltype (r), decltype (l)> port { r, l };
+};
+
+struct RLSeriesFused
+{
+    wdft::ResistorInductorSeriesT<float> port { 1.0e3f, 10.0e-3f, fs };
+};
+
+struct RLParallelTree
+{
+    wdft::ResistorT<float> r { 1.0e3f };
+    wdft::InductorT<float> l { 10.0e-3f, fs };
+    wdft::WDFParallelT<float, decltype (r), decltype (l)> port { r, l };
+};
+
+struct RLParallelFused
+{
+    wdft::ResistorInductorParallelT<float> port { 1.0e3f, 10.0e-3f, fs };
+};
+
+struct LCSeriesTree
+{
+    wdft::InductorT<float> l { 10.0e-3f, fs };
+    wdft::CapacitorT<float> c { 1.0e-6f, fs };
+    wdft::WDFSeriesT<float, decltype (l), decltype (c)> port { l, c };
+};
+
+struct LCSeriesFused
+{
+    wdft::InductorCapacitorSeriesT<float> port { 10.0e-3f, 1.0e-6f, fs };
+};
+
+struct LCParallelTree
+{
+    wdft::InductorT<float> l { 10.0e-3f, fs };
+    wdft::CapacitorT<float> c { 1.0e-6f, fs };
+    wdft::WDFParallelT<float, decltype (l), decltype (c)> port { l, c };
+};
+
+struct LCParallelFused
+{
+    wdft::InductorCapacitorParallelT<float> port { 10.0e-3f, 1.0e-6f, fs };
+};
+
+struct RLCSeriesTree
+{
+    wdft::ResistorT<float> r { 100.0f };
+    wdft::InductorT<float> l { 10.0e-3f, fs };
+    wdft::CapacitorT<float> c { 1.0e-6f, fs };
+    wdft::WDFSeriesT<float, decltype (l), decltype (c)> lc { l, c };
+    wdft::WDFSeriesT<float, decltype (r), decltype (lc)> port { r, lc };
+};
+
+struct RLCSeriesFused
+{
+    wdft::ResistorInductorCapacitorSeriesT<float> port { 100.0f, 10.0e-3f, 1.0e-6f, fs };
+};
+
+struct RCCurrentSourceTree
+{
+    RCCurrentSourceTree() { is.setCurrent (1.0e-3f); }
+
+    wdft::ResistiveCurrentSourceT<float> is { 2.0e3f };
+    wdft::CapacitorT<float> c { 1.0e-6f, fs };
+    wdft::WDFParallelT<float, decltype (is), decltype (c)> port { is, c };
+};
+
+struct RCCurrentSourceFused
+{
+    RCCurrentSourceFused() { port.setCurrent (1.0e-3f); }
+
+    wdft::ResistiveCapacitiveCurrentSourceT<float> port { 2.0e3f, 1.0e-6f, fs };
+};
+
+struct CapacitorESRTree
+{
+    wdft::ResistorT<float> esr { 0.5f };
+    wdft::CapacitorT<float> c { 100.0e-6f, fs };
+    wdft::ResistorT<float> leakage { 1.0e6f };
+    wdft::WDFParallelT<float, decltype (c), decltype (leakage)> leakyCap { c, leakage };
+    wdft::WDFSeriesT<float, decltype (esr), decltype (leakyCap)> port { esr, leakyCap };
+};
+
+struct CapacitorESRFused
+{
+    wdft::CapacitorESRT<float> port { 100.0e-6f, 0.5f, fs, 1.0e6f };
+};
+
+// a string of six elements, connected with nested 3-port adaptors, or a single N-port adaptor
+struct SeriesStringTree
+{
+    wdft::ResistorT<float> r1 { 1.0e3f };
+    wdft::CapacitorT<float> c1 { 1.0e-6f, fs };
+    wdft::InductorT<float> l1 { 10.0e-3f, fs };
+    wdft::ResistorT<float> r2 { 4.7e3f };
+    wdft::CapacitorT<float> c2 { 47.0e-9f, fs };
+    wdft::InductorT<float> l2 { 1.0e-3f, fs };
+    wdft::WDFSeriesT<float, decltype (c2), decltype (l2)> s1 { c2, l2 };
+    wdft::WDFSeriesT<float, decltype (r2), decltype (s1)> s2 { r2, s1 };
+    wdft::WDFSeriesT<float, decltype (l1), decltype (s2)> s3 { l1, s2 };
+    wdft::WDFSeriesT<float, decltype (c1), decltype (s3)> s4 { c1, s3 };
+    wdft::WDFSeriesT<float, decltype (r1), decltype (s4)> port { r1, s4 };
+};
+
+struct SeriesStringFused
+{
+    wdft::ResistorT<float> r1 { 1.0e3f };
+    wdft::CapacitorT<float> c1 { 1.0e-6f, fs };
+    wdft::InductorT<float> l1 { 10.0e-3f, fs };
+    wdft::ResistorT<float> r2 { 4.7e3f };
+    wdft::CapacitorT<float> c2 { 47.0e-9f, fs };
+    wdft::InductorT<float> l2 { 1.0e-3f, fs };
+    wdft::WDFSeriesNT<float, decltype (r1), decltype (c1), decltype (l1), decltype (r2), decltype (c2), decltype (l2)> port { r1, c1, l1, r2, c2, l2 };
+};
+
+struct ParallelStringTree
+{
+    wdft::ResistorT<float> r1 { 1.0e3f };
+    wdft::CapacitorT<float> c1 { 1.0e-6f, fs };
+    wdft::InductorT<float> l1 { 10.0e-3f, fs };
+    wdft::ResistorT<float> r2 { 4.7e3f };
+    wdft::CapacitorT<float> c2 { 47.0e-9f, fs };
+    wdft::InductorT<float> l2 { 1.0e-3f, fs };
+    wdft::WDFParallelT<float, decltype (c2), decltype (l2)> p1 { c2, l2 };
+    wdft::WDFParallelT<float, decltype (r2), decltype (p1)> p2 { r2, p1 };
+    wdft::WDFParallelT<float, decltype (l1), decltype (p2)> p3 { l1, p2 };
+    wdft::WDFParallelT<float, decltype (c1), decltype (p3)> p4 { c1, p3 };
+    wdft::WDFParallelT<float, decltype (r1), decltype (p4)> port { r1, p4 };
+};
+
+struct ParallelStringFused
+{
+    wdft::ResistorT<float> r1 { 1.0e3f };
+    wdft::CapacitorT<float> c1 { 1.0e-6f, fs };
+    wdft::InductorT<float> l1 { 10.0e-3f, fs };
+    wdft::ResistorT<float> r2 { 4.7e3f };
+    wdft::CapacitorT<float> c2 { 47.0e-9f, fs };
+    wdft::InductorT<float> l2 { 1.0e-3f, fs };
+    wdft::WDFParallelNT<float, decltype (r1), decltype (c1), decltype (l1), decltype (r2), decltype (c2), decltype (l2)> port { r1, c1, l1, r2, c2, l2 };
+};
+
+template <typename Circuit>
+void combinedComponent (benchmark::State& state)
+{
+    Circuit circuit;
+    wdft::IdealVoltageSourceT<float, decltype (circuit.port)> vs { circuit.port };
+
+    std::vector<float> input ((size_t) blockSize);
+    for (int n = 0; n < blockSize; ++n)
+        input[(size_t) n] = std::sin (0.03f * (float) n);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        for (int n = 0; n < blockSize; ++n)
+        {
+            vs.setVoltage (input[(size_t) n]);
+            vs.incident (circuit.port.reflected());
+            circuit.port.incident (vs.reflected());
+        }
+
+        benchmark::DoNotOptimize (circuit.port.wdf.b);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+} // namespace
+
+#define COMBINED_COMPONENT_BENCHMARKS(Element)                             \
+    BENCHMARK_TEMPLATE (combinedComponent, Element##Tree)->MinTime (0.5); \
+    BENCHMARK_TEMPLATE (combinedComponent, Element##Fused)->MinTime (0.5);
+
+COMBINED_COMPONENT_BENCHMARKS (RLSeries)
+COMBINED_COMPONENT_BENCHMARKS (RLParallel)
+COMBINED_COMPONENT_BENCHMARKS (LCSeries)
+COMBINED_COMPONENT_BENCHMARKS (LCParallel)
+COMBINED_COMPONENT_BENCHMARKS (RLCSeries)
+COMBINED_COMPONENT_BENCHMARKS (RCCurrentSource)
+COMBINED_COMPONENT_BENCHMARKS (CapacitorESR)
+COMBINED_COMPONENT_BENCHMARKS (SeriesString)
+COMBINED_COMPONENT_BENCHMARKS (ParallelString)
+
+BENCHMARK_MAIN();
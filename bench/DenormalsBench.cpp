@@ -0,0 +1,126 @@
+#include <limits>
+#include <benchmark/benchmark.h>
+
+#if CHOWDSP_WDF_TEST_WITH_XSIMD
+#include <xsimd/xsimd.hpp>
+#endif
+#include <chowdsp_wdf/chowdsp_wdf.h>
+
+#include "PerfCounters.h"
+
+/**
+ * Measures the cost of processing a WDF model whose states have decayed into the
+ * denormal range. The filter is excited by a tiny impulse, and then allowed to
+ * ring out for a block of silence.
+ *
+ * The same benchmarks are compiled into denormals_bench, and denormals_flush_bench
+ * (with CHOWDSP_WDF_FLUSH_DENORMALS enabled), so the two can be compared.
+ */
+namespace
+{
+namespace wdft = chowdsp::wdft;
+
+template <typename T>
+struct LowpassCascade
+{
+    wdft::ResistiveVoltageSourceT<T> vs { (T) 1.0e3 };
+    wdft::CapacitorT<T> c1 { (T) 33.0e-6 };
+    wdft::WDFParallelT<T, decltype (vs), decltype (c1)> p1 { vs, c1 };
+
+    wdft::ResistorT<T> r2 { (T) 1.0e3 };
+    wdft::WDFSeriesT<T, decltype (p1), decltype (r2)> s2 { p1, r2 };
+    wdft::CapacitorT<T> c2 { (T) 33.0e-6 };
+    wdft::WDFParallelT<T, decltype (s2), decltype (c2)> p2 { s2, c2 };
+
+    wdft::ResistorCapacitorSeriesT<T> rc3 { (T) 1.0e3, (T) 33.0e-6 };
+    wdft::WDFParallelT<T, decltype (p2), decltype (rc3)> p3 { p2, rc3 };
+
+    wdft::InductorT<T> l4 { (T) 10.0 };
+    wdft::WDFSeriesT<T, decltype (p3), decltype (l4)> s4 { p3, l4 };
+    wdft::ResistorT<T> r4 { (T) 1.0e3 };
+    wdft::WDFParallelT<T, decltype (s4), decltype (r4)> p4 { s4, r4 };
+
+    wdft::IdealCurrentSourceT<T, decltype (p4)> is { p4 };
+
+    void prepare (T fs)
+    {
+        c1.prepare (fs);
+        c2.prepare (fs);
+        rc3.prepare (fs);
+        l4.prepare (fs);
+    }
+
+    void reset()
+    {
+        c1.reset();
+        c2.reset();
+        rc3.reset();
+        l4.reset();
+    }
+
+    inline T processSample (T x) noexcept
+    {
+        vs.setVoltage (x);
+
+        is.incident (p4.reflected());
+        p4.incident (is.reflected());
+
+        return wdft::voltage<T> (r4);
+    }
+};
+
+constexpr int blockSize = 8192;
+
+template <typename T>
+void processDecay (LowpassCascade<T>& circuit, benchmark::State& state, T impulseLevel)
+{
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        circuit.reset();
+
+        auto y = circuit.processSample (impulseLevel);
+        for (int n = 1; n < blockSize; ++n)
+            y += circuit.processSample ((T) 0);
+
+        benchmark::DoNotOptimize (y);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+
+template <typename T>
+void normalDecay (benchmark::State& state)
+{
+    LowpassCascade<T> circuit;
+    circuit.prepare ((T) 48000);
+    processDecay<T> (circuit, state, (T) 1);
+}
+
+template <typename T>
+void denormalDecay (benchmark::State& state)
+{
+    LowpassCascade<T> circuit;
+    circuit.prepare ((T) 48000);
+    processDecay<T> (circuit, state, (T) 100 * std::numeric_limits<T>::min());
+}
+
+template <typename T>
+void denormalDecayScopedNoDenormals (benchmark::State& state)
+{
+    wdft::ScopedNoDenormals noDenormals;
+
+    LowpassCascade<T> circuit;
+    circuit.prepare ((T) 48000);
+    processDecay<T> (circuit, state, (T) 100 * std::numeric_limits<T>::min());
+}
+} // namespace
+
+BENCHMARK_TEMPLATE (normalDecay, float)->MinTime (1);
+BENCHMARK_TEMPLATE (denormalDecay, float)->MinTime (1);
+BENCHMARK_TEMPLATE (denormalDecayScopedNoDenormals, float)->MinTime (1);
+BENCHMARK_TEMPLATE (normalDecay, double)->MinTime (1);
+BENCHMARK_TEMPLATE (denormalDecay, double)->MinTime (1);
+BENCHMARK_TEMPLATE (denormalDecayScopedNoDenormals, double)->MinTime (1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,134 @@
+#include <string>
+#include <benchmark/benchmark.h>
+
+#if CHOWDSP_WDF_TEST_WITH_XSIMD
+#include <xsimd/xsimd.hpp>
+#endif
+#include <chowdsp_wdf/chowdsp_wdf.h>
+
+#include "PerfCounters.h"
+
+/**
+ * Uses the WDF instrumentation counters (compiled with CHOWDSP_WDF_INSTRUMENTATION enabled)
+ * to report how much work is done when each potentiometer in a circuit is changed, and
+ * where the time is spent when processing the circuit.
+ */
+namespace
+{
+namespace wdft = chowdsp::wdft;
+
+static_assert (CHOWDSP_WDF_INSTRUMENTATION, "This benchmark needs CHOWDSP_WDF_INSTRUMENTATION to be enabled!");
+
+/** A passive tone network feeding a diode clipper, with pots at different depths in the WDF tree */
+struct ToneClipper
+{
+    wdft::ResistiveVoltageSourceT<float> Vs { 4.7e3f };
+
+    wdft::ResistorT<float> deepPot { 10.0e3f };
+    wdft::CapacitorT<float> C3 { 22.0e-9f };
+    wdft::WDFSeriesT<float, decltype (deepPot), decltype (C3)> S1 { deepPot, C3 };
+    wdft::CapacitorT<float> C2 { 47.0e-9f };
+    wdft::WDFParallelT<float, decltype (S1), decltype (C2)> P1 { S1, C2 };
+
+    wdft::ResistorT<float> midPot { 25.0e3f };
+    wdft::WDFSeriesT<float, decltype (P1), decltype (midPot)> S2 { P1, midPot };
+    wdft::CapacitorT<float> C1 { 10.0e-9f };
+    wdft::WDFParallelT<float, decltype (S2), decltype (C1)> P2 { S2, C1 };
+
+    wdft::ResistorT<float> shallowPot { 50.0e3f };
+    wdft::WDFSeriesT<float, decltype (P2), decltype (shallowPot)> S3 { P2, shallowPot };
+    wdft::WDFParallelT<float, decltype (S3), decltype (Vs)> P3 { S3, Vs };
+
+    wdft::DiodePairT<float, decltype (P3)> dp { P3, 2.52e-9f };
+
+    void prepare (float fs)
+    {
+        C1.prepare (fs);
+        C2.prepare (fs);
+        C3.prepare (fs);
+    }
+
+    inline float processSample (float x) noexcept
+    {
+        Vs.setVoltage (x);
+
+        dp.incident (P3.reflected());
+        P3.incident (dp.reflected());
+
+        return wdft::voltage<float> (C1);
+    }
+};
+
+template <typename PotGetter>
+void potChange (benchmark::State& state, PotGetter&& getPot)
+{
+    ToneClipper circuit;
+    circuit.prepare (48000.0f);
+    auto& pot = getPot (circuit);
+    wdft::resetInstrumentationCounters (circuit.dp);
+
+    float potValue = 1.0e3f;
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        pot.setResistanceValue (potValue);
+        potValue = potValue > 50.0e3f ? 1.0e3f : potValue * 1.1f;
+    }
+
+    const auto counters = wdft::getTotalInstrumentationCounters (circuit.dp);
+    state.counters["calcImpedance"] = benchmark::Counter ((double) counters.calcImpedance, benchmark::Counter::kAvgIterations);
+    state.counters["propagations"] = benchmark::Counter ((double) counters.propagateImpedanceChange, benchmark::Counter::kAvgIterations);
+}
+
+void deepPotChange (benchmark::State& state)
+{
+    potChange (state, [] (ToneClipper& c) -> wdft::ResistorT<float>& { return c.deepPot; });
+}
+
+void midPotChange (benchmark::State& state)
+{
+    potChange (state, [] (ToneClipper& c) -> wdft::ResistorT<float>& { return c.midPot; });
+}
+
+void shallowPotChange (benchmark::State& state)
+{
+    potChange (state, [] (ToneClipper& c) -> wdft::ResistorT<float>& { return c.shallowPot; });
+}
+
+void processCircuit (benchmark::State& state)
+{
+    constexpr int blockSize = 1024;
+
+    ToneClipper circuit;
+    circuit.prepare (48000.0f);
+    wdft::resetInstrumentationCounters (circuit.dp);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        float y = 0.0f;
+        for (int n = 0; n < blockSize; ++n)
+            y += circuit.processSample (n % 64 < 32 ? 1.0f : -1.0f);
+
+        benchmark::DoNotOptimize (y);
+    }
+
+    // report the average cost of incident()/reflected() for each element, in visiting order
+    int elementIndex = 0;
+    wdft::forEachElement (circuit.dp,
+                          [&state, &elementIndex] (auto& element)
+                          {
+                              const auto counterName = (elementIndex < 10 ? "e0" : "e") + std::to_string (elementIndex) + "_cycles";
+                              state.counters[counterName] = wdft::getInstrumentationCounters (element).getAverageCycles();
+                              elementIndex++;
+                          });
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+} // namespace
+
+BENCHMARK (deepPotChange)->MinTime (1);
+BENCHMARK (midPotChange)->MinTime (1);
+BENCHMARK (shallowPotChange)->MinTime (1);
+BENCHMARK (processCircuit)->MinTime (1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,96 @@
+#include <cmath>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "BaxandallEQ.h"
+#include "PerfCounters.h"
+
+/**
+ * Measures the cost of a linear circuit (the Baxandall EQ), processed through the
+ * WDF, and through the equivalent wdft::LinearCircuitFilter (items = samples).
+ *
+ * - BaxandallCircuit processes every sample through the WDF.
+ * - BaxandallFilter processes every sample through the parallel second-order sections.
+ * - BaxandallUpdate measures the cost of a parameter change: setting the circuit parameters,
+ *   and re-analysing the circuit to update the filter.
+ */
+namespace
+{
+constexpr int blockSize = 512;
+constexpr double fs = 48000.0;
+
+std::vector<float> makeInput()
+{
+    std::vector<float> input ((size_t) blockSize);
+    for (int n = 0; n < blockSize; ++n)
+        input[(size_t) n] = std::sin (0.03f * (float) n);
+    return input;
+}
+
+void baxandallCircuit (benchmark::State& state)
+{
+    BaxandallWDF circuit;
+    circuit.prepare (fs);
+    circuit.setParams (0.3f, 0.8f);
+
+    const auto input = makeInput();
+    std::vector<float> buffer ((size_t) blockSize);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        for (int n = 0; n < blockSize; ++n)
+            buffer[(size_t) n] = circuit.processSample (input[(size_t) n]);
+        benchmark::DoNotOptimize (buffer[0]);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+
+void baxandallFilter (benchmark::State& state)
+{
+    BaxandallWDF circuit;
+    circuit.prepare (fs);
+    circuit.setParams (0.3f, 0.8f);
+
+    chowdsp::wdft::LinearCircuitFilter<float> filter;
+    filter.prepare (circuit.getRoot());
+    filter.update (circuit.getRoot(), [&circuit] (float x) { return circuit.processSample (x); });
+
+    const auto input = makeInput();
+    std::vector<float> buffer ((size_t) blockSize);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        std::copy (input.begin(), input.end(), buffer.begin());
+        filter.processBlock (buffer.data(), blockSize);
+        benchmark::DoNotOptimize (buffer[0]);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+
+void baxandallUpdate (benchmark::State& state)
+{
+    BaxandallWDF circuit;
+    circuit.prepare (fs);
+
+    chowdsp::wdft::LinearCircuitFilter<float> filter;
+    filter.prepare (circuit.getRoot());
+
+    float param = 0.0f;
+    for (auto _ : state)
+    {
+        param = param > 0.9f ? 0.0f : param + 0.01f;
+        circuit.setParams (param, 1.0f - param);
+        benchmark::DoNotOptimize (filter.update (circuit.getRoot(), [&circuit] (float x) { return circuit.processSample (x); }));
+    }
+}
+} // namespace
+
+BENCHMARK (baxandallCircuit)->Name ("linearCircuitFilter/BaxandallCircuit")->MinTime (0.5);
+BENCHMARK (baxandallFilter)->Name ("linearCircuitFilter/BaxandallFilter")->MinTime (0.5);
+BENCHMARK (baxandallUpdate)->Name ("linearCircuitFilter/BaxandallUpdate")->MinTime (0.5);
+
+BENCHMARK_MAIN();
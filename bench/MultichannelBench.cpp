@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "DiodeClipper.h"
+#include "PerfCounters.h"
+
+/**
+ * Measures the cost of processing multichannel buffers with SIMD circuits, with one
+ * channel per SIMD lane (items = samples per channel). The circuit is a diode clipper.
+ *
+ * - Glue loads one sample from each channel into the SIMD lanes, and stores them back
+ *   afterwards, for every sample (i.e. the hand-written approach).
+ * - Planar and Interleaved use wdft::processPlanar() and wdft::processInterleaved().
+ *
+ * When the benchmarks are built without XSIMD, the "SIMD" type is just float.
+ */
+namespace
+{
+namespace wdft = chowdsp::wdft;
+
+#if CHOWDSP_WDF_TEST_WITH_XSIMD
+using VectorType = xsimd::batch<float>;
+VectorType loadFrame (const float* frame) { return xsimd::load_aligned (frame); }
+void storeFrame (float* frame, VectorType x) { xsimd::store_aligned (frame, x); }
+#else
+using VectorType = float;
+float loadFrame (const float* frame) { return *frame; }
+void storeFrame (float* frame, float x) { *frame = x; }
+#endif
+constexpr int lanes = wdft::getNumChannelsPerVector<VectorType>();
+
+constexpr int blockSize = 512;
+
+struct Buffers
+{
+    explicit Buffers (int numChannels)
+        : planar ((size_t) numChannels, std::vector<float> ((size_t) blockSize)),
+          interleaved ((size_t) (numChannels * blockSize)),
+          circuits ((size_t) wdft::getNumVectorGroups<VectorType> (numChannels))
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            channels.push_back (planar[(size_t) ch].data());
+            for (int n = 0; n < blockSize; ++n)
+            {
+                planar[(size_t) ch][(size_t) n] = std::sin (0.01f * (float) ((ch + 1) * n));
+                interleaved[(size_t) (n * numChannels + ch)] = planar[(size_t) ch][(size_t) n];
+            }
+        }
+    }
+
+    std::vector<std::vector<float>> planar;
+    std::vector<float*> channels;
+    std::vector<float> interleaved;
+    std::vector<DiodeClipper<VectorType>> circuits;
+};
+
+void multichannelGlue (benchmark::State& state)
+{
+    const auto numChannels = (int) state.range (0);
+    Buffers buffers { numChannels };
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        for (int group = 0; group * lanes < numChannels; ++group)
+        {
+            auto** channels = buffers.channels.data() + group * lanes;
+            const auto groupChannels = std::min (lanes, numChannels - group * lanes);
+            for (int n = 0; n < blockSize; ++n)
+            {
+                alignas (alignof (VectorType)) float frame[lanes] {};
+                for (int lane = 0; lane < groupChannels; ++lane)
+                    frame[lane] = channels[lane][n];
+
+                storeFrame (frame, buffers.circuits[(size_t) group].processSample (loadFrame (frame)));
+
+                for (int lane = 0; lane < groupChannels; ++lane)
+                    channels[lane][n] = frame[lane];
+            }
+        }
+
+        benchmark::DoNotOptimize (buffers.planar[0][0]);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+
+void multichannelPlanar (benchmark::State& state)
+{
+    const auto numChannels = (int) state.range (0);
+    Buffers buffers { numChannels };
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        wdft::processPlanar<VectorType> (buffers.channels.data(), numChannels, blockSize, [&buffers] (int group, VectorType x)
+                                         { return buffers.circuits[(size_t) group].processSample (x); });
+
+        benchmark::DoNotOptimize (buffers.planar[0][0]);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+
+void multichannelInterleaved (benchmark::State& state)
+{
+    const auto numChannels = (int) state.range (0);
+    Buffers buffers { numChannels };
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        wdft::processInterleaved<VectorType> (buffers.interleaved.data(), numChannels, blockSize, [&buffers] (int group, VectorType x)
+                                              { return buffers.circuits[(size_t) group].processSample (x); });
+
+        benchmark::DoNotOptimize (buffers.interleaved[0]);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+} // namespace
+
+BENCHMARK (multichannelGlue)->Arg (2)->Arg (4)->Arg (8)->MinTime (0.5);
+BENCHMARK (multichannelPlanar)->Arg (2)->Arg (4)->Arg (8)->MinTime (0.5);
+BENCHMARK (multichannelInterleaved)->Arg (2)->Arg (4)->Arg (8)->MinTime (0.5);
+
+BENCHMARK_MAIN();
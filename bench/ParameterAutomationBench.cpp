@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+
+#include "BassmanToneStack.h"
+#include "BassmanToneStackPoly.h"
+#include "BaxandallEQ.h"
+#include "BaxandallEQPoly.h"
+#include "PerfCounters.h"
+
+#include <chowdsp_wdf/rtype/async_root_rtype_adaptor.h>
+
+/**
+ * Measures the cost of automating the pots in circuits with R-Type adaptors.
+ *
+ * - paramUpdate measures the cost of a single parameter update (items = updates).
+ * - automation processes a block of audio, while updating the parameters every
+ *   state.range (0) samples (0 = no updates, so the per-sample cost can be compared).
+ *
+ * Each benchmark is run for the wdft and wdf flavours of the Baxandall EQ and Bassman
+ * tonestack, with and without ScopedDeferImpedancePropagation. Note that in the wdf
+ * flavour the impedance propagation does not continue into the R-Type adaptor
+ * (and does not respect the deferral), so both variants do roughly the same work.
+ *
+ * TonestackAsync computes the R-Type scattering matrix on a background thread, so
+ * paramUpdate only measures the cost of handing the new impedances over to that thread.
+ * TonestackIncremental computes the scattering matrix from the R-Type topology, and
+ * updates it with rank-1 updates as each pot changes. TonestackPolyFixedSize is the wdf
+ * Bassman tonestack, using a FixedSizeRootRtypeAdaptor in place of the RootRtypeAdaptor.
+ */
+namespace
+{
+constexpr int blockSize = 512;
+constexpr double fs = 48000.0;
+
+void setParams (BaxandallWDF& circuit, float param, bool defer) { circuit.setParams (param, 1.0f - param, defer); }
+void setParams (BaxandallWDFPoly& circuit, float param, bool defer) { circuit.setParams (param, 1.0f - param, defer); }
+using TonestackAsync = Tonestack<float, chowdsp::wdft::AsyncRootRtypeAdaptor>;
+using TonestackIncremental = Tonestack<float, chowdsp::wdft::IncrementalRootRtypeAdaptor>;
+using TonestackPolyFixedSize = TonestackPoly<float, chowdsp::wdf::FixedSizeRootRtypeAdaptor<float, 6>>;
+
+void setParams (Tonestack<float>& circuit, float param, bool defer) { circuit.setParams (param, 1.0f - param, 0.5f * param, defer); }
+void setParams (TonestackPoly<float>& circuit, float param, bool defer) { circuit.setParams (param, 1.0f - param, 0.5f * param, defer); }
+void setParams (TonestackAsync& circuit, float param, bool defer) { circuit.setParams (param, 1.0f - param, 0.5f * param, defer); }
+void setParams (TonestackIncremental& circuit, float param, bool defer) { circuit.setParams (param, 1.0f - param, 0.5f * param, defer); }
+void setParams (TonestackPolyFixedSize& circuit, float param, bool defer) { circuit.setParams (param, 1.0f - param, 0.5f * param, defer); }
+
+/** A slow triangle wave, to sweep the pots back and forth */
+struct ParamSweep
+{
+    float next() noexcept
+    {
+        value += increment;
+        if (value > 0.9f || value < 0.1f)
+            increment = -increment;
+        return value;
+    }
+
+    float value = 0.5f;
+    float increment = 1.0e-3f;
+};
+
+template <typename Circuit>
+void prepareCircuit (Circuit& circuit)
+{
+    circuit.prepare (fs);
+    setParams (circuit, 0.5f, true);
+}
+
+template <typename Circuit, bool Defer>
+void paramUpdate (benchmark::State& state)
+{
+    Circuit circuit;
+    prepareCircuit (circuit);
+
+    ParamSweep sweep;
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        setParams (circuit, sweep.next(), Defer);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations());
+}
+
+template <typename Circuit, bool Defer>
+void automation (benchmark::State& state)
+{
+    const auto updateInterval = (int) state.range (0);
+
+    Circuit circuit;
+    prepareCircuit (circuit);
+
+    ParamSweep sweep;
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        float y = 0.0f;
+        for (int n = 0; n < blockSize; ++n)
+        {
+            if (updateInterval > 0 && n % updateInterval == 0)
+                setParams (circuit, sweep.next(), Defer);
+
+            y += (float) circuit.processSample ((n & 64) == 0 ? 0.5f : -0.5f);
+        }
+
+        benchmark::DoNotOptimize (y);
+    }
+
+    // items = samples, so the per-sample cost is 1 / items_per_second
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+    state.counters["updates_per_block"] = updateInterval > 0 ? (double) ((blockSize + updateInterval - 1) / updateInterval) : 0.0;
+}
+
+void automationArgs (benchmark::internal::Benchmark* b)
+{
+    b->ArgName ("interval")->Arg (0)->Arg (1)->Arg (16)->Arg (blockSize)->MinTime (0.5);
+}
+} // namespace
+
+#define PARAM_AUTOMATION_BENCHMARKS(Circuit)                       \
+    BENCHMARK_TEMPLATE (paramUpdate, Circuit, true)->MinTime (0.5);  \
+    BENCHMARK_TEMPLATE (paramUpdate, Circuit, false)->MinTime (0.5); \
+    BENCHMARK_TEMPLATE (automation, Circuit, true)->Apply (automationArgs); \
+    BENCHMARK_TEMPLATE (automation, Circuit, false)->Apply (automationArgs);
+
+PARAM_AUTOMATION_BENCHMARKS (BaxandallWDF)
+PARAM_AUTOMATION_BENCHMARKS (BaxandallWDFPoly)
+PARAM_AUTOMATION_BENCHMARKS (Tonestack<float>)
+PARAM_AUTOMATION_BENCHMARKS (TonestackPoly<float>)
+PARAM_AUTOMATION_BENCHMARKS (TonestackAsync)
+PARAM_AUTOMATION_BENCHMARKS (TonestackIncremental)
+PARAM_AUTOMATION_BENCHMARKS (TonestackPolyFixedSize)
+
+BENCHMARK_MAIN();
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <benchmark/benchmark.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define CHOWDSP_WDF_BENCH_PERF_EVENTS 1
+#else
+#define CHOWDSP_WDF_BENCH_PERF_EVENTS 0
+#endif
+
+/**
+ * Hardware performance counters for the benchmarks, using perf_event_open (Linux only).
+ *
+ * Each counter is opened separately, so if the CPU (or VM) doesn't support one of the events,
+ * the others are still reported. If no counters are available (not running on Linux, or blocked
+ * by /proc/sys/kernel/perf_event_paranoid), or if the CHOWDSP_WDF_BENCH_PERF_COUNTERS environment
+ * variable is set to 0, nothing is reported, and the benchmarks run as usual.
+ */
+namespace perf_counters
+{
+enum class Event
+{
+    Cycles,
+    Instructions,
+    L1DMisses,
+    LLCMisses,
+    BranchMisses,
+};
+
+constexpr size_t numEvents = 5;
+
+/** Returns the name used to report the event as a benchmark counter */
+inline const char* getEventName (Event event) noexcept
+{
+    switch (event)
+    {
+        case Event::Cycles:
+            return "cycles";
+        case Event::Instructions:
+            return "instructions";
+        case Event::L1DMisses:
+            return "L1D_misses";
+        case Event::LLCMisses:
+            return "LLC_misses";
+        case Event::BranchMisses:
+        default:
+            return "branch_misses";
+    }
+}
+
+/** A set of hardware performance counters, measuring the calling thread (user-space only). */
+class PerfCounters
+{
+public:
+    PerfCounters()
+    {
+        fds.fill (-1);
+
+        const auto* enableVar = std::getenv ("CHOWDSP_WDF_BENCH_PERF_COUNTERS");
+        if (enableVar != nullptr && std::strcmp (enableVar, "0") == 0)
+            return;
+
+        for (size_t i = 0; i < numEvents; ++i)
+            fds[i] = openEvent ((Event) i);
+    }
+
+    ~PerfCounters()
+    {
+#if CHOWDSP_WDF_BENCH_PERF_EVENTS
+        for (auto fd : fds)
+            if (fd >= 0)
+                close (fd);
+#endif
+    }
+
+    PerfCounters (const PerfCounters&) = delete;
+    PerfCounters& operator= (const PerfCounters&) = delete;
+
+    /** Returns true if the given event can be measured */
+    bool isAvailable (Event event) const noexcept { return fds[(size_t) event] >= 0; }
+
+    /** Returns true if any of the events can be measured */
+    bool isAvailable() const noexcept
+    {
+        for (size_t i = 0; i < numEvents; ++i)
+            if (isAvailable ((Event) i))
+                return true;
+        return false;
+    }
+
+    /** Resets and starts the counters */
+    void start() noexcept
+    {
+#if CHOWDSP_WDF_BENCH_PERF_EVENTS
+        for (auto fd : fds)
+        {
+            if (fd >= 0)
+            {
+                ioctl (fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl (fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /** Stops the counters, and reads their values */
+    void stop() noexcept
+    {
+#if CHOWDSP_WDF_BENCH_PERF_EVENTS
+        for (auto fd : fds)
+            if (fd >= 0)
+                ioctl (fd, PERF_EVENT_IOC_DISABLE, 0);
+
+        for (size_t i = 0; i < numEvents; ++i)
+        {
+            values[i] = 0.0;
+            if (fds[i] < 0)
+                continue;
+
+            // value, time enabled, time running
+            uint64_t readData[3] {};
+            if (read (fds[i], readData, sizeof (readData)) != (ssize_t) sizeof (readData) || readData[2] == 0)
+                continue;
+
+            // if there are more events than hardware counters, the kernel multiplexes them, so scale up the count
+            values[i] = (double) readData[0] * ((double) readData[1] / (double) readData[2]);
+        }
+#endif
+    }
+
+    /** Returns the count for the given event, between the last calls to start() and stop() */
+    double getValue (Event event) const noexcept { return values[(size_t) event]; }
+
+private:
+    static int openEvent (Event event) noexcept
+    {
+#if CHOWDSP_WDF_BENCH_PERF_EVENTS
+        perf_event_attr attr;
+        std::memset (&attr, 0, sizeof (attr));
+        attr.size = sizeof (attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        const auto cacheMiss = [] (uint64_t cache)
+        { return cache | ((uint64_t) PERF_COUNT_HW_CACHE_OP_READ << 8) | ((uint64_t) PERF_COUNT_HW_CACHE_RESULT_MISS << 16); };
+
+        switch (event)
+        {
+            case Event::Cycles:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case Event::Instructions:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case Event::L1DMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cacheMiss (PERF_COUNT_HW_CACHE_L1D);
+                break;
+            case Event::LLCMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cacheMiss (PERF_COUNT_HW_CACHE_LL);
+                break;
+            case Event::BranchMisses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+        }
+
+        return (int) syscall (SYS_perf_event_open, &attr, 0 /* this thread */, -1 /* any CPU */, -1 /* no group */, 0);
+#else
+        (void) event;
+        return -1;
+#endif
+    }
+
+    std::array<int, numEvents> fds {};
+    std::array<double, numEvents> values {};
+};
+
+/**
+ * Measures the hardware performance counters from construction until the end of the
+ * scope, and reports them as custom counters for the benchmark. Create this just before
+ * the benchmark loop:
+ * ```cpp
+ * perf_counters::ScopedPerfCounters perfCounters { state };
+ * for (auto _ : state)
+ *     ...
+ * state.SetItemsProcessed (...);
+ * ```
+ *
+ * If the benchmark sets the number of items processed (e.g. samples), the counters are
+ * reported per item, otherwise they are reported per iteration. The instructions per cycle
+ * are reported as "IPC".
+ */
+class ScopedPerfCounters
+{
+public:
+    explicit ScopedPerfCounters (benchmark::State& benchState) : state (benchState)
+    {
+        counters.start();
+    }
+
+    ~ScopedPerfCounters()
+    {
+        counters.stop();
+        if (! counters.isAvailable())
+            return;
+
+        const auto numItems = state.items_processed();
+        for (size_t i = 0; i < numEvents; ++i)
+        {
+            const auto event = (Event) i;
+            if (! counters.isAvailable (event))
+                continue;
+
+            const auto value = counters.getValue (event);
+            state.counters[getEventName (event)] = numItems > 0
+                                                       ? benchmark::Counter (value / (double) numItems)
+                                                       : benchmark::Counter (value, benchmark::Counter::kAvgIterations);
+        }
+
+        if (counters.isAvailable (Event::Cycles) && counters.isAvailable (Event::Instructions) && counters.getValue (Event::Cycles) > 0.0)
+            state.counters["IPC"] = counters.getValue (Event::Instructions) / counters.getValue (Event::Cycles);
+    }
+
+private:
+    benchmark::State& state;
+    PerfCounters counters;
+};
+} // namespace perf_counters
@@ -0,0 +1,132 @@
+#include <cmath>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include <chowdsp_wdf/chowdsp_wdf.h>
+
+#include "PerfCounters.h"
+
+/**
+ * Measures the cost of metering several internal voltages and currents of a circuit
+ * (a diode clipper with an RC input filter), for every sample (items = samples).
+ *
+ * - NoProbes processes the circuit without any metering.
+ * - ManualProbes probes the elements by hand, into an array of per-sample structs.
+ * - ProbeRecorder records the same probes with wdft::ProbeRecorder.
+ */
+namespace
+{
+namespace wdft = chowdsp::wdft;
+
+constexpr int blockSize = 512;
+constexpr float fs = 48000.0f;
+
+struct Circuit
+{
+    float processSample (float x) noexcept
+    {
+        Vs.setVoltage (x);
+        dp.incident (P2.reflected());
+        P2.incident (dp.reflected());
+        return wdft::voltage<float> (C2);
+    }
+
+    wdft::ResistiveVoltageSourceT<float> Vs { 1000.0f };
+    wdft::CapacitorT<float> C1 { 1.0e-6f, fs };
+    wdft::WDFSeriesT<float, decltype (Vs), decltype (C1)> S1 { Vs, C1 };
+    wdft::ResistorT<float> R1 { 4700.0f };
+    wdft::WDFParallelT<float, decltype (S1), decltype (R1)> P1 { S1, R1 };
+    wdft::CapacitorT<float> C2 { 47.0e-9f, fs };
+    wdft::WDFParallelT<float, decltype (P1), decltype (C2)> P2 { P1, C2 };
+    wdft::DiodePairT<float, decltype (P2)> dp { P2, 2.52e-9f };
+};
+
+struct Meters
+{
+    float inputCurrent, couplingVoltage, loadCurrent, outputVoltage;
+};
+
+std::vector<float> makeInput()
+{
+    std::vector<float> input ((size_t) blockSize);
+    for (int n = 0; n < blockSize; ++n)
+        input[(size_t) n] = std::sin (0.03f * (float) n);
+    return input;
+}
+
+void noProbes (benchmark::State& state)
+{
+    Circuit circuit;
+    const auto input = makeInput();
+    std::vector<float> output ((size_t) blockSize);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        for (int n = 0; n < blockSize; ++n)
+            output[(size_t) n] = circuit.processSample (input[(size_t) n]);
+
+        benchmark::DoNotOptimize (output.data());
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+
+void manualProbes (benchmark::State& state)
+{
+    Circuit circuit;
+    const auto input = makeInput();
+    std::vector<float> output ((size_t) blockSize);
+    std::vector<Meters> meters ((size_t) blockSize);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        for (int n = 0; n < blockSize; ++n)
+        {
+            output[(size_t) n] = circuit.processSample (input[(size_t) n]);
+            meters[(size_t) n] = { wdft::current<float> (circuit.Vs), wdft::voltage<float> (circuit.C1), wdft::current<float> (circuit.R1), wdft::voltage<float> (circuit.C2) };
+        }
+
+        benchmark::DoNotOptimize (output.data());
+        benchmark::DoNotOptimize (meters.data());
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+
+void probeRecorder (benchmark::State& state)
+{
+    Circuit circuit;
+    const auto input = makeInput();
+    std::vector<float> output ((size_t) blockSize);
+
+    auto probes = wdft::makeProbeRecorder (wdft::currentProbe<float> (circuit.Vs),
+                                           wdft::voltageProbe<float> (circuit.C1),
+                                           wdft::currentProbe<float> (circuit.R1),
+                                           wdft::voltageProbe<float> (circuit.C2));
+    probes.prepare (blockSize);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        probes.startBlock();
+        for (int n = 0; n < blockSize; ++n)
+        {
+            output[(size_t) n] = circuit.processSample (input[(size_t) n]);
+            probes.record();
+        }
+
+        benchmark::DoNotOptimize (output.data());
+        benchmark::DoNotOptimize (probes.getProbeData (0));
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+} // namespace
+
+BENCHMARK (noProbes)->MinTime (0.5);
+BENCHMARK (manualProbes)->MinTime (0.5);
+BENCHMARK (probeRecorder)->MinTime (0.5);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,116 @@
+#include <array>
+#include <benchmark/benchmark.h>
+
+#include <chowdsp_wdf/chowdsp_wdf.h>
+
+#include "PerfCounters.h"
+
+/**
+ * Measures the per-sample cost of scattering through large R-Type adaptors.
+ *
+ * The circuit is a resistive voltage source, loaded by N - 1 RC series branches, all
+ * connected at a single node (i.e. an N-port parallel junction). The benchmarks come in
+ * pairs: <N>Dense uses a RootRtypeAdaptor, with the full N x N scattering matrix, and
+ * <N>LowRank uses an IncrementalRootRtypeAdaptor, which (since the junction only has one
+ * node) stores the scattering matrix as its rank-1 factors (items = samples).
+ */
+namespace
+{
+namespace wdft = chowdsp::wdft;
+
+constexpr int blockSize = 512;
+constexpr float fs = 48000.0f;
+
+/** Scattering matrix for a parallel junction, computed by hand */
+struct ParallelJunctionImpedance
+{
+    template <typename RType>
+    static void calcImpedance (RType& R)
+    {
+        constexpr auto numPorts = RType::numPorts;
+        const auto portImpedances = R.getPortImpedances();
+
+        float G[numPorts];
+        float Gsum = 0.0f;
+        for (int i = 0; i < numPorts; ++i)
+        {
+            G[i] = 1.0f / portImpedances[(size_t) i];
+            Gsum += G[i];
+        }
+
+        float S[numPorts][numPorts];
+        for (int i = 0; i < numPorts; ++i)
+            for (int j = 0; j < numPorts; ++j)
+                S[i][j] = 2.0f * G[j] / Gsum - (i == j ? 1.0f : 0.0f);
+        R.setSMatrixData (S);
+    }
+};
+
+/** Topology for a parallel junction */
+struct ParallelJunctionTopology
+{
+    static constexpr int numNodes = 1;
+    static wdft::RtypePortNodes getPortNodes (int) { return { 1, 0 }; }
+};
+
+template <size_t>
+using Branch = wdft::ResistorCapacitorSeriesT<float>;
+
+template <typename Indices, bool lowRank>
+struct ParallelJunction;
+
+template <size_t... I, bool lowRank>
+struct ParallelJunction<std::index_sequence<I...>, lowRank>
+{
+    using Source = wdft::ResistiveVoltageSourceT<float>;
+    using Root = std::conditional_t<lowRank,
+                                    wdft::IncrementalRootRtypeAdaptor<float, ParallelJunctionTopology, Source, Branch<I>...>,
+                                    wdft::RootRtypeAdaptor<float, ParallelJunctionImpedance, Source, Branch<I>...>>;
+
+    float processSample (float x) noexcept
+    {
+        vs.setVoltage (x);
+        R.compute();
+        return wdft::voltage<float> (vs);
+    }
+
+    Source vs { 100.0f };
+    std::array<Branch<0>, sizeof...(I)> branches { { Branch<I> { 1.0e3f + 100.0f * (float) I, 1.0e-6f, fs }... } };
+    Root R { vs, std::get<I> (branches)... };
+};
+
+template <int numPorts>
+using DenseJunction = ParallelJunction<std::make_index_sequence<numPorts - 1>, false>;
+
+template <int numPorts>
+using LowRankJunction = ParallelJunction<std::make_index_sequence<numPorts - 1>, true>;
+
+template <typename Circuit>
+void rtypeScatter (benchmark::State& state)
+{
+    Circuit circuit;
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        float y = 0.0f;
+        for (int n = 0; n < blockSize; ++n)
+            y += circuit.processSample ((n & 64) == 0 ? 0.5f : -0.5f);
+
+        benchmark::DoNotOptimize (y);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+} // namespace
+
+#define RTYPE_SCATTER_BENCHMARKS(numPorts)                                        \
+    BENCHMARK_TEMPLATE (rtypeScatter, DenseJunction<numPorts>)->MinTime (0.5); \
+    BENCHMARK_TEMPLATE (rtypeScatter, LowRankJunction<numPorts>)->MinTime (0.5);
+
+RTYPE_SCATTER_BENCHMARKS (4)
+RTYPE_SCATTER_BENCHMARKS (8)
+RTYPE_SCATTER_BENCHMARKS (16)
+RTYPE_SCATTER_BENCHMARKS (20)
+
+BENCHMARK_MAIN();
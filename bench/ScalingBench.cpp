@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+
+#include "PerfCounters.h"
+#include "SyntheticCircuits.h"
+
+/**
+ * Measures how the per-sample cost of a WDF circuit scales with the size of the circuit,
+ * using synthetic circuits with N leaf elements (see SyntheticCircuits.h).
+ *
+ * Each configuration is run for the compile-time (wdft) and run-time (wdf) flavours of the
+ * same circuit. The "elements" and "depth" counters report the total number of elements
+ * (leaves + adaptors + root), and the longest path from the root to a leaf.
+ */
+namespace
+{
+using namespace synthetic_circuits;
+
+constexpr int blockSize = 512;
+constexpr double fs = 48000.0;
+
+using RandomTree = TreeOptions<TreeShape::Random>;
+using ChainTree = TreeOptions<TreeShape::Chain>;
+using BalancedLinearTree = TreeOptions<TreeShape::Balanced, 50, 0, 4, RootKind::Open>;
+using RtypeTree = TreeOptions<TreeShape::Random, 50, 30, 4, RootKind::Rtype>;
+
+template <typename Circuit>
+void processCircuit (benchmark::State& state, Circuit& circuit, int numElements, int depth)
+{
+    circuit.prepare ((float) fs);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        float y = 0.0f;
+        for (int n = 0; n < blockSize; ++n)
+            y += circuit.processSample ((n & 64) == 0 ? 0.5f : -0.5f);
+
+        benchmark::DoNotOptimize (y);
+    }
+
+    // items = samples, so the per-sample cost is 1 / items_per_second
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+    state.counters["elements"] = (double) numElements;
+    state.counters["depth"] = (double) depth;
+}
+
+template <int NumLeaves, typename Options>
+void scalingWDFT (benchmark::State& state)
+{
+    using Circuit = SyntheticCircuitT<float, NumLeaves, 1, Options>;
+    auto circuit = std::make_unique<Circuit>(); // large circuits might not fit on the stack
+    processCircuit (state, *circuit, Circuit::numElements, Circuit::depth);
+}
+
+template <typename Options>
+void scalingWDF (benchmark::State& state)
+{
+    SyntheticCircuit<float> circuit { (int) state.range (0), 1, toRuntimeOptions<Options>() };
+    processCircuit (state, circuit, circuit.getNumElements(), circuit.getDepth());
+}
+} // namespace
+
+BENCHMARK_TEMPLATE (scalingWDFT, 4, RandomTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDFT, 16, RandomTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDFT, 64, RandomTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDFT, 256, RandomTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDF, RandomTree)->ArgName ("N")->Arg (4)->Arg (16)->Arg (64)->Arg (256)->MinTime (0.25);
+
+BENCHMARK_TEMPLATE (scalingWDFT, 4, ChainTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDFT, 16, ChainTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDFT, 64, ChainTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDF, ChainTree)->ArgName ("N")->Arg (4)->Arg (16)->Arg (64)->MinTime (0.25);
+
+BENCHMARK_TEMPLATE (scalingWDFT, 16, BalancedLinearTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDFT, 64, BalancedLinearTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDFT, 256, BalancedLinearTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDF, BalancedLinearTree)->ArgName ("N")->Arg (16)->Arg (64)->Arg (256)->MinTime (0.25);
+
+BENCHMARK_TEMPLATE (scalingWDFT, 16, RtypeTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDFT, 64, RtypeTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDFT, 256, RtypeTree)->MinTime (0.25);
+BENCHMARK_TEMPLATE (scalingWDF, RtypeTree)->ArgName ("N")->Arg (16)->Arg (64)->Arg (256)->MinTime (0.25);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,87 @@
+#include <cmath>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "BaxandallEQ.h"
+#include "PerfCounters.h"
+
+/**
+ * Measures the cost of rendering a linear circuit (the Baxandall EQ) in long blocks,
+ * through the WDF, and through wdft::StateSpaceBlockProcessor (items = samples).
+ *
+ * - Circuit processes every sample through the WDF.
+ * - StateSpacePerSample processes every sample with the state-space recursion.
+ * - StateSpaceBlock/<K> processes the blocks in sub-blocks of K samples.
+ */
+namespace
+{
+constexpr int blockSize = 4096;
+constexpr double fs = 48000.0;
+
+std::vector<float> makeInput()
+{
+    std::vector<float> input ((size_t) blockSize);
+    for (int n = 0; n < blockSize; ++n)
+        input[(size_t) n] = std::sin (0.03f * (float) n);
+    return input;
+}
+
+void circuit (benchmark::State& state)
+{
+    BaxandallWDF eq;
+    eq.prepare (fs);
+    eq.setParams (0.3f, 0.8f);
+
+    const auto input = makeInput();
+    std::vector<float> buffer ((size_t) blockSize);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        for (int n = 0; n < blockSize; ++n)
+            buffer[(size_t) n] = eq.processSample (input[(size_t) n]);
+        benchmark::DoNotOptimize (buffer[0]);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+
+template <bool perSample>
+void stateSpace (benchmark::State& state)
+{
+    BaxandallWDF eq;
+    eq.prepare (fs);
+    eq.setParams (0.3f, 0.8f);
+
+    chowdsp::wdft::StateSpaceBlockProcessor<float> processor;
+    processor.prepare (eq.getRoot(), blockSize, perSample ? 16 : (int) state.range (0));
+    processor.update (eq.getRoot(), [&eq] (float x) { return eq.processSample (x); });
+
+    const auto input = makeInput();
+    std::vector<float> buffer ((size_t) blockSize);
+
+    perf_counters::ScopedPerfCounters perfCounters { state };
+    for (auto _ : state)
+    {
+        std::copy (input.begin(), input.end(), buffer.begin());
+        if (perSample)
+        {
+            for (auto& x : buffer)
+                x = processor.processSample (x);
+        }
+        else
+        {
+            processor.processBlock (buffer.data(), blockSize);
+        }
+        benchmark::DoNotOptimize (buffer[0]);
+    }
+
+    state.SetItemsProcessed ((int64_t) state.iterations() * blockSize);
+}
+} // namespace
+
+BENCHMARK (circuit)->Name ("stateSpaceBlock/Circuit")->MinTime (0.5);
+BENCHMARK_TEMPLATE (stateSpace, true)->Name ("stateSpaceBlock/StateSpacePerSample")->MinTime (0.5);
+BENCHMARK_TEMPLATE (stateSpace, false)->Name ("stateSpaceBlock/StateSpaceBlock")->Arg (8)->Arg (16)->Arg (32)->Arg (64)->MinTime (0.5);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,691 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if CHOWDSP_WDF_TEST_WITH_XSIMD
+#include <xsimd/xsimd.hpp>
+#endif
+#include <chowdsp_wdf/chowdsp_wdf.h>
+
+/**
+ * Generators for random (but valid) WDF trees, for measuring how the cost of a circuit
+ * scales with the number of elements, the depth of the tree, and the size of the R-Type
+ * adaptors.
+ *
+ * The same tree can be generated at compile-time (SyntheticCircuitT, using the wdft API),
+ * or at run-time (SyntheticCircuit, using the wdf API): for the same number of leaves,
+ * seed, and options, both generators make the same decisions, so the two can be compared
+ * directly.
+ *
+ * - Leaves are resistors, capacitors, inductors, or series RC elements, except for the
+ *   "first" leaf in the tree, which is the resistive voltage source that drives the circuit.
+ * - Internal nodes are series or parallel adaptors, or R-Type adaptors (parallel junctions
+ *   with a full scattering matrix), with the given number of ports.
+ * - The root is either a diode pair, an open circuit, or a root R-Type adaptor.
+ */
+namespace synthetic_circuits
+{
+namespace wdf = chowdsp::wdf;
+namespace wdft = chowdsp::wdft;
+
+/** Controls how the leaves are split between the two sides of each adaptor */
+enum class TreeShape
+{
+    Balanced, /* half the leaves on each side, so the depth is ~log2 (N) */
+    Random, /* a random split */
+    Chain, /* one leaf on one side, so the depth is N - 1 */
+};
+
+/** The type of element at the root of the tree */
+enum class RootKind
+{
+    DiodePair,
+    Open,
+    Rtype,
+};
+
+/** Compile-time options for generating a synthetic tree */
+template <TreeShape shapeOpt = TreeShape::Random,
+          int parallelPercentOpt = 50,
+          int rtypePercentOpt = 0,
+          int rtypePortsOpt = 4,
+          RootKind rootOpt = RootKind::DiodePair>
+struct TreeOptions
+{
+    static constexpr TreeShape shape = shapeOpt;
+    static constexpr int parallelPercent = parallelPercentOpt; /* % of 3-port adaptors that are parallel (vs. series) */
+    static constexpr int rtypePercent = rtypePercentOpt; /* % of internal nodes that are R-Type adaptors */
+    static constexpr int rtypePorts = rtypePortsOpt; /* number of ports for each R-Type adaptor (including the up-facing port) */
+    static constexpr RootKind root = rootOpt;
+
+    static_assert (rtypePorts >= 3, "R-Type adaptors need at least 3 ports!");
+};
+
+/** Run-time options for generating a synthetic tree */
+struct RuntimeTreeOptions
+{
+    TreeShape shape = TreeShape::Random;
+    int parallelPercent = 50;
+    int rtypePercent = 0;
+    int rtypePorts = 4;
+    RootKind root = RootKind::DiodePair;
+};
+
+/** Returns run-time options equivalent to the given compile-time options */
+template <typename Options>
+RuntimeTreeOptions toRuntimeOptions()
+{
+    return { Options::shape, Options::parallelPercent, Options::rtypePercent, Options::rtypePorts, Options::root };
+}
+
+namespace detail
+{
+    /** A simple integer hash, used as a compile-time "random" number generator */
+    constexpr uint32_t mix (uint32_t x)
+    {
+        x ^= x >> 16;
+        x *= 0x7feb352dU;
+        x ^= x >> 15;
+        x *= 0x846ca68bU;
+        x ^= x >> 16;
+        return x;
+    }
+
+    constexpr int leafKind (uint32_t seed) { return (int) (mix (seed ^ 0x1eafU) % 4); }
+
+    constexpr bool isParallel (uint32_t seed, int parallelPercent) { return (int) (mix (seed ^ 0x9a7aU) % 100) < parallelPercent; }
+
+    constexpr bool isRtypeNode (int numLeaves, uint32_t seed, int rtypePercent, int rtypePorts)
+    {
+        return numLeaves >= rtypePorts - 1 && (int) (mix (seed ^ 0x47e9U) % 100) < rtypePercent;
+    }
+
+    /** Returns the number of leaves on the "first" side of a 3-port adaptor */
+    constexpr int splitLeaves (int numLeaves, uint32_t seed, TreeShape shape)
+    {
+        return shape == TreeShape::Balanced ? numLeaves / 2
+                                            : (shape == TreeShape::Chain ? 1 : 1 + (int) (mix (seed ^ 0x5b17U) % (uint32_t) (numLeaves - 1)));
+    }
+
+    /** Returns the number of leaves below a given port of an R-Type adaptor */
+    constexpr int portLeaves (int numLeaves, int numPorts, int portIndex)
+    {
+        return numLeaves / numPorts + (portIndex < numLeaves % numPorts ? 1 : 0);
+    }
+
+    constexpr uint32_t childSeed (uint32_t seed, int childIndex) { return mix (seed + 1U + (uint32_t) childIndex); }
+
+    inline double uniform (uint32_t seed, uint32_t salt) { return (double) (mix (seed ^ salt) & 0xffffU) / 65535.0; }
+    inline double resistance (uint32_t seed) { return 100.0 * std::pow (10.0, 3.0 * uniform (seed, 0x4e5U)); } // 100 Ohm - 100 kOhm
+    inline double capacitance (uint32_t seed) { return 1.0e-9 * std::pow (10.0, 3.0 * uniform (seed, 0xca9U)); } // 1 nF - 1 uF
+    inline double inductance (uint32_t seed) { return 1.0e-3 * std::pow (10.0, 2.0 * uniform (seed, 0x1d0U)); } // 1 mH - 100 mH
+
+    constexpr int sum (std::initializer_list<int> values)
+    {
+        int result = 0;
+        for (auto v : values)
+            result += v;
+        return result;
+    }
+
+    constexpr int maximum (std::initializer_list<int> values)
+    {
+        int result = 0;
+        for (auto v : values)
+            result = v > result ? v : result;
+        return result;
+    }
+
+    /** Scattering matrix for a parallel junction, S_ij = 2 G_j / sum(G) - delta_ij */
+    template <typename T, int numPorts>
+    void parallelJunctionMatrix (const T (&G)[numPorts], T (&S)[numPorts][numPorts])
+    {
+        T Gsum = (T) 0;
+        for (int i = 0; i < numPorts; ++i)
+            Gsum += G[i];
+
+        for (int i = 0; i < numPorts; ++i)
+            for (int j = 0; j < numPorts; ++j)
+                S[i][j] = (T) 2 * G[j] / Gsum - (i == j ? (T) 1 : (T) 0);
+    }
+
+    /** Impedance calculator for an adapted R-Type parallel junction (the up-facing port is last) */
+    struct ParallelJunctionImpedance
+    {
+        template <typename RType>
+        static auto calcImpedance (RType& R)
+        {
+            using T = typename decltype (R.getPortImpedances())::value_type;
+            constexpr auto numPorts = RType::numPorts;
+
+            const auto portImpedances = R.getPortImpedances();
+            T G[numPorts] {};
+            for (int i = 0; i < numPorts - 1; ++i)
+            {
+                G[i] = (T) 1 / portImpedances[(size_t) i];
+                G[numPorts - 1] += G[i];
+            }
+
+            T S[numPorts][numPorts];
+            parallelJunctionMatrix (G, S);
+            R.setSMatrixData (S);
+
+            return (T) 1 / G[numPorts - 1];
+        }
+    };
+
+    /** Impedance calculator for a root R-Type parallel junction */
+    struct RootParallelJunctionImpedance
+    {
+        template <typename RType>
+        static void calcImpedance (RType& R)
+        {
+            using T = typename decltype (R.getPortImpedances())::value_type;
+            constexpr auto numPorts = RType::numPorts;
+
+            const auto portImpedances = R.getPortImpedances();
+            T G[numPorts];
+            for (int i = 0; i < numPorts; ++i)
+                G[i] = (T) 1 / portImpedances[(size_t) i];
+
+            T S[numPorts][numPorts];
+            parallelJunctionMatrix (G, S);
+            R.setSMatrixData (S);
+        }
+    };
+
+    //================================================================================
+    // Compile-time (wdft) tree nodes
+    template <typename T, uint32_t Seed, int Kind>
+    struct LeafT;
+
+    template <typename T, int NumLeaves, uint32_t Seed, typename Options, bool HasInput>
+    struct AdaptorNodeT;
+
+    template <typename T, int NumLeaves, uint32_t Seed, typename Options, bool HasInput, typename Indices = std::make_index_sequence<(size_t) Options::rtypePorts - 1>>
+    struct RtypeNodeT;
+
+    template <typename T, int NumLeaves, uint32_t Seed, typename Options, bool HasInput>
+    using SubtreeT = std::conditional_t<NumLeaves == 1,
+                                        LeafT<T, Seed, HasInput ? -1 : leafKind (Seed)>,
+                                        std::conditional_t<isRtypeNode (NumLeaves, Seed, Options::rtypePercent, Options::rtypePorts),
+                                                           RtypeNodeT<T, NumLeaves, Seed, Options, HasInput>,
+                                                           AdaptorNodeT<T, NumLeaves, Seed, Options, HasInput>>>;
+
+    template <typename T, uint32_t Seed>
+    struct LeafT<T, Seed, -1>
+    {
+        using RootType = wdft::ResistiveVoltageSourceT<T>;
+        static constexpr int numElements = 1;
+        static constexpr int depth = 0;
+
+        void setInput (T x) { element.setVoltage (x); }
+        void prepare (T) {}
+        RootType& root() { return element; }
+
+        RootType element { (T) resistance (Seed) };
+    };
+
+    template <typename T, uint32_t Seed>
+    struct LeafT<T, Seed, 0>
+    {
+        using RootType = wdft::ResistorT<T>;
+        static constexpr int numElements = 1;
+        static constexpr int depth = 0;
+
+        void setInput (T) {}
+        void prepare (T) {}
+        RootType& root() { return element; }
+
+        RootType element { (T) resistance (Seed) };
+    };
+
+    template <typename T, uint32_t Seed>
+    struct LeafT<T, Seed, 1>
+    {
+        using RootType = wdft::CapacitorT<T>;
+        static constexpr int numElements = 1;
+        static constexpr int depth = 0;
+
+        void setInput (T) {}
+        void prepare (T fs) { element.prepare (fs); }
+        RootType& root() { return element; }
+
+        RootType element { (T) capacitance (Seed) };
+    };
+
+    template <typename T, uint32_t Seed>
+    struct LeafT<T, Seed, 2>
+    {
+        using RootType = wdft::InductorT<T>;
+        static constexpr int numElements = 1;
+        static constexpr int depth = 0;
+
+        void setInput (T) {}
+        void prepare (T fs) { element.prepare (fs); }
+        RootType& root() { return element; }
+
+        RootType element { (T) inductance (Seed) };
+    };
+
+    template <typename T, uint32_t Seed>
+    struct LeafT<T, Seed, 3>
+    {
+        using RootType = wdft::ResistorCapacitorSeriesT<T>;
+        static constexpr int numElements = 1;
+        static constexpr int depth = 0;
+
+        void setInput (T) {}
+        void prepare (T fs) { element.prepare (fs); }
+        RootType& root() { return element; }
+
+        RootType element { (T) resistance (Seed), (T) capacitance (Seed) };
+    };
+
+    template <typename T, int NumLeaves, uint32_t Seed, typename Options, bool HasInput>
+    struct AdaptorNodeT
+    {
+        static constexpr int numLeftLeaves = splitLeaves (NumLeaves, Seed, Options::shape);
+        using LeftType = SubtreeT<T, numLeftLeaves, childSeed (Seed, 0), Options, HasInput>;
+        using RightType = SubtreeT<T, NumLeaves - numLeftLeaves, childSeed (Seed, 1), Options, false>;
+
+        using RootType = std::conditional_t<isParallel (Seed, Options::parallelPercent),
+                                            wdft::WDFParallelT<T, typename LeftType::RootType, typename RightType::RootType>,
+                                            wdft::WDFSeriesT<T, typename LeftType::RootType, typename RightType::RootType>>;
+
+        static constexpr int numElements = 1 + LeftType::numElements + RightType::numElements;
+        static constexpr int depth = 1 + maximum ({ LeftType::depth, RightType::depth });
+
+        void setInput (T x) { left.setInput (x); }
+
+        void prepare (T fs)
+        {
+            left.prepare (fs);
+            right.prepare (fs);
+        }
+
+        RootType& root() { return adaptor; }
+
+        LeftType left;
+        RightType right;
+        RootType adaptor { left.root(), right.root() };
+    };
+
+    template <typename T, int NumLeaves, uint32_t Seed, typename Options, bool HasInput, size_t... I>
+    struct RtypeNodeT<T, NumLeaves, Seed, Options, HasInput, std::index_sequence<I...>>
+    {
+        static constexpr int numDownPorts = (int) sizeof...(I);
+        using ChildrenType = std::tuple<SubtreeT<T, portLeaves (NumLeaves, numDownPorts, (int) I), childSeed (Seed, (int) I), Options, HasInput && I == 0>...>;
+        using RootType = wdft::RtypeAdaptor<T, numDownPorts, ParallelJunctionImpedance, typename std::tuple_element_t<I, ChildrenType>::RootType...>;
+
+        static constexpr int numElements = 1 + sum ({ std::tuple_element_t<I, ChildrenType>::numElements... });
+        static constexpr int depth = 1 + maximum ({ std::tuple_element_t<I, ChildrenType>::depth... });
+
+        void setInput (T x) { std::get<0> (children).setInput (x); }
+
+        void prepare (T fs)
+        {
+            (void) std::initializer_list<int> { (std::get<I> (children).prepare (fs), 0)... };
+            adaptor.propagateImpedanceChange(); // make sure the scattering matrix is up-to-date
+        }
+
+        RootType& root() { return adaptor; }
+
+        ChildrenType children;
+        RootType adaptor { std::get<I> (children).root()... };
+    };
+
+    template <typename T, int NumLeaves, uint32_t Seed, typename Options, RootKind Root = Options::root>
+    struct CircuitRootT;
+
+    template <typename T, int NumLeaves, uint32_t Seed, typename Options>
+    struct CircuitRootT<T, NumLeaves, Seed, Options, RootKind::DiodePair>
+    {
+        using TreeType = SubtreeT<T, NumLeaves, Seed, Options, true>;
+        static constexpr int numElements = TreeType::numElements + 1;
+        static constexpr int depth = TreeType::depth + 1;
+
+        void prepare (T fs) { tree.prepare (fs); }
+
+        T processSample (T x) noexcept
+        {
+            tree.setInput (x);
+            dp.incident (tree.root().reflected());
+            tree.root().incident (dp.reflected());
+            return wdft::voltage<T> (dp);
+        }
+
+        TreeType tree;
+        wdft::DiodePairT<T, typename TreeType::RootType> dp { tree.root(), (T) 2.52e-9 };
+    };
+
+    template <typename T, int NumLeaves, uint32_t Seed, typename Options>
+    struct CircuitRootT<T, NumLeaves, Seed, Options, RootKind::Open>
+    {
+        using TreeType = SubtreeT<T, NumLeaves, Seed, Options, true>;
+        static constexpr int numElements = TreeType::numElements + 1;
+        static constexpr int depth = TreeType::depth + 1;
+
+        void prepare (T fs) { tree.prepare (fs); }
+
+        T processSample (T x) noexcept
+        {
+            tree.setInput (x);
+            open.incident (tree.root().reflected());
+            tree.root().incident (open.reflected());
+            return wdft::voltage<T> (open);
+        }
+
+        TreeType tree;
+        wdft::IdealCurrentSourceT<T, typename TreeType::RootType> open { tree.root() }; // zero current == open circuit
+    };
+
+    template <typename T, int NumLeaves, uint32_t Seed, typename Options, typename Indices = std::make_index_sequence<(size_t) Options::rtypePorts>>
+    struct RootRtypeT;
+
+    template <typename T, int NumLeaves, uint32_t Seed, typename Options, size_t... I>
+    struct RootRtypeT<T, NumLeaves, Seed, Options, std::index_sequence<I...>>
+    {
+        static constexpr int numPorts = (int) sizeof...(I);
+        static_assert (NumLeaves >= numPorts, "Root R-Type adaptor needs at least one leaf per port!");
+
+        using ChildrenType = std::tuple<SubtreeT<T, portLeaves (NumLeaves, numPorts, (int) I), childSeed (Seed, (int) I), Options, I == 0>...>;
+        static constexpr int numElements = 1 + sum ({ std::tuple_element_t<I, ChildrenType>::numElements... });
+        static constexpr int depth = 1 + maximum ({ std::tuple_element_t<I, ChildrenType>::depth... });
+
+        void prepare (T fs)
+        {
+            (void) std::initializer_list<int> { (std::get<I> (children).prepare (fs), 0)... };
+            R.propagateImpedanceChange();
+        }
+
+        T processSample (T x) noexcept
+        {
+            std::get<0> (children).setInput (x);
+            R.compute();
+            return wdft::voltage<T> (std::get<0> (children).root());
+        }
+
+        ChildrenType children;
+        wdft::RootRtypeAdaptor<T, RootParallelJunctionImpedance, typename std::tuple_element_t<I, ChildrenType>::RootType...> R { std::get<I> (children).root()... };
+    };
+
+    template <typename T, int NumLeaves, uint32_t Seed, typename Options>
+    struct CircuitRootT<T, NumLeaves, Seed, Options, RootKind::Rtype> : RootRtypeT<T, NumLeaves, Seed, Options>
+    {
+    };
+} // namespace detail
+
+/**
+ * A synthetic wdft circuit with NumLeaves leaf elements, generated at compile-time.
+ * The number of elements (leaves + adaptors + root) is given by numElements.
+ */
+template <typename T, int NumLeaves, uint32_t Seed = 1, typename Options = TreeOptions<>>
+class SyntheticCircuitT
+{
+public:
+    static constexpr int numElements = detail::CircuitRootT<T, NumLeaves, Seed, Options>::numElements;
+    static constexpr int depth = detail::CircuitRootT<T, NumLeaves, Seed, Options>::depth;
+
+    void prepare (T fs) { circuit.prepare (fs); }
+    T processSample (T x) noexcept { return circuit.processSample (x); }
+
+private:
+    detail::CircuitRootT<T, NumLeaves, Seed, Options> circuit;
+};
+
+/**
+ * A synthetic wdf circuit, generated at run-time. For the same arguments,
+ * the circuit has the same structure as the equivalent SyntheticCircuitT.
+ */
+template <typename T>
+class SyntheticCircuit
+{
+public:
+    SyntheticCircuit (int numLeaves, uint32_t seed = 1, RuntimeTreeOptions treeOptions = {}) : options (treeOptions)
+    {
+        if (options.root == RootKind::Rtype)
+        {
+            std::vector<wdf::WDF<T>*> ports;
+            for (int i = 0; i < options.rtypePorts; ++i)
+            {
+                int portDepth = 0;
+                ports.push_back (buildSubtree (detail::portLeaves (numLeaves, options.rtypePorts, i), detail::childSeed (seed, i), i == 0, portDepth));
+                treeDepth = std::max (treeDepth, portDepth + 1);
+            }
+
+            rootRtype = makeRootRtype (ports);
+            rootPort = ports[0];
+            numElements = (int) elements.size();
+            return;
+        }
+
+        auto* tree = buildSubtree (numLeaves, seed, true, treeDepth);
+        if (options.root == RootKind::DiodePair)
+            root = std::make_unique<wdf::DiodePair<T>> (tree, (T) 2.52e-9);
+        else
+            root = std::make_unique<wdf::IdealCurrentSource<T>> (tree);
+
+        rootPort = tree;
+        treeDepth += 1;
+        numElements = (int) elements.size() + 1;
+    }
+
+    void prepare (T fs)
+    {
+        for (auto& prepareElement : preparers)
+            prepareElement (fs);
+
+        for (auto* rtype : rtypeAdaptors)
+            rtype->propagateImpedance(); // make sure the scattering matrices are up-to-date
+
+        if (rootRtype != nullptr)
+            rootRtype->propagateImpedance();
+    }
+
+    T processSample (T x) noexcept
+    {
+        input->setVoltage (x);
+
+        if (rootRtype != nullptr)
+        {
+            rootRtype->compute();
+            return rootPort->voltage();
+        }
+
+        root->incident (rootPort->reflected());
+        rootPort->incident (root->reflected());
+        return root->voltage();
+    }
+
+    int getNumElements() const noexcept { return numElements; }
+    int getDepth() const noexcept { return treeDepth; }
+
+private:
+    template <typename ElementType, typename... Args>
+    ElementType* make (Args&&... args)
+    {
+        auto element = std::make_unique<ElementType> (std::forward<Args> (args)...);
+        auto* elementPtr = element.get();
+        elements.push_back (std::move (element));
+        return elementPtr;
+    }
+
+    template <typename ElementType>
+    void addReactive (ElementType* element)
+    {
+        preparers.push_back ([element] (T fs) { element->prepare (fs); });
+    }
+
+    wdf::WDF<T>* buildLeaf (uint32_t seed, bool hasInput)
+    {
+        if (hasInput)
+        {
+            input = make<wdf::ResistiveVoltageSource<T>> ((T) detail::resistance (seed));
+            return input;
+        }
+
+        switch (detail::leafKind (seed))
+        {
+            case 0:
+                return make<wdf::Resistor<T>> ((T) detail::resistance (seed));
+            case 1:
+            {
+                auto* c = make<wdf::Capacitor<T>> ((T) detail::capacitance (seed));
+                addReactive (c);
+                return c;
+            }
+            case 2:
+            {
+                auto* l = make<wdf::Inductor<T>> ((T) detail::inductance (seed));
+                addReactive (l);
+                return l;
+            }
+            default:
+            {
+                auto* rc = make<wdf::ResistorCapacitorSeries<T>> ((T) detail::resistance (seed), (T) detail::capacitance (seed));
+                addReactive (rc);
+                return rc;
+            }
+        }
+    }
+
+    wdf::WDF<T>* buildSubtree (int numLeaves, uint32_t seed, bool hasInput, int& depth)
+    {
+        depth = 0;
+        if (numLeaves == 1)
+            return buildLeaf (seed, hasInput);
+
+        if (detail::isRtypeNode (numLeaves, seed, options.rtypePercent, options.rtypePorts))
+        {
+            const auto numDownPorts = options.rtypePorts - 1;
+            std::vector<wdf::WDF<T>*> ports;
+            for (int i = 0; i < numDownPorts; ++i)
+            {
+                int portDepth = 0;
+                ports.push_back (buildSubtree (detail::portLeaves (numLeaves, numDownPorts, i), detail::childSeed (seed, i), hasInput && i == 0, portDepth));
+                depth = std::max (depth, portDepth + 1);
+            }
+
+            auto* rtype = makeRtype (ports);
+            rtypeAdaptors.push_back (rtype);
+            return rtype;
+        }
+
+        const auto numLeftLeaves = detail::splitLeaves (numLeaves, seed, options.shape);
+        int leftDepth = 0, rightDepth = 0;
+        auto* left = buildSubtree (numLeftLeaves, detail::childSeed (seed, 0), hasInput, leftDepth);
+        auto* right = buildSubtree (numLeaves - numLeftLeaves, detail::childSeed (seed, 1), false, rightDepth);
+        depth = 1 + std::max (leftDepth, rightDepth);
+
+        if (detail::isParallel (seed, options.parallelPercent))
+            return make<wdf::WDFParallel<T>> (left, right);
+        return make<wdf::WDFSeries<T>> (left, right);
+    }
+
+    // wdf R-Type adaptors take an initializer list of ports, and a fixed-size scattering
+    // matrix, so we need to dispatch to a compile-time number of ports
+    template <size_t... I>
+    wdf::RtypeAdaptor<T>* makeRtypeImpl (const std::vector<wdf::WDF<T>*>& ports, std::index_sequence<I...>)
+    {
+        constexpr auto numPorts = (int) sizeof...(I) + 1;
+        auto* rtype = make<wdf::RtypeAdaptor<T>> (std::initializer_list<wdf::WDF<T>*> { ports[I]... }, numPorts - 1);
+        rtype->impedanceCalculator = [] (wdf::RtypeAdaptor<T>& R)
+        {
+            T G[numPorts] {};
+            for (size_t i = 0; i < (size_t) numPorts - 1; ++i)
+            {
+                G[i] = (T) 1 / R.getPortImpedance (i);
+                G[numPorts - 1] += G[i];
+            }
+
+            T S[numPorts][numPorts];
+            detail::parallelJunctionMatrix (G, S);
+            R.setSMatrixData (S);
+            return (T) 1 / G[numPorts - 1];
+        };
+        return rtype;
+    }
+
+    template <size_t... I>
+    wdf::RootRtypeAdaptor<T>* makeRootRtypeImpl (const std::vector<wdf::WDF<T>*>& ports, std::index_sequence<I...>)
+    {
+        constexpr auto numPorts = (int) sizeof...(I);
+        auto* rtype = make<wdf::RootRtypeAdaptor<T>> (std::initializer_list<wdf::WDF<T>*> { ports[I]... });
+        rtype->impedanceCalculator = [] (wdf::RootRtypeAdaptor<T>& R)
+        {
+            T G[numPorts];
+            for (size_t i = 0; i < (size_t) numPorts; ++i)
+                G[i] = (T) 1 / R.getPortImpedance (i);
+
+            T S[numPorts][numPorts];
+            detail::parallelJunctionMatrix (G, S);
+            R.setSMatrixData (S);
+        };
+        return rtype;
+    }
+
+    wdf::RtypeAdaptor<T>* makeRtype (const std::vector<wdf::WDF<T>*>& ports)
+    {
+        switch (ports.size())
+        {
+            case 2:
+                return makeRtypeImpl (ports, std::make_index_sequence<2> {});
+            case 3:
+                return makeRtypeImpl (ports, std::make_index_sequence<3> {});
+            case 4:
+                return makeRtypeImpl (ports, std::make_index_sequence<4> {});
+            case 5:
+                return makeRtypeImpl (ports, std::make_index_sequence<5> {});
+            case 6:
+                return makeRtypeImpl (ports, std::make_index_sequence<6> {});
+            case 7:
+                return makeRtypeImpl (ports, std::make_index_sequence<7> {});
+            default:
+                return nullptr; // unsupported number of ports
+        }
+    }
+
+    wdf::RootRtypeAdaptor<T>* makeRootRtype (const std::vector<wdf::WDF<T>*>& ports)
+    {
+        switch (ports.size())
+        {
+            case 3:
+                return makeRootRtypeImpl (ports, std::make_index_sequence<3> {});
+            case 4:
+                return makeRootRtypeImpl (ports, std::make_index_sequence<4> {});
+            case 5:
+                return makeRootRtypeImpl (ports, std::make_index_sequence<5> {});
+            case 6:
+                return makeRootRtypeImpl (ports, std::make_index_sequence<6> {});
+            case 7:
+                return makeRootRtypeImpl (ports, std::make_index_sequence<7> {});
+            case 8:
+                return makeRootRtypeImpl (ports, std::make_index_sequence<8> {});
+            default:
+                return nullptr; // unsupported number of ports
+        }
+    }
+
+    const RuntimeTreeOptions options;
+
+    std::vector<std::unique_ptr<wdf::WDF<T>>> elements;
+    std::vector<std::function<void (T)>> preparers;
+    std::vector<wdf::RtypeAdaptor<T>*> rtypeAdaptors;
+
+    wdf::ResistiveVoltageSource<T>* input = nullptr;
+    wdf::WDF<T>* rootPort = nullptr;
+    std::unique_ptr<wdf::WDF<T>> root;
+    wdf::RootRtypeAdaptor<T>* rootRtype = nullptr;
+
+    int numElements = 0;
+    int treeDepth = 0;
+};
+} // namespace synthetic_circuits
@@ -9,6 +9,8 @@
 #include <random>
 #include <vector>
 
+#include "PerfCounters.h"
+
 template <typename T>
 inline auto makeRandomVector (int num)
 {
@@ -25,11 +27,13 @@ inline auto makeRandomVector (int num)
 #define SCALAR_BENCH(name, testVec, func) \
   static void name (benchmark::State& state) \
   { \
+      perf_counters::ScopedPerfCounters perfCounters { state }; \
       for (auto _ : state) \
       { \
           for (int i = 0; i < N; ++i) \
               (testVec)[i] = func ((testVec) [i]); \
       } \
+      state.SetItemsProcessed ((int64_t) state.iterations() * N); \
   }                                       \
   BENCHMARK(name)->MinTime (3);
 
@@ -37,12 +41,14 @@ inline auto makeRandomVector (int num)
   static void name (benchmark::State& state) \
   { \
       SIMDType y;                                            \
+      perf_counters::ScopedPerfCounters perfCounters { state }; \
       for (auto _ : state) \
       { \
           for (int i = 0; i < N; ++i) \
               y = func ((SIMDType) (testVec) [i]); \
       } \
       (testVec)[0] = y.get (0);\
+      state.SetItemsProcessed ((int64_t) state.iterations() * N); \
   } \
   BENCHMARK(name)->MinTime (3);
 
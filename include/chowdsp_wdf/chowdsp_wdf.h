@@ -24,6 +24,14 @@ constexpr int CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT = 16;
 #include "rtype/rtype.h"
 
 #include "util/defer_impedance.h"
+#include "util/circuit_state.h"
+#include "util/dc_operating_point.h"
+#include "util/scoped_no_denormals.h"
+#include "util/multichannel.h"
+#include "util/circuit_sleep.h"
+#include "util/probe_recorder.h"
+#include "util/linear_state_space.h"
+#include "util/linear_circuit_filter.h"
 
 #if defined(_MSC_VER)
 #pragma warning(pop)
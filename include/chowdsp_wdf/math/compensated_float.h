@@ -0,0 +1,94 @@
+#ifndef CHOWDSP_WDF_COMPENSATED_FLOAT_H
+#define CHOWDSP_WDF_COMPENSATED_FLOAT_H
+
+namespace chowdsp
+{
+/**
+ * A floating-point accumulator which tracks the rounding error of its running sum
+ * in a second "low" word (i.e. Kahan/TwoSum compensated summation). This gives
+ * close to double-word precision for state variables that integrate many small
+ * increments, while only using operations that are available for SIMD types.
+ *
+ * This type is intended to be used as the StateType for the WDF elements that
+ * support a mixed-precision state (e.g. `wdft::ResistorCapacitorSeriesT<float, CompensatedFloat<float>>`).
+ *
+ * Note that compensated arithmetic relies on strict IEEE semantics, so it will not work
+ * correctly if the code is compiled with `-ffast-math` or similar re-association flags.
+ */
+template <typename T>
+struct CompensatedFloat
+{
+    CompensatedFloat() = default;
+    explicit CompensatedFloat (T value) : hi (value) {}
+
+    /** Returns the value of the accumulator, rounded to the underlying type. */
+    explicit operator T() const noexcept { return hi + lo; }
+
+    CompensatedFloat& operator+= (T x) noexcept
+    {
+        T err;
+        const auto sum = twoSum (hi, x, err);
+        normalise (sum, lo + err);
+        return *this;
+    }
+
+    CompensatedFloat& operator-= (T x) noexcept
+    {
+        return *this += -x;
+    }
+
+    CompensatedFloat& operator+= (const CompensatedFloat& other) noexcept
+    {
+        T err;
+        const auto sum = twoSum (hi, other.hi, err);
+        normalise (sum, err + (lo + other.lo));
+        return *this;
+    }
+
+    CompensatedFloat& operator-= (const CompensatedFloat& other) noexcept
+    {
+        return *this += -other;
+    }
+
+    CompensatedFloat operator-() const noexcept
+    {
+        CompensatedFloat result;
+        result.hi = -hi;
+        result.lo = -lo;
+        return result;
+    }
+
+    /** Scales the accumulator by a (non-compensated) coefficient. */
+    friend inline CompensatedFloat operator* (T k, const CompensatedFloat& x) noexcept
+    {
+        CompensatedFloat result;
+        result.normalise (k * x.hi, k * x.lo);
+        return result;
+    }
+
+    friend inline CompensatedFloat operator+ (CompensatedFloat x, T y) noexcept { return x += y; }
+    friend inline CompensatedFloat operator+ (T x, CompensatedFloat y) noexcept { return y += x; }
+    friend inline CompensatedFloat operator- (CompensatedFloat x, T y) noexcept { return x -= y; }
+
+    T hi {}; /* high word (the rounded running value) */
+    T lo {}; /* low word (the accumulated rounding error) */
+
+private:
+    /** Error-free sum: returns fl(a + b) and stores the rounding error in err. */
+    static inline T twoSum (T a, T b, T& err) noexcept
+    {
+        const auto s = a + b;
+        const auto bb = s - a;
+        err = (a - (s - bb)) + (b - bb);
+        return s;
+    }
+
+    inline void normalise (T sum, T err) noexcept
+    {
+        hi = sum + err;
+        lo = err - (hi - sum);
+    }
+};
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_COMPENSATED_FLOAT_H
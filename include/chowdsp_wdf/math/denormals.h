@@ -0,0 +1,70 @@
+#ifndef CHOWDSP_WDF_DENORMALS_H
+#define CHOWDSP_WDF_DENORMALS_H
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "compensated_float.h"
+
+/**
+ * If CHOWDSP_WDF_FLUSH_DENORMALS is enabled, the reactive WDF elements will
+ * flush their internal states to zero whenever those states become denormal.
+ * This costs a compare and select per state write, but protects against
+ * denormal CPU spikes even when the caller has not set the FTZ/DAZ flags.
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_FLUSH_DENORMALS
+#define CHOWDSP_WDF_FLUSH_DENORMALS 0
+#endif
+
+namespace chowdsp
+{
+/** Methods for dealing with denormal numbers */
+namespace denormals
+{
+    /** Returns zero if the input is denormal, otherwise returns the input. */
+    template <typename T>
+    inline typename std::enable_if<std::is_floating_point<T>::value, T>::type
+        flush (T x) noexcept
+    {
+        return std::abs (x) < std::numeric_limits<T>::min() ? (T) 0 : x;
+    }
+
+#if defined(XSIMD_HPP)
+    /** Returns zero for any denormal elements of the input. */
+    template <typename T>
+    inline xsimd::batch<T> flush (xsimd::batch<T> x) noexcept
+    {
+        using v_type = xsimd::batch<T>;
+        return xsimd::select (xsimd::abs (x) < v_type (std::numeric_limits<T>::min()), v_type ((T) 0), x);
+    }
+#endif
+
+    /** Flushes both words of a compensated accumulator. */
+    template <typename T>
+    inline CompensatedFloat<T> flush (CompensatedFloat<T> x) noexcept
+    {
+        x.hi = flush (x.hi);
+        x.lo = flush (x.lo);
+        return x;
+    }
+
+    /**
+     * Used by the WDF elements when writing their internal state.
+     * Flushes denormals if CHOWDSP_WDF_FLUSH_DENORMALS is enabled, otherwise does nothing.
+     */
+    template <typename T>
+    inline T flushState (T x) noexcept
+    {
+#if CHOWDSP_WDF_FLUSH_DENORMALS
+        return flush (x);
+#else
+        return x;
+#endif
+    }
+} // namespace denormals
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_DENORMALS_H
@@ -0,0 +1,342 @@
+#ifndef CHOWDSP_WDF_ASYNC_ROOT_RTYPE_ADAPTOR_H
+#define CHOWDSP_WDF_ASYNC_ROOT_RTYPE_ADAPTOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "../util/spin_wait.h"
+#include "root_rtype_adaptor.h"
+
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace rtype_detail
+    {
+        /**
+         * A lock-free single-producer, single-consumer "latest value" buffer.
+         * The producer writes into its own slot and publishes it, and the consumer
+         * picks up the most recently published slot. Values which are published
+         * while the consumer is busy are overwritten, rather than queued.
+         */
+        template <typename Data>
+        class TripleBuffer
+        {
+        public:
+            /** Returns the slot the producer may write into. */
+            Data& getWriteBuffer() noexcept { return buffers[writeIndex]; }
+
+            /** Publishes the producer's slot. */
+            void publish() noexcept
+            {
+                writeIndex = middleIndex.exchange (writeIndex | newDataFlag, std::memory_order_acq_rel) & indexMask;
+            }
+
+            /** Returns true if a slot has been published since the consumer last took one. */
+            bool hasNewData() const noexcept { return (middleIndex.load (std::memory_order_relaxed) & newDataFlag) != 0; }
+
+            /** Takes the most recently published slot, and returns false if nothing new has been published. */
+            bool consume() noexcept
+            {
+                if (! hasNewData())
+                    return false;
+
+                readIndex = middleIndex.exchange (readIndex, std::memory_order_acq_rel) & indexMask;
+                return true;
+            }
+
+            /** Returns the slot the consumer may read from. */
+            const Data& getReadBuffer() const noexcept { return buffers[readIndex]; }
+
+        private:
+            static constexpr int indexMask = 3;
+            static constexpr int newDataFlag = 4;
+
+            Data buffers[3] {};
+            int writeIndex = 0;
+            int readIndex = 1;
+            std::atomic<int> middleIndex { 2 };
+        };
+    } // namespace rtype_detail
+#endif // DOXYGEN
+
+    /**
+     *  A non-adaptable R-Type adaptor, which computes its scattering matrix on a background thread.
+     *
+     *  This has the same interface as RootRtypeAdaptor, and takes the same ImpedanceCalculator.
+     *  When the port impedances change, calcImpedance() only takes a snapshot of the new impedances
+     *  and hands it over to the background thread, without locking or allocating memory. The audio
+     *  thread keeps using the old scattering matrix until the background thread has computed the
+     *  new one, which is then swapped in at the start of the next call to compute(). If several
+     *  impedance changes arrive while the background thread is busy, only the most recent one is
+     *  computed. This way, an expensive ImpedanceCalculator (or several pots moving at once) can
+     *  never cause the audio thread to miss a deadline.
+     *
+     *  The new scattering matrix is typically swapped in within a millisecond or so. With
+     *  setCrossfadeSamples(), the old matrix is crossfaded into the new one instead, to avoid
+     *  any clicks from the parameter jump.
+     *
+     *  The background thread is started by the constructor and stopped by the destructor. While
+     *  there is nothing to compute, it is parked on a semaphore, which calcImpedance() posts to
+     *  without blocking (on platforms without a native semaphore, it falls back to polling for new
+     *  impedances every 250 microseconds). Since
+     *  the first scattering matrix is also computed asynchronously, call calcImpedanceNow()
+     *  after preparing the circuit, so that the circuit is correct from the very first sample:
+     *  @code
+     *  void prepare (double sampleRate)
+     *  {
+     *      C1.prepare ((float) sampleRate);
+     *      R.calcImpedanceNow();
+     *  }
+     *  @endcode
+     *
+     *  The ImpedanceCalculator will be called on the background thread, so it must only use
+     *  the getPortImpedances() and setSMatrixData() methods of the R-Type that it is given.
+     *  Since an adaptable R-Type needs its up-port impedance as soon as its port impedances
+     *  change, only root R-Types can be computed asynchronously.
+     */
+    template <typename T, typename ImpedanceCalculator, typename... PortTypes>
+    class AsyncRootRtypeAdaptor : public RootWDF
+    {
+    public:
+        /** Number of ports connected to AsyncRootRtypeAdaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+
+        explicit AsyncRootRtypeAdaptor (PortTypes&... dps) : downPorts (std::tie (dps...))
+        {
+            b_vec.clear();
+            a_vec.clear();
+            clearMatrix (S_matrix);
+
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
+                                          downPorts);
+
+            backgroundThread = std::thread ([this]
+                                            { backgroundThreadLoop(); });
+        }
+
+        ~AsyncRootRtypeAdaptor() override
+        {
+            shouldQuit.store (true, std::memory_order_release);
+            requestsPublished.notify();
+            backgroundThread.join();
+        }
+
+        AsyncRootRtypeAdaptor (const AsyncRootRtypeAdaptor&) = delete;
+        AsyncRootRtypeAdaptor& operator= (const AsyncRootRtypeAdaptor&) = delete;
+
+        /** Sends the incoming impedances to the background thread, to recompute the scattering matrix. */
+        void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+
+            auto& request = requests.getWriteBuffer();
+            request.impedances = getPortImpedances();
+            request.index = ++lastRequestIndex;
+            requests.publish();
+            requestsPublished.notify();
+        }
+
+        /**
+         * Recomputes the scattering matrix on the calling thread, without a crossfade.
+         * This is useful when preparing the circuit, but should not be called from the audio thread.
+         */
+        void calcImpedanceNow()
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+
+            MatrixCalculator calculator { getPortImpedances(), S_matrix };
+            ImpedanceCalculator::calcImpedance (calculator);
+            crossfadeCounter = 0;
+
+            // any matrices still being computed are older than this one
+            appliedRequestIndex = lastRequestIndex;
+        }
+
+        /**
+         * Sets the number of samples over which the old scattering matrix is crossfaded
+         * into the new one. With 0 samples (the default), the new matrix is swapped in
+         * immediately.
+         */
+        void setCrossfadeSamples (int numSamples) noexcept { crossfadeLength = numSamples > 0 ? numSamples : 0; }
+
+        /** Returns true if the background thread has not yet finished computing the latest scattering matrix. */
+        bool hasPendingUpdate() const noexcept
+        {
+            return completedRequestIndex.load (std::memory_order_acquire) < lastRequestIndex;
+        }
+
+        /** Returns true if the scattering matrix is currently being crossfaded. */
+        bool isCrossfading() const noexcept { return crossfadeCounter > 0; }
+
+        constexpr auto getPortImpedances()
+        {
+            std::array<T, numPorts> portImpedances {};
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { portImpedances[i] = port.wdf.R; },
+                                          downPorts);
+
+            return portImpedances;
+        }
+
+        /** Computes both the incident and reflected waves at this root node. */
+        inline void compute() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            if (results.consume())
+                applyResult (results.getReadBuffer());
+
+            if (crossfadeCounter > 0)
+                crossfadeStep();
+
+            rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
+                                          port.incident (b_vec[i]);
+                                          a_vec[i] = port.reflected(); },
+                                          downPorts);
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          downPorts);
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            // the incoming waves are stored between calls to compute()
+            for (int i = 0; i < numPorts; ++i)
+                visitor (a_vec[i]);
+        }
+
+    private:
+        using Matrix = rtype_detail::Matrix<T, numPorts>;
+
+        /** A snapshot of the port impedances, sent to the background thread */
+        struct Request
+        {
+            std::array<T, numPorts> impedances {};
+            uint64_t index = 0;
+        };
+
+        /** A scattering matrix, sent back from the background thread */
+        struct Result
+        {
+            Matrix S;
+            uint64_t index = 0;
+        };
+
+        /** Stands in for the R-Type when the ImpedanceCalculator is called */
+        struct MatrixCalculator
+        {
+            static constexpr auto numPorts = AsyncRootRtypeAdaptor::numPorts;
+
+            std::array<T, numPorts> getPortImpedances() const noexcept { return impedances; }
+
+            void setSMatrixData (const T (&mat)[numPorts][numPorts])
+            {
+                for (int i = 0; i < numPorts; ++i)
+                    for (int j = 0; j < numPorts; ++j)
+                        S[j][i] = mat[i][j];
+            }
+
+            const std::array<T, numPorts> impedances;
+            Matrix& S;
+        };
+
+        static void clearMatrix (Matrix& mat) noexcept
+        {
+            for (int i = 0; i < numPorts; ++i)
+                mat[i].clear();
+        }
+
+        static void copyMatrix (Matrix& dest, const Matrix& src) noexcept
+        {
+            for (int i = 0; i < numPorts; ++i)
+                for (int j = 0; j < numPorts; ++j)
+                    dest[i][j] = src[i][j];
+        }
+
+        void applyResult (const Result& result) noexcept
+        {
+            // a newer matrix has already been computed with calcImpedanceNow()
+            if (result.index <= appliedRequestIndex)
+                return;
+
+            appliedRequestIndex = result.index;
+            if (crossfadeLength == 0)
+            {
+                copyMatrix (S_matrix, result.S);
+                crossfadeCounter = 0;
+                return;
+            }
+
+            // start from the current matrix, in case the previous crossfade hasn't finished
+            copyMatrix (S_start, S_matrix);
+            copyMatrix (S_target, result.S);
+            crossfadeCounter = crossfadeLength;
+        }
+
+        void crossfadeStep() noexcept
+        {
+            crossfadeCounter--;
+            const auto gain = (T) ((NumericType<T>) crossfadeCounter / (NumericType<T>) crossfadeLength);
+            for (int i = 0; i < numPorts; ++i)
+                for (int j = 0; j < numPorts; ++j)
+                    S_matrix[i][j] = S_target[i][j] + gain * (S_start[i][j] - S_target[i][j]);
+        }
+
+        void backgroundThreadLoop()
+        {
+            while (true)
+            {
+                requestsPublished.wait ([this]
+                                        { return requests.hasNewData() || shouldQuit.load (std::memory_order_acquire); });
+
+                if (shouldQuit.load (std::memory_order_acquire))
+                    return;
+
+                if (! requests.consume())
+                    continue;
+
+                const auto& request = requests.getReadBuffer();
+                auto& result = results.getWriteBuffer();
+                MatrixCalculator calculator { request.impedances, result.S };
+                ImpedanceCalculator::calcImpedance (calculator);
+                result.index = request.index;
+
+                results.publish();
+                completedRequestIndex.store (request.index, std::memory_order_release);
+            }
+        }
+
+        std::tuple<PortTypes&...> downPorts; // tuple of ports connected to RtypeAdaptor
+
+        Matrix S_matrix; // square matrix representing S
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
+
+        Matrix S_start; // crossfade from this matrix...
+        Matrix S_target; // ... to this matrix
+        int crossfadeLength = 0;
+        int crossfadeCounter = 0;
+
+        rtype_detail::TripleBuffer<Request> requests; // audio thread -> background thread
+        rtype_detail::TripleBuffer<Result> results; // background thread -> audio thread
+        uint64_t lastRequestIndex = 0;
+        uint64_t appliedRequestIndex = 0;
+        std::atomic<uint64_t> completedRequestIndex { 0 };
+
+        spin_detail::WakeupSignal requestsPublished; // wakes up the background thread
+        std::atomic<bool> shouldQuit { false };
+        std::thread backgroundThread;
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_ASYNC_ROOT_RTYPE_ADAPTOR_H
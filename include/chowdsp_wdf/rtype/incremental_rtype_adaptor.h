@@ -0,0 +1,546 @@
+#ifndef CHOWDSP_WDF_INCREMENTAL_RTYPE_ADAPTOR_H
+#define CHOWDSP_WDF_INCREMENTAL_RTYPE_ADAPTOR_H
+
+#include <cmath>
+#include <limits>
+
+#include "../wdft/wdft_base.h"
+#include "rtype_detail.h"
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** The circuit nodes that an R-Type port is connected between. Node 0 is the datum (or "ground") node. */
+    struct RtypePortNodes
+    {
+        int positive;
+        int negative;
+    };
+
+#ifndef DOXYGEN
+    namespace rtype_detail
+    {
+        /**
+         * Returns true if a scattering matrix with numPorts ports and numNodes (non-datum) nodes
+         * is cheaper to apply as low-rank factors, than as a dense numPorts x numPorts matrix.
+         */
+        constexpr bool useLowRankScattering (int numNodes, int numPorts)
+        {
+            return numNodes + 1 < numPorts;
+        }
+
+        /**
+         * Computes the scattering matrix of an R-Type adaptor from its topology, keeps it up to
+         * date when the port impedances change, and applies it to the incident waves.
+         *
+         * For an R-Type adaptor which only connects its ports together (i.e. with no internal
+         * elements), the nodal admittance matrix is X = Q G Q^T, where Q is the node-port incidence
+         * matrix and G holds the port admittances. The scattering matrix is then S = 2 Q^T Y G - I,
+         * with Y = X^-1 Q. When the admittance of port i changes by dG, X changes by dG q_i q_i^T, so
+         * Y can be updated with the Sherman-Morrison formula, using only column i of Y:
+         *     Y' = Y - dG y_i (q_i^T Y) / (1 + dG q_i^T y_i)
+         * which costs O(numNodes * numPorts), rather than the O(numNodes^3) of a full recomputation.
+         *
+         * S has rank numNodes at most, so when the circuit has few nodes compared to the number of
+         * ports, S is never formed. Instead, the incident waves are scattered as b = 2 Q^T (V a) - a,
+         * with V = Y G: a numNodes x numPorts matrix-vector product, followed by a sparse product with
+         * the incidence matrix, which only takes the difference between the two nodes of each port.
+         * This needs (numNodes + 1) * numPorts multiply-adds, rather than numPorts^2.
+         *
+         * If adaptedPort is a valid port index, that port is adapted: its admittance is left out of X,
+         * and its impedance is chosen so that the port is reflection-free.
+         */
+        template <typename T, typename Topology, int numPorts, int adaptedPort = -1>
+        class NodalScatteringMatrix
+        {
+        public:
+            static constexpr int numNodes = Topology::numNodes;
+            static constexpr bool isLowRank = useLowRankScattering (numNodes, numPorts);
+
+            NodalScatteringMatrix()
+            {
+                for (int i = 0; i < numPorts; ++i)
+                    portNodes[i] = Topology::getPortNodes (i);
+
+                upPortRow.clear();
+            }
+
+            /** Sets the number of incremental updates after which Y is recomputed from scratch. */
+            void setFullUpdateInterval (int numUpdates) noexcept { fullUpdateInterval = numUpdates > 1 ? numUpdates : 1; }
+
+            /** Returns the number of full recomputations of Y (mostly useful for testing). */
+            int getNumFullUpdates() const noexcept { return numFullUpdates; }
+
+            /** Updates the scattering matrix for a new set of port impedances. */
+            void update (const std::array<T, numPorts>& portImpedances)
+            {
+                T newG[numPorts];
+                int numChanged = 0;
+                for (int i = 0; i < numPorts; ++i)
+                {
+                    newG[i] = i == adaptedPort ? (T) 0 : (T) 1 / portImpedances[i];
+                    numChanged += all (newG[i] == G[i]) ? 0 : 1;
+                }
+
+                if (! isInitialised || updatesSinceFullUpdate + numChanged > fullUpdateInterval || numChanged * incrementalCost > fullCost)
+                {
+                    for (int i = 0; i < numPorts; ++i)
+                        G[i] = newG[i];
+                    fullUpdate();
+                }
+                else if (numChanged > 0)
+                {
+                    // several ports changing at once become a sequence of rank-1 updates
+                    bool isWellConditioned = true;
+                    for (int i = 0; i < numPorts && isWellConditioned; ++i)
+                    {
+                        if (! all (newG[i] == G[i]))
+                            isWellConditioned = rankOneUpdate (Y, i, newG[i] - G[i]);
+                        G[i] = newG[i];
+                    }
+
+                    if (isWellConditioned)
+                    {
+                        updatesSinceFullUpdate += numChanged;
+                    }
+                    else
+                    {
+                        for (int i = 0; i < numPorts; ++i)
+                            G[i] = newG[i];
+                        fullUpdate();
+                    }
+                }
+
+                computeScatteringData();
+            }
+
+            /** Returns the impedance of the adapted port. */
+            T getAdaptedImpedance() const noexcept { return adaptedImpedance; }
+
+            /** Computes the reflected waves, b = S a */
+            void scatter (const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_) noexcept
+            {
+                scatter (a_, b_, std::integral_constant<bool, isLowRank> {});
+            }
+
+            /** Computes the reflected wave at the adapted port, using only the corresponding row of S. */
+            T scatterAdaptedPort (const AlignedArray<T, numPorts>& a_) const noexcept
+            {
+                T b = upPortRow[0] * a_[0];
+                for (int c = 1; c < numPorts; ++c)
+                    b += upPortRow[c] * a_[c];
+                return b;
+            }
+
+        private:
+            static constexpr int fullCost = numNodes * numNodes * numNodes / 3 + numNodes * numNodes * numPorts;
+            static constexpr int incrementalCost = numNodes * numPorts;
+
+            /** Returns (q_port^T mat)[col], i.e. the difference between the port's nodes, in column col of mat. */
+            T nodeDifference (const T (*mat)[numPorts], int port, int col) const noexcept
+            {
+                const auto& nodes = portNodes[port];
+                return (nodes.positive > 0 ? mat[nodes.positive - 1][col] : (T) 0)
+                       - (nodes.negative > 0 ? mat[nodes.negative - 1][col] : (T) 0);
+            }
+
+            /**
+             * Applies the Sherman-Morrison update to mat, for port's admittance changing by deltaG.
+             *
+             * The denominator, 1 + dG q_i^T y_i, is the ratio of the determinants of X after and before
+             * the update. It gets close to zero when the port held up most of the admittance between
+             * its nodes, and that admittance is removed (e.g. a pot going from 0 Ohms to its full
+             * resistance), and very large in the opposite case. Either way, the update cancels out most
+             * of mat, leaving mostly rounding error, so then mat is left unchanged, and this returns false,
+             * so that it can be recomputed instead.
+             */
+            bool rankOneUpdate (T (&mat)[numNodes][numPorts], int port, T deltaG) const noexcept
+            {
+                T y_i[numNodes];
+                for (int n = 0; n < numNodes; ++n)
+                    y_i[n] = mat[n][port];
+
+                T qY_i[numPorts];
+                for (int c = 0; c < numPorts; ++c)
+                    qY_i[c] = nodeDifference (mat, port, c);
+
+                const auto denominator = (T) 1 + deltaG * qY_i[port];
+                if (! all (denominator >= (T) minDenominator()) || ! all (denominator <= (T) 1 / (T) minDenominator()))
+                    return false;
+
+                const auto scale = deltaG / denominator;
+                for (int n = 0; n < numNodes; ++n)
+                    for (int c = 0; c < numPorts; ++c)
+                        mat[n][c] -= scale * y_i[n] * qY_i[c];
+
+                return true;
+            }
+
+            /**
+             * The smallest Sherman-Morrison denominator (and the reciprocal of the largest) for which
+             * an update is accepted. Each accepted update can lose up to a quarter of the available
+             * precision, and the periodic full updates stop those losses from adding up further.
+             */
+            static NumericType<T> minDenominator() noexcept
+            {
+                return std::sqrt (std::sqrt (std::numeric_limits<NumericType<T>>::epsilon()));
+            }
+
+            /** Recomputes Y = X^-1 Q, with X = Q G Q^T. */
+            void fullUpdate()
+            {
+                T X[numNodes][numNodes] {};
+                for (int n = 0; n < numNodes; ++n)
+                    for (int i = 0; i < numPorts; ++i)
+                        Y[n][i] = (T) 0;
+
+                for (int i = 0; i < numPorts; ++i)
+                {
+                    const auto p = portNodes[i].positive - 1;
+                    const auto m = portNodes[i].negative - 1;
+                    if (p >= 0)
+                    {
+                        X[p][p] += G[i];
+                        Y[p][i] = (T) 1;
+                    }
+                    if (m >= 0)
+                    {
+                        X[m][m] += G[i];
+                        Y[m][i] = (T) -1;
+                    }
+                    if (p >= 0 && m >= 0)
+                    {
+                        X[p][m] -= G[i];
+                        X[m][p] -= G[i];
+                    }
+                }
+
+                // X is symmetric positive definite (for a connected circuit), so no pivoting is needed.
+                // Solve X Y = Q, by Gaussian elimination...
+                for (int k = 0; k < numNodes; ++k)
+                {
+                    for (int r = k + 1; r < numNodes; ++r)
+                    {
+                        const auto factor = X[r][k] / X[k][k];
+                        for (int c = k; c < numNodes; ++c)
+                            X[r][c] -= factor * X[k][c];
+                        for (int i = 0; i < numPorts; ++i)
+                            Y[r][i] -= factor * Y[k][i];
+                    }
+                }
+
+                // ... and back substitution
+                for (int k = numNodes - 1; k >= 0; --k)
+                {
+                    for (int i = 0; i < numPorts; ++i)
+                    {
+                        for (int c = k + 1; c < numNodes; ++c)
+                            Y[k][i] -= X[k][c] * Y[c][i];
+                        Y[k][i] /= X[k][k];
+                    }
+                }
+
+                isInitialised = true;
+                updatesSinceFullUpdate = 0;
+                numFullUpdates++;
+            }
+
+            /** Computes either S = 2 Q^T Y G - I (transposed, as used by RtypeScatter), or its factors V = Y G. */
+            void computeScatteringData() noexcept
+            {
+                T G_S[numPorts];
+                for (int i = 0; i < numPorts; ++i)
+                    G_S[i] = G[i];
+
+                const T(*Y_S)[numPorts] = Y;
+                if (adaptedPort >= 0)
+                {
+                    // connect the adapted port, with the impedance that makes it reflection-free
+                    const auto upPort = adaptedPort < 0 ? 0 : adaptedPort;
+                    for (int n = 0; n < numNodes; ++n)
+                        for (int c = 0; c < numPorts; ++c)
+                            Y_adapted[n][c] = Y[n][c];
+
+                    adaptedImpedance = nodeDifference (Y, upPort, upPort);
+                    G_S[upPort] = (T) 1 / adaptedImpedance;
+                    rankOneUpdate (Y_adapted, upPort, G_S[upPort]); // the denominator is always 2 here
+                    Y_S = Y_adapted;
+
+                    for (int c = 0; c < numPorts; ++c)
+                        upPortRow[c] = (T) 2 * nodeDifference (Y_adapted, upPort, c) * G_S[c] - (c == upPort ? (T) 1 : (T) 0);
+                }
+
+                for (int c = 0; c < numPorts; ++c)
+                {
+                    for (int r = 0; r < numOutputs; ++r)
+                    {
+                        if (isLowRank)
+                            scatteringData[c][r] = Y_S[r][c] * G_S[c];
+                        else
+                            scatteringData[c][r] = (T) 2 * nodeDifference (Y_S, r, c) * G_S[c] - (r == c ? (T) 1 : (T) 0);
+                    }
+                }
+            }
+
+            void scatter (const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_, std::true_type) noexcept
+            {
+                // V a has only a few outputs, but each has numPorts terms, so the sums are split up
+                // into independent partial sums, rather than waiting on one long chain of additions
+                constexpr int numPartials = 4;
+                T partials[numPartials][numNodes] {};
+                for (int c = 0; c < numPorts; ++c)
+                    for (int n = 0; n < numNodes; ++n)
+                        partials[c % numPartials][n] += scatteringData[c][n] * a_[c];
+
+                for (int n = 0; n < numNodes; ++n)
+                    nodeWaves[n + 1] = (partials[0][n] + partials[1][n]) + (partials[2][n] + partials[3][n]);
+
+                // the topology is known at compile-time, so once this loop is unrolled, the node lookups can be too
+                for (int i = 0; i < numPorts; ++i)
+                {
+                    const auto nodes = Topology::getPortNodes (i);
+                    b_[i] = (T) 2 * (nodeWaves[nodes.positive] - nodeWaves[nodes.negative]) - a_[i];
+                }
+            }
+
+            void scatter (const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_, std::false_type) noexcept
+            {
+                RtypeScatter (scatteringData, a_, b_);
+            }
+
+            static constexpr int numOutputs = isLowRank ? numNodes : numPorts;
+
+            RtypePortNodes portNodes[numPorts] {};
+            T G[numPorts] {}; // port admittances
+            T Y[numNodes][numPorts] {}; // X^-1 Q
+            T Y_adapted[numNodes][numPorts] {}; // Y, including the adapted port
+            T adaptedImpedance {};
+
+            Matrix<T, numOutputs, numPorts> scatteringData; // S (transposed), or its low-rank factors V
+            T nodeWaves[numNodes + 1] {}; // V a, with the datum node first
+            AlignedArray<T, adaptedPort >= 0 ? numPorts : 1> upPortRow; // the row of S for the adapted port
+
+            bool isInitialised = false;
+            int updatesSinceFullUpdate = 0;
+            int fullUpdateInterval = 64;
+            int numFullUpdates = 0;
+        };
+    } // namespace rtype_detail
+#endif // DOXYGEN
+
+    /**
+     *  A non-adaptable R-Type adaptor, which computes its own scattering matrix from the
+     *  circuit topology, and updates it incrementally when only some of the port impedances change.
+     *
+     *  Rather than an ImpedanceCalculator, this adaptor takes a Topology, describing which nodes
+     *  each port is connected between (see RtypePortNodes). Node 0 is the datum node, and the
+     *  other nodes are numbered from 1 to numNodes:
+     *  @code
+     *  struct Topology
+     *  {
+     *      static constexpr int numNodes = 3;
+     *      static wdft::RtypePortNodes getPortNodes (int portIndex)
+     *      {
+     *          constexpr wdft::RtypePortNodes nodes[] = { { 2, 0 }, { 3, 0 }, { 2, 3 }, { 1, 3 }, { 1, 2 }, { 0, 1 } };
+     *          return nodes[portIndex];
+     *      }
+     *  };
+     *  @endcode
+     *
+     *  The R-Type must only connect its ports together, without any internal elements (e.g. a
+     *  controlled source), and every node must be connected to the datum node through the ports.
+     *  When a single port impedance changes (e.g. one pot moving), the scattering matrix is
+     *  updated with a rank-1 (Sherman-Morrison) update, in O(numNodes * numPorts) operations. A few
+     *  ports changing at once become a sequence of rank-1 updates, and if enough ports change that
+     *  a full recomputation would be cheaper, the matrix is recomputed from scratch. To stop
+     *  rounding errors from building up, the matrix is also recomputed from scratch after every
+     *  64 incremental updates, which can be changed with setFullUpdateInterval(), or whenever
+     *  a rank-1 update would be ill-conditioned (e.g. a pot going from 0 Ohms to its full resistance).
+     *
+     *  The rank of the scattering matrix is at most numNodes, so for adaptors with many ports
+     *  but only a few nodes (e.g. a large parallel junction), the scattering matrix is stored
+     *  as its low-rank factors, and applied in O(numNodes * numPorts) operations per sample,
+     *  rather than the O(numPorts^2) of the dense matrix. This is chosen automatically at
+     *  compile-time, whenever numNodes + 1 < numPorts.
+     */
+    template <typename T, typename Topology, typename... PortTypes>
+    class IncrementalRootRtypeAdaptor : public RootWDF
+    {
+    public:
+        /** Number of ports connected to IncrementalRootRtypeAdaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+
+        explicit IncrementalRootRtypeAdaptor (PortTypes&... dps) : downPorts (std::tie (dps...))
+        {
+            b_vec.clear();
+            a_vec.clear();
+
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
+                                          downPorts);
+            calcImpedance();
+        }
+
+        /** Updates the scattering matrix, based on the incoming impedances */
+        void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            scatteringMatrix.update (getPortImpedances());
+        }
+
+        /** Sets the number of incremental updates after which the scattering matrix is recomputed from scratch. */
+        void setFullUpdateInterval (int numUpdates) noexcept { scatteringMatrix.setFullUpdateInterval (numUpdates); }
+
+        /** Returns the number of times the scattering matrix has been recomputed from scratch. */
+        int getNumFullUpdates() const noexcept { return scatteringMatrix.getNumFullUpdates(); }
+
+        constexpr auto getPortImpedances()
+        {
+            std::array<T, numPorts> portImpedances {};
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { portImpedances[i] = port.wdf.R; },
+                                          downPorts);
+
+            return portImpedances;
+        }
+
+        /** Computes both the incident and reflected waves at this root node. */
+        inline void compute() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            scatteringMatrix.scatter (a_vec, b_vec);
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
+                                          port.incident (b_vec[i]);
+                                          a_vec[i] = port.reflected(); },
+                                          downPorts);
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          downPorts);
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            // the incoming waves are stored between calls to compute()
+            for (int i = 0; i < numPorts; ++i)
+                visitor (a_vec[i]);
+        }
+
+    private:
+        std::tuple<PortTypes&...> downPorts; // tuple of ports connected to RtypeAdaptor
+
+        rtype_detail::NodalScatteringMatrix<T, Topology, numPorts> scatteringMatrix;
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
+    };
+
+    /**
+     *  An adaptable R-Type adaptor, which computes its own scattering matrix from the circuit
+     *  topology, and updates it incrementally when only some of the port impedances change.
+     *
+     *  This works the same way as IncrementalRootRtypeAdaptor, except that the Topology also
+     *  includes the upward-facing port, at upPortIndex. The impedance of the upward-facing port
+     *  is the impedance of the rest of the circuit, as seen from that port.
+     */
+    template <typename T, int upPortIndex, typename Topology, typename... PortTypes>
+    class IncrementalRtypeAdaptor : public BaseWDF
+    {
+    public:
+        /** Number of ports connected to IncrementalRtypeAdaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes) + 1);
+
+        explicit IncrementalRtypeAdaptor (PortTypes&... dps) : downPorts (std::tie (dps...))
+        {
+            b_vec.clear();
+            a_vec.clear();
+
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
+                                          downPorts);
+            calcImpedance();
+        }
+
+        /** Updates the scattering matrix, and re-computes the port impedance at the adapted upward-facing port */
+        void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            scatteringMatrix.update (getPortImpedances());
+            wdf.R = scatteringMatrix.getAdaptedImpedance();
+            wdf.G = (T) 1 / wdf.R;
+        }
+
+        /** Sets the number of incremental updates after which the scattering matrix is recomputed from scratch. */
+        void setFullUpdateInterval (int numUpdates) noexcept { scatteringMatrix.setFullUpdateInterval (numUpdates); }
+
+        /** Returns the number of times the scattering matrix has been recomputed from scratch. */
+        int getNumFullUpdates() const noexcept { return scatteringMatrix.getNumFullUpdates(); }
+
+        /** Returns the port impedances, with a placeholder for the (adapted) upward-facing port. */
+        constexpr auto getPortImpedances()
+        {
+            std::array<T, numPorts> portImpedances {};
+            portImpedances[upPortIndex] = (T) 1;
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { portImpedances[getPortIndex ((int) i)] = port.wdf.R; },
+                                          downPorts);
+
+            return portImpedances;
+        }
+
+        /** Computes the incident wave. */
+        inline void incident (T downWave) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = downWave;
+            a_vec[upPortIndex] = wdf.a;
+
+            scatteringMatrix.scatter (a_vec, b_vec);
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
+                                              auto portIndex = getPortIndex ((int) i);
+                                              port.incident (b_vec[portIndex]); },
+                                          downPorts);
+        }
+
+        /** Computes the reflected wave */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
+                                              auto portIndex = getPortIndex ((int) i);
+                                              a_vec[portIndex] = port.reflected(); },
+                                          downPorts);
+
+            // S[upPortIndex][upPortIndex] is zero, so this is fine without a fresh a_vec[upPortIndex].
+            wdf.b = scatteringMatrix.scatterAdaptedPort (a_vec);
+            return wdf.b;
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          downPorts);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        constexpr auto getPortIndex (int tupleIndex)
+        {
+            return tupleIndex < upPortIndex ? tupleIndex : tupleIndex + 1;
+        }
+
+        std::tuple<PortTypes&...> downPorts; // tuple of ports connected to RtypeAdaptor
+
+        rtype_detail::NodalScatteringMatrix<T, Topology, numPorts, upPortIndex> scatteringMatrix;
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_INCREMENTAL_RTYPE_ADAPTOR_H
@@ -46,6 +46,7 @@ namespace wdft
         /** Recomputes internal variables based on the incoming impedances */
         void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             ImpedanceCalculator::calcImpedance (*this);
         }
 
@@ -69,6 +70,7 @@ namespace wdft
         /** Computes both the incident and reflected waves at this root node. */
         inline void compute() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
             rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
                                           port.incident (b_vec[i]);
@@ -76,6 +78,23 @@ namespace wdft
                                           downPorts);
         }
 
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          downPorts);
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            // the incoming waves are stored between calls to compute()
+            for (int i = 0; i < numPorts; ++i)
+                visitor (a_vec[i]);
+        }
+
     private:
         std::tuple<PortTypes&...> downPorts; // tuple of ports connected to RtypeAdaptor
 
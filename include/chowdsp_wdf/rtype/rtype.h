@@ -3,6 +3,8 @@
 
 #include "rtype_adaptor.h"
 #include "root_rtype_adaptor.h"
+#include "incremental_rtype_adaptor.h"
 #include "wdf_rtype.h"
+#include "wdf_fixed_size_rtype.h"
 
 #endif // CHOWDSP_WDF_RTYPE_H_INCLUDED
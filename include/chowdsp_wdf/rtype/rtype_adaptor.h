@@ -48,6 +48,7 @@ namespace wdft
         /** Re-computes the port impedance at the adapted upward-facing port */
         void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = ImpedanceCalculator::calcImpedance (*this);
             wdf.G = (T) 1 / wdf.R;
         }
@@ -72,6 +73,7 @@ namespace wdft
         /** Computes the incident wave. */
         inline void incident (T downWave) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = downWave;
             a_vec[upPortIndex] = wdf.a;
 
@@ -85,6 +87,7 @@ namespace wdft
         /** Computes the reflected wave */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
                                               auto portIndex = getPortIndex ((int) i);
                                               a_vec[portIndex] = port.reflected(); },
@@ -95,6 +98,14 @@ namespace wdft
             return wdf.b;
         }
 
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          downPorts);
+        }
+
         WDFMembers<T> wdf;
 
     private:
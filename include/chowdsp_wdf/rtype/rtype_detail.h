@@ -5,6 +5,8 @@
 #include <algorithm>
 #include <initializer_list>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace chowdsp
@@ -150,6 +152,72 @@ namespace wdf
     {
         using wdft::rtype_detail::ceil_div;
 
+        template <typename Signature>
+        class FunctionRef;
+
+        /**
+         * A non-owning, non-allocating reference to a callable, similar to std::function,
+         * but without the heap allocation or type-erased copies.
+         *
+         * Function pointers (and lambdas without captures) are stored by value, so they
+         * are always safe to use. Any other callable is stored by reference, so it must
+         * outlive the FunctionRef. To catch the most common mistake, temporary callables
+         * which can't be converted to a function pointer are not accepted.
+         */
+        template <typename R, typename... Args>
+        class FunctionRef<R (Args...)>
+        {
+        public:
+            using FunctionPointer = R (*) (Args...);
+
+            /** Wraps a function pointer. */
+            FunctionRef (FunctionPointer fn) noexcept : trampoline (&callFunction) { target.function = fn; }
+
+            /** Wraps a lambda without captures (or anything else convertible to a function pointer). */
+            template <typename Fn,
+                      typename = std::enable_if_t<std::is_convertible<Fn&&, FunctionPointer>::value
+                                                  && ! std::is_same<std::decay_t<Fn>, FunctionRef>::value>>
+            FunctionRef (Fn&& fn) noexcept : FunctionRef (static_cast<FunctionPointer> (fn))
+            {
+            }
+
+            /** Wraps a reference to a callable object, which must outlive the FunctionRef. */
+            template <typename Fn,
+                      typename = std::enable_if_t<! std::is_convertible<Fn&, FunctionPointer>::value
+                                                  && ! std::is_same<std::remove_const_t<Fn>, FunctionRef>::value>,
+                      typename = void>
+            FunctionRef (Fn& fn) noexcept : trampoline (&callObject<Fn>)
+            {
+                target.object = (void*) &fn;
+            }
+
+            R operator() (Args... args) const
+            {
+                return trampoline (target, std::forward<Args> (args)...);
+            }
+
+        private:
+            union Target
+            {
+                void* object;
+                FunctionPointer function;
+            };
+
+            static R callFunction (const Target& target, Args... args)
+            {
+                return target.function (std::forward<Args> (args)...);
+            }
+
+            template <typename Fn>
+            static R callObject (const Target& target, Args... args)
+            {
+                return (*(Fn*) target.object) (std::forward<Args> (args)...);
+            }
+
+            Target target;
+            R (*trampoline) (const Target&, Args...);
+        };
+
         template <typename T>
         typename std::enable_if<std::is_floating_point<T>::value, size_t>::type array_pad (size_t base_size)
         {
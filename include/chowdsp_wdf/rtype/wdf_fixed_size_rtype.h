@@ -0,0 +1,223 @@
+#ifndef CHOWDSP_WDF_WDF_FIXED_SIZE_RTYPE_H
+#define CHOWDSP_WDF_WDF_FIXED_SIZE_RTYPE_H
+
+#include <algorithm>
+#include <stdexcept>
+#include "../wdf/wdf_base.h"
+#include "rtype_detail.h"
+
+namespace chowdsp
+{
+namespace wdf
+{
+    /**
+     *  A non-adaptable R-Type adaptor, with the number of ports known at compile-time.
+     *
+     *  This works the same way as RootRtypeAdaptor, and can be used in the same run-time
+     *  WDF trees, but the scattering matrix and wave vectors are stored inline (rather
+     *  than on the heap), and the scattering is done with the same fixed-size routines as
+     *  wdft::RootRtypeAdaptor. The impedance calculator is a non-allocating FunctionRef
+     *  rather than a std::function, so a lambda without captures (or a function pointer)
+     *  can be assigned directly. A callable with captures must outlive the adaptor.
+     *
+     *  The list of ports must contain numPorts ports.
+     */
+    template <typename T, int numPorts>
+    class FixedSizeRootRtypeAdaptor : public WDF<T>
+    {
+    public:
+        using ImpedanceCalculator = rtype_detail::FunctionRef<void (FixedSizeRootRtypeAdaptor&)>;
+
+        /** Throws std::invalid_argument unless the list contains numPorts (non-null) ports. */
+        FixedSizeRootRtypeAdaptor (std::initializer_list<WDF<T>*> dps)
+            : WDF<T> ("Root R-Type Adaptor")
+        {
+            if ((int) dps.size() != numPorts || std::find (dps.begin(), dps.end(), nullptr) != dps.end())
+                throw std::invalid_argument ("FixedSizeRootRtypeAdaptor needs a list of exactly numPorts ports!");
+
+            std::copy (dps.begin(), dps.end(), downPorts);
+            for (auto* port : downPorts)
+                port->connectToParent (this);
+
+            a_vec.clear();
+            b_vec.clear();
+        }
+
+        /** Returns the number of ports connected to FixedSizeRootRtypeAdaptor */
+        static constexpr size_t getNumPorts() noexcept { return (size_t) numPorts; }
+
+        /**
+         * Returns the port impedance for the given port index.
+         * Note: it is the caller's responsibility to ensure that the portIndex is in range!
+         */
+        T getPortImpedance (size_t portIndex) const noexcept { return downPorts[portIndex]->wdf.R; }
+
+        /** Recomputes internal variables based on the incoming impedances */
+        void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            impedanceCalculator (*this);
+        }
+
+        /** Use this function to set the scattering matrix data. */
+        void setSMatrixData (const T (&mat)[numPorts][numPorts])
+        {
+            for (int i = 0; i < numPorts; ++i)
+                for (int j = 0; j < numPorts; ++j)
+                    S_matrix[j][i] = mat[i][j];
+        }
+
+        /** Computes both the incident and reflected waves at this root node. */
+        inline void compute() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdft::rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+
+            for (int i = 0; i < numPorts; ++i)
+            {
+                downPorts[i]->incident (b_vec[i]);
+                a_vec[i] = downPorts[i]->reflected();
+            }
+        }
+
+        /** Implement this function to set the scattering matrix when an incoming impedance changes */
+        ImpedanceCalculator impedanceCalculator = [] (FixedSizeRootRtypeAdaptor&) {};
+
+        /** Visits each of the ports connected to this adaptor. */
+        void visitConnectedPorts (typename WDF<T>::PortVisitor& visitor) override
+        {
+            for (auto* port : downPorts)
+                visitor.visit (*port);
+        }
+
+        /** Visits the incoming waves, which are stored between calls to compute(). */
+        void visitInternalState (typename WDF<T>::StateVisitor& visitor) override
+        {
+            for (int i = 0; i < numPorts; ++i)
+                visitor.visit (a_vec[i]);
+        }
+
+    private:
+        void incident (T) noexcept override {}
+        T reflected() noexcept override { return T {}; }
+
+        WDF<T>* downPorts[numPorts] {};
+
+        wdft::rtype_detail::Matrix<T, numPorts> S_matrix; // square matrix representing S
+        wdft::rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
+        wdft::rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
+    };
+
+    /**
+     *  An adaptable R-Type adaptor, with the number of ports known at compile-time.
+     *
+     *  This works the same way as RtypeAdaptor, with the same storage as FixedSizeRootRtypeAdaptor.
+     *  numPorts is the size of the scattering matrix, including the upward-facing port, so the list
+     *  of ports must contain numPorts - 1 ports.
+     */
+    template <typename T, int numPorts>
+    class FixedSizeRtypeAdaptor : public WDF<T>
+    {
+    public:
+        using ImpedanceCalculator = rtype_detail::FunctionRef<T (FixedSizeRtypeAdaptor&)>;
+
+        /**
+         * The upPortIndex argument describes with port of the scattering matrix is being adapted.
+         * Throws std::invalid_argument unless the list contains numPorts - 1 (non-null) ports,
+         * and upPortIndex is in the range [0, numPorts).
+         */
+        FixedSizeRtypeAdaptor (std::initializer_list<WDF<T>*> dps, int upPortIndex)
+            : WDF<T> ("R-Type Adaptor"),
+              m_upPortIndex (upPortIndex)
+        {
+            if ((int) dps.size() != numDownPorts || std::find (dps.begin(), dps.end(), nullptr) != dps.end())
+                throw std::invalid_argument ("FixedSizeRtypeAdaptor needs a list of exactly numPorts - 1 ports!");
+            if (upPortIndex < 0 || upPortIndex >= numPorts)
+                throw std::invalid_argument ("FixedSizeRtypeAdaptor upPortIndex is out of range!");
+
+            std::copy (dps.begin(), dps.end(), downPorts);
+            for (auto* port : downPorts)
+                port->connectToParent (this);
+
+            a_vec.clear();
+            b_vec.clear();
+        }
+
+        /** Returns the number of ports connected to FixedSizeRtypeAdaptor */
+        static constexpr size_t getNumPorts() noexcept { return (size_t) numPorts; }
+
+        /**
+         * Returns the port impedance for the given port index.
+         * Note: it is the caller's responsibility to ensure that the portIndex is in range!
+         */
+        T getPortImpedance (size_t portIndex) const noexcept { return downPorts[portIndex]->wdf.R; }
+
+        /** Recomputes internal variables based on the incoming impedances */
+        void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            this->wdf.R = impedanceCalculator (*this);
+            this->wdf.G = (T) 1 / this->wdf.R;
+        }
+
+        /** Use this function to set the scattering matrix data. */
+        void setSMatrixData (const T (&mat)[numPorts][numPorts])
+        {
+            for (int i = 0; i < numPorts; ++i)
+                for (int j = 0; j < numPorts; ++j)
+                    S_matrix[j][i] = mat[i][j];
+        }
+
+        /** Computes the incident wave. */
+        inline void incident (T downWave) noexcept override
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            this->wdf.a = downWave;
+            a_vec[m_upPortIndex] = this->wdf.a;
+
+            wdft::rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+            for (int i = 0; i < numDownPorts; ++i)
+                downPorts[i]->incident (b_vec[getPortIndex (i)]);
+        }
+
+        /** Computes the reflected wave */
+        inline T reflected() noexcept override
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            for (int i = 0; i < numDownPorts; ++i)
+                a_vec[getPortIndex (i)] = downPorts[i]->reflected();
+
+            // S_matrix[m_upPortIndex][m_upPortIndex] is zero, so this is fine without a fresh a_vec[m_upPortIndex].
+            this->wdf.b = wdft::rtype_detail::RtypeScatterSingle (S_matrix, a_vec, m_upPortIndex);
+            return this->wdf.b;
+        }
+
+        /** Implement this function to set the scattering matrix when an incoming impedance changes */
+        ImpedanceCalculator impedanceCalculator = [] (FixedSizeRtypeAdaptor&) { return (T) 1; };
+
+        /** Visits each of the ports connected to this adaptor. */
+        void visitConnectedPorts (typename WDF<T>::PortVisitor& visitor) override
+        {
+            for (auto* port : downPorts)
+                visitor.visit (*port);
+        }
+
+    private:
+        static constexpr int numDownPorts = numPorts - 1;
+
+        int getPortIndex (int arrayIndex) const noexcept
+        {
+            return arrayIndex < m_upPortIndex ? arrayIndex : arrayIndex + 1;
+        }
+
+        const int m_upPortIndex;
+        WDF<T>* downPorts[numDownPorts] {};
+
+        wdft::rtype_detail::Matrix<T, numPorts> S_matrix; // square matrix representing S
+        wdft::rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
+        wdft::rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
+    };
+} // namespace wdf
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDF_FIXED_SIZE_RTYPE_H
@@ -40,6 +40,7 @@ namespace wdf
         /** Recomputes internal variables based on the incoming impedances */
         void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             impedanceCalculator (*this);
         }
 
@@ -56,6 +57,7 @@ namespace wdf
         /** Computes both the incident and reflected waves at this root node. */
         inline void compute() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
 
             int i = 0;
@@ -70,6 +72,20 @@ namespace wdf
         /** Implement this function to set the scattering matrix when an incoming impedance changes */
         std::function<void (RootRtypeAdaptor&)> impedanceCalculator = [] (auto&) {};
 
+        /** Visits each of the ports connected to this adaptor. */
+        void visitConnectedPorts (typename WDF<T>::PortVisitor& visitor) override
+        {
+            for (auto* port : downPorts)
+                visitor.visit (*port);
+        }
+
+        /** Visits the incoming waves, which are stored between calls to compute(). */
+        void visitInternalState (typename WDF<T>::StateVisitor& visitor) override
+        {
+            for (int i = 0; i < a_vec.size(); ++i)
+                visitor.visit (a_vec[i]);
+        }
+
     private:
         void incident (T) noexcept override {}
         T reflected() noexcept override { return T {}; }
@@ -114,6 +130,7 @@ namespace wdf
         /** Recomputes internal variables based on the incoming impedances */
         void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             this->wdf.R = impedanceCalculator (*this);
             this->wdf.G = (T) 1 / this->wdf.R;
         }
@@ -131,6 +148,7 @@ namespace wdf
         /** Computes the incident wave. */
         inline void incident (T downWave) noexcept override
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             this->wdf.a = downWave;
             a_vec[m_upPortIndex] = this->wdf.a;
 
@@ -140,7 +158,7 @@ namespace wdf
             for (auto* port : downPorts)
             {
                 auto portIndex = getPortIndex (i);
-                port->incident (b_vec[i]);
+                port->incident (b_vec[portIndex]);
                 i++;
             }
         }
@@ -148,6 +166,7 @@ namespace wdf
         /** Computes the reflected wave */
         inline T reflected() noexcept override
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             int i = 0;
             for (auto* port : downPorts)
             {
@@ -164,6 +183,13 @@ namespace wdf
         /** Implement this function to set the scattering matrix when an incoming impedance changes */
         std::function<T (RtypeAdaptor&)> impedanceCalculator = [] (auto&) { return (T) 1; };
 
+        /** Visits each of the ports connected to this adaptor. */
+        void visitConnectedPorts (typename WDF<T>::PortVisitor& visitor) override
+        {
+            for (auto* port : downPorts)
+                visitor.visit (*port);
+        }
+
     private:
         int getPortIndex (int vectorIndex)
         {
@@ -0,0 +1,274 @@
+#ifndef CHOWDSP_WDF_CIRCUIT_PIPELINE_H
+#define CHOWDSP_WDF_CIRCUIT_PIPELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "spin_wait.h"
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** A lock-free single-producer, single-consumer ring buffer of samples. */
+    template <typename T>
+    class SampleRingBuffer
+    {
+    public:
+        /** Creates a ring buffer which can hold at least minCapacity samples. */
+        explicit SampleRingBuffer (size_t minCapacity)
+        {
+            size_t capacity = 2;
+            while (capacity < minCapacity)
+                capacity *= 2;
+            buffer.resize (capacity, (T) 0);
+        }
+
+        /** Returns the number of samples that can be read. */
+        size_t getNumReady() const noexcept
+        {
+            return (size_t) (writePosition.load (std::memory_order_acquire) - readPosition.load (std::memory_order_relaxed));
+        }
+
+        /** Returns the number of samples that can be written. */
+        size_t getNumFree() const noexcept
+        {
+            return buffer.size() - (size_t) (writePosition.load (std::memory_order_relaxed) - readPosition.load (std::memory_order_acquire));
+        }
+
+        /** Writes numSamples to the buffer. The caller must check that there is enough free space! */
+        void write (const T* data, size_t numSamples) noexcept
+        {
+            const auto writeIndex = writePosition.load (std::memory_order_relaxed);
+            for (size_t n = 0; n < numSamples; ++n)
+                buffer[(size_t) (writeIndex + n) & (buffer.size() - 1)] = data[n];
+            writePosition.store (writeIndex + numSamples, std::memory_order_release);
+        }
+
+        /** Reads numSamples from the buffer. The caller must check that there are enough samples ready! */
+        void read (T* data, size_t numSamples) noexcept
+        {
+            const auto readIndex = readPosition.load (std::memory_order_relaxed);
+            for (size_t n = 0; n < numSamples; ++n)
+                data[n] = buffer[(size_t) (readIndex + n) & (buffer.size() - 1)];
+            readPosition.store (readIndex + numSamples, std::memory_order_release);
+        }
+
+    private:
+        std::vector<T> buffer;
+
+        // padded, so that the reader and writer positions don't share a cache line
+        std::atomic<uint64_t> writePosition { 0 };
+        unsigned char padding[64] {};
+        std::atomic<uint64_t> readPosition { 0 };
+    };
+
+    /**
+     * Runs a cascade of circuits (e.g. input buffer -> tonestack -> clipper -> EQ), with
+     * each stage on its own worker thread, so that one heavy signal chain can be spread
+     * over several cores.
+     *
+     * The stages are connected by lock-free ring buffers. While one stage processes a block,
+     * the previous stage is already processing the next block, so the output is delayed by
+     * (numStages + extraLatencyBlocks) * maxBlockSize samples (see getLatencySamples()).
+     * The extra blocks of latency give the worker threads some slack, for when they are
+     * slow to wake up, or are interrupted by other threads.
+     *
+     * process() doesn't allocate memory or lock any mutexes. If the last stage hasn't
+     * finished by the time its output is needed, process() waits for it. This is always
+     * the case for offline rendering, where the output is identical to processing the
+     * stages in series (delayed by the latency). For live use, choose a latency large
+     * enough that process() doesn't wait; getNumLateBlocks() counts the waits.
+     * ```cpp
+     * // in prepare()...
+     * wdft::CircuitPipeline<float> pipeline { maxBlockSize, 1 };
+     * pipeline.addStage (tonestack); // each stage has a processBlock (float* buffer, int numSamples) method
+     * pipeline.addStage (clipper);
+     * pipeline.addStage (eq);
+     * pipeline.start();
+     * setLatencySamples (pipeline.getLatencySamples());
+     *
+     * // in the audio callback...
+     * pipeline.process (buffer, numSamples);
+     * ```
+     */
+    template <typename T>
+    class CircuitPipeline
+    {
+    public:
+        /** A callback which processes a block of numSamples samples in-place. */
+        using StageCallback = void (*) (void* context, T* buffer, int numSamples);
+
+        /** Creates a pipeline, which will process blocks of up to maxBlockSize samples. */
+        explicit CircuitPipeline (int maxBlockSize, int extraLatencyBlocks = 1)
+            : maxBlockSize (std::max (maxBlockSize, 1)),
+              extraLatencyBlocks (std::max (extraLatencyBlocks, 0))
+        {
+        }
+
+        ~CircuitPipeline() { stop(); }
+
+        CircuitPipeline (const CircuitPipeline&) = delete;
+        CircuitPipeline& operator= (const CircuitPipeline&) = delete;
+
+        /** Adds a stage to the end of the pipeline. This must not be called while the pipeline is running. */
+        bool addStage (StageCallback callback, void* context)
+        {
+            if (isRunning())
+                return false;
+
+            stages.push_back ({ callback, context });
+            return true;
+        }
+
+        /** Adds a stage with a `processBlock (T* buffer, int numSamples)` method to the end of the pipeline. */
+        template <typename StageType>
+        bool addStage (StageType& stage)
+        {
+            return addStage ([] (void* context, T* buffer, int numSamples)
+                             { static_cast<StageType*> (context)->processBlock (buffer, numSamples); },
+                             &stage);
+        }
+
+        /** Returns the number of stages in the pipeline. */
+        size_t getNumStages() const noexcept { return stages.size(); }
+
+        /** Returns the latency of the pipeline in samples. */
+        int getLatencySamples() const noexcept { return ((int) stages.size() + extraLatencyBlocks) * maxBlockSize; }
+
+        /** Returns true if the worker threads are running. */
+        bool isRunning() const noexcept { return ! workers.empty(); }
+
+        /**
+         * Allocates the ring buffers (filled with the latency worth of zeros),
+         * and starts a worker thread for each stage.
+         */
+        void start()
+        {
+            stop();
+
+            // the caller only takes out as many samples as it puts in, so the samples
+            // in flight (spread between all the ring buffers) never exceed this
+            const auto ringBufferSize = (size_t) (getLatencySamples() + 2 * maxBlockSize);
+            rings.clear();
+            for (size_t i = 0; i <= stages.size(); ++i)
+                rings.emplace_back (new SampleRingBuffer<T> (ringBufferSize));
+
+            std::vector<T> latencyZeros ((size_t) getLatencySamples(), (T) 0);
+            rings.back()->write (latencyZeros.data(), latencyZeros.size());
+
+            wakeups.clear();
+            for (size_t i = 0; i < stages.size(); ++i)
+                wakeups.emplace_back (new spin_detail::WakeupSignal());
+
+            numLateBlocks.store (0, std::memory_order_relaxed);
+            shouldQuit.store (false, std::memory_order_release);
+            for (size_t i = 0; i < stages.size(); ++i)
+                workers.emplace_back ([this, i]
+                                      { workerLoop (i); });
+        }
+
+        /** Stops the worker threads. Any samples still in the pipeline are discarded. */
+        void stop()
+        {
+            shouldQuit.store (true, std::memory_order_release);
+            for (auto& wakeup : wakeups)
+                wakeup->notify();
+            for (auto& worker : workers)
+                worker.join();
+            workers.clear();
+        }
+
+        /**
+         * Processes a block of samples in-place (numSamples must not be larger than maxBlockSize).
+         * The output is delayed by getLatencySamples(). If the pipeline is not running, the
+         * buffer is cleared.
+         */
+        void process (T* buffer, int numSamples) noexcept
+        {
+            if (! isRunning())
+            {
+                std::fill (buffer, buffer + numSamples, (T) 0);
+                return;
+            }
+
+            rings.front()->write (buffer, (size_t) numSamples);
+            wakeups.front()->notify();
+
+            auto& output = *rings.back();
+            if (output.getNumReady() < (size_t) numSamples)
+            {
+                numLateBlocks.fetch_add (1, std::memory_order_relaxed);
+                while (output.getNumReady() < (size_t) numSamples)
+                    spin_detail::pause();
+            }
+
+            output.read (buffer, (size_t) numSamples);
+            wakeups.back()->notify();
+        }
+
+        /** Returns the number of times that process() had to wait for the pipeline to catch up. */
+        uint64_t getNumLateBlocks() const noexcept { return numLateBlocks.load (std::memory_order_relaxed); }
+
+    private:
+        struct Stage
+        {
+            StageCallback callback;
+            void* context;
+        };
+
+        void workerLoop (size_t stageIndex)
+        {
+            const auto& stage = stages[stageIndex];
+            auto& input = *rings[stageIndex];
+            auto& output = *rings[stageIndex + 1];
+            std::vector<T> stageBuffer ((size_t) maxBlockSize, (T) 0);
+
+            // the stage is woken up when its input is written, or its output is read
+            auto& wakeup = *wakeups[stageIndex];
+            auto* previousStageWakeup = stageIndex > 0 ? wakeups[stageIndex - 1].get() : nullptr;
+            auto* nextStageWakeup = stageIndex + 1 < wakeups.size() ? wakeups[stageIndex + 1].get() : nullptr;
+
+            while (true)
+            {
+                size_t numSamples = 0;
+                wakeup.wait ([&]
+                             {
+                                 numSamples = std::min (input.getNumReady(), (size_t) maxBlockSize);
+                                 return shouldQuit.load (std::memory_order_acquire)
+                                        || (numSamples > 0 && output.getNumFree() >= numSamples); });
+                if (shouldQuit.load (std::memory_order_acquire))
+                    return;
+
+                input.read (stageBuffer.data(), numSamples);
+                if (previousStageWakeup != nullptr)
+                    previousStageWakeup->notify();
+
+                stage.callback (stage.context, stageBuffer.data(), (int) numSamples);
+
+                output.write (stageBuffer.data(), numSamples);
+                if (nextStageWakeup != nullptr)
+                    nextStageWakeup->notify();
+            }
+        }
+
+        const int maxBlockSize;
+        const int extraLatencyBlocks;
+
+        std::vector<Stage> stages;
+        std::vector<std::unique_ptr<SampleRingBuffer<T>>> rings;
+        std::vector<std::unique_ptr<spin_detail::WakeupSignal>> wakeups; // one per stage
+        std::vector<std::thread> workers;
+
+        std::atomic<uint64_t> numLateBlocks { 0 };
+        std::atomic<bool> shouldQuit { false };
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_CIRCUIT_PIPELINE_H
@@ -0,0 +1,323 @@
+#ifndef CHOWDSP_WDF_CIRCUIT_SCHEDULER_H
+#define CHOWDSP_WDF_CIRCUIT_SCHEDULER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "spin_wait.h"
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /**
+     * A fixed-size array, where each element starts on its own cache line,
+     * so that elements used by different threads don't share cache lines
+     * ("false sharing"). All the elements are constructed up-front, so the
+     * array can be used from a real-time thread without allocating memory.
+     * ```cpp
+     * // one circuit per voice, which may be processed on different threads
+     * wdft::CacheLineSeparatedArray<Voice> voices { numVoices };
+     * ```
+     */
+    template <typename T>
+    class CacheLineSeparatedArray
+    {
+    public:
+        /** The assumed size of a cache line. */
+        static constexpr size_t cacheLineSize = 64;
+
+        /** The alignment of each element. */
+        static constexpr size_t alignment = alignof (T) > cacheLineSize ? alignof (T) : cacheLineSize;
+
+        /** The distance in bytes between elements. */
+        static constexpr size_t stride = (sizeof (T) + alignment - 1) / alignment * alignment;
+
+        /** Creates an array of numElements, each constructed with the given arguments. */
+        template <typename... Args>
+        explicit CacheLineSeparatedArray (size_t numElements, const Args&... args)
+            : storage (new unsigned char[numElements * stride + alignment])
+        {
+            const auto address = reinterpret_cast<uintptr_t> (storage.get());
+            data = storage.get() + (alignment - address % alignment) % alignment;
+
+            for (; numConstructed < numElements; ++numConstructed)
+                new (data + numConstructed * stride) T (args...);
+        }
+
+        ~CacheLineSeparatedArray()
+        {
+            for (size_t i = 0; i < numConstructed; ++i)
+                (*this)[i].~T();
+        }
+
+        CacheLineSeparatedArray (const CacheLineSeparatedArray&) = delete;
+        CacheLineSeparatedArray& operator= (const CacheLineSeparatedArray&) = delete;
+
+        /** Returns the number of elements in the array. */
+        size_t size() const noexcept { return numConstructed; }
+
+        T& operator[] (size_t index) noexcept { return *reinterpret_cast<T*> (data + index * stride); }
+        const T& operator[] (size_t index) const noexcept { return *reinterpret_cast<const T*> (data + index * stride); }
+
+    private:
+        std::unique_ptr<unsigned char[]> storage;
+        unsigned char* data = nullptr;
+        size_t numConstructed = 0;
+    };
+
+    /**
+     * Processes a set of independent circuit processors (e.g. one per channel or voice)
+     * in parallel, on a fixed pool of worker threads.
+     *
+     * Each processor is a "block callback", which processes one block of audio. The
+     * processors are split evenly between the threads (including the thread that calls
+     * process()), and threads that run out of work steal the remaining processors from
+     * the other threads, so no thread sits idle while there is work left to do. process()
+     * returns once all the processors have finished the block.
+     *
+     * All of the memory and threads are allocated up-front, so process() doesn't allocate
+     * memory or lock any mutexes, and can be called from a real-time audio callback. Idle
+     * worker threads spin for a little while, and then park on a semaphore, which process()
+     * signals at the start of each block. Since the calling thread also steals work, the
+     * block will always be finished, even if the worker threads are slow to wake up.
+     * ```cpp
+     * struct Voice
+     * {
+     *     void processBlock (int numSamples) { ... }
+     *     MyCircuit circuit;
+     *     float buffer[maxBlockSize];
+     * };
+     *
+     * // in prepare()...
+     * wdft::CacheLineSeparatedArray<Voice> voices { numVoices };
+     * wdft::CircuitScheduler scheduler { numWorkerThreads, numVoices };
+     * for (size_t i = 0; i < voices.size(); ++i)
+     *     scheduler.addProcessor (voices[i]);
+     *
+     * // in the audio callback...
+     * scheduler.process (numSamples);
+     * ```
+     */
+    class CircuitScheduler
+    {
+    public:
+        /** A callback which processes a block of numSamples samples. */
+        using BlockCallback = void (*) (void* context, int numSamples);
+
+        /**
+         * Creates a scheduler with the given number of worker threads (in addition
+         * to the thread calling process()), which can process up to maxNumProcessors.
+         */
+        CircuitScheduler (int numWorkerThreads, size_t maxNumProcessors)
+            : numThreads ((size_t) (numWorkerThreads > 0 ? numWorkerThreads : 0) + 1),
+              queues (numThreads)
+        {
+            processors.reserve (maxNumProcessors);
+
+            workers.reserve (numThreads - 1);
+            for (size_t threadIndex = 1; threadIndex < numThreads; ++threadIndex)
+                workers.emplace_back ([this, threadIndex]
+                                      { workerLoop (threadIndex); });
+        }
+
+        ~CircuitScheduler()
+        {
+            shouldQuit.store (true, std::memory_order_release);
+            blockStarted.notify();
+            for (auto& worker : workers)
+                worker.join();
+        }
+
+        CircuitScheduler (const CircuitScheduler&) = delete;
+        CircuitScheduler& operator= (const CircuitScheduler&) = delete;
+
+        /**
+         * Adds a processor to the scheduler. Returns false if the scheduler is full.
+         * This must not be called while process() is running.
+         */
+        bool addProcessor (BlockCallback callback, void* context) noexcept
+        {
+            if (processors.size() == processors.capacity())
+                return false;
+
+            ScopedReconfigure reconfigure { *this };
+            processors.push_back ({ callback, context });
+            distributeProcessors();
+            return true;
+        }
+
+        /** Adds a processor with a `processBlock (int numSamples)` method to the scheduler. */
+        template <typename ProcessorType>
+        bool addProcessor (ProcessorType& processor) noexcept
+        {
+            return addProcessor ([] (void* context, int numSamples)
+                                 { static_cast<ProcessorType*> (context)->processBlock (numSamples); },
+                                 &processor);
+        }
+
+        /** Removes all the processors from the scheduler. This must not be called while process() is running. */
+        void clearProcessors() noexcept
+        {
+            ScopedReconfigure reconfigure { *this };
+            processors.clear();
+            distributeProcessors();
+        }
+
+        /** Returns the number of processors in the scheduler. */
+        size_t getNumProcessors() const noexcept { return processors.size(); }
+
+        /** Returns the number of threads used for processing (including the thread calling process()). */
+        size_t getNumThreads() const noexcept { return numThreads; }
+
+        /** Processes a block of numSamples with all of the processors, and waits until they are all finished. */
+        void process (int numSamples) noexcept
+        {
+            if (processors.empty())
+                return;
+
+            // The processors can be claimed as soon as the queues are reset, so the
+            // block size and remaining count must be written first.
+            blockSize.store (numSamples, std::memory_order_relaxed);
+            numRemaining.store (processors.size(), std::memory_order_relaxed);
+            for (size_t i = 0; i < numThreads; ++i)
+                queues[i].next.store (queues[i].begin, std::memory_order_release);
+            blockIndex.fetch_add (1, std::memory_order_release);
+            blockStarted.notify();
+
+            while (runOneProcessor (0))
+            {
+            }
+
+            // barrier: wait for any processors that are still running on the worker threads
+            while (numRemaining.load (std::memory_order_acquire) > 0)
+                spin_detail::pause();
+        }
+
+    private:
+        struct Processor
+        {
+            BlockCallback callback;
+            void* context;
+        };
+
+        /** The range of processors assigned to a thread, which may be stolen by the other threads */
+        struct WorkQueue
+        {
+            std::atomic<size_t> next { 0 };
+            size_t begin = 0;
+            size_t end = 0;
+        };
+
+        /**
+         * Waits until the worker threads are idle, and keeps them idle until the end of the scope.
+         * A worker thread can still be looking for work after process() has returned, so this is
+         * needed before changing the processors.
+         */
+        struct ScopedReconfigure
+        {
+            explicit ScopedReconfigure (CircuitScheduler& s) noexcept : scheduler (s)
+            {
+                scheduler.isReconfiguring.store (true);
+                while (scheduler.numBusyWorkers.load() > 0)
+                    std::this_thread::yield();
+            }
+
+            ~ScopedReconfigure() noexcept { scheduler.isReconfiguring.store (false); }
+
+            CircuitScheduler& scheduler;
+        };
+
+        void distributeProcessors() noexcept
+        {
+            const auto numProcessors = processors.size();
+            for (size_t i = 0; i < numThreads; ++i)
+            {
+                queues[i].begin = i * numProcessors / numThreads;
+                queues[i].end = (i + 1) * numProcessors / numThreads;
+                queues[i].next.store (queues[i].end, std::memory_order_relaxed); // empty until the next block
+            }
+        }
+
+        /** Claims and runs one processor, starting from this thread's queue, then stealing from the others */
+        bool runOneProcessor (size_t threadIndex) noexcept
+        {
+            for (size_t i = 0; i < numThreads; ++i)
+            {
+                auto& queue = queues[(threadIndex + i) % numThreads];
+                if (queue.next.load (std::memory_order_relaxed) >= queue.end)
+                    continue;
+
+                const auto processorIndex = queue.next.fetch_add (1, std::memory_order_acq_rel);
+                if (processorIndex >= queue.end)
+                    continue;
+
+                const auto& processor = processors[processorIndex];
+                processor.callback (processor.context, blockSize.load (std::memory_order_relaxed));
+                numRemaining.fetch_sub (1, std::memory_order_release);
+                return true;
+            }
+
+            return false;
+        }
+
+        void workerLoop (size_t threadIndex)
+        {
+            uint64_t lastBlockIndex = 0;
+            while (true)
+            {
+                // wait for the next block
+                blockStarted.wait ([this, lastBlockIndex]
+                                   { return blockIndex.load (std::memory_order_acquire) != lastBlockIndex
+                                            || shouldQuit.load (std::memory_order_acquire); });
+                if (shouldQuit.load (std::memory_order_acquire))
+                    return;
+
+                // (sequentially consistent, so that either this thread sees isReconfiguring, or ScopedReconfigure sees numBusyWorkers)
+                numBusyWorkers.fetch_add (1);
+                if (! isReconfiguring.load())
+                {
+                    lastBlockIndex = blockIndex.load (std::memory_order_acquire);
+                    while (runOneProcessor (threadIndex))
+                    {
+                    }
+                }
+                else
+                {
+                    // The caller has already finished this block (process() doesn't run while the
+                    // processors are being changed), so skip it, rather than spinning on it while
+                    // ScopedReconfigure waits for this thread to go idle.
+                    lastBlockIndex = blockIndex.load (std::memory_order_acquire);
+                }
+                numBusyWorkers.fetch_sub (1);
+            }
+        }
+
+        const size_t numThreads;
+        std::vector<Processor> processors;
+        CacheLineSeparatedArray<WorkQueue> queues;
+
+        // the shared state is padded, so that the counters written while processing don't share a cache line
+        unsigned char padding0[CacheLineSeparatedArray<int>::cacheLineSize] {};
+        std::atomic<uint64_t> blockIndex { 0 };
+        std::atomic<int> blockSize { 0 };
+        unsigned char padding1[CacheLineSeparatedArray<int>::cacheLineSize] {};
+        std::atomic<size_t> numRemaining { 0 };
+        unsigned char padding2[CacheLineSeparatedArray<int>::cacheLineSize] {};
+        std::atomic<int> numBusyWorkers { 0 };
+        std::atomic<bool> isReconfiguring { false };
+        std::atomic<bool> shouldQuit { false };
+        spin_detail::WakeupSignal blockStarted;
+
+        std::vector<std::thread> workers;
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_CIRCUIT_SCHEDULER_H
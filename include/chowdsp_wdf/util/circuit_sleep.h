@@ -0,0 +1,139 @@
+#ifndef CHOWDSP_WDF_CIRCUIT_SLEEP_H
+#define CHOWDSP_WDF_CIRCUIT_SLEEP_H
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include "circuit_state.h"
+
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace sleep_detail
+    {
+        template <typename T>
+        std::enable_if_t<std::is_arithmetic<T>::value, bool> isBelow (const T& x, double threshold) noexcept
+        {
+            return std::abs ((double) x) <= threshold;
+        }
+
+        template <typename T>
+        bool isBelow (const CompensatedFloat<T>& x, double threshold) noexcept
+        {
+            return isBelow (x.hi, threshold) && isBelow (x.lo, threshold);
+        }
+
+#if defined(XSIMD_HPP)
+        template <typename T>
+        bool isBelow (const xsimd::batch<T>& x, double threshold) noexcept
+        {
+            return xsimd::all (xsimd::abs (x) <= xsimd::batch<T> ((T) threshold));
+        }
+#endif
+    } // namespace sleep_detail
+#endif // DOXYGEN
+
+    /**
+     * Skips the processing for a circuit while it is silent.
+     *
+     * Once a block of input is silent, and every state variable in the circuit (the waves
+     * and internal states of every element, as visited by visitCircuitState()) has decayed
+     * below the threshold, the circuit goes to sleep: its state is set to zero, and while
+     * the input stays silent, the output is filled with zeros, without running the circuit.
+     * As soon as a block of input contains a sample above the threshold, the circuit wakes
+     * up and processes that whole block, starting from the zeroed state.
+     *
+     * Note that a circuit whose state does not decay to zero with a silent input (e.g. a
+     * circuit with a bias voltage) will never go to sleep. Input signals which are set on
+     * the circuit outside of the processed buffer (e.g. a modulation source) are not
+     * checked, so call wake() whenever one of those becomes non-zero.
+     *
+     * The circuit state is only checked at the end of a silent block, and checking it
+     * does not allocate any memory, so process() may be called from the audio thread.
+     * ```cpp
+     * wdft::CircuitSleepMode sleepMode { 1.0e-6 };
+     *
+     * // in the audio callback...
+     * sleepMode.process (circuit.root, buffer, numSamples, [&] (float* data, int n) { circuit.processBlock (data, n); });
+     * ```
+     */
+    class CircuitSleepMode
+    {
+    public:
+        /** Creates a sleep mode with the given threshold (linear gain) for the input and circuit state. */
+        explicit CircuitSleepMode (double thresholdToUse = 1.0e-6) : threshold (thresholdToUse) {}
+
+        /** Sets the threshold (linear gain) for the input and circuit state. */
+        void setThreshold (double newThreshold) noexcept { threshold = newThreshold; }
+
+        /** Returns the threshold for the input and circuit state. */
+        double getThreshold() const noexcept { return threshold; }
+
+        /** Returns true if the circuit is currently asleep. */
+        bool isAsleep() const noexcept { return asleep; }
+
+        /** Wakes the circuit up, so that the next block is processed. */
+        void wake() noexcept { asleep = false; }
+
+        /**
+         * Processes a block of samples in-place, by calling processBlock (buffer, numSamples),
+         * unless the circuit is asleep and the block is silent, in which case the block is
+         * filled with zeros.
+         *
+         * @param root          the root of the WDF tree.
+         * @param buffer        the input buffer, which is processed in-place.
+         * @param numSamples    the number of samples in the buffer.
+         * @param processBlock  a function which processes the buffer through the circuit.
+         * @return              true if the circuit was processed, or false if it was asleep.
+         */
+        template <typename RootType, typename SampleType, typename ProcessFunc>
+        bool process (RootType& root, SampleType* buffer, int numSamples, ProcessFunc&& processBlock) noexcept
+        {
+            const auto inputIsSilent = isSilent (buffer, numSamples);
+            if (asleep && inputIsSilent)
+            {
+                std::fill (buffer, buffer + numSamples, SampleType {});
+                return false;
+            }
+
+            asleep = false;
+            processBlock (buffer, numSamples);
+
+            if (inputIsSilent && stateIsSilent (root))
+            {
+                visitCircuitState (root, [] (auto& x) { x = std::remove_reference_t<decltype (x)> {}; });
+                asleep = true;
+            }
+
+            return true;
+        }
+
+    private:
+        template <typename SampleType>
+        bool isSilent (const SampleType* buffer, int numSamples) const noexcept
+        {
+            for (int n = 0; n < numSamples; ++n)
+                if (! sleep_detail::isBelow (buffer[n], threshold))
+                    return false;
+            return true;
+        }
+
+        template <typename RootType>
+        bool stateIsSilent (RootType& root) const noexcept
+        {
+            bool isSilent = true;
+            visitCircuitState (root, [this, &isSilent] (const auto& x)
+                               { isSilent = isSilent && sleep_detail::isBelow (x, threshold); });
+            return isSilent;
+        }
+
+        double threshold;
+        bool asleep = false;
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_CIRCUIT_SLEEP_H
@@ -0,0 +1,241 @@
+#ifndef CHOWDSP_WDF_CIRCUIT_STATE_H
+#define CHOWDSP_WDF_CIRCUIT_STATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace state_detail
+    {
+        template <typename...>
+        using void_t = void;
+
+        template <typename ElementType, typename = void>
+        struct HasWDFMembers : std::false_type
+        {
+        };
+
+        template <typename ElementType>
+        struct HasWDFMembers<ElementType, void_t<decltype (std::declval<ElementType&>().wdf.a)>> : std::true_type
+        {
+        };
+
+        template <typename ElementType, typename Visitor>
+        std::enable_if_t<HasWDFMembers<ElementType>::value> visitWaves (ElementType& element, Visitor& visitor)
+        {
+            visitor (element.wdf.a);
+            visitor (element.wdf.b);
+        }
+
+        template <typename ElementType, typename Visitor>
+        std::enable_if_t<! HasWDFMembers<ElementType>::value> visitWaves (ElementType&, Visitor&)
+        {
+        }
+
+        /** Rounds the offset up to the alignment of the state variable type */
+        template <typename StateType>
+        constexpr size_t alignOffset (size_t offset) noexcept
+        {
+            return (offset + alignof (StateType) - 1) / alignof (StateType) * alignof (StateType);
+        }
+    } // namespace state_detail
+#endif // DOXYGEN
+
+    /**
+     * Calls visitor with a reference to every state variable in the circuit:
+     * that is, the incident and reflected waves of each element, plus any internal
+     * state variables (capacitor states, R-Type adaptor inputs, etc.).
+     *
+     * The variables are always visited in the same order for a given circuit.
+     * Note that circuit inputs (e.g. source voltages) are not considered to be state.
+     */
+    template <typename RootType, typename Visitor>
+    void visitCircuitState (RootType& root, Visitor&& visitor)
+    {
+        forEachElement (root,
+                        [&visitor] (auto& element)
+                        {
+                            state_detail::visitWaves (element, visitor);
+                            element.visitState (visitor);
+                        });
+    }
+
+    /** Returns the number of bytes needed to store the state of the circuit. */
+    template <typename RootType>
+    size_t getStateSizeBytes (RootType& root)
+    {
+        size_t numBytes = 0;
+        visitCircuitState (root,
+                           [&numBytes] (auto& x)
+                           {
+                               using StateType = std::remove_reference_t<decltype (x)>;
+                               numBytes = state_detail::alignOffset<StateType> (numBytes) + sizeof (StateType);
+                           });
+        return numBytes;
+    }
+
+    /**
+     * Copies the state of the circuit into the given memory,
+     * which must be at least getStateSizeBytes (root) bytes long.
+     */
+    template <typename RootType>
+    void saveState (RootType& root, void* data) noexcept
+    {
+        auto* bytes = static_cast<unsigned char*> (data);
+        size_t offset = 0;
+        visitCircuitState (root,
+                           [bytes, &offset] (auto& x)
+                           {
+                               using StateType = std::remove_reference_t<decltype (x)>;
+                               static_assert (std::is_trivially_copyable<StateType>::value, "State variables must be trivially copyable!");
+
+                               offset = state_detail::alignOffset<StateType> (offset);
+                               std::memcpy (bytes + offset, &x, sizeof (StateType));
+                               offset += sizeof (StateType);
+                           });
+    }
+
+    /** Restores the state of the circuit from memory that was written by saveState(). */
+    template <typename RootType>
+    void loadState (RootType& root, const void* data) noexcept
+    {
+        const auto* bytes = static_cast<const unsigned char*> (data);
+        size_t offset = 0;
+        visitCircuitState (root,
+                           [bytes, &offset] (auto& x)
+                           {
+                               using StateType = std::remove_reference_t<decltype (x)>;
+                               static_assert (std::is_trivially_copyable<StateType>::value, "State variables must be trivially copyable!");
+
+                               offset = state_detail::alignOffset<StateType> (offset);
+                               std::memcpy (&x, bytes + offset, sizeof (StateType));
+                               offset += sizeof (StateType);
+                           });
+    }
+
+    /**
+     * A SIMD-aligned block of memory for storing the state of a circuit.
+     *
+     * The buffer should be allocated when preparing the circuit, after which
+     * the state can be saved and loaded without any memory allocation, e.g.
+     * ```cpp
+     * // in prepare()...
+     * for (auto& voiceState : voiceStates)
+     *     voiceState.allocate (circuit.root);
+     *
+     * // on the audio thread...
+     * saveState (circuit.root, voiceStates[oldVoice]);
+     * loadState (circuit.root, voiceStates[newVoice]);
+     * ```
+     */
+    class CircuitStateBuffer
+    {
+    public:
+        CircuitStateBuffer() = default;
+
+        /** Allocates a buffer large enough for the state of the given circuit. */
+        template <typename RootType>
+        explicit CircuitStateBuffer (RootType& root)
+        {
+            allocate (root);
+        }
+
+        /** Copies the state data into a new (aligned) allocation. */
+        CircuitStateBuffer (const CircuitStateBuffer& other)
+        {
+            copyFrom (other);
+        }
+
+        /** Copies the state data into a new (aligned) allocation. */
+        CircuitStateBuffer& operator= (const CircuitStateBuffer& other)
+        {
+            if (this != &other)
+                copyFrom (other);
+            return *this;
+        }
+
+        CircuitStateBuffer (CircuitStateBuffer&& other) noexcept
+            : storage (std::move (other.storage)),
+              offset (std::exchange (other.offset, (size_t) 0)),
+              numBytes (std::exchange (other.numBytes, (size_t) 0))
+        {
+        }
+
+        CircuitStateBuffer& operator= (CircuitStateBuffer&& other) noexcept
+        {
+            storage = std::move (other.storage);
+            offset = std::exchange (other.offset, (size_t) 0);
+            numBytes = std::exchange (other.numBytes, (size_t) 0);
+            return *this;
+        }
+
+        /** Allocates a buffer large enough for the state of the given circuit. */
+        template <typename RootType>
+        void allocate (RootType& root)
+        {
+            allocateBytes (getStateSizeBytes (root));
+        }
+
+        /** Allocates a zero-initialised buffer with the given number of bytes. */
+        void allocateBytes (size_t numBytesToAllocate)
+        {
+            numBytes = numBytesToAllocate;
+            storage.assign (numBytes + (size_t) alignment, 0);
+
+            const auto address = reinterpret_cast<uintptr_t> (storage.data());
+            offset = (size_t) ((alignment - address % alignment) % alignment);
+        }
+
+        /** Returns a pointer to the (aligned) state data. */
+        void* data() noexcept { return storage.data() + offset; }
+
+        /** Returns a pointer to the (aligned) state data. */
+        const void* data() const noexcept { return storage.data() + offset; }
+
+        /** Returns the size of the state data in bytes. */
+        size_t size() const noexcept { return numBytes; }
+
+        /** The alignment of the state data. */
+        static constexpr uintptr_t alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT > alignof (std::max_align_t)
+                                                   ? (uintptr_t) CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT
+                                                   : (uintptr_t) alignof (std::max_align_t);
+
+    private:
+        /** The offset of the aligned data depends on the address of the allocation, so it can't be copied as-is */
+        void copyFrom (const CircuitStateBuffer& other)
+        {
+            allocateBytes (other.numBytes);
+            if (numBytes > 0)
+                std::memcpy (data(), other.data(), numBytes);
+        }
+
+        std::vector<unsigned char> storage;
+        size_t offset = 0;
+        size_t numBytes = 0;
+    };
+
+    /** Copies the state of the circuit into the state buffer. */
+    template <typename RootType>
+    void saveState (RootType& root, CircuitStateBuffer& buffer) noexcept
+    {
+        saveState (root, buffer.data());
+    }
+
+    /** Restores the state of the circuit from the state buffer. */
+    template <typename RootType>
+    void loadState (RootType& root, const CircuitStateBuffer& buffer) noexcept
+    {
+        loadState (root, buffer.data());
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_CIRCUIT_STATE_H
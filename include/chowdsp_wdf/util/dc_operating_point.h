@@ -0,0 +1,358 @@
+#ifndef CHOWDSP_WDF_DC_OPERATING_POINT_H
+#define CHOWDSP_WDF_DC_OPERATING_POINT_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "circuit_state.h"
+
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace dc_detail
+    {
+        template <typename T>
+        std::enable_if_t<std::is_arithmetic<T>::value, double> getValue (const T& x) noexcept
+        {
+            return (double) x;
+        }
+
+        template <typename T>
+        std::enable_if_t<std::is_arithmetic<T>::value> setValue (T& x, double value) noexcept
+        {
+            x = (T) value;
+        }
+
+        template <typename T>
+        double getValue (const CompensatedFloat<T>& x) noexcept
+        {
+            return (double) x.hi + (double) x.lo;
+        }
+
+        template <typename T>
+        void setValue (CompensatedFloat<T>& x, double value) noexcept
+        {
+            x.hi = (T) value;
+            x.lo = (T) (value - (double) x.hi);
+        }
+
+        /**
+         * The finite-difference step size for a given state variable type (relative to the state value).
+         * We use a larger step than usual, since the rounding errors in the circuit can be amplified
+         * by the slow modes of the circuit (e.g. large capacitors), and the Jacobian is exact for linear circuits.
+         */
+        template <typename T>
+        std::enable_if_t<std::is_arithmetic<T>::value, double> perturbationSize (const T&) noexcept
+        {
+            return std::cbrt ((double) std::numeric_limits<std::conditional_t<std::is_floating_point<T>::value, T, double>>::epsilon());
+        }
+
+        template <typename T>
+        double perturbationSize (const CompensatedFloat<T>&) noexcept
+        {
+            return std::cbrt ((double) std::numeric_limits<T>::epsilon() * std::numeric_limits<T>::epsilon());
+        }
+    } // namespace dc_detail
+#endif // DOXYGEN
+
+    /**
+     * Computes the DC operating point of a circuit, and initialises the states of
+     * the circuit elements to that operating point, so that the circuit does not
+     * need to be "warmed up" by processing audio.
+     *
+     * With the bilinear transform, a capacitor with a constant voltage reflects its
+     * incident wave (i.e. an open circuit), and an inductor with a constant current
+     * inverts its incident wave (i.e. a short circuit). So the DC operating point is
+     * exactly the fixed point of the circuit's per-sample processing with a constant
+     * input. The fixed point is found using Newton's method, with the Jacobian of the
+     * per-sample processing computed by perturbing the circuit state.
+     *
+     * For linear circuits the solver converges in a single iteration, while circuits
+     * with nonlinear root elements (e.g. diodes) typically converge in a handful
+     * of iterations.
+     *
+     * The solver only supports circuits with scalar (i.e. non-SIMD) state variables.
+     * All memory is allocated in prepare(), so settle() may be called from the audio thread,
+     * although the cost is roughly (N + 1) samples of processing per iteration for a
+     * circuit with N state variables, plus an N x N linear solve.
+     *
+     * ```cpp
+     * DCOperatingPointSolver dcSolver;
+     * dcSolver.prepare (circuit.root);
+     *
+     * // later...
+     * circuit.reset();
+     * dcSolver.settle (circuit.root, [&] { circuit.processSample (0.0f); });
+     * ```
+     */
+    class DCOperatingPointSolver
+    {
+    public:
+        DCOperatingPointSolver() = default;
+
+        /** Allocates the memory needed to solve for the operating point of this circuit. */
+        template <typename RootType>
+        void prepare (RootType& root)
+        {
+            size_t numStates = 0;
+            perturbationSize = 0.0;
+            visitCircuitState (root,
+                               [this, &numStates] (auto& s)
+                               {
+                                   numStates++;
+                                   perturbationSize = std::max (perturbationSize, dc_detail::perturbationSize (s));
+                               });
+
+            // if the residual stops improving, we accept the solution as long as the
+            // change in state over one sample is roughly within the rounding noise
+            noiseTolerance = perturbationSize * perturbationSize;
+
+            x.resize (numStates, 0.0);
+            trial.resize (numStates, 0.0);
+            residual.resize (numStates, 0.0);
+            trialResidual.resize (numStates, 0.0);
+            step.resize (numStates, 0.0);
+            jacobian.resize (numStates * numStates, 0.0);
+            pivotColumns.resize (numStates, 0);
+            originalState.allocate (root);
+        }
+
+        /**
+         * Solves for the DC operating point, and sets the circuit state to that operating point.
+         *
+         * @param root              the root of the WDF tree.
+         * @param processSample     a function which processes one sample of the circuit, with
+         *                          the input (and bias) voltages/currents set to their DC values.
+         * @return                  true if the solver converged. If the solver fails to converge,
+         *                          the circuit state is restored to what it was before the call.
+         */
+        template <typename RootType, typename ProcessFunc>
+        bool settle (RootType& root, ProcessFunc&& processSample) noexcept
+        {
+            saveState (root, originalState);
+            readState (root, x);
+
+            auto residualNorm = computeResidual (root, processSample, x, residual);
+            for (int iter = 0; iter < maxIterations; ++iter)
+            {
+                const auto scale = 1.0 + maxAbs (x);
+                if (residualNorm == 0.0)
+                {
+                    writeState (root, x);
+                    return true;
+                }
+
+                computeJacobian (root, processSample);
+                solveNewtonStep();
+
+                // take the Newton step, backtracking if the residual doesn't decrease
+                auto stepScale = 1.0;
+                auto foundBetterState = false;
+                for (int backtrack = 0; backtrack <= maxBacktracks; ++backtrack)
+                {
+                    for (size_t i = 0; i < x.size(); ++i)
+                        trial[i] = x[i] + stepScale * step[i];
+
+                    const auto trialResidualNorm = computeResidual (root, processSample, trial, trialResidual);
+                    if (trialResidualNorm < residualNorm)
+                    {
+                        residualNorm = trialResidualNorm;
+                        std::swap (x, trial);
+                        std::swap (residual, trialResidual);
+                        foundBetterState = true;
+                        break;
+                    }
+
+                    stepScale *= 0.5;
+                }
+
+                // The step was either small enough that we've converged, or we've
+                // hit the limit of what the circuit's floating-point precision can resolve.
+                const auto stepNorm = stepScale * maxAbs (step);
+                if ((foundBetterState && stepNorm <= tolerance * scale)
+                    || (! foundBetterState && residualNorm <= noiseTolerance * scale))
+                {
+                    writeState (root, x);
+                    return true;
+                }
+
+                if (! foundBetterState)
+                    break;
+            }
+
+            loadState (root, originalState);
+            return false;
+        }
+
+        /** Returns the number of state variables in the prepared circuit. */
+        size_t getNumStates() const noexcept { return x.size(); }
+
+        /** The maximum number of Newton iterations */
+        int maxIterations = 50;
+
+        /** The maximum number of times that a Newton step can be halved */
+        int maxBacktracks = 8;
+
+        /** The solver has converged when the Newton step is smaller than tolerance * (1 + max(|state|)) */
+        double tolerance = 1.0e-9;
+
+    private:
+        template <typename RootType>
+        static void readState (RootType& root, std::vector<double>& dest) noexcept
+        {
+            size_t index = 0;
+            visitCircuitState (root, [&dest, &index] (auto& s)
+                               { dest[index++] = dc_detail::getValue (s); });
+        }
+
+        template <typename RootType>
+        static void writeState (RootType& root, const std::vector<double>& source) noexcept
+        {
+            size_t index = 0;
+            visitCircuitState (root, [&source, &index] (auto& s)
+                               { dc_detail::setValue (s, source[index++]); });
+        }
+
+        static double maxAbs (const std::vector<double>& vec) noexcept
+        {
+            double result = 0.0;
+            for (auto v : vec)
+                result = std::max (result, std::abs (v));
+            return result;
+        }
+
+        /** Computes F(state) = step(state) - state, and returns max |F| */
+        template <typename RootType, typename ProcessFunc>
+        static double computeResidual (RootType& root, ProcessFunc& processSample, const std::vector<double>& state, std::vector<double>& result) noexcept
+        {
+            writeState (root, state);
+            processSample();
+            readState (root, result);
+
+            double norm = 0.0;
+            for (size_t i = 0; i < state.size(); ++i)
+            {
+                result[i] -= state[i];
+                if (! std::isfinite (result[i]))
+                    return std::numeric_limits<double>::infinity();
+                norm = std::max (norm, std::abs (result[i]));
+            }
+
+            return norm;
+        }
+
+        /** Computes J = dF/dx column by column, using forward differences */
+        template <typename RootType, typename ProcessFunc>
+        void computeJacobian (RootType& root, ProcessFunc& processSample) noexcept
+        {
+            const auto N = x.size();
+            for (size_t j = 0; j < N; ++j)
+            {
+                const auto xj = x[j];
+                const auto h = perturbationSize * std::max (1.0, std::abs (xj));
+                x[j] = xj + h;
+                computeResidual (root, processSample, x, trialResidual);
+                x[j] = xj;
+
+                for (size_t i = 0; i < N; ++i)
+                    jacobian[i * N + j] = (trialResidual[i] - residual[i]) / h;
+            }
+        }
+
+        /**
+         * Solves J * step = -F with Gaussian elimination and partial pivoting.
+         * State variables that the DC solution does not depend on (e.g. the voltage
+         * of a floating capacitor) lead to singular columns, so those variables are
+         * left unchanged.
+         */
+        void solveNewtonStep() noexcept
+        {
+            const auto N = x.size();
+            auto* M = jacobian.data();
+            for (size_t i = 0; i < N; ++i)
+                trial[i] = -residual[i];
+
+            double scale = 0.0;
+            for (size_t i = 0; i < N * N; ++i)
+                scale = std::max (scale, std::abs (M[i]));
+            const auto pivotThreshold = scale * 1.0e-10;
+
+            size_t rank = 0;
+            for (size_t k = 0; k < N && rank < N; ++k)
+            {
+                auto pivotRow = rank;
+                for (auto i = rank + 1; i < N; ++i)
+                    if (std::abs (M[i * N + k]) > std::abs (M[pivotRow * N + k]))
+                        pivotRow = i;
+
+                if (std::abs (M[pivotRow * N + k]) <= pivotThreshold)
+                    continue; // singular column
+
+                if (pivotRow != rank)
+                {
+                    for (size_t c = 0; c < N; ++c)
+                        std::swap (M[rank * N + c], M[pivotRow * N + c]);
+                    std::swap (trial[rank], trial[pivotRow]);
+                }
+
+                for (auto i = rank + 1; i < N; ++i)
+                {
+                    const auto factor = M[i * N + k] / M[rank * N + k];
+                    if (factor == 0.0)
+                        continue;
+
+                    for (auto c = k; c < N; ++c)
+                        M[i * N + c] -= factor * M[rank * N + c];
+                    trial[i] -= factor * trial[rank];
+                }
+
+                pivotColumns[rank++] = k;
+            }
+
+            // back-substitution, with the variables in singular columns left unchanged
+            std::fill (step.begin(), step.end(), 0.0);
+            for (auto r = rank; r-- > 0;)
+            {
+                const auto k = pivotColumns[r];
+                auto sum = trial[r];
+                for (auto c = k + 1; c < N; ++c)
+                    sum -= M[r * N + c] * step[c];
+                step[k] = sum / M[r * N + k];
+            }
+        }
+
+        double perturbationSize = 0.0;
+        double noiseTolerance = 0.0;
+
+        std::vector<double> x;
+        std::vector<double> trial;
+        std::vector<double> residual;
+        std::vector<double> trialResidual;
+        std::vector<double> step;
+        std::vector<double> jacobian;
+        std::vector<size_t> pivotColumns;
+
+        CircuitStateBuffer originalState;
+    };
+
+    /**
+     * Sets the circuit state to its DC operating point. This is a convenience
+     * wrapper around DCOperatingPointSolver, which allocates memory for the solver.
+     */
+    template <typename RootType, typename ProcessFunc>
+    bool settleToDC (RootType& root, ProcessFunc&& processSample)
+    {
+        DCOperatingPointSolver solver;
+        solver.prepare (root);
+        return solver.settle (root, std::forward<ProcessFunc> (processSample));
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_DC_OPERATING_POINT_H
@@ -65,7 +65,9 @@ namespace wdft
             rtype_detail::forEachInTuple (
                 [] (auto& el, size_t) {
                     el.dontPropagateImpedance = false;
+                    CHOWDSP_WDF_TRACE_DEFERRED_CALC (el);
                     el.calcImpedance();
+                    CHOWDSP_WDF_TRACE_CALC_DONE();
                 },
                 elements);
         }
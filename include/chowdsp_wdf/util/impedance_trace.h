@@ -0,0 +1,359 @@
+#ifndef CHOWDSP_WDF_IMPEDANCE_TRACE_H
+#define CHOWDSP_WDF_IMPEDANCE_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * If CHOWDSP_WDF_TRACING is enabled, every impedance propagation through the
+ * WDF tree is recorded into the active ImpedanceTracer (if there is one).
+ *
+ * When the option is disabled (the default), the tracing hooks are compiled
+ * out completely, so there is no runtime cost, and this header is not included
+ * by the WDF elements (it can still be included directly, for the tracer classes).
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_TRACING
+#define CHOWDSP_WDF_TRACING 0
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+    class BaseWDF;
+
+    /** A single impedance propagation event, recorded by the ImpedanceTracer. */
+    struct ImpedanceTraceEvent
+    {
+        enum class Type : uint8_t
+        {
+            Propagation, /* the element recomputed its impedance, and (maybe) propagated the change to its parent */
+            Deferred, /* the propagation was stopped by a ScopedDeferImpedancePropagation */
+            DeferredCalc, /* the element recomputed its impedance when a ScopedDeferImpedancePropagation went out of scope */
+        };
+
+        Type type = Type::Propagation;
+        uint32_t depth = 0; /* the number of elements that the change has propagated through before reaching this element */
+        uint64_t propagationId = 0; /* all the events triggered by the same parameter change share an ID */
+        const BaseWDF* element = nullptr; /* the element that this event happened at */
+        const BaseWDF* source = nullptr; /* the element whose impedance change started the propagation */
+        int64_t startNs = 0; /* start time of the event (steady_clock) */
+        int64_t durationNs = 0; /* total duration, including the propagation to the ancestors of this element */
+        int64_t calcImpedanceNs = 0; /* time spent in calcImpedance() for this element */
+    };
+
+    /**
+     * Records impedance propagation events into a lock-free single-producer,
+     * single-consumer ring buffer, so that latency spikes while automating
+     * circuit parameters can be inspected offline.
+     *
+     * The tracer only records events when it is the active tracer and
+     * CHOWDSP_WDF_TRACING is enabled. Parameter changes should come from
+     * one thread at a time (typically the audio thread), while the events
+     * can be read from any other thread.
+     * ```cpp
+     * wdft::ImpedanceTracer tracer { 8192 };
+     * tracer.setElementName (circuit.pot1, "pot1");
+     * wdft::ImpedanceTracer::setActiveTracer (&tracer);
+     *
+     * // ... process and automate the circuit ...
+     *
+     * std::ofstream traceFile { "wdf_trace.json" };
+     * tracer.writeChromeTrace (traceFile); // open in chrome://tracing or https://ui.perfetto.dev
+     * ```
+     */
+    class ImpedanceTracer
+    {
+    public:
+        /** Creates a tracer which can hold at least the given number of (unread) events. */
+        explicit ImpedanceTracer (size_t minCapacity = 4096)
+        {
+            size_t capacity = 2;
+            while (capacity < minCapacity)
+                capacity *= 2;
+            events.resize (capacity);
+        }
+
+        ~ImpedanceTracer()
+        {
+            auto* self = this;
+            activeTracer().compare_exchange_strong (self, nullptr);
+        }
+
+        ImpedanceTracer (const ImpedanceTracer&) = delete;
+        ImpedanceTracer& operator= (const ImpedanceTracer&) = delete;
+
+        /** Sets the tracer that will record impedance propagation events (or nullptr to stop tracing). */
+        static void setActiveTracer (ImpedanceTracer* tracer) noexcept
+        {
+            activeTracer().store (tracer, std::memory_order_release);
+        }
+
+        /** Returns the active tracer, or nullptr if tracing is not active. */
+        static ImpedanceTracer* getActiveTracer() noexcept
+        {
+            return activeTracer().load (std::memory_order_acquire);
+        }
+
+        /** Sets a name to use for an element in the exported trace (not real-time safe). */
+        void setElementName (const BaseWDF& element, std::string name)
+        {
+            elementNames[&element] = std::move (name);
+        }
+
+        /** Adds an event to the buffer. If the buffer is full, the event is dropped and false is returned. */
+        bool push (const ImpedanceTraceEvent& event) noexcept
+        {
+            const auto writeIndex = writePosition.load (std::memory_order_relaxed);
+            if (writeIndex - readPosition.load (std::memory_order_acquire) >= events.size())
+            {
+                numDroppedEvents.fetch_add (1, std::memory_order_relaxed);
+                return false;
+            }
+
+            events[writeIndex & (events.size() - 1)] = event;
+            writePosition.store (writeIndex + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Reads the oldest event from the buffer. Returns false if there are no events to read. */
+        bool pop (ImpedanceTraceEvent& event) noexcept
+        {
+            const auto readIndex = readPosition.load (std::memory_order_relaxed);
+            if (readIndex == writePosition.load (std::memory_order_acquire))
+                return false;
+
+            event = events[readIndex & (events.size() - 1)];
+            readPosition.store (readIndex + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Returns the number of events that were dropped because the buffer was full. */
+        uint64_t getNumDroppedEvents() const noexcept { return numDroppedEvents.load (std::memory_order_relaxed); }
+
+        /**
+         * Reads all the events from the buffer, and writes them out in the Chrome
+         * trace-event JSON format. Propagations are written as "complete" events,
+         * so the propagation through the ancestors of an element appears nested
+         * inside the element's event, and deferred propagations are written as
+         * instant events.
+         */
+        void writeChromeTrace (std::ostream& os)
+        {
+            os << "{\"traceEvents\":[";
+
+            ImpedanceTraceEvent event;
+            bool isFirstEvent = true;
+            while (pop (event))
+            {
+                if (! isFirstEvent)
+                    os << ",";
+                isFirstEvent = false;
+
+                os << "\n{\"name\":\"" << getEventName (event) << "\",\"cat\":\"wdf\""
+                   << ",\"ph\":\"" << (event.type == ImpedanceTraceEvent::Type::Deferred ? "i\",\"s\":\"t" : "X")
+                   << "\",\"pid\":1,\"tid\":1,\"ts\":" << formatMicroseconds (event.startNs);
+
+                if (event.type != ImpedanceTraceEvent::Type::Deferred)
+                    os << ",\"dur\":" << formatMicroseconds (event.durationNs);
+
+                os << ",\"args\":{\"element\":\"" << escapeJson (getElementName (event.element))
+                   << "\",\"source\":\"" << escapeJson (getElementName (event.source))
+                   << "\",\"depth\":" << event.depth
+                   << ",\"propagation\":" << event.propagationId
+                   << ",\"calcImpedance_us\":" << formatMicroseconds (event.calcImpedanceNs)
+                   << "}}";
+            }
+
+            os << "\n],\"otherData\":{\"droppedEvents\":" << getNumDroppedEvents() << "}}\n";
+        }
+
+    private:
+        static std::atomic<ImpedanceTracer*>& activeTracer() noexcept
+        {
+            static std::atomic<ImpedanceTracer*> tracer { nullptr };
+            return tracer;
+        }
+
+        static const char* getEventName (const ImpedanceTraceEvent& event) noexcept
+        {
+            switch (event.type)
+            {
+                case ImpedanceTraceEvent::Type::Deferred:
+                    return "deferred";
+                case ImpedanceTraceEvent::Type::DeferredCalc:
+                    return "deferred calcImpedance";
+                case ImpedanceTraceEvent::Type::Propagation:
+                default:
+                    return "propagateImpedanceChange";
+            }
+        }
+
+        std::string getElementName (const BaseWDF* element) const
+        {
+            const auto nameIter = elementNames.find (element);
+            if (nameIter != elementNames.end())
+                return nameIter->second;
+
+            char pointerName[32];
+            std::snprintf (pointerName, sizeof (pointerName), "%p", (const void*) element);
+            return pointerName;
+        }
+
+        /** Escapes the characters that can't appear as-is in a JSON string */
+        static std::string escapeJson (const std::string& str)
+        {
+            std::string escaped;
+            escaped.reserve (str.size());
+            for (auto c : str)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    escaped += '\\';
+                    escaped += c;
+                }
+                else if ((unsigned char) c < 0x20)
+                {
+                    char code[8];
+                    std::snprintf (code, sizeof (code), "\\u%04x", (unsigned) c);
+                    escaped += code;
+                }
+                else
+                {
+                    escaped += c;
+                }
+            }
+            return escaped;
+        }
+
+        static std::string formatMicroseconds (int64_t ns)
+        {
+            char value[32];
+            std::snprintf (value, sizeof (value), "%.3f", (double) ns * 1.0e-3);
+            return value;
+        }
+
+        std::vector<ImpedanceTraceEvent> events;
+        std::atomic<uint64_t> writePosition { 0 };
+        std::atomic<uint64_t> readPosition { 0 };
+        std::atomic<uint64_t> numDroppedEvents { 0 };
+
+        std::unordered_map<const BaseWDF*, std::string> elementNames;
+    };
+
+#ifndef DOXYGEN
+    namespace trace_detail
+    {
+        inline int64_t nowNs() noexcept
+        {
+            return (int64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /** Keeps track of the propagation that is currently running on this thread */
+        struct PropagationContext
+        {
+            uint32_t depth = 0;
+            uint64_t nextPropagationId = 0;
+            const BaseWDF* source = nullptr;
+        };
+
+        inline PropagationContext& getPropagationContext() noexcept
+        {
+            static thread_local PropagationContext context;
+            return context;
+        }
+
+        /** Records a propagation event covering the lifetime of this object */
+        class PropagationScope
+        {
+        public:
+            explicit PropagationScope (const BaseWDF& element, ImpedanceTraceEvent::Type type = ImpedanceTraceEvent::Type::Propagation) noexcept
+                : tracer (ImpedanceTracer::getActiveTracer())
+            {
+                if (tracer == nullptr)
+                    return;
+
+                auto& context = getPropagationContext();
+                if (context.depth == 0)
+                {
+                    context.nextPropagationId++;
+                    context.source = &element;
+                }
+
+                event.type = type;
+                event.depth = context.depth++;
+                event.propagationId = context.nextPropagationId;
+                event.element = &element;
+                event.source = context.source;
+                event.startNs = nowNs();
+            }
+
+            ~PropagationScope() noexcept
+            {
+                if (tracer == nullptr)
+                    return;
+
+                event.durationNs = nowNs() - event.startNs;
+                getPropagationContext().depth--;
+                tracer->push (event);
+            }
+
+            /** Call this once the element has finished computing its impedance */
+            void calcImpedanceDone() noexcept
+            {
+                if (tracer != nullptr)
+                    event.calcImpedanceNs = nowNs() - event.startNs;
+            }
+
+        private:
+            ImpedanceTracer* tracer;
+            ImpedanceTraceEvent event;
+        };
+
+        /** Records that an impedance propagation was stopped at this element */
+        inline void recordDeferredPropagation (const BaseWDF& element) noexcept
+        {
+            auto* tracer = ImpedanceTracer::getActiveTracer();
+            if (tracer == nullptr)
+                return;
+
+            auto& context = getPropagationContext();
+            ImpedanceTraceEvent event;
+            event.type = ImpedanceTraceEvent::Type::Deferred;
+            event.depth = context.depth;
+            event.propagationId = context.depth == 0 ? ++context.nextPropagationId : context.nextPropagationId;
+            event.element = &element;
+            event.source = context.depth == 0 ? &element : context.source;
+            event.startNs = nowNs();
+            tracer->push (event);
+        }
+    } // namespace trace_detail
+#endif // DOXYGEN
+} // namespace wdft
+} // namespace chowdsp
+
+#if CHOWDSP_WDF_TRACING
+/** Traces an impedance propagation through the current WDF element, until the end of the current scope */
+#define CHOWDSP_WDF_TRACE_PROPAGATION() \
+    ::chowdsp::wdft::trace_detail::PropagationScope chowdsp_wdf_trace_scope { *this }
+
+/** Marks the end of the calcImpedance() call in the current traced propagation */
+#define CHOWDSP_WDF_TRACE_CALC_DONE() chowdsp_wdf_trace_scope.calcImpedanceDone()
+
+/** Records that the impedance propagation was deferred at the current WDF element */
+#define CHOWDSP_WDF_TRACE_DEFERRED() ::chowdsp::wdft::trace_detail::recordDeferredPropagation (*this)
+
+/** Traces the deferred impedance calculation of the given WDF element, until the end of the current scope */
+#define CHOWDSP_WDF_TRACE_DEFERRED_CALC(element) \
+    ::chowdsp::wdft::trace_detail::PropagationScope chowdsp_wdf_trace_scope { element, ::chowdsp::wdft::ImpedanceTraceEvent::Type::DeferredCalc }
+#endif
+
+#endif //CHOWDSP_WDF_IMPEDANCE_TRACE_H
@@ -0,0 +1,158 @@
+#ifndef CHOWDSP_WDF_INSTRUMENTATION_H
+#define CHOWDSP_WDF_INSTRUMENTATION_H
+
+#include <cstdint>
+
+/**
+ * If CHOWDSP_WDF_INSTRUMENTATION is enabled, every WDF element keeps count of
+ * how many times its impedance has been recomputed, how many impedance changes
+ * have been propagated through it, and how many incident/reflected waves it has
+ * processed. The counts can be retrieved with wdft::getInstrumentationCounters().
+ *
+ * When the option is disabled (the default), the counters are compiled out
+ * completely, so there is no runtime or memory cost.
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_INSTRUMENTATION
+#define CHOWDSP_WDF_INSTRUMENTATION 0
+#endif
+
+/**
+ * If CHOWDSP_WDF_INSTRUMENTATION is enabled, CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+ * can be set to a power of two N, in which case every Nth call to each instrumented
+ * method is timed using the CPU cycle counter (rdtsc on x86, cntvct_el0 on ARM64).
+ * Sampling keeps the overhead of reading the counter low, while still giving a good
+ * estimate of the per-call cost.
+ */
+#ifndef CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+#define CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING 0
+#endif
+
+#if CHOWDSP_WDF_INSTRUMENTATION && CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_CNTVCT 1
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** Instrumentation counts for a single WDF element (see CHOWDSP_WDF_INSTRUMENTATION). */
+    struct InstrumentationCounters
+    {
+        uint64_t calcImpedance = 0; /* number of calls to calcImpedance() */
+        uint64_t propagateImpedanceChange = 0; /* number of impedance changes propagated through this element */
+        uint64_t incident = 0; /* number of calls to incident(), or compute() for R-Type root adaptors */
+        uint64_t reflected = 0; /* number of calls to reflected() */
+
+        /**
+         * Total cycles spent in the sampled calls to incident() and reflected(). Note that for
+         * adaptors this includes the time spent in the connected ports, so the cost of an adaptor
+         * itself is roughly its average cycles, minus the average cycles of its ports.
+         */
+        uint64_t cycles = 0;
+        uint64_t cycleSamples = 0; /* number of calls included in the cycle count */
+
+        /** Returns the average number of cycles per sampled call to incident() or reflected() */
+        double getAverageCycles() const noexcept
+        {
+            return cycleSamples == 0 ? 0.0 : (double) cycles / (double) cycleSamples;
+        }
+
+        InstrumentationCounters& operator+= (const InstrumentationCounters& other) noexcept
+        {
+            calcImpedance += other.calcImpedance;
+            propagateImpedanceChange += other.propagateImpedanceChange;
+            incident += other.incident;
+            reflected += other.reflected;
+            cycles += other.cycles;
+            cycleSamples += other.cycleSamples;
+            return *this;
+        }
+    };
+
+#ifndef DOXYGEN
+    namespace instrumentation_detail
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION && CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+        static_assert ((CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING & (CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING - 1)) == 0,
+                       "The cycle sampling interval must be a power of two!");
+
+        inline uint64_t readCycleCounter() noexcept
+        {
+#if CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC
+            return (uint64_t) __rdtsc();
+#elif CHOWDSP_WDF_INSTRUMENTATION_USE_CNTVCT
+            uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0"
+                         : "=r"(ticks));
+            return ticks;
+#else
+            return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+#endif
+
+#if CHOWDSP_WDF_INSTRUMENTATION
+        /** Increments a call counter, and (maybe) measures the cycles spent in the current scope. */
+        class ScopedCounter
+        {
+        public:
+            ScopedCounter (uint64_t& callCount, InstrumentationCounters& counters) noexcept
+#if CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+                : sampledCounters ((callCount++ & (CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING - 1)) == 0 ? &counters : nullptr)
+            {
+                if (sampledCounters != nullptr)
+                    startTime = readCycleCounter();
+            }
+#else
+            {
+                callCount++;
+                (void) counters;
+            }
+#endif
+
+#if CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+            ~ScopedCounter() noexcept
+            {
+                if (sampledCounters != nullptr)
+                {
+                    sampledCounters->cycles += readCycleCounter() - startTime;
+                    sampledCounters->cycleSamples++;
+                }
+            }
+
+        private:
+            InstrumentationCounters* sampledCounters;
+            uint64_t startTime = 0;
+#endif
+        };
+#endif
+    } // namespace instrumentation_detail
+#endif // DOXYGEN
+} // namespace wdft
+} // namespace chowdsp
+
+#if CHOWDSP_WDF_INSTRUMENTATION
+/** Counts a call to the given method of the current WDF element */
+#define CHOWDSP_WDF_INSTRUMENT_COUNT(method) (this->instrumentationCounters.method++)
+
+/** Counts a call to the given method of the current WDF element, and samples the time spent in the method */
+#define CHOWDSP_WDF_INSTRUMENT_TIMED(method) \
+    ::chowdsp::wdft::instrumentation_detail::ScopedCounter chowdsp_wdf_instrumentation_scope { this->instrumentationCounters.method, this->instrumentationCounters }
+#else
+#define CHOWDSP_WDF_INSTRUMENT_COUNT(method)
+#define CHOWDSP_WDF_INSTRUMENT_TIMED(method)
+#endif
+
+#endif //CHOWDSP_WDF_INSTRUMENTATION_H
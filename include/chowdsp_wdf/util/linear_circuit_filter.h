@@ -0,0 +1,694 @@
+#ifndef CHOWDSP_WDF_LINEAR_CIRCUIT_FILTER_H
+#define CHOWDSP_WDF_LINEAR_CIRCUIT_FILTER_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "linear_state_space.h"
+
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace iir_detail
+    {
+        /** Row-major access to an n x n matrix */
+        struct MatrixRef
+        {
+            double* data;
+            int n;
+
+            double& operator() (int row, int col) noexcept { return data[row * n + col]; }
+        };
+
+        /**
+         * Balances the matrix with a diagonal similarity transform D^-1 A D, to improve the
+         * accuracy of the eigenvalues. Each diagonal element of D is a power of 2 (so the
+         * scaling is exact), chosen to bring the off-diagonal norms of the matching row and
+         * column close together.
+         */
+        inline void balance (MatrixRef a) noexcept
+        {
+            constexpr int maxSweeps = 32;
+            for (int sweep = 0; sweep < maxSweeps; ++sweep)
+            {
+                bool changed = false;
+                for (int i = 0; i < a.n; ++i)
+                {
+                    double rowNorm = 0.0, colNorm = 0.0;
+                    for (int j = 0; j < a.n; ++j)
+                    {
+                        if (j != i)
+                        {
+                            rowNorm += std::abs (a (i, j));
+                            colNorm += std::abs (a (j, i));
+                        }
+                    }
+
+                    if (rowNorm == 0.0 || colNorm == 0.0)
+                        continue;
+
+                    // scaling the row by 1/f and the column by f balances the norms when f = sqrt (rowNorm / colNorm)
+                    const auto f = std::exp2 (std::round (0.5 * std::log2 (rowNorm / colNorm)));
+                    if (colNorm * f + rowNorm / f >= 0.95 * (colNorm + rowNorm))
+                        continue;
+
+                    changed = true;
+                    for (int j = 0; j < a.n; ++j)
+                    {
+                        a (i, j) /= f;
+                        a (j, i) *= f;
+                    }
+                }
+
+                if (! changed)
+                    break;
+            }
+        }
+
+        /**
+         * A Householder reflection P = I - beta v v^T, of size 2 or 3, which maps the vector
+         * it was made from onto the first axis.
+         */
+        struct Reflector
+        {
+            double v[3] {};
+            double beta = 0.0;
+            double alpha = 0.0; // the first element of the reflected vector
+            int size = 0;
+
+            Reflector (const double* x, int vectorSize) noexcept : size (vectorSize)
+            {
+                double norm = 0.0;
+                for (int i = 0; i < size; ++i)
+                    norm += x[i] * x[i];
+                norm = std::sqrt (norm);
+                if (norm == 0.0)
+                    return; // identity
+
+                // reflect away from x[0], to avoid cancellation
+                alpha = x[0] >= 0.0 ? -norm : norm;
+                std::copy (x, x + size, v);
+                v[0] -= alpha;
+
+                double vNormSq = 0.0;
+                for (int i = 0; i < size; ++i)
+                    vNormSq += v[i] * v[i];
+                beta = 2.0 / vNormSq;
+            }
+
+            /** a := P a, for rows [row, row + size) and columns [firstCol, lastCol] */
+            void applyLeft (MatrixRef a, int row, int firstCol, int lastCol) const noexcept
+            {
+                for (int j = firstCol; j <= lastCol; ++j)
+                {
+                    double dot = 0.0;
+                    for (int i = 0; i < size; ++i)
+                        dot += v[i] * a (row + i, j);
+                    dot *= beta;
+                    for (int i = 0; i < size; ++i)
+                        a (row + i, j) -= dot * v[i];
+                }
+            }
+
+            /** a := a P, for columns [col, col + size) and rows [firstRow, lastRow] */
+            void applyRight (MatrixRef a, int col, int firstRow, int lastRow) const noexcept
+            {
+                for (int i = firstRow; i <= lastRow; ++i)
+                {
+                    double dot = 0.0;
+                    for (int j = 0; j < size; ++j)
+                        dot += a (i, col + j) * v[j];
+                    dot *= beta;
+                    for (int j = 0; j < size; ++j)
+                        a (i, col + j) -= dot * v[j];
+                }
+            }
+        };
+
+        /** Reduces the matrix to upper Hessenberg form, with Householder similarity transforms */
+        inline void reduceToHessenberg (MatrixRef a) noexcept
+        {
+            const auto n = a.n;
+            for (int k = 0; k < n - 2; ++k)
+            {
+                // zero column k below the sub-diagonal from the bottom up, reflecting
+                // each element against the element above it
+                for (int row = n - 2; row > k; --row)
+                {
+                    const double x[2] { a (row, k), a (row + 1, k) };
+                    if (x[1] == 0.0)
+                        continue;
+
+                    const Reflector p { x, 2 };
+                    p.applyLeft (a, row, k, n - 1);
+                    p.applyRight (a, row, 0, n - 1);
+                    a (row, k) = p.alpha;
+                    a (row + 1, k) = 0.0;
+                }
+            }
+        }
+
+        /** Computes the eigenvalues of a real 2x2 matrix [[p, q], [r, s]] */
+        inline void eigenvalues2x2 (double p, double q, double r, double s, double* re, double* im) noexcept
+        {
+            const auto halfDiff = 0.5 * (p - s);
+            const auto discriminant = halfDiff * halfDiff + q * r;
+            if (discriminant >= 0.0)
+            {
+                // the larger root is found directly, and the other from the product of the roots, to avoid cancellation
+                const auto z = halfDiff + std::copysign (std::sqrt (discriminant), halfDiff);
+                re[0] = s + z;
+                re[1] = z != 0.0 ? s - q * r / z : s;
+                im[0] = im[1] = 0.0;
+            }
+            else
+            {
+                re[0] = re[1] = s + halfDiff;
+                im[0] = std::sqrt (-discriminant);
+                im[1] = -im[0];
+            }
+        }
+
+        /**
+         * One implicit double-shift (Francis) QR step on the active block [lo, hi] of an
+         * upper Hessenberg matrix, with the shifts at the eigenvalues of the trailing 2x2
+         * block (given by their sum and product). Only the active block is updated, since
+         * that is all that is needed for the eigenvalues.
+         */
+        inline void francisStep (MatrixRef a, int lo, int hi, double shiftSum, double shiftProduct) noexcept
+        {
+            // the first column of (H - mu1 I) (H - mu2 I), which only has 3 non-zero elements
+            double x[3] {
+                a (lo, lo) * a (lo, lo) + a (lo, lo + 1) * a (lo + 1, lo) - shiftSum * a (lo, lo) + shiftProduct,
+                a (lo + 1, lo) * (a (lo, lo) + a (lo + 1, lo + 1) - shiftSum),
+                a (lo + 1, lo) * a (lo + 2, lo + 1),
+            };
+
+            // chase the bulge down the sub-diagonal
+            for (int k = lo; k < hi - 1; ++k)
+            {
+                const Reflector p { x, 3 };
+                const auto firstCol = std::max (k - 1, lo);
+                p.applyLeft (a, k, firstCol, hi);
+                p.applyRight (a, k, lo, std::min (k + 3, hi));
+                if (k > lo)
+                {
+                    a (k, k - 1) = p.alpha;
+                    a (k + 1, k - 1) = a (k + 2, k - 1) = 0.0;
+                }
+
+                x[0] = a (k + 1, k);
+                x[1] = a (k + 2, k);
+                x[2] = k + 3 <= hi ? a (k + 3, k) : 0.0;
+            }
+
+            const Reflector p { x, 2 };
+            p.applyLeft (a, hi - 1, hi - 2, hi);
+            p.applyRight (a, hi - 1, lo, hi);
+            a (hi - 1, hi - 2) = p.alpha;
+            a (hi, hi - 2) = 0.0;
+        }
+
+        /**
+         * Computes the eigenvalues of an upper Hessenberg matrix (which is overwritten), using
+         * the implicit double-shift QR algorithm, so that complex eigenvalues come out in exact
+         * conjugate pairs. Returns false if the algorithm fails to converge.
+         */
+        inline bool hessenbergEigenvalues (MatrixRef a, double* re, double* im) noexcept
+        {
+            constexpr auto eps = std::numeric_limits<double>::epsilon();
+            constexpr int maxIterationsPerEigenvalue = 64;
+
+            double norm = 0.0;
+            for (int i = 0; i < a.n; ++i)
+                for (int j = std::max (i - 1, 0); j < a.n; ++j)
+                    norm += std::abs (a (i, j));
+
+            int hi = a.n - 1;
+            int iterations = 0;
+            while (hi >= 0)
+            {
+                // look for a negligible sub-diagonal element, which splits off the block [lo, hi]
+                int lo = hi;
+                while (lo > 0)
+                {
+                    auto scale = std::abs (a (lo - 1, lo - 1)) + std::abs (a (lo, lo));
+                    if (scale == 0.0)
+                        scale = norm;
+                    if (std::abs (a (lo, lo - 1)) <= eps * scale)
+                    {
+                        a (lo, lo - 1) = 0.0;
+                        break;
+                    }
+                    --lo;
+                }
+
+                if (lo == hi)
+                {
+                    re[hi] = a (hi, hi);
+                    im[hi] = 0.0;
+                    hi -= 1;
+                    iterations = 0;
+                    continue;
+                }
+
+                if (lo == hi - 1)
+                {
+                    eigenvalues2x2 (a (hi - 1, hi - 1), a (hi - 1, hi), a (hi, hi - 1), a (hi, hi), re + hi - 1, im + hi - 1);
+                    hi -= 2;
+                    iterations = 0;
+                    continue;
+                }
+
+                if (++iterations > maxIterationsPerEigenvalue)
+                    return false;
+
+                if (iterations % 16 == 0)
+                {
+                    // every so often, shift by a complex pair at centre + radius * exp (+/-j) instead,
+                    // in case the standard shifts have settled into a cycle (e.g. for a permutation
+                    // matrix). The angle is arbitrary, but must not be a multiple of pi / 2, so that
+                    // the shifts separate eigenvalues which are symmetric about the centre.
+                    const auto centre = a (hi, hi);
+                    const auto radius = std::abs (a (hi, hi - 1)) + std::abs (a (hi - 1, hi - 2));
+                    const auto shiftReal = centre + radius * std::cos (1.0);
+                    const auto shiftImag = radius * std::sin (1.0);
+                    francisStep (a, lo, hi, 2.0 * shiftReal, shiftReal * shiftReal + shiftImag * shiftImag);
+                }
+                else
+                {
+                    const auto shiftSum = a (hi - 1, hi - 1) + a (hi, hi);
+                    const auto shiftProduct = a (hi - 1, hi - 1) * a (hi, hi) - a (hi - 1, hi) * a (hi, hi - 1);
+                    francisStep (a, lo, hi, shiftSum, shiftProduct);
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * Solves the least-squares problem min |phi * x - h|, for a (column-major) numRows x numCols
+         * matrix phi, using Householder QR. phi and h are overwritten. Returns false if phi is rank-deficient.
+         */
+        inline bool solveLeastSquares (double* phi, double* h, double* x, int numRows, int numCols) noexcept
+        {
+            auto Phi = [phi, numRows] (int row, int col) -> double& { return phi[col * numRows + row]; };
+
+            for (int k = 0; k < numCols; ++k)
+            {
+                double norm = 0.0;
+                for (int i = k; i < numRows; ++i)
+                    norm += Phi (i, k) * Phi (i, k);
+                norm = std::sqrt (norm);
+                if (norm == 0.0)
+                    return false;
+
+                // Householder vector v = phi[k:, k] + sign (phi[k, k]) * |phi[k:, k]| * e_k, stored in-place
+                const auto alpha = Phi (k, k) >= 0.0 ? -norm : norm;
+                Phi (k, k) -= alpha;
+                double vNormSq = 0.0;
+                for (int i = k; i < numRows; ++i)
+                    vNormSq += Phi (i, k) * Phi (i, k);
+
+                auto reflect = [&] (auto&& column)
+                {
+                    double dot = 0.0;
+                    for (int i = k; i < numRows; ++i)
+                        dot += Phi (i, k) * column (i);
+                    const auto scale = 2.0 * dot / vNormSq;
+                    for (int i = k; i < numRows; ++i)
+                        column (i) -= scale * Phi (i, k);
+                };
+
+                for (int j = k + 1; j < numCols; ++j)
+                    reflect ([&Phi, j] (int i) -> double& { return Phi (i, j); });
+                reflect ([h] (int i) -> double& { return h[i]; });
+
+                // the diagonal of R
+                x[k] = alpha;
+            }
+
+            // back-substitution, with R stored above the diagonal of phi
+            for (int k = numCols - 1; k >= 0; --k)
+            {
+                const auto diagonal = x[k];
+                if (std::abs (diagonal) == 0.0)
+                    return false;
+
+                auto sum = h[k];
+                for (int j = k + 1; j < numCols; ++j)
+                    sum -= Phi (k, j) * x[j];
+                x[k] = sum / diagonal;
+            }
+
+            return true;
+        }
+    } // namespace iir_detail
+#endif // DOXYGEN
+
+    /**
+     * Runs a linear circuit as an equivalent IIR filter.
+     *
+     * A circuit made up of only linear elements (resistors, capacitors, inductors, linear
+     * sources, and adaptors, including R-Type adaptors) is a linear time-invariant filter,
+     * for fixed parameter values. update() analyses the circuit for its current parameters,
+     * and derives a bank of second-order sections, running in parallel, with the same
+     * impulse response:
+     *
+     * - The state-space model of the circuit is measured (see LinearStateSpace), and the
+     *   poles are found from the eigenvalues of its state-transition matrix.
+     * - The poles are paired into second-order sections (complex conjugate pairs, or
+     *   neighbouring real poles), and the section numerators are fit to the impulse
+     *   response of the model with least squares. Poles at (or very close to) zero,
+     *   which come from wave variables that are only delayed by a sample, become the
+     *   taps of a short FIR filter.
+     *
+     * Since the sections run in parallel, rather than in cascade, they can be processed
+     * side-by-side, which vectorises well. The analysis restores the circuit state when
+     * it is done, and all memory is allocated in prepare(), so update() does not allocate.
+     * However, the impulse response fit makes update() much more expensive than a sample
+     * of circuit processing (hundreds of microseconds for a tone stack), so it is best
+     * run from a background thread, or for occasional parameter changes, rather than for
+     * every block of a modulated parameter.
+     *
+     * The circuit must not have any non-zero inputs other than the processed signal (e.g.
+     * bias voltages), since the analysis assumes that the circuit is linear, not affine.
+     * ```cpp
+     * wdft::LinearCircuitFilter<float> filter;
+     * filter.prepare (circuit.getRoot());
+     *
+     * // whenever the parameters change...
+     * circuit.setParams (bass, treble);
+     * filter.update (circuit.getRoot(), [&] (float x) { return circuit.processSample (x); });
+     *
+     * // in the audio callback...
+     * filter.processBlock (buffer, numSamples);
+     * ```
+     */
+    template <typename T = float>
+    class LinearCircuitFilter
+    {
+    public:
+        LinearCircuitFilter() = default;
+
+        /** Allocates the memory needed to analyse this circuit. */
+        template <typename RootType>
+        void prepare (RootType& root)
+        {
+            model.prepare (root);
+
+            size_t numStates = 0;
+            visitCircuitState (root, [&numStates] (auto&) { numStates++; });
+
+            const auto N = (int) numStates;
+            impulseState.assign (2 * numStates, 0.0);
+            eigenMatrix.assign (numStates * numStates, 0.0);
+            polesReal.assign (numStates, 0.0);
+            polesImag.assign (numStates, 0.0);
+            denominators.assign (2 * numStates, 0.0);
+
+            const auto maxUnknowns = N + 1;
+            const auto maxImpulseLength = getImpulseLength (maxUnknowns);
+            impulseResponse.assign ((size_t) maxImpulseLength, 0.0);
+            fitTarget.assign ((size_t) maxImpulseLength, 0.0);
+            basis.assign ((size_t) (maxImpulseLength * maxUnknowns), 0.0);
+            fitCoefs.assign ((size_t) maxUnknowns, 0.0);
+
+            b0.assign (numStates, (T) 0);
+            b1.assign (numStates, (T) 0);
+            a1.assign (numStates, (T) 0);
+            a2.assign (numStates, (T) 0);
+            s1.assign (numStates, (T) 0);
+            s2.assign (numStates, (T) 0);
+            firTaps.assign (numStates + 1, (T) 0);
+            firState.assign (numStates + 1, (T) 0);
+
+            numSections = 0;
+            numFirTaps = 0;
+        }
+
+        /**
+         * Re-analyses the circuit for its current parameters, and updates the filter coefficients.
+         *
+         * @param root              the root of the WDF tree.
+         * @param processSample     a function which processes one sample of the circuit, and
+         *                          returns the output sample, i.e. T processSample (T x).
+         * @return                  true if the analysis succeeded. If the analysis fails, the
+         *                          previous filter coefficients are kept.
+         */
+        template <typename RootType, typename ProcessFunc>
+        bool update (RootType& root, ProcessFunc&& processSample) noexcept
+        {
+            model.update (root, processSample);
+            if (! findPoles())
+                return false;
+
+            // every pole adds one unknown to the fit, plus the feed-through term
+            impulseLength = getImpulseLength (numPoles + 1);
+            computeImpulseResponse();
+
+            return fitSections();
+        }
+
+        /** Resets the filter state. */
+        void reset() noexcept
+        {
+            std::fill (s1.begin(), s1.end(), (T) 0);
+            std::fill (s2.begin(), s2.end(), (T) 0);
+            std::fill (firState.begin(), firState.end(), (T) 0);
+        }
+
+        /** Processes a single sample through the filter. */
+        inline T processSample (T x) noexcept
+        {
+            // FIR part
+            for (int i = numFirTaps - 1; i > 0; --i)
+                firState[(size_t) i] = firState[(size_t) i - 1];
+            firState[0] = x;
+
+            T y = (T) 0;
+            for (int i = 0; i < numFirTaps; ++i)
+                y += firTaps[(size_t) i] * firState[(size_t) i];
+
+            // parallel second-order sections (transposed direct form II)
+            auto* b0Data = b0.data();
+            auto* b1Data = b1.data();
+            auto* a1Data = a1.data();
+            auto* a2Data = a2.data();
+            auto* s1Data = s1.data();
+            auto* s2Data = s2.data();
+            for (int k = 0; k < numSections; ++k)
+            {
+                const auto yk = b0Data[k] * x + s1Data[k];
+                s1Data[k] = b1Data[k] * x - a1Data[k] * yk + s2Data[k];
+                s2Data[k] = -a2Data[k] * yk;
+                y += yk;
+            }
+
+            return y;
+        }
+
+        /** Processes a block of samples in-place. */
+        void processBlock (T* buffer, int numSamples) noexcept
+        {
+            for (int n = 0; n < numSamples; ++n)
+                buffer[n] = processSample (buffer[n]);
+        }
+
+        /** Returns the number of second-order sections in the filter. */
+        int getNumSections() const noexcept { return numSections; }
+
+        /** Returns the number of FIR taps in the filter (including the feed-through term). */
+        int getNumFirTaps() const noexcept { return numFirTaps; }
+
+        /** Returns the RMS error of the fitted impulse response, relative to the RMS of the circuit's impulse response. */
+        double getFitError() const noexcept { return fitError; }
+
+        /** Poles with a magnitude smaller than this are treated as FIR taps */
+        double zeroPoleThreshold = 1.0e-3;
+
+    private:
+        /** The length of impulse response used to fit the given number of unknowns */
+        static int getImpulseLength (int numUnknowns) noexcept { return 16 * numUnknowns + 128; }
+
+        /** Computes the impulse response of the circuit from its state-space model */
+        void computeImpulseResponse() noexcept
+        {
+            const auto M = (size_t) model.getNumStates();
+            const auto* A = model.getA();
+            const auto* B = model.getB();
+            const auto* C = model.getC();
+
+            auto* x = impulseState.data();
+            auto* nextX = impulseState.data() + M;
+            std::copy (B, B + M, x);
+            impulseResponse[0] = model.getD();
+            for (int n = 1; n < impulseLength; ++n)
+            {
+                double y = 0.0;
+                for (size_t i = 0; i < M; ++i)
+                {
+                    y += C[i] * x[i];
+
+                    double sum = 0.0;
+                    for (size_t j = 0; j < M; ++j)
+                        sum += A[i * M + j] * x[j];
+                    nextX[i] = sum;
+                }
+                impulseResponse[(size_t) n] = y;
+                std::swap (x, nextX);
+            }
+        }
+
+        bool findPoles() noexcept
+        {
+            numPoles = model.getNumStates();
+            std::copy (model.getA(), model.getA() + numPoles * numPoles, eigenMatrix.begin());
+
+            iir_detail::MatrixRef a { eigenMatrix.data(), numPoles };
+            if (numPoles == 0)
+                return true;
+
+            iir_detail::balance (a);
+            iir_detail::reduceToHessenberg (a);
+            return iir_detail::hessenbergEigenvalues (a, polesReal.data(), polesImag.data());
+        }
+
+        /** Pairs up the poles into second-order denominators, and fits the numerators to the impulse response */
+        bool fitSections() noexcept
+        {
+            int numZeroPoles = 0;
+            int numSectionsFound = 0;
+            int numRealPoles = 0;
+            for (int i = 0; i < numPoles; ++i)
+            {
+                if (std::hypot (polesReal[(size_t) i], polesImag[(size_t) i]) < zeroPoleThreshold)
+                {
+                    numZeroPoles++;
+                }
+                else if (polesImag[(size_t) i] > 0.0)
+                {
+                    // complex conjugate pair: 1 - 2 Re(p) z^-1 + |p|^2 z^-2
+                    denominators[(size_t) (2 * numSectionsFound)] = -2.0 * polesReal[(size_t) i];
+                    denominators[(size_t) (2 * numSectionsFound + 1)] = polesReal[(size_t) i] * polesReal[(size_t) i] + polesImag[(size_t) i] * polesImag[(size_t) i];
+                    numSectionsFound++;
+                }
+                else if (polesImag[(size_t) i] == 0.0)
+                {
+                    // collect the real poles at the front of the array, to be paired up below
+                    polesReal[(size_t) numRealPoles++] = polesReal[(size_t) i];
+                }
+            }
+
+            // pair neighbouring real poles, so that nearly-repeated poles share a section
+            std::sort (polesReal.begin(), polesReal.begin() + numRealPoles);
+            for (int i = 0; i < numRealPoles; i += 2)
+            {
+                const auto p1 = polesReal[(size_t) i];
+                const auto p2 = i + 1 < numRealPoles ? polesReal[(size_t) i + 1] : 0.0;
+                denominators[(size_t) (2 * numSectionsFound)] = -(p1 + p2);
+                denominators[(size_t) (2 * numSectionsFound + 1)] = p1 * p2;
+                numSectionsFound++;
+            }
+            const auto lastSectionIsFirstOrder = numRealPoles % 2 == 1;
+
+            // unknowns: FIR taps, then (b0, b1) for each section (b0 only for a first-order section)
+            const auto numTaps = numZeroPoles + 1;
+            const auto numUnknowns = numTaps + 2 * numSectionsFound - (lastSectionIsFirstOrder ? 1 : 0);
+            const auto L = impulseLength;
+            auto column = [this, L] (int col) { return basis.data() + col * L; };
+
+            for (int tap = 0; tap < numTaps; ++tap)
+            {
+                std::fill (column (tap), column (tap) + L, 0.0);
+                column (tap)[tap] = 1.0;
+            }
+
+            for (int k = 0; k < numSectionsFound; ++k)
+            {
+                const auto den1 = denominators[(size_t) (2 * k)];
+                const auto den2 = denominators[(size_t) (2 * k + 1)];
+
+                // impulse response of 1 / (1 + den1 z^-1 + den2 z^-2), and the same delayed by one sample
+                auto* g = column (numTaps + 2 * k);
+                g[0] = 1.0;
+                g[1] = -den1;
+                for (int n = 2; n < L; ++n)
+                    g[n] = -den1 * g[n - 1] - den2 * g[n - 2];
+
+                if (numTaps + 2 * k + 1 < numUnknowns)
+                {
+                    auto* gDelayed = column (numTaps + 2 * k + 1);
+                    gDelayed[0] = 0.0;
+                    std::copy (g, g + L - 1, gDelayed + 1);
+                }
+            }
+
+            std::copy (impulseResponse.begin(), impulseResponse.end(), fitTarget.begin());
+            if (! iir_detail::solveLeastSquares (basis.data(), fitTarget.data(), fitCoefs.data(), L, numUnknowns))
+                return false;
+
+            // the least-squares residual is left in the bottom of fitTarget
+            double residualPower = 0.0, signalPower = 0.0;
+            for (int n = 0; n < L; ++n)
+            {
+                residualPower += n >= numUnknowns ? fitTarget[(size_t) n] * fitTarget[(size_t) n] : 0.0;
+                signalPower += impulseResponse[(size_t) n] * impulseResponse[(size_t) n];
+            }
+            fitError = signalPower > 0.0 ? std::sqrt (residualPower / signalPower) : 0.0;
+
+            // the FIR taps beyond the last significant one are just the delayed wave variables,
+            // which the least-squares fit only zeros up to rounding errors
+            double maxTap = 0.0;
+            for (int tap = 0; tap < numTaps; ++tap)
+                maxTap = std::max (maxTap, std::abs (fitCoefs[(size_t) tap]));
+
+            const auto tapTolerance = std::sqrt (std::numeric_limits<double>::epsilon()) * maxTap;
+            auto numTapsUsed = numTaps;
+            while (numTapsUsed > 1 && std::abs (fitCoefs[(size_t) numTapsUsed - 1]) <= tapTolerance)
+                numTapsUsed--;
+
+            // the filter state only carries over if the structure of the filter is unchanged
+            if (numSectionsFound != numSections || numTapsUsed != numFirTaps)
+                reset();
+            numFirTaps = numTapsUsed;
+
+            for (int tap = 0; tap < numTaps; ++tap)
+                firTaps[(size_t) tap] = (T) fitCoefs[(size_t) tap];
+
+            for (int k = 0; k < numSectionsFound; ++k)
+            {
+                b0[(size_t) k] = (T) fitCoefs[(size_t) (numTaps + 2 * k)];
+                b1[(size_t) k] = numTaps + 2 * k + 1 < numUnknowns ? (T) fitCoefs[(size_t) (numTaps + 2 * k + 1)] : (T) 0;
+                a1[(size_t) k] = (T) denominators[(size_t) (2 * k)];
+                a2[(size_t) k] = (T) denominators[(size_t) (2 * k + 1)];
+            }
+            numSections = numSectionsFound;
+
+            return true;
+        }
+
+        // circuit analysis (in double precision)
+        LinearStateSpace<T> model;
+        std::vector<double> impulseState;
+        std::vector<double> eigenMatrix, polesReal, polesImag, denominators;
+        int numPoles = 0;
+        int impulseLength = 0;
+        std::vector<double> impulseResponse, fitTarget, basis, fitCoefs;
+        double fitError = 0.0;
+
+        // filter coefficients and state
+        std::vector<T> b0, b1, a1, a2, s1, s2;
+        std::vector<T> firTaps, firState;
+        int numSections = 0;
+        int numFirTaps = 0;
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_LINEAR_CIRCUIT_FILTER_H
@@ -0,0 +1,545 @@
+#ifndef CHOWDSP_WDF_LINEAR_STATE_SPACE_H
+#define CHOWDSP_WDF_LINEAR_STATE_SPACE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "circuit_state.h"
+#include "dc_operating_point.h"
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /**
+     * The state-space model of a linear circuit:
+     * x[n+1] = A x[n] + B u[n], y[n] = C x[n] + D u[n].
+     *
+     * update() measures the model for the circuit's current parameters, by processing
+     * one sample from each unit state (as in DCOperatingPointSolver), with every state
+     * variable visited by visitCircuitState(). The state variables which can be dropped
+     * without changing the input-output behaviour (from a zero initial state) are then
+     * removed: those which never affect the output or the other states (e.g. waves which
+     * are always overwritten before they are read), and those which are never affected by
+     * the input or the other states (e.g. waves from resistors). The model is stored in
+     * double precision, whatever the sample type of the circuit.
+     *
+     * The circuit must not have any non-zero inputs other than the processed signal (e.g.
+     * bias voltages), since the model assumes that the circuit is linear, not affine.
+     */
+    template <typename T = float>
+    class LinearStateSpace
+    {
+    public:
+        LinearStateSpace() = default;
+
+        /** Allocates the memory needed to measure this circuit. */
+        template <typename RootType>
+        void prepare (RootType& root)
+        {
+            size_t numCircuitStates = 0;
+            visitCircuitState (root, [&numCircuitStates] (auto&) { numCircuitStates++; });
+
+            fullA.assign (numCircuitStates * numCircuitStates, 0.0);
+            fullB.assign (numCircuitStates, 0.0);
+            fullC.assign (numCircuitStates, 0.0);
+            state.assign (numCircuitStates, 0.0);
+            activeStates.assign (numCircuitStates, 0);
+
+            A.assign (numCircuitStates * numCircuitStates, 0.0);
+            B.assign (numCircuitStates, 0.0);
+            C.assign (numCircuitStates, 0.0);
+            D = 0.0;
+            numStates = 0;
+
+            originalState.allocate (root);
+        }
+
+        /**
+         * Measures the model for the circuit's current parameters.
+         * The circuit state is restored afterwards.
+         *
+         * @param root              the root of the WDF tree.
+         * @param processSample     a function which processes one sample of the circuit, and
+         *                          returns the output sample, i.e. T processSample (T x).
+         */
+        template <typename RootType, typename ProcessFunc>
+        void update (RootType& root, ProcessFunc&& processSample) noexcept
+        {
+            saveState (root, originalState);
+            measure (root, processSample);
+            loadState (root, originalState);
+
+            reduce();
+        }
+
+        /** Returns the number of state variables in the (reduced) model. */
+        int getNumStates() const noexcept { return numStates; }
+
+        /** Returns the number of state variables in the circuit, i.e. before the model is reduced. */
+        int getNumCircuitStates() const noexcept { return (int) activeStates.size(); }
+
+        /**
+         * Returns a flag for each of the circuit's state variables (in the order visited by
+         * visitCircuitState()), which is 1 if the variable is kept in the reduced model, or 0
+         * if it was removed. The model's states are the kept variables, in the same order.
+         */
+        const int* getUsedCircuitStates() const noexcept { return activeStates.data(); }
+
+        /** Returns the state-transition matrix A, as a row-major getNumStates() x getNumStates() matrix. */
+        const double* getA() const noexcept { return A.data(); }
+
+        /** Returns the input vector B. */
+        const double* getB() const noexcept { return B.data(); }
+
+        /** Returns the output vector C. */
+        const double* getC() const noexcept { return C.data(); }
+
+        /** Returns the feed-through term D. */
+        double getD() const noexcept { return D; }
+
+    private:
+        template <typename RootType>
+        void readState (RootType& root) noexcept
+        {
+            size_t index = 0;
+            visitCircuitState (root, [this, &index] (auto& s)
+                               { state[index++] = dc_detail::getValue (s); });
+        }
+
+        template <typename RootType>
+        void writeState (RootType& root) noexcept
+        {
+            size_t index = 0;
+            visitCircuitState (root, [this, &index] (auto& s)
+                               { dc_detail::setValue (s, state[index++]); });
+        }
+
+        template <typename RootType, typename ProcessFunc>
+        void measure (RootType& root, ProcessFunc& processSample) noexcept
+        {
+            const auto N = state.size();
+            for (size_t j = 0; j < N; ++j)
+            {
+                std::fill (state.begin(), state.end(), 0.0);
+                state[j] = 1.0;
+                writeState (root);
+                fullC[j] = (double) processSample ((T) 0);
+                readState (root);
+                for (size_t i = 0; i < N; ++i)
+                    fullA[i * N + j] = state[i];
+            }
+
+            std::fill (state.begin(), state.end(), 0.0);
+            writeState (root);
+            D = (double) processSample ((T) 1);
+            readState (root);
+            std::copy (state.begin(), state.end(), fullB.begin());
+        }
+
+        void reduce() noexcept
+        {
+            const auto N = state.size();
+            std::fill (activeStates.begin(), activeStates.end(), 1);
+
+            auto isActive = [this] (size_t i) { return activeStates[i] != 0; };
+            bool changed = true;
+            while (changed)
+            {
+                changed = false;
+                for (size_t j = 0; j < N; ++j)
+                {
+                    if (! isActive (j))
+                        continue;
+
+                    bool readByOthers = fullC[j] != 0.0;
+                    bool writtenByOthers = fullB[j] != 0.0;
+                    for (size_t i = 0; i < N; ++i)
+                    {
+                        if (! isActive (i))
+                            continue;
+                        readByOthers = readByOthers || fullA[i * N + j] != 0.0;
+                        writtenByOthers = writtenByOthers || fullA[j * N + i] != 0.0;
+                    }
+
+                    if (! readByOthers || ! writtenByOthers)
+                    {
+                        activeStates[j] = 0;
+                        changed = true;
+                    }
+                }
+            }
+
+            numStates = 0;
+            for (size_t i = 0; i < N; ++i)
+                numStates += activeStates[i];
+
+            const auto M = (size_t) numStates;
+            size_t row = 0;
+            for (size_t i = 0; i < N; ++i)
+            {
+                if (! isActive (i))
+                    continue;
+
+                size_t col = 0;
+                for (size_t j = 0; j < N; ++j)
+                    if (isActive (j))
+                        A[row * M + col++] = fullA[i * N + j];
+
+                B[row] = fullB[i];
+                C[row] = fullC[i];
+                row++;
+            }
+        }
+
+        std::vector<double> fullA, fullB, fullC;
+        std::vector<double> state;
+        std::vector<int> activeStates;
+        CircuitStateBuffer originalState;
+
+        std::vector<double> A, B, C;
+        double D = 0.0;
+        int numStates = 0;
+    };
+
+    /**
+     * Runs a linear circuit through its state-space model, computing a block of samples
+     * at a time.
+     *
+     * Processing a circuit sample-by-sample is limited by the dependency of each sample
+     * on the previous one. With the state-space model (see LinearStateSpace), a sub-block
+     * of K samples can instead be computed from the state at the start of the sub-block:
+     * y = O x + T u, and the state at the end of the sub-block is A^K x + G u, where the
+     * rows of O are C A^k, T is the (lower-triangular Toeplitz) matrix of the impulse
+     * response, and the columns of G are A^(K-1-j) B. Those matrices are precomputed in
+     * update(), and processBlock() then works in three passes over the buffer:
+     *
+     * 1. G u for every sub-block (a matrix-matrix product),
+     * 2. the state at the start of every sub-block (the only sequential pass, with one
+     *    step per sub-block rather than per sample),
+     * 3. O x + T u for every sub-block (another matrix-matrix product).
+     *
+     * The products have no dependencies between samples, so they vectorise well, which
+     * makes this a good fit for offline rendering, or other long blocks. Any samples left
+     * over after the last complete sub-block are processed sample-by-sample.
+     *
+     * The processor starts from a zero state. All memory is allocated in prepare(), so
+     * update() may be called from the audio thread when the parameters change, although
+     * it costs roughly one sample of circuit processing per circuit state variable, plus
+     * O(K M^2 + M^3 log K) for the precomputed matrices (for M states in the reduced model).
+     * The processor state carries over to the new model, as long as it keeps the same circuit
+     * state variables, otherwise the processor is reset.
+     * ```cpp
+     * wdft::StateSpaceBlockProcessor<float> processor;
+     * processor.prepare (circuit.getRoot(), maxBlockSize);
+     *
+     * // whenever the parameters change...
+     * processor.update (circuit.getRoot(), [&] (float x) { return circuit.processSample (x); });
+     *
+     * // when rendering...
+     * processor.processBlock (buffer, numSamples);
+     * ```
+     */
+    template <typename T = float>
+    class StateSpaceBlockProcessor
+    {
+    public:
+        StateSpaceBlockProcessor() = default;
+
+        /**
+         * Allocates the memory needed for this circuit.
+         *
+         * @param root              the root of the WDF tree.
+         * @param maxBlockSize      the largest number of samples processed in one pass (larger blocks are split up).
+         * @param subBlockSizeToUse the number of samples computed from each state (K), which must be at least 1.
+         */
+        template <typename RootType>
+        void prepare (RootType& root, int maxBlockSize, int subBlockSizeToUse = 32)
+        {
+            model.prepare (root);
+
+            size_t maxStates = 0;
+            visitCircuitState (root, [&maxStates] (auto&) { maxStates++; });
+
+            subBlockSize = std::max (subBlockSizeToUse, 1);
+            maxSubBlocks = std::max (maxBlockSize / subBlockSize, 1);
+
+            const auto M = maxStates;
+            const auto K = (size_t) subBlockSize;
+            powerScratch.assign (3 * M * M, 0.0);
+            vectorScratch.assign (2 * M, 0.0);
+
+            A.assign (M * M, (T) 0);
+            B.assign (M, (T) 0);
+            C.assign (M, (T) 0);
+            AK.assign (M * M, (T) 0);
+            outputMatrix.assign (M * K, (T) 0);
+            impulseResponse.assign (K, (T) 0);
+            inputMatrix.assign (K * M, (T) 0);
+
+            state.assign (M, (T) 0);
+            nextState.assign (M, (T) 0);
+            blockInputs.assign ((size_t) maxSubBlocks * M, (T) 0);
+            blockStates.assign ((size_t) maxSubBlocks * M, (T) 0);
+            subBlockOutput.assign (K, (T) 0);
+            usedCircuitStates.assign (M, 0);
+
+            numStates = 0;
+            D = (T) 0;
+        }
+
+        /**
+         * Re-measures the circuit's state-space model for its current parameters, and
+         * updates the precomputed matrices. The circuit state is restored afterwards.
+         *
+         * @param root              the root of the WDF tree.
+         * @param processSample     a function which processes one sample of the circuit, and
+         *                          returns the output sample, i.e. T processSample (T x).
+         */
+        template <typename RootType, typename ProcessFunc>
+        void update (RootType& root, ProcessFunc&& processSample) noexcept
+        {
+            model.update (root, processSample);
+
+            // the processor state only carries over if the model keeps the same circuit states
+            const auto* modelStates = model.getUsedCircuitStates();
+            numStates = model.getNumStates();
+            if (! std::equal (usedCircuitStates.begin(), usedCircuitStates.end(), modelStates))
+            {
+                std::copy (modelStates, modelStates + usedCircuitStates.size(), usedCircuitStates.begin());
+                reset();
+            }
+
+            computeMatrices();
+        }
+
+        /** Resets the processor state. */
+        void reset() noexcept
+        {
+            std::fill (state.begin(), state.end(), (T) 0);
+        }
+
+        /** Processes a block of samples in-place. */
+        void processBlock (T* buffer, int numSamples) noexcept
+        {
+            const auto maxSamplesPerPass = maxSubBlocks * subBlockSize;
+            while (numSamples >= subBlockSize)
+            {
+                const auto numSubBlocks = std::min (numSamples, maxSamplesPerPass) / subBlockSize;
+                processSubBlocks (buffer, numSubBlocks);
+                buffer += numSubBlocks * subBlockSize;
+                numSamples -= numSubBlocks * subBlockSize;
+            }
+
+            for (int n = 0; n < numSamples; ++n)
+                buffer[n] = processSample (buffer[n]);
+        }
+
+        /** Processes a single sample, with the state-space recursion. */
+        inline T processSample (T x) noexcept
+        {
+            const auto M = numStates;
+            auto y = D * x;
+            for (int i = 0; i < M; ++i)
+                y += C[(size_t) i] * state[(size_t) i];
+
+            for (int i = 0; i < M; ++i)
+            {
+                auto sum = B[(size_t) i] * x;
+                for (int j = 0; j < M; ++j)
+                    sum += A[(size_t) (i * M + j)] * state[(size_t) j];
+                nextState[(size_t) i] = sum;
+            }
+            std::copy (nextState.begin(), nextState.begin() + M, state.begin());
+
+            return y;
+        }
+
+        /** Returns the number of state variables in the circuit's (reduced) state-space model. */
+        int getNumStates() const noexcept { return numStates; }
+
+        /** Returns the circuit's state-space model. */
+        const LinearStateSpace<T>& getModel() const noexcept { return model; }
+
+    private:
+        /** Computes the matrices used to process each sub-block (in double precision) */
+        void computeMatrices() noexcept
+        {
+            const auto M = (size_t) numStates;
+            const auto K = (size_t) subBlockSize;
+            const auto* modelA = model.getA();
+            const auto* modelB = model.getB();
+            const auto* modelC = model.getC();
+
+            for (size_t i = 0; i < M * M; ++i)
+                A[i] = (T) modelA[i];
+            for (size_t i = 0; i < M; ++i)
+            {
+                B[i] = (T) modelB[i];
+                C[i] = (T) modelC[i];
+            }
+            D = (T) model.getD();
+
+            // O: row-major (M x K), with column k = (C A^k)^T, and the impulse response C A^(k-1) B
+            auto* rowVec = vectorScratch.data();
+            auto* tempVec = vectorScratch.data() + M;
+            std::copy (modelC, modelC + M, rowVec);
+            impulseResponse[0] = D;
+            for (size_t k = 0; k < K; ++k)
+            {
+                double h = 0.0;
+                for (size_t i = 0; i < M; ++i)
+                {
+                    outputMatrix[i * K + k] = (T) rowVec[i];
+                    h += rowVec[i] * modelB[i];
+                }
+                if (k + 1 < K)
+                    impulseResponse[k + 1] = (T) h;
+
+                for (size_t j = 0; j < M; ++j)
+                {
+                    double sum = 0.0;
+                    for (size_t i = 0; i < M; ++i)
+                        sum += rowVec[i] * modelA[i * M + j];
+                    tempVec[j] = sum;
+                }
+                std::copy (tempVec, tempVec + M, rowVec);
+            }
+
+            // G: stored transposed (K x M), with row j = (A^(K-1-j) B)^T
+            auto* colVec = vectorScratch.data();
+            std::copy (modelB, modelB + M, colVec);
+            for (size_t k = 0; k < K; ++k)
+            {
+                for (size_t i = 0; i < M; ++i)
+                    inputMatrix[(K - 1 - k) * M + i] = (T) colVec[i];
+
+                for (size_t i = 0; i < M; ++i)
+                {
+                    double sum = 0.0;
+                    for (size_t j = 0; j < M; ++j)
+                        sum += modelA[i * M + j] * colVec[j];
+                    tempVec[i] = sum;
+                }
+                std::copy (tempVec, tempVec + M, colVec);
+            }
+
+            // A^K, by repeated squaring
+            auto* power = powerScratch.data();
+            auto* square = powerScratch.data() + M * M;
+            auto* temp = powerScratch.data() + 2 * M * M;
+            std::fill (power, power + M * M, 0.0);
+            for (size_t i = 0; i < M; ++i)
+                power[i * M + i] = 1.0;
+            std::copy (modelA, modelA + M * M, square);
+            for (auto k = K; k > 0; k >>= 1)
+            {
+                if ((k & 1) != 0)
+                {
+                    multiply (power, square, temp, M);
+                    std::copy (temp, temp + M * M, power);
+                }
+
+                if (k > 1)
+                {
+                    multiply (square, square, temp, M);
+                    std::copy (temp, temp + M * M, square);
+                }
+            }
+            for (size_t i = 0; i < M * M; ++i)
+                AK[i] = (T) power[i];
+        }
+
+        /** result = left * right, for M x M row-major matrices */
+        static void multiply (const double* left, const double* right, double* result, size_t M) noexcept
+        {
+            for (size_t i = 0; i < M; ++i)
+            {
+                for (size_t j = 0; j < M; ++j)
+                {
+                    double sum = 0.0;
+                    for (size_t l = 0; l < M; ++l)
+                        sum += left[i * M + l] * right[l * M + j];
+                    result[i * M + j] = sum;
+                }
+            }
+        }
+
+        void processSubBlocks (T* buffer, int numSubBlocks) noexcept
+        {
+            const auto M = numStates;
+            const auto K = subBlockSize;
+
+            // 1. the contribution of each sub-block's input to the state at the end of the sub-block
+            for (int b = 0; b < numSubBlocks; ++b)
+            {
+                auto* g = blockInputs.data() + b * M;
+                const auto* u = buffer + b * K;
+                std::fill (g, g + M, (T) 0);
+                for (int j = 0; j < K; ++j)
+                {
+                    const auto* G = inputMatrix.data() + j * M;
+                    for (int i = 0; i < M; ++i)
+                        g[i] += G[i] * u[j];
+                }
+            }
+
+            // 2. the state at the start of each sub-block
+            for (int b = 0; b < numSubBlocks; ++b)
+            {
+                auto* x = blockStates.data() + b * M;
+                std::copy (state.begin(), state.begin() + M, x);
+
+                const auto* g = blockInputs.data() + b * M;
+                for (int i = 0; i < M; ++i)
+                {
+                    auto sum = g[i];
+                    for (int j = 0; j < M; ++j)
+                        sum += AK[(size_t) (i * M + j)] * x[j];
+                    state[(size_t) i] = sum;
+                }
+            }
+
+            // 3. the output of each sub-block, from its initial state and input
+            auto* y = subBlockOutput.data();
+            const auto* h = impulseResponse.data();
+            for (int b = 0; b < numSubBlocks; ++b)
+            {
+                const auto* x = blockStates.data() + b * M;
+                auto* u = buffer + b * K;
+
+                std::fill (y, y + K, (T) 0);
+                for (int i = 0; i < M; ++i)
+                {
+                    const auto* O = outputMatrix.data() + i * K;
+                    for (int k = 0; k < K; ++k)
+                        y[k] += O[k] * x[i];
+                }
+
+                for (int j = 0; j < K; ++j)
+                    for (int k = j; k < K; ++k)
+                        y[k] += h[k - j] * u[j];
+
+                std::copy (y, y + K, u);
+            }
+        }
+
+        LinearStateSpace<T> model;
+        std::vector<double> powerScratch, vectorScratch;
+
+        std::vector<T> A, B, C, AK;
+        T D = (T) 0;
+        std::vector<T> outputMatrix, impulseResponse, inputMatrix;
+
+        std::vector<T> state, nextState;
+        std::vector<T> blockInputs, blockStates, subBlockOutput;
+        std::vector<int> usedCircuitStates;
+
+        int numStates = 0;
+        int subBlockSize = 32;
+        int maxSubBlocks = 1;
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_LINEAR_STATE_SPACE_H
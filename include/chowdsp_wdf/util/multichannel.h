@@ -0,0 +1,270 @@
+#ifndef CHOWDSP_WDF_MULTICHANNEL_H
+#define CHOWDSP_WDF_MULTICHANNEL_H
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "../math/sample_type.h"
+
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace multichannel_detail
+    {
+        /** Number of samples per channel which are transposed at a time */
+        constexpr int subBlockSize = 32;
+
+        template <typename VectorType>
+        constexpr int numLanes() noexcept
+        {
+            return (int) (sizeof (VectorType) / sizeof (NumericType<VectorType>));
+        }
+
+        /**
+         * Loads a vector from numLanes() contiguous samples. This uses memcpy, rather than an XSIMD
+         * load, so that this header doesn't depend on XSIMD. Compilers usually turn a fixed-size
+         * memcpy into a single unaligned vector load.
+         */
+        template <typename VectorType>
+        inline VectorType load (const NumericType<VectorType>* data) noexcept
+        {
+            VectorType x;
+            std::memcpy (&x, data, sizeof (VectorType));
+            return x;
+        }
+
+        /** Stores a vector to numLanes() contiguous samples (see load()) */
+        template <typename VectorType>
+        inline void store (NumericType<VectorType>* data, const VectorType& x) noexcept
+        {
+            std::memcpy (data, &x, sizeof (VectorType));
+        }
+
+        /**
+         * Buffer for transposing a sub-block of planar channels into vectors, and back again.
+         * The transpose is done with plain scalar copies, not with SIMD shuffles.
+         */
+        template <typename VectorType>
+        struct TransposeBuffer
+        {
+            using T = NumericType<VectorType>;
+            static constexpr int lanes = numLanes<VectorType>();
+
+            /** Copies numChannels (<= lanes) planar channels into the buffer, leaving any unused lanes zeroed. */
+            void interleave (T* const* channelData, int numChannels, int startSample, int numSamples) noexcept
+            {
+                if (numChannels == lanes)
+                {
+                    // with a compile-time number of lanes, the compiler may vectorise these copies (but this isn't guaranteed)
+                    for (int n = 0; n < numSamples; ++n)
+                        for (int lane = 0; lane < lanes; ++lane)
+                            data[n * lanes + lane] = channelData[lane][startSample + n];
+                    return;
+                }
+
+                std::fill (std::begin (data), std::end (data), (T) 0);
+                for (int lane = 0; lane < numChannels; ++lane)
+                    for (int n = 0; n < numSamples; ++n)
+                        data[n * lanes + lane] = channelData[lane][startSample + n];
+            }
+
+            /** Copies the buffer back out to numChannels (<= lanes) planar channels. */
+            void deinterleave (T* const* channelData, int numChannels, int startSample, int numSamples) const noexcept
+            {
+                if (numChannels == lanes)
+                {
+                    for (int n = 0; n < numSamples; ++n)
+                        for (int lane = 0; lane < lanes; ++lane)
+                            channelData[lane][startSample + n] = data[n * lanes + lane];
+                    return;
+                }
+
+                for (int lane = 0; lane < numChannels; ++lane)
+                    for (int n = 0; n < numSamples; ++n)
+                        channelData[lane][startSample + n] = data[n * lanes + lane];
+            }
+
+            alignas (alignof (VectorType)) T data[subBlockSize * lanes];
+        };
+
+        /**
+         * Number of vectors which are processed together. The circuits for different vectors
+         * are independent, so processing them in the same loop gives the CPU more to do while
+         * it waits on the latency of each circuit.
+         */
+        constexpr int maxGroupsPerBatch = 4;
+
+        /** Processes numGroups (<= maxGroupsPerBatch) vectors, starting from the first channel in channelData */
+        template <typename VectorType, typename VectorProcessor>
+        void processPlanarBatch (NumericType<VectorType>* const* channelData, int numChannels, int numSamples, int firstGroup, int numGroups, VectorProcessor& vectorProcessor)
+        {
+            constexpr auto lanes = numLanes<VectorType>();
+            if (lanes == 1)
+            {
+                // nothing to transpose!
+                for (int n = 0; n < numSamples; ++n)
+                    for (int group = 0; group < numGroups; ++group)
+                        store (channelData[group] + n, vectorProcessor (firstGroup + group, load<VectorType> (channelData[group] + n)));
+                return;
+            }
+
+            TransposeBuffer<VectorType> buffers[maxGroupsPerBatch];
+            for (int startSample = 0; startSample < numSamples; startSample += subBlockSize)
+            {
+                const auto subBlockSamples = std::min (subBlockSize, numSamples - startSample);
+                for (int group = 0; group < numGroups; ++group)
+                    buffers[group].interleave (channelData + group * lanes, std::min (lanes, numChannels - group * lanes), startSample, subBlockSamples);
+
+                for (int n = 0; n < subBlockSamples; ++n)
+                {
+                    for (int group = 0; group < numGroups; ++group)
+                    {
+                        auto* frame = buffers[group].data + n * lanes;
+                        store (frame, vectorProcessor (firstGroup + group, load<VectorType> (frame)));
+                    }
+                }
+
+                for (int group = 0; group < numGroups; ++group)
+                    buffers[group].deinterleave (channelData + group * lanes, std::min (lanes, numChannels - group * lanes), startSample, subBlockSamples);
+            }
+        }
+
+        /** Processes numGroups vectors, in batches of maxGroupsPerBatch */
+        template <typename VectorType, typename VectorProcessor>
+        void processPlanarGroups (NumericType<VectorType>* const* channelData, int numChannels, int numSamples, int numGroups, VectorProcessor& vectorProcessor)
+        {
+            constexpr auto lanes = numLanes<VectorType>();
+            for (int firstGroup = 0; firstGroup < numGroups; firstGroup += maxGroupsPerBatch)
+            {
+                processPlanarBatch<VectorType> (channelData + firstGroup * lanes,
+                                                numChannels - firstGroup * lanes,
+                                                numSamples,
+                                                firstGroup,
+                                                std::min (maxGroupsPerBatch, numGroups - firstGroup),
+                                                vectorProcessor);
+            }
+        }
+    } // namespace multichannel_detail
+#endif // DOXYGEN
+
+    /** Returns the number of channels processed by each vector (e.g. 4 for an SSE xsimd::batch<float>, or 1 for float). */
+    template <typename VectorType>
+    constexpr int getNumChannelsPerVector() noexcept
+    {
+        return multichannel_detail::numLanes<VectorType>();
+    }
+
+    /**
+     * Returns the number of vectors needed to process numChannels, i.e. the number of
+     * circuits needed by the vector processor. If padLeftoverChannels is false, the leftover
+     * channels are not counted, since they are processed by the scalar processor.
+     */
+    template <typename VectorType>
+    constexpr int getNumVectorGroups (int numChannels, bool padLeftoverChannels = true) noexcept
+    {
+        return padLeftoverChannels ? (numChannels + getNumChannelsPerVector<VectorType>() - 1) / getNumChannelsPerVector<VectorType>()
+                                   : numChannels / getNumChannelsPerVector<VectorType>();
+    }
+
+    /**
+     * Processes a planar buffer (one pointer per channel) in-place, with the channels mapped
+     * to the lanes of VectorType (e.g. xsimd::batch<float>): channels [0, lanes) go to the
+     * first vector, [lanes, 2 * lanes) to the second vector, and so on.
+     *
+     * vectorProcessor is called as vectorProcessor (int groupIndex, VectorType x) for each
+     * sample, and should return the processed vector (e.g. by calling processSample() on the
+     * circuit for that group). The channels are transposed to and from vectors a few samples
+     * at a time, rather than gathering one sample from each channel per vector, and a few
+     * groups are processed side-by-side, so that their circuits can overlap in the CPU.
+     * The transpose itself is done with scalar copies, through a small buffer on the stack.
+     * The time saved comes from keeping the circuit processing in a tight loop, rather than
+     * from a faster transpose.
+     *
+     * scalarProcessor is called as scalarProcessor (int channelIndex, T x) for each sample of
+     * the channels left over after the last full vector.
+     */
+    template <typename VectorType, typename VectorProcessor, typename ScalarProcessor>
+    void processPlanar (NumericType<VectorType>* const* channelData, int numChannels, int numSamples, VectorProcessor&& vectorProcessor, ScalarProcessor&& scalarProcessor)
+    {
+        constexpr auto lanes = getNumChannelsPerVector<VectorType>();
+        const auto numGroups = getNumVectorGroups<VectorType> (numChannels, false);
+
+        multichannel_detail::processPlanarGroups<VectorType> (channelData, numGroups * lanes, numSamples, numGroups, vectorProcessor);
+
+        for (int n = 0; n < numSamples; ++n)
+            for (int channel = numGroups * lanes; channel < numChannels; ++channel)
+                channelData[channel][n] = scalarProcessor (channel, channelData[channel][n]);
+    }
+
+    /**
+     * Processes a planar buffer in-place, as above, except that any leftover channels are
+     * processed by one more (partially filled) vector, with the unused lanes set to zero.
+     * For example, a stereo buffer uses two lanes of a single SSE vector.
+     */
+    template <typename VectorType, typename VectorProcessor>
+    void processPlanar (NumericType<VectorType>* const* channelData, int numChannels, int numSamples, VectorProcessor&& vectorProcessor)
+    {
+        const auto numGroups = getNumVectorGroups<VectorType> (numChannels);
+        multichannel_detail::processPlanarGroups<VectorType> (channelData, numChannels, numSamples, numGroups, vectorProcessor);
+    }
+
+    /**
+     * Processes an interleaved buffer (numSamples frames of numChannels samples) in-place,
+     * with the same channel mapping and processor arguments as processPlanar(). Since the
+     * channels of each frame are already contiguous, each vector is loaded straight from
+     * the buffer, without a transpose.
+     */
+    template <typename VectorType, typename VectorProcessor, typename ScalarProcessor>
+    void processInterleaved (NumericType<VectorType>* data, int numChannels, int numSamples, VectorProcessor&& vectorProcessor, ScalarProcessor&& scalarProcessor)
+    {
+        using namespace multichannel_detail;
+        constexpr auto lanes = getNumChannelsPerVector<VectorType>();
+        const auto numGroups = getNumVectorGroups<VectorType> (numChannels, false);
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            auto* frame = data + n * numChannels;
+            for (int group = 0; group < numGroups; ++group)
+                store (frame + group * lanes, vectorProcessor (group, load<VectorType> (frame + group * lanes)));
+
+            for (int channel = numGroups * lanes; channel < numChannels; ++channel)
+                frame[channel] = scalarProcessor (channel, frame[channel]);
+        }
+    }
+
+    /**
+     * Processes an interleaved buffer in-place, with any leftover channels processed by
+     * one more (partially filled) vector, with the unused lanes set to zero.
+     */
+    template <typename VectorType, typename VectorProcessor>
+    void processInterleaved (NumericType<VectorType>* data, int numChannels, int numSamples, VectorProcessor&& vectorProcessor)
+    {
+        using namespace multichannel_detail;
+        using T = NumericType<VectorType>;
+        constexpr auto lanes = getNumChannelsPerVector<VectorType>();
+        const auto numFullGroups = getNumVectorGroups<VectorType> (numChannels, false);
+        const auto numLeftoverChannels = numChannels - numFullGroups * lanes;
+
+        alignas (alignof (VectorType)) T leftovers[lanes];
+        for (int n = 0; n < numSamples; ++n)
+        {
+            auto* frame = data + n * numChannels;
+            for (int group = 0; group < numFullGroups; ++group)
+                store (frame + group * lanes, vectorProcessor (group, load<VectorType> (frame + group * lanes)));
+
+            if (numLeftoverChannels > 0)
+            {
+                std::copy (frame + numFullGroups * lanes, frame + numChannels, leftovers);
+                std::fill (leftovers + numLeftoverChannels, leftovers + lanes, (T) 0);
+                store (leftovers, vectorProcessor (numFullGroups, load<VectorType> (leftovers)));
+                std::copy (leftovers, leftovers + numLeftoverChannels, frame + numFullGroups * lanes);
+            }
+        }
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_MULTICHANNEL_H
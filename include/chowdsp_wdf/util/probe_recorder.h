@@ -0,0 +1,130 @@
+#ifndef CHOWDSP_WDF_PROBE_RECORDER_H
+#define CHOWDSP_WDF_PROBE_RECORDER_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** Probes the voltage across a circuit element, for use with ProbeRecorder. */
+    template <typename T, typename ElementType>
+    struct VoltageProbe
+    {
+        const ElementType* element;
+
+        inline T operator()() const noexcept { return voltage<T> (*element); }
+    };
+
+    /** Probes the current through a circuit element, for use with ProbeRecorder. */
+    template <typename T, typename ElementType>
+    struct CurrentProbe
+    {
+        const ElementType* element;
+
+        inline T operator()() const noexcept { return current<T> (*element); }
+    };
+
+    /** Creates a probe for the voltage across a circuit element. */
+    template <typename T, typename ElementType>
+    VoltageProbe<T, ElementType> voltageProbe (const ElementType& element) noexcept
+    {
+        return { &element };
+    }
+
+    /** Creates a probe for the current through a circuit element. */
+    template <typename T, typename ElementType>
+    CurrentProbe<T, ElementType> currentProbe (const ElementType& element) noexcept
+    {
+        return { &element };
+    }
+
+    /**
+     * Records the voltages and/or currents of several circuit elements, for every
+     * sample of a block, into one contiguous buffer per probe.
+     *
+     * The probes are fixed when the recorder is created, so recording a sample is
+     * just a few loads from the (already cached) element waves, and a store to each
+     * probe's buffer, with no virtual calls or branches. The buffers are allocated
+     * in prepare(), so the recorder can be used on the audio thread:
+     * ```cpp
+     * auto probes = wdft::makeProbeRecorder (wdft::voltageProbe<float> (C1), wdft::currentProbe<float> (R2));
+     * probes.prepare (maxBlockSize);
+     *
+     * // in the audio callback...
+     * probes.startBlock();
+     * for (int n = 0; n < numSamples; ++n)
+     * {
+     *     buffer[n] = processSample (buffer[n]);
+     *     probes.record();
+     * }
+     * meter.process (probes.getProbeData (0), probes.getNumSamples());
+     * ```
+     *
+     * Probes work with elements from both the wdft and wdf APIs.
+     */
+    template <typename T, typename... Probes>
+    class ProbeRecorder
+    {
+    public:
+        /** The number of probes */
+        static constexpr int numProbes = (int) sizeof...(Probes);
+
+        explicit ProbeRecorder (Probes... probesToRecord) : probes (probesToRecord...) {}
+
+        /** Allocates the probe buffers, for blocks of up to maxBlockSize samples. */
+        void prepare (int maxBlockSize)
+        {
+            bufferSize = maxBlockSize;
+            data.assign ((size_t) (numProbes * maxBlockSize), T {});
+            numSamples = 0;
+        }
+
+        /** Starts recording a new block, from the start of the probe buffers. */
+        void startBlock() noexcept { numSamples = 0; }
+
+        /**
+         * Records one sample from each probe.
+         * Note: it is the caller's responsibility not to record more than maxBlockSize samples per block!
+         */
+        inline void record() noexcept
+        {
+            recordProbes (std::make_index_sequence<sizeof...(Probes)> {});
+            numSamples++;
+        }
+
+        /** Returns the number of samples recorded since the start of the block. */
+        int getNumSamples() const noexcept { return numSamples; }
+
+        /** Returns the samples recorded for the given probe (in the order that the probes were given to the constructor). */
+        const T* getProbeData (int probeIndex) const noexcept { return data.data() + probeIndex * bufferSize; }
+
+    private:
+        template <size_t... Ix>
+        inline void recordProbes (std::index_sequence<Ix...>) noexcept
+        {
+            auto* samples = data.data() + numSamples;
+            (void) std::initializer_list<int> { ((void) (samples[(int) Ix * bufferSize] = std::get<Ix> (probes)()), 0)... };
+        }
+
+        std::tuple<Probes...> probes;
+        std::vector<T> data;
+        int bufferSize = 0;
+        int numSamples = 0;
+    };
+
+    /** Creates a ProbeRecorder from a list of probes (see voltageProbe() and currentProbe()). */
+    template <typename FirstProbe, typename... OtherProbes>
+    auto makeProbeRecorder (FirstProbe firstProbe, OtherProbes... otherProbes)
+    {
+        using T = decltype (firstProbe());
+        return ProbeRecorder<T, FirstProbe, OtherProbes...> { firstProbe, otherProbes... };
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_PROBE_RECORDER_H
@@ -0,0 +1,327 @@
+#ifndef CHOWDSP_WDF_REALTIME_SAFETY_H
+#define CHOWDSP_WDF_REALTIME_SAFETY_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32) && defined(__cpp_aligned_new)
+#include <malloc.h> // _aligned_malloc
+#endif
+
+/**
+ * A debugging tool for checking that the audio processing code is real-time safe,
+ * i.e. that it doesn't allocate or free memory, or lock any mutexes.
+ *
+ * Any code running inside a ScopedAudioThread region is checked, and each
+ * allocation, deallocation, or mutex lock is counted as a violation.
+ * ```cpp
+ * {
+ *     wdft::ScopedAudioThread audioThread;
+ *     for (int n = 0; n < numSamples; ++n)
+ *         buffer[n] = circuit.processSample (buffer[n]);
+ * }
+ * jassert (wdft::getRealtimeSafetyViolations().total() == 0);
+ * ```
+ *
+ * This header is not included by chowdsp_wdf.h. The checker works by replacing the
+ * global operator new/delete, including the aligned versions when the compiler supports
+ * them (and on Linux, by interposing pthread_mutex_lock, which is used by std::mutex),
+ * so CHOWDSP_WDF_REALTIME_SAFETY_CHECKER_IMPLEMENTATION must be defined before including
+ * this header in exactly one translation unit of the executable. The replacement
+ * operators have a small runtime cost, so the checker is intended for tests and debug
+ * builds only.
+ */
+namespace chowdsp
+{
+namespace wdft
+{
+    /** The types of real-time safety violations that can be detected. */
+    enum class RealtimeSafetyViolation
+    {
+        Allocation,
+        Deallocation,
+        MutexLock,
+    };
+
+    /** The number of real-time safety violations of each type. */
+    struct RealtimeSafetyViolations
+    {
+        uint64_t allocations = 0;
+        uint64_t deallocations = 0;
+        uint64_t mutexLocks = 0;
+
+        /** Returns the total number of violations */
+        uint64_t total() const noexcept { return allocations + deallocations + mutexLocks; }
+    };
+
+    /**
+     * A callback for real-time safety violations, e.g. to break into the debugger,
+     * or abort the program. Note that the handler is called from inside operator new,
+     * so it must not allocate memory itself!
+     */
+    using RealtimeSafetyViolationHandler = void (*) (RealtimeSafetyViolation);
+
+#ifndef DOXYGEN
+    namespace realtime_safety_detail
+    {
+        struct ViolationCounts
+        {
+            std::atomic<uint64_t> allocations { 0 };
+            std::atomic<uint64_t> deallocations { 0 };
+            std::atomic<uint64_t> mutexLocks { 0 };
+            std::atomic<RealtimeSafetyViolationHandler> handler { nullptr };
+        };
+
+        inline ViolationCounts& getViolationCounts() noexcept
+        {
+            static ViolationCounts counts;
+            return counts;
+        }
+
+        inline int& getAudioThreadDepth() noexcept
+        {
+            static thread_local int depth = 0;
+            return depth;
+        }
+
+        /** Records a violation, if the current thread is inside a ScopedAudioThread region */
+        inline void checkViolation (RealtimeSafetyViolation violation) noexcept
+        {
+            auto& depth = getAudioThreadDepth();
+            if (depth <= 0)
+                return;
+
+            auto& counts = getViolationCounts();
+            switch (violation)
+            {
+                case RealtimeSafetyViolation::Allocation:
+                    counts.allocations.fetch_add (1, std::memory_order_relaxed);
+                    break;
+                case RealtimeSafetyViolation::Deallocation:
+                    counts.deallocations.fetch_add (1, std::memory_order_relaxed);
+                    break;
+                case RealtimeSafetyViolation::MutexLock:
+                    counts.mutexLocks.fetch_add (1, std::memory_order_relaxed);
+                    break;
+            }
+
+            if (auto* handler = counts.handler.load (std::memory_order_acquire))
+            {
+                // don't check anything that the handler does (e.g. printing a message)
+                const auto savedDepth = depth;
+                depth = 0;
+                handler (violation);
+                depth = savedDepth;
+            }
+        }
+    } // namespace realtime_safety_detail
+#endif // DOXYGEN
+
+    /**
+     * Marks the current thread as a real-time "audio thread", until the end of the scope.
+     * Regions can be nested, e.g. to mark a whole process callback, and individual parameter
+     * setters inside it.
+     */
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread() noexcept { realtime_safety_detail::getAudioThreadDepth()++; }
+        ~ScopedAudioThread() noexcept { realtime_safety_detail::getAudioThreadDepth()--; }
+
+        ScopedAudioThread (const ScopedAudioThread&) = delete;
+        ScopedAudioThread& operator= (const ScopedAudioThread&) = delete;
+
+        /** Returns true if the current thread is inside a ScopedAudioThread region */
+        static bool isActive() noexcept { return realtime_safety_detail::getAudioThreadDepth() > 0; }
+    };
+
+    /** Returns the number of real-time safety violations (from any thread), since the last reset. */
+    inline RealtimeSafetyViolations getRealtimeSafetyViolations() noexcept
+    {
+        auto& counts = realtime_safety_detail::getViolationCounts();
+
+        RealtimeSafetyViolations violations;
+        violations.allocations = counts.allocations.load (std::memory_order_relaxed);
+        violations.deallocations = counts.deallocations.load (std::memory_order_relaxed);
+        violations.mutexLocks = counts.mutexLocks.load (std::memory_order_relaxed);
+        return violations;
+    }
+
+    /** Resets the real-time safety violation counts. */
+    inline void resetRealtimeSafetyViolations() noexcept
+    {
+        auto& counts = realtime_safety_detail::getViolationCounts();
+        counts.allocations.store (0, std::memory_order_relaxed);
+        counts.deallocations.store (0, std::memory_order_relaxed);
+        counts.mutexLocks.store (0, std::memory_order_relaxed);
+    }
+
+    /** Sets a handler to be called for every real-time safety violation (or nullptr to only count the violations). */
+    inline void setRealtimeSafetyViolationHandler (RealtimeSafetyViolationHandler handler) noexcept
+    {
+        realtime_safety_detail::getViolationCounts().handler.store (handler, std::memory_order_release);
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#if defined(CHOWDSP_WDF_REALTIME_SAFETY_CHECKER_IMPLEMENTATION)
+#ifndef DOXYGEN
+namespace chowdsp
+{
+namespace wdft
+{
+    namespace realtime_safety_detail
+    {
+        inline void* checkedAllocate (std::size_t size)
+        {
+            checkViolation (RealtimeSafetyViolation::Allocation);
+            if (auto* ptr = std::malloc (size == 0 ? 1 : size))
+                return ptr;
+            throw std::bad_alloc {};
+        }
+
+        inline void checkedFree (void* ptr) noexcept
+        {
+            if (ptr == nullptr)
+                return;
+
+            checkViolation (RealtimeSafetyViolation::Deallocation);
+            std::free (ptr);
+        }
+
+#if defined(__cpp_aligned_new)
+        inline void* checkedAllocateAligned (std::size_t size, std::align_val_t alignment)
+        {
+            checkViolation (RealtimeSafetyViolation::Allocation);
+
+            const auto align = std::max ((std::size_t) alignment, sizeof (void*));
+            size = size == 0 ? 1 : size;
+#if defined(_WIN32)
+            if (auto* ptr = _aligned_malloc (size, align))
+                return ptr;
+#else
+            void* ptr = nullptr;
+            if (posix_memalign (&ptr, align, size) == 0)
+                return ptr;
+#endif
+            throw std::bad_alloc {};
+        }
+
+        inline void checkedFreeAligned (void* ptr) noexcept
+        {
+            if (ptr == nullptr)
+                return;
+
+            checkViolation (RealtimeSafetyViolation::Deallocation);
+#if defined(_WIN32)
+            _aligned_free (ptr);
+#else
+            std::free (ptr);
+#endif
+        }
+#endif // __cpp_aligned_new
+    } // namespace realtime_safety_detail
+} // namespace wdft
+} // namespace chowdsp
+
+void* operator new (std::size_t size) { return chowdsp::wdft::realtime_safety_detail::checkedAllocate (size); }
+void* operator new[] (std::size_t size) { return chowdsp::wdft::realtime_safety_detail::checkedAllocate (size); }
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return chowdsp::wdft::realtime_safety_detail::checkedAllocate (size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return chowdsp::wdft::realtime_safety_detail::checkedAllocate (size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void operator delete (void* ptr) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFree (ptr); }
+void operator delete[] (void* ptr) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFree (ptr); }
+void operator delete (void* ptr, std::size_t) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFree (ptr); }
+void operator delete[] (void* ptr, std::size_t) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFree (ptr); }
+void operator delete (void* ptr, const std::nothrow_t&) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFree (ptr); }
+void operator delete[] (void* ptr, const std::nothrow_t&) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFree (ptr); }
+
+#if defined(__cpp_aligned_new)
+// over-aligned allocations (e.g. SIMD types with alignas), which don't go through the plain operator new
+void* operator new (std::size_t size, std::align_val_t alignment) { return chowdsp::wdft::realtime_safety_detail::checkedAllocateAligned (size, alignment); }
+void* operator new[] (std::size_t size, std::align_val_t alignment) { return chowdsp::wdft::realtime_safety_detail::checkedAllocateAligned (size, alignment); }
+
+void* operator new (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return chowdsp::wdft::realtime_safety_detail::checkedAllocateAligned (size, alignment);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[] (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return chowdsp::wdft::realtime_safety_detail::checkedAllocateAligned (size, alignment);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void operator delete (void* ptr, std::align_val_t) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFreeAligned (ptr); }
+void operator delete[] (void* ptr, std::align_val_t) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFreeAligned (ptr); }
+void operator delete (void* ptr, std::size_t, std::align_val_t) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFreeAligned (ptr); }
+void operator delete[] (void* ptr, std::size_t, std::align_val_t) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFreeAligned (ptr); }
+void operator delete (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFreeAligned (ptr); }
+void operator delete[] (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { chowdsp::wdft::realtime_safety_detail::checkedFreeAligned (ptr); }
+#endif // __cpp_aligned_new
+
+#if defined(__linux__)
+#include <dlfcn.h>
+#include <pthread.h>
+
+/** Interposes the pthread_mutex_lock from libc/libpthread, so that std::mutex::lock() can be checked */
+extern "C" int pthread_mutex_lock (pthread_mutex_t* mutex)
+{
+    using LockFunction = int (*) (pthread_mutex_t*);
+
+    // constant-initialised, so that there is no static initialisation guard (which may itself lock a mutex)
+    static std::atomic<LockFunction> realLock { nullptr };
+
+    auto lockFunction = realLock.load (std::memory_order_acquire);
+    if (lockFunction == nullptr)
+    {
+        lockFunction = (LockFunction) dlsym (RTLD_NEXT, "pthread_mutex_lock");
+        realLock.store (lockFunction, std::memory_order_release);
+    }
+
+    chowdsp::wdft::realtime_safety_detail::checkViolation (chowdsp::wdft::RealtimeSafetyViolation::MutexLock);
+    return lockFunction (mutex);
+}
+#endif // __linux__
+#endif // DOXYGEN
+#endif // CHOWDSP_WDF_REALTIME_SAFETY_CHECKER_IMPLEMENTATION
+
+#endif //CHOWDSP_WDF_REALTIME_SAFETY_H
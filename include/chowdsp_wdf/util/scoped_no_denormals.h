@@ -0,0 +1,100 @@
+#ifndef CHOWDSP_WDF_SCOPED_NO_DENORMALS_H
+#define CHOWDSP_WDF_SCOPED_NO_DENORMALS_H
+
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP > 0)
+#include <xmmintrin.h>
+#define CHOWDSP_WDF_DENORMALS_USE_MXCSR 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHOWDSP_WDF_DENORMALS_USE_FPCR 1
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /**
+     * While an object of this type is in scope, the CPU will flush denormal
+     * floating-point numbers to zero (i.e. the FTZ/DAZ flags are set on x86,
+     * and the FZ flag is set on ARM64). The previous floating-point control
+     * state is restored when the object is destroyed.
+     *
+     * WDF models with reactive elements can decay into the denormal range once
+     * the input falls silent, which can cause large CPU spikes on some platforms.
+     * If you don't already have something like this in your audio callback,
+     * you probably want to do something like:
+     * ```cpp
+     * void processBlock (float* data, int numSamples)
+     * {
+     *     wdft::ScopedNoDenormals noDenormals;
+     *     for (int n = 0; n < numSamples; ++n)
+     *         data[n] = myWDF.processSample (data[n]);
+     * }
+     * ```
+     *
+     * On platforms where the flags are not supported, this class does nothing,
+     * in which case you may want to enable CHOWDSP_WDF_FLUSH_DENORMALS instead.
+     */
+    class ScopedNoDenormals
+    {
+    public:
+        ScopedNoDenormals() noexcept
+        {
+#if CHOWDSP_WDF_DENORMALS_USE_MXCSR
+            prevState = (intptr_t) _mm_getcsr();
+            _mm_setcsr ((unsigned int) prevState | 0x8040u); // FTZ | DAZ
+#elif CHOWDSP_WDF_DENORMALS_USE_FPCR
+            prevState = getFPCR();
+            setFPCR (prevState | (intptr_t) (1 << 24)); // FZ
+#endif
+        }
+
+        ~ScopedNoDenormals() noexcept
+        {
+#if CHOWDSP_WDF_DENORMALS_USE_MXCSR
+            _mm_setcsr ((unsigned int) prevState);
+#elif CHOWDSP_WDF_DENORMALS_USE_FPCR
+            setFPCR (prevState);
+#endif
+        }
+
+        ScopedNoDenormals (const ScopedNoDenormals&) = delete;
+        ScopedNoDenormals& operator= (const ScopedNoDenormals&) = delete;
+
+        /** Returns true if this class is able to flush denormals on the current platform */
+        static constexpr bool isSupported() noexcept
+        {
+#if CHOWDSP_WDF_DENORMALS_USE_MXCSR || CHOWDSP_WDF_DENORMALS_USE_FPCR
+            return true;
+#else
+            return false;
+#endif
+        }
+
+    private:
+#if CHOWDSP_WDF_DENORMALS_USE_FPCR
+        static inline intptr_t getFPCR() noexcept
+        {
+            intptr_t fpcr;
+            asm volatile("mrs %0, fpcr"
+                         : "=r"(fpcr));
+            return fpcr;
+        }
+
+        static inline void setFPCR (intptr_t fpcr) noexcept
+        {
+            asm volatile("msr fpcr, %0"
+                         :
+                         : "ri"(fpcr));
+        }
+#endif
+
+#if CHOWDSP_WDF_DENORMALS_USE_MXCSR || CHOWDSP_WDF_DENORMALS_USE_FPCR
+        intptr_t prevState = 0;
+#endif
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_SCOPED_NO_DENORMALS_H
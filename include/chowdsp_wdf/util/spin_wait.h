@@ -0,0 +1,179 @@
+#ifndef CHOWDSP_WDF_SPIN_WAIT_H
+#define CHOWDSP_WDF_SPIN_WAIT_H
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#define CHOWDSP_WDF_UNDEF_NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#define CHOWDSP_WDF_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#ifdef CHOWDSP_WDF_UNDEF_NOMINMAX
+#undef NOMINMAX
+#undef CHOWDSP_WDF_UNDEF_NOMINMAX
+#endif
+#ifdef CHOWDSP_WDF_UNDEF_WIN32_LEAN_AND_MEAN
+#undef WIN32_LEAN_AND_MEAN
+#undef CHOWDSP_WDF_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__unix__)
+#include <cerrno>
+#include <semaphore.h>
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace spin_detail
+    {
+        /** Hints to the CPU that we are in a spin-wait loop */
+        inline void pause() noexcept
+        {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+            asm volatile("yield");
+#endif
+        }
+
+        /**
+         * A counting semaphore, using the native semaphore of the platform. post() never
+         * blocks, and doesn't allocate memory or lock any mutexes, so it can be called from
+         * the audio thread. On platforms without a native semaphore, post() does nothing,
+         * and wait() falls back to sleeping for a short poll interval, so the waiting thread
+         * must check its wake-up condition after every wait().
+         */
+        class Semaphore
+        {
+        public:
+#if defined(_WIN32)
+            Semaphore() : handle (CreateSemaphoreW (nullptr, 0, MAXLONG, nullptr)) {}
+            ~Semaphore() { CloseHandle (handle); }
+
+            void post (int count) noexcept { ReleaseSemaphore (handle, (LONG) count, nullptr); }
+            void wait() noexcept { WaitForSingleObject (handle, INFINITE); }
+
+        private:
+            HANDLE handle;
+#elif defined(__APPLE__)
+            Semaphore() { semaphore_create (mach_task_self(), &semaphore, SYNC_POLICY_FIFO, 0); }
+            ~Semaphore() { semaphore_destroy (mach_task_self(), semaphore); }
+
+            void post (int count) noexcept
+            {
+                for (int i = 0; i < count; ++i)
+                    semaphore_signal (semaphore);
+            }
+
+            void wait() noexcept { semaphore_wait (semaphore); }
+
+        private:
+            semaphore_t semaphore {};
+#elif defined(__unix__)
+            Semaphore() { sem_init (&semaphore, 0, 0); }
+            ~Semaphore() { sem_destroy (&semaphore); }
+
+            void post (int count) noexcept
+            {
+                for (int i = 0; i < count; ++i)
+                    sem_post (&semaphore);
+            }
+
+            void wait() noexcept
+            {
+                while (sem_wait (&semaphore) != 0 && errno == EINTR)
+                {
+                }
+            }
+
+        private:
+            sem_t semaphore {};
+#else
+            void post (int) noexcept {}
+            void wait() noexcept { std::this_thread::sleep_for (std::chrono::microseconds (250)); }
+#endif
+
+        public:
+            Semaphore (const Semaphore&) = delete;
+            Semaphore& operator= (const Semaphore&) = delete;
+        };
+
+        /**
+         * Lets worker threads wait for work without locking: a waiting thread spins for a
+         * little while (for the lowest latency), then parks on a semaphore (so that idle
+         * workers don't use the CPU), until another thread changes the wake-up condition
+         * and calls notify(). notify() only calls into the OS when a thread is parked, so
+         * it costs next to nothing when the workers are busy.
+         */
+        class WakeupSignal
+        {
+        public:
+            /** Waits until isReady() returns true. isReady() may be called several times. */
+            template <typename Condition>
+            void wait (Condition&& isReady) noexcept
+            {
+                for (int i = 0; i < spinLoops; ++i)
+                {
+                    if (isReady())
+                        return;
+                    pause();
+                }
+
+                while (! isReady())
+                {
+                    // register as parked before the last check, so that either this thread sees
+                    // the new condition, or notify() sees this thread (and posts to the semaphore)
+                    numParked.fetch_add (1, std::memory_order_relaxed);
+                    std::atomic_thread_fence (std::memory_order_seq_cst);
+                    // (if the condition is already true, the next notify() posts this thread's count anyway,
+                    // which only causes a spurious wake-up, so the condition is always checked again)
+                    if (isReady())
+                        return;
+
+                    semaphore.wait();
+                }
+            }
+
+            /** Wakes up the parked threads. Call this after changing the wake-up condition. */
+            void notify() noexcept
+            {
+                std::atomic_thread_fence (std::memory_order_seq_cst);
+                if (numParked.load (std::memory_order_relaxed) == 0)
+                    return;
+
+                const auto count = numParked.exchange (0, std::memory_order_relaxed);
+                if (count > 0)
+                    semaphore.post (count);
+            }
+
+        private:
+            static constexpr int spinLoops = 2000;
+
+            Semaphore semaphore;
+            std::atomic<int> numParked { 0 };
+        };
+    } // namespace spin_detail
+#endif // DOXYGEN
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_SPIN_WAIT_H
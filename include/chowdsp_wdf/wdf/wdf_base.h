@@ -2,6 +2,7 @@
 #define CHOWDSP_WDF_WDF_BASE_H
 
 #include <string>
+#include <type_traits>
 #include <utility>
 
 #include "../wdft/wdft.h"
@@ -26,7 +27,10 @@ namespace wdf
      */
         virtual inline void propagateImpedance()
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
             calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
 
             if (wdfParent != nullptr)
                 wdfParent->propagateImpedance();
@@ -38,6 +42,52 @@ namespace wdf
         /** Sub-classes override this function to propogate a reflected wave. */
         virtual T reflected() noexcept = 0;
 
+        /** Interface for visiting the ports connected to an element (see visitPorts()). */
+        struct PortVisitor
+        {
+            virtual ~PortVisitor() = default;
+            virtual void visit (WDF<T>& port) = 0;
+        };
+
+        /** Interface for visiting the internal state of an element (see visitState()). */
+        struct StateVisitor
+        {
+            virtual ~StateVisitor() = default;
+            virtual void visit (T& state) = 0;
+        };
+
+        /** Sub-classes override this function to visit each of their connected ports. */
+        virtual void visitConnectedPorts (PortVisitor&) {}
+
+        /** Sub-classes override this function to visit each of their internal state variables. */
+        virtual void visitInternalState (StateVisitor&) {}
+
+        /** Calls fn for each port connected "below" this element in the WDF tree. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            struct Visitor : PortVisitor
+            {
+                explicit Visitor (std::remove_reference_t<Fn>& f) : fn (f) {}
+                void visit (WDF<T>& port) override { fn (port); }
+                std::remove_reference_t<Fn>& fn;
+            } visitor { fn };
+            visitConnectedPorts (visitor);
+        }
+
+        /** Calls visitor with a reference to each of this element's internal state variables. */
+        template <typename Fn>
+        void visitState (Fn&& fn)
+        {
+            struct Visitor : StateVisitor
+            {
+                explicit Visitor (std::remove_reference_t<Fn>& f) : fn (f) {}
+                void visit (T& state) override { fn (state); }
+                std::remove_reference_t<Fn>& fn;
+            } visitor { fn };
+            visitInternalState (visitor);
+        }
+
         /** Probe the voltage across this circuit element. */
         inline T voltage() const noexcept
         {
@@ -82,6 +132,7 @@ namespace wdf
         /** Computes the impedance of the WDF resistor, Z_R = R. */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             internalWDF.calcImpedance();
             this->wdf.R = internalWDF.wdf.R;
             this->wdf.G = internalWDF.wdf.G;
@@ -90,6 +141,7 @@ namespace wdf
         /** Accepts an incident wave into a WDF resistor. */
         inline void incident (T x) noexcept override
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             this->wdf.a = x;
             internalWDF.incident (x);
         }
@@ -97,10 +149,25 @@ namespace wdf
         /** Propogates a reflected wave from a WDF resistor. */
         inline T reflected() noexcept override
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             this->wdf.b = internalWDF.reflected();
             return this->wdf.b;
         }
 
+        /** Visits the ports connected to the internal WDF element. */
+        void visitConnectedPorts (typename WDF<T>::PortVisitor& visitor) override
+        {
+            internalWDF.visitPorts ([&visitor] (WDF<T>& port) { visitor.visit (port); });
+        }
+
+        /** Visits the waves and internal state of the internal WDF element. */
+        void visitInternalState (typename WDF<T>::StateVisitor& visitor) override
+        {
+            visitor.visit (internalWDF.wdf.a);
+            visitor.visit (internalWDF.wdf.b);
+            internalWDF.visitState ([&visitor] (T& x) { visitor.visit (x); });
+        }
+
     protected:
         WDFType internalWDF;
     };
@@ -118,11 +185,15 @@ namespace wdf
 
         inline void propagateImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
             this->calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
         }
 
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             this->internalWDF.calcImpedance();
         }
     };
@@ -35,17 +35,19 @@ namespace wdf
             this->wdf.G = (T) 1.0 / this->wdf.R;
         }
 
-        inline void calcImpedance() override {}
+        inline void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
 
         /** Accepts an incident wave into a WDF open. */
         inline void incident (T x) noexcept override
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             this->wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF open. */
         inline T reflected() noexcept override
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             this->wdf.b = this->wdf.a;
             return this->wdf.b;
         }
@@ -62,17 +64,19 @@ namespace wdf
             this->wdf.G = (T) 1.0 / this->wdf.R;
         }
 
-        inline void calcImpedance() override {}
+        inline void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
 
         /** Accepts an incident wave into a WDF short. */
         inline void incident (T x) noexcept override
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             this->wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF short. */
         inline T reflected() noexcept override
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             this->wdf.b = -this->wdf.a;
             return this->wdf.b;
         }
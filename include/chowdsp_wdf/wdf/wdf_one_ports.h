@@ -264,6 +264,274 @@ namespace wdf
             this->internalWDF.reset();
         }
     };
+
+    /** WDF Resistor/Inductor Series Node */
+    template <typename T>
+    class ResistorInductorSeries final : public WDFWrapper<T, wdft::ResistorInductorSeriesT<T>>
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor Series node.
+         * @param res_value: resistance in Ohms
+         * @param ind_value: inductance in Henries
+         */
+        explicit ResistorInductorSeries (T res_value, T ind_value)
+            : WDFWrapper<T, wdft::ResistorInductorSeriesT<T>> ("Resistor/Inductor Series", res_value, ind_value)
+        {
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            this->internalWDF.setResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Resistor/Inductor Parallel Node */
+    template <typename T>
+    class ResistorInductorParallel final : public WDFWrapper<T, wdft::ResistorInductorParallelT<T>>
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor Parallel node.
+         * @param res_value: resistance in Ohms
+         * @param ind_value: inductance in Henries
+         */
+        explicit ResistorInductorParallel (T res_value, T ind_value)
+            : WDFWrapper<T, wdft::ResistorInductorParallelT<T>> ("Resistor/Inductor Parallel", res_value, ind_value)
+        {
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            this->internalWDF.setResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Inductor/Capacitor Series Node */
+    template <typename T>
+    class InductorCapacitorSeries final : public WDFWrapper<T, wdft::InductorCapacitorSeriesT<T>>
+    {
+    public:
+        /** Creates a new WDF Inductor/Capacitor Series node.
+         * @param ind_value: inductance in Henries
+         * @param cap_value: capacitance in Farads
+         */
+        explicit InductorCapacitorSeries (T ind_value, T cap_value)
+            : WDFWrapper<T, wdft::InductorCapacitorSeriesT<T>> ("Inductor/Capacitor Series", ind_value, cap_value)
+        {
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Inductor/Capacitor Parallel Node */
+    template <typename T>
+    class InductorCapacitorParallel final : public WDFWrapper<T, wdft::InductorCapacitorParallelT<T>>
+    {
+    public:
+        /** Creates a new WDF Inductor/Capacitor Parallel node.
+         * @param ind_value: inductance in Henries
+         * @param cap_value: capacitance in Farads
+         */
+        explicit InductorCapacitorParallel (T ind_value, T cap_value)
+            : WDFWrapper<T, wdft::InductorCapacitorParallelT<T>> ("Inductor/Capacitor Parallel", ind_value, cap_value)
+        {
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Resistor/Inductor/Capacitor Series Node */
+    template <typename T>
+    class ResistorInductorCapacitorSeries final : public WDFWrapper<T, wdft::ResistorInductorCapacitorSeriesT<T>>
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor/Capacitor Series node.
+         * @param res_value: resistance in Ohms
+         * @param ind_value: inductance in Henries
+         * @param cap_value: capacitance in Farads
+         */
+        explicit ResistorInductorCapacitorSeries (T res_value, T ind_value, T cap_value)
+            : WDFWrapper<T, wdft::ResistorInductorCapacitorSeriesT<T>> ("Resistor/Inductor/Capacitor Series", res_value, ind_value, cap_value)
+        {
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            this->internalWDF.setResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Capacitor with ESR and leakage resistance */
+    template <typename T>
+    class CapacitorESR final : public WDFWrapper<T, wdft::CapacitorESRT<T>>
+    {
+    public:
+        /** Creates a new WDF Capacitor with ESR.
+         * @param cap_value: capacitance in Farads
+         * @param esr_value: equivalent series resistance in Ohms
+         * @param leakage_value: leakage resistance in Ohms
+         */
+        explicit CapacitorESR (T cap_value, T esr_value, T leakage_value = (NumericType<T>) 1.0e9)
+            : WDFWrapper<T, wdft::CapacitorESRT<T>> ("Capacitor/ESR", cap_value, esr_value, (T) 48000.0, leakage_value)
+        {
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Sets the equivalent series resistance, in Ohms. */
+        void setESRValue (T newESR)
+        {
+            this->internalWDF.setESRValue (newESR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the leakage resistance, in Ohms. */
+        void setLeakageResistanceValue (T newR)
+        {
+            this->internalWDF.setLeakageResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
 } // namespace wdf
 } // namespace chowdsp
 
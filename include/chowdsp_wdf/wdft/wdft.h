@@ -13,6 +13,7 @@ namespace wdft
 #include "wdft_one_ports.h"
 #include "wdft_sources.h"
 #include "wdft_adaptors.h"
+#include "wdft_fusion.h"
 #include "wdft_nonlinearities.h"
 
 #endif // CHOWDSP_WDF_T_INCLUDED
@@ -2,6 +2,7 @@
 #define CHOWDSP_WDF_WDFT_ADAPTORS_H
 
 #include "wdft_base.h"
+#include "../rtype/rtype_detail.h"
 
 namespace chowdsp
 {
@@ -28,14 +29,25 @@ namespace wdft
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.G = port1.wdf.G + port2.wdf.G;
             wdf.R = (T) 1.0 / wdf.G;
-            port1Reflect = port1.wdf.G / wdf.G;
+            port1Reflect.set (port1.wdf.G / wdf.G);
+        }
+
+        /** Returns the adaptor impedance at compile-time, if both ports have fixed impedances. */
+        template <bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value,
+                  std::enable_if_t<isFixed, int> = 0>
+        static constexpr double getFixedImpedance() noexcept
+        {
+            return (Port1Type::getFixedImpedance() * Port2Type::getFixedImpedance())
+                   / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance());
         }
 
         /** Accepts an incident wave into a WDF parallel adaptor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             const auto b2 = wdf.b - port2.wdf.b + x;
             port1.incident (b2 + bDiff);
             port2.incident (b2);
@@ -46,22 +58,38 @@ namespace wdft
         /** Propogates a reflected wave from a WDF parallel adaptor. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             port1.reflected();
             port2.reflected();
 
             bDiff = port2.wdf.b - port1.wdf.b;
-            wdf.b = port2.wdf.b - port1Reflect * bDiff;
+            wdf.b = port2.wdf.b - port1Reflect.get() * bDiff;
 
             return wdf.b;
         }
 
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+            fn (port2);
+        }
+
         Port1Type& port1;
         Port2Type& port2;
 
         WDFMembers<T> wdf;
 
     private:
-        T port1Reflect = (T) 1.0;
+        /** G_1 / (G_1 + G_2), for fixed port impedances */
+        struct FixedPort1Reflect
+        {
+            static constexpr bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value;
+            static constexpr double value() noexcept { return Port2Type::getFixedImpedance() / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance()); }
+        };
+
+        fixed_detail::Coefficient<T, FixedPort1Reflect> port1Reflect;
         T bDiff = (T) 0.0;
     };
 
@@ -84,15 +112,25 @@ namespace wdft
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = port1.wdf.R + port2.wdf.R;
             wdf.G = (T) 1.0 / wdf.R;
-            port1Reflect = port1.wdf.R / wdf.R;
+            port1Reflect.set (port1.wdf.R / wdf.R);
+        }
+
+        /** Returns the adaptor impedance at compile-time, if both ports have fixed impedances. */
+        template <bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value,
+                  std::enable_if_t<isFixed, int> = 0>
+        static constexpr double getFixedImpedance() noexcept
+        {
+            return Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance();
         }
 
         /** Accepts an incident wave into a WDF series adaptor. */
         inline void incident (T x) noexcept
         {
-            const auto b1 = port1.wdf.b - port1Reflect * (x + port1.wdf.b + port2.wdf.b);
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto b1 = port1.wdf.b - port1Reflect.get() * (x + port1.wdf.b + port2.wdf.b);
             port1.incident (b1);
             port2.incident (-(x + b1));
 
@@ -102,17 +140,232 @@ namespace wdft
         /** Propogates a reflected wave from a WDF series adaptor. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = -(port1.reflected() + port2.reflected());
             return wdf.b;
         }
 
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+            fn (port2);
+        }
+
         Port1Type& port1;
         Port2Type& port2;
 
         WDFMembers<T> wdf;
 
     private:
-        T port1Reflect = (T) 1.0;
+        /** R_1 / (R_1 + R_2), for fixed port impedances */
+        struct FixedPort1Reflect
+        {
+            static constexpr bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value;
+            static constexpr double value() noexcept { return Port1Type::getFixedImpedance() / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance()); }
+        };
+
+        fixed_detail::Coefficient<T, FixedPort1Reflect> port1Reflect;
+    };
+
+    /**
+     * WDF (N+1)-port parallel adaptor.
+     *
+     * Equivalent to a chain of nested WDFParallelT adaptors, but the reflection
+     * coefficients for all of the ports are computed with a single division, and
+     * the waves are scattered to all of the ports at once, rather than one level
+     * of the tree at a time.
+     */
+    template <typename T, typename... PortTypes>
+    class WDFParallelNT final : public BaseWDF
+    {
+    public:
+        /** Number of ports connected "below" this adaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+        static_assert (numPorts >= 2, "WDFParallelNT needs at least two ports!");
+
+        /** Creates a new WDF parallel adaptor from the connected ports. */
+        explicit WDFParallelNT (PortTypes&... ps) : ports (std::tie (ps...))
+        {
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t) { port.connectToParent (this); },
+                                          ports);
+            calcImpedance();
+        }
+
+        /** Computes the impedance for a WDF parallel adaptor.
+         *  1     1           1
+         * --- = --- + ... + ---
+         * Z_p   Z_1         Z_N
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { portG[i] = port.wdf.G; },
+                                          ports);
+
+            wdf.G = portG[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.G += portG[i];
+            wdf.R = (T) 1.0 / wdf.G;
+
+            for (int i = 0; i < numPorts; ++i)
+                portReflect[i] = portG[i] * wdf.R;
+        }
+
+        /** Accepts an incident wave into a WDF parallel adaptor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto bPlusX = wdf.b + x;
+            for (int i = 0; i < numPorts; ++i)
+                b_vec[i] = bPlusX - a_vec[i];
+
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { port.incident (b_vec[i]); },
+                                          ports);
+
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF parallel adaptor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { a_vec[i] = port.reflected(); },
+                                          ports);
+
+            wdf.b = portReflect[0] * a_vec[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.b += portReflect[i] * a_vec[i];
+
+            return wdf.b;
+        }
+
+        /** Returns the port connected at the given index. */
+        template <int Index>
+        auto& getPort() noexcept
+        {
+            return std::get<Index> (ports);
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          ports);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        std::tuple<PortTypes&...> ports;
+
+        rtype_detail::AlignedArray<T, numPorts> portG; // port admittances
+        rtype_detail::AlignedArray<T, numPorts> portReflect; // reflection coefficients
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // waves reflected from the ports
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // waves incident to the ports
+    };
+
+    /**
+     * WDF (N+1)-port series adaptor.
+     *
+     * Equivalent to a chain of nested WDFSeriesT adaptors, but the reflection
+     * coefficients for all of the ports are computed with a single division, and
+     * the waves are scattered to all of the ports at once, rather than one level
+     * of the tree at a time.
+     *
+     * Note that all of the ports are connected with the same orientation, whereas in
+     * a chain of WDFSeriesT adaptors, each nested adaptor flips the polarity of the
+     * ports below it.
+     */
+    template <typename T, typename... PortTypes>
+    class WDFSeriesNT final : public BaseWDF
+    {
+    public:
+        /** Number of ports connected "below" this adaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+        static_assert (numPorts >= 2, "WDFSeriesNT needs at least two ports!");
+
+        /** Creates a new WDF series adaptor from the connected ports. */
+        explicit WDFSeriesNT (PortTypes&... ps) : ports (std::tie (ps...))
+        {
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t) { port.connectToParent (this); },
+                                          ports);
+            calcImpedance();
+        }
+
+        /** Computes the impedance for a WDF series adaptor.
+         * Z_s = Z_1 + ... + Z_N
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { portR[i] = port.wdf.R; },
+                                          ports);
+
+            wdf.R = portR[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.R += portR[i];
+            wdf.G = (T) 1.0 / wdf.R;
+
+            for (int i = 0; i < numPorts; ++i)
+                portReflect[i] = portR[i] * wdf.G;
+        }
+
+        /** Accepts an incident wave into a WDF series adaptor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto waveSum = x - wdf.b; // x + a_1 + ... + a_N
+            for (int i = 0; i < numPorts; ++i)
+                b_vec[i] = a_vec[i] - portReflect[i] * waveSum;
+
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { port.incident (b_vec[i]); },
+                                          ports);
+
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF series adaptor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { a_vec[i] = port.reflected(); },
+                                          ports);
+
+            wdf.b = a_vec[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.b += a_vec[i];
+            wdf.b = -wdf.b;
+
+            return wdf.b;
+        }
+
+        /** Returns the port connected at the given index. */
+        template <int Index>
+        auto& getPort() noexcept
+        {
+            return std::get<Index> (ports);
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          ports);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        std::tuple<PortTypes&...> ports;
+
+        rtype_detail::AlignedArray<T, numPorts> portR; // port impedances
+        rtype_detail::AlignedArray<T, numPorts> portReflect; // reflection coefficients
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // waves reflected from the ports
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // waves incident to the ports
     };
 
     /** WDF Voltage Polarity Inverter */
@@ -132,6 +385,7 @@ namespace wdft
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = port1.wdf.R;
             wdf.G = (T) 1.0 / wdf.R;
         }
@@ -139,6 +393,7 @@ namespace wdft
         /** Accepts an incident wave into a WDF inverter. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
             port1.incident (-x);
         }
@@ -146,10 +401,18 @@ namespace wdft
         /** Propogates a reflected wave from a WDF inverter. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = -port1.reflected();
             return wdf.b;
         }
 
+        /** Calls fn for the port connected to this inverter. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -176,6 +439,7 @@ namespace wdft
         /** Calculates the impedance of the WDF Y-Parameter */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             denominator = y[1][1] + port1.wdf.R * y[0][0] * y[1][1] - port1.wdf.R * y[0][1] * y[1][0];
             wdf.R = (port1.wdf.R * y[0][0] + (T) 1.0) / denominator;
             wdf.G = (T) 1.0 / wdf.R;
@@ -192,6 +456,7 @@ namespace wdft
         /** Accepts an incident wave into a WDF Y-Parameter. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
             port1.incident (A * port1.wdf.b + B * x);
         }
@@ -199,10 +464,18 @@ namespace wdft
         /** Propogates a reflected wave from a WDF Y-Parameter. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = C * port1.reflected();
             return wdf.b;
         }
 
+        /** Calls fn for the port connected to this Y-Parameter. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -1,7 +1,23 @@
 #ifndef CHOWDSP_WDF_WDFT_BASE_H
 #define CHOWDSP_WDF_WDFT_BASE_H
 
+#include <type_traits>
+
 #include "../math/sample_type.h"
+#include "../util/instrumentation.h"
+
+#ifndef CHOWDSP_WDF_TRACING
+#define CHOWDSP_WDF_TRACING 0
+#endif
+
+#if CHOWDSP_WDF_TRACING
+#include "../util/impedance_trace.h"
+#else
+#define CHOWDSP_WDF_TRACE_PROPAGATION()
+#define CHOWDSP_WDF_TRACE_CALC_DONE()
+#define CHOWDSP_WDF_TRACE_DEFERRED()
+#define CHOWDSP_WDF_TRACE_DEFERRED_CALC(element)
+#endif
 
 namespace chowdsp
 {
@@ -20,14 +36,44 @@ namespace wdft
         inline virtual void propagateImpedanceChange()
         {
             if (dontPropagateImpedance)
+            {
+                CHOWDSP_WDF_TRACE_DEFERRED();
                 return; // the impedance propagation is being deferred until later...
+            }
 
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
             calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
 
             if (parent != nullptr)
                 parent->propagateImpedanceChange();
         }
 
+        /**
+         * Calls fn for each port connected "below" this element in the WDF tree.
+         * Elements with connected ports (adaptors and root elements) hide this method.
+         */
+        template <typename Fn>
+        void visitPorts (Fn&&)
+        {
+        }
+
+        /**
+         * Calls visitor with a reference to each of this element's internal
+         * state variables (not including the wdf.a and wdf.b members).
+         * Elements with internal state hide this method.
+         */
+        template <typename Visitor>
+        void visitState (Visitor&&)
+        {
+        }
+
+#if CHOWDSP_WDF_INSTRUMENTATION
+        /** Instrumentation counts for this element (see getInstrumentationCounters()). */
+        InstrumentationCounters instrumentationCounters;
+#endif
+
     protected:
         BaseWDF* parent = nullptr;
 
@@ -42,7 +88,13 @@ namespace wdft
     class RootWDF : public BaseWDF
     {
     public:
-        inline void propagateImpedanceChange() override { calcImpedance(); }
+        inline void propagateImpedanceChange() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
+            calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
+        }
 
     private:
         // don't try to connect root nodes!
@@ -59,6 +111,90 @@ namespace wdft
         T b = (T) 0.0; /* reflected wave */
     };
 
+#ifndef DOXYGEN
+    namespace fixed_detail
+    {
+        template <typename...>
+        using void_t = void;
+
+        /** True if the element's impedance is known at compile-time (see FixedResistorT). */
+        template <typename ElementType, typename = void>
+        struct HasFixedImpedance : std::false_type
+        {
+        };
+
+        template <typename ElementType>
+        struct HasFixedImpedance<ElementType, void_t<decltype (ElementType::getFixedImpedance())>> : std::true_type
+        {
+        };
+
+        /**
+         * Holds an adaptor coefficient, which is replaced by a compile-time constant
+         * when FixedValue::value() can be computed from fixed port impedances.
+         */
+        template <typename T, typename FixedValue, bool isFixed = FixedValue::isFixed>
+        struct Coefficient
+        {
+            void set (T newValue) noexcept { value = newValue; }
+            T get() const noexcept { return value; }
+
+            T value = (T) 1.0;
+        };
+
+        template <typename T, typename FixedValue>
+        struct Coefficient<T, FixedValue, true>
+        {
+            void set (T) noexcept {}
+            static T get() noexcept { return (T) FixedValue::value(); }
+        };
+    } // namespace fixed_detail
+#endif // DOXYGEN
+
+    /**
+     * Calls fn for the given element, and for every element below it in the WDF tree.
+     * Usually this will be called on the root of the tree, to visit the whole circuit.
+     */
+    template <typename ElementType, typename Fn>
+    void forEachElement (ElementType& element, Fn&& fn)
+    {
+        fn (element);
+        element.visitPorts ([&fn] (auto& port) { forEachElement (port, fn); });
+    }
+
+    /**
+     * Returns the instrumentation counts for this element.
+     * If CHOWDSP_WDF_INSTRUMENTATION is disabled, the counts will always be zero.
+     */
+    inline InstrumentationCounters getInstrumentationCounters (const BaseWDF& element) noexcept
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION
+        return element.instrumentationCounters;
+#else
+        (void) element;
+        return {};
+#endif
+    }
+
+    /** Returns the sum of the instrumentation counts for every element in the circuit. */
+    template <typename RootType>
+    InstrumentationCounters getTotalInstrumentationCounters (RootType& root) noexcept
+    {
+        InstrumentationCounters total {};
+        forEachElement (root, [&total] (auto& element) { total += getInstrumentationCounters (element); });
+        return total;
+    }
+
+    /** Resets the instrumentation counts for every element in the circuit. */
+    template <typename RootType>
+    void resetInstrumentationCounters (RootType& root) noexcept
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION
+        forEachElement (root, [] (auto& element) { element.instrumentationCounters = {}; });
+#else
+        (void) root;
+#endif
+    }
+
     /** Probe the voltage across this circuit element. */
     template <typename T, typename WDFType>
     inline T voltage (const WDFType& wdf) noexcept
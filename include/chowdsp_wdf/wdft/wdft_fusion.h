@@ -0,0 +1,232 @@
+#ifndef CHOWDSP_WDF_WDFT_FUSION_H
+#define CHOWDSP_WDF_WDFT_FUSION_H
+
+#include <type_traits>
+
+#include "wdft_one_ports.h"
+#include "wdft_sources.h"
+
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace fusion_detail
+    {
+        /**
+         * Maps a pair of one-ports connected in series to the fused element
+         * which implements them both. Pairs which can't be fused have no "type".
+         */
+        template <typename T, typename P1Type, typename P2Type>
+        struct FusedSeries
+        {
+        };
+
+        /** Same as FusedSeries, but for one-ports connected in parallel. */
+        template <typename T, typename P1Type, typename P2Type>
+        struct FusedParallel
+        {
+        };
+
+        /** Series and parallel connections are symmetric, so the ports may come in either order. */
+        template <typename Fusion>
+        struct SwapPorts
+        {
+            using type = typename Fusion::type;
+
+            template <typename P1Type, typename P2Type>
+            static type make (const P1Type& p1, const P2Type& p2)
+            {
+                return Fusion::make (p2, p1);
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, CapacitorT<T>>
+        {
+            using type = ResistorCapacitorSeriesT<T>;
+
+            static type make (const ResistorT<T>& r, const CapacitorT<T>& c)
+            {
+                return type { r.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, InductorT<T>>
+        {
+            using type = ResistorInductorSeriesT<T>;
+
+            static type make (const ResistorT<T>& r, const InductorT<T>& l)
+            {
+                return type { r.getResistanceValue(), l.getInductanceValue(), l.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, InductorT<T>, CapacitorT<T>>
+        {
+            using type = InductorCapacitorSeriesT<T>;
+
+            static type make (const InductorT<T>& l, const CapacitorT<T>& c)
+            {
+                return type { l.getInductanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, InductorCapacitorSeriesT<T>>
+        {
+            using type = ResistorInductorCapacitorSeriesT<T>;
+
+            static type make (const ResistorT<T>& r, const InductorCapacitorSeriesT<T>& lc)
+            {
+                return type { r.getResistanceValue(), lc.getInductanceValue(), lc.getCapacitanceValue(), lc.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, ResistorCapacitorParallelT<T>>
+        {
+            using type = CapacitorESRT<T>;
+
+            static type make (const ResistorT<T>& esr, const ResistorCapacitorParallelT<T>& leakyCap)
+            {
+                return type { leakyCap.getCapacitanceValue(), esr.getResistanceValue(), leakyCap.getSampleRate(), leakyCap.getResistanceValue() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistiveVoltageSourceT<T>, CapacitorT<T>>
+        {
+            using type = ResistiveCapacitiveVoltageSourceT<T>;
+
+            static type make (const ResistiveVoltageSourceT<T>& vs, const CapacitorT<T>& c)
+            {
+                type fused { vs.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+                fused.setVoltage (vs.getVoltage());
+                return fused;
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistorT<T>, CapacitorT<T>>
+        {
+            using type = ResistorCapacitorParallelT<T>;
+
+            static type make (const ResistorT<T>& r, const CapacitorT<T>& c)
+            {
+                return type { r.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistorT<T>, InductorT<T>>
+        {
+            using type = ResistorInductorParallelT<T>;
+
+            static type make (const ResistorT<T>& r, const InductorT<T>& l)
+            {
+                return type { r.getResistanceValue(), l.getInductanceValue(), l.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, InductorT<T>, CapacitorT<T>>
+        {
+            using type = InductorCapacitorParallelT<T>;
+
+            static type make (const InductorT<T>& l, const CapacitorT<T>& c)
+            {
+                return type { l.getInductanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistiveCurrentSourceT<T>, CapacitorT<T>>
+        {
+            using type = ResistiveCapacitiveCurrentSourceT<T>;
+
+            static type make (const ResistiveCurrentSourceT<T>& is, const CapacitorT<T>& c)
+            {
+                type fused { is.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+                fused.setCurrent (is.getCurrent());
+                return fused;
+            }
+        };
+
+        // clang-format off
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedSeries<T, InductorT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, InductorT<T>>> {};
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, InductorT<T>> : SwapPorts<FusedSeries<T, InductorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedSeries<T, InductorCapacitorSeriesT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, InductorCapacitorSeriesT<T>>> {};
+        template <typename T> struct FusedSeries<T, ResistorCapacitorParallelT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, ResistorCapacitorParallelT<T>>> {};
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, ResistiveVoltageSourceT<T>> : SwapPorts<FusedSeries<T, ResistiveVoltageSourceT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, ResistorT<T>> : SwapPorts<FusedParallel<T, ResistorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, InductorT<T>, ResistorT<T>> : SwapPorts<FusedParallel<T, ResistorT<T>, InductorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, InductorT<T>> : SwapPorts<FusedParallel<T, InductorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, ResistiveCurrentSourceT<T>> : SwapPorts<FusedParallel<T, ResistiveCurrentSourceT<T>, CapacitorT<T>>> {};
+        // clang-format on
+
+        /** Only temporaries can be fused, since nothing else may be holding a reference to them. */
+        template <typename P1Type, typename P2Type>
+        using EnableIfTemporaries = std::enable_if_t<! std::is_lvalue_reference<P1Type>::value && ! std::is_lvalue_reference<P2Type>::value>;
+    } // namespace fusion_detail
+#endif // DOXYGEN
+
+    /** The fused element which replaces the series connection of P1Type and P2Type. */
+    template <typename T, typename P1Type, typename P2Type>
+    using FusedSeriesT = typename fusion_detail::FusedSeries<T, P1Type, P2Type>::type;
+
+    /** The fused element which replaces the parallel connection of P1Type and P2Type. */
+    template <typename T, typename P1Type, typename P2Type>
+    using FusedParallelT = typename fusion_detail::FusedParallel<T, P1Type, P2Type>::type;
+
+    /**
+     * Factory method for fusing two elements connected in series into a single element.
+     *
+     * When makeSeries() is called with two temporary elements (rather than references to
+     * elements that live elsewhere), the pair is replaced by the equivalent fused element,
+     * chosen at compile-time. Fused elements may be fused again, so that nested factory
+     * calls can collapse a whole sub-tree:
+     * @code
+     * // ResistorInductorCapacitorSeriesT<float>
+     * auto rlc = wdft::makeSeries<float> (wdft::ResistorT<float> { 100.0f },
+     *                                     wdft::makeSeries<float> (wdft::InductorT<float> { 10.0e-3f, fs },
+     *                                                              wdft::CapacitorT<float> { 1.0e-6f, fs }));
+     * rlc.setResistanceValue (220.0f);
+     * @endcode
+     *
+     * The fused element takes its values from the temporary elements, and has the same
+     * setters (setResistanceValue(), setCapacitanceValue(), etc.). Since the temporaries
+     * don't outlive the call, the internal states of the fused element can't be probed
+     * separately. The supported combinations are:
+     *  - Resistor + Capacitor, Resistor + Inductor, Inductor + Capacitor
+     *  - Resistor + (Inductor + Capacitor): ResistorInductorCapacitorSeriesT
+     *  - Resistor + (Capacitor || Resistor): CapacitorESRT
+     *  - ResistiveVoltageSource + Capacitor: ResistiveCapacitiveVoltageSourceT
+     *
+     * Other combinations don't compile, and should use the reference version of makeSeries().
+     */
+    template <typename T, typename P1Type, typename P2Type, typename = fusion_detail::EnableIfTemporaries<P1Type, P2Type>>
+    CHOWDSP_WDF_MAYBE_UNUSED FusedSeriesT<T, std::decay_t<P1Type>, std::decay_t<P2Type>> makeSeries (P1Type&& p1, P2Type&& p2)
+    {
+        return fusion_detail::FusedSeries<T, std::decay_t<P1Type>, std::decay_t<P2Type>>::make (p1, p2);
+    }
+
+    /**
+     * Factory method for fusing two elements connected in parallel into a single element.
+     *
+     * This works the same way as the fusing version of makeSeries(). The supported combinations are:
+     *  - Resistor || Capacitor, Resistor || Inductor, Inductor || Capacitor
+     *  - ResistiveCurrentSource || Capacitor: ResistiveCapacitiveCurrentSourceT
+     */
+    template <typename T, typename P1Type, typename P2Type, typename = fusion_detail::EnableIfTemporaries<P1Type, P2Type>>
+    CHOWDSP_WDF_MAYBE_UNUSED FusedParallelT<T, std::decay_t<P1Type>, std::decay_t<P2Type>> makeParallel (P1Type&& p1, P2Type&& p2)
+    {
+        return fusion_detail::FusedParallel<T, std::decay_t<P1Type>, std::decay_t<P2Type>>::make (p1, p2);
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDFT_FUSION_H
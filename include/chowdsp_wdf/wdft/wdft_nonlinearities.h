@@ -53,6 +53,7 @@ namespace wdft
 
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
 #if defined(XSIMD_HPP)
             using xsimd::log;
 #endif
@@ -66,16 +67,25 @@ namespace wdft
         /** Accepts an incident wave into a WDF diode pair. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF diode pair. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             reflectedInternal();
             return wdf.b;
         }
 
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -110,7 +120,7 @@ namespace wdft
         T R_Is_overVt;
         T logR_Is_overVt;
 
-        const Next& next;
+        Next& next;
     };
 
     /**
@@ -147,6 +157,7 @@ namespace wdft
 
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
 #if defined(XSIMD_HPP)
             using xsimd::log;
 #endif
@@ -160,17 +171,26 @@ namespace wdft
         /** Accepts an incident wave into a WDF diode. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF diode. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             // See eqn (10) from reference paper
             wdf.b = wdf.a + twoR_Is - twoVt * OmegaProvider::omega (logR_Is_overVt + wdf.a * oneOverVt + R_Is_overVt);
             return wdf.b;
         }
 
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -184,7 +204,7 @@ namespace wdft
         T R_Is_overVt;
         T logR_Is_overVt;
 
-        const Next& next;
+        Next& next;
     };
 
     /** WDF Switch (non-adaptable) */
@@ -192,12 +212,12 @@ namespace wdft
     class SwitchT final : public RootWDF
     {
     public:
-        explicit SwitchT (Next& next)
+        explicit SwitchT (Next& n) : next (n)
         {
-            next.connectToParent (this);
+            n.connectToParent (this);
         }
 
-        inline void calcImpedance() override {}
+        inline void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
 
         /** Sets the state of the switch. */
         void setClosed (bool shouldClose) { closed = shouldClose; }
@@ -205,19 +225,30 @@ namespace wdft
         /** Accepts an incident wave into a WDF switch. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF switch. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = closed ? -wdf.a : wdf.a;
             return wdf.b;
         }
 
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
         WDFMembers<T> wdf;
 
     private:
+        Next& next;
+
         bool closed = true;
     };
 } // namespace wdft
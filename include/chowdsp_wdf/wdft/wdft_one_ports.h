@@ -1,7 +1,11 @@
 #ifndef CHOWDSP_WDF_WDFT_ONE_PORTS_H
 #define CHOWDSP_WDF_WDFT_ONE_PORTS_H
 
+#include <ratio>
+
 #include "wdft_base.h"
+#include "../math/compensated_float.h"
+#include "../math/denormals.h"
 
 namespace chowdsp
 {
@@ -30,9 +34,13 @@ namespace wdft
             propagateImpedanceChange();
         }
 
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
         /** Computes the impedance of the WDF resistor, Z_R = R. */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = R_value;
             wdf.G = (T) 1.0 / wdf.R;
         }
@@ -40,12 +48,14 @@ namespace wdft
         /** Accepts an incident wave into a WDF resistor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF resistor. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = 0.0;
             return wdf.b;
         }
@@ -56,6 +66,59 @@ namespace wdft
         T R_value = (T) 1.0e-9;
     };
 
+    /**
+     * WDF Resistor Node, with a resistance that is fixed at compile-time.
+     *
+     * The resistance is given in Ohms as a std::ratio, e.g. FixedResistorT<float, std::ratio<4700>>
+     * or FixedResistorT<float, std::ratio<22, 10>> for 2.2 Ohms. When both ports of a WDFSeriesT or
+     * WDFParallelT adaptor have fixed impedances, the adaptor's reflection coefficient becomes a
+     * compile-time constant, and the adaptor's impedance is fixed as well, so whole sub-trees of
+     * fixed resistors fold into constants.
+     */
+    template <typename T, typename ResistanceRatio>
+    class FixedResistorT final : public BaseWDF
+    {
+    public:
+        FixedResistorT()
+        {
+            calcImpedance();
+        }
+
+        /** Returns the resistance value, in Ohms, at compile-time. */
+        static constexpr double getFixedImpedance() noexcept
+        {
+            return (double) ResistanceRatio::num / (double) ResistanceRatio::den;
+        }
+
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return (T) getFixedImpedance(); }
+
+        /** Computes the impedance of the WDF resistor, Z_R = R. */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) getFixedImpedance();
+            wdf.G = (T) (1.0 / getFixedImpedance());
+        }
+
+        /** Accepts an incident wave into a WDF resistor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF resistor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = 0.0;
+            return wdf.b;
+        }
+
+        WDFMembers<T> wdf;
+    };
+
     /** WDF Capacitor Node */
     template <typename T>
     class CapacitorT final : public BaseWDF
@@ -96,6 +159,12 @@ namespace wdft
             propagateImpedanceChange();
         }
 
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return fs; }
+
         /** Computes the impedance of the WDF capacitor,
          *             1
          * Z_C = --------------
@@ -103,6 +172,7 @@ namespace wdft
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
             wdf.G = (T) 1.0 / wdf.R;
         }
@@ -110,17 +180,26 @@ namespace wdft
         /** Accepts an incident wave into a WDF capacitor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.a;
+            z = denormals::flushState (wdf.a);
         }
 
         /** Propogates a reflected wave from a WDF capacitor. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = z;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -192,6 +271,7 @@ namespace wdft
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = (T) 1.0 / (((T) 1.0 + alpha) * C_value * fs);
             wdf.G = (T) 1.0 / wdf.R;
         }
@@ -199,17 +279,26 @@ namespace wdft
         /** Accepts an incident wave into a WDF capacitor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.a;
+            z = denormals::flushState (wdf.a);
         }
 
         /** Propogates a reflected wave from a WDF capacitor. */
         inline T reflected() noexcept
         {
-            wdf.b = b_coef * wdf.b + a_coef * z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = denormals::flushState (b_coef * wdf.b + a_coef * z);
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -263,11 +352,18 @@ namespace wdft
             propagateImpedanceChange();
         }
 
+        /** Returns the inductance value, in Henries. */
+        T getInductanceValue() const noexcept { return L_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return fs; }
+
         /** Computes the impedance of the WDF inductor,
          * Z_L = 2 * f_s * L
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = (T) 2.0 * L_value * fs;
             wdf.G = (T) 1.0 / wdf.R;
         }
@@ -275,17 +371,26 @@ namespace wdft
         /** Accepts an incident wave into a WDF inductor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.a;
+            z = denormals::flushState (wdf.a);
         }
 
         /** Propogates a reflected wave from a WDF inductor. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = -z;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -355,6 +460,7 @@ namespace wdft
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = ((T) 1.0 + alpha) * L_value * fs;
             wdf.G = (T) 1.0 / wdf.R;
         }
@@ -362,17 +468,26 @@ namespace wdft
         /** Accepts an incident wave into a WDF inductor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.a;
+            z = denormals::flushState (wdf.a);
         }
 
         /** Propogates a reflected wave from a WDF inductor. */
         inline T reflected() noexcept
         {
-            wdf.b = b_coef * wdf.b - a_coef * z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = denormals::flushState (b_coef * wdf.b - a_coef * z);
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -386,8 +501,15 @@ namespace wdft
         T a_coef;
     };
 
-    /** WDF Resistor and Capacitor in Series */
-    template <typename T>
+    /**
+     * WDF Resistor and Capacitor in Series
+     *
+     * For low cutoff frequencies, the capacitor state integrates very small increments,
+     * so the StateType argument may be used to store the state at a higher precision
+     * than the waves and coefficients, e.g. `ResistorCapacitorSeriesT<float, double>`,
+     * or `ResistorCapacitorSeriesT<xsimd::batch<float>, CompensatedFloat<xsimd::batch<float>>>`.
+     */
+    template <typename T, typename StateType = T>
     class ResistorCapacitorSeriesT final : public BaseWDF
     {
     public:
@@ -416,7 +538,7 @@ namespace wdft
         /** Resets the capacitor state */
         void reset()
         {
-            z = (T) 0.0;
+            z = StateType {};
             wdf.a = (T) 0;
             wdf.b = (T) 0;
         }
@@ -444,6 +566,7 @@ namespace wdft
         /** Computes the impedance of the WDF resistor/capacitor combination */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = tt / ((T) 2.0 * C_value) + R_value;
             wdf.G = (T) 1.0 / wdf.R;
             T_over_T_plus_2RC = tt / ((T) 2 * C_value * R_value + tt);
@@ -452,17 +575,27 @@ namespace wdft
         /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
             z -= T_over_T_plus_2RC * (wdf.a + z);
+            z = denormals::flushState (z);
         }
 
         /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            wdf.b = -z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -(T) z;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -471,7 +604,7 @@ namespace wdft
 
         T T_over_T_plus_2RC = (T) 0.0;
 
-        T z = (T) 0.0;
+        StateType z {};
 
         T tt;
     };
@@ -531,9 +664,19 @@ namespace wdft
             propagateImpedanceChange();
         }
 
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return (T) 1 / tt; }
+
         /** Computes the impedance of the WDF resistor/capacitor combination */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             const auto twoRC = (T) 2.0 * C_value * R_value;
             wdf.R = R_value * tt / (twoRC + tt);
             wdf.G = (T) 1.0 / wdf.R;
@@ -543,24 +686,701 @@ namespace wdft
         /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.b + wdf.a - z;
+            z = denormals::flushState (wdf.b + wdf.a - z);
         }
 
         /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = twoRC_over_twoRC_plus_T * z;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e3;
+        T C_value = (T) 1.0e-6;
+
+        T twoRC_over_twoRC_plus_T = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
+    };
+
+    /** WDF Resistor and Inductor in Series */
+    template <typename T>
+    class ResistorInductorSeriesT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor Series.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorInductorSeriesT (T res_value, T ind_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF resistor/inductor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoL = (T) 2.0 * L_value;
+            wdf.R = twoL / tt + R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+            twoL_over_twoL_plus_RT = twoL / (twoL + R_value * tt);
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (twoL_over_twoL_plus_RT * (z - wdf.a) - z);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = z;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
+
+        T twoL_over_twoL_plus_RT = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
+    };
+
+    /** WDF Resistor and Inductor in parallel */
+    template <typename T>
+    class ResistorInductorParallelT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor Parallel.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorInductorParallelT (T res_value, T ind_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF resistor/inductor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoL = (T) 2.0 * L_value;
+            const auto RT = R_value * tt;
+            wdf.R = twoL * R_value / (RT + twoL);
+            wdf.G = (T) 1.0 / wdf.R;
+            RT_over_RT_plus_twoL = RT / (RT + twoL);
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.b + wdf.a + z);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -RT_over_RT_plus_twoL * z;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
         T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
+
+        T RT_over_RT_plus_twoL = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
+    };
+
+    /** WDF Inductor and Capacitor in Series */
+    template <typename T>
+    class InductorCapacitorSeriesT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Inductor/Capacitor Series.
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit InductorCapacitorSeriesT (T ind_value, T cap_value, T fs = (T) 48000.0)
+            : L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Returns the inductance value, in Henries. */
+        T getInductanceValue() const noexcept { return L_value; }
+
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return (T) 1 / tt; }
+
+        /** Computes the impedance of the WDF inductor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto R_C = tt / ((T) 2.0 * C_value);
+            wdf.R = R_C + (T) 2.0 * L_value / tt;
+            wdf.G = (T) 1.0 / wdf.R;
+            RC_over_Rp = R_C * wdf.G;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            zC = denormals::flushState (zC - RC_over_Rp * (wdf.a - wdf.b));
+            zL = denormals::flushState (-(wdf.a + zC));
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = zL - zC;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (zL);
+            visitor (zC);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T L_value = (T) 1.0e-3;
+        T C_value = (T) 1.0e-6;
+
+        T RC_over_Rp = (T) 0.0;
+
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
+
+        T tt;
+    };
+
+    /** WDF Inductor and Capacitor in parallel */
+    template <typename T>
+    class InductorCapacitorParallelT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Inductor/Capacitor Parallel.
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit InductorCapacitorParallelT (T ind_value, T cap_value, T fs = (T) 48000.0)
+            : L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF inductor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto G_C = (T) 2.0 * C_value / tt;
+            wdf.G = G_C + tt / ((T) 2.0 * L_value);
+            wdf.R = (T) 1.0 / wdf.G;
+            GC_over_Gp = G_C * wdf.R;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            const auto a_plus_b = wdf.a + wdf.b;
+            zL = denormals::flushState (a_plus_b + zL);
+            zC = denormals::flushState (a_plus_b - zC);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = GC_over_Gp * (zL + zC) - zL;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (zL);
+            visitor (zC);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T L_value = (T) 1.0e-3;
+        T C_value = (T) 1.0e-6;
+
+        T GC_over_Gp = (T) 0.0;
+
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
+
+        T tt;
+    };
+
+    /** WDF Resistor, Inductor, and Capacitor in Series */
+    template <typename T>
+    class ResistorInductorCapacitorSeriesT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor/Capacitor Series.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorInductorCapacitorSeriesT (T res_value, T ind_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF resistor/inductor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto R_L = (T) 2.0 * L_value / tt;
+            const auto R_C = tt / ((T) 2.0 * C_value);
+            wdf.R = R_value + R_L + R_C;
+            wdf.G = (T) 1.0 / wdf.R;
+            RL_over_Rp = R_L * wdf.G;
+            RC_over_Rp = R_C * wdf.G;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            const auto a_minus_b = wdf.a - wdf.b;
+            zL = denormals::flushState (-(zL + RL_over_Rp * a_minus_b));
+            zC = denormals::flushState (zC - RC_over_Rp * a_minus_b);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = zL - zC;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (zL);
+            visitor (zC);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
+        T C_value = (T) 1.0e-6;
+
+        T RL_over_Rp = (T) 0.0;
+        T RC_over_Rp = (T) 0.0;
+
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
+
+        T tt;
+    };
+
+    /**
+     * WDF Capacitor with an equivalent series resistance (ESR),
+     * and a leakage resistance in parallel with the capacitor.
+     *
+     * The default leakage resistance is large enough that the
+     * element behaves like a resistor and capacitor in series.
+     */
+    template <typename T>
+    class CapacitorESRT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Capacitor with ESR.
+         * @param cap_value: Capacitance value in Farads
+         * @param esr_value: Equivalent series resistance in Ohms
+         * @param fs: WDF sample rate
+         * @param leakage_value: Leakage resistance in Ohms
+         */
+        explicit CapacitorESRT (T cap_value, T esr_value, T fs = (T) 48000.0, T leakage_value = NumericType<T> (1.0e9))
+            : C_value (cap_value),
+              ESR_value (esr_value),
+              leakage_value (leakage_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the equivalent series resistance, in Ohms. */
+        void setESRValue (T newESR)
+        {
+            if (all (newESR == ESR_value))
+                return;
+
+            ESR_value = newESR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the leakage resistance, in Ohms. */
+        void setLeakageResistanceValue (T newR)
+        {
+            if (all (newR == leakage_value))
+                return;
+
+            leakage_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF capacitor/ESR/leakage combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoRC = (T) 2.0 * C_value * leakage_value;
+            const auto R_leaky_cap = leakage_value * tt / (twoRC + tt);
+            wdf.R = R_leaky_cap + ESR_value;
+            wdf.G = (T) 1.0 / wdf.R;
+            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
+            Rcap_over_Rp = R_leaky_cap * wdf.G;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (-((T) 2 * wdf.b + z + Rcap_over_Rp * (wdf.a - wdf.b)));
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -twoRC_over_twoRC_plus_T * z;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
         T C_value = (T) 1.0e-6;
+        T ESR_value = (T) 1.0;
+        T leakage_value = (T) 1.0e9;
 
         T twoRC_over_twoRC_plus_T = (T) 0.0;
+        T Rcap_over_Rp = (T) 0.0;
 
         T z = (T) 0.0;
 
@@ -2,6 +2,8 @@
 #define CHOWDSP_WDF_WDFT_SOURCES_H
 
 #include "wdft_base.h"
+#include "../math/compensated_float.h"
+#include "../math/denormals.h"
 
 namespace chowdsp
 {
@@ -12,13 +14,13 @@ namespace wdft
     class IdealVoltageSourceT final : public RootWDF
     {
     public:
-        explicit IdealVoltageSourceT (Next& next)
+        explicit IdealVoltageSourceT (Next& n) : next (n)
         {
-            next.connectToParent (this);
+            n.connectToParent (this);
             calcImpedance();
         }
 
-        void calcImpedance() override {}
+        void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
 
         /** Sets the voltage of the voltage source, in Volts */
         void setVoltage (T newV) { Vs = newV; }
@@ -26,19 +28,30 @@ namespace wdft
         /** Accepts an incident wave into a WDF ideal voltage source. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF ideal voltage source. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = -wdf.a + (T) 2.0 * Vs;
             return wdf.b;
         }
 
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
         WDFMembers<T> wdf;
 
     private:
+        Next& next;
+
         T Vs = (T) 0.0;
     };
 
@@ -65,11 +78,15 @@ namespace wdft
             propagateImpedanceChange();
         }
 
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
         /** Computes the impedance for a WDF resistive voltage souce
          * Z_Vr = Z_R
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = R_value;
             wdf.G = (T) 1.0 / wdf.R;
         }
@@ -77,15 +94,20 @@ namespace wdft
         /** Sets the voltage of the voltage source, in Volts */
         void setVoltage (T newV) { Vs = newV; }
 
+        /** Returns the voltage of the voltage source, in Volts */
+        T getVoltage() const noexcept { return Vs; }
+
         /** Accepts an incident wave into a WDF resistive voltage source. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF resistive voltage source. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = Vs;
             return wdf.b;
         }
@@ -145,6 +167,7 @@ namespace wdft
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
             wdf.G = (T) 1.0 / wdf.R;
         }
@@ -158,18 +181,28 @@ namespace wdft
         /** Accepts an incident wave into a WDF resistive voltage source. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.a;
+            z = denormals::flushState (wdf.a);
         }
 
         /** Propogates a reflected wave from a WDF resistive voltage source. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = z + v_0 - v_1;
             v_1 = v_0;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+            visitor (v_1);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -195,6 +228,7 @@ namespace wdft
 
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             twoR = (T) 2.0 * next.wdf.R;
             twoR_Is = twoR * Is;
         }
@@ -209,20 +243,29 @@ namespace wdft
         /** Accepts an incident wave into a WDF ideal current source. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF ideal current source. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = twoR_Is + wdf.a;
             return wdf.b;
         }
 
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        const Next& next;
+        Next& next;
 
         T Is = (T) 0.0;
         T twoR;
@@ -252,11 +295,15 @@ namespace wdft
             propagateImpedanceChange();
         }
 
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
         /** Computes the impedance for a WDF resistive current souce
          * Z_Ir = Z_R
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = R_value;
             wdf.G = (T) 1.0 / wdf.R;
         }
@@ -264,15 +311,20 @@ namespace wdft
         /** Sets the current of the current source, in Amps */
         void setCurrent (T newI) { Is = newI; }
 
+        /** Returns the current of the current source, in Amps */
+        T getCurrent() const noexcept { return Is; }
+
         /** Accepts an incident wave into a WDF resistive current source. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF resistive current source. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = wdf.R * Is;
             return wdf.b;
         }
@@ -284,8 +336,13 @@ namespace wdft
         T R_value = (T) 1.0e9;
     };
 
-    /** WDF Resistor and Capacitor and Voltage source in Series */
-    template <typename T>
+    /**
+     * WDF Resistor and Capacitor and Voltage source in Series
+     *
+     * As with ResistorCapacitorSeriesT, the StateType argument may be used to store the
+     * capacitor state at a higher precision than the waves and coefficients.
+     */
+    template <typename T, typename StateType = T>
     class ResistiveCapacitiveVoltageSourceT final : public BaseWDF
     {
     public:
@@ -315,7 +372,7 @@ namespace wdft
         /** Resets the capacitor state */
         void reset()
         {
-            z = 0.0f;
+            z = StateType {};
         }
 
         /** Sets the resistance value of the WDF resistor, in Ohms. */
@@ -344,25 +401,36 @@ namespace wdft
         /** Computes the impedance of the WDF resistor/capacitor combination */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = tt / ((T) 2.0 * C_value) + R_value;
             wdf.G = (T) 1.0 / wdf.R;
-            T_over_2RC = tt / ((T) 2 * C_value * R_value);
+            T_over_T_plus_2RC = tt / ((T) 2 * C_value * R_value + tt);
         }
 
         /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z -= T_over_2RC * (wdf.a - wdf.b);
+            z -= T_over_T_plus_2RC * (wdf.a - wdf.b);
+            z = denormals::flushState (z);
         }
 
         /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            wdf.b = -(z + Vs);
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -(T) (z + Vs);
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -370,7 +438,119 @@ namespace wdft
         T R_value = (T) 1.0e3;
         T C_value = (T) 1.0e-6;
 
-        T T_over_2RC = (T) 0.0;
+        T T_over_T_plus_2RC = (T) 0.0;
+
+        StateType z {};
+
+        T tt;
+    };
+
+    /** WDF Current source with a resistor and capacitor in parallel */
+    template <typename T>
+    class ResistiveCapacitiveCurrentSourceT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Capacitor/Current Source Parallel.
+         * @param res_value: Resistance value in Ohms
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistiveCapacitiveCurrentSourceT (T res_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+            reset();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI)
+        {
+            Is = newI;
+            Rp_Is = wdf.R * Is;
+        }
+
+        /** Computes the impedance of the WDF resistor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoRC = (T) 2.0 * C_value * R_value;
+            wdf.R = R_value * tt / (twoRC + tt);
+            wdf.G = (T) 1.0 / wdf.R;
+            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
+            Rp_Is = wdf.R * Is;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.b + wdf.a - z);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = twoRC_over_twoRC_plus_T * z + Rp_Is;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T Is = (T) 0.0;
+        T R_value = (T) 1.0e3;
+        T C_value = (T) 1.0e-6;
+
+        T twoRC_over_twoRC_plus_T = (T) 0.0;
+        T Rp_Is = (T) 0.0;
 
         T z = (T) 0.0;
 
@@ -301,3 +301,148 @@ $ B(z) = A(z) z^(-1) + E(z) (1 - z^(-1)) $
 
 Applying the inverse $z$-transform:
 $ b[n] = a[n-1] + e[n] - e[n-1] $
+
+= Resistor-Inductor Series
+
+A WDF Inductor is defined by:
+
+$ R_p = (2L)/T, b = -a[n-1] $
+
+We use the 1-multiply series adaptor again, with the
+inductor at port (1), and the resistor at port (2):
+$
+R_p = (2L)/T + R \
+R_i := R_1/R_p = (2L)/(2L + R T) \
+b_0 = -b_l - b_r \
+a_l = b_l - R_i (a_0 + b_l + b_r)
+$
+
+Subbing in $b_l = -a_l[n-1]$ and $b_r = 0$:
+$
+b_0 = a_l[n-1] \
+a_l = -a_l[n-1] - R_i (a_0 - a_l[n-1])
+$
+
+So the final derivation:
+$
+b_0 = z[n-1] \
+z = R_i (z[n-1] - a_0) - z[n-1]
+$
+
+= Resistor-Inductor Parallel
+
+Using the 1-multiply parallel adaptor, with the inductor
+at port (1), and the resistor at port (2):
+$
+G_p = T/(2L) + 1/R \
+G_i := G_1/G_p = (R T)/(R T + 2L) \
+b_d = b_r - b_l = a_l[n-1] \
+b_0 = b_r - G_i b_d = -G_i a_l[n-1] \
+a_r = b_0 - b_r + a_0 = b_0 + a_0 \
+a_l = a_r + b_d = b_0 + a_0 + a_l[n-1]
+$
+
+So the final derivation:
+$
+b_0 = -G_i z[n-1] \
+z = b_0 + a_0 + z[n-1]
+$
+
+= Inductor-Capacitor Series
+
+Now there are two states, $z_l$ and $z_c$. With the
+capacitor at port (1) and the inductor at port (2)
+of the series adaptor:
+$
+R_p = T/(2C) + (2L)/T \
+R_i := R_1/R_p \
+b_0 = -b_c - b_l = z_l[n-1] - z_c[n-1] \
+a_c = b_c - R_i (a_0 + b_c + b_l) = z_c[n-1] - R_i (a_0 - b_0) \
+a_l = -(a_0 + a_c)
+$
+
+So the final derivation:
+$
+b_0 = z_l[n-1] - z_c[n-1] \
+z_c = z_c[n-1] - R_i (a_0 - b_0) \
+z_l = -(a_0 + z_c)
+$
+
+= Inductor-Capacitor Parallel
+
+With the capacitor at port (1) and the inductor at
+port (2) of the parallel adaptor:
+$
+G_p = (2C)/T + T/(2L) \
+G_i := G_1/G_p \
+b_d = b_l - b_c = -z_l[n-1] - z_c[n-1] \
+b_0 = b_l - G_i b_d = G_i (z_l[n-1] + z_c[n-1]) - z_l[n-1] \
+a_l = b_0 - b_l + a_0 = b_0 + a_0 + z_l[n-1] \
+a_c = a_l + b_d = b_0 + a_0 - z_c[n-1]
+$
+
+So the final derivation:
+$
+b_0 = G_i (z_l[n-1] + z_c[n-1]) - z_l[n-1] \
+z_l = b_0 + a_0 + z_l[n-1] \
+z_c = b_0 + a_0 - z_c[n-1]
+$
+
+= Resistor-Inductor-Capacitor Series
+
+For a series adaptor with more ports, where port (0) is
+adapted, each of the other ports reflects:
+$ b_k = a_k - R_k/R_p (a_0 + sum_j a_j) $
+and $b_0 = -sum_j a_j$. With a resistor, inductor, and
+capacitor, $sum_j a_j = z_c[n-1] - z_l[n-1] = -b_0$, so:
+$
+R_p = R + (2L)/T + T/(2C) \
+b_0 = z_l[n-1] - z_c[n-1] \
+z_l = -z_l[n-1] - ((2L)/T)/R_p (a_0 - b_0) \
+z_c = z_c[n-1] - (T/(2C))/R_p (a_0 - b_0)
+$
+
+= Resistive-Capacitive Current Source (Parallel)
+
+A WDF Resistive Current Source is defined:
+
+$ R_p = R, b = R I $
+
+This is the same as the Resistor-Capacitor Parallel
+combination, except that $b_r = R I$:
+$
+G_i = (2 R C)/(2 R C + T) \
+b_d = R I - z[n-1] \
+b_0 = R I - G_i b_d = G_i z[n-1] + (1 - G_i) R I \
+a_c = b_0 + a_0 - z[n-1]
+$
+
+Note that $(1 - G_i) R = (R T)/(2 R C + T)$ is the port
+impedance $R_p$ of the combined element, so:
+$
+b_0 = G_i z[n-1] + R_p I \
+z = b_0 + a_0 - z[n-1]
+$
+
+= Capacitor With ESR
+
+A real capacitor can be modelled as a capacitor
+in parallel with a (large) leakage resistance $R_l$, in
+series with a (small) equivalent series resistance.
+The capacitor and leakage resistance are combined as in
+the Resistor-Capacitor Parallel section, with
+$G_i = (2 R_l C)/(2 R_l C + T)$ and port impedance
+$R_1 = (R_l T)/(2 R_l C + T)$. Then, we connect that
+in series with the ESR, with $R_i := R_1/(R_1 + R_"ESR")$:
+$
+b_1 = G_i z[n-1] \
+b_0 = -b_1 \
+a_1 = b_1 - R_i (a_0 + b_1) = -b_0 - R_i (a_0 - b_0) \
+z = b_1 + a_1 - z[n-1]
+$
+
+So the final derivation:
+$
+b_0 = -G_i z[n-1] \
+z = -(2 b_0 + z[n-1] + R_i (a_0 - b_0))
+$
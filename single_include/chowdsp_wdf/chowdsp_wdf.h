@@ -36,10 +36,14 @@ namespace wdft
 #ifndef CHOWDSP_WDF_WDFT_ONE_PORTS_H
 #define CHOWDSP_WDF_WDFT_ONE_PORTS_H
 
+#include <ratio>
+
 // #include "wdft_base.h"
 #ifndef CHOWDSP_WDF_WDFT_BASE_H
 #define CHOWDSP_WDF_WDFT_BASE_H
 
+#include <type_traits>
+
 // #include "../math/sample_type.h"
 #ifndef CHOWDSP_WDF_SAMPLE_TYPE_H
 #define CHOWDSP_WDF_SAMPLE_TYPE_H
@@ -90,498 +94,919 @@ inline T select (bool b, const T& t, const T& f)
 
 #endif //CHOWDSP_WDF_SAMPLE_TYPE_H
 
+// #include "../util/instrumentation.h"
+#ifndef CHOWDSP_WDF_INSTRUMENTATION_H
+#define CHOWDSP_WDF_INSTRUMENTATION_H
+
+#include <cstdint>
+
+/**
+ * If CHOWDSP_WDF_INSTRUMENTATION is enabled, every WDF element keeps count of
+ * how many times its impedance has been recomputed, how many impedance changes
+ * have been propagated through it, and how many incident/reflected waves it has
+ * processed. The counts can be retrieved with wdft::getInstrumentationCounters().
+ *
+ * When the option is disabled (the default), the counters are compiled out
+ * completely, so there is no runtime or memory cost.
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_INSTRUMENTATION
+#define CHOWDSP_WDF_INSTRUMENTATION 0
+#endif
+
+/**
+ * If CHOWDSP_WDF_INSTRUMENTATION is enabled, CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+ * can be set to a power of two N, in which case every Nth call to each instrumented
+ * method is timed using the CPU cycle counter (rdtsc on x86, cntvct_el0 on ARM64).
+ * Sampling keeps the overhead of reading the counter low, while still giving a good
+ * estimate of the per-call cost.
+ */
+#ifndef CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+#define CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING 0
+#endif
+
+#if CHOWDSP_WDF_INSTRUMENTATION && CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_CNTVCT 1
+#else
+#include <chrono>
+#endif
+#endif
 
 namespace chowdsp
 {
 namespace wdft
 {
-    /** Base WDF class for propagating impedance changes between elements */
-    class BaseWDF
+    /** Instrumentation counts for a single WDF element (see CHOWDSP_WDF_INSTRUMENTATION). */
+    struct InstrumentationCounters
     {
-    public:
-        virtual ~BaseWDF() = default;
-
-        void connectToParent (BaseWDF* p) { parent = p; }
+        uint64_t calcImpedance = 0; /* number of calls to calcImpedance() */
+        uint64_t propagateImpedanceChange = 0; /* number of impedance changes propagated through this element */
+        uint64_t incident = 0; /* number of calls to incident(), or compute() for R-Type root adaptors */
+        uint64_t reflected = 0; /* number of calls to reflected() */
 
-        virtual void calcImpedance() = 0;
+        /**
+         * Total cycles spent in the sampled calls to incident() and reflected(). Note that for
+         * adaptors this includes the time spent in the connected ports, so the cost of an adaptor
+         * itself is roughly its average cycles, minus the average cycles of its ports.
+         */
+        uint64_t cycles = 0;
+        uint64_t cycleSamples = 0; /* number of calls included in the cycle count */
 
-        inline virtual void propagateImpedanceChange()
+        /** Returns the average number of cycles per sampled call to incident() or reflected() */
+        double getAverageCycles() const noexcept
         {
-            if (dontPropagateImpedance)
-                return; // the impedance propagation is being deferred until later...
+            return cycleSamples == 0 ? 0.0 : (double) cycles / (double) cycleSamples;
+        }
 
-            calcImpedance();
+        InstrumentationCounters& operator+= (const InstrumentationCounters& other) noexcept
+        {
+            calcImpedance += other.calcImpedance;
+            propagateImpedanceChange += other.propagateImpedanceChange;
+            incident += other.incident;
+            reflected += other.reflected;
+            cycles += other.cycles;
+            cycleSamples += other.cycleSamples;
+            return *this;
+        }
+    };
 
-            if (parent != nullptr)
-                parent->propagateImpedanceChange();
+#ifndef DOXYGEN
+    namespace instrumentation_detail
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION && CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+        static_assert ((CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING & (CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING - 1)) == 0,
+                       "The cycle sampling interval must be a power of two!");
+
+        inline uint64_t readCycleCounter() noexcept
+        {
+#if CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC
+            return (uint64_t) __rdtsc();
+#elif CHOWDSP_WDF_INSTRUMENTATION_USE_CNTVCT
+            uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0"
+                         : "=r"(ticks));
+            return ticks;
+#else
+            return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
         }
+#endif
 
-    protected:
-        BaseWDF* parent = nullptr;
+#if CHOWDSP_WDF_INSTRUMENTATION
+        /** Increments a call counter, and (maybe) measures the cycles spent in the current scope. */
+        class ScopedCounter
+        {
+        public:
+            ScopedCounter (uint64_t& callCount, InstrumentationCounters& counters) noexcept
+#if CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+                : sampledCounters ((callCount++ & (CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING - 1)) == 0 ? &counters : nullptr)
+            {
+                if (sampledCounters != nullptr)
+                    startTime = readCycleCounter();
+            }
+#else
+            {
+                callCount++;
+                (void) counters;
+            }
+#endif
 
-    private:
-        bool dontPropagateImpedance = false;
+#if CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+            ~ScopedCounter() noexcept
+            {
+                if (sampledCounters != nullptr)
+                {
+                    sampledCounters->cycles += readCycleCounter() - startTime;
+                    sampledCounters->cycleSamples++;
+                }
+            }
 
-        template <typename... Elements>
-        friend class ScopedDeferImpedancePropagation;
-    };
+        private:
+            InstrumentationCounters* sampledCounters;
+            uint64_t startTime = 0;
+#endif
+        };
+#endif
+    } // namespace instrumentation_detail
+#endif // DOXYGEN
+} // namespace wdft
+} // namespace chowdsp
 
-    /** Base class for propagating impedance changes into root WDF elements */
-    class RootWDF : public BaseWDF
-    {
-    public:
-        inline void propagateImpedanceChange() override { calcImpedance(); }
+#if CHOWDSP_WDF_INSTRUMENTATION
+/** Counts a call to the given method of the current WDF element */
+#define CHOWDSP_WDF_INSTRUMENT_COUNT(method) (this->instrumentationCounters.method++)
 
-    private:
-        // don't try to connect root nodes!
-        void connectToParent (BaseWDF*) {}
-    };
+/** Counts a call to the given method of the current WDF element, and samples the time spent in the method */
+#define CHOWDSP_WDF_INSTRUMENT_TIMED(method) \
+    ::chowdsp::wdft::instrumentation_detail::ScopedCounter chowdsp_wdf_instrumentation_scope { this->instrumentationCounters.method, this->instrumentationCounters }
+#else
+#define CHOWDSP_WDF_INSTRUMENT_COUNT(method)
+#define CHOWDSP_WDF_INSTRUMENT_TIMED(method)
+#endif
 
-    /** Helper struct for common WDF member variables */
-    template <typename T>
-    struct WDFMembers
-    {
-        T R = (NumericType<T>) 1.0e-9; /* impedance */
-        T G = (T) 1.0 / R; /* admittance */
-        T a = (T) 0.0; /* incident wave */
-        T b = (T) 0.0; /* reflected wave */
-    };
+#endif //CHOWDSP_WDF_INSTRUMENTATION_H
 
-    /** Probe the voltage across this circuit element. */
-    template <typename T, typename WDFType>
-    inline T voltage (const WDFType& wdf) noexcept
-    {
-        return (wdf.wdf.a + wdf.wdf.b) * (T) 0.5;
-    }
 
-    /**Probe the current through this circuit element. */
-    template <typename T, typename WDFType>
-    inline T current (const WDFType& wdf) noexcept
-    {
-        return (wdf.wdf.a - wdf.wdf.b) * ((T) 0.5 * wdf.wdf.G);
-    }
-} // namespace wdft
-} // namespace chowdsp
+#ifndef CHOWDSP_WDF_TRACING
+#define CHOWDSP_WDF_TRACING 0
+#endif
 
-#endif // CHOWDSP_WDF_WDFT_BASE_H
+#if CHOWDSP_WDF_TRACING
+// #include "../util/impedance_trace.h"
+#ifndef CHOWDSP_WDF_IMPEDANCE_TRACE_H
+#define CHOWDSP_WDF_IMPEDANCE_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
+/**
+ * If CHOWDSP_WDF_TRACING is enabled, every impedance propagation through the
+ * WDF tree is recorded into the active ImpedanceTracer (if there is one).
+ *
+ * When the option is disabled (the default), the tracing hooks are compiled
+ * out completely, so there is no runtime cost, and this header is not included
+ * by the WDF elements (it can still be included directly, for the tracer classes).
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_TRACING
+#define CHOWDSP_WDF_TRACING 0
+#endif
 
 namespace chowdsp
 {
 namespace wdft
 {
-    /** WDF Resistor Node */
-    template <typename T>
-    class ResistorT final : public BaseWDF
+    class BaseWDF;
+
+    /** A single impedance propagation event, recorded by the ImpedanceTracer. */
+    struct ImpedanceTraceEvent
+    {
+        enum class Type : uint8_t
+        {
+            Propagation, /* the element recomputed its impedance, and (maybe) propagated the change to its parent */
+            Deferred, /* the propagation was stopped by a ScopedDeferImpedancePropagation */
+            DeferredCalc, /* the element recomputed its impedance when a ScopedDeferImpedancePropagation went out of scope */
+        };
+
+        Type type = Type::Propagation;
+        uint32_t depth = 0; /* the number of elements that the change has propagated through before reaching this element */
+        uint64_t propagationId = 0; /* all the events triggered by the same parameter change share an ID */
+        const BaseWDF* element = nullptr; /* the element that this event happened at */
+        const BaseWDF* source = nullptr; /* the element whose impedance change started the propagation */
+        int64_t startNs = 0; /* start time of the event (steady_clock) */
+        int64_t durationNs = 0; /* total duration, including the propagation to the ancestors of this element */
+        int64_t calcImpedanceNs = 0; /* time spent in calcImpedance() for this element */
+    };
+
+    /**
+     * Records impedance propagation events into a lock-free single-producer,
+     * single-consumer ring buffer, so that latency spikes while automating
+     * circuit parameters can be inspected offline.
+     *
+     * The tracer only records events when it is the active tracer and
+     * CHOWDSP_WDF_TRACING is enabled. Parameter changes should come from
+     * one thread at a time (typically the audio thread), while the events
+     * can be read from any other thread.
+     * ```cpp
+     * wdft::ImpedanceTracer tracer { 8192 };
+     * tracer.setElementName (circuit.pot1, "pot1");
+     * wdft::ImpedanceTracer::setActiveTracer (&tracer);
+     *
+     * // ... process and automate the circuit ...
+     *
+     * std::ofstream traceFile { "wdf_trace.json" };
+     * tracer.writeChromeTrace (traceFile); // open in chrome://tracing or https://ui.perfetto.dev
+     * ```
+     */
+    class ImpedanceTracer
     {
     public:
-        /** Creates a new WDF Resistor with a given resistance.
-         * @param value: resistance in Ohms
-         */
-        explicit ResistorT (T value) : R_value (value)
+        /** Creates a tracer which can hold at least the given number of (unread) events. */
+        explicit ImpedanceTracer (size_t minCapacity = 4096)
         {
-            calcImpedance();
+            size_t capacity = 2;
+            while (capacity < minCapacity)
+                capacity *= 2;
+            events.resize (capacity);
         }
 
-        /** Sets the resistance value of the WDF resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        ~ImpedanceTracer()
         {
-            if (all (newR == R_value))
-                return;
-
-            R_value = newR;
-            propagateImpedanceChange();
+            auto* self = this;
+            activeTracer().compare_exchange_strong (self, nullptr);
         }
 
-        /** Computes the impedance of the WDF resistor, Z_R = R. */
-        inline void calcImpedance() override
+        ImpedanceTracer (const ImpedanceTracer&) = delete;
+        ImpedanceTracer& operator= (const ImpedanceTracer&) = delete;
+
+        /** Sets the tracer that will record impedance propagation events (or nullptr to stop tracing). */
+        static void setActiveTracer (ImpedanceTracer* tracer) noexcept
         {
-            wdf.R = R_value;
-            wdf.G = (T) 1.0 / wdf.R;
+            activeTracer().store (tracer, std::memory_order_release);
         }
 
-        /** Accepts an incident wave into a WDF resistor. */
-        inline void incident (T x) noexcept
+        /** Returns the active tracer, or nullptr if tracing is not active. */
+        static ImpedanceTracer* getActiveTracer() noexcept
         {
-            wdf.a = x;
+            return activeTracer().load (std::memory_order_acquire);
         }
 
-        /** Propogates a reflected wave from a WDF resistor. */
-        inline T reflected() noexcept
+        /** Sets a name to use for an element in the exported trace (not real-time safe). */
+        void setElementName (const BaseWDF& element, std::string name)
         {
-            wdf.b = 0.0;
-            return wdf.b;
+            elementNames[&element] = std::move (name);
         }
 
-        WDFMembers<T> wdf;
+        /** Adds an event to the buffer. If the buffer is full, the event is dropped and false is returned. */
+        bool push (const ImpedanceTraceEvent& event) noexcept
+        {
+            const auto writeIndex = writePosition.load (std::memory_order_relaxed);
+            if (writeIndex - readPosition.load (std::memory_order_acquire) >= events.size())
+            {
+                numDroppedEvents.fetch_add (1, std::memory_order_relaxed);
+                return false;
+            }
 
-    private:
-        T R_value = (T) 1.0e-9;
-    };
+            events[writeIndex & (events.size() - 1)] = event;
+            writePosition.store (writeIndex + 1, std::memory_order_release);
+            return true;
+        }
 
-    /** WDF Capacitor Node */
-    template <typename T>
-    class CapacitorT final : public BaseWDF
-    {
-    public:
-        /** Creates a new WDF Capacitor.
-         * @param value: Capacitance value in Farads
-         * @param _fs: WDF sample rate
-         */
-        explicit CapacitorT (T value, T _fs = (T) 48000.0) : C_value (value),
-                                                             fs (_fs)
+        /** Reads the oldest event from the buffer. Returns false if there are no events to read. */
+        bool pop (ImpedanceTraceEvent& event) noexcept
         {
-            calcImpedance();
+            const auto readIndex = readPosition.load (std::memory_order_relaxed);
+            if (readIndex == writePosition.load (std::memory_order_acquire))
+                return false;
+
+            event = events[readIndex & (events.size() - 1)];
+            readPosition.store (readIndex + 1, std::memory_order_release);
+            return true;
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        /** Returns the number of events that were dropped because the buffer was full. */
+        uint64_t getNumDroppedEvents() const noexcept { return numDroppedEvents.load (std::memory_order_relaxed); }
+
+        /**
+         * Reads all the events from the buffer, and writes them out in the Chrome
+         * trace-event JSON format. Propagations are written as "complete" events,
+         * so the propagation through the ancestors of an element appears nested
+         * inside the element's event, and deferred propagations are written as
+         * instant events.
+         */
+        void writeChromeTrace (std::ostream& os)
         {
-            fs = sampleRate;
-            propagateImpedanceChange();
+            os << "{\"traceEvents\":[";
 
-            reset();
+            ImpedanceTraceEvent event;
+            bool isFirstEvent = true;
+            while (pop (event))
+            {
+                if (! isFirstEvent)
+                    os << ",";
+                isFirstEvent = false;
+
+                os << "\n{\"name\":\"" << getEventName (event) << "\",\"cat\":\"wdf\""
+                   << ",\"ph\":\"" << (event.type == ImpedanceTraceEvent::Type::Deferred ? "i\",\"s\":\"t" : "X")
+                   << "\",\"pid\":1,\"tid\":1,\"ts\":" << formatMicroseconds (event.startNs);
+
+                if (event.type != ImpedanceTraceEvent::Type::Deferred)
+                    os << ",\"dur\":" << formatMicroseconds (event.durationNs);
+
+                os << ",\"args\":{\"element\":\"" << escapeJson (getElementName (event.element))
+                   << "\",\"source\":\"" << escapeJson (getElementName (event.source))
+                   << "\",\"depth\":" << event.depth
+                   << ",\"propagation\":" << event.propagationId
+                   << ",\"calcImpedance_us\":" << formatMicroseconds (event.calcImpedanceNs)
+                   << "}}";
+            }
+
+            os << "\n],\"otherData\":{\"droppedEvents\":" << getNumDroppedEvents() << "}}\n";
         }
 
-        /** Resets the capacitor state */
-        void reset()
+    private:
+        static std::atomic<ImpedanceTracer*>& activeTracer() noexcept
         {
-            z = (T) 0.0;
+            static std::atomic<ImpedanceTracer*> tracer { nullptr };
+            return tracer;
         }
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
+        static const char* getEventName (const ImpedanceTraceEvent& event) noexcept
         {
-            if (all (newC == C_value))
-                return;
-
-            C_value = newC;
-            propagateImpedanceChange();
+            switch (event.type)
+            {
+                case ImpedanceTraceEvent::Type::Deferred:
+                    return "deferred";
+                case ImpedanceTraceEvent::Type::DeferredCalc:
+                    return "deferred calcImpedance";
+                case ImpedanceTraceEvent::Type::Propagation:
+                default:
+                    return "propagateImpedanceChange";
+            }
         }
 
-        /** Computes the impedance of the WDF capacitor,
-         *             1
-         * Z_C = --------------
-         *        2 * f_s * C
-         */
-        inline void calcImpedance() override
+        std::string getElementName (const BaseWDF* element) const
         {
-            wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
-            wdf.G = (T) 1.0 / wdf.R;
+            const auto nameIter = elementNames.find (element);
+            if (nameIter != elementNames.end())
+                return nameIter->second;
+
+            char pointerName[32];
+            std::snprintf (pointerName, sizeof (pointerName), "%p", (const void*) element);
+            return pointerName;
         }
 
-        /** Accepts an incident wave into a WDF capacitor. */
-        inline void incident (T x) noexcept
+        /** Escapes the characters that can't appear as-is in a JSON string */
+        static std::string escapeJson (const std::string& str)
         {
-            wdf.a = x;
-            z = wdf.a;
+            std::string escaped;
+            escaped.reserve (str.size());
+            for (auto c : str)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    escaped += '\\';
+                    escaped += c;
+                }
+                else if ((unsigned char) c < 0x20)
+                {
+                    char code[8];
+                    std::snprintf (code, sizeof (code), "\\u%04x", (unsigned) c);
+                    escaped += code;
+                }
+                else
+                {
+                    escaped += c;
+                }
+            }
+            return escaped;
         }
 
-        /** Propogates a reflected wave from a WDF capacitor. */
-        inline T reflected() noexcept
+        static std::string formatMicroseconds (int64_t ns)
         {
-            wdf.b = z;
-            return wdf.b;
+            char value[32];
+            std::snprintf (value, sizeof (value), "%.3f", (double) ns * 1.0e-3);
+            return value;
         }
 
-        WDFMembers<T> wdf;
-
-    private:
-        T C_value = (T) 1.0e-6;
-        T z = (T) 0.0;
+        std::vector<ImpedanceTraceEvent> events;
+        std::atomic<uint64_t> writePosition { 0 };
+        std::atomic<uint64_t> readPosition { 0 };
+        std::atomic<uint64_t> numDroppedEvents { 0 };
 
-        T fs;
+        std::unordered_map<const BaseWDF*, std::string> elementNames;
     };
 
-    /** WDF Capacitor Node with alpha transform parameter */
-    template <typename T>
-    class CapacitorAlphaT final : public BaseWDF
+#ifndef DOXYGEN
+    namespace trace_detail
     {
-    public:
-        /** Creates a new WDF Capacitor.
-         * @param value: Capacitance value in Farads
-         * @param fs: WDF sample rate
-         * @param alpha: alpha value to be used for the alpha transform,
-         *             use 0 for Backwards Euler, use 1 for Bilinear Transform.
-         */
-        explicit CapacitorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : C_value (value),
-                                                                                    fs (fs),
-                                                                                    alpha (alpha),
-                                                                                    b_coef (((T) 1.0 - alpha) / (T) 2.0),
-                                                                                    a_coef (((T) 1.0 + alpha) / (T) 2.0)
+        inline int64_t nowNs() noexcept
         {
-            calcImpedance();
+            return (int64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        /** Keeps track of the propagation that is currently running on this thread */
+        struct PropagationContext
         {
-            fs = sampleRate;
-            propagateImpedanceChange();
-
-            reset();
-        }
+            uint32_t depth = 0;
+            uint64_t nextPropagationId = 0;
+            const BaseWDF* source = nullptr;
+        };
 
-        /** Resets the capacitor state */
-        void reset()
+        inline PropagationContext& getPropagationContext() noexcept
         {
-            z = (T) 0.0;
+            static thread_local PropagationContext context;
+            return context;
         }
 
-        /** Sets a new alpha value to use for the alpha transform */
-        void setAlpha (T newAlpha)
+        /** Records a propagation event covering the lifetime of this object */
+        class PropagationScope
         {
-            alpha = newAlpha;
-            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
-            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
+        public:
+            explicit PropagationScope (const BaseWDF& element, ImpedanceTraceEvent::Type type = ImpedanceTraceEvent::Type::Propagation) noexcept
+                : tracer (ImpedanceTracer::getActiveTracer())
+            {
+                if (tracer == nullptr)
+                    return;
+
+                auto& context = getPropagationContext();
+                if (context.depth == 0)
+                {
+                    context.nextPropagationId++;
+                    context.source = &element;
+                }
+
+                event.type = type;
+                event.depth = context.depth++;
+                event.propagationId = context.nextPropagationId;
+                event.element = &element;
+                event.source = context.source;
+                event.startNs = nowNs();
+            }
 
-            propagateImpedanceChange();
-        }
+            ~PropagationScope() noexcept
+            {
+                if (tracer == nullptr)
+                    return;
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
-        {
-            if (all (newC == C_value))
-                return;
+                event.durationNs = nowNs() - event.startNs;
+                getPropagationContext().depth--;
+                tracer->push (event);
+            }
 
-            C_value = newC;
-            propagateImpedanceChange();
-        }
+            /** Call this once the element has finished computing its impedance */
+            void calcImpedanceDone() noexcept
+            {
+                if (tracer != nullptr)
+                    event.calcImpedanceNs = nowNs() - event.startNs;
+            }
 
-        /** Computes the impedance of the WDF capacitor,
-         *                 1
-         * Z_C = ---------------------
-         *       (1 + alpha) * f_s * C
-         */
-        inline void calcImpedance() override
-        {
-            wdf.R = (T) 1.0 / (((T) 1.0 + alpha) * C_value * fs);
-            wdf.G = (T) 1.0 / wdf.R;
-        }
+        private:
+            ImpedanceTracer* tracer;
+            ImpedanceTraceEvent event;
+        };
 
-        /** Accepts an incident wave into a WDF capacitor. */
-        inline void incident (T x) noexcept
+        /** Records that an impedance propagation was stopped at this element */
+        inline void recordDeferredPropagation (const BaseWDF& element) noexcept
         {
-            wdf.a = x;
-            z = wdf.a;
-        }
+            auto* tracer = ImpedanceTracer::getActiveTracer();
+            if (tracer == nullptr)
+                return;
 
-        /** Propogates a reflected wave from a WDF capacitor. */
-        inline T reflected() noexcept
-        {
-            wdf.b = b_coef * wdf.b + a_coef * z;
-            return wdf.b;
-        }
+            auto& context = getPropagationContext();
+            ImpedanceTraceEvent event;
+            event.type = ImpedanceTraceEvent::Type::Deferred;
+            event.depth = context.depth;
+            event.propagationId = context.depth == 0 ? ++context.nextPropagationId : context.nextPropagationId;
+            event.element = &element;
+            event.source = context.depth == 0 ? &element : context.source;
+            event.startNs = nowNs();
+            tracer->push (event);
+        }
+    } // namespace trace_detail
+#endif // DOXYGEN
+} // namespace wdft
+} // namespace chowdsp
 
-        WDFMembers<T> wdf;
+#if CHOWDSP_WDF_TRACING
+/** Traces an impedance propagation through the current WDF element, until the end of the current scope */
+#define CHOWDSP_WDF_TRACE_PROPAGATION() \
+    ::chowdsp::wdft::trace_detail::PropagationScope chowdsp_wdf_trace_scope { *this }
 
-    private:
-        T C_value = (T) 1.0e-6;
-        T z = (T) 0.0;
+/** Marks the end of the calcImpedance() call in the current traced propagation */
+#define CHOWDSP_WDF_TRACE_CALC_DONE() chowdsp_wdf_trace_scope.calcImpedanceDone()
 
-        T fs;
+/** Records that the impedance propagation was deferred at the current WDF element */
+#define CHOWDSP_WDF_TRACE_DEFERRED() ::chowdsp::wdft::trace_detail::recordDeferredPropagation (*this)
 
-        T alpha;
-        T b_coef;
-        T a_coef;
-    };
+/** Traces the deferred impedance calculation of the given WDF element, until the end of the current scope */
+#define CHOWDSP_WDF_TRACE_DEFERRED_CALC(element) \
+    ::chowdsp::wdft::trace_detail::PropagationScope chowdsp_wdf_trace_scope { element, ::chowdsp::wdft::ImpedanceTraceEvent::Type::DeferredCalc }
+#endif
 
-    /** WDF Inductor Node */
-    template <typename T>
-    class InductorT final : public BaseWDF
+#endif //CHOWDSP_WDF_IMPEDANCE_TRACE_H
+
+#else
+#define CHOWDSP_WDF_TRACE_PROPAGATION()
+#define CHOWDSP_WDF_TRACE_CALC_DONE()
+#define CHOWDSP_WDF_TRACE_DEFERRED()
+#define CHOWDSP_WDF_TRACE_DEFERRED_CALC(element)
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** Base WDF class for propagating impedance changes between elements */
+    class BaseWDF
     {
     public:
-        /** Creates a new WDF Inductor.
-         * @param value: Inductance value in Farads
-         * @param fs: WDF sample rate
-         */
-        explicit InductorT (T value, T fs = (T) 48000.0) : L_value (value),
-                                                           fs (fs)
-        {
-            calcImpedance();
-        }
+        virtual ~BaseWDF() = default;
 
-        /** Prepares the inductor to operate at a new sample rate */
-        void prepare (T sampleRate)
-        {
-            fs = sampleRate;
-            propagateImpedanceChange();
+        void connectToParent (BaseWDF* p) { parent = p; }
 
-            reset();
-        }
+        virtual void calcImpedance() = 0;
 
-        /** Resets the inductor state */
-        void reset()
+        inline virtual void propagateImpedanceChange()
         {
-            z = (T) 0.0;
-        }
+            if (dontPropagateImpedance)
+            {
+                CHOWDSP_WDF_TRACE_DEFERRED();
+                return; // the impedance propagation is being deferred until later...
+            }
 
-        /** Sets the inductance value of the WDF inductor, in Henries. */
-        void setInductanceValue (T newL)
-        {
-            if (all (newL == L_value))
-                return;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
+            calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
 
-            L_value = newL;
-            propagateImpedanceChange();
+            if (parent != nullptr)
+                parent->propagateImpedanceChange();
         }
 
-        /** Computes the impedance of the WDF inductor,
-         * Z_L = 2 * f_s * L
+        /**
+         * Calls fn for each port connected "below" this element in the WDF tree.
+         * Elements with connected ports (adaptors and root elements) hide this method.
          */
-        inline void calcImpedance() override
+        template <typename Fn>
+        void visitPorts (Fn&&)
         {
-            wdf.R = (T) 2.0 * L_value * fs;
-            wdf.G = (T) 1.0 / wdf.R;
         }
 
-        /** Accepts an incident wave into a WDF inductor. */
-        inline void incident (T x) noexcept
+        /**
+         * Calls visitor with a reference to each of this element's internal
+         * state variables (not including the wdf.a and wdf.b members).
+         * Elements with internal state hide this method.
+         */
+        template <typename Visitor>
+        void visitState (Visitor&&)
         {
-            wdf.a = x;
-            z = wdf.a;
         }
 
-        /** Propogates a reflected wave from a WDF inductor. */
-        inline T reflected() noexcept
-        {
-            wdf.b = -z;
-            return wdf.b;
-        }
+#if CHOWDSP_WDF_INSTRUMENTATION
+        /** Instrumentation counts for this element (see getInstrumentationCounters()). */
+        InstrumentationCounters instrumentationCounters;
+#endif
 
-        WDFMembers<T> wdf;
+    protected:
+        BaseWDF* parent = nullptr;
 
     private:
-        T L_value = (T) 1.0e-6;
-        T z = (T) 0.0;
+        bool dontPropagateImpedance = false;
 
-        T fs;
+        template <typename... Elements>
+        friend class ScopedDeferImpedancePropagation;
     };
 
-    /** WDF Inductor Node with alpha transform parameter */
-    template <typename T>
-    class InductorAlphaT final : public BaseWDF
+    /** Base class for propagating impedance changes into root WDF elements */
+    class RootWDF : public BaseWDF
     {
     public:
-        /** Creates a new WDF Inductor.
-         * @param value: Inductance value in Farads
-         * @param fs: WDF sample rate
-         * @param alpha: alpha value to be used for the alpha transform,
-         *               use 0 for Backwards Euler, use 1 for Bilinear Transform.
-         */
-        explicit InductorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : L_value (value),
-                                                                                   fs (fs),
-                                                                                   alpha (alpha),
-                                                                                   b_coef (((T) 1.0 - alpha) / (T) 2.0),
-                                                                                   a_coef (((T) 1.0 + alpha) / (T) 2.0)
+        inline void propagateImpedanceChange() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
             calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
         }
 
-        /** Prepares the inductor to operate at a new sample rate */
-        void prepare (T sampleRate)
-        {
-            fs = sampleRate;
-            propagateImpedanceChange();
+    private:
+        // don't try to connect root nodes!
+        void connectToParent (BaseWDF*) {}
+    };
 
-            reset();
-        }
+    /** Helper struct for common WDF member variables */
+    template <typename T>
+    struct WDFMembers
+    {
+        T R = (NumericType<T>) 1.0e-9; /* impedance */
+        T G = (T) 1.0 / R; /* admittance */
+        T a = (T) 0.0; /* incident wave */
+        T b = (T) 0.0; /* reflected wave */
+    };
 
-        /** Resets the inductor state */
-        void reset()
-        {
-            z = (T) 0.0;
-        }
+#ifndef DOXYGEN
+    namespace fixed_detail
+    {
+        template <typename...>
+        using void_t = void;
 
-        /** Sets a new alpha value to use for the alpha transform */
-        void setAlpha (T newAlpha)
+        /** True if the element's impedance is known at compile-time (see FixedResistorT). */
+        template <typename ElementType, typename = void>
+        struct HasFixedImpedance : std::false_type
         {
-            alpha = newAlpha;
-            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
-            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
-
-            propagateImpedanceChange();
-        }
+        };
 
-        /** Sets the inductance value of the WDF inductor, in Henries. */
-        void setInductanceValue (T newL)
+        template <typename ElementType>
+        struct HasFixedImpedance<ElementType, void_t<decltype (ElementType::getFixedImpedance())>> : std::true_type
         {
-            if (all (newL == L_value))
-                return;
-
-            L_value = newL;
-            propagateImpedanceChange();
-        }
+        };
 
-        /** Computes the impedance of the WDF inductor,
-         * Z_L = (1 + alpha) * f_s * L
+        /**
+         * Holds an adaptor coefficient, which is replaced by a compile-time constant
+         * when FixedValue::value() can be computed from fixed port impedances.
          */
-        inline void calcImpedance() override
+        template <typename T, typename FixedValue, bool isFixed = FixedValue::isFixed>
+        struct Coefficient
         {
-            wdf.R = ((T) 1.0 + alpha) * L_value * fs;
-            wdf.G = (T) 1.0 / wdf.R;
-        }
+            void set (T newValue) noexcept { value = newValue; }
+            T get() const noexcept { return value; }
 
-        /** Accepts an incident wave into a WDF inductor. */
-        inline void incident (T x) noexcept
-        {
-            wdf.a = x;
-            z = wdf.a;
-        }
+            T value = (T) 1.0;
+        };
 
-        /** Propogates a reflected wave from a WDF inductor. */
-        inline T reflected() noexcept
+        template <typename T, typename FixedValue>
+        struct Coefficient<T, FixedValue, true>
         {
-            wdf.b = b_coef * wdf.b - a_coef * z;
-            return wdf.b;
-        }
-
-        WDFMembers<T> wdf;
+            void set (T) noexcept {}
+            static T get() noexcept { return (T) FixedValue::value(); }
+        };
+    } // namespace fixed_detail
+#endif // DOXYGEN
 
-    private:
-        T L_value = (T) 1.0e-6;
-        T z = (T) 0.0;
+    /**
+     * Calls fn for the given element, and for every element below it in the WDF tree.
+     * Usually this will be called on the root of the tree, to visit the whole circuit.
+     */
+    template <typename ElementType, typename Fn>
+    void forEachElement (ElementType& element, Fn&& fn)
+    {
+        fn (element);
+        element.visitPorts ([&fn] (auto& port) { forEachElement (port, fn); });
+    }
 
-        T fs;
+    /**
+     * Returns the instrumentation counts for this element.
+     * If CHOWDSP_WDF_INSTRUMENTATION is disabled, the counts will always be zero.
+     */
+    inline InstrumentationCounters getInstrumentationCounters (const BaseWDF& element) noexcept
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION
+        return element.instrumentationCounters;
+#else
+        (void) element;
+        return {};
+#endif
+    }
 
-        T alpha;
-        T b_coef;
-        T a_coef;
-    };
+    /** Returns the sum of the instrumentation counts for every element in the circuit. */
+    template <typename RootType>
+    InstrumentationCounters getTotalInstrumentationCounters (RootType& root) noexcept
+    {
+        InstrumentationCounters total {};
+        forEachElement (root, [&total] (auto& element) { total += getInstrumentationCounters (element); });
+        return total;
+    }
 
-    /** WDF Resistor and Capacitor in Series */
-    template <typename T>
-    class ResistorCapacitorSeriesT final : public BaseWDF
+    /** Resets the instrumentation counts for every element in the circuit. */
+    template <typename RootType>
+    void resetInstrumentationCounters (RootType& root) noexcept
     {
-    public:
-        /** Creates a new WDF Resistor/Capacitor Series.
-         * @param cap_value: Resistance value in Ohms
-         * @param res_value: Capacitance value in Farads
-         * @param fs: WDF sample rate
-         */
-        explicit ResistorCapacitorSeriesT (T res_value, T cap_value, T fs = (T) 48000.0)
-            : R_value (res_value),
-              C_value (cap_value),
-              tt ((T) 1 / fs)
-        {
-            calcImpedance();
-        }
+#if CHOWDSP_WDF_INSTRUMENTATION
+        forEachElement (root, [] (auto& element) { element.instrumentationCounters = {}; });
+#else
+        (void) root;
+#endif
+    }
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
-        {
-            tt = (T) 1 / sampleRate;
-            propagateImpedanceChange();
+    /** Probe the voltage across this circuit element. */
+    template <typename T, typename WDFType>
+    inline T voltage (const WDFType& wdf) noexcept
+    {
+        return (wdf.wdf.a + wdf.wdf.b) * (T) 0.5;
+    }
 
-            reset();
-        }
+    /**Probe the current through this circuit element. */
+    template <typename T, typename WDFType>
+    inline T current (const WDFType& wdf) noexcept
+    {
+        return (wdf.wdf.a - wdf.wdf.b) * ((T) 0.5 * wdf.wdf.G);
+    }
+} // namespace wdft
+} // namespace chowdsp
 
-        /** Resets the capacitor state */
-        void reset()
+#endif // CHOWDSP_WDF_WDFT_BASE_H
+
+// #include "../math/compensated_float.h"
+#ifndef CHOWDSP_WDF_COMPENSATED_FLOAT_H
+#define CHOWDSP_WDF_COMPENSATED_FLOAT_H
+
+namespace chowdsp
+{
+/**
+ * A floating-point accumulator which tracks the rounding error of its running sum
+ * in a second "low" word (i.e. Kahan/TwoSum compensated summation). This gives
+ * close to double-word precision for state variables that integrate many small
+ * increments, while only using operations that are available for SIMD types.
+ *
+ * This type is intended to be used as the StateType for the WDF elements that
+ * support a mixed-precision state (e.g. `wdft::ResistorCapacitorSeriesT<float, CompensatedFloat<float>>`).
+ *
+ * Note that compensated arithmetic relies on strict IEEE semantics, so it will not work
+ * correctly if the code is compiled with `-ffast-math` or similar re-association flags.
+ */
+template <typename T>
+struct CompensatedFloat
+{
+    CompensatedFloat() = default;
+    explicit CompensatedFloat (T value) : hi (value) {}
+
+    /** Returns the value of the accumulator, rounded to the underlying type. */
+    explicit operator T() const noexcept { return hi + lo; }
+
+    CompensatedFloat& operator+= (T x) noexcept
+    {
+        T err;
+        const auto sum = twoSum (hi, x, err);
+        normalise (sum, lo + err);
+        return *this;
+    }
+
+    CompensatedFloat& operator-= (T x) noexcept
+    {
+        return *this += -x;
+    }
+
+    CompensatedFloat& operator+= (const CompensatedFloat& other) noexcept
+    {
+        T err;
+        const auto sum = twoSum (hi, other.hi, err);
+        normalise (sum, err + (lo + other.lo));
+        return *this;
+    }
+
+    CompensatedFloat& operator-= (const CompensatedFloat& other) noexcept
+    {
+        return *this += -other;
+    }
+
+    CompensatedFloat operator-() const noexcept
+    {
+        CompensatedFloat result;
+        result.hi = -hi;
+        result.lo = -lo;
+        return result;
+    }
+
+    /** Scales the accumulator by a (non-compensated) coefficient. */
+    friend inline CompensatedFloat operator* (T k, const CompensatedFloat& x) noexcept
+    {
+        CompensatedFloat result;
+        result.normalise (k * x.hi, k * x.lo);
+        return result;
+    }
+
+    friend inline CompensatedFloat operator+ (CompensatedFloat x, T y) noexcept { return x += y; }
+    friend inline CompensatedFloat operator+ (T x, CompensatedFloat y) noexcept { return y += x; }
+    friend inline CompensatedFloat operator- (CompensatedFloat x, T y) noexcept { return x -= y; }
+
+    T hi {}; /* high word (the rounded running value) */
+    T lo {}; /* low word (the accumulated rounding error) */
+
+private:
+    /** Error-free sum: returns fl(a + b) and stores the rounding error in err. */
+    static inline T twoSum (T a, T b, T& err) noexcept
+    {
+        const auto s = a + b;
+        const auto bb = s - a;
+        err = (a - (s - bb)) + (b - bb);
+        return s;
+    }
+
+    inline void normalise (T sum, T err) noexcept
+    {
+        hi = sum + err;
+        lo = err - (hi - sum);
+    }
+};
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_COMPENSATED_FLOAT_H
+
+// #include "../math/denormals.h"
+#ifndef CHOWDSP_WDF_DENORMALS_H
+#define CHOWDSP_WDF_DENORMALS_H
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+// #include "compensated_float.h"
+
+
+/**
+ * If CHOWDSP_WDF_FLUSH_DENORMALS is enabled, the reactive WDF elements will
+ * flush their internal states to zero whenever those states become denormal.
+ * This costs a compare and select per state write, but protects against
+ * denormal CPU spikes even when the caller has not set the FTZ/DAZ flags.
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_FLUSH_DENORMALS
+#define CHOWDSP_WDF_FLUSH_DENORMALS 0
+#endif
+
+namespace chowdsp
+{
+/** Methods for dealing with denormal numbers */
+namespace denormals
+{
+    /** Returns zero if the input is denormal, otherwise returns the input. */
+    template <typename T>
+    inline typename std::enable_if<std::is_floating_point<T>::value, T>::type
+        flush (T x) noexcept
+    {
+        return std::abs (x) < std::numeric_limits<T>::min() ? (T) 0 : x;
+    }
+
+#if defined(XSIMD_HPP)
+    /** Returns zero for any denormal elements of the input. */
+    template <typename T>
+    inline xsimd::batch<T> flush (xsimd::batch<T> x) noexcept
+    {
+        using v_type = xsimd::batch<T>;
+        return xsimd::select (xsimd::abs (x) < v_type (std::numeric_limits<T>::min()), v_type ((T) 0), x);
+    }
+#endif
+
+    /** Flushes both words of a compensated accumulator. */
+    template <typename T>
+    inline CompensatedFloat<T> flush (CompensatedFloat<T> x) noexcept
+    {
+        x.hi = flush (x.hi);
+        x.lo = flush (x.lo);
+        return x;
+    }
+
+    /**
+     * Used by the WDF elements when writing their internal state.
+     * Flushes denormals if CHOWDSP_WDF_FLUSH_DENORMALS is enabled, otherwise does nothing.
+     */
+    template <typename T>
+    inline T flushState (T x) noexcept
+    {
+#if CHOWDSP_WDF_FLUSH_DENORMALS
+        return flush (x);
+#else
+        return x;
+#endif
+    }
+} // namespace denormals
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_DENORMALS_H
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** WDF Resistor Node */
+    template <typename T>
+    class ResistorT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor with a given resistance.
+         * @param value: resistance in Ohms
+         */
+        explicit ResistorT (T value) : R_value (value)
         {
-            z = (T) 0.0;
-            wdf.a = (T) 0;
-            wdf.b = (T) 0;
+            calcImpedance();
         }
 
         /** Sets the resistance value of the WDF resistor, in Ohms. */
@@ -594,65 +1019,102 @@ namespace wdft
             propagateImpedanceChange();
         }
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
-        {
-            if (all (newC == C_value))
-                return;
-
-            C_value = newC;
-            propagateImpedanceChange();
-        }
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
 
-        /** Computes the impedance of the WDF resistor/capacitor combination */
+        /** Computes the impedance of the WDF resistor, Z_R = R. */
         inline void calcImpedance() override
         {
-            wdf.R = tt / ((T) 2.0 * C_value) + R_value;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = R_value;
             wdf.G = (T) 1.0 / wdf.R;
-            T_over_T_plus_2RC = tt / ((T) 2 * C_value * R_value + tt);
         }
 
-        /** Accepts an incident wave into the WDF. */
+        /** Accepts an incident wave into a WDF resistor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z -= T_over_T_plus_2RC * (wdf.a + z);
         }
 
-        /** Propogates a reflected wave from the WDF. */
+        /** Propogates a reflected wave from a WDF resistor. */
         inline T reflected() noexcept
         {
-            wdf.b = -z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = 0.0;
             return wdf.b;
         }
 
         WDFMembers<T> wdf;
 
     private:
-        T R_value = (T) 1.0e3;
-        T C_value = (T) 1.0e-6;
+        T R_value = (T) 1.0e-9;
+    };
 
-        T T_over_T_plus_2RC = (T) 0.0;
+    /**
+     * WDF Resistor Node, with a resistance that is fixed at compile-time.
+     *
+     * The resistance is given in Ohms as a std::ratio, e.g. FixedResistorT<float, std::ratio<4700>>
+     * or FixedResistorT<float, std::ratio<22, 10>> for 2.2 Ohms. When both ports of a WDFSeriesT or
+     * WDFParallelT adaptor have fixed impedances, the adaptor's reflection coefficient becomes a
+     * compile-time constant, and the adaptor's impedance is fixed as well, so whole sub-trees of
+     * fixed resistors fold into constants.
+     */
+    template <typename T, typename ResistanceRatio>
+    class FixedResistorT final : public BaseWDF
+    {
+    public:
+        FixedResistorT()
+        {
+            calcImpedance();
+        }
 
-        T z = (T) 0.0;
+        /** Returns the resistance value, in Ohms, at compile-time. */
+        static constexpr double getFixedImpedance() noexcept
+        {
+            return (double) ResistanceRatio::num / (double) ResistanceRatio::den;
+        }
 
-        T tt;
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return (T) getFixedImpedance(); }
+
+        /** Computes the impedance of the WDF resistor, Z_R = R. */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) getFixedImpedance();
+            wdf.G = (T) (1.0 / getFixedImpedance());
+        }
+
+        /** Accepts an incident wave into a WDF resistor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF resistor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = 0.0;
+            return wdf.b;
+        }
+
+        WDFMembers<T> wdf;
     };
 
-    /** WDF Resistor and Capacitor in parallel */
+    /** WDF Capacitor Node */
     template <typename T>
-    class ResistorCapacitorParallelT final : public BaseWDF
+    class CapacitorT final : public BaseWDF
     {
     public:
-        /** Creates a new WDF Resistor/Capacitor Parallel.
-         * @param res_value: Resistance value in Ohms
-         * @param cap_value: Capacitance value in Farads
-         * @param fs: WDF sample rate
+        /** Creates a new WDF Capacitor.
+         * @param value: Capacitance value in Farads
+         * @param _fs: WDF sample rate
          */
-        explicit ResistorCapacitorParallelT (T res_value, T cap_value, T fs = (T) 48000.0)
-            : R_value (res_value),
-              C_value (cap_value),
-              tt ((T) 1 / fs)
+        explicit CapacitorT (T value, T _fs = (T) 48000.0) : C_value (value),
+                                                             fs (_fs)
         {
             calcImpedance();
         }
@@ -660,7 +1122,7 @@ namespace wdft
         /** Prepares the capacitor to operate at a new sample rate */
         void prepare (T sampleRate)
         {
-            tt = (T) 1 / sampleRate;
+            fs = sampleRate;
             propagateImpedanceChange();
 
             reset();
@@ -670,18 +1132,6 @@ namespace wdft
         void reset()
         {
             z = (T) 0.0;
-            wdf.a = (T) 0;
-            wdf.b = (T) 0;
-        }
-
-        /** Sets the resistance value of the WDF resistor, in Ohms. */
-        void setResistanceValue (T newR)
-        {
-            if (all (newR == R_value))
-                return;
-
-            R_value = newR;
-            propagateImpedanceChange();
         }
 
         /** Sets the capacitance value of the WDF capacitor, in Farads. */
@@ -694,164 +1144,175 @@ namespace wdft
             propagateImpedanceChange();
         }
 
-        /** Computes the impedance of the WDF resistor/capacitor combination */
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return fs; }
+
+        /** Computes the impedance of the WDF capacitor,
+         *             1
+         * Z_C = --------------
+         *        2 * f_s * C
+         */
         inline void calcImpedance() override
         {
-            const auto twoRC = (T) 2.0 * C_value * R_value;
-            wdf.R = R_value * tt / (twoRC + tt);
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
             wdf.G = (T) 1.0 / wdf.R;
-            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
         }
 
-        /** Accepts an incident wave into the WDF. */
+        /** Accepts an incident wave into a WDF capacitor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.b + wdf.a - z;
+            z = denormals::flushState (wdf.a);
         }
 
-        /** Propogates a reflected wave from the WDF. */
+        /** Propogates a reflected wave from a WDF capacitor. */
         inline T reflected() noexcept
         {
-            wdf.b = twoRC_over_twoRC_plus_T * z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = z;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        T R_value = (T) 1.0e3;
         T C_value = (T) 1.0e-6;
-
-        T twoRC_over_twoRC_plus_T = (T) 0.0;
-
         T z = (T) 0.0;
 
-        T tt;
+        T fs;
     };
-} // namespace wdft
-} // namespace chowdsp
-
-#endif //CHOWDSP_WDF_WDFT_ONE_PORTS_H
-
-// #include "wdft_sources.h"
-#ifndef CHOWDSP_WDF_WDFT_SOURCES_H
-#define CHOWDSP_WDF_WDFT_SOURCES_H
-
-// #include "wdft_base.h"
 
-
-namespace chowdsp
-{
-namespace wdft
-{
-    /** WDF Ideal Voltage source (non-adaptable) */
-    template <typename T, typename Next>
-    class IdealVoltageSourceT final : public RootWDF
+    /** WDF Capacitor Node with alpha transform parameter */
+    template <typename T>
+    class CapacitorAlphaT final : public BaseWDF
     {
     public:
-        explicit IdealVoltageSourceT (Next& next)
-        {
-            next.connectToParent (this);
-            calcImpedance();
-        }
-
-        void calcImpedance() override {}
-
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV) { Vs = newV; }
-
-        /** Accepts an incident wave into a WDF ideal voltage source. */
-        inline void incident (T x) noexcept
+        /** Creates a new WDF Capacitor.
+         * @param value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         * @param alpha: alpha value to be used for the alpha transform,
+         *             use 0 for Backwards Euler, use 1 for Bilinear Transform.
+         */
+        explicit CapacitorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : C_value (value),
+                                                                                    fs (fs),
+                                                                                    alpha (alpha),
+                                                                                    b_coef (((T) 1.0 - alpha) / (T) 2.0),
+                                                                                    a_coef (((T) 1.0 + alpha) / (T) 2.0)
         {
-            wdf.a = x;
+            calcImpedance();
         }
 
-        /** Propogates a reflected wave from a WDF ideal voltage source. */
-        inline T reflected() noexcept
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
         {
-            wdf.b = -wdf.a + (T) 2.0 * Vs;
-            return wdf.b;
-        }
+            fs = sampleRate;
+            propagateImpedanceChange();
 
-        WDFMembers<T> wdf;
+            reset();
+        }
 
-    private:
-        T Vs = (T) 0.0;
-    };
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+        }
 
-    /** WDF Voltage source with series resistance */
-    template <typename T>
-    class ResistiveVoltageSourceT final : public BaseWDF
-    {
-    public:
-        /** Creates a new resistive voltage source.
-         * @param value: initial resistance value, in Ohms
-         */
-        explicit ResistiveVoltageSourceT (T value = NumericType<T> (1.0e-9)) : R_value (value)
+        /** Sets a new alpha value to use for the alpha transform */
+        void setAlpha (T newAlpha)
         {
-            calcImpedance();
+            alpha = newAlpha;
+            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
+            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
+
+            propagateImpedanceChange();
         }
 
-        /** Sets the resistance value of the series resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
         {
-            if (all (newR == R_value))
+            if (all (newC == C_value))
                 return;
 
-            R_value = newR;
+            C_value = newC;
             propagateImpedanceChange();
         }
 
-        /** Computes the impedance for a WDF resistive voltage souce
-         * Z_Vr = Z_R
+        /** Computes the impedance of the WDF capacitor,
+         *                 1
+         * Z_C = ---------------------
+         *       (1 + alpha) * f_s * C
          */
         inline void calcImpedance() override
         {
-            wdf.R = R_value;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) 1.0 / (((T) 1.0 + alpha) * C_value * fs);
             wdf.G = (T) 1.0 / wdf.R;
         }
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV) { Vs = newV; }
-
-        /** Accepts an incident wave into a WDF resistive voltage source. */
+        /** Accepts an incident wave into a WDF capacitor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
+            z = denormals::flushState (wdf.a);
         }
 
-        /** Propogates a reflected wave from a WDF resistive voltage source. */
+        /** Propogates a reflected wave from a WDF capacitor. */
         inline T reflected() noexcept
         {
-            wdf.b = Vs;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = denormals::flushState (b_coef * wdf.b + a_coef * z);
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        T Vs = (T) 0.0;
-        T R_value = (T) 1.0e-9;
+        T C_value = (T) 1.0e-6;
+        T z = (T) 0.0;
+
+        T fs;
+
+        T alpha;
+        T b_coef;
+        T a_coef;
     };
 
-    /** WDF Voltage source with series capacitance */
+    /** WDF Inductor Node */
     template <typename T>
-    class CapacitiveVoltageSourceT final : public BaseWDF
+    class InductorT final : public BaseWDF
     {
     public:
-        /** Creates a new resistive voltage source.
-         * @param value: initial resistance value, in Ohms
+        /** Creates a new WDF Inductor.
+         * @param value: Inductance value in Farads
+         * @param fs: WDF sample rate
          */
-        explicit CapacitiveVoltageSourceT (T value = NumericType<T> (1.0e-6), T fs = (T) 48000)
-            : C_value (value),
-              fs (fs)
-
+        explicit InductorT (T value, T fs = (T) 48000.0) : L_value (value),
+                                                           fs (fs)
         {
             calcImpedance();
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
+        /** Prepares the inductor to operate at a new sample rate */
         void prepare (T sampleRate)
         {
             fs = sampleRate;
@@ -860,171 +1321,181 @@ namespace wdft
             reset();
         }
 
+        /** Resets the inductor state */
         void reset()
         {
-            z = (T) 0;
-            v_1 = (T) 0;
+            z = (T) 0.0;
         }
 
-        /** Sets the capacitance value of the series resistor, in Farads. */
-        void setCapacitanceValue (T newC)
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
         {
-            if (all (newC == C_value))
+            if (all (newL == L_value))
                 return;
 
-            C_value = newC;
+            L_value = newL;
             propagateImpedanceChange();
         }
 
-        /** Computes the impedance of the WDF capacitor,
-         *             1
-         * Z_C = --------------
-         *        2 * f_s * C
+        /** Returns the inductance value, in Henries. */
+        T getInductanceValue() const noexcept { return L_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return fs; }
+
+        /** Computes the impedance of the WDF inductor,
+         * Z_L = 2 * f_s * L
          */
         inline void calcImpedance() override
         {
-            wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) 2.0 * L_value * fs;
             wdf.G = (T) 1.0 / wdf.R;
         }
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV)
-        {
-            v_0 = newV;
-        }
-
-        /** Accepts an incident wave into a WDF resistive voltage source. */
+        /** Accepts an incident wave into a WDF inductor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.a;
+            z = denormals::flushState (wdf.a);
         }
 
-        /** Propogates a reflected wave from a WDF resistive voltage source. */
+        /** Propogates a reflected wave from a WDF inductor. */
         inline T reflected() noexcept
         {
-            wdf.b = z + v_0 - v_1;
-            v_1 = v_0;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -z;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        T C_value = (T) 1.0e-6;
-
-        T z {};
-        T v_0 {};
-        T v_1 {};
+        T L_value = (T) 1.0e-6;
+        T z = (T) 0.0;
 
         T fs;
     };
 
-    /** WDF Current source (non-adaptable) */
-    template <typename T, typename Next>
-    class IdealCurrentSourceT final : public RootWDF
+    /** WDF Inductor Node with alpha transform parameter */
+    template <typename T>
+    class InductorAlphaT final : public BaseWDF
     {
     public:
-        explicit IdealCurrentSourceT (Next& n) : next (n)
+        /** Creates a new WDF Inductor.
+         * @param value: Inductance value in Farads
+         * @param fs: WDF sample rate
+         * @param alpha: alpha value to be used for the alpha transform,
+         *               use 0 for Backwards Euler, use 1 for Bilinear Transform.
+         */
+        explicit InductorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : L_value (value),
+                                                                                   fs (fs),
+                                                                                   alpha (alpha),
+                                                                                   b_coef (((T) 1.0 - alpha) / (T) 2.0),
+                                                                                   a_coef (((T) 1.0 + alpha) / (T) 2.0)
         {
-            n.connectToParent (this);
             calcImpedance();
         }
 
-        inline void calcImpedance() override
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
         {
-            twoR = (T) 2.0 * next.wdf.R;
-            twoR_Is = twoR * Is;
-        }
+            fs = sampleRate;
+            propagateImpedanceChange();
 
-        /** Sets the current of the current source, in Amps */
-        void setCurrent (T newI)
-        {
-            Is = newI;
-            twoR_Is = twoR * Is;
+            reset();
         }
 
-        /** Accepts an incident wave into a WDF ideal current source. */
-        inline void incident (T x) noexcept
+        /** Resets the inductor state */
+        void reset()
         {
-            wdf.a = x;
+            z = (T) 0.0;
         }
 
-        /** Propogates a reflected wave from a WDF ideal current source. */
-        inline T reflected() noexcept
+        /** Sets a new alpha value to use for the alpha transform */
+        void setAlpha (T newAlpha)
         {
-            wdf.b = twoR_Is + wdf.a;
-            return wdf.b;
-        }
-
-        WDFMembers<T> wdf;
-
-    private:
-        const Next& next;
-
-        T Is = (T) 0.0;
-        T twoR;
-        T twoR_Is;
-    };
+            alpha = newAlpha;
+            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
+            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
 
-    /** WDF Current source with parallel resistance */
-    template <typename T>
-    class ResistiveCurrentSourceT final : public BaseWDF
-    {
-    public:
-        /** Creates a new resistive current source.
-         * @param value: initial resistance value, in Ohms
-         */
-        explicit ResistiveCurrentSourceT (T value = NumericType<T> (1.0e9)) : R_value (value)
-        {
-            calcImpedance();
+            propagateImpedanceChange();
         }
 
-        /** Sets the resistance value of the parallel resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
         {
-            if (all (newR == R_value))
+            if (all (newL == L_value))
                 return;
 
-            R_value = newR;
+            L_value = newL;
             propagateImpedanceChange();
         }
 
-        /** Computes the impedance for a WDF resistive current souce
-         * Z_Ir = Z_R
+        /** Computes the impedance of the WDF inductor,
+         * Z_L = (1 + alpha) * f_s * L
          */
         inline void calcImpedance() override
         {
-            wdf.R = R_value;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = ((T) 1.0 + alpha) * L_value * fs;
             wdf.G = (T) 1.0 / wdf.R;
         }
 
-        /** Sets the current of the current source, in Amps */
-        void setCurrent (T newI) { Is = newI; }
-
-        /** Accepts an incident wave into a WDF resistive current source. */
+        /** Accepts an incident wave into a WDF inductor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
+            z = denormals::flushState (wdf.a);
         }
 
-        /** Propogates a reflected wave from a WDF resistive current source. */
+        /** Propogates a reflected wave from a WDF inductor. */
         inline T reflected() noexcept
         {
-            wdf.b = wdf.R * Is;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = denormals::flushState (b_coef * wdf.b - a_coef * z);
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        T Is = (T) 0.0;
-        T R_value = (T) 1.0e9;
+        T L_value = (T) 1.0e-6;
+        T z = (T) 0.0;
+
+        T fs;
+
+        T alpha;
+        T b_coef;
+        T a_coef;
     };
 
-    /** WDF Resistor and Capacitor and Voltage source in Series */
-    template <typename T>
-    class ResistiveCapacitiveVoltageSourceT final : public BaseWDF
+    /**
+     * WDF Resistor and Capacitor in Series
+     *
+     * For low cutoff frequencies, the capacitor state integrates very small increments,
+     * so the StateType argument may be used to store the state at a higher precision
+     * than the waves and coefficients, e.g. `ResistorCapacitorSeriesT<float, double>`,
+     * or `ResistorCapacitorSeriesT<xsimd::batch<float>, CompensatedFloat<xsimd::batch<float>>>`.
+     */
+    template <typename T, typename StateType = T>
+    class ResistorCapacitorSeriesT final : public BaseWDF
     {
     public:
         /** Creates a new WDF Resistor/Capacitor Series.
@@ -1032,13 +1503,12 @@ namespace wdft
          * @param res_value: Capacitance value in Farads
          * @param fs: WDF sample rate
          */
-        explicit ResistiveCapacitiveVoltageSourceT (T res_value, T cap_value, T fs = (T) 48000.0)
+        explicit ResistorCapacitorSeriesT (T res_value, T cap_value, T fs = (T) 48000.0)
             : R_value (res_value),
               C_value (cap_value),
               tt ((T) 1 / fs)
         {
             calcImpedance();
-            reset();
         }
 
         /** Prepares the capacitor to operate at a new sample rate */
@@ -1053,7 +1523,9 @@ namespace wdft
         /** Resets the capacitor state */
         void reset()
         {
-            z = 0.0f;
+            z = StateType {};
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
         }
 
         /** Sets the resistance value of the WDF resistor, in Ohms. */
@@ -1076,1085 +1548,909 @@ namespace wdft
             propagateImpedanceChange();
         }
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV) { Vs = newV; }
-
         /** Computes the impedance of the WDF resistor/capacitor combination */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = tt / ((T) 2.0 * C_value) + R_value;
             wdf.G = (T) 1.0 / wdf.R;
-            T_over_2RC = tt / ((T) 2 * C_value * R_value);
+            T_over_T_plus_2RC = tt / ((T) 2 * C_value * R_value + tt);
         }
 
         /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z -= T_over_2RC * (wdf.a - wdf.b);
+            z -= T_over_T_plus_2RC * (wdf.a + z);
+            z = denormals::flushState (z);
         }
 
         /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            wdf.b = -(z + Vs);
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -(T) z;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        T Vs = (T) 0.0;
         T R_value = (T) 1.0e3;
         T C_value = (T) 1.0e-6;
 
-        T T_over_2RC = (T) 0.0;
+        T T_over_T_plus_2RC = (T) 0.0;
 
-        T z = (T) 0.0;
+        StateType z {};
 
         T tt;
     };
-} // namespace wdft
-} // namespace chowdsp
-
-#endif //CHOWDSP_WDF_WDFT_SOURCES_H
-
-// #include "wdft_adaptors.h"
-#ifndef CHOWDSP_WDF_WDFT_ADAPTORS_H
-#define CHOWDSP_WDF_WDFT_ADAPTORS_H
-
-// #include "wdft_base.h"
-
 
-namespace chowdsp
-{
-namespace wdft
-{
-    /** WDF 3-port parallel adaptor */
-    template <typename T, typename Port1Type, typename Port2Type>
-    class WDFParallelT final : public BaseWDF
+    /** WDF Resistor and Capacitor in parallel */
+    template <typename T>
+    class ResistorCapacitorParallelT final : public BaseWDF
     {
     public:
-        /** Creates a new WDF parallel adaptor from two connected ports. */
-        WDFParallelT (Port1Type& p1, Port2Type& p2) : port1 (p1),
-                                                      port2 (p2)
+        /** Creates a new WDF Resistor/Capacitor Parallel.
+         * @param res_value: Resistance value in Ohms
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorCapacitorParallelT (T res_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
         {
-            port1.connectToParent (this);
-            port2.connectToParent (this);
             calcImpedance();
         }
 
-        /** Computes the impedance for a WDF parallel adaptor.
-         *  1     1     1
-         * --- = --- + ---
-         * Z_p   Z_1   Z_2
-         */
-        inline void calcImpedance() override
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
         {
-            wdf.G = port1.wdf.G + port2.wdf.G;
-            wdf.R = (T) 1.0 / wdf.G;
-            port1Reflect = port1.wdf.G / wdf.G;
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
         }
 
-        /** Accepts an incident wave into a WDF parallel adaptor. */
-        inline void incident (T x) noexcept
+        /** Resets the capacitor state */
+        void reset()
         {
-            const auto b2 = wdf.b - port2.wdf.b + x;
-            port1.incident (b2 + bDiff);
-            port2.incident (b2);
-
-            wdf.a = x;
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
         }
 
-        /** Propogates a reflected wave from a WDF parallel adaptor. */
-        inline T reflected() noexcept
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
         {
-            port1.reflected();
-            port2.reflected();
-
-            bDiff = port2.wdf.b - port1.wdf.b;
-            wdf.b = port2.wdf.b - port1Reflect * bDiff;
+            if (all (newR == R_value))
+                return;
 
-            return wdf.b;
+            R_value = newR;
+            propagateImpedanceChange();
         }
 
-        Port1Type& port1;
-        Port2Type& port2;
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
 
-        WDFMembers<T> wdf;
+            C_value = newC;
+            propagateImpedanceChange();
+        }
 
-    private:
-        T port1Reflect = (T) 1.0;
-        T bDiff = (T) 0.0;
-    };
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
 
-    /** WDF 3-port series adaptor */
-    template <typename T, typename Port1Type, typename Port2Type>
-    class WDFSeriesT final : public BaseWDF
-    {
-    public:
-        /** Creates a new WDF series adaptor from two connected ports. */
-        WDFSeriesT (Port1Type& p1, Port2Type& p2) : port1 (p1),
-                                                    port2 (p2)
-        {
-            port1.connectToParent (this);
-            port2.connectToParent (this);
-            calcImpedance();
-        }
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
 
-        /** Computes the impedance for a WDF parallel adaptor.
-         * Z_s = Z_1 + Z_2
-         */
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return (T) 1 / tt; }
+
+        /** Computes the impedance of the WDF resistor/capacitor combination */
         inline void calcImpedance() override
         {
-            wdf.R = port1.wdf.R + port2.wdf.R;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoRC = (T) 2.0 * C_value * R_value;
+            wdf.R = R_value * tt / (twoRC + tt);
             wdf.G = (T) 1.0 / wdf.R;
-            port1Reflect = port1.wdf.R / wdf.R;
+            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
         }
 
-        /** Accepts an incident wave into a WDF series adaptor. */
+        /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
-            const auto b1 = port1.wdf.b - port1Reflect * (x + port1.wdf.b + port2.wdf.b);
-            port1.incident (b1);
-            port2.incident (-(x + b1));
-
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
+            z = denormals::flushState (wdf.b + wdf.a - z);
         }
 
-        /** Propogates a reflected wave from a WDF series adaptor. */
+        /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            wdf.b = -(port1.reflected() + port2.reflected());
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = twoRC_over_twoRC_plus_T * z;
             return wdf.b;
         }
 
-        Port1Type& port1;
-        Port2Type& port2;
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
 
         WDFMembers<T> wdf;
 
     private:
-        T port1Reflect = (T) 1.0;
+        T R_value = (T) 1.0e3;
+        T C_value = (T) 1.0e-6;
+
+        T twoRC_over_twoRC_plus_T = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
     };
 
-    /** WDF Voltage Polarity Inverter */
-    template <typename T, typename PortType>
-    class PolarityInverterT final : public BaseWDF
+    /** WDF Resistor and Inductor in Series */
+    template <typename T>
+    class ResistorInductorSeriesT final : public BaseWDF
     {
     public:
-        /** Creates a new WDF polarity inverter */
-        explicit PolarityInverterT (PortType& p) : port1 (p)
+        /** Creates a new WDF Resistor/Inductor Series.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorInductorSeriesT (T res_value, T ind_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              tt ((T) 1 / fs)
         {
-            port1.connectToParent (this);
             calcImpedance();
         }
 
-        /** Calculates the impedance of the WDF inverter
-         * (same impedance as the connected node).
-         */
-        inline void calcImpedance() override
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
         {
-            wdf.R = port1.wdf.R;
-            wdf.G = (T) 1.0 / wdf.R;
-        }
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
 
-        /** Accepts an incident wave into a WDF inverter. */
-        inline void incident (T x) noexcept
-        {
-            wdf.a = x;
-            port1.incident (-x);
+            reset();
         }
 
-        /** Propogates a reflected wave from a WDF inverter. */
-        inline T reflected() noexcept
+        /** Resets the inductor state */
+        void reset()
         {
-            wdf.b = -port1.reflected();
-            return wdf.b;
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
         }
 
-        WDFMembers<T> wdf;
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
 
-    private:
-        PortType& port1;
-    };
+            R_value = newR;
+            propagateImpedanceChange();
+        }
 
-    /** WDF y-parameter 2-port (short circuit admittance) */
-    template <typename T, typename PortType>
-    class YParameterT final : public BaseWDF
-    {
-    public:
-        /** Creates a new WDF Y-Parameter, with the given coefficients */
-        YParameterT (PortType& port1, T y11, T y12, T y21, T y22) : port1 (port1)
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
         {
-            y[0][0] = y11;
-            y[0][1] = y12;
-            y[1][0] = y21;
-            y[1][1] = y22;
+            if (all (newL == L_value))
+                return;
 
-            port1.connectToParent (this);
-            calcImpedance();
+            L_value = newL;
+            propagateImpedanceChange();
         }
 
-        /** Calculates the impedance of the WDF Y-Parameter */
+        /** Computes the impedance of the WDF resistor/inductor combination */
         inline void calcImpedance() override
         {
-            denominator = y[1][1] + port1.wdf.R * y[0][0] * y[1][1] - port1.wdf.R * y[0][1] * y[1][0];
-            wdf.R = (port1.wdf.R * y[0][0] + (T) 1.0) / denominator;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoL = (T) 2.0 * L_value;
+            wdf.R = twoL / tt + R_value;
             wdf.G = (T) 1.0 / wdf.R;
-
-            T rSq = port1.wdf.R * port1.wdf.R;
-            T num1A = -y[1][1] * rSq * y[0][0] * y[0][0];
-            T num2A = y[0][1] * y[1][0] * rSq * y[0][0];
-
-            A = (num1A + num2A + y[1][1]) / (denominator * (port1.wdf.R * y[0][0] + (T) 1.0));
-            B = -port1.wdf.R * y[0][1] / (port1.wdf.R * y[0][0] + (T) 1.0);
-            C = -y[1][0] / denominator;
+            twoL_over_twoL_plus_RT = twoL / (twoL + R_value * tt);
         }
 
-        /** Accepts an incident wave into a WDF Y-Parameter. */
+        /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            port1.incident (A * port1.wdf.b + B * x);
+            z = denormals::flushState (twoL_over_twoL_plus_RT * (z - wdf.a) - z);
         }
 
-        /** Propogates a reflected wave from a WDF Y-Parameter. */
+        /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            wdf.b = C * port1.reflected();
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = z;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        PortType& port1;
-        T y[2][2] = { { (T) 0.0, (T) 0.0 }, { (T) 0.0, (T) 0.0 } };
+        T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
 
-        T denominator = (T) 1.0;
-        T A = (T) 1.0;
-        T B = (T) 1.0;
-        T C = (T) 1.0;
-    };
+        T twoL_over_twoL_plus_RT = (T) 0.0;
 
-    // useful "factory" functions so you don't have to declare all the template parameters
+        T z = (T) 0.0;
 
-    /** Factory method for creating a parallel adaptor between two elements. */
-    template <typename T, typename P1Type, typename P2Type>
-    CHOWDSP_WDF_MAYBE_UNUSED WDFParallelT<T, P1Type, P2Type> makeParallel (P1Type& p1, P2Type& p2)
-    {
-        return WDFParallelT<T, P1Type, P2Type> (p1, p2);
-    }
+        T tt;
+    };
 
-    /** Factory method for creating a series adaptor between two elements. */
-    template <typename T, typename P1Type, typename P2Type>
-    CHOWDSP_WDF_MAYBE_UNUSED WDFSeriesT<T, P1Type, P2Type> makeSeries (P1Type& p1, P2Type& p2)
+    /** WDF Resistor and Inductor in parallel */
+    template <typename T>
+    class ResistorInductorParallelT final : public BaseWDF
     {
-        return WDFSeriesT<T, P1Type, P2Type> (p1, p2);
-    }
+    public:
+        /** Creates a new WDF Resistor/Inductor Parallel.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorInductorParallelT (T res_value, T ind_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
 
-    /** Factory method for creating a polarity inverter. */
-    template <typename T, typename PType>
-    CHOWDSP_WDF_MAYBE_UNUSED PolarityInverterT<T, PType> makeInverter (PType& p1)
-    {
-        return PolarityInverterT<T, PType> (p1);
-    }
-} // namespace wdft
-} // namespace chowdsp
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
 
-#endif //CHOWDSP_WDF_WDFT_ADAPTORS_H
+            reset();
+        }
 
-// #include "wdft_nonlinearities.h"
-#ifndef CHOWDSP_WDF_WDFT_NONLINEARITIES_H
-#define CHOWDSP_WDF_WDFT_NONLINEARITIES_H
+        /** Resets the inductor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
 
-#include <cmath>
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
 
-// #include "wdft_base.h"
+            R_value = newR;
+            propagateImpedanceChange();
+        }
 
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
 
-// #include "../math/signum.h"
+            L_value = newL;
+            propagateImpedanceChange();
+        }
 
+        /** Computes the impedance of the WDF resistor/inductor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoL = (T) 2.0 * L_value;
+            const auto RT = R_value * tt;
+            wdf.R = twoL * R_value / (RT + twoL);
+            wdf.G = (T) 1.0 / wdf.R;
+            RT_over_RT_plus_twoL = RT / (RT + twoL);
+        }
 
-namespace chowdsp
-{
-/** Methods for implementing the signum function */
-namespace signum
-{
-    /** Signum function to determine the sign of the input. */
-    template <typename T>
-    inline int signum (T val)
-    {
-        return (T (0) < val) - (val < T (0));
-    }
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.b + wdf.a + z);
+        }
 
-#if defined(XSIMD_HPP)
-    /** Signum function to determine the sign of the input. */
-    template <typename T>
-    inline xsimd::batch<T> signum (xsimd::batch<T> val)
-    {
-        using v_type = xsimd::batch<T>;
-        const auto positive = xsimd::select (val > v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
-        const auto negative = xsimd::select (val < v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
-        return positive - negative;
-    }
-#endif
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -RT_over_RT_plus_twoL * z;
+            return wdf.b;
+        }
 
-} // namespace signum
-} // namespace chowdsp
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
 
-// #include "../math/omega.h"
-/*
- * Copyright (C) 2019 Stefano D'Angelo
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
- * 
- * NOTE: code has been modified significantly by Jatin Chowdhury
- */
+        WDFMembers<T> wdf;
 
-#ifndef OMEGA_H_INCLUDED
-#define OMEGA_H_INCLUDED
+    private:
+        T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
 
-#include <algorithm>
-#include <cstdint>
-#include <cstddef>
-// #include "sample_type.h"
+        T RT_over_RT_plus_twoL = (T) 0.0;
 
+        T z = (T) 0.0;
 
-namespace chowdsp
-{
-/**
- * Useful approximations for evaluating the Wright Omega function.
- *
- * This approach was devloped by Stefano D'Angelo, and adapted from his
- * original implementation under the MIT license.
- * - Paper: https://www.dafx.de/paper-archive/2019/DAFx2019_paper_5.pdf
- * - Original Source: https://www.dangelo.audio/dafx2019-omega.html
- */
-namespace Omega
-{
-    /**
-     * Evaluates a polynomial of a given order, using Estrin's scheme.
-     * Coefficients should be given in the form { a_n, a_n-1, ..., a_1, a_0 }
-     * https://en.wikipedia.org/wiki/Estrin%27s_scheme
-     */
-    template <int ORDER, typename T, typename X>
-    inline typename std::enable_if<(ORDER == 1), decltype (T {} * X {})>::type estrin (const T (&coeffs)[ORDER + 1], const X& x)
-    {
-        return coeffs[1] + coeffs[0] * x;
-    }
+        T tt;
+    };
 
-    template <int ORDER, typename T, typename X>
-    inline typename std::enable_if<(ORDER > 1), decltype (T {} * X {})>::type estrin (const T (&coeffs)[ORDER + 1], const X& x)
+    /** WDF Inductor and Capacitor in Series */
+    template <typename T>
+    class InductorCapacitorSeriesT final : public BaseWDF
     {
-        decltype (T {} * X {}) temp[ORDER / 2 + 1];
-        for (int n = ORDER; n >= 0; n -= 2)
-            temp[n / 2] = coeffs[n] + coeffs[n - 1] * x;
+    public:
+        /** Creates a new WDF Inductor/Capacitor Series.
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit InductorCapacitorSeriesT (T ind_value, T cap_value, T fs = (T) 48000.0)
+            : L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
 
-        temp[0] = (ORDER % 2 == 0) ? coeffs[0] : temp[0];
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
 
-        return estrin<ORDER / 2> (temp, x * x); // recurse!
-    }
+            reset();
+        }
 
-    /** approximation for log_2(x), optimized on the range [1, 2] */
-    template <typename T>
-    constexpr T log2_approx (T x)
-    {
-        constexpr auto alpha = (T) 0.1640425613334452;
-        constexpr auto beta = (T) -1.098865286222744;
-        constexpr auto gamma = (T) 3.148297929334117;
-        constexpr auto zeta = (T) -2.213475204444817;
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
 
-        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
-    }
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
 
-#if defined(XSIMD_HPP)
-    /** approximation for log_2(x), optimized on the range [1, 2] */
-    template <typename T>
-    inline xsimd::batch<T> log2_approx (const xsimd::batch<T>& x)
-    {
-        static constexpr auto alpha = (NumericType<T>) 0.1640425613334452;
-        static constexpr auto beta = (NumericType<T>) -1.098865286222744;
-        static constexpr auto gamma = (NumericType<T>) 3.148297929334117;
-        static constexpr auto zeta = (NumericType<T>) -2.213475204444817;
+            L_value = newL;
+            propagateImpedanceChange();
+        }
 
-        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
-    }
-#endif
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
 
-    /** approximation for log(x) */
-    template <typename T>
-    constexpr T log_approx (T x);
+            C_value = newC;
+            propagateImpedanceChange();
+        }
 
-    /** approximation for log(x) (32-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED constexpr float log_approx (float x)
-    {
-        union
-        {
-            int32_t i;
-            float f;
-        } v {};
-        v.f = x;
-        int32_t ex = v.i & 0x7f800000;
-        int32_t e = (ex >> 23) - 127;
-        v.i = (v.i - ex) | 0x3f800000;
+        /** Returns the inductance value, in Henries. */
+        T getInductanceValue() const noexcept { return L_value; }
 
-        return 0.693147180559945f * ((float) e + log2_approx<float> (v.f));
-    }
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
 
-    /** approximation for log(x) (64-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED constexpr double log_approx (double x)
-    {
-        union
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return (T) 1 / tt; }
+
+        /** Computes the impedance of the WDF inductor/capacitor combination */
+        inline void calcImpedance() override
         {
-            int64_t i;
-            double d;
-        } v {};
-        v.d = x;
-        int64_t ex = v.i & 0x7ff0000000000000;
-        int64_t e = (ex >> 53) - 510;
-        v.i = (v.i - ex) | 0x3ff0000000000000;
-
-        return 0.693147180559945 * ((double) e + log2_approx<double> (v.d));
-    }
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto R_C = tt / ((T) 2.0 * C_value);
+            wdf.R = R_C + (T) 2.0 * L_value / tt;
+            wdf.G = (T) 1.0 / wdf.R;
+            RC_over_Rp = R_C * wdf.G;
+        }
 
-#if defined(XSIMD_HPP)
-    /** approximation for log(x) (SIMD 32-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<float> log_approx (xsimd::batch<float> x)
-    {
-        union
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
         {
-            xsimd::batch<int32_t> i;
-            xsimd::batch<float> f;
-        } v;
-        v.f = x;
-        xsimd::batch<int32_t> ex = v.i & 0x7f800000;
-        xsimd::batch<float> e = xsimd::to_float ((ex >> 23) - 127);
-        v.i = (v.i - ex) | 0x3f800000;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            zC = denormals::flushState (zC - RC_over_Rp * (wdf.a - wdf.b));
+            zL = denormals::flushState (-(wdf.a + zC));
+        }
 
-        return 0.693147180559945f * (log2_approx<float> (v.f) + e);
-    }
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = zL - zC;
+            return wdf.b;
+        }
 
-    /** approximation for log(x) (64-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<double> log_approx (xsimd::batch<double> x)
-    {
-        union
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
         {
-            xsimd::batch<int64_t> i;
-            xsimd::batch<double> d;
-        } v {};
-        v.d = x;
-        xsimd::batch<int64_t> ex = v.i & 0x7ff0000000000000;
-        xsimd::batch<double> e = xsimd::to_float ((ex >> 53) - 510);
-        v.i = (v.i - ex) | 0x3ff0000000000000;
+            visitor (zL);
+            visitor (zC);
+        }
 
-        return 0.693147180559945 * (e + log2_approx<double> (v.d));
-    }
-#endif
+        WDFMembers<T> wdf;
 
-    /** approximation for 2^x, optimized on the range [0, 1] */
-    template <typename T>
-    constexpr T pow2_approx (T x)
-    {
-        constexpr auto alpha = (T) 0.07944154167983575;
-        constexpr auto beta = (T) 0.2274112777602189;
-        constexpr auto gamma = (T) 0.6931471805599453;
-        constexpr auto zeta = (T) 1.0;
+    private:
+        T L_value = (T) 1.0e-3;
+        T C_value = (T) 1.0e-6;
 
-        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
-    }
+        T RC_over_Rp = (T) 0.0;
 
-#if defined(XSIMD_HPP)
-    template <typename T>
-    inline xsimd::batch<T> pow2_approx (const xsimd::batch<T>& x)
-    {
-        static constexpr auto alpha = (NumericType<T>) 0.07944154167983575;
-        static constexpr auto beta = (NumericType<T>) 0.2274112777602189;
-        static constexpr auto gamma = (NumericType<T>) 0.6931471805599453;
-        static constexpr auto zeta = (NumericType<T>) 1.0;
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
 
-        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
-    }
-#endif
+        T tt;
+    };
 
-    /** approximation for exp(x) */
+    /** WDF Inductor and Capacitor in parallel */
     template <typename T>
-    T exp_approx (T x);
-
-    /** approximation for exp(x) (32-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED constexpr float exp_approx (float x)
+    class InductorCapacitorParallelT final : public BaseWDF
     {
-        x = std::max (-126.0f, 1.442695040888963f * x);
-
-        union
+    public:
+        /** Creates a new WDF Inductor/Capacitor Parallel.
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit InductorCapacitorParallelT (T ind_value, T cap_value, T fs = (T) 48000.0)
+            : L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
         {
-            int32_t i;
-            float f;
-        } v {};
-
-        auto xi = (int32_t) x;
-        int32_t l = x < 0.0f ? xi - 1 : xi;
-        float f = x - (float) l;
-        v.i = (l + 127) << 23;
-
-        return v.f * pow2_approx<float> (f);
-    }
-
-    /** approximation for exp(x) (64-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED constexpr double exp_approx (double x)
-    {
-        x = std::max ((double) -126.0, 1.442695040888963 * x);
+            calcImpedance();
+        }
 
-        union
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
         {
-            int64_t i;
-            double d;
-        } v {};
-
-        auto xi = (int64_t) x;
-        int64_t l = x < 0.0 ? xi - 1 : xi;
-        double d = x - (double) l;
-        v.i = (l + 1023) << 52;
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
 
-        return v.d * pow2_approx<double> (d);
-    }
+            reset();
+        }
 
-#if defined(XSIMD_HPP)
-    /** approximation for exp(x) (32-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<float> exp_approx (xsimd::batch<float> x)
-    {
-        x = xsimd::max (xsimd::broadcast (-126.0f), 1.442695040888963f * x);
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
 
-        union
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
         {
-            xsimd::batch<int32_t> i;
-            xsimd::batch<float> f;
-        } v {};
+            if (all (newL == L_value))
+                return;
 
-        auto xi = xsimd::to_int (x);
-        xsimd::batch<int32_t> l = xsimd::select (xi < 0, xi - 1, xi);
-        xsimd::batch<float> f = x - xsimd::to_float (l);
-        v.i = (l + 127) << 23;
+            L_value = newL;
+            propagateImpedanceChange();
+        }
 
-        return v.f * pow2_approx<float> (f);
-    }
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
 
-    /** approximation for exp(x) (64-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<double> exp_approx (xsimd::batch<double> x)
-    {
-        x = xsimd::max (xsimd::broadcast (-126.0), 1.442695040888963 * x);
+            C_value = newC;
+            propagateImpedanceChange();
+        }
 
-        union
+        /** Computes the impedance of the WDF inductor/capacitor combination */
+        inline void calcImpedance() override
         {
-            xsimd::batch<int64_t> i;
-            xsimd::batch<double> d;
-        } v {};
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto G_C = (T) 2.0 * C_value / tt;
+            wdf.G = G_C + tt / ((T) 2.0 * L_value);
+            wdf.R = (T) 1.0 / wdf.G;
+            GC_over_Gp = G_C * wdf.R;
+        }
 
-        auto xi = xsimd::to_int (x);
-        xsimd::batch<int64_t> l = xsimd::select (xi < 0, xi - 1, xi);
-        xsimd::batch<double> d = x - xsimd::to_float (l);
-        v.i = (l + 1023) << 52;
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            const auto a_plus_b = wdf.a + wdf.b;
+            zL = denormals::flushState (a_plus_b + zL);
+            zC = denormals::flushState (a_plus_b - zC);
+        }
 
-        return v.d * pow2_approx<double> (d);
-    }
-#endif
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = GC_over_Gp * (zL + zC) - zL;
+            return wdf.b;
+        }
 
-    /** First-order approximation of the Wright Omega functions */
-    template <typename T>
-    constexpr T omega1 (T x)
-    {
-#if defined(XSIMD_HPP)
-        using xsimd::max;
-#endif
-        using std::max;
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (zL);
+            visitor (zC);
+        }
 
-        return max (x, (T) 0);
-    }
+        WDFMembers<T> wdf;
 
-    /** Second-order approximation of the Wright Omega functions */
-    template <typename T>
-    constexpr T omega2 (T x)
-    {
-        constexpr auto x1 = (NumericType<T>) -3.684303659906469;
-        constexpr auto x2 = (NumericType<T>) 1.972967391708859;
-        constexpr auto a = (NumericType<T>) 9.451797158780131e-3;
-        constexpr auto b = (NumericType<T>) 1.126446405111627e-1;
-        constexpr auto c = (NumericType<T>) 4.451353886588814e-1;
-        constexpr auto d = (NumericType<T>) 5.836596684310648e-1;
+    private:
+        T L_value = (T) 1.0e-3;
+        T C_value = (T) 1.0e-6;
 
-        return select (x < x1, (T) 0, select (x > x2, x, estrin<3> ({ a, b, c, d }, x)));
-    }
+        T GC_over_Gp = (T) 0.0;
 
-    /** Third-order approximation of the Wright Omega functions */
-    template <typename T>
-    constexpr T omega3 (T x)
-    {
-        constexpr auto x1 = (NumericType<T>) -3.341459552768620;
-        constexpr auto x2 = (NumericType<T>) 8.0;
-        constexpr auto a = (NumericType<T>) -1.314293149877800e-3;
-        constexpr auto b = (NumericType<T>) 4.775931364975583e-2;
-        constexpr auto c = (NumericType<T>) 3.631952663804445e-1;
-        constexpr auto d = (NumericType<T>) 6.313183464296682e-1;
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
 
-        return select (x < x1, (T) 0, select (x < x2, estrin<3> ({ a, b, c, d }, x), x - log_approx<T> (x)));
-    }
+        T tt;
+    };
 
-    /** Fourth-order approximation of the Wright Omega functions */
+    /** WDF Resistor, Inductor, and Capacitor in Series */
     template <typename T>
-    constexpr T omega4 (T x)
-    {
-        const auto y = omega3<T> (x);
-        return y - (y - exp_approx<T> (x - y)) / (y + (T) 1);
-    }
-
-    struct Omega
+    class ResistorInductorCapacitorSeriesT final : public BaseWDF
     {
-        template <typename T>
-        static T omega (T x)
+    public:
+        /** Creates a new WDF Resistor/Inductor/Capacitor Series.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorInductorCapacitorSeriesT (T res_value, T ind_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
         {
-            return omega4 (x);
+            calcImpedance();
         }
-    };
-} // namespace Omega
-} // namespace chowdsp
 
-#endif //OMEGA_H_INCLUDED
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
 
+            reset();
+        }
 
-namespace chowdsp
-{
-namespace wdft
-{
-    /** Enum to determine which diode approximation eqn. to use */
-    enum DiodeQuality
-    {
-        Good, // see reference eqn (18)
-        Best, // see reference eqn (39)
-    };
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
 
-    /**
-     * WDF diode pair (non-adaptable)
-     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
-     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
-     */
-    template <typename T, typename Next, DiodeQuality Quality = DiodeQuality::Best, typename OmegaProvider = Omega::Omega>
-    class DiodePairT final : public RootWDF
-    {
-    public:
-        /**
-         * Creates a new WDF diode pair, with the given diode specifications.
-         * @param n: the next element in the WDF connection tree
-         * @param Is: reverse saturation current
-         * @param Vt: thermal voltage
-         * @param nDiodes: the number of series diodes
-         */
-        DiodePairT (Next& n, T Is, T Vt = NumericType<T> (25.85e-3), T nDiodes = 1) : next (n)
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
         {
-            n.connectToParent (this);
-            setDiodeParameters (Is, Vt, nDiodes);
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
         }
 
-        /** Sets diode specific parameters */
-        void setDiodeParameters (T newIs, T newVt, T nDiodes)
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
         {
-            Is = newIs;
-            Vt = nDiodes * newVt;
-            twoVt = (T) 2 * Vt;
-            oneOverVt = (T) 1 / Vt;
-            calcImpedance();
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
         }
 
-        inline void calcImpedance() override
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
         {
-#if defined(XSIMD_HPP)
-            using xsimd::log;
-#endif
-            using std::log;
+            if (all (newC == C_value))
+                return;
 
-            R_Is = next.wdf.R * Is;
-            R_Is_overVt = R_Is * oneOverVt;
-            logR_Is_overVt = log (R_Is_overVt);
+            C_value = newC;
+            propagateImpedanceChange();
         }
 
-        /** Accepts an incident wave into a WDF diode pair. */
+        /** Computes the impedance of the WDF resistor/inductor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto R_L = (T) 2.0 * L_value / tt;
+            const auto R_C = tt / ((T) 2.0 * C_value);
+            wdf.R = R_value + R_L + R_C;
+            wdf.G = (T) 1.0 / wdf.R;
+            RL_over_Rp = R_L * wdf.G;
+            RC_over_Rp = R_C * wdf.G;
+        }
+
+        /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
+            const auto a_minus_b = wdf.a - wdf.b;
+            zL = denormals::flushState (-(zL + RL_over_Rp * a_minus_b));
+            zC = denormals::flushState (zC - RC_over_Rp * a_minus_b);
         }
 
-        /** Propogates a reflected wave from a WDF diode pair. */
+        /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            reflectedInternal();
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = zL - zC;
             return wdf.b;
         }
 
-        WDFMembers<T> wdf;
-
-    private:
-        /** Implementation for float/double (Good). */
-        template <typename C = T, DiodeQuality Q = Quality>
-        inline typename std::enable_if<Q == Good, void>::type
-            reflectedInternal() noexcept
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
         {
-            // See eqn (18) from reference paper
-            T lambda = (T) signum::signum (wdf.a);
-            wdf.b = wdf.a + (T) 2 * lambda * (R_Is - Vt * OmegaProvider::omega (logR_Is_overVt + lambda * wdf.a * oneOverVt + R_Is_overVt));
+            visitor (zL);
+            visitor (zC);
         }
 
-        /** Implementation for float/double (Best). */
-        template <typename C = T, DiodeQuality Q = Quality>
-        inline typename std::enable_if<Q == Best, void>::type
-            reflectedInternal() noexcept
-        {
-            // See eqn (39) from reference paper
-            T lambda = (T) signum::signum (wdf.a);
-            T lambda_a_over_vt = lambda * wdf.a * oneOverVt;
-            wdf.b = wdf.a - twoVt * lambda * (Omega::omega4 (logR_Is_overVt + lambda_a_over_vt) - Omega::omega4 (logR_Is_overVt - lambda_a_over_vt));
-        }
+        WDFMembers<T> wdf;
 
-        T Is; // reverse saturation current
-        T Vt; // thermal voltage
+    private:
+        T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
+        T C_value = (T) 1.0e-6;
 
-        // pre-computed vars
-        T twoVt;
-        T oneOverVt;
-        T R_Is;
-        T R_Is_overVt;
-        T logR_Is_overVt;
+        T RL_over_Rp = (T) 0.0;
+        T RC_over_Rp = (T) 0.0;
+
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
 
-        const Next& next;
+        T tt;
     };
 
     /**
-     * WDF diode (non-adaptable)
-     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
-     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
+     * WDF Capacitor with an equivalent series resistance (ESR),
+     * and a leakage resistance in parallel with the capacitor.
+     *
+     * The default leakage resistance is large enough that the
+     * element behaves like a resistor and capacitor in series.
      */
-    template <typename T, typename Next, DiodeQuality Quality = DiodeQuality::Best, typename OmegaProvider = Omega::Omega>
-    class DiodeT final : public RootWDF
+    template <typename T>
+    class CapacitorESRT final : public BaseWDF
     {
     public:
-        /**
-         * Creates a new WDF diode, with the given diode specifications.
-         * @param n: the next element in the WDF connection tree
-         * @param Is: reverse saturation current
-         * @param Vt: thermal voltage
-         * @param nDiodes: the number of series diodes
+        /** Creates a new WDF Capacitor with ESR.
+         * @param cap_value: Capacitance value in Farads
+         * @param esr_value: Equivalent series resistance in Ohms
+         * @param fs: WDF sample rate
+         * @param leakage_value: Leakage resistance in Ohms
          */
-        DiodeT (Next& n, T Is, T Vt = NumericType<T> (25.85e-3), T nDiodes = 1) : next (n)
+        explicit CapacitorESRT (T cap_value, T esr_value, T fs = (T) 48000.0, T leakage_value = NumericType<T> (1.0e9))
+            : C_value (cap_value),
+              ESR_value (esr_value),
+              leakage_value (leakage_value),
+              tt ((T) 1 / fs)
         {
-            n.connectToParent (this);
-            setDiodeParameters (Is, Vt, nDiodes);
+            calcImpedance();
         }
 
-        /** Sets diode specific parameters */
-        void setDiodeParameters (T newIs, T newVt, T nDiodes)
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
         {
-            Is = newIs;
-            Vt = nDiodes * newVt;
-            twoVt = (T) 2 * Vt;
-            oneOverVt = (T) 1 / Vt;
-            calcImpedance();
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
         }
 
-        inline void calcImpedance() override
+        /** Resets the capacitor state */
+        void reset()
         {
-#if defined(XSIMD_HPP)
-            using xsimd::log;
-#endif
-            using std::log;
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
 
-            twoR_Is = (T) 2 * next.wdf.R * Is;
-            R_Is_overVt = next.wdf.R * Is * oneOverVt;
-            logR_Is_overVt = log (R_Is_overVt);
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
         }
 
-        /** Accepts an incident wave into a WDF diode. */
+        /** Sets the equivalent series resistance, in Ohms. */
+        void setESRValue (T newESR)
+        {
+            if (all (newESR == ESR_value))
+                return;
+
+            ESR_value = newESR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the leakage resistance, in Ohms. */
+        void setLeakageResistanceValue (T newR)
+        {
+            if (all (newR == leakage_value))
+                return;
+
+            leakage_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF capacitor/ESR/leakage combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoRC = (T) 2.0 * C_value * leakage_value;
+            const auto R_leaky_cap = leakage_value * tt / (twoRC + tt);
+            wdf.R = R_leaky_cap + ESR_value;
+            wdf.G = (T) 1.0 / wdf.R;
+            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
+            Rcap_over_Rp = R_leaky_cap * wdf.G;
+        }
+
+        /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
+            z = denormals::flushState (-((T) 2 * wdf.b + z + Rcap_over_Rp * (wdf.a - wdf.b)));
         }
 
-        /** Propogates a reflected wave from a WDF diode. */
+        /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            // See eqn (10) from reference paper
-            wdf.b = wdf.a + twoR_Is - twoVt * OmegaProvider::omega (logR_Is_overVt + wdf.a * oneOverVt + R_Is_overVt);
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -twoRC_over_twoRC_plus_T * z;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        T Is; // reverse saturation current
-        T Vt; // thermal voltage
+        T C_value = (T) 1.0e-6;
+        T ESR_value = (T) 1.0;
+        T leakage_value = (T) 1.0e9;
 
-        // pre-computed vars
-        T twoVt;
-        T oneOverVt;
-        T twoR_Is;
-        T R_Is_overVt;
-        T logR_Is_overVt;
+        T twoRC_over_twoRC_plus_T = (T) 0.0;
+        T Rcap_over_Rp = (T) 0.0;
+
+        T z = (T) 0.0;
 
-        const Next& next;
+        T tt;
     };
+} // namespace wdft
+} // namespace chowdsp
 
-    /** WDF Switch (non-adaptable) */
+#endif //CHOWDSP_WDF_WDFT_ONE_PORTS_H
+
+// #include "wdft_sources.h"
+#ifndef CHOWDSP_WDF_WDFT_SOURCES_H
+#define CHOWDSP_WDF_WDFT_SOURCES_H
+
+// #include "wdft_base.h"
+
+// #include "../math/compensated_float.h"
+
+// #include "../math/denormals.h"
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** WDF Ideal Voltage source (non-adaptable) */
     template <typename T, typename Next>
-    class SwitchT final : public RootWDF
+    class IdealVoltageSourceT final : public RootWDF
     {
     public:
-        explicit SwitchT (Next& next)
+        explicit IdealVoltageSourceT (Next& n) : next (n)
         {
-            next.connectToParent (this);
+            n.connectToParent (this);
+            calcImpedance();
         }
 
-        inline void calcImpedance() override {}
+        void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
 
-        /** Sets the state of the switch. */
-        void setClosed (bool shouldClose) { closed = shouldClose; }
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV) { Vs = newV; }
 
-        /** Accepts an incident wave into a WDF switch. */
+        /** Accepts an incident wave into a WDF ideal voltage source. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
-        /** Propogates a reflected wave from a WDF switch. */
+        /** Propogates a reflected wave from a WDF ideal voltage source. */
         inline T reflected() noexcept
         {
-            wdf.b = closed ? -wdf.a : wdf.a;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -wdf.a + (T) 2.0 * Vs;
             return wdf.b;
         }
 
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        bool closed = true;
+        Next& next;
+
+        T Vs = (T) 0.0;
     };
-} // namespace wdft
-} // namespace chowdsp
 
-#endif //CHOWDSP_WDF_WDFT_NONLINEARITIES_H
-
-
-#endif // CHOWDSP_WDF_T_INCLUDED
-
-// #include "wdf/wdf.h"
-#ifndef CHOWDSP_WDF_H_INCLUDED
-#define CHOWDSP_WDF_H_INCLUDED
-
-namespace chowdsp
-{
-/** API for constructing Wave Digital Filters with run-time flexibility */
-namespace wdf
-{
-}
-
-} // namespace chowdsp
-
-// #include "wdf_one_ports.h"
-#ifndef CHOWDSP_WDF_WDF_ONE_PORTS_H
-#define CHOWDSP_WDF_WDF_ONE_PORTS_H
-
-// #include "wdf_base.h"
-#ifndef CHOWDSP_WDF_WDF_BASE_H
-#define CHOWDSP_WDF_WDF_BASE_H
-
-#include <string>
-#include <utility>
-
-// #include "../wdft/wdft.h"
-#ifndef CHOWDSP_WDF_T_INCLUDED
-#define CHOWDSP_WDF_T_INCLUDED
-
-namespace chowdsp
-{
-/** API for constructing Wave Digital Filters with a fixed compile-time architecture */
-namespace wdft
-{
-}
-
-} // namespace chowdsp
-
-// #include "wdft_one_ports.h"
-#ifndef CHOWDSP_WDF_WDFT_ONE_PORTS_H
-#define CHOWDSP_WDF_WDFT_ONE_PORTS_H
-
-// #include "wdft_base.h"
-#ifndef CHOWDSP_WDF_WDFT_BASE_H
-#define CHOWDSP_WDF_WDFT_BASE_H
-
-// #include "../math/sample_type.h"
-#ifndef CHOWDSP_WDF_SAMPLE_TYPE_H
-#define CHOWDSP_WDF_SAMPLE_TYPE_H
-
-#include <type_traits>
-
-#ifndef DOXYGEN
-
-namespace chowdsp
-{
-#if ! (JUCE_MODULE_AVAILABLE_chowdsp_dsp)
-/** Useful structs for determining the internal data type of SIMD types */
-namespace SampleTypeHelpers
-{
-    template <typename T, bool = std::is_floating_point<T>::value>
-    struct ElementType
-    {
-        using Type = T;
-    };
-
-    template <typename T>
-    struct ElementType<T, false>
-    {
-        using Type = typename T::value_type;
-    };
-} // namespace SampleTypeHelpers
-#endif
-
-/** Type alias for a SIMD numeric type */
-template <typename T>
-using NumericType = typename SampleTypeHelpers::ElementType<T>::Type;
-
-/** Returns true if all the elements in a SIMD vector are equal */
-inline bool all (bool x)
-{
-    return x;
-}
-
-/** Ternary select operation */
-template <typename T>
-inline T select (bool b, const T& t, const T& f)
-{
-    return b ? t : f;
-}
-} // namespace chowdsp
-
-#endif // DOXYGEN
-
-#endif //CHOWDSP_WDF_SAMPLE_TYPE_H
-
-
-namespace chowdsp
-{
-namespace wdft
-{
-    /** Base WDF class for propagating impedance changes between elements */
-    class BaseWDF
-    {
-    public:
-        virtual ~BaseWDF() = default;
-
-        void connectToParent (BaseWDF* p) { parent = p; }
-
-        virtual void calcImpedance() = 0;
-
-        inline virtual void propagateImpedanceChange()
-        {
-            if (dontPropagateImpedance)
-                return; // the impedance propagation is being deferred until later...
-
-            calcImpedance();
-
-            if (parent != nullptr)
-                parent->propagateImpedanceChange();
-        }
-
-    protected:
-        BaseWDF* parent = nullptr;
-
-    private:
-        bool dontPropagateImpedance = false;
-
-        template <typename... Elements>
-        friend class ScopedDeferImpedancePropagation;
-    };
-
-    /** Base class for propagating impedance changes into root WDF elements */
-    class RootWDF : public BaseWDF
-    {
-    public:
-        inline void propagateImpedanceChange() override { calcImpedance(); }
-
-    private:
-        // don't try to connect root nodes!
-        void connectToParent (BaseWDF*) {}
-    };
-
-    /** Helper struct for common WDF member variables */
-    template <typename T>
-    struct WDFMembers
-    {
-        T R = (NumericType<T>) 1.0e-9; /* impedance */
-        T G = (T) 1.0 / R; /* admittance */
-        T a = (T) 0.0; /* incident wave */
-        T b = (T) 0.0; /* reflected wave */
-    };
-
-    /** Probe the voltage across this circuit element. */
-    template <typename T, typename WDFType>
-    inline T voltage (const WDFType& wdf) noexcept
-    {
-        return (wdf.wdf.a + wdf.wdf.b) * (T) 0.5;
-    }
-
-    /**Probe the current through this circuit element. */
-    template <typename T, typename WDFType>
-    inline T current (const WDFType& wdf) noexcept
-    {
-        return (wdf.wdf.a - wdf.wdf.b) * ((T) 0.5 * wdf.wdf.G);
-    }
-} // namespace wdft
-} // namespace chowdsp
-
-#endif // CHOWDSP_WDF_WDFT_BASE_H
-
-
-namespace chowdsp
-{
-namespace wdft
-{
-    /** WDF Resistor Node */
+    /** WDF Voltage source with series resistance */
     template <typename T>
-    class ResistorT final : public BaseWDF
+    class ResistiveVoltageSourceT final : public BaseWDF
     {
     public:
-        /** Creates a new WDF Resistor with a given resistance.
-         * @param value: resistance in Ohms
+        /** Creates a new resistive voltage source.
+         * @param value: initial resistance value, in Ohms
          */
-        explicit ResistorT (T value) : R_value (value)
+        explicit ResistiveVoltageSourceT (T value = NumericType<T> (1.0e-9)) : R_value (value)
         {
             calcImpedance();
         }
 
-        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        /** Sets the resistance value of the series resistor, in Ohms. */
         void setResistanceValue (T newR)
         {
             if (all (newR == R_value))
@@ -2164,43 +2460,59 @@ namespace wdft
             propagateImpedanceChange();
         }
 
-        /** Computes the impedance of the WDF resistor, Z_R = R. */
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
+        /** Computes the impedance for a WDF resistive voltage souce
+         * Z_Vr = Z_R
+         */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = R_value;
             wdf.G = (T) 1.0 / wdf.R;
         }
 
-        /** Accepts an incident wave into a WDF resistor. */
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV) { Vs = newV; }
+
+        /** Returns the voltage of the voltage source, in Volts */
+        T getVoltage() const noexcept { return Vs; }
+
+        /** Accepts an incident wave into a WDF resistive voltage source. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
-        /** Propogates a reflected wave from a WDF resistor. */
+        /** Propogates a reflected wave from a WDF resistive voltage source. */
         inline T reflected() noexcept
         {
-            wdf.b = 0.0;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = Vs;
             return wdf.b;
         }
 
         WDFMembers<T> wdf;
 
     private:
+        T Vs = (T) 0.0;
         T R_value = (T) 1.0e-9;
     };
 
-    /** WDF Capacitor Node */
+    /** WDF Voltage source with series capacitance */
     template <typename T>
-    class CapacitorT final : public BaseWDF
+    class CapacitiveVoltageSourceT final : public BaseWDF
     {
     public:
-        /** Creates a new WDF Capacitor.
-         * @param value: Capacitance value in Farads
-         * @param _fs: WDF sample rate
+        /** Creates a new resistive voltage source.
+         * @param value: initial resistance value, in Ohms
          */
-        explicit CapacitorT (T value, T _fs = (T) 48000.0) : C_value (value),
-                                                             fs (_fs)
+        explicit CapacitiveVoltageSourceT (T value = NumericType<T> (1.0e-6), T fs = (T) 48000)
+            : C_value (value),
+              fs (fs)
+
         {
             calcImpedance();
         }
@@ -2214,13 +2526,13 @@ namespace wdft
             reset();
         }
 
-        /** Resets the capacitor state */
         void reset()
         {
-            z = (T) 0.0;
+            z = (T) 0;
+            v_1 = (T) 0;
         }
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        /** Sets the capacitance value of the series resistor, in Farads. */
         void setCapacitanceValue (T newC)
         {
             if (all (newC == C_value))
@@ -2237,292 +2549,183 @@ namespace wdft
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
             wdf.G = (T) 1.0 / wdf.R;
         }
 
-        /** Accepts an incident wave into a WDF capacitor. */
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV)
+        {
+            v_0 = newV;
+        }
+
+        /** Accepts an incident wave into a WDF resistive voltage source. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.a;
+            z = denormals::flushState (wdf.a);
         }
 
-        /** Propogates a reflected wave from a WDF capacitor. */
+        /** Propogates a reflected wave from a WDF resistive voltage source. */
         inline T reflected() noexcept
         {
-            wdf.b = z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = z + v_0 - v_1;
+            v_1 = v_0;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+            visitor (v_1);
+        }
+
         WDFMembers<T> wdf;
 
     private:
         T C_value = (T) 1.0e-6;
-        T z = (T) 0.0;
+
+        T z {};
+        T v_0 {};
+        T v_1 {};
 
         T fs;
     };
 
-    /** WDF Capacitor Node with alpha transform parameter */
-    template <typename T>
-    class CapacitorAlphaT final : public BaseWDF
+    /** WDF Current source (non-adaptable) */
+    template <typename T, typename Next>
+    class IdealCurrentSourceT final : public RootWDF
     {
     public:
-        /** Creates a new WDF Capacitor.
-         * @param value: Capacitance value in Farads
-         * @param fs: WDF sample rate
-         * @param alpha: alpha value to be used for the alpha transform,
-         *             use 0 for Backwards Euler, use 1 for Bilinear Transform.
-         */
-        explicit CapacitorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : C_value (value),
-                                                                                    fs (fs),
-                                                                                    alpha (alpha),
-                                                                                    b_coef (((T) 1.0 - alpha) / (T) 2.0),
-                                                                                    a_coef (((T) 1.0 + alpha) / (T) 2.0)
+        explicit IdealCurrentSourceT (Next& n) : next (n)
         {
+            n.connectToParent (this);
             calcImpedance();
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
-        {
-            fs = sampleRate;
-            propagateImpedanceChange();
-
-            reset();
-        }
-
-        /** Resets the capacitor state */
-        void reset()
-        {
-            z = (T) 0.0;
-        }
-
-        /** Sets a new alpha value to use for the alpha transform */
-        void setAlpha (T newAlpha)
-        {
-            alpha = newAlpha;
-            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
-            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
-
-            propagateImpedanceChange();
-        }
-
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
+        inline void calcImpedance() override
         {
-            if (all (newC == C_value))
-                return;
-
-            C_value = newC;
-            propagateImpedanceChange();
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            twoR = (T) 2.0 * next.wdf.R;
+            twoR_Is = twoR * Is;
         }
 
-        /** Computes the impedance of the WDF capacitor,
-         *                 1
-         * Z_C = ---------------------
-         *       (1 + alpha) * f_s * C
-         */
-        inline void calcImpedance() override
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI)
         {
-            wdf.R = (T) 1.0 / (((T) 1.0 + alpha) * C_value * fs);
-            wdf.G = (T) 1.0 / wdf.R;
+            Is = newI;
+            twoR_Is = twoR * Is;
         }
 
-        /** Accepts an incident wave into a WDF capacitor. */
+        /** Accepts an incident wave into a WDF ideal current source. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.a;
         }
 
-        /** Propogates a reflected wave from a WDF capacitor. */
+        /** Propogates a reflected wave from a WDF ideal current source. */
         inline T reflected() noexcept
         {
-            wdf.b = b_coef * wdf.b + a_coef * z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = twoR_Is + wdf.a;
             return wdf.b;
         }
 
-        WDFMembers<T> wdf;
-
-    private:
-        T C_value = (T) 1.0e-6;
-        T z = (T) 0.0;
-
-        T fs;
-
-        T alpha;
-        T b_coef;
-        T a_coef;
-    };
-
-    /** WDF Inductor Node */
-    template <typename T>
-    class InductorT final : public BaseWDF
-    {
-    public:
-        /** Creates a new WDF Inductor.
-         * @param value: Inductance value in Farads
-         * @param fs: WDF sample rate
-         */
-        explicit InductorT (T value, T fs = (T) 48000.0) : L_value (value),
-                                                           fs (fs)
-        {
-            calcImpedance();
-        }
-
-        /** Prepares the inductor to operate at a new sample rate */
-        void prepare (T sampleRate)
-        {
-            fs = sampleRate;
-            propagateImpedanceChange();
-
-            reset();
-        }
-
-        /** Resets the inductor state */
-        void reset()
-        {
-            z = (T) 0.0;
-        }
-
-        /** Sets the inductance value of the WDF inductor, in Henries. */
-        void setInductanceValue (T newL)
-        {
-            if (all (newL == L_value))
-                return;
-
-            L_value = newL;
-            propagateImpedanceChange();
-        }
-
-        /** Computes the impedance of the WDF inductor,
-         * Z_L = 2 * f_s * L
-         */
-        inline void calcImpedance() override
-        {
-            wdf.R = (T) 2.0 * L_value * fs;
-            wdf.G = (T) 1.0 / wdf.R;
-        }
-
-        /** Accepts an incident wave into a WDF inductor. */
-        inline void incident (T x) noexcept
-        {
-            wdf.a = x;
-            z = wdf.a;
-        }
-
-        /** Propogates a reflected wave from a WDF inductor. */
-        inline T reflected() noexcept
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
         {
-            wdf.b = -z;
-            return wdf.b;
+            fn (next);
         }
 
         WDFMembers<T> wdf;
 
     private:
-        T L_value = (T) 1.0e-6;
-        T z = (T) 0.0;
+        Next& next;
 
-        T fs;
+        T Is = (T) 0.0;
+        T twoR;
+        T twoR_Is;
     };
 
-    /** WDF Inductor Node with alpha transform parameter */
+    /** WDF Current source with parallel resistance */
     template <typename T>
-    class InductorAlphaT final : public BaseWDF
+    class ResistiveCurrentSourceT final : public BaseWDF
     {
     public:
-        /** Creates a new WDF Inductor.
-         * @param value: Inductance value in Farads
-         * @param fs: WDF sample rate
-         * @param alpha: alpha value to be used for the alpha transform,
-         *               use 0 for Backwards Euler, use 1 for Bilinear Transform.
+        /** Creates a new resistive current source.
+         * @param value: initial resistance value, in Ohms
          */
-        explicit InductorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : L_value (value),
-                                                                                   fs (fs),
-                                                                                   alpha (alpha),
-                                                                                   b_coef (((T) 1.0 - alpha) / (T) 2.0),
-                                                                                   a_coef (((T) 1.0 + alpha) / (T) 2.0)
+        explicit ResistiveCurrentSourceT (T value = NumericType<T> (1.0e9)) : R_value (value)
         {
             calcImpedance();
         }
 
-        /** Prepares the inductor to operate at a new sample rate */
-        void prepare (T sampleRate)
-        {
-            fs = sampleRate;
-            propagateImpedanceChange();
-
-            reset();
-        }
-
-        /** Resets the inductor state */
-        void reset()
-        {
-            z = (T) 0.0;
-        }
-
-        /** Sets a new alpha value to use for the alpha transform */
-        void setAlpha (T newAlpha)
-        {
-            alpha = newAlpha;
-            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
-            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
-
-            propagateImpedanceChange();
-        }
-
-        /** Sets the inductance value of the WDF inductor, in Henries. */
-        void setInductanceValue (T newL)
+        /** Sets the resistance value of the parallel resistor, in Ohms. */
+        void setResistanceValue (T newR)
         {
-            if (all (newL == L_value))
+            if (all (newR == R_value))
                 return;
 
-            L_value = newL;
+            R_value = newR;
             propagateImpedanceChange();
         }
 
-        /** Computes the impedance of the WDF inductor,
-         * Z_L = (1 + alpha) * f_s * L
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
+        /** Computes the impedance for a WDF resistive current souce
+         * Z_Ir = Z_R
          */
         inline void calcImpedance() override
         {
-            wdf.R = ((T) 1.0 + alpha) * L_value * fs;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = R_value;
             wdf.G = (T) 1.0 / wdf.R;
         }
 
-        /** Accepts an incident wave into a WDF inductor. */
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI) { Is = newI; }
+
+        /** Returns the current of the current source, in Amps */
+        T getCurrent() const noexcept { return Is; }
+
+        /** Accepts an incident wave into a WDF resistive current source. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.a;
         }
 
-        /** Propogates a reflected wave from a WDF inductor. */
+        /** Propogates a reflected wave from a WDF resistive current source. */
         inline T reflected() noexcept
         {
-            wdf.b = b_coef * wdf.b - a_coef * z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = wdf.R * Is;
             return wdf.b;
         }
 
         WDFMembers<T> wdf;
 
     private:
-        T L_value = (T) 1.0e-6;
-        T z = (T) 0.0;
-
-        T fs;
-
-        T alpha;
-        T b_coef;
-        T a_coef;
+        T Is = (T) 0.0;
+        T R_value = (T) 1.0e9;
     };
 
-    /** WDF Resistor and Capacitor in Series */
-    template <typename T>
-    class ResistorCapacitorSeriesT final : public BaseWDF
+    /**
+     * WDF Resistor and Capacitor and Voltage source in Series
+     *
+     * As with ResistorCapacitorSeriesT, the StateType argument may be used to store the
+     * capacitor state at a higher precision than the waves and coefficients.
+     */
+    template <typename T, typename StateType = T>
+    class ResistiveCapacitiveVoltageSourceT final : public BaseWDF
     {
     public:
         /** Creates a new WDF Resistor/Capacitor Series.
@@ -2530,12 +2733,13 @@ namespace wdft
          * @param res_value: Capacitance value in Farads
          * @param fs: WDF sample rate
          */
-        explicit ResistorCapacitorSeriesT (T res_value, T cap_value, T fs = (T) 48000.0)
+        explicit ResistiveCapacitiveVoltageSourceT (T res_value, T cap_value, T fs = (T) 48000.0)
             : R_value (res_value),
               C_value (cap_value),
               tt ((T) 1 / fs)
         {
             calcImpedance();
+            reset();
         }
 
         /** Prepares the capacitor to operate at a new sample rate */
@@ -2550,9 +2754,7 @@ namespace wdft
         /** Resets the capacitor state */
         void reset()
         {
-            z = (T) 0.0;
-            wdf.a = (T) 0;
-            wdf.b = (T) 0;
+            z = StateType {};
         }
 
         /** Sets the resistance value of the WDF resistor, in Ohms. */
@@ -2575,9 +2777,13 @@ namespace wdft
             propagateImpedanceChange();
         }
 
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV) { Vs = newV; }
+
         /** Computes the impedance of the WDF resistor/capacitor combination */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = tt / ((T) 2.0 * C_value) + R_value;
             wdf.G = (T) 1.0 / wdf.R;
             T_over_T_plus_2RC = tt / ((T) 2 * C_value * R_value + tt);
@@ -2586,46 +2792,58 @@ namespace wdft
         /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z -= T_over_T_plus_2RC * (wdf.a + z);
+            z -= T_over_T_plus_2RC * (wdf.a - wdf.b);
+            z = denormals::flushState (z);
         }
 
         /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            wdf.b = -z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -(T) (z + Vs);
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
+        T Vs = (T) 0.0;
         T R_value = (T) 1.0e3;
         T C_value = (T) 1.0e-6;
 
         T T_over_T_plus_2RC = (T) 0.0;
 
-        T z = (T) 0.0;
+        StateType z {};
 
         T tt;
     };
 
-    /** WDF Resistor and Capacitor in parallel */
+    /** WDF Current source with a resistor and capacitor in parallel */
     template <typename T>
-    class ResistorCapacitorParallelT final : public BaseWDF
+    class ResistiveCapacitiveCurrentSourceT final : public BaseWDF
     {
     public:
-        /** Creates a new WDF Resistor/Capacitor Parallel.
+        /** Creates a new WDF Resistor/Capacitor/Current Source Parallel.
          * @param res_value: Resistance value in Ohms
          * @param cap_value: Capacitance value in Farads
          * @param fs: WDF sample rate
          */
-        explicit ResistorCapacitorParallelT (T res_value, T cap_value, T fs = (T) 48000.0)
+        explicit ResistiveCapacitiveCurrentSourceT (T res_value, T cap_value, T fs = (T) 48000.0)
             : R_value (res_value),
               C_value (cap_value),
               tt ((T) 1 / fs)
         {
             calcImpedance();
+            reset();
         }
 
         /** Prepares the capacitor to operate at a new sample rate */
@@ -2665,36 +2883,56 @@ namespace wdft
             propagateImpedanceChange();
         }
 
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI)
+        {
+            Is = newI;
+            Rp_Is = wdf.R * Is;
+        }
+
         /** Computes the impedance of the WDF resistor/capacitor combination */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             const auto twoRC = (T) 2.0 * C_value * R_value;
             wdf.R = R_value * tt / (twoRC + tt);
             wdf.G = (T) 1.0 / wdf.R;
             twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
+            Rp_Is = wdf.R * Is;
         }
 
         /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.b + wdf.a - z;
+            z = denormals::flushState (wdf.b + wdf.a - z);
         }
 
         /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            wdf.b = twoRC_over_twoRC_plus_T * z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = twoRC_over_twoRC_plus_T * z + Rp_Is;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
         WDFMembers<T> wdf;
 
     private:
+        T Is = (T) 0.0;
         T R_value = (T) 1.0e3;
         T C_value = (T) 1.0e-6;
 
         T twoRC_over_twoRC_plus_T = (T) 0.0;
+        T Rp_Is = (T) 0.0;
 
         T z = (T) 0.0;
 
@@ -2703,510 +2941,724 @@ namespace wdft
 } // namespace wdft
 } // namespace chowdsp
 
-#endif //CHOWDSP_WDF_WDFT_ONE_PORTS_H
+#endif //CHOWDSP_WDF_WDFT_SOURCES_H
 
-// #include "wdft_sources.h"
-#ifndef CHOWDSP_WDF_WDFT_SOURCES_H
-#define CHOWDSP_WDF_WDFT_SOURCES_H
+// #include "wdft_adaptors.h"
+#ifndef CHOWDSP_WDF_WDFT_ADAPTORS_H
+#define CHOWDSP_WDF_WDFT_ADAPTORS_H
 
 // #include "wdft_base.h"
 
+// #include "../rtype/rtype_detail.h"
+#ifndef CHOWDSP_WDF_RTYPE_DETAIL_H
+#define CHOWDSP_WDF_RTYPE_DETAIL_H
+
+#include <array>
+#include <algorithm>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace chowdsp
 {
+#ifndef DOXYGEN
 namespace wdft
 {
-    /** WDF Ideal Voltage source (non-adaptable) */
-    template <typename T, typename Next>
-    class IdealVoltageSourceT final : public RootWDF
+    /** Utility functions used internally by the R-Type adaptor */
+    namespace rtype_detail
     {
-    public:
-        explicit IdealVoltageSourceT (Next& next)
+        /** Divides two numbers and rounds up if there is a remainder. */
+        template <typename T>
+        constexpr T ceil_div (T num, T den)
         {
-            next.connectToParent (this);
-            calcImpedance();
+            return (num + den - 1) / den;
         }
 
-        void calcImpedance() override {}
-
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV) { Vs = newV; }
-
-        /** Accepts an incident wave into a WDF ideal voltage source. */
-        inline void incident (T x) noexcept
+        template <typename T, size_t base_size>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, size_t>::type array_pad()
         {
-            wdf.a = x;
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = v_type::size;
+            constexpr auto num_simd_registers = ceil_div (base_size, simd_size);
+            return num_simd_registers * simd_size;
+#else
+            return base_size;
+#endif
         }
 
-        /** Propogates a reflected wave from a WDF ideal voltage source. */
-        inline T reflected() noexcept
+        template <typename T, size_t base_size>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, size_t>::type array_pad()
         {
-            wdf.b = -wdf.a + (T) 2.0 * Vs;
-            return wdf.b;
+            return base_size;
         }
 
-        WDFMembers<T> wdf;
-
-    private:
-        T Vs = (T) 0.0;
-    };
-
-    /** WDF Voltage source with series resistance */
-    template <typename T>
-    class ResistiveVoltageSourceT final : public BaseWDF
-    {
-    public:
-        /** Creates a new resistive voltage source.
-         * @param value: initial resistance value, in Ohms
-         */
-        explicit ResistiveVoltageSourceT (T value = NumericType<T> (1.0e-9)) : R_value (value)
+        /** Functions to do a function for each element in the tuple */
+        template <typename Fn, typename Tuple, size_t... Ix>
+        constexpr void forEachInTuple (Fn&& fn, Tuple&& tuple, std::index_sequence<Ix...>) noexcept (noexcept (std::initializer_list<int> { (fn (std::get<Ix> (tuple), Ix), 0)... }))
         {
-            calcImpedance();
+            (void) std::initializer_list<int> { ((void) fn (std::get<Ix> (tuple), Ix), 0)... };
         }
 
-        /** Sets the resistance value of the series resistor, in Ohms. */
-        void setResistanceValue (T newR)
-        {
-            if (all (newR == R_value))
-                return;
-
-            R_value = newR;
-            propagateImpedanceChange();
-        }
+        template <typename T>
+        using TupleIndexSequence = std::make_index_sequence<std::tuple_size<std::remove_cv_t<std::remove_reference_t<T>>>::value>;
 
-        /** Computes the impedance for a WDF resistive voltage souce
-         * Z_Vr = Z_R
-         */
-        inline void calcImpedance() override
+        template <typename Fn, typename Tuple>
+        constexpr void forEachInTuple (Fn&& fn, Tuple&& tuple) noexcept (noexcept (forEachInTuple (std::forward<Fn> (fn), std::forward<Tuple> (tuple), TupleIndexSequence<Tuple> {})))
         {
-            wdf.R = R_value;
-            wdf.G = (T) 1.0 / wdf.R;
+            forEachInTuple (std::forward<Fn> (fn), std::forward<Tuple> (tuple), TupleIndexSequence<Tuple> {});
         }
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV) { Vs = newV; }
-
-        /** Accepts an incident wave into a WDF resistive voltage source. */
-        inline void incident (T x) noexcept
+        template <typename ElementType, int arraySize, int alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT>
+        struct AlignedArray
         {
-            wdf.a = x;
-        }
+            template <typename IntType>
+            ElementType& operator[] (IntType index) noexcept
+            {
+                return array[index];
+            }
+            template <typename IntType>
+            const ElementType& operator[] (IntType index) const noexcept
+            {
+                return array[index];
+            }
 
-        /** Propogates a reflected wave from a WDF resistive voltage source. */
-        inline T reflected() noexcept
-        {
-            wdf.b = Vs;
-            return wdf.b;
-        }
+            ElementType* data() noexcept { return array; }
+            const ElementType* data() const noexcept { return array; }
 
-        WDFMembers<T> wdf;
+            void clear() { std::fill (std::begin (array), std::end (array), ElementType {}); }
+            static constexpr int size() noexcept { return arraySize; }
 
-    private:
-        T Vs = (T) 0.0;
-        T R_value = (T) 1.0e-9;
-    };
+        private:
+            alignas (alignment) ElementType array[array_pad<ElementType, (size_t) arraySize>()] {};
+        };
 
-    /** WDF Voltage source with series capacitance */
-    template <typename T>
-    class CapacitiveVoltageSourceT final : public BaseWDF
-    {
-    public:
-        /** Creates a new resistive voltage source.
-         * @param value: initial resistance value, in Ohms
-         */
-        explicit CapacitiveVoltageSourceT (T value = NumericType<T> (1.0e-6), T fs = (T) 48000)
-            : C_value (value),
-              fs (fs)
+        template <typename T, int nRows, int nCols = nRows, int alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT>
+        using Matrix = AlignedArray<T, nRows, alignment>[(size_t) nCols];
 
+        /** Implementation for float/double. */
+        template <typename T, int numPorts>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_)
         {
-            calcImpedance();
-        }
+            // input matrix (S) of size dim x dim
+            // input vector (a) of size 1 x dim
+            // output vector (b) of size 1 x dim
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
-        {
-            fs = sampleRate;
-            propagateImpedanceChange();
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = (int) v_type::size;
+            constexpr auto vec_size = ceil_div (numPorts, simd_size) * simd_size;
 
-            reset();
-        }
+            for (int c = 0; c < vec_size; c += simd_size)
+            {
+                auto b_vec = a_[0] * xsimd::load_aligned (S_[0].data() + c);
+                for (int r = 1; r < numPorts; ++r)
+                    b_vec = xsimd::fma (xsimd::broadcast (a_[r]), xsimd::load_aligned (S_[r].data() + c), b_vec);
 
-        void reset()
-        {
-            z = (T) 0;
-            v_1 = (T) 0;
+                xsimd::store_aligned (b_.data() + c, b_vec);
+            }
+#else // No SIMD
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+#endif // SIMD options
         }
 
-        /** Sets the capacitance value of the series resistor, in Farads. */
-        void setCapacitanceValue (T newC)
+#if defined(XSIMD_HPP)
+        /** Implementation for SIMD float/double. */
+        template <typename T, int numPorts>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_)
         {
-            if (all (newC == C_value))
-                return;
-
-            C_value = newC;
-            propagateImpedanceChange();
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
         }
+#endif // XSIMD
 
-        /** Computes the impedance of the WDF capacitor,
-         *             1
-         * Z_C = --------------
-         *        2 * f_s * C
-         */
-        inline void calcImpedance() override
+        /** Computes a single output of the scattering matrix: b[outIndex] = sum_r S_[r][outIndex] * a_[r]. */
+        template <typename T, int numPorts>
+        constexpr T RtypeScatterSingle (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, int outIndex)
         {
-            wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
-            wdf.G = (T) 1.0 / wdf.R;
+            T b = S_[0][outIndex] * a_[0];
+            for (int r = 1; r < numPorts; ++r)
+                b += S_[r][outIndex] * a_[r];
+            return b;
         }
+    } // namespace rtype_detail
+} // namespace wdft
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV)
-        {
-            v_0 = newV;
-        }
+namespace wdf
+{
+    /** Utility functions used internally by the R-Type adaptor */
+    namespace rtype_detail
+    {
+        using wdft::rtype_detail::ceil_div;
 
-        /** Accepts an incident wave into a WDF resistive voltage source. */
-        inline void incident (T x) noexcept
-        {
-            wdf.a = x;
-            z = wdf.a;
-        }
+        template <typename Signature>
+        class FunctionRef;
 
-        /** Propogates a reflected wave from a WDF resistive voltage source. */
-        inline T reflected() noexcept
+        /**
+         * A non-owning, non-allocating reference to a callable, similar to std::function,
+         * but without the heap allocation or type-erased copies.
+         *
+         * Function pointers (and lambdas without captures) are stored by value, so they
+         * are always safe to use. Any other callable is stored by reference, so it must
+         * outlive the FunctionRef. To catch the most common mistake, temporary callables
+         * which can't be converted to a function pointer are not accepted.
+         */
+        template <typename R, typename... Args>
+        class FunctionRef<R (Args...)>
         {
-            wdf.b = z + v_0 - v_1;
-            v_1 = v_0;
-            return wdf.b;
-        }
+        public:
+            using FunctionPointer = R (*) (Args...);
 
-        WDFMembers<T> wdf;
+            /** Wraps a function pointer. */
+            FunctionRef (FunctionPointer fn) noexcept : trampoline (&callFunction) { target.function = fn; }
 
-    private:
-        T C_value = (T) 1.0e-6;
+            /** Wraps a lambda without captures (or anything else convertible to a function pointer). */
+            template <typename Fn,
+                      typename = std::enable_if_t<std::is_convertible<Fn&&, FunctionPointer>::value
+                                                  && ! std::is_same<std::decay_t<Fn>, FunctionRef>::value>>
+            FunctionRef (Fn&& fn) noexcept : FunctionRef (static_cast<FunctionPointer> (fn))
+            {
+            }
 
-        T z {};
-        T v_0 {};
-        T v_1 {};
+            /** Wraps a reference to a callable object, which must outlive the FunctionRef. */
+            template <typename Fn,
+                      typename = std::enable_if_t<! std::is_convertible<Fn&, FunctionPointer>::value
+                                                  && ! std::is_same<std::remove_const_t<Fn>, FunctionRef>::value>,
+                      typename = void>
+            FunctionRef (Fn& fn) noexcept : trampoline (&callObject<Fn>)
+            {
+                target.object = (void*) &fn;
+            }
 
-        T fs;
-    };
+            R operator() (Args... args) const
+            {
+                return trampoline (target, std::forward<Args> (args)...);
+            }
 
-    /** WDF Current source (non-adaptable) */
-    template <typename T, typename Next>
-    class IdealCurrentSourceT final : public RootWDF
+        private:
+            union Target
+            {
+                void* object;
+                FunctionPointer function;
+            };
+
+            static R callFunction (const Target& target, Args... args)
+            {
+                return target.function (std::forward<Args> (args)...);
+            }
+
+            template <typename Fn>
+            static R callObject (const Target& target, Args... args)
+            {
+                return (*(Fn*) target.object) (std::forward<Args> (args)...);
+            }
+
+            Target target;
+            R (*trampoline) (const Target&, Args...);
+        };
+
+        template <typename T>
+        typename std::enable_if<std::is_floating_point<T>::value, size_t>::type array_pad (size_t base_size)
+        {
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = v_type::size;
+            const auto num_simd_registers = ceil_div (base_size, simd_size);
+            return num_simd_registers * simd_size;
+#else
+            return base_size;
+#endif
+        }
+
+        template <typename T>
+        typename std::enable_if<! std::is_floating_point<T>::value, size_t>::type array_pad (size_t base_size)
+        {
+            return base_size;
+        }
+
+        template <typename ElementType>
+        struct AlignedArray
+        {
+            explicit AlignedArray (size_t size) : m_size ((int) size),
+                                                  vector (array_pad<ElementType> (size), ElementType {})
+            {
+            }
+
+            ElementType& operator[] (int index) noexcept { return vector[index]; }
+            const ElementType& operator[] (int index) const noexcept { return vector[index]; }
+
+            ElementType* data() noexcept { return vector.data(); }
+            const ElementType* data() const noexcept { return vector.data(); }
+
+            void clear() { std::fill (std::begin (vector), std::end (vector), ElementType {}); }
+            int size() const noexcept { return (int) m_size; }
+
+        private:
+            const int m_size;
+#if defined(XSIMD_HPP)
+            std::vector<ElementType, xsimd::default_allocator<ElementType>> vector;
+#else
+            std::vector<ElementType> vector;
+#endif
+        };
+
+        template <typename ElementType>
+        struct Matrix
+        {
+            Matrix (size_t nRows, size_t nCols) : vector (nCols, AlignedArray<ElementType> (nRows))
+            {
+            }
+
+            AlignedArray<ElementType>& operator[] (int index) noexcept { return vector[(size_t) index]; }
+            const AlignedArray<ElementType>& operator[] (int index) const noexcept { return vector[(size_t) index]; }
+
+        private:
+            std::vector<AlignedArray<ElementType>> vector;
+        };
+
+        /** Implementation for float/double. */
+        template <typename T>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T>& S_, const AlignedArray<T>& a_, AlignedArray<T>& b_)
+        {
+            // input matrix (S) of size dim x dim
+            // input vector (a) of size 1 x dim
+            // output vector (b) of size 1 x dim
+
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = (int) v_type::size;
+            const auto numPorts = a_.size();
+            const auto vec_size = ceil_div (numPorts, simd_size) * simd_size;
+
+            for (int c = 0; c < vec_size; c += simd_size)
+            {
+                auto b_vec = a_[0] * xsimd::load_aligned (S_[0].data() + c);
+                for (int r = 1; r < numPorts; ++r)
+                    b_vec = xsimd::fma (xsimd::broadcast (a_[r]), xsimd::load_aligned (S_[r].data() + c), b_vec);
+
+                xsimd::store_aligned (b_.data() + c, b_vec);
+            }
+#else // No SIMD
+            const auto numPorts = a_.size();
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+#endif // SIMD options
+        }
+
+#if defined(XSIMD_HPP)
+        /** Implementation for SIMD float/double. */
+        template <typename T>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T>& S_, const AlignedArray<T>& a_, AlignedArray<T>& b_)
+        {
+            const auto numPorts = a_.size();
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+        }
+#endif // XSIMD
+
+        /** Computes a single output of the scattering matrix: b[outIndex] = sum_r S_[r][outIndex] * a_[r]. */
+        template <typename T>
+        T RtypeScatterSingle (const Matrix<T>& S_, const AlignedArray<T>& a_, int outIndex)
+        {
+            const auto numPorts = a_.size();
+            T b = S_[0][outIndex] * a_[0];
+            for (int r = 1; r < numPorts; ++r)
+                b += S_[r][outIndex] * a_[r];
+            return b;
+        }
+    } // namespace rtype_detail
+} // namespace wdf
+#endif // DOXYGEN
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_RTYPE_DETAIL_H
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** WDF 3-port parallel adaptor */
+    template <typename T, typename Port1Type, typename Port2Type>
+    class WDFParallelT final : public BaseWDF
     {
     public:
-        explicit IdealCurrentSourceT (Next& n) : next (n)
+        /** Creates a new WDF parallel adaptor from two connected ports. */
+        WDFParallelT (Port1Type& p1, Port2Type& p2) : port1 (p1),
+                                                      port2 (p2)
         {
-            n.connectToParent (this);
+            port1.connectToParent (this);
+            port2.connectToParent (this);
             calcImpedance();
         }
 
+        /** Computes the impedance for a WDF parallel adaptor.
+         *  1     1     1
+         * --- = --- + ---
+         * Z_p   Z_1   Z_2
+         */
         inline void calcImpedance() override
         {
-            twoR = (T) 2.0 * next.wdf.R;
-            twoR_Is = twoR * Is;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.G = port1.wdf.G + port2.wdf.G;
+            wdf.R = (T) 1.0 / wdf.G;
+            port1Reflect.set (port1.wdf.G / wdf.G);
         }
 
-        /** Sets the current of the current source, in Amps */
-        void setCurrent (T newI)
+        /** Returns the adaptor impedance at compile-time, if both ports have fixed impedances. */
+        template <bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value,
+                  std::enable_if_t<isFixed, int> = 0>
+        static constexpr double getFixedImpedance() noexcept
         {
-            Is = newI;
-            twoR_Is = twoR * Is;
+            return (Port1Type::getFixedImpedance() * Port2Type::getFixedImpedance())
+                   / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance());
         }
 
-        /** Accepts an incident wave into a WDF ideal current source. */
+        /** Accepts an incident wave into a WDF parallel adaptor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto b2 = wdf.b - port2.wdf.b + x;
+            port1.incident (b2 + bDiff);
+            port2.incident (b2);
+
             wdf.a = x;
         }
 
-        /** Propogates a reflected wave from a WDF ideal current source. */
+        /** Propogates a reflected wave from a WDF parallel adaptor. */
         inline T reflected() noexcept
         {
-            wdf.b = twoR_Is + wdf.a;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            port1.reflected();
+            port2.reflected();
+
+            bDiff = port2.wdf.b - port1.wdf.b;
+            wdf.b = port2.wdf.b - port1Reflect.get() * bDiff;
+
             return wdf.b;
         }
 
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+            fn (port2);
+        }
+
+        Port1Type& port1;
+        Port2Type& port2;
+
         WDFMembers<T> wdf;
 
     private:
-        const Next& next;
+        /** G_1 / (G_1 + G_2), for fixed port impedances */
+        struct FixedPort1Reflect
+        {
+            static constexpr bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value;
+            static constexpr double value() noexcept { return Port2Type::getFixedImpedance() / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance()); }
+        };
 
-        T Is = (T) 0.0;
-        T twoR;
-        T twoR_Is;
+        fixed_detail::Coefficient<T, FixedPort1Reflect> port1Reflect;
+        T bDiff = (T) 0.0;
     };
 
-    /** WDF Current source with parallel resistance */
-    template <typename T>
-    class ResistiveCurrentSourceT final : public BaseWDF
+    /** WDF 3-port series adaptor */
+    template <typename T, typename Port1Type, typename Port2Type>
+    class WDFSeriesT final : public BaseWDF
     {
     public:
-        /** Creates a new resistive current source.
-         * @param value: initial resistance value, in Ohms
-         */
-        explicit ResistiveCurrentSourceT (T value = NumericType<T> (1.0e9)) : R_value (value)
+        /** Creates a new WDF series adaptor from two connected ports. */
+        WDFSeriesT (Port1Type& p1, Port2Type& p2) : port1 (p1),
+                                                    port2 (p2)
         {
+            port1.connectToParent (this);
+            port2.connectToParent (this);
             calcImpedance();
         }
 
-        /** Sets the resistance value of the parallel resistor, in Ohms. */
-        void setResistanceValue (T newR)
-        {
-            if (all (newR == R_value))
-                return;
-
-            R_value = newR;
-            propagateImpedanceChange();
-        }
-
-        /** Computes the impedance for a WDF resistive current souce
-         * Z_Ir = Z_R
+        /** Computes the impedance for a WDF parallel adaptor.
+         * Z_s = Z_1 + Z_2
          */
         inline void calcImpedance() override
         {
-            wdf.R = R_value;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = port1.wdf.R + port2.wdf.R;
             wdf.G = (T) 1.0 / wdf.R;
+            port1Reflect.set (port1.wdf.R / wdf.R);
         }
 
-        /** Sets the current of the current source, in Amps */
-        void setCurrent (T newI) { Is = newI; }
+        /** Returns the adaptor impedance at compile-time, if both ports have fixed impedances. */
+        template <bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value,
+                  std::enable_if_t<isFixed, int> = 0>
+        static constexpr double getFixedImpedance() noexcept
+        {
+            return Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance();
+        }
 
-        /** Accepts an incident wave into a WDF resistive current source. */
+        /** Accepts an incident wave into a WDF series adaptor. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto b1 = port1.wdf.b - port1Reflect.get() * (x + port1.wdf.b + port2.wdf.b);
+            port1.incident (b1);
+            port2.incident (-(x + b1));
+
             wdf.a = x;
         }
 
-        /** Propogates a reflected wave from a WDF resistive current source. */
+        /** Propogates a reflected wave from a WDF series adaptor. */
         inline T reflected() noexcept
         {
-            wdf.b = wdf.R * Is;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -(port1.reflected() + port2.reflected());
             return wdf.b;
         }
 
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+            fn (port2);
+        }
+
+        Port1Type& port1;
+        Port2Type& port2;
+
         WDFMembers<T> wdf;
 
     private:
-        T Is = (T) 0.0;
-        T R_value = (T) 1.0e9;
+        /** R_1 / (R_1 + R_2), for fixed port impedances */
+        struct FixedPort1Reflect
+        {
+            static constexpr bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value;
+            static constexpr double value() noexcept { return Port1Type::getFixedImpedance() / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance()); }
+        };
+
+        fixed_detail::Coefficient<T, FixedPort1Reflect> port1Reflect;
     };
 
-    /** WDF Resistor and Capacitor and Voltage source in Series */
-    template <typename T>
-    class ResistiveCapacitiveVoltageSourceT final : public BaseWDF
+    /**
+     * WDF (N+1)-port parallel adaptor.
+     *
+     * Equivalent to a chain of nested WDFParallelT adaptors, but the reflection
+     * coefficients for all of the ports are computed with a single division, and
+     * the waves are scattered to all of the ports at once, rather than one level
+     * of the tree at a time.
+     */
+    template <typename T, typename... PortTypes>
+    class WDFParallelNT final : public BaseWDF
     {
     public:
-        /** Creates a new WDF Resistor/Capacitor Series.
-         * @param cap_value: Resistance value in Ohms
-         * @param res_value: Capacitance value in Farads
-         * @param fs: WDF sample rate
-         */
-        explicit ResistiveCapacitiveVoltageSourceT (T res_value, T cap_value, T fs = (T) 48000.0)
-            : R_value (res_value),
-              C_value (cap_value),
-              tt ((T) 1 / fs)
+        /** Number of ports connected "below" this adaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+        static_assert (numPorts >= 2, "WDFParallelNT needs at least two ports!");
+
+        /** Creates a new WDF parallel adaptor from the connected ports. */
+        explicit WDFParallelNT (PortTypes&... ps) : ports (std::tie (ps...))
         {
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t) { port.connectToParent (this); },
+                                          ports);
             calcImpedance();
-            reset();
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        /** Computes the impedance for a WDF parallel adaptor.
+         *  1     1           1
+         * --- = --- + ... + ---
+         * Z_p   Z_1         Z_N
+         */
+        inline void calcImpedance() override
         {
-            tt = (T) 1 / sampleRate;
-            propagateImpedanceChange();
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { portG[i] = port.wdf.G; },
+                                          ports);
 
-            reset();
-        }
+            wdf.G = portG[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.G += portG[i];
+            wdf.R = (T) 1.0 / wdf.G;
 
-        /** Resets the capacitor state */
-        void reset()
-        {
-            z = 0.0f;
+            for (int i = 0; i < numPorts; ++i)
+                portReflect[i] = portG[i] * wdf.R;
         }
 
-        /** Sets the resistance value of the WDF resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        /** Accepts an incident wave into a WDF parallel adaptor. */
+        inline void incident (T x) noexcept
         {
-            if (all (newR == R_value))
-                return;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto bPlusX = wdf.b + x;
+            for (int i = 0; i < numPorts; ++i)
+                b_vec[i] = bPlusX - a_vec[i];
 
-            R_value = newR;
-            propagateImpedanceChange();
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { port.incident (b_vec[i]); },
+                                          ports);
+
+            wdf.a = x;
         }
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
+        /** Propogates a reflected wave from a WDF parallel adaptor. */
+        inline T reflected() noexcept
         {
-            if (all (newC == C_value))
-                return;
-
-            C_value = newC;
-            propagateImpedanceChange();
-        }
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { a_vec[i] = port.reflected(); },
+                                          ports);
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV) { Vs = newV; }
+            wdf.b = portReflect[0] * a_vec[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.b += portReflect[i] * a_vec[i];
 
-        /** Computes the impedance of the WDF resistor/capacitor combination */
-        inline void calcImpedance() override
-        {
-            wdf.R = tt / ((T) 2.0 * C_value) + R_value;
-            wdf.G = (T) 1.0 / wdf.R;
-            T_over_2RC = tt / ((T) 2 * C_value * R_value);
+            return wdf.b;
         }
 
-        /** Accepts an incident wave into the WDF. */
-        inline void incident (T x) noexcept
+        /** Returns the port connected at the given index. */
+        template <int Index>
+        auto& getPort() noexcept
         {
-            wdf.a = x;
-            z -= T_over_2RC * (wdf.a - wdf.b);
+            return std::get<Index> (ports);
         }
 
-        /** Propogates a reflected wave from the WDF. */
-        inline T reflected() noexcept
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
         {
-            wdf.b = -(z + Vs);
-            return wdf.b;
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          ports);
         }
 
         WDFMembers<T> wdf;
 
     private:
-        T Vs = (T) 0.0;
-        T R_value = (T) 1.0e3;
-        T C_value = (T) 1.0e-6;
-
-        T T_over_2RC = (T) 0.0;
-
-        T z = (T) 0.0;
+        std::tuple<PortTypes&...> ports;
 
-        T tt;
+        rtype_detail::AlignedArray<T, numPorts> portG; // port admittances
+        rtype_detail::AlignedArray<T, numPorts> portReflect; // reflection coefficients
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // waves reflected from the ports
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // waves incident to the ports
     };
-} // namespace wdft
-} // namespace chowdsp
-
-#endif //CHOWDSP_WDF_WDFT_SOURCES_H
-
-// #include "wdft_adaptors.h"
-#ifndef CHOWDSP_WDF_WDFT_ADAPTORS_H
-#define CHOWDSP_WDF_WDFT_ADAPTORS_H
-
-// #include "wdft_base.h"
 
-
-namespace chowdsp
-{
-namespace wdft
-{
-    /** WDF 3-port parallel adaptor */
-    template <typename T, typename Port1Type, typename Port2Type>
-    class WDFParallelT final : public BaseWDF
+    /**
+     * WDF (N+1)-port series adaptor.
+     *
+     * Equivalent to a chain of nested WDFSeriesT adaptors, but the reflection
+     * coefficients for all of the ports are computed with a single division, and
+     * the waves are scattered to all of the ports at once, rather than one level
+     * of the tree at a time.
+     *
+     * Note that all of the ports are connected with the same orientation, whereas in
+     * a chain of WDFSeriesT adaptors, each nested adaptor flips the polarity of the
+     * ports below it.
+     */
+    template <typename T, typename... PortTypes>
+    class WDFSeriesNT final : public BaseWDF
     {
     public:
-        /** Creates a new WDF parallel adaptor from two connected ports. */
-        WDFParallelT (Port1Type& p1, Port2Type& p2) : port1 (p1),
-                                                      port2 (p2)
+        /** Number of ports connected "below" this adaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+        static_assert (numPorts >= 2, "WDFSeriesNT needs at least two ports!");
+
+        /** Creates a new WDF series adaptor from the connected ports. */
+        explicit WDFSeriesNT (PortTypes&... ps) : ports (std::tie (ps...))
         {
-            port1.connectToParent (this);
-            port2.connectToParent (this);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t) { port.connectToParent (this); },
+                                          ports);
             calcImpedance();
         }
 
-        /** Computes the impedance for a WDF parallel adaptor.
-         *  1     1     1
-         * --- = --- + ---
-         * Z_p   Z_1   Z_2
+        /** Computes the impedance for a WDF series adaptor.
+         * Z_s = Z_1 + ... + Z_N
          */
         inline void calcImpedance() override
         {
-            wdf.G = port1.wdf.G + port2.wdf.G;
-            wdf.R = (T) 1.0 / wdf.G;
-            port1Reflect = port1.wdf.G / wdf.G;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { portR[i] = port.wdf.R; },
+                                          ports);
+
+            wdf.R = portR[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.R += portR[i];
+            wdf.G = (T) 1.0 / wdf.R;
+
+            for (int i = 0; i < numPorts; ++i)
+                portReflect[i] = portR[i] * wdf.G;
         }
 
-        /** Accepts an incident wave into a WDF parallel adaptor. */
+        /** Accepts an incident wave into a WDF series adaptor. */
         inline void incident (T x) noexcept
         {
-            const auto b2 = wdf.b - port2.wdf.b + x;
-            port1.incident (b2 + bDiff);
-            port2.incident (b2);
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto waveSum = x - wdf.b; // x + a_1 + ... + a_N
+            for (int i = 0; i < numPorts; ++i)
+                b_vec[i] = a_vec[i] - portReflect[i] * waveSum;
+
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { port.incident (b_vec[i]); },
+                                          ports);
 
             wdf.a = x;
         }
 
-        /** Propogates a reflected wave from a WDF parallel adaptor. */
+        /** Propogates a reflected wave from a WDF series adaptor. */
         inline T reflected() noexcept
         {
-            port1.reflected();
-            port2.reflected();
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { a_vec[i] = port.reflected(); },
+                                          ports);
 
-            bDiff = port2.wdf.b - port1.wdf.b;
-            wdf.b = port2.wdf.b - port1Reflect * bDiff;
+            wdf.b = a_vec[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.b += a_vec[i];
+            wdf.b = -wdf.b;
 
             return wdf.b;
         }
 
-        Port1Type& port1;
-        Port2Type& port2;
-
-        WDFMembers<T> wdf;
-
-    private:
-        T port1Reflect = (T) 1.0;
-        T bDiff = (T) 0.0;
-    };
-
-    /** WDF 3-port series adaptor */
-    template <typename T, typename Port1Type, typename Port2Type>
-    class WDFSeriesT final : public BaseWDF
-    {
-    public:
-        /** Creates a new WDF series adaptor from two connected ports. */
-        WDFSeriesT (Port1Type& p1, Port2Type& p2) : port1 (p1),
-                                                    port2 (p2)
-        {
-            port1.connectToParent (this);
-            port2.connectToParent (this);
-            calcImpedance();
-        }
-
-        /** Computes the impedance for a WDF parallel adaptor.
-         * Z_s = Z_1 + Z_2
-         */
-        inline void calcImpedance() override
-        {
-            wdf.R = port1.wdf.R + port2.wdf.R;
-            wdf.G = (T) 1.0 / wdf.R;
-            port1Reflect = port1.wdf.R / wdf.R;
-        }
-
-        /** Accepts an incident wave into a WDF series adaptor. */
-        inline void incident (T x) noexcept
+        /** Returns the port connected at the given index. */
+        template <int Index>
+        auto& getPort() noexcept
         {
-            const auto b1 = port1.wdf.b - port1Reflect * (x + port1.wdf.b + port2.wdf.b);
-            port1.incident (b1);
-            port2.incident (-(x + b1));
-
-            wdf.a = x;
+            return std::get<Index> (ports);
         }
 
-        /** Propogates a reflected wave from a WDF series adaptor. */
-        inline T reflected() noexcept
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
         {
-            wdf.b = -(port1.reflected() + port2.reflected());
-            return wdf.b;
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          ports);
         }
 
-        Port1Type& port1;
-        Port2Type& port2;
-
         WDFMembers<T> wdf;
 
     private:
-        T port1Reflect = (T) 1.0;
+        std::tuple<PortTypes&...> ports;
+
+        rtype_detail::AlignedArray<T, numPorts> portR; // port impedances
+        rtype_detail::AlignedArray<T, numPorts> portReflect; // reflection coefficients
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // waves reflected from the ports
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // waves incident to the ports
     };
 
     /** WDF Voltage Polarity Inverter */
@@ -3226,6 +3678,7 @@ namespace wdft
          */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             wdf.R = port1.wdf.R;
             wdf.G = (T) 1.0 / wdf.R;
         }
@@ -3233,6 +3686,7 @@ namespace wdft
         /** Accepts an incident wave into a WDF inverter. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
             port1.incident (-x);
         }
@@ -3240,10 +3694,18 @@ namespace wdft
         /** Propogates a reflected wave from a WDF inverter. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = -port1.reflected();
             return wdf.b;
         }
 
+        /** Calls fn for the port connected to this inverter. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -3270,6 +3732,7 @@ namespace wdft
         /** Calculates the impedance of the WDF Y-Parameter */
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
             denominator = y[1][1] + port1.wdf.R * y[0][0] * y[1][1] - port1.wdf.R * y[0][1] * y[1][0];
             wdf.R = (port1.wdf.R * y[0][0] + (T) 1.0) / denominator;
             wdf.G = (T) 1.0 / wdf.R;
@@ -3286,6 +3749,7 @@ namespace wdft
         /** Accepts an incident wave into a WDF Y-Parameter. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
             port1.incident (A * port1.wdf.b + B * x);
         }
@@ -3293,10 +3757,18 @@ namespace wdft
         /** Propogates a reflected wave from a WDF Y-Parameter. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = C * port1.reflected();
             return wdf.b;
         }
 
+        /** Calls fn for the port connected to this Y-Parameter. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -3336,87 +3808,323 @@ namespace wdft
 
 #endif //CHOWDSP_WDF_WDFT_ADAPTORS_H
 
-// #include "wdft_nonlinearities.h"
-#ifndef CHOWDSP_WDF_WDFT_NONLINEARITIES_H
-#define CHOWDSP_WDF_WDFT_NONLINEARITIES_H
-
-#include <cmath>
+// #include "wdft_fusion.h"
+#ifndef CHOWDSP_WDF_WDFT_FUSION_H
+#define CHOWDSP_WDF_WDFT_FUSION_H
 
-// #include "wdft_base.h"
+#include <type_traits>
 
+// #include "wdft_one_ports.h"
 
-// #include "../math/signum.h"
+// #include "wdft_sources.h"
 
 
 namespace chowdsp
 {
-/** Methods for implementing the signum function */
-namespace signum
+namespace wdft
 {
-    /** Signum function to determine the sign of the input. */
-    template <typename T>
-    inline int signum (T val)
+#ifndef DOXYGEN
+    namespace fusion_detail
     {
-        return (T (0) < val) - (val < T (0));
-    }
+        /**
+         * Maps a pair of one-ports connected in series to the fused element
+         * which implements them both. Pairs which can't be fused have no "type".
+         */
+        template <typename T, typename P1Type, typename P2Type>
+        struct FusedSeries
+        {
+        };
 
-#if defined(XSIMD_HPP)
-    /** Signum function to determine the sign of the input. */
-    template <typename T>
-    inline xsimd::batch<T> signum (xsimd::batch<T> val)
-    {
-        using v_type = xsimd::batch<T>;
-        const auto positive = xsimd::select (val > v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
-        const auto negative = xsimd::select (val < v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
-        return positive - negative;
-    }
-#endif
+        /** Same as FusedSeries, but for one-ports connected in parallel. */
+        template <typename T, typename P1Type, typename P2Type>
+        struct FusedParallel
+        {
+        };
 
-} // namespace signum
-} // namespace chowdsp
+        /** Series and parallel connections are symmetric, so the ports may come in either order. */
+        template <typename Fusion>
+        struct SwapPorts
+        {
+            using type = typename Fusion::type;
 
-// #include "../math/omega.h"
-/*
- * Copyright (C) 2019 Stefano D'Angelo
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
- * 
- * NOTE: code has been modified significantly by Jatin Chowdhury
- */
+            template <typename P1Type, typename P2Type>
+            static type make (const P1Type& p1, const P2Type& p2)
+            {
+                return Fusion::make (p2, p1);
+            }
+        };
 
-#ifndef OMEGA_H_INCLUDED
-#define OMEGA_H_INCLUDED
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, CapacitorT<T>>
+        {
+            using type = ResistorCapacitorSeriesT<T>;
 
-#include <algorithm>
-#include <cstdint>
-#include <cstddef>
-// #include "sample_type.h"
+            static type make (const ResistorT<T>& r, const CapacitorT<T>& c)
+            {
+                return type { r.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
 
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, InductorT<T>>
+        {
+            using type = ResistorInductorSeriesT<T>;
 
-namespace chowdsp
-{
-/**
- * Useful approximations for evaluating the Wright Omega function.
- *
- * This approach was devloped by Stefano D'Angelo, and adapted from his
- * original implementation under the MIT license.
- * - Paper: https://www.dafx.de/paper-archive/2019/DAFx2019_paper_5.pdf
+            static type make (const ResistorT<T>& r, const InductorT<T>& l)
+            {
+                return type { r.getResistanceValue(), l.getInductanceValue(), l.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, InductorT<T>, CapacitorT<T>>
+        {
+            using type = InductorCapacitorSeriesT<T>;
+
+            static type make (const InductorT<T>& l, const CapacitorT<T>& c)
+            {
+                return type { l.getInductanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, InductorCapacitorSeriesT<T>>
+        {
+            using type = ResistorInductorCapacitorSeriesT<T>;
+
+            static type make (const ResistorT<T>& r, const InductorCapacitorSeriesT<T>& lc)
+            {
+                return type { r.getResistanceValue(), lc.getInductanceValue(), lc.getCapacitanceValue(), lc.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, ResistorCapacitorParallelT<T>>
+        {
+            using type = CapacitorESRT<T>;
+
+            static type make (const ResistorT<T>& esr, const ResistorCapacitorParallelT<T>& leakyCap)
+            {
+                return type { leakyCap.getCapacitanceValue(), esr.getResistanceValue(), leakyCap.getSampleRate(), leakyCap.getResistanceValue() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistiveVoltageSourceT<T>, CapacitorT<T>>
+        {
+            using type = ResistiveCapacitiveVoltageSourceT<T>;
+
+            static type make (const ResistiveVoltageSourceT<T>& vs, const CapacitorT<T>& c)
+            {
+                type fused { vs.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+                fused.setVoltage (vs.getVoltage());
+                return fused;
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistorT<T>, CapacitorT<T>>
+        {
+            using type = ResistorCapacitorParallelT<T>;
+
+            static type make (const ResistorT<T>& r, const CapacitorT<T>& c)
+            {
+                return type { r.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistorT<T>, InductorT<T>>
+        {
+            using type = ResistorInductorParallelT<T>;
+
+            static type make (const ResistorT<T>& r, const InductorT<T>& l)
+            {
+                return type { r.getResistanceValue(), l.getInductanceValue(), l.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, InductorT<T>, CapacitorT<T>>
+        {
+            using type = InductorCapacitorParallelT<T>;
+
+            static type make (const InductorT<T>& l, const CapacitorT<T>& c)
+            {
+                return type { l.getInductanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistiveCurrentSourceT<T>, CapacitorT<T>>
+        {
+            using type = ResistiveCapacitiveCurrentSourceT<T>;
+
+            static type make (const ResistiveCurrentSourceT<T>& is, const CapacitorT<T>& c)
+            {
+                type fused { is.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+                fused.setCurrent (is.getCurrent());
+                return fused;
+            }
+        };
+
+        // clang-format off
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedSeries<T, InductorT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, InductorT<T>>> {};
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, InductorT<T>> : SwapPorts<FusedSeries<T, InductorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedSeries<T, InductorCapacitorSeriesT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, InductorCapacitorSeriesT<T>>> {};
+        template <typename T> struct FusedSeries<T, ResistorCapacitorParallelT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, ResistorCapacitorParallelT<T>>> {};
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, ResistiveVoltageSourceT<T>> : SwapPorts<FusedSeries<T, ResistiveVoltageSourceT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, ResistorT<T>> : SwapPorts<FusedParallel<T, ResistorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, InductorT<T>, ResistorT<T>> : SwapPorts<FusedParallel<T, ResistorT<T>, InductorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, InductorT<T>> : SwapPorts<FusedParallel<T, InductorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, ResistiveCurrentSourceT<T>> : SwapPorts<FusedParallel<T, ResistiveCurrentSourceT<T>, CapacitorT<T>>> {};
+        // clang-format on
+
+        /** Only temporaries can be fused, since nothing else may be holding a reference to them. */
+        template <typename P1Type, typename P2Type>
+        using EnableIfTemporaries = std::enable_if_t<! std::is_lvalue_reference<P1Type>::value && ! std::is_lvalue_reference<P2Type>::value>;
+    } // namespace fusion_detail
+#endif // DOXYGEN
+
+    /** The fused element which replaces the series connection of P1Type and P2Type. */
+    template <typename T, typename P1Type, typename P2Type>
+    using FusedSeriesT = typename fusion_detail::FusedSeries<T, P1Type, P2Type>::type;
+
+    /** The fused element which replaces the parallel connection of P1Type and P2Type. */
+    template <typename T, typename P1Type, typename P2Type>
+    using FusedParallelT = typename fusion_detail::FusedParallel<T, P1Type, P2Type>::type;
+
+    /**
+     * Factory method for fusing two elements connected in series into a single element.
+     *
+     * When makeSeries() is called with two temporary elements (rather than references to
+     * elements that live elsewhere), the pair is replaced by the equivalent fused element,
+     * chosen at compile-time. Fused elements may be fused again, so that nested factory
+     * calls can collapse a whole sub-tree:
+     * @code
+     * // ResistorInductorCapacitorSeriesT<float>
+     * auto rlc = wdft::makeSeries<float> (wdft::ResistorT<float> { 100.0f },
+     *                                     wdft::makeSeries<float> (wdft::InductorT<float> { 10.0e-3f, fs },
+     *                                                              wdft::CapacitorT<float> { 1.0e-6f, fs }));
+     * rlc.setResistanceValue (220.0f);
+     * @endcode
+     *
+     * The fused element takes its values from the temporary elements, and has the same
+     * setters (setResistanceValue(), setCapacitanceValue(), etc.). Since the temporaries
+     * don't outlive the call, the internal states of the fused element can't be probed
+     * separately. The supported combinations are:
+     *  - Resistor + Capacitor, Resistor + Inductor, Inductor + Capacitor
+     *  - Resistor + (Inductor + Capacitor): ResistorInductorCapacitorSeriesT
+     *  - Resistor + (Capacitor || Resistor): CapacitorESRT
+     *  - ResistiveVoltageSource + Capacitor: ResistiveCapacitiveVoltageSourceT
+     *
+     * Other combinations don't compile, and should use the reference version of makeSeries().
+     */
+    template <typename T, typename P1Type, typename P2Type, typename = fusion_detail::EnableIfTemporaries<P1Type, P2Type>>
+    CHOWDSP_WDF_MAYBE_UNUSED FusedSeriesT<T, std::decay_t<P1Type>, std::decay_t<P2Type>> makeSeries (P1Type&& p1, P2Type&& p2)
+    {
+        return fusion_detail::FusedSeries<T, std::decay_t<P1Type>, std::decay_t<P2Type>>::make (p1, p2);
+    }
+
+    /**
+     * Factory method for fusing two elements connected in parallel into a single element.
+     *
+     * This works the same way as the fusing version of makeSeries(). The supported combinations are:
+     *  - Resistor || Capacitor, Resistor || Inductor, Inductor || Capacitor
+     *  - ResistiveCurrentSource || Capacitor: ResistiveCapacitiveCurrentSourceT
+     */
+    template <typename T, typename P1Type, typename P2Type, typename = fusion_detail::EnableIfTemporaries<P1Type, P2Type>>
+    CHOWDSP_WDF_MAYBE_UNUSED FusedParallelT<T, std::decay_t<P1Type>, std::decay_t<P2Type>> makeParallel (P1Type&& p1, P2Type&& p2)
+    {
+        return fusion_detail::FusedParallel<T, std::decay_t<P1Type>, std::decay_t<P2Type>>::make (p1, p2);
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDFT_FUSION_H
+
+// #include "wdft_nonlinearities.h"
+#ifndef CHOWDSP_WDF_WDFT_NONLINEARITIES_H
+#define CHOWDSP_WDF_WDFT_NONLINEARITIES_H
+
+#include <cmath>
+
+// #include "wdft_base.h"
+
+
+// #include "../math/signum.h"
+
+
+namespace chowdsp
+{
+/** Methods for implementing the signum function */
+namespace signum
+{
+    /** Signum function to determine the sign of the input. */
+    template <typename T>
+    inline int signum (T val)
+    {
+        return (T (0) < val) - (val < T (0));
+    }
+
+#if defined(XSIMD_HPP)
+    /** Signum function to determine the sign of the input. */
+    template <typename T>
+    inline xsimd::batch<T> signum (xsimd::batch<T> val)
+    {
+        using v_type = xsimd::batch<T>;
+        const auto positive = xsimd::select (val > v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
+        const auto negative = xsimd::select (val < v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
+        return positive - negative;
+    }
+#endif
+
+} // namespace signum
+} // namespace chowdsp
+
+// #include "../math/omega.h"
+/*
+ * Copyright (C) 2019 Stefano D'Angelo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * NOTE: code has been modified significantly by Jatin Chowdhury
+ */
+
+#ifndef OMEGA_H_INCLUDED
+#define OMEGA_H_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+// #include "sample_type.h"
+
+
+namespace chowdsp
+{
+/**
+ * Useful approximations for evaluating the Wright Omega function.
+ *
+ * This approach was devloped by Stefano D'Angelo, and adapted from his
+ * original implementation under the MIT license.
+ * - Paper: https://www.dafx.de/paper-archive/2019/DAFx2019_paper_5.pdf
  * - Original Source: https://www.dangelo.audio/dafx2019-omega.html
  */
 namespace Omega
@@ -3762,6 +4470,7 @@ namespace wdft
 
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
 #if defined(XSIMD_HPP)
             using xsimd::log;
 #endif
@@ -3775,16 +4484,25 @@ namespace wdft
         /** Accepts an incident wave into a WDF diode pair. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF diode pair. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             reflectedInternal();
             return wdf.b;
         }
 
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -3819,7 +4537,7 @@ namespace wdft
         T R_Is_overVt;
         T logR_Is_overVt;
 
-        const Next& next;
+        Next& next;
     };
 
     /**
@@ -3856,6 +4574,7 @@ namespace wdft
 
         inline void calcImpedance() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
 #if defined(XSIMD_HPP)
             using xsimd::log;
 #endif
@@ -3869,17 +4588,26 @@ namespace wdft
         /** Accepts an incident wave into a WDF diode. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF diode. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             // See eqn (10) from reference paper
             wdf.b = wdf.a + twoR_Is - twoVt * OmegaProvider::omega (logR_Is_overVt + wdf.a * oneOverVt + R_Is_overVt);
             return wdf.b;
         }
 
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
         WDFMembers<T> wdf;
 
     private:
@@ -3893,7 +4621,7 @@ namespace wdft
         T R_Is_overVt;
         T logR_Is_overVt;
 
-        const Next& next;
+        Next& next;
     };
 
     /** WDF Switch (non-adaptable) */
@@ -3901,12 +4629,12 @@ namespace wdft
     class SwitchT final : public RootWDF
     {
     public:
-        explicit SwitchT (Next& next)
+        explicit SwitchT (Next& n) : next (n)
         {
-            next.connectToParent (this);
+            n.connectToParent (this);
         }
 
-        inline void calcImpedance() override {}
+        inline void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
 
         /** Sets the state of the switch. */
         void setClosed (bool shouldClose) { closed = shouldClose; }
@@ -3914,19 +4642,30 @@ namespace wdft
         /** Accepts an incident wave into a WDF switch. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
         }
 
         /** Propogates a reflected wave from a WDF switch. */
         inline T reflected() noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
             wdf.b = closed ? -wdf.a : wdf.a;
             return wdf.b;
         }
 
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
         WDFMembers<T> wdf;
 
     private:
+        Next& next;
+
         bool closed = true;
     };
 } // namespace wdft
@@ -3937,1559 +4676,2077 @@ namespace wdft
 
 #endif // CHOWDSP_WDF_T_INCLUDED
 
+// #include "wdf/wdf.h"
+#ifndef CHOWDSP_WDF_H_INCLUDED
+#define CHOWDSP_WDF_H_INCLUDED
 
 namespace chowdsp
 {
+/** API for constructing Wave Digital Filters with run-time flexibility */
 namespace wdf
 {
-    /** Wave digital filter base class */
-    template <typename T>
-    class WDF : public wdft::BaseWDF
-    {
-    public:
-        explicit WDF (std::string type) : type (std::move (type)) {}
-        ~WDF() override = default;
+}
 
-        void connectToNode (WDF<T>* p) { wdfParent = p; }
+} // namespace chowdsp
 
-        /** Sub-classes override this function to propagate
-     * an impedance change to the upstream elements in
-     * the WDF tree.
-     */
-        virtual inline void propagateImpedance()
-        {
-            calcImpedance();
+// #include "wdf_one_ports.h"
+#ifndef CHOWDSP_WDF_WDF_ONE_PORTS_H
+#define CHOWDSP_WDF_WDF_ONE_PORTS_H
 
-            if (wdfParent != nullptr)
-                wdfParent->propagateImpedance();
-        }
+// #include "wdf_base.h"
+#ifndef CHOWDSP_WDF_WDF_BASE_H
+#define CHOWDSP_WDF_WDF_BASE_H
 
-        /** Sub-classes override this function to accept an incident wave. */
-        virtual void incident (T x) noexcept = 0;
+#include <string>
+#include <type_traits>
+#include <utility>
 
-        /** Sub-classes override this function to propogate a reflected wave. */
-        virtual T reflected() noexcept = 0;
+// #include "../wdft/wdft.h"
+#ifndef CHOWDSP_WDF_T_INCLUDED
+#define CHOWDSP_WDF_T_INCLUDED
 
-        /** Probe the voltage across this circuit element. */
-        inline T voltage() const noexcept
-        {
-            return (wdf.a + wdf.b) / (T) 2.0;
-        }
+namespace chowdsp
+{
+/** API for constructing Wave Digital Filters with a fixed compile-time architecture */
+namespace wdft
+{
+}
 
-        /**Probe the current through this circuit element. */
-        inline T current() const noexcept
-        {
-            return (wdf.a - wdf.b) / ((T) 2.0 * wdf.R);
-        }
+} // namespace chowdsp
 
-        // These classes need access to a,b
-        template <typename>
-        friend class YParameter;
+// #include "wdft_one_ports.h"
+#ifndef CHOWDSP_WDF_WDFT_ONE_PORTS_H
+#define CHOWDSP_WDF_WDFT_ONE_PORTS_H
 
-        template <typename>
-        friend class WDFParallel;
+#include <ratio>
 
-        template <typename>
-        friend class WDFSeries;
+// #include "wdft_base.h"
+#ifndef CHOWDSP_WDF_WDFT_BASE_H
+#define CHOWDSP_WDF_WDFT_BASE_H
 
-        wdft::WDFMembers<T> wdf;
+#include <type_traits>
 
-    private:
-        const std::string type;
+// #include "../math/sample_type.h"
+#ifndef CHOWDSP_WDF_SAMPLE_TYPE_H
+#define CHOWDSP_WDF_SAMPLE_TYPE_H
 
-        WDF<T>* wdfParent = nullptr;
-    };
+#include <type_traits>
 
-    template <typename T, typename WDFType>
-    class WDFWrapper : public WDF<T>
+#ifndef DOXYGEN
+
+namespace chowdsp
+{
+#if ! (JUCE_MODULE_AVAILABLE_chowdsp_dsp)
+/** Useful structs for determining the internal data type of SIMD types */
+namespace SampleTypeHelpers
+{
+    template <typename T, bool = std::is_floating_point<T>::value>
+    struct ElementType
     {
-    public:
-        template <typename... Args>
-        explicit WDFWrapper (const std::string& name, Args&&... args) : WDF<T> (name),
-                                                                        internalWDF (std::forward<Args> (args)...)
-        {
-            calcImpedance();
-        }
+        using Type = T;
+    };
 
-        /** Computes the impedance of the WDF resistor, Z_R = R. */
-        inline void calcImpedance() override
-        {
-            internalWDF.calcImpedance();
-            this->wdf.R = internalWDF.wdf.R;
-            this->wdf.G = internalWDF.wdf.G;
-        }
+    template <typename T>
+    struct ElementType<T, false>
+    {
+        using Type = typename T::value_type;
+    };
+} // namespace SampleTypeHelpers
+#endif
 
-        /** Accepts an incident wave into a WDF resistor. */
-        inline void incident (T x) noexcept override
+/** Type alias for a SIMD numeric type */
+template <typename T>
+using NumericType = typename SampleTypeHelpers::ElementType<T>::Type;
+
+/** Returns true if all the elements in a SIMD vector are equal */
+inline bool all (bool x)
+{
+    return x;
+}
+
+/** Ternary select operation */
+template <typename T>
+inline T select (bool b, const T& t, const T& f)
+{
+    return b ? t : f;
+}
+} // namespace chowdsp
+
+#endif // DOXYGEN
+
+#endif //CHOWDSP_WDF_SAMPLE_TYPE_H
+
+// #include "../util/instrumentation.h"
+#ifndef CHOWDSP_WDF_INSTRUMENTATION_H
+#define CHOWDSP_WDF_INSTRUMENTATION_H
+
+#include <cstdint>
+
+/**
+ * If CHOWDSP_WDF_INSTRUMENTATION is enabled, every WDF element keeps count of
+ * how many times its impedance has been recomputed, how many impedance changes
+ * have been propagated through it, and how many incident/reflected waves it has
+ * processed. The counts can be retrieved with wdft::getInstrumentationCounters().
+ *
+ * When the option is disabled (the default), the counters are compiled out
+ * completely, so there is no runtime or memory cost.
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_INSTRUMENTATION
+#define CHOWDSP_WDF_INSTRUMENTATION 0
+#endif
+
+/**
+ * If CHOWDSP_WDF_INSTRUMENTATION is enabled, CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+ * can be set to a power of two N, in which case every Nth call to each instrumented
+ * method is timed using the CPU cycle counter (rdtsc on x86, cntvct_el0 on ARM64).
+ * Sampling keeps the overhead of reading the counter low, while still giving a good
+ * estimate of the per-call cost.
+ */
+#ifndef CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+#define CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING 0
+#endif
+
+#if CHOWDSP_WDF_INSTRUMENTATION && CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_CNTVCT 1
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** Instrumentation counts for a single WDF element (see CHOWDSP_WDF_INSTRUMENTATION). */
+    struct InstrumentationCounters
+    {
+        uint64_t calcImpedance = 0; /* number of calls to calcImpedance() */
+        uint64_t propagateImpedanceChange = 0; /* number of impedance changes propagated through this element */
+        uint64_t incident = 0; /* number of calls to incident(), or compute() for R-Type root adaptors */
+        uint64_t reflected = 0; /* number of calls to reflected() */
+
+        /**
+         * Total cycles spent in the sampled calls to incident() and reflected(). Note that for
+         * adaptors this includes the time spent in the connected ports, so the cost of an adaptor
+         * itself is roughly its average cycles, minus the average cycles of its ports.
+         */
+        uint64_t cycles = 0;
+        uint64_t cycleSamples = 0; /* number of calls included in the cycle count */
+
+        /** Returns the average number of cycles per sampled call to incident() or reflected() */
+        double getAverageCycles() const noexcept
         {
-            this->wdf.a = x;
-            internalWDF.incident (x);
+            return cycleSamples == 0 ? 0.0 : (double) cycles / (double) cycleSamples;
         }
 
-        /** Propogates a reflected wave from a WDF resistor. */
-        inline T reflected() noexcept override
+        InstrumentationCounters& operator+= (const InstrumentationCounters& other) noexcept
         {
-            this->wdf.b = internalWDF.reflected();
-            return this->wdf.b;
+            calcImpedance += other.calcImpedance;
+            propagateImpedanceChange += other.propagateImpedanceChange;
+            incident += other.incident;
+            reflected += other.reflected;
+            cycles += other.cycles;
+            cycleSamples += other.cycleSamples;
+            return *this;
         }
-
-    protected:
-        WDFType internalWDF;
     };
 
-    template <typename T, typename WDFType>
-    class WDFRootWrapper : public WDFWrapper<T, WDFType>
+#ifndef DOXYGEN
+    namespace instrumentation_detail
     {
-    public:
-        template <typename Next, typename... Args>
-        WDFRootWrapper (const std::string& name, Next& next, Args&&... args) : WDFWrapper<T, WDFType> (name, std::forward<Args> (args)...)
-        {
-            next.connectToNode (this);
-            calcImpedance();
+#if CHOWDSP_WDF_INSTRUMENTATION && CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+        static_assert ((CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING & (CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING - 1)) == 0,
+                       "The cycle sampling interval must be a power of two!");
+
+        inline uint64_t readCycleCounter() noexcept
+        {
+#if CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC
+            return (uint64_t) __rdtsc();
+#elif CHOWDSP_WDF_INSTRUMENTATION_USE_CNTVCT
+            uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0"
+                         : "=r"(ticks));
+            return ticks;
+#else
+            return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
         }
+#endif
 
-        inline void propagateImpedance() override
+#if CHOWDSP_WDF_INSTRUMENTATION
+        /** Increments a call counter, and (maybe) measures the cycles spent in the current scope. */
+        class ScopedCounter
         {
-            this->calcImpedance();
-        }
+        public:
+            ScopedCounter (uint64_t& callCount, InstrumentationCounters& counters) noexcept
+#if CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+                : sampledCounters ((callCount++ & (CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING - 1)) == 0 ? &counters : nullptr)
+            {
+                if (sampledCounters != nullptr)
+                    startTime = readCycleCounter();
+            }
+#else
+            {
+                callCount++;
+                (void) counters;
+            }
+#endif
 
-        inline void calcImpedance() override
-        {
-            this->internalWDF.calcImpedance();
-        }
-    };
-} // namespace wdf
+#if CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+            ~ScopedCounter() noexcept
+            {
+                if (sampledCounters != nullptr)
+                {
+                    sampledCounters->cycles += readCycleCounter() - startTime;
+                    sampledCounters->cycleSamples++;
+                }
+            }
+
+        private:
+            InstrumentationCounters* sampledCounters;
+            uint64_t startTime = 0;
+#endif
+        };
+#endif
+    } // namespace instrumentation_detail
+#endif // DOXYGEN
+} // namespace wdft
 } // namespace chowdsp
 
-#endif //CHOWDSP_WDF_WDF_BASE_H
+#if CHOWDSP_WDF_INSTRUMENTATION
+/** Counts a call to the given method of the current WDF element */
+#define CHOWDSP_WDF_INSTRUMENT_COUNT(method) (this->instrumentationCounters.method++)
+
+/** Counts a call to the given method of the current WDF element, and samples the time spent in the method */
+#define CHOWDSP_WDF_INSTRUMENT_TIMED(method) \
+    ::chowdsp::wdft::instrumentation_detail::ScopedCounter chowdsp_wdf_instrumentation_scope { this->instrumentationCounters.method, this->instrumentationCounters }
+#else
+#define CHOWDSP_WDF_INSTRUMENT_COUNT(method)
+#define CHOWDSP_WDF_INSTRUMENT_TIMED(method)
+#endif
+
+#endif //CHOWDSP_WDF_INSTRUMENTATION_H
+
+
+#ifndef CHOWDSP_WDF_TRACING
+#define CHOWDSP_WDF_TRACING 0
+#endif
+
+#if CHOWDSP_WDF_TRACING
+// #include "../util/impedance_trace.h"
+#ifndef CHOWDSP_WDF_IMPEDANCE_TRACE_H
+#define CHOWDSP_WDF_IMPEDANCE_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
+/**
+ * If CHOWDSP_WDF_TRACING is enabled, every impedance propagation through the
+ * WDF tree is recorded into the active ImpedanceTracer (if there is one).
+ *
+ * When the option is disabled (the default), the tracing hooks are compiled
+ * out completely, so there is no runtime cost, and this header is not included
+ * by the WDF elements (it can still be included directly, for the tracer classes).
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_TRACING
+#define CHOWDSP_WDF_TRACING 0
+#endif
 
 namespace chowdsp
 {
-namespace wdf
+namespace wdft
 {
-    /** WDF Resistor Node */
-    template <typename T>
-    class Resistor final : public WDFWrapper<T, wdft::ResistorT<T>>
+    class BaseWDF;
+
+    /** A single impedance propagation event, recorded by the ImpedanceTracer. */
+    struct ImpedanceTraceEvent
     {
-    public:
-        /** Creates a new WDF Resistor with a given resistance.
-         * @param value: resistance in Ohms
-         */
-        explicit Resistor (T value) : WDFWrapper<T, wdft::ResistorT<T>> ("Resistor", value)
+        enum class Type : uint8_t
         {
-        }
+            Propagation, /* the element recomputed its impedance, and (maybe) propagated the change to its parent */
+            Deferred, /* the propagation was stopped by a ScopedDeferImpedancePropagation */
+            DeferredCalc, /* the element recomputed its impedance when a ScopedDeferImpedancePropagation went out of scope */
+        };
 
-        /** Sets the resistance value of the WDF resistor, in Ohms. */
-        void setResistanceValue (T newR)
-        {
-            this->internalWDF.setResistanceValue (newR);
-            this->propagateImpedance();
-        }
+        Type type = Type::Propagation;
+        uint32_t depth = 0; /* the number of elements that the change has propagated through before reaching this element */
+        uint64_t propagationId = 0; /* all the events triggered by the same parameter change share an ID */
+        const BaseWDF* element = nullptr; /* the element that this event happened at */
+        const BaseWDF* source = nullptr; /* the element whose impedance change started the propagation */
+        int64_t startNs = 0; /* start time of the event (steady_clock) */
+        int64_t durationNs = 0; /* total duration, including the propagation to the ancestors of this element */
+        int64_t calcImpedanceNs = 0; /* time spent in calcImpedance() for this element */
     };
 
-    /** WDF Capacitor Node */
-    template <typename T>
-    class Capacitor final : public WDFWrapper<T, wdft::CapacitorT<T>>
+    /**
+     * Records impedance propagation events into a lock-free single-producer,
+     * single-consumer ring buffer, so that latency spikes while automating
+     * circuit parameters can be inspected offline.
+     *
+     * The tracer only records events when it is the active tracer and
+     * CHOWDSP_WDF_TRACING is enabled. Parameter changes should come from
+     * one thread at a time (typically the audio thread), while the events
+     * can be read from any other thread.
+     * ```cpp
+     * wdft::ImpedanceTracer tracer { 8192 };
+     * tracer.setElementName (circuit.pot1, "pot1");
+     * wdft::ImpedanceTracer::setActiveTracer (&tracer);
+     *
+     * // ... process and automate the circuit ...
+     *
+     * std::ofstream traceFile { "wdf_trace.json" };
+     * tracer.writeChromeTrace (traceFile); // open in chrome://tracing or https://ui.perfetto.dev
+     * ```
+     */
+    class ImpedanceTracer
     {
     public:
-        /** Creates a new WDF Capacitor.
-         * @param value: Capacitance value in Farads
-         * @param fs: WDF sample rate
-         */
-        explicit Capacitor (T value, T fs = (T) 48000.0) : WDFWrapper<T, wdft::CapacitorT<T>> ("Capacitor", value, fs)
+        /** Creates a tracer which can hold at least the given number of (unread) events. */
+        explicit ImpedanceTracer (size_t minCapacity = 4096)
         {
+            size_t capacity = 2;
+            while (capacity < minCapacity)
+                capacity *= 2;
+            events.resize (capacity);
         }
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
+        ~ImpedanceTracer()
         {
-            this->internalWDF.setCapacitanceValue (newC);
-            this->propagateImpedance();
+            auto* self = this;
+            activeTracer().compare_exchange_strong (self, nullptr);
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        ImpedanceTracer (const ImpedanceTracer&) = delete;
+        ImpedanceTracer& operator= (const ImpedanceTracer&) = delete;
+
+        /** Sets the tracer that will record impedance propagation events (or nullptr to stop tracing). */
+        static void setActiveTracer (ImpedanceTracer* tracer) noexcept
         {
-            this->internalWDF.prepare (sampleRate);
-            this->propagateImpedance();
+            activeTracer().store (tracer, std::memory_order_release);
         }
 
-        /** Resets the capacitor state */
-        void reset()
+        /** Returns the active tracer, or nullptr if tracing is not active. */
+        static ImpedanceTracer* getActiveTracer() noexcept
         {
-            this->internalWDF.reset();
+            return activeTracer().load (std::memory_order_acquire);
         }
-    };
 
-    /** WDF Capacitor Node with alpha transform parameter */
-    template <typename T>
-    class CapacitorAlpha final : public WDFWrapper<T, wdft::CapacitorAlphaT<T>>
-    {
-    public:
-        /** Creates a new WDF Capacitor.
-         * @param value: Capacitance value in Farads
-         * @param fs: WDF sample rate
-         * @param alpha: alpha value to be used for the alpha transform,
-         *               use 0 for Backwards Euler, use 1 for Bilinear Transform.
-         */
-        explicit CapacitorAlpha (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : WDFWrapper<T, wdft::CapacitorAlphaT<T>> ("Capacitor", value, fs, alpha)
+        /** Sets a name to use for an element in the exported trace (not real-time safe). */
+        void setElementName (const BaseWDF& element, std::string name)
         {
+            elementNames[&element] = std::move (name);
         }
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
+        /** Adds an event to the buffer. If the buffer is full, the event is dropped and false is returned. */
+        bool push (const ImpedanceTraceEvent& event) noexcept
         {
-            this->internalWDF.setCapacitanceValue (newC);
-            this->propagateImpedance();
+            const auto writeIndex = writePosition.load (std::memory_order_relaxed);
+            if (writeIndex - readPosition.load (std::memory_order_acquire) >= events.size())
+            {
+                numDroppedEvents.fetch_add (1, std::memory_order_relaxed);
+                return false;
+            }
+
+            events[writeIndex & (events.size() - 1)] = event;
+            writePosition.store (writeIndex + 1, std::memory_order_release);
+            return true;
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        /** Reads the oldest event from the buffer. Returns false if there are no events to read. */
+        bool pop (ImpedanceTraceEvent& event) noexcept
         {
-            this->internalWDF.prepare (sampleRate);
-            this->propagateImpedance();
+            const auto readIndex = readPosition.load (std::memory_order_relaxed);
+            if (readIndex == writePosition.load (std::memory_order_acquire))
+                return false;
+
+            event = events[readIndex & (events.size() - 1)];
+            readPosition.store (readIndex + 1, std::memory_order_release);
+            return true;
         }
 
-        /** Resets the capacitor state */
-        void reset()
+        /** Returns the number of events that were dropped because the buffer was full. */
+        uint64_t getNumDroppedEvents() const noexcept { return numDroppedEvents.load (std::memory_order_relaxed); }
+
+        /**
+         * Reads all the events from the buffer, and writes them out in the Chrome
+         * trace-event JSON format. Propagations are written as "complete" events,
+         * so the propagation through the ancestors of an element appears nested
+         * inside the element's event, and deferred propagations are written as
+         * instant events.
+         */
+        void writeChromeTrace (std::ostream& os)
         {
-            this->internalWDF.reset();
+            os << "{\"traceEvents\":[";
+
+            ImpedanceTraceEvent event;
+            bool isFirstEvent = true;
+            while (pop (event))
+            {
+                if (! isFirstEvent)
+                    os << ",";
+                isFirstEvent = false;
+
+                os << "\n{\"name\":\"" << getEventName (event) << "\",\"cat\":\"wdf\""
+                   << ",\"ph\":\"" << (event.type == ImpedanceTraceEvent::Type::Deferred ? "i\",\"s\":\"t" : "X")
+                   << "\",\"pid\":1,\"tid\":1,\"ts\":" << formatMicroseconds (event.startNs);
+
+                if (event.type != ImpedanceTraceEvent::Type::Deferred)
+                    os << ",\"dur\":" << formatMicroseconds (event.durationNs);
+
+                os << ",\"args\":{\"element\":\"" << escapeJson (getElementName (event.element))
+                   << "\",\"source\":\"" << escapeJson (getElementName (event.source))
+                   << "\",\"depth\":" << event.depth
+                   << ",\"propagation\":" << event.propagationId
+                   << ",\"calcImpedance_us\":" << formatMicroseconds (event.calcImpedanceNs)
+                   << "}}";
+            }
+
+            os << "\n],\"otherData\":{\"droppedEvents\":" << getNumDroppedEvents() << "}}\n";
         }
 
-        /** Sets a new alpha value to use for the alpha transform */
-        void setAlpha (T newAlpha)
+    private:
+        static std::atomic<ImpedanceTracer*>& activeTracer() noexcept
         {
-            this->internalWDF.setAlpha (newAlpha);
-            this->propagateImpedance();
+            static std::atomic<ImpedanceTracer*> tracer { nullptr };
+            return tracer;
         }
-    };
 
-    /** WDF Inductor Node */
-    template <typename T>
-    class Inductor final : public WDFWrapper<T, wdft::InductorT<T>>
-    {
-    public:
-        /** Creates a new WDF Inductor.
-     * @param value: Inductance value in Farads
-     * @param fs: WDF sample rate
-     */
-        explicit Inductor (T value, T fs = (T) 48000.0) : WDFWrapper<T, wdft::InductorT<T>> ("Inductor", value, fs)
+        static const char* getEventName (const ImpedanceTraceEvent& event) noexcept
         {
+            switch (event.type)
+            {
+                case ImpedanceTraceEvent::Type::Deferred:
+                    return "deferred";
+                case ImpedanceTraceEvent::Type::DeferredCalc:
+                    return "deferred calcImpedance";
+                case ImpedanceTraceEvent::Type::Propagation:
+                default:
+                    return "propagateImpedanceChange";
+            }
         }
 
-        /** Sets the inductance value of the WDF inductor, in Henries. */
-        void setInductanceValue (T newL)
+        std::string getElementName (const BaseWDF* element) const
         {
-            this->internalWDF.setInductanceValue (newL);
-            this->propagateImpedance();
+            const auto nameIter = elementNames.find (element);
+            if (nameIter != elementNames.end())
+                return nameIter->second;
+
+            char pointerName[32];
+            std::snprintf (pointerName, sizeof (pointerName), "%p", (const void*) element);
+            return pointerName;
         }
 
-        /** Prepares the inductor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        /** Escapes the characters that can't appear as-is in a JSON string */
+        static std::string escapeJson (const std::string& str)
         {
-            this->internalWDF.prepare (sampleRate);
-            this->propagateImpedance();
+            std::string escaped;
+            escaped.reserve (str.size());
+            for (auto c : str)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    escaped += '\\';
+                    escaped += c;
+                }
+                else if ((unsigned char) c < 0x20)
+                {
+                    char code[8];
+                    std::snprintf (code, sizeof (code), "\\u%04x", (unsigned) c);
+                    escaped += code;
+                }
+                else
+                {
+                    escaped += c;
+                }
+            }
+            return escaped;
         }
 
-        /** Resets the inductor state */
-        void reset()
-        {
-            this->internalWDF.reset();
-        }
-    };
-
-    /** WDF Inductor Node with alpha transform parameter */
-    template <typename T>
-    class InductorAlpha final : public WDFWrapper<T, wdft::InductorAlphaT<T>>
-    {
-    public:
-        /** Creates a new WDF Inductor.
-     * @param value: Inductance value in Farads
-     * @param fs: WDF sample rate
-     * @param alpha: alpha value to be used for the alpha transform,
-     *               use 0 for Backwards Euler, use 1 for Bilinear Transform.
-     */
-        explicit InductorAlpha (T value, T fs = 48000.0, T alpha = 1.0) : WDFWrapper<T, wdft::InductorAlphaT<T>> ("Inductor", value, fs, alpha)
-        {
-        }
-
-        /** Sets the inductance value of the WDF inductor, in Henries. */
-        void setInductanceValue (T newL)
-        {
-            this->internalWDF.setInductanceValue (newL);
-            this->propagateImpedance();
-        }
-
-        /** Prepares the inductor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        static std::string formatMicroseconds (int64_t ns)
         {
-            this->internalWDF.prepare (sampleRate);
-            this->propagateImpedance();
+            char value[32];
+            std::snprintf (value, sizeof (value), "%.3f", (double) ns * 1.0e-3);
+            return value;
         }
 
-        /** Resets the inductor state */
-        void reset()
-        {
-            this->internalWDF.reset();
-        }
+        std::vector<ImpedanceTraceEvent> events;
+        std::atomic<uint64_t> writePosition { 0 };
+        std::atomic<uint64_t> readPosition { 0 };
+        std::atomic<uint64_t> numDroppedEvents { 0 };
 
-        /** Sets a new alpha value to use for the alpha transform */
-        void setAlpha (T newAlpha)
-        {
-            this->internalWDF.setAlpha (newAlpha);
-            this->propagateImpedance();
-        }
+        std::unordered_map<const BaseWDF*, std::string> elementNames;
     };
 
-    /** WDF Resistor/Capacitor Series Node */
-    template <typename T>
-    class ResistorCapacitorSeries final : public WDFWrapper<T, wdft::ResistorCapacitorSeriesT<T>>
+#ifndef DOXYGEN
+    namespace trace_detail
     {
-    public:
-        /** Creates a new WDF Resistor/Capacitor Series node.
-         * @param res_value: resistance in Ohms
-         * @param cap_value: capacitance in Farads
-         */
-        explicit ResistorCapacitorSeries (T res_value, T cap_value)
-            : WDFWrapper<T, wdft::ResistorCapacitorSeriesT<T>> ("Resistor/Capacitor Series", res_value, cap_value)
+        inline int64_t nowNs() noexcept
         {
+            return (int64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
         }
 
-        /** Sets the resistance value of the WDF resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        /** Keeps track of the propagation that is currently running on this thread */
+        struct PropagationContext
         {
-            this->internalWDF.setResistanceValue (newR);
-            this->propagateImpedance();
-        }
+            uint32_t depth = 0;
+            uint64_t nextPropagationId = 0;
+            const BaseWDF* source = nullptr;
+        };
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
+        inline PropagationContext& getPropagationContext() noexcept
         {
-            this->internalWDF.setCapacitanceValue (newC);
-            this->propagateImpedance();
+            static thread_local PropagationContext context;
+            return context;
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        /** Records a propagation event covering the lifetime of this object */
+        class PropagationScope
         {
-            this->internalWDF.prepare (sampleRate);
-            this->propagateImpedance();
-        }
+        public:
+            explicit PropagationScope (const BaseWDF& element, ImpedanceTraceEvent::Type type = ImpedanceTraceEvent::Type::Propagation) noexcept
+                : tracer (ImpedanceTracer::getActiveTracer())
+            {
+                if (tracer == nullptr)
+                    return;
+
+                auto& context = getPropagationContext();
+                if (context.depth == 0)
+                {
+                    context.nextPropagationId++;
+                    context.source = &element;
+                }
+
+                event.type = type;
+                event.depth = context.depth++;
+                event.propagationId = context.nextPropagationId;
+                event.element = &element;
+                event.source = context.source;
+                event.startNs = nowNs();
+            }
 
-        /** Resets the capacitor state */
-        void reset()
-        {
-            this->internalWDF.reset();
-        }
-    };
+            ~PropagationScope() noexcept
+            {
+                if (tracer == nullptr)
+                    return;
 
-    /** WDF Resistor/Capacitor Parallel Node */
-    template <typename T>
-    class ResistorCapacitorParallel final : public WDFWrapper<T, wdft::ResistorCapacitorParallelT<T>>
-    {
-    public:
-        /** Creates a new WDF Resistor/Capacitor Parallel node.
-         * @param res_value: resistance in Ohms
-         * @param cap_value: capacitance in Farads
-         */
-        explicit ResistorCapacitorParallel (T res_value, T cap_value)
-            : WDFWrapper<T, wdft::ResistorCapacitorParallelT<T>> ("Resistor/Capacitor Parallel", res_value, cap_value)
-        {
-        }
+                event.durationNs = nowNs() - event.startNs;
+                getPropagationContext().depth--;
+                tracer->push (event);
+            }
 
-        /** Sets the resistance value of the WDF resistor, in Ohms. */
-        void setResistanceValue (T newR)
-        {
-            this->internalWDF.setResistanceValue (newR);
-            this->propagateImpedance();
-        }
+            /** Call this once the element has finished computing its impedance */
+            void calcImpedanceDone() noexcept
+            {
+                if (tracer != nullptr)
+                    event.calcImpedanceNs = nowNs() - event.startNs;
+            }
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
-        {
-            this->internalWDF.setCapacitanceValue (newC);
-            this->propagateImpedance();
-        }
+        private:
+            ImpedanceTracer* tracer;
+            ImpedanceTraceEvent event;
+        };
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        /** Records that an impedance propagation was stopped at this element */
+        inline void recordDeferredPropagation (const BaseWDF& element) noexcept
         {
-            this->internalWDF.prepare (sampleRate);
-            this->propagateImpedance();
-        }
+            auto* tracer = ImpedanceTracer::getActiveTracer();
+            if (tracer == nullptr)
+                return;
 
-        /** Resets the capacitor state */
-        void reset()
-        {
-            this->internalWDF.reset();
-        }
-    };
-} // namespace wdf
+            auto& context = getPropagationContext();
+            ImpedanceTraceEvent event;
+            event.type = ImpedanceTraceEvent::Type::Deferred;
+            event.depth = context.depth;
+            event.propagationId = context.depth == 0 ? ++context.nextPropagationId : context.nextPropagationId;
+            event.element = &element;
+            event.source = context.depth == 0 ? &element : context.source;
+            event.startNs = nowNs();
+            tracer->push (event);
+        }
+    } // namespace trace_detail
+#endif // DOXYGEN
+} // namespace wdft
 } // namespace chowdsp
 
-#endif //CHOWDSP_WDF_WDF_ONE_PORTS_H
+#if CHOWDSP_WDF_TRACING
+/** Traces an impedance propagation through the current WDF element, until the end of the current scope */
+#define CHOWDSP_WDF_TRACE_PROPAGATION() \
+    ::chowdsp::wdft::trace_detail::PropagationScope chowdsp_wdf_trace_scope { *this }
 
-// #include "wdf_sources.h"
-#ifndef CHOWDSP_WDF_WDF_SOURCES_H
-#define CHOWDSP_WDF_WDF_SOURCES_H
+/** Marks the end of the calcImpedance() call in the current traced propagation */
+#define CHOWDSP_WDF_TRACE_CALC_DONE() chowdsp_wdf_trace_scope.calcImpedanceDone()
 
-// #include "wdf_base.h"
+/** Records that the impedance propagation was deferred at the current WDF element */
+#define CHOWDSP_WDF_TRACE_DEFERRED() ::chowdsp::wdft::trace_detail::recordDeferredPropagation (*this)
 
+/** Traces the deferred impedance calculation of the given WDF element, until the end of the current scope */
+#define CHOWDSP_WDF_TRACE_DEFERRED_CALC(element) \
+    ::chowdsp::wdft::trace_detail::PropagationScope chowdsp_wdf_trace_scope { element, ::chowdsp::wdft::ImpedanceTraceEvent::Type::DeferredCalc }
+#endif
+
+#endif //CHOWDSP_WDF_IMPEDANCE_TRACE_H
+
+#else
+#define CHOWDSP_WDF_TRACE_PROPAGATION()
+#define CHOWDSP_WDF_TRACE_CALC_DONE()
+#define CHOWDSP_WDF_TRACE_DEFERRED()
+#define CHOWDSP_WDF_TRACE_DEFERRED_CALC(element)
+#endif
 
 namespace chowdsp
 {
-namespace wdf
+namespace wdft
 {
-    /** WDF Voltage source with series resistance */
-    template <typename T>
-    class ResistiveVoltageSource final : public WDFWrapper<T, wdft::ResistiveVoltageSourceT<T>>
+    /** Base WDF class for propagating impedance changes between elements */
+    class BaseWDF
     {
     public:
-        /** Creates a new resistive voltage source.
-     * @param value: initial resistance value, in Ohms
-     */
-        explicit ResistiveVoltageSource (T value = (NumericType<T>) 1.0e-9) : WDFWrapper<T, wdft::ResistiveVoltageSourceT<T>> ("Resistive Voltage", value)
+        virtual ~BaseWDF() = default;
+
+        void connectToParent (BaseWDF* p) { parent = p; }
+
+        virtual void calcImpedance() = 0;
+
+        inline virtual void propagateImpedanceChange()
         {
+            if (dontPropagateImpedance)
+            {
+                CHOWDSP_WDF_TRACE_DEFERRED();
+                return; // the impedance propagation is being deferred until later...
+            }
+
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
+            calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
+
+            if (parent != nullptr)
+                parent->propagateImpedanceChange();
         }
 
-        /** Sets the resistance value of the series resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        /**
+         * Calls fn for each port connected "below" this element in the WDF tree.
+         * Elements with connected ports (adaptors and root elements) hide this method.
+         */
+        template <typename Fn>
+        void visitPorts (Fn&&)
         {
-            this->internalWDF.setResistanceValue (newR);
-            this->propagateImpedance();
         }
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV) { this->internalWDF.setVoltage (newV); }
-    };
-
-    /** WDF Ideal Voltage source (non-adaptable) */
-    template <typename T>
-    class IdealVoltageSource final : public WDFWrapper<T, wdft::IdealVoltageSourceT<T, WDF<T>>>
-    {
-    public:
-        explicit IdealVoltageSource (WDF<T>* next) : WDFWrapper<T, wdft::IdealVoltageSourceT<T, WDF<T>>> ("IdealVoltage", *next)
+        /**
+         * Calls visitor with a reference to each of this element's internal
+         * state variables (not including the wdf.a and wdf.b members).
+         * Elements with internal state hide this method.
+         */
+        template <typename Visitor>
+        void visitState (Visitor&&)
         {
-            next->connectToNode (this);
         }
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV) { this->internalWDF.setVoltage (newV); }
+#if CHOWDSP_WDF_INSTRUMENTATION
+        /** Instrumentation counts for this element (see getInstrumentationCounters()). */
+        InstrumentationCounters instrumentationCounters;
+#endif
+
+    protected:
+        BaseWDF* parent = nullptr;
+
+    private:
+        bool dontPropagateImpedance = false;
+
+        template <typename... Elements>
+        friend class ScopedDeferImpedancePropagation;
     };
 
-    /** WDF Current source with parallel resistance */
-    template <typename T>
-    class ResistiveCurrentSource final : public WDFWrapper<T, wdft::ResistiveCurrentSourceT<T>>
+    /** Base class for propagating impedance changes into root WDF elements */
+    class RootWDF : public BaseWDF
     {
     public:
-        /** Creates a new resistive current source.
-     * @param value: initial resistance value, in Ohms
-     */
-        explicit ResistiveCurrentSource (T value = (NumericType<T>) 1.0e9) : WDFWrapper<T, wdft::ResistiveCurrentSourceT<T>> ("Resistive Current", value)
+        inline void propagateImpedanceChange() override
         {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
+            calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
         }
 
-        /** Sets the resistance value of the parallel resistor, in Ohms. */
-        void setResistanceValue (T newR)
-        {
-            this->internalWDF.setResistanceValue (newR);
-            this->propagateImpedance();
-        }
-
-        /** Sets the current of the current source, in Amps */
-        void setCurrent (T newI) { this->internalWDF.setCurrent (newI); }
+    private:
+        // don't try to connect root nodes!
+        void connectToParent (BaseWDF*) {}
     };
 
-    /** WDF Current source (non-adpatable) */
+    /** Helper struct for common WDF member variables */
     template <typename T>
-    class IdealCurrentSource final : public WDFWrapper<T, wdft::IdealCurrentSourceT<T, WDF<T>>>
+    struct WDFMembers
     {
-    public:
-        explicit IdealCurrentSource (WDF<T>* next) : WDFWrapper<T, wdft::IdealCurrentSourceT<T, WDF<T>>> ("Ideal Current", *next)
+        T R = (NumericType<T>) 1.0e-9; /* impedance */
+        T G = (T) 1.0 / R; /* admittance */
+        T a = (T) 0.0; /* incident wave */
+        T b = (T) 0.0; /* reflected wave */
+    };
+
+#ifndef DOXYGEN
+    namespace fixed_detail
+    {
+        template <typename...>
+        using void_t = void;
+
+        /** True if the element's impedance is known at compile-time (see FixedResistorT). */
+        template <typename ElementType, typename = void>
+        struct HasFixedImpedance : std::false_type
         {
-            next->connectToNode (this);
-        }
+        };
 
-        /** Sets the current of the current source, in Amps */
-        void setCurrent (T newI) { this->internalWDF.setCurrent (newI); }
-    };
-} // namespace wdf
-} // namespace chowdsp
+        template <typename ElementType>
+        struct HasFixedImpedance<ElementType, void_t<decltype (ElementType::getFixedImpedance())>> : std::true_type
+        {
+        };
 
-#endif //CHOWDSP_WDF_WDF_SOURCES_H
+        /**
+         * Holds an adaptor coefficient, which is replaced by a compile-time constant
+         * when FixedValue::value() can be computed from fixed port impedances.
+         */
+        template <typename T, typename FixedValue, bool isFixed = FixedValue::isFixed>
+        struct Coefficient
+        {
+            void set (T newValue) noexcept { value = newValue; }
+            T get() const noexcept { return value; }
 
-// #include "wdf_adaptors.h"
-#ifndef CHOWDSP_WDF_WDF_ADAPTORS_H
-#define CHOWDSP_WDF_WDF_ADAPTORS_H
+            T value = (T) 1.0;
+        };
 
-// #include "wdf_base.h"
+        template <typename T, typename FixedValue>
+        struct Coefficient<T, FixedValue, true>
+        {
+            void set (T) noexcept {}
+            static T get() noexcept { return (T) FixedValue::value(); }
+        };
+    } // namespace fixed_detail
+#endif // DOXYGEN
 
+    /**
+     * Calls fn for the given element, and for every element below it in the WDF tree.
+     * Usually this will be called on the root of the tree, to visit the whole circuit.
+     */
+    template <typename ElementType, typename Fn>
+    void forEachElement (ElementType& element, Fn&& fn)
+    {
+        fn (element);
+        element.visitPorts ([&fn] (auto& port) { forEachElement (port, fn); });
+    }
 
-namespace chowdsp
+    /**
+     * Returns the instrumentation counts for this element.
+     * If CHOWDSP_WDF_INSTRUMENTATION is disabled, the counts will always be zero.
+     */
+    inline InstrumentationCounters getInstrumentationCounters (const BaseWDF& element) noexcept
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION
+        return element.instrumentationCounters;
+#else
+        (void) element;
+        return {};
+#endif
+    }
+
+    /** Returns the sum of the instrumentation counts for every element in the circuit. */
+    template <typename RootType>
+    InstrumentationCounters getTotalInstrumentationCounters (RootType& root) noexcept
+    {
+        InstrumentationCounters total {};
+        forEachElement (root, [&total] (auto& element) { total += getInstrumentationCounters (element); });
+        return total;
+    }
+
+    /** Resets the instrumentation counts for every element in the circuit. */
+    template <typename RootType>
+    void resetInstrumentationCounters (RootType& root) noexcept
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION
+        forEachElement (root, [] (auto& element) { element.instrumentationCounters = {}; });
+#else
+        (void) root;
+#endif
+    }
+
+    /** Probe the voltage across this circuit element. */
+    template <typename T, typename WDFType>
+    inline T voltage (const WDFType& wdf) noexcept
+    {
+        return (wdf.wdf.a + wdf.wdf.b) * (T) 0.5;
+    }
+
+    /**Probe the current through this circuit element. */
+    template <typename T, typename WDFType>
+    inline T current (const WDFType& wdf) noexcept
+    {
+        return (wdf.wdf.a - wdf.wdf.b) * ((T) 0.5 * wdf.wdf.G);
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif // CHOWDSP_WDF_WDFT_BASE_H
+
+// #include "../math/compensated_float.h"
+#ifndef CHOWDSP_WDF_COMPENSATED_FLOAT_H
+#define CHOWDSP_WDF_COMPENSATED_FLOAT_H
+
+namespace chowdsp
 {
-namespace wdf
+/**
+ * A floating-point accumulator which tracks the rounding error of its running sum
+ * in a second "low" word (i.e. Kahan/TwoSum compensated summation). This gives
+ * close to double-word precision for state variables that integrate many small
+ * increments, while only using operations that are available for SIMD types.
+ *
+ * This type is intended to be used as the StateType for the WDF elements that
+ * support a mixed-precision state (e.g. `wdft::ResistorCapacitorSeriesT<float, CompensatedFloat<float>>`).
+ *
+ * Note that compensated arithmetic relies on strict IEEE semantics, so it will not work
+ * correctly if the code is compiled with `-ffast-math` or similar re-association flags.
+ */
+template <typename T>
+struct CompensatedFloat
 {
-    /** WDF Voltage Polarity Inverter */
+    CompensatedFloat() = default;
+    explicit CompensatedFloat (T value) : hi (value) {}
+
+    /** Returns the value of the accumulator, rounded to the underlying type. */
+    explicit operator T() const noexcept { return hi + lo; }
+
+    CompensatedFloat& operator+= (T x) noexcept
+    {
+        T err;
+        const auto sum = twoSum (hi, x, err);
+        normalise (sum, lo + err);
+        return *this;
+    }
+
+    CompensatedFloat& operator-= (T x) noexcept
+    {
+        return *this += -x;
+    }
+
+    CompensatedFloat& operator+= (const CompensatedFloat& other) noexcept
+    {
+        T err;
+        const auto sum = twoSum (hi, other.hi, err);
+        normalise (sum, err + (lo + other.lo));
+        return *this;
+    }
+
+    CompensatedFloat& operator-= (const CompensatedFloat& other) noexcept
+    {
+        return *this += -other;
+    }
+
+    CompensatedFloat operator-() const noexcept
+    {
+        CompensatedFloat result;
+        result.hi = -hi;
+        result.lo = -lo;
+        return result;
+    }
+
+    /** Scales the accumulator by a (non-compensated) coefficient. */
+    friend inline CompensatedFloat operator* (T k, const CompensatedFloat& x) noexcept
+    {
+        CompensatedFloat result;
+        result.normalise (k * x.hi, k * x.lo);
+        return result;
+    }
+
+    friend inline CompensatedFloat operator+ (CompensatedFloat x, T y) noexcept { return x += y; }
+    friend inline CompensatedFloat operator+ (T x, CompensatedFloat y) noexcept { return y += x; }
+    friend inline CompensatedFloat operator- (CompensatedFloat x, T y) noexcept { return x -= y; }
+
+    T hi {}; /* high word (the rounded running value) */
+    T lo {}; /* low word (the accumulated rounding error) */
+
+private:
+    /** Error-free sum: returns fl(a + b) and stores the rounding error in err. */
+    static inline T twoSum (T a, T b, T& err) noexcept
+    {
+        const auto s = a + b;
+        const auto bb = s - a;
+        err = (a - (s - bb)) + (b - bb);
+        return s;
+    }
+
+    inline void normalise (T sum, T err) noexcept
+    {
+        hi = sum + err;
+        lo = err - (hi - sum);
+    }
+};
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_COMPENSATED_FLOAT_H
+
+// #include "../math/denormals.h"
+#ifndef CHOWDSP_WDF_DENORMALS_H
+#define CHOWDSP_WDF_DENORMALS_H
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+// #include "compensated_float.h"
+
+
+/**
+ * If CHOWDSP_WDF_FLUSH_DENORMALS is enabled, the reactive WDF elements will
+ * flush their internal states to zero whenever those states become denormal.
+ * This costs a compare and select per state write, but protects against
+ * denormal CPU spikes even when the caller has not set the FTZ/DAZ flags.
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_FLUSH_DENORMALS
+#define CHOWDSP_WDF_FLUSH_DENORMALS 0
+#endif
+
+namespace chowdsp
+{
+/** Methods for dealing with denormal numbers */
+namespace denormals
+{
+    /** Returns zero if the input is denormal, otherwise returns the input. */
     template <typename T>
-    class PolarityInverter final : public WDFWrapper<T, wdft::PolarityInverterT<T, WDF<T>>>
+    inline typename std::enable_if<std::is_floating_point<T>::value, T>::type
+        flush (T x) noexcept
     {
-    public:
-        /** Creates a new WDF polarity inverter
-         * @param port1: the port to connect to the inverter
-         */
-        explicit PolarityInverter (WDF<T>* port1) : WDFWrapper<T, wdft::PolarityInverterT<T, WDF<T>>> ("Polarity Inverter", *port1)
-        {
-            port1->connectToNode (this);
-        }
-    };
+        return std::abs (x) < std::numeric_limits<T>::min() ? (T) 0 : x;
+    }
 
-    /** WDF y-parameter 2-port (short circuit admittance) */
+#if defined(XSIMD_HPP)
+    /** Returns zero for any denormal elements of the input. */
     template <typename T>
-    class YParameter final : public WDFWrapper<T, wdft::YParameterT<T, WDF<T>>>
+    inline xsimd::batch<T> flush (xsimd::batch<T> x) noexcept
     {
-    public:
-        YParameter (WDF<T>* port1, T y11, T y12, T y21, T y22) : WDFWrapper<T, wdft::YParameterT<T, WDF<T>>> ("YParameter", *port1, y11, y12, y21, y22)
-        {
-            port1->connectToNode (this);
-        }
-    };
+        using v_type = xsimd::batch<T>;
+        return xsimd::select (xsimd::abs (x) < v_type (std::numeric_limits<T>::min()), v_type ((T) 0), x);
+    }
+#endif
 
-    /** WDF 3-port parallel adaptor */
+    /** Flushes both words of a compensated accumulator. */
     template <typename T>
-    class WDFParallel final : public WDFWrapper<T, wdft::WDFParallelT<T, WDF<T>, WDF<T>>>
+    inline CompensatedFloat<T> flush (CompensatedFloat<T> x) noexcept
     {
-    public:
-        /** Creates a new WDF parallel adaptor from two connected ports. */
-        WDFParallel (WDF<T>* port1, WDF<T>* port2) : WDFWrapper<T, wdft::WDFParallelT<T, WDF<T>, WDF<T>>> ("Parallel", *port1, *port2)
-        {
-            port1->connectToNode (this);
-            port2->connectToNode (this);
-        }
-    };
+        x.hi = flush (x.hi);
+        x.lo = flush (x.lo);
+        return x;
+    }
 
-    /** WDF 3-port series adaptor */
+    /**
+     * Used by the WDF elements when writing their internal state.
+     * Flushes denormals if CHOWDSP_WDF_FLUSH_DENORMALS is enabled, otherwise does nothing.
+     */
     template <typename T>
-    class WDFSeries final : public WDFWrapper<T, wdft::WDFSeriesT<T, WDF<T>, WDF<T>>>
+    inline T flushState (T x) noexcept
     {
-    public:
-        /** Creates a new WDF series adaptor from two connected ports. */
-        WDFSeries (WDF<T>* port1, WDF<T>* port2) : WDFWrapper<T, wdft::WDFSeriesT<T, WDF<T>, WDF<T>>> ("Series", *port1, *port2)
-        {
-            port1->connectToNode (this);
-            port2->connectToNode (this);
-        }
-    };
-} // namespace wdf
+#if CHOWDSP_WDF_FLUSH_DENORMALS
+        return flush (x);
+#else
+        return x;
+#endif
+    }
+} // namespace denormals
 } // namespace chowdsp
 
-#endif //CHOWDSP_WDF_WDF_ADAPTORS_H
-
-// #include "wdf_nonlinearities.h"
-#ifndef CHOWDSP_WDF_WDF_NONLINEARITIES_H
-#define CHOWDSP_WDF_WDF_NONLINEARITIES_H
-
-// #include "wdf_base.h"
+#endif //CHOWDSP_WDF_DENORMALS_H
 
 
 namespace chowdsp
 {
-namespace wdf
+namespace wdft
 {
-    /** WDF Switch (non-adaptable) */
+    /** WDF Resistor Node */
     template <typename T>
-    class Switch final : public WDFWrapper<T, wdft::SwitchT<T, WDF<T>>>
+    class ResistorT final : public BaseWDF
     {
     public:
-        explicit Switch (WDF<T>* next) : WDFWrapper<T, wdft::SwitchT<T, WDF<T>>> ("Switch", *next)
+        /** Creates a new WDF Resistor with a given resistance.
+         * @param value: resistance in Ohms
+         */
+        explicit ResistorT (T value) : R_value (value)
         {
-            next->connectToNode (this);
+            calcImpedance();
         }
 
-        /** Sets the state of the switch. */
-        void setClosed (bool shouldClose)
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
         {
-            this->internalWDF.setClosed (shouldClose);
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
         }
-    };
 
-    /** WDF Open circuit (non-adaptable) */
-    template <typename T>
-    class Open final : public WDF<T>
-    {
-    public:
-        Open() : WDF<T> ("Open")
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
+        /** Computes the impedance of the WDF resistor, Z_R = R. */
+        inline void calcImpedance() override
         {
-            this->wdf.R = (T) 1.0e15;
-            this->wdf.G = (T) 1.0 / this->wdf.R;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = R_value;
+            wdf.G = (T) 1.0 / wdf.R;
         }
 
-        inline void calcImpedance() override {}
-
-        /** Accepts an incident wave into a WDF open. */
-        inline void incident (T x) noexcept override
+        /** Accepts an incident wave into a WDF resistor. */
+        inline void incident (T x) noexcept
         {
-            this->wdf.a = x;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
         }
 
-        /** Propogates a reflected wave from a WDF open. */
-        inline T reflected() noexcept override
+        /** Propogates a reflected wave from a WDF resistor. */
+        inline T reflected() noexcept
         {
-            this->wdf.b = this->wdf.a;
-            return this->wdf.b;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = 0.0;
+            return wdf.b;
         }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e-9;
     };
 
-    /** WDF Short circuit (non-adaptable) */
-    template <typename T>
-    class Short final : public WDF<T>
+    /**
+     * WDF Resistor Node, with a resistance that is fixed at compile-time.
+     *
+     * The resistance is given in Ohms as a std::ratio, e.g. FixedResistorT<float, std::ratio<4700>>
+     * or FixedResistorT<float, std::ratio<22, 10>> for 2.2 Ohms. When both ports of a WDFSeriesT or
+     * WDFParallelT adaptor have fixed impedances, the adaptor's reflection coefficient becomes a
+     * compile-time constant, and the adaptor's impedance is fixed as well, so whole sub-trees of
+     * fixed resistors fold into constants.
+     */
+    template <typename T, typename ResistanceRatio>
+    class FixedResistorT final : public BaseWDF
     {
     public:
-        Short() : WDF<T> ("Short")
+        FixedResistorT()
         {
-            this->wdf.R = (T) 1.0e-15;
-            this->wdf.G = (T) 1.0 / this->wdf.R;
+            calcImpedance();
         }
 
-        inline void calcImpedance() override {}
-
-        /** Accepts an incident wave into a WDF short. */
-        inline void incident (T x) noexcept override
+        /** Returns the resistance value, in Ohms, at compile-time. */
+        static constexpr double getFixedImpedance() noexcept
         {
-            this->wdf.a = x;
+            return (double) ResistanceRatio::num / (double) ResistanceRatio::den;
         }
 
-        /** Propogates a reflected wave from a WDF short. */
-        inline T reflected() noexcept override
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return (T) getFixedImpedance(); }
+
+        /** Computes the impedance of the WDF resistor, Z_R = R. */
+        inline void calcImpedance() override
         {
-            this->wdf.b = -this->wdf.a;
-            return this->wdf.b;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) getFixedImpedance();
+            wdf.G = (T) (1.0 / getFixedImpedance());
         }
-    };
 
-    /**
-     * WDF diode pair (non-adaptable)
-     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
-     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
-     */
-    template <typename T, wdft::DiodeQuality Q = wdft::DiodeQuality::Best>
-    class DiodePair final : public WDFRootWrapper<T, wdft::DiodePairT<T, WDF<T>, Q>>
-    {
-    public:
-        /**
-         * Creates a new WDF diode pair, with the given diode specifications.
-         * @param next: the next element in the WDF connection tree
-         * @param Is: reverse saturation current
-         * @param Vt: thermal voltage
-         * @param nDiodes: the number of series diodes
-         */
-        DiodePair (WDF<T>* next, T Is, T Vt = (NumericType<T>) 25.85e-3, T nDiodes = (T) 1) : WDFRootWrapper<T, wdft::DiodePairT<T, WDF<T>, Q>> ("DiodePair", *next, *next, Is, Vt, nDiodes)
+        /** Accepts an incident wave into a WDF resistor. */
+        inline void incident (T x) noexcept
         {
-            next->connectToNode (this);
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
         }
 
-        /** Sets diode specific parameters */
-        void setDiodeParameters (T newIs, T newVt, T nDiodes)
+        /** Propogates a reflected wave from a WDF resistor. */
+        inline T reflected() noexcept
         {
-            this->internalWDF.setDiodeParameters (newIs, newVt, nDiodes);
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = 0.0;
+            return wdf.b;
         }
+
+        WDFMembers<T> wdf;
     };
 
-    /**
-     * WDF diode (non-adaptable)
-     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
-     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
-     */
+    /** WDF Capacitor Node */
     template <typename T>
-    class Diode final : public WDFRootWrapper<T, wdft::DiodeT<T, WDF<T>>>
+    class CapacitorT final : public BaseWDF
     {
     public:
-        /**
-         * Creates a new WDF diode, with the given diode specifications.
-         * @param next: the next element in the WDF connection tree
-         * @param Is: reverse saturation current
-         * @param Vt: thermal voltage
-         * @param nDiodes: the number of series diodes
+        /** Creates a new WDF Capacitor.
+         * @param value: Capacitance value in Farads
+         * @param _fs: WDF sample rate
          */
-        Diode (WDF<T>* next, T Is, T Vt = (NumericType<T>) 25.85e-3, T nDiodes = 1) : WDFRootWrapper<T, wdft::DiodeT<T, WDF<T>>> ("Diode", *next, *next, Is, Vt, nDiodes)
+        explicit CapacitorT (T value, T _fs = (T) 48000.0) : C_value (value),
+                                                             fs (_fs)
         {
-            next->connectToNode (this);
+            calcImpedance();
         }
 
-        /** Sets diode specific parameters */
-        void setDiodeParameters (T newIs, T newVt, T nDiodes)
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
         {
-            this->internalWDF.setDiodeParameters (newIs, newVt, nDiodes);
+            fs = sampleRate;
+            propagateImpedanceChange();
+
+            reset();
         }
-    };
-} // namespace wdf
-} // namespace chowdsp
 
-#endif //CHOWDSP_WDF_WDF_NONLINEARITIES_H
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+        }
 
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
 
-#endif // CHOWDSP_WDF_H_INCLUDED
+            C_value = newC;
+            propagateImpedanceChange();
+        }
 
-// #include "rtype/rtype.h"
-#ifndef CHOWDSP_WDF_RTYPE_H_INCLUDED
-#define CHOWDSP_WDF_RTYPE_H_INCLUDED
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
 
-// #include "rtype_adaptor.h"
-#ifndef CHOWDSP_WDF_RTYPE_ADAPTOR_H
-#define CHOWDSP_WDF_RTYPE_ADAPTOR_H
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return fs; }
 
-// #include "../wdft/wdft_base.h"
-#ifndef CHOWDSP_WDF_WDFT_BASE_H
-#define CHOWDSP_WDF_WDFT_BASE_H
+        /** Computes the impedance of the WDF capacitor,
+         *             1
+         * Z_C = --------------
+         *        2 * f_s * C
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
+            wdf.G = (T) 1.0 / wdf.R;
+        }
 
-// #include "../math/sample_type.h"
-#ifndef CHOWDSP_WDF_SAMPLE_TYPE_H
-#define CHOWDSP_WDF_SAMPLE_TYPE_H
+        /** Accepts an incident wave into a WDF capacitor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.a);
+        }
 
-#include <type_traits>
+        /** Propogates a reflected wave from a WDF capacitor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = z;
+            return wdf.b;
+        }
 
-#ifndef DOXYGEN
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
 
-namespace chowdsp
-{
-#if ! (JUCE_MODULE_AVAILABLE_chowdsp_dsp)
-/** Useful structs for determining the internal data type of SIMD types */
-namespace SampleTypeHelpers
-{
-    template <typename T, bool = std::is_floating_point<T>::value>
-    struct ElementType
-    {
-        using Type = T;
+        WDFMembers<T> wdf;
+
+    private:
+        T C_value = (T) 1.0e-6;
+        T z = (T) 0.0;
+
+        T fs;
     };
 
+    /** WDF Capacitor Node with alpha transform parameter */
     template <typename T>
-    struct ElementType<T, false>
+    class CapacitorAlphaT final : public BaseWDF
     {
-        using Type = typename T::value_type;
-    };
-} // namespace SampleTypeHelpers
-#endif
-
-/** Type alias for a SIMD numeric type */
-template <typename T>
-using NumericType = typename SampleTypeHelpers::ElementType<T>::Type;
+    public:
+        /** Creates a new WDF Capacitor.
+         * @param value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         * @param alpha: alpha value to be used for the alpha transform,
+         *             use 0 for Backwards Euler, use 1 for Bilinear Transform.
+         */
+        explicit CapacitorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : C_value (value),
+                                                                                    fs (fs),
+                                                                                    alpha (alpha),
+                                                                                    b_coef (((T) 1.0 - alpha) / (T) 2.0),
+                                                                                    a_coef (((T) 1.0 + alpha) / (T) 2.0)
+        {
+            calcImpedance();
+        }
 
-/** Returns true if all the elements in a SIMD vector are equal */
-inline bool all (bool x)
-{
-    return x;
-}
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            fs = sampleRate;
+            propagateImpedanceChange();
 
-/** Ternary select operation */
-template <typename T>
-inline T select (bool b, const T& t, const T& f)
-{
-    return b ? t : f;
-}
-} // namespace chowdsp
+            reset();
+        }
 
-#endif // DOXYGEN
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+        }
 
-#endif //CHOWDSP_WDF_SAMPLE_TYPE_H
+        /** Sets a new alpha value to use for the alpha transform */
+        void setAlpha (T newAlpha)
+        {
+            alpha = newAlpha;
+            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
+            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
 
+            propagateImpedanceChange();
+        }
 
-namespace chowdsp
-{
-namespace wdft
-{
-    /** Base WDF class for propagating impedance changes between elements */
-    class BaseWDF
-    {
-    public:
-        virtual ~BaseWDF() = default;
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
 
-        void connectToParent (BaseWDF* p) { parent = p; }
+            C_value = newC;
+            propagateImpedanceChange();
+        }
 
-        virtual void calcImpedance() = 0;
+        /** Computes the impedance of the WDF capacitor,
+         *                 1
+         * Z_C = ---------------------
+         *       (1 + alpha) * f_s * C
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) 1.0 / (((T) 1.0 + alpha) * C_value * fs);
+            wdf.G = (T) 1.0 / wdf.R;
+        }
 
-        inline virtual void propagateImpedanceChange()
+        /** Accepts an incident wave into a WDF capacitor. */
+        inline void incident (T x) noexcept
         {
-            if (dontPropagateImpedance)
-                return; // the impedance propagation is being deferred until later...
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.a);
+        }
 
-            calcImpedance();
+        /** Propogates a reflected wave from a WDF capacitor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = denormals::flushState (b_coef * wdf.b + a_coef * z);
+            return wdf.b;
+        }
 
-            if (parent != nullptr)
-                parent->propagateImpedanceChange();
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
         }
 
-    protected:
-        BaseWDF* parent = nullptr;
+        WDFMembers<T> wdf;
 
     private:
-        bool dontPropagateImpedance = false;
-
-        template <typename... Elements>
-        friend class ScopedDeferImpedancePropagation;
-    };
+        T C_value = (T) 1.0e-6;
+        T z = (T) 0.0;
 
-    /** Base class for propagating impedance changes into root WDF elements */
-    class RootWDF : public BaseWDF
-    {
-    public:
-        inline void propagateImpedanceChange() override { calcImpedance(); }
+        T fs;
 
-    private:
-        // don't try to connect root nodes!
-        void connectToParent (BaseWDF*) {}
+        T alpha;
+        T b_coef;
+        T a_coef;
     };
 
-    /** Helper struct for common WDF member variables */
+    /** WDF Inductor Node */
     template <typename T>
-    struct WDFMembers
+    class InductorT final : public BaseWDF
     {
-        T R = (NumericType<T>) 1.0e-9; /* impedance */
-        T G = (T) 1.0 / R; /* admittance */
-        T a = (T) 0.0; /* incident wave */
-        T b = (T) 0.0; /* reflected wave */
-    };
+    public:
+        /** Creates a new WDF Inductor.
+         * @param value: Inductance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit InductorT (T value, T fs = (T) 48000.0) : L_value (value),
+                                                           fs (fs)
+        {
+            calcImpedance();
+        }
 
-    /** Probe the voltage across this circuit element. */
-    template <typename T, typename WDFType>
-    inline T voltage (const WDFType& wdf) noexcept
-    {
-        return (wdf.wdf.a + wdf.wdf.b) * (T) 0.5;
-    }
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            fs = sampleRate;
+            propagateImpedanceChange();
 
-    /**Probe the current through this circuit element. */
-    template <typename T, typename WDFType>
-    inline T current (const WDFType& wdf) noexcept
-    {
-        return (wdf.wdf.a - wdf.wdf.b) * ((T) 0.5 * wdf.wdf.G);
-    }
-} // namespace wdft
-} // namespace chowdsp
+            reset();
+        }
 
-#endif // CHOWDSP_WDF_WDFT_BASE_H
+        /** Resets the inductor state */
+        void reset()
+        {
+            z = (T) 0.0;
+        }
 
-// #include "rtype_detail.h"
-#ifndef CHOWDSP_WDF_RTYPE_DETAIL_H
-#define CHOWDSP_WDF_RTYPE_DETAIL_H
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
 
-#include <array>
-#include <algorithm>
-#include <initializer_list>
-#include <tuple>
-#include <vector>
+            L_value = newL;
+            propagateImpedanceChange();
+        }
 
-namespace chowdsp
-{
-#ifndef DOXYGEN
-namespace wdft
-{
-    /** Utility functions used internally by the R-Type adaptor */
-    namespace rtype_detail
-    {
-        /** Divides two numbers and rounds up if there is a remainder. */
-        template <typename T>
-        constexpr T ceil_div (T num, T den)
+        /** Returns the inductance value, in Henries. */
+        T getInductanceValue() const noexcept { return L_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return fs; }
+
+        /** Computes the impedance of the WDF inductor,
+         * Z_L = 2 * f_s * L
+         */
+        inline void calcImpedance() override
         {
-            return (num + den - 1) / den;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) 2.0 * L_value * fs;
+            wdf.G = (T) 1.0 / wdf.R;
         }
 
-        template <typename T, size_t base_size>
-        constexpr typename std::enable_if<std::is_floating_point<T>::value, size_t>::type array_pad()
+        /** Accepts an incident wave into a WDF inductor. */
+        inline void incident (T x) noexcept
         {
-#if defined(XSIMD_HPP)
-            using v_type = xsimd::simd_type<T>;
-            constexpr auto simd_size = v_type::size;
-            constexpr auto num_simd_registers = ceil_div (base_size, simd_size);
-            return num_simd_registers * simd_size;
-#else
-            return base_size;
-#endif
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.a);
         }
 
-        template <typename T, size_t base_size>
-        constexpr typename std::enable_if<! std::is_floating_point<T>::value, size_t>::type array_pad()
+        /** Propogates a reflected wave from a WDF inductor. */
+        inline T reflected() noexcept
         {
-            return base_size;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -z;
+            return wdf.b;
         }
 
-        /** Functions to do a function for each element in the tuple */
-        template <typename Fn, typename Tuple, size_t... Ix>
-        constexpr void forEachInTuple (Fn&& fn, Tuple&& tuple, std::index_sequence<Ix...>) noexcept (noexcept (std::initializer_list<int> { (fn (std::get<Ix> (tuple), Ix), 0)... }))
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
         {
-            (void) std::initializer_list<int> { ((void) fn (std::get<Ix> (tuple), Ix), 0)... };
+            visitor (z);
         }
 
-        template <typename T>
-        using TupleIndexSequence = std::make_index_sequence<std::tuple_size<std::remove_cv_t<std::remove_reference_t<T>>>::value>;
+        WDFMembers<T> wdf;
 
-        template <typename Fn, typename Tuple>
-        constexpr void forEachInTuple (Fn&& fn, Tuple&& tuple) noexcept (noexcept (forEachInTuple (std::forward<Fn> (fn), std::forward<Tuple> (tuple), TupleIndexSequence<Tuple> {})))
+    private:
+        T L_value = (T) 1.0e-6;
+        T z = (T) 0.0;
+
+        T fs;
+    };
+
+    /** WDF Inductor Node with alpha transform parameter */
+    template <typename T>
+    class InductorAlphaT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Inductor.
+         * @param value: Inductance value in Farads
+         * @param fs: WDF sample rate
+         * @param alpha: alpha value to be used for the alpha transform,
+         *               use 0 for Backwards Euler, use 1 for Bilinear Transform.
+         */
+        explicit InductorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : L_value (value),
+                                                                                   fs (fs),
+                                                                                   alpha (alpha),
+                                                                                   b_coef (((T) 1.0 - alpha) / (T) 2.0),
+                                                                                   a_coef (((T) 1.0 + alpha) / (T) 2.0)
         {
-            forEachInTuple (std::forward<Fn> (fn), std::forward<Tuple> (tuple), TupleIndexSequence<Tuple> {});
+            calcImpedance();
         }
 
-        template <typename ElementType, int arraySize, int alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT>
-        struct AlignedArray
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
         {
-            template <typename IntType>
-            ElementType& operator[] (IntType index) noexcept
-            {
-                return array[index];
-            }
-            template <typename IntType>
-            const ElementType& operator[] (IntType index) const noexcept
-            {
-                return array[index];
-            }
-
-            ElementType* data() noexcept { return array; }
-            const ElementType* data() const noexcept { return array; }
-
-            void clear() { std::fill (std::begin (array), std::end (array), ElementType {}); }
-            static constexpr int size() noexcept { return arraySize; }
+            fs = sampleRate;
+            propagateImpedanceChange();
 
-        private:
-            alignas (alignment) ElementType array[array_pad<ElementType, (size_t) arraySize>()] {};
-        };
+            reset();
+        }
 
-        template <typename T, int nRows, int nCols = nRows, int alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT>
-        using Matrix = AlignedArray<T, nRows, alignment>[(size_t) nCols];
+        /** Resets the inductor state */
+        void reset()
+        {
+            z = (T) 0.0;
+        }
 
-        /** Implementation for float/double. */
-        template <typename T, int numPorts>
-        constexpr typename std::enable_if<std::is_floating_point<T>::value, void>::type
-            RtypeScatter (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_)
+        /** Sets a new alpha value to use for the alpha transform */
+        void setAlpha (T newAlpha)
         {
-            // input matrix (S) of size dim x dim
-            // input vector (a) of size 1 x dim
-            // output vector (b) of size 1 x dim
+            alpha = newAlpha;
+            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
+            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
 
-#if defined(XSIMD_HPP)
-            using v_type = xsimd::simd_type<T>;
-            constexpr auto simd_size = (int) v_type::size;
-            constexpr auto vec_size = ceil_div (numPorts, simd_size) * simd_size;
+            propagateImpedanceChange();
+        }
 
-            for (int c = 0; c < vec_size; c += simd_size)
-            {
-                auto b_vec = a_[0] * xsimd::load_aligned (S_[0].data() + c);
-                for (int r = 1; r < numPorts; ++r)
-                    b_vec = xsimd::fma (xsimd::broadcast (a_[r]), xsimd::load_aligned (S_[r].data() + c), b_vec);
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
 
-                xsimd::store_aligned (b_.data() + c, b_vec);
-            }
-#else // No SIMD
-            for (int c = 0; c < numPorts; ++c)
-            {
-                b_[c] = S_[0][c] * a_[0];
-                for (int r = 1; r < numPorts; ++r)
-                    b_[c] += S_[r][c] * a_[r];
-            }
-#endif // SIMD options
+            L_value = newL;
+            propagateImpedanceChange();
         }
 
-#if defined(XSIMD_HPP)
-        /** Implementation for SIMD float/double. */
-        template <typename T, int numPorts>
-        constexpr typename std::enable_if<! std::is_floating_point<T>::value, void>::type
-            RtypeScatter (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_)
+        /** Computes the impedance of the WDF inductor,
+         * Z_L = (1 + alpha) * f_s * L
+         */
+        inline void calcImpedance() override
         {
-            for (int c = 0; c < numPorts; ++c)
-            {
-                b_[c] = S_[0][c] * a_[0];
-                for (int r = 1; r < numPorts; ++r)
-                    b_[c] += S_[r][c] * a_[r];
-            }
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = ((T) 1.0 + alpha) * L_value * fs;
+            wdf.G = (T) 1.0 / wdf.R;
         }
-#endif // XSIMD
 
-        /** Computes a single output of the scattering matrix: b[outIndex] = sum_r S_[r][outIndex] * a_[r]. */
-        template <typename T, int numPorts>
-        constexpr T RtypeScatterSingle (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, int outIndex)
+        /** Accepts an incident wave into a WDF inductor. */
+        inline void incident (T x) noexcept
         {
-            T b = S_[0][outIndex] * a_[0];
-            for (int r = 1; r < numPorts; ++r)
-                b += S_[r][outIndex] * a_[r];
-            return b;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.a);
         }
-    } // namespace rtype_detail
-} // namespace wdft
-
-namespace wdf
-{
-    /** Utility functions used internally by the R-Type adaptor */
-    namespace rtype_detail
-    {
-        using wdft::rtype_detail::ceil_div;
 
-        template <typename T>
-        typename std::enable_if<std::is_floating_point<T>::value, size_t>::type array_pad (size_t base_size)
+        /** Propogates a reflected wave from a WDF inductor. */
+        inline T reflected() noexcept
         {
-#if defined(XSIMD_HPP)
-            using v_type = xsimd::simd_type<T>;
-            constexpr auto simd_size = v_type::size;
-            const auto num_simd_registers = ceil_div (base_size, simd_size);
-            return num_simd_registers * simd_size;
-#else
-            return base_size;
-#endif
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = denormals::flushState (b_coef * wdf.b - a_coef * z);
+            return wdf.b;
         }
 
-        template <typename T>
-        typename std::enable_if<! std::is_floating_point<T>::value, size_t>::type array_pad (size_t base_size)
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
         {
-            return base_size;
+            visitor (z);
         }
 
-        template <typename ElementType>
-        struct AlignedArray
-        {
-            explicit AlignedArray (size_t size) : m_size ((int) size),
-                                                  vector (array_pad<ElementType> (size), ElementType {})
-            {
-            }
+        WDFMembers<T> wdf;
 
-            ElementType& operator[] (int index) noexcept { return vector[index]; }
-            const ElementType& operator[] (int index) const noexcept { return vector[index]; }
+    private:
+        T L_value = (T) 1.0e-6;
+        T z = (T) 0.0;
 
-            ElementType* data() noexcept { return vector.data(); }
-            const ElementType* data() const noexcept { return vector.data(); }
+        T fs;
 
-            void clear() { std::fill (std::begin (vector), std::end (vector), ElementType {}); }
-            int size() const noexcept { return (int) m_size; }
+        T alpha;
+        T b_coef;
+        T a_coef;
+    };
 
-        private:
-            const int m_size;
-#if defined(XSIMD_HPP)
-            std::vector<ElementType, xsimd::default_allocator<ElementType>> vector;
-#else
-            std::vector<ElementType> vector;
-#endif
-        };
+    /**
+     * WDF Resistor and Capacitor in Series
+     *
+     * For low cutoff frequencies, the capacitor state integrates very small increments,
+     * so the StateType argument may be used to store the state at a higher precision
+     * than the waves and coefficients, e.g. `ResistorCapacitorSeriesT<float, double>`,
+     * or `ResistorCapacitorSeriesT<xsimd::batch<float>, CompensatedFloat<xsimd::batch<float>>>`.
+     */
+    template <typename T, typename StateType = T>
+    class ResistorCapacitorSeriesT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Capacitor Series.
+         * @param cap_value: Resistance value in Ohms
+         * @param res_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorCapacitorSeriesT (T res_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
 
-        template <typename ElementType>
-        struct Matrix
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
         {
-            Matrix (size_t nRows, size_t nCols) : vector (nCols, AlignedArray<ElementType> (nRows))
-            {
-            }
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
 
-            AlignedArray<ElementType>& operator[] (int index) noexcept { return vector[(size_t) index]; }
-            const AlignedArray<ElementType>& operator[] (int index) const noexcept { return vector[(size_t) index]; }
+            reset();
+        }
 
-        private:
-            std::vector<AlignedArray<ElementType>> vector;
-        };
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = StateType {};
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
 
-        /** Implementation for float/double. */
-        template <typename T>
-        constexpr typename std::enable_if<std::is_floating_point<T>::value, void>::type
-            RtypeScatter (const Matrix<T>& S_, const AlignedArray<T>& a_, AlignedArray<T>& b_)
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
         {
-            // input matrix (S) of size dim x dim
-            // input vector (a) of size 1 x dim
-            // output vector (b) of size 1 x dim
+            if (all (newR == R_value))
+                return;
 
-#if defined(XSIMD_HPP)
-            using v_type = xsimd::simd_type<T>;
-            constexpr auto simd_size = (int) v_type::size;
-            const auto numPorts = a_.size();
-            const auto vec_size = ceil_div (numPorts, simd_size) * simd_size;
+            R_value = newR;
+            propagateImpedanceChange();
+        }
 
-            for (int c = 0; c < vec_size; c += simd_size)
-            {
-                auto b_vec = a_[0] * xsimd::load_aligned (S_[0].data() + c);
-                for (int r = 1; r < numPorts; ++r)
-                    b_vec = xsimd::fma (xsimd::broadcast (a_[r]), xsimd::load_aligned (S_[r].data() + c), b_vec);
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
 
-                xsimd::store_aligned (b_.data() + c, b_vec);
-            }
-#else // No SIMD
-            const auto numPorts = a_.size();
-            for (int c = 0; c < numPorts; ++c)
-            {
-                b_[c] = S_[0][c] * a_[0];
-                for (int r = 1; r < numPorts; ++r)
-                    b_[c] += S_[r][c] * a_[r];
-            }
-#endif // SIMD options
+            C_value = newC;
+            propagateImpedanceChange();
         }
 
-#if defined(XSIMD_HPP)
-        /** Implementation for SIMD float/double. */
-        template <typename T>
-        constexpr typename std::enable_if<! std::is_floating_point<T>::value, void>::type
-            RtypeScatter (const Matrix<T>& S_, const AlignedArray<T>& a_, AlignedArray<T>& b_)
+        /** Computes the impedance of the WDF resistor/capacitor combination */
+        inline void calcImpedance() override
         {
-            const auto numPorts = a_.size();
-            for (int c = 0; c < numPorts; ++c)
-            {
-                b_[c] = S_[0][c] * a_[0];
-                for (int r = 1; r < numPorts; ++r)
-                    b_[c] += S_[r][c] * a_[r];
-            }
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = tt / ((T) 2.0 * C_value) + R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+            T_over_T_plus_2RC = tt / ((T) 2 * C_value * R_value + tt);
         }
-#endif // XSIMD
 
-        /** Computes a single output of the scattering matrix: b[outIndex] = sum_r S_[r][outIndex] * a_[r]. */
-        template <typename T>
-        T RtypeScatterSingle (const Matrix<T>& S_, const AlignedArray<T>& a_, int outIndex)
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
         {
-            const auto numPorts = a_.size();
-            T b = S_[0][outIndex] * a_[0];
-            for (int r = 1; r < numPorts; ++r)
-                b += S_[r][outIndex] * a_[r];
-            return b;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z -= T_over_T_plus_2RC * (wdf.a + z);
+            z = denormals::flushState (z);
         }
-    } // namespace rtype_detail
-} // namespace wdf
-#endif // DOXYGEN
-} // namespace chowdsp
 
-#endif //CHOWDSP_WDF_RTYPE_DETAIL_H
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -(T) z;
+            return wdf.b;
+        }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
 
-namespace chowdsp
-{
-namespace wdft
-{
-    /**
-     *  An adaptable R-Type adaptor.
-     *  For more information see: https://searchworks.stanford.edu/view/11891203, chapter 2
-     *
-     *  The upPortIndex argument descibes with port of the scattering matrix is being adapted.
-     *
-     *  The ImpedanceCalculator template argument with a static method of the form:
-     *  @code
-     *  template <typename RType>
-     *  static T calcImpedance (RType& R);
-     *  @endcode
-     */
-    template <typename T, int upPortIndex, typename ImpedanceCalculator, typename... PortTypes>
-    class RtypeAdaptor : public BaseWDF
-    {
-    public:
-        /** Number of ports connected to RtypeAdaptor */
-        static constexpr auto numPorts = int (sizeof...(PortTypes) + 1);
+        WDFMembers<T> wdf;
 
-        explicit RtypeAdaptor (PortTypes&... dps) : downPorts (std::tie (dps...))
-        {
-            b_vec.clear();
-            a_vec.clear();
+    private:
+        T R_value = (T) 1.0e3;
+        T C_value = (T) 1.0e-6;
 
-            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
-                                          downPorts);
-        }
+        T T_over_T_plus_2RC = (T) 0.0;
 
-        [[deprecated ("Prefer the alternative constuctor which accepts the port references directly")]] explicit RtypeAdaptor (std::tuple<PortTypes&...> dps) : downPorts (dps)
-        {
-            b_vec.clear();
-            a_vec.clear();
+        StateType z {};
 
-            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
-                                          downPorts);
-        }
+        T tt;
+    };
 
-        /** Re-computes the port impedance at the adapted upward-facing port */
-        void calcImpedance() override
+    /** WDF Resistor and Capacitor in parallel */
+    template <typename T>
+    class ResistorCapacitorParallelT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Capacitor Parallel.
+         * @param res_value: Resistance value in Ohms
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorCapacitorParallelT (T res_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
         {
-            wdf.R = ImpedanceCalculator::calcImpedance (*this);
-            wdf.G = (T) 1 / wdf.R;
+            calcImpedance();
         }
 
-        constexpr auto getPortImpedances()
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
         {
-            std::array<T, numPorts - 1> portImpedances {};
-            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { portImpedances[i] = port.wdf.R; },
-                                          downPorts);
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
 
-            return portImpedances;
+            reset();
         }
 
-        /** Use this function to set the scattering matrix data. */
-        void setSMatrixData (const T (&mat)[numPorts][numPorts])
+        /** Resets the capacitor state */
+        void reset()
         {
-            for (int i = 0; i < numPorts; ++i)
-                for (int j = 0; j < numPorts; ++j)
-                    S_matrix[j][i] = mat[i][j];
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
         }
 
-        /** Computes the incident wave. */
-        inline void incident (T downWave) noexcept
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
         {
-            wdf.a = downWave;
-            a_vec[upPortIndex] = wdf.a;
+            if (all (newR == R_value))
+                return;
 
-            rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
-            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
-                                              auto portIndex = getPortIndex ((int) i);
-                                              port.incident (b_vec[portIndex]); },
-                                          downPorts);
+            R_value = newR;
+            propagateImpedanceChange();
         }
 
-        /** Computes the reflected wave */
-        inline T reflected() noexcept
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
         {
-            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
-                                              auto portIndex = getPortIndex ((int) i);
-                                              a_vec[portIndex] = port.reflected(); },
-                                          downPorts);
+            if (all (newC == C_value))
+                return;
 
-            // S_matrix[upPortIndex][upPortIndex] is zero, so this is fine without a fresh a_vec[upPortIndex].
-            wdf.b = rtype_detail::RtypeScatterSingle (S_matrix, a_vec, upPortIndex);
-            return wdf.b;
+            C_value = newC;
+            propagateImpedanceChange();
         }
 
-        WDFMembers<T> wdf;
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
 
-    private:
-        constexpr auto getPortIndex (int tupleIndex)
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return (T) 1 / tt; }
+
+        /** Computes the impedance of the WDF resistor/capacitor combination */
+        inline void calcImpedance() override
         {
-            return tupleIndex < upPortIndex ? tupleIndex : tupleIndex + 1;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoRC = (T) 2.0 * C_value * R_value;
+            wdf.R = R_value * tt / (twoRC + tt);
+            wdf.G = (T) 1.0 / wdf.R;
+            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
         }
 
-        std::tuple<PortTypes&...> downPorts; // tuple of ports connected to RtypeAdaptor
-
-        rtype_detail::Matrix<T, numPorts> S_matrix; // square matrix representing S
-        rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
-        rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
-    };
-} // namespace wdft
-} // namespace chowdsp
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.b + wdf.a - z);
+        }
 
-#endif //CHOWDSP_WDF_RTYPE_ADAPTOR_H
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = twoRC_over_twoRC_plus_T * z;
+            return wdf.b;
+        }
 
-// #include "root_rtype_adaptor.h"
-#ifndef CHOWDSP_WDF_ROOT_RTYPE_ADAPTOR_H
-#define CHOWDSP_WDF_ROOT_RTYPE_ADAPTOR_H
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
 
-// #include "../wdft/wdft_base.h"
+        WDFMembers<T> wdf;
 
-// #include "rtype_detail.h"
+    private:
+        T R_value = (T) 1.0e3;
+        T C_value = (T) 1.0e-6;
 
+        T twoRC_over_twoRC_plus_T = (T) 0.0;
 
-namespace chowdsp
-{
-namespace wdft
-{
-    /**
-     *  A non-adaptable R-Type adaptor.
-     *  For more information see: https://searchworks.stanford.edu/view/11891203, chapter 2
-     *
-     *  The ImpedanceCalculator template argument with a static method of the form:
-     *  @code
-     *  template <typename RType>
-     *  static void calcImpedance (RType& R);
-     *  @endcode
-     */
-    template <typename T, typename ImpedanceCalculator, typename... PortTypes>
-    class RootRtypeAdaptor : public RootWDF
+        T z = (T) 0.0;
+
+        T tt;
+    };
+
+    /** WDF Resistor and Inductor in Series */
+    template <typename T>
+    class ResistorInductorSeriesT final : public BaseWDF
     {
     public:
-        /** Number of ports connected to RootRtypeAdaptor */
-        static constexpr auto numPorts = int (sizeof...(PortTypes));
+        /** Creates a new WDF Resistor/Inductor Series.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorInductorSeriesT (T res_value, T ind_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
 
-        explicit RootRtypeAdaptor (PortTypes&... dps) : downPorts (std::tie (dps...))
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
         {
-            b_vec.clear();
-            a_vec.clear();
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
 
-            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
-                                          downPorts);
+            reset();
         }
 
-        [[deprecated ("Prefer the alternative constuctor which accepts the port references directly")]] explicit RootRtypeAdaptor (std::tuple<PortTypes&...> dps) : downPorts (dps)
+        /** Resets the inductor state */
+        void reset()
         {
-            b_vec.clear();
-            a_vec.clear();
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
 
-            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
-                                          downPorts);
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
         }
 
-        /** Recomputes internal variables based on the incoming impedances */
-        void calcImpedance() override
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
         {
-            ImpedanceCalculator::calcImpedance (*this);
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
         }
 
-        constexpr auto getPortImpedances()
+        /** Computes the impedance of the WDF resistor/inductor combination */
+        inline void calcImpedance() override
         {
-            std::array<T, numPorts> portImpedances {};
-            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { portImpedances[i] = port.wdf.R; },
-                                          downPorts);
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoL = (T) 2.0 * L_value;
+            wdf.R = twoL / tt + R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+            twoL_over_twoL_plus_RT = twoL / (twoL + R_value * tt);
+        }
 
-            return portImpedances;
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (twoL_over_twoL_plus_RT * (z - wdf.a) - z);
         }
 
-        /** Use this function to set the scattering matrix data. */
-        void setSMatrixData (const T (&mat)[numPorts][numPorts])
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
         {
-            for (int i = 0; i < numPorts; ++i)
-                for (int j = 0; j < numPorts; ++j)
-                    S_matrix[j][i] = mat[i][j];
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = z;
+            return wdf.b;
         }
 
-        /** Computes both the incident and reflected waves at this root node. */
-        inline void compute() noexcept
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
         {
-            rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
-            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
-                                          port.incident (b_vec[i]);
-                                          a_vec[i] = port.reflected(); },
-                                          downPorts);
+            visitor (z);
         }
 
+        WDFMembers<T> wdf;
+
     private:
-        std::tuple<PortTypes&...> downPorts; // tuple of ports connected to RtypeAdaptor
+        T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
 
-        rtype_detail::Matrix<T, numPorts> S_matrix; // square matrix representing S
-        rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
-        rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
+        T twoL_over_twoL_plus_RT = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
     };
-} // namespace wdft
-} // namespace chowdsp
 
-#endif //CHOWDSP_WDF_ROOT_RTYPE_ADAPTOR_H
+    /** WDF Resistor and Inductor in parallel */
+    template <typename T>
+    class ResistorInductorParallelT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor Parallel.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorInductorParallelT (T res_value, T ind_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
 
-// #include "wdf_rtype.h"
-#ifndef CHOWDSP_WDF_WDF_RTYPE_H
-#define CHOWDSP_WDF_WDF_RTYPE_H
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
 
-#include <functional>
-// #include "../wdf/wdf_base.h"
-#ifndef CHOWDSP_WDF_WDF_BASE_H
-#define CHOWDSP_WDF_WDF_BASE_H
+            reset();
+        }
 
-#include <string>
-#include <utility>
+        /** Resets the inductor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
 
-// #include "../wdft/wdft.h"
-#ifndef CHOWDSP_WDF_T_INCLUDED
-#define CHOWDSP_WDF_T_INCLUDED
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
 
-namespace chowdsp
-{
-/** API for constructing Wave Digital Filters with a fixed compile-time architecture */
-namespace wdft
-{
-}
+            R_value = newR;
+            propagateImpedanceChange();
+        }
 
-} // namespace chowdsp
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
 
-// #include "wdft_one_ports.h"
-#ifndef CHOWDSP_WDF_WDFT_ONE_PORTS_H
-#define CHOWDSP_WDF_WDFT_ONE_PORTS_H
+            L_value = newL;
+            propagateImpedanceChange();
+        }
 
-// #include "wdft_base.h"
-#ifndef CHOWDSP_WDF_WDFT_BASE_H
-#define CHOWDSP_WDF_WDFT_BASE_H
+        /** Computes the impedance of the WDF resistor/inductor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoL = (T) 2.0 * L_value;
+            const auto RT = R_value * tt;
+            wdf.R = twoL * R_value / (RT + twoL);
+            wdf.G = (T) 1.0 / wdf.R;
+            RT_over_RT_plus_twoL = RT / (RT + twoL);
+        }
 
-// #include "../math/sample_type.h"
-#ifndef CHOWDSP_WDF_SAMPLE_TYPE_H
-#define CHOWDSP_WDF_SAMPLE_TYPE_H
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.b + wdf.a + z);
+        }
 
-#include <type_traits>
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -RT_over_RT_plus_twoL * z;
+            return wdf.b;
+        }
 
-#ifndef DOXYGEN
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
 
-namespace chowdsp
-{
-#if ! (JUCE_MODULE_AVAILABLE_chowdsp_dsp)
-/** Useful structs for determining the internal data type of SIMD types */
-namespace SampleTypeHelpers
-{
-    template <typename T, bool = std::is_floating_point<T>::value>
-    struct ElementType
-    {
-        using Type = T;
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
+
+        T RT_over_RT_plus_twoL = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
     };
 
+    /** WDF Inductor and Capacitor in Series */
     template <typename T>
-    struct ElementType<T, false>
-    {
-        using Type = typename T::value_type;
-    };
-} // namespace SampleTypeHelpers
-#endif
-
-/** Type alias for a SIMD numeric type */
-template <typename T>
-using NumericType = typename SampleTypeHelpers::ElementType<T>::Type;
-
-/** Returns true if all the elements in a SIMD vector are equal */
-inline bool all (bool x)
-{
-    return x;
-}
-
-/** Ternary select operation */
-template <typename T>
-inline T select (bool b, const T& t, const T& f)
-{
-    return b ? t : f;
-}
-} // namespace chowdsp
-
-#endif // DOXYGEN
-
-#endif //CHOWDSP_WDF_SAMPLE_TYPE_H
-
-
-namespace chowdsp
-{
-namespace wdft
-{
-    /** Base WDF class for propagating impedance changes between elements */
-    class BaseWDF
+    class InductorCapacitorSeriesT final : public BaseWDF
     {
     public:
-        virtual ~BaseWDF() = default;
-
-        void connectToParent (BaseWDF* p) { parent = p; }
-
-        virtual void calcImpedance() = 0;
-
-        inline virtual void propagateImpedanceChange()
+        /** Creates a new WDF Inductor/Capacitor Series.
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit InductorCapacitorSeriesT (T ind_value, T cap_value, T fs = (T) 48000.0)
+            : L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
         {
-            if (dontPropagateImpedance)
-                return; // the impedance propagation is being deferred until later...
-
             calcImpedance();
-
-            if (parent != nullptr)
-                parent->propagateImpedanceChange();
         }
 
-    protected:
-        BaseWDF* parent = nullptr;
-
-    private:
-        bool dontPropagateImpedance = false;
-
-        template <typename... Elements>
-        friend class ScopedDeferImpedancePropagation;
-    };
-
-    /** Base class for propagating impedance changes into root WDF elements */
-    class RootWDF : public BaseWDF
-    {
-    public:
-        inline void propagateImpedanceChange() override { calcImpedance(); }
-
-    private:
-        // don't try to connect root nodes!
-        void connectToParent (BaseWDF*) {}
-    };
-
-    /** Helper struct for common WDF member variables */
-    template <typename T>
-    struct WDFMembers
-    {
-        T R = (NumericType<T>) 1.0e-9; /* impedance */
-        T G = (T) 1.0 / R; /* admittance */
-        T a = (T) 0.0; /* incident wave */
-        T b = (T) 0.0; /* reflected wave */
-    };
-
-    /** Probe the voltage across this circuit element. */
-    template <typename T, typename WDFType>
-    inline T voltage (const WDFType& wdf) noexcept
-    {
-        return (wdf.wdf.a + wdf.wdf.b) * (T) 0.5;
-    }
-
-    /**Probe the current through this circuit element. */
-    template <typename T, typename WDFType>
-    inline T current (const WDFType& wdf) noexcept
-    {
-        return (wdf.wdf.a - wdf.wdf.b) * ((T) 0.5 * wdf.wdf.G);
-    }
-} // namespace wdft
-} // namespace chowdsp
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
 
-#endif // CHOWDSP_WDF_WDFT_BASE_H
+            reset();
+        }
 
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
 
-namespace chowdsp
-{
-namespace wdft
-{
-    /** WDF Resistor Node */
-    template <typename T>
-    class ResistorT final : public BaseWDF
-    {
-    public:
-        /** Creates a new WDF Resistor with a given resistance.
-         * @param value: resistance in Ohms
-         */
-        explicit ResistorT (T value) : R_value (value)
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
         {
-            calcImpedance();
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
         }
 
-        /** Sets the resistance value of the WDF resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
         {
-            if (all (newR == R_value))
+            if (all (newC == C_value))
                 return;
 
-            R_value = newR;
+            C_value = newC;
             propagateImpedanceChange();
         }
 
-        /** Computes the impedance of the WDF resistor, Z_R = R. */
+        /** Returns the inductance value, in Henries. */
+        T getInductanceValue() const noexcept { return L_value; }
+
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return (T) 1 / tt; }
+
+        /** Computes the impedance of the WDF inductor/capacitor combination */
         inline void calcImpedance() override
         {
-            wdf.R = R_value;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto R_C = tt / ((T) 2.0 * C_value);
+            wdf.R = R_C + (T) 2.0 * L_value / tt;
             wdf.G = (T) 1.0 / wdf.R;
+            RC_over_Rp = R_C * wdf.G;
         }
 
-        /** Accepts an incident wave into a WDF resistor. */
+        /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
+            zC = denormals::flushState (zC - RC_over_Rp * (wdf.a - wdf.b));
+            zL = denormals::flushState (-(wdf.a + zC));
         }
 
-        /** Propogates a reflected wave from a WDF resistor. */
+        /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            wdf.b = 0.0;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = zL - zC;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (zL);
+            visitor (zC);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        T R_value = (T) 1.0e-9;
+        T L_value = (T) 1.0e-3;
+        T C_value = (T) 1.0e-6;
+
+        T RC_over_Rp = (T) 0.0;
+
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
+
+        T tt;
     };
 
-    /** WDF Capacitor Node */
+    /** WDF Inductor and Capacitor in parallel */
     template <typename T>
-    class CapacitorT final : public BaseWDF
+    class InductorCapacitorParallelT final : public BaseWDF
     {
     public:
-        /** Creates a new WDF Capacitor.
-         * @param value: Capacitance value in Farads
-         * @param _fs: WDF sample rate
+        /** Creates a new WDF Inductor/Capacitor Parallel.
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
          */
-        explicit CapacitorT (T value, T _fs = (T) 48000.0) : C_value (value),
-                                                             fs (_fs)
+        explicit InductorCapacitorParallelT (T ind_value, T cap_value, T fs = (T) 48000.0)
+            : L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
         {
             calcImpedance();
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
         void prepare (T sampleRate)
         {
-            fs = sampleRate;
+            tt = (T) 1 / sampleRate;
             propagateImpedanceChange();
 
             reset();
         }
 
-        /** Resets the capacitor state */
+        /** Resets the inductor and capacitor states */
         void reset()
         {
-            z = (T) 0.0;
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
         }
 
         /** Sets the capacitance value of the WDF capacitor, in Farads. */
@@ -5502,82 +6759,111 @@ namespace wdft
             propagateImpedanceChange();
         }
 
-        /** Computes the impedance of the WDF capacitor,
-         *             1
-         * Z_C = --------------
-         *        2 * f_s * C
-         */
+        /** Computes the impedance of the WDF inductor/capacitor combination */
         inline void calcImpedance() override
         {
-            wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
-            wdf.G = (T) 1.0 / wdf.R;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto G_C = (T) 2.0 * C_value / tt;
+            wdf.G = G_C + tt / ((T) 2.0 * L_value);
+            wdf.R = (T) 1.0 / wdf.G;
+            GC_over_Gp = G_C * wdf.R;
         }
 
-        /** Accepts an incident wave into a WDF capacitor. */
+        /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.a;
+            const auto a_plus_b = wdf.a + wdf.b;
+            zL = denormals::flushState (a_plus_b + zL);
+            zC = denormals::flushState (a_plus_b - zC);
         }
 
-        /** Propogates a reflected wave from a WDF capacitor. */
+        /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            wdf.b = z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = GC_over_Gp * (zL + zC) - zL;
             return wdf.b;
         }
 
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (zL);
+            visitor (zC);
+        }
+
         WDFMembers<T> wdf;
 
     private:
+        T L_value = (T) 1.0e-3;
         T C_value = (T) 1.0e-6;
-        T z = (T) 0.0;
 
-        T fs;
+        T GC_over_Gp = (T) 0.0;
+
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
+
+        T tt;
     };
 
-    /** WDF Capacitor Node with alpha transform parameter */
+    /** WDF Resistor, Inductor, and Capacitor in Series */
     template <typename T>
-    class CapacitorAlphaT final : public BaseWDF
+    class ResistorInductorCapacitorSeriesT final : public BaseWDF
     {
     public:
-        /** Creates a new WDF Capacitor.
-         * @param value: Capacitance value in Farads
+        /** Creates a new WDF Resistor/Inductor/Capacitor Series.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
          * @param fs: WDF sample rate
-         * @param alpha: alpha value to be used for the alpha transform,
-         *             use 0 for Backwards Euler, use 1 for Bilinear Transform.
          */
-        explicit CapacitorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : C_value (value),
-                                                                                    fs (fs),
-                                                                                    alpha (alpha),
-                                                                                    b_coef (((T) 1.0 - alpha) / (T) 2.0),
-                                                                                    a_coef (((T) 1.0 + alpha) / (T) 2.0)
+        explicit ResistorInductorCapacitorSeriesT (T res_value, T ind_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
         {
             calcImpedance();
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
         void prepare (T sampleRate)
         {
-            fs = sampleRate;
+            tt = (T) 1 / sampleRate;
             propagateImpedanceChange();
 
             reset();
         }
 
-        /** Resets the capacitor state */
+        /** Resets the inductor and capacitor states */
         void reset()
         {
-            z = (T) 0.0;
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
         }
 
-        /** Sets a new alpha value to use for the alpha transform */
-        void setAlpha (T newAlpha)
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
         {
-            alpha = newAlpha;
-            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
-            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
 
+            L_value = newL;
             propagateImpedanceChange();
         }
 
@@ -5591,2015 +6877,13378 @@ namespace wdft
             propagateImpedanceChange();
         }
 
-        /** Computes the impedance of the WDF capacitor,
-         *                 1
-         * Z_C = ---------------------
-         *       (1 + alpha) * f_s * C
-         */
+        /** Computes the impedance of the WDF resistor/inductor/capacitor combination */
         inline void calcImpedance() override
         {
-            wdf.R = (T) 1.0 / (((T) 1.0 + alpha) * C_value * fs);
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto R_L = (T) 2.0 * L_value / tt;
+            const auto R_C = tt / ((T) 2.0 * C_value);
+            wdf.R = R_value + R_L + R_C;
             wdf.G = (T) 1.0 / wdf.R;
+            RL_over_Rp = R_L * wdf.G;
+            RC_over_Rp = R_C * wdf.G;
         }
 
-        /** Accepts an incident wave into a WDF capacitor. */
+        /** Accepts an incident wave into the WDF. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.a;
+            const auto a_minus_b = wdf.a - wdf.b;
+            zL = denormals::flushState (-(zL + RL_over_Rp * a_minus_b));
+            zC = denormals::flushState (zC - RC_over_Rp * a_minus_b);
         }
 
-        /** Propogates a reflected wave from a WDF capacitor. */
+        /** Propogates a reflected wave from the WDF. */
         inline T reflected() noexcept
         {
-            wdf.b = b_coef * wdf.b + a_coef * z;
-            return wdf.b;
-        }
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = zL - zC;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (zL);
+            visitor (zC);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
+        T C_value = (T) 1.0e-6;
+
+        T RL_over_Rp = (T) 0.0;
+        T RC_over_Rp = (T) 0.0;
+
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
+
+        T tt;
+    };
+
+    /**
+     * WDF Capacitor with an equivalent series resistance (ESR),
+     * and a leakage resistance in parallel with the capacitor.
+     *
+     * The default leakage resistance is large enough that the
+     * element behaves like a resistor and capacitor in series.
+     */
+    template <typename T>
+    class CapacitorESRT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Capacitor with ESR.
+         * @param cap_value: Capacitance value in Farads
+         * @param esr_value: Equivalent series resistance in Ohms
+         * @param fs: WDF sample rate
+         * @param leakage_value: Leakage resistance in Ohms
+         */
+        explicit CapacitorESRT (T cap_value, T esr_value, T fs = (T) 48000.0, T leakage_value = NumericType<T> (1.0e9))
+            : C_value (cap_value),
+              ESR_value (esr_value),
+              leakage_value (leakage_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the equivalent series resistance, in Ohms. */
+        void setESRValue (T newESR)
+        {
+            if (all (newESR == ESR_value))
+                return;
+
+            ESR_value = newESR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the leakage resistance, in Ohms. */
+        void setLeakageResistanceValue (T newR)
+        {
+            if (all (newR == leakage_value))
+                return;
+
+            leakage_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF capacitor/ESR/leakage combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoRC = (T) 2.0 * C_value * leakage_value;
+            const auto R_leaky_cap = leakage_value * tt / (twoRC + tt);
+            wdf.R = R_leaky_cap + ESR_value;
+            wdf.G = (T) 1.0 / wdf.R;
+            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
+            Rcap_over_Rp = R_leaky_cap * wdf.G;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (-((T) 2 * wdf.b + z + Rcap_over_Rp * (wdf.a - wdf.b)));
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -twoRC_over_twoRC_plus_T * z;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T C_value = (T) 1.0e-6;
+        T ESR_value = (T) 1.0;
+        T leakage_value = (T) 1.0e9;
+
+        T twoRC_over_twoRC_plus_T = (T) 0.0;
+        T Rcap_over_Rp = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDFT_ONE_PORTS_H
+
+// #include "wdft_sources.h"
+#ifndef CHOWDSP_WDF_WDFT_SOURCES_H
+#define CHOWDSP_WDF_WDFT_SOURCES_H
+
+// #include "wdft_base.h"
+
+// #include "../math/compensated_float.h"
+
+// #include "../math/denormals.h"
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** WDF Ideal Voltage source (non-adaptable) */
+    template <typename T, typename Next>
+    class IdealVoltageSourceT final : public RootWDF
+    {
+    public:
+        explicit IdealVoltageSourceT (Next& n) : next (n)
+        {
+            n.connectToParent (this);
+            calcImpedance();
+        }
+
+        void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
+
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV) { Vs = newV; }
+
+        /** Accepts an incident wave into a WDF ideal voltage source. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF ideal voltage source. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -wdf.a + (T) 2.0 * Vs;
+            return wdf.b;
+        }
+
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        Next& next;
+
+        T Vs = (T) 0.0;
+    };
+
+    /** WDF Voltage source with series resistance */
+    template <typename T>
+    class ResistiveVoltageSourceT final : public BaseWDF
+    {
+    public:
+        /** Creates a new resistive voltage source.
+         * @param value: initial resistance value, in Ohms
+         */
+        explicit ResistiveVoltageSourceT (T value = NumericType<T> (1.0e-9)) : R_value (value)
+        {
+            calcImpedance();
+        }
+
+        /** Sets the resistance value of the series resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
+        /** Computes the impedance for a WDF resistive voltage souce
+         * Z_Vr = Z_R
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV) { Vs = newV; }
+
+        /** Returns the voltage of the voltage source, in Volts */
+        T getVoltage() const noexcept { return Vs; }
+
+        /** Accepts an incident wave into a WDF resistive voltage source. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF resistive voltage source. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = Vs;
+            return wdf.b;
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T Vs = (T) 0.0;
+        T R_value = (T) 1.0e-9;
+    };
+
+    /** WDF Voltage source with series capacitance */
+    template <typename T>
+    class CapacitiveVoltageSourceT final : public BaseWDF
+    {
+    public:
+        /** Creates a new resistive voltage source.
+         * @param value: initial resistance value, in Ohms
+         */
+        explicit CapacitiveVoltageSourceT (T value = NumericType<T> (1.0e-6), T fs = (T) 48000)
+            : C_value (value),
+              fs (fs)
+
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            fs = sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        void reset()
+        {
+            z = (T) 0;
+            v_1 = (T) 0;
+        }
+
+        /** Sets the capacitance value of the series resistor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF capacitor,
+         *             1
+         * Z_C = --------------
+         *        2 * f_s * C
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV)
+        {
+            v_0 = newV;
+        }
+
+        /** Accepts an incident wave into a WDF resistive voltage source. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.a);
+        }
+
+        /** Propogates a reflected wave from a WDF resistive voltage source. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = z + v_0 - v_1;
+            v_1 = v_0;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+            visitor (v_1);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T C_value = (T) 1.0e-6;
+
+        T z {};
+        T v_0 {};
+        T v_1 {};
+
+        T fs;
+    };
+
+    /** WDF Current source (non-adaptable) */
+    template <typename T, typename Next>
+    class IdealCurrentSourceT final : public RootWDF
+    {
+    public:
+        explicit IdealCurrentSourceT (Next& n) : next (n)
+        {
+            n.connectToParent (this);
+            calcImpedance();
+        }
+
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            twoR = (T) 2.0 * next.wdf.R;
+            twoR_Is = twoR * Is;
+        }
+
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI)
+        {
+            Is = newI;
+            twoR_Is = twoR * Is;
+        }
+
+        /** Accepts an incident wave into a WDF ideal current source. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF ideal current source. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = twoR_Is + wdf.a;
+            return wdf.b;
+        }
+
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        Next& next;
+
+        T Is = (T) 0.0;
+        T twoR;
+        T twoR_Is;
+    };
+
+    /** WDF Current source with parallel resistance */
+    template <typename T>
+    class ResistiveCurrentSourceT final : public BaseWDF
+    {
+    public:
+        /** Creates a new resistive current source.
+         * @param value: initial resistance value, in Ohms
+         */
+        explicit ResistiveCurrentSourceT (T value = NumericType<T> (1.0e9)) : R_value (value)
+        {
+            calcImpedance();
+        }
+
+        /** Sets the resistance value of the parallel resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
+        /** Computes the impedance for a WDF resistive current souce
+         * Z_Ir = Z_R
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI) { Is = newI; }
+
+        /** Returns the current of the current source, in Amps */
+        T getCurrent() const noexcept { return Is; }
+
+        /** Accepts an incident wave into a WDF resistive current source. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF resistive current source. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = wdf.R * Is;
+            return wdf.b;
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T Is = (T) 0.0;
+        T R_value = (T) 1.0e9;
+    };
+
+    /**
+     * WDF Resistor and Capacitor and Voltage source in Series
+     *
+     * As with ResistorCapacitorSeriesT, the StateType argument may be used to store the
+     * capacitor state at a higher precision than the waves and coefficients.
+     */
+    template <typename T, typename StateType = T>
+    class ResistiveCapacitiveVoltageSourceT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Capacitor Series.
+         * @param cap_value: Resistance value in Ohms
+         * @param res_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistiveCapacitiveVoltageSourceT (T res_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+            reset();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = StateType {};
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV) { Vs = newV; }
+
+        /** Computes the impedance of the WDF resistor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = tt / ((T) 2.0 * C_value) + R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+            T_over_T_plus_2RC = tt / ((T) 2 * C_value * R_value + tt);
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z -= T_over_T_plus_2RC * (wdf.a - wdf.b);
+            z = denormals::flushState (z);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -(T) (z + Vs);
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T Vs = (T) 0.0;
+        T R_value = (T) 1.0e3;
+        T C_value = (T) 1.0e-6;
+
+        T T_over_T_plus_2RC = (T) 0.0;
+
+        StateType z {};
+
+        T tt;
+    };
+
+    /** WDF Current source with a resistor and capacitor in parallel */
+    template <typename T>
+    class ResistiveCapacitiveCurrentSourceT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Capacitor/Current Source Parallel.
+         * @param res_value: Resistance value in Ohms
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistiveCapacitiveCurrentSourceT (T res_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+            reset();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI)
+        {
+            Is = newI;
+            Rp_Is = wdf.R * Is;
+        }
+
+        /** Computes the impedance of the WDF resistor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoRC = (T) 2.0 * C_value * R_value;
+            wdf.R = R_value * tt / (twoRC + tt);
+            wdf.G = (T) 1.0 / wdf.R;
+            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
+            Rp_Is = wdf.R * Is;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.b + wdf.a - z);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = twoRC_over_twoRC_plus_T * z + Rp_Is;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T Is = (T) 0.0;
+        T R_value = (T) 1.0e3;
+        T C_value = (T) 1.0e-6;
+
+        T twoRC_over_twoRC_plus_T = (T) 0.0;
+        T Rp_Is = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDFT_SOURCES_H
+
+// #include "wdft_adaptors.h"
+#ifndef CHOWDSP_WDF_WDFT_ADAPTORS_H
+#define CHOWDSP_WDF_WDFT_ADAPTORS_H
+
+// #include "wdft_base.h"
+
+// #include "../rtype/rtype_detail.h"
+#ifndef CHOWDSP_WDF_RTYPE_DETAIL_H
+#define CHOWDSP_WDF_RTYPE_DETAIL_H
+
+#include <array>
+#include <algorithm>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace chowdsp
+{
+#ifndef DOXYGEN
+namespace wdft
+{
+    /** Utility functions used internally by the R-Type adaptor */
+    namespace rtype_detail
+    {
+        /** Divides two numbers and rounds up if there is a remainder. */
+        template <typename T>
+        constexpr T ceil_div (T num, T den)
+        {
+            return (num + den - 1) / den;
+        }
+
+        template <typename T, size_t base_size>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, size_t>::type array_pad()
+        {
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = v_type::size;
+            constexpr auto num_simd_registers = ceil_div (base_size, simd_size);
+            return num_simd_registers * simd_size;
+#else
+            return base_size;
+#endif
+        }
+
+        template <typename T, size_t base_size>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, size_t>::type array_pad()
+        {
+            return base_size;
+        }
+
+        /** Functions to do a function for each element in the tuple */
+        template <typename Fn, typename Tuple, size_t... Ix>
+        constexpr void forEachInTuple (Fn&& fn, Tuple&& tuple, std::index_sequence<Ix...>) noexcept (noexcept (std::initializer_list<int> { (fn (std::get<Ix> (tuple), Ix), 0)... }))
+        {
+            (void) std::initializer_list<int> { ((void) fn (std::get<Ix> (tuple), Ix), 0)... };
+        }
+
+        template <typename T>
+        using TupleIndexSequence = std::make_index_sequence<std::tuple_size<std::remove_cv_t<std::remove_reference_t<T>>>::value>;
+
+        template <typename Fn, typename Tuple>
+        constexpr void forEachInTuple (Fn&& fn, Tuple&& tuple) noexcept (noexcept (forEachInTuple (std::forward<Fn> (fn), std::forward<Tuple> (tuple), TupleIndexSequence<Tuple> {})))
+        {
+            forEachInTuple (std::forward<Fn> (fn), std::forward<Tuple> (tuple), TupleIndexSequence<Tuple> {});
+        }
+
+        template <typename ElementType, int arraySize, int alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT>
+        struct AlignedArray
+        {
+            template <typename IntType>
+            ElementType& operator[] (IntType index) noexcept
+            {
+                return array[index];
+            }
+            template <typename IntType>
+            const ElementType& operator[] (IntType index) const noexcept
+            {
+                return array[index];
+            }
+
+            ElementType* data() noexcept { return array; }
+            const ElementType* data() const noexcept { return array; }
+
+            void clear() { std::fill (std::begin (array), std::end (array), ElementType {}); }
+            static constexpr int size() noexcept { return arraySize; }
+
+        private:
+            alignas (alignment) ElementType array[array_pad<ElementType, (size_t) arraySize>()] {};
+        };
+
+        template <typename T, int nRows, int nCols = nRows, int alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT>
+        using Matrix = AlignedArray<T, nRows, alignment>[(size_t) nCols];
+
+        /** Implementation for float/double. */
+        template <typename T, int numPorts>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_)
+        {
+            // input matrix (S) of size dim x dim
+            // input vector (a) of size 1 x dim
+            // output vector (b) of size 1 x dim
+
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = (int) v_type::size;
+            constexpr auto vec_size = ceil_div (numPorts, simd_size) * simd_size;
+
+            for (int c = 0; c < vec_size; c += simd_size)
+            {
+                auto b_vec = a_[0] * xsimd::load_aligned (S_[0].data() + c);
+                for (int r = 1; r < numPorts; ++r)
+                    b_vec = xsimd::fma (xsimd::broadcast (a_[r]), xsimd::load_aligned (S_[r].data() + c), b_vec);
+
+                xsimd::store_aligned (b_.data() + c, b_vec);
+            }
+#else // No SIMD
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+#endif // SIMD options
+        }
+
+#if defined(XSIMD_HPP)
+        /** Implementation for SIMD float/double. */
+        template <typename T, int numPorts>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_)
+        {
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+        }
+#endif // XSIMD
+
+        /** Computes a single output of the scattering matrix: b[outIndex] = sum_r S_[r][outIndex] * a_[r]. */
+        template <typename T, int numPorts>
+        constexpr T RtypeScatterSingle (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, int outIndex)
+        {
+            T b = S_[0][outIndex] * a_[0];
+            for (int r = 1; r < numPorts; ++r)
+                b += S_[r][outIndex] * a_[r];
+            return b;
+        }
+    } // namespace rtype_detail
+} // namespace wdft
+
+namespace wdf
+{
+    /** Utility functions used internally by the R-Type adaptor */
+    namespace rtype_detail
+    {
+        using wdft::rtype_detail::ceil_div;
+
+        template <typename Signature>
+        class FunctionRef;
+
+        /**
+         * A non-owning, non-allocating reference to a callable, similar to std::function,
+         * but without the heap allocation or type-erased copies.
+         *
+         * Function pointers (and lambdas without captures) are stored by value, so they
+         * are always safe to use. Any other callable is stored by reference, so it must
+         * outlive the FunctionRef. To catch the most common mistake, temporary callables
+         * which can't be converted to a function pointer are not accepted.
+         */
+        template <typename R, typename... Args>
+        class FunctionRef<R (Args...)>
+        {
+        public:
+            using FunctionPointer = R (*) (Args...);
+
+            /** Wraps a function pointer. */
+            FunctionRef (FunctionPointer fn) noexcept : trampoline (&callFunction) { target.function = fn; }
+
+            /** Wraps a lambda without captures (or anything else convertible to a function pointer). */
+            template <typename Fn,
+                      typename = std::enable_if_t<std::is_convertible<Fn&&, FunctionPointer>::value
+                                                  && ! std::is_same<std::decay_t<Fn>, FunctionRef>::value>>
+            FunctionRef (Fn&& fn) noexcept : FunctionRef (static_cast<FunctionPointer> (fn))
+            {
+            }
+
+            /** Wraps a reference to a callable object, which must outlive the FunctionRef. */
+            template <typename Fn,
+                      typename = std::enable_if_t<! std::is_convertible<Fn&, FunctionPointer>::value
+                                                  && ! std::is_same<std::remove_const_t<Fn>, FunctionRef>::value>,
+                      typename = void>
+            FunctionRef (Fn& fn) noexcept : trampoline (&callObject<Fn>)
+            {
+                target.object = (void*) &fn;
+            }
+
+            R operator() (Args... args) const
+            {
+                return trampoline (target, std::forward<Args> (args)...);
+            }
+
+        private:
+            union Target
+            {
+                void* object;
+                FunctionPointer function;
+            };
+
+            static R callFunction (const Target& target, Args... args)
+            {
+                return target.function (std::forward<Args> (args)...);
+            }
+
+            template <typename Fn>
+            static R callObject (const Target& target, Args... args)
+            {
+                return (*(Fn*) target.object) (std::forward<Args> (args)...);
+            }
+
+            Target target;
+            R (*trampoline) (const Target&, Args...);
+        };
+
+        template <typename T>
+        typename std::enable_if<std::is_floating_point<T>::value, size_t>::type array_pad (size_t base_size)
+        {
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = v_type::size;
+            const auto num_simd_registers = ceil_div (base_size, simd_size);
+            return num_simd_registers * simd_size;
+#else
+            return base_size;
+#endif
+        }
+
+        template <typename T>
+        typename std::enable_if<! std::is_floating_point<T>::value, size_t>::type array_pad (size_t base_size)
+        {
+            return base_size;
+        }
+
+        template <typename ElementType>
+        struct AlignedArray
+        {
+            explicit AlignedArray (size_t size) : m_size ((int) size),
+                                                  vector (array_pad<ElementType> (size), ElementType {})
+            {
+            }
+
+            ElementType& operator[] (int index) noexcept { return vector[index]; }
+            const ElementType& operator[] (int index) const noexcept { return vector[index]; }
+
+            ElementType* data() noexcept { return vector.data(); }
+            const ElementType* data() const noexcept { return vector.data(); }
+
+            void clear() { std::fill (std::begin (vector), std::end (vector), ElementType {}); }
+            int size() const noexcept { return (int) m_size; }
+
+        private:
+            const int m_size;
+#if defined(XSIMD_HPP)
+            std::vector<ElementType, xsimd::default_allocator<ElementType>> vector;
+#else
+            std::vector<ElementType> vector;
+#endif
+        };
+
+        template <typename ElementType>
+        struct Matrix
+        {
+            Matrix (size_t nRows, size_t nCols) : vector (nCols, AlignedArray<ElementType> (nRows))
+            {
+            }
+
+            AlignedArray<ElementType>& operator[] (int index) noexcept { return vector[(size_t) index]; }
+            const AlignedArray<ElementType>& operator[] (int index) const noexcept { return vector[(size_t) index]; }
+
+        private:
+            std::vector<AlignedArray<ElementType>> vector;
+        };
+
+        /** Implementation for float/double. */
+        template <typename T>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T>& S_, const AlignedArray<T>& a_, AlignedArray<T>& b_)
+        {
+            // input matrix (S) of size dim x dim
+            // input vector (a) of size 1 x dim
+            // output vector (b) of size 1 x dim
+
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = (int) v_type::size;
+            const auto numPorts = a_.size();
+            const auto vec_size = ceil_div (numPorts, simd_size) * simd_size;
+
+            for (int c = 0; c < vec_size; c += simd_size)
+            {
+                auto b_vec = a_[0] * xsimd::load_aligned (S_[0].data() + c);
+                for (int r = 1; r < numPorts; ++r)
+                    b_vec = xsimd::fma (xsimd::broadcast (a_[r]), xsimd::load_aligned (S_[r].data() + c), b_vec);
+
+                xsimd::store_aligned (b_.data() + c, b_vec);
+            }
+#else // No SIMD
+            const auto numPorts = a_.size();
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+#endif // SIMD options
+        }
+
+#if defined(XSIMD_HPP)
+        /** Implementation for SIMD float/double. */
+        template <typename T>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T>& S_, const AlignedArray<T>& a_, AlignedArray<T>& b_)
+        {
+            const auto numPorts = a_.size();
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+        }
+#endif // XSIMD
+
+        /** Computes a single output of the scattering matrix: b[outIndex] = sum_r S_[r][outIndex] * a_[r]. */
+        template <typename T>
+        T RtypeScatterSingle (const Matrix<T>& S_, const AlignedArray<T>& a_, int outIndex)
+        {
+            const auto numPorts = a_.size();
+            T b = S_[0][outIndex] * a_[0];
+            for (int r = 1; r < numPorts; ++r)
+                b += S_[r][outIndex] * a_[r];
+            return b;
+        }
+    } // namespace rtype_detail
+} // namespace wdf
+#endif // DOXYGEN
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_RTYPE_DETAIL_H
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** WDF 3-port parallel adaptor */
+    template <typename T, typename Port1Type, typename Port2Type>
+    class WDFParallelT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF parallel adaptor from two connected ports. */
+        WDFParallelT (Port1Type& p1, Port2Type& p2) : port1 (p1),
+                                                      port2 (p2)
+        {
+            port1.connectToParent (this);
+            port2.connectToParent (this);
+            calcImpedance();
+        }
+
+        /** Computes the impedance for a WDF parallel adaptor.
+         *  1     1     1
+         * --- = --- + ---
+         * Z_p   Z_1   Z_2
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.G = port1.wdf.G + port2.wdf.G;
+            wdf.R = (T) 1.0 / wdf.G;
+            port1Reflect.set (port1.wdf.G / wdf.G);
+        }
+
+        /** Returns the adaptor impedance at compile-time, if both ports have fixed impedances. */
+        template <bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value,
+                  std::enable_if_t<isFixed, int> = 0>
+        static constexpr double getFixedImpedance() noexcept
+        {
+            return (Port1Type::getFixedImpedance() * Port2Type::getFixedImpedance())
+                   / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance());
+        }
+
+        /** Accepts an incident wave into a WDF parallel adaptor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto b2 = wdf.b - port2.wdf.b + x;
+            port1.incident (b2 + bDiff);
+            port2.incident (b2);
+
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF parallel adaptor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            port1.reflected();
+            port2.reflected();
+
+            bDiff = port2.wdf.b - port1.wdf.b;
+            wdf.b = port2.wdf.b - port1Reflect.get() * bDiff;
+
+            return wdf.b;
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+            fn (port2);
+        }
+
+        Port1Type& port1;
+        Port2Type& port2;
+
+        WDFMembers<T> wdf;
+
+    private:
+        /** G_1 / (G_1 + G_2), for fixed port impedances */
+        struct FixedPort1Reflect
+        {
+            static constexpr bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value;
+            static constexpr double value() noexcept { return Port2Type::getFixedImpedance() / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance()); }
+        };
+
+        fixed_detail::Coefficient<T, FixedPort1Reflect> port1Reflect;
+        T bDiff = (T) 0.0;
+    };
+
+    /** WDF 3-port series adaptor */
+    template <typename T, typename Port1Type, typename Port2Type>
+    class WDFSeriesT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF series adaptor from two connected ports. */
+        WDFSeriesT (Port1Type& p1, Port2Type& p2) : port1 (p1),
+                                                    port2 (p2)
+        {
+            port1.connectToParent (this);
+            port2.connectToParent (this);
+            calcImpedance();
+        }
+
+        /** Computes the impedance for a WDF parallel adaptor.
+         * Z_s = Z_1 + Z_2
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = port1.wdf.R + port2.wdf.R;
+            wdf.G = (T) 1.0 / wdf.R;
+            port1Reflect.set (port1.wdf.R / wdf.R);
+        }
+
+        /** Returns the adaptor impedance at compile-time, if both ports have fixed impedances. */
+        template <bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value,
+                  std::enable_if_t<isFixed, int> = 0>
+        static constexpr double getFixedImpedance() noexcept
+        {
+            return Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance();
+        }
+
+        /** Accepts an incident wave into a WDF series adaptor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto b1 = port1.wdf.b - port1Reflect.get() * (x + port1.wdf.b + port2.wdf.b);
+            port1.incident (b1);
+            port2.incident (-(x + b1));
+
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF series adaptor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -(port1.reflected() + port2.reflected());
+            return wdf.b;
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+            fn (port2);
+        }
+
+        Port1Type& port1;
+        Port2Type& port2;
+
+        WDFMembers<T> wdf;
+
+    private:
+        /** R_1 / (R_1 + R_2), for fixed port impedances */
+        struct FixedPort1Reflect
+        {
+            static constexpr bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value;
+            static constexpr double value() noexcept { return Port1Type::getFixedImpedance() / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance()); }
+        };
+
+        fixed_detail::Coefficient<T, FixedPort1Reflect> port1Reflect;
+    };
+
+    /**
+     * WDF (N+1)-port parallel adaptor.
+     *
+     * Equivalent to a chain of nested WDFParallelT adaptors, but the reflection
+     * coefficients for all of the ports are computed with a single division, and
+     * the waves are scattered to all of the ports at once, rather than one level
+     * of the tree at a time.
+     */
+    template <typename T, typename... PortTypes>
+    class WDFParallelNT final : public BaseWDF
+    {
+    public:
+        /** Number of ports connected "below" this adaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+        static_assert (numPorts >= 2, "WDFParallelNT needs at least two ports!");
+
+        /** Creates a new WDF parallel adaptor from the connected ports. */
+        explicit WDFParallelNT (PortTypes&... ps) : ports (std::tie (ps...))
+        {
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t) { port.connectToParent (this); },
+                                          ports);
+            calcImpedance();
+        }
+
+        /** Computes the impedance for a WDF parallel adaptor.
+         *  1     1           1
+         * --- = --- + ... + ---
+         * Z_p   Z_1         Z_N
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { portG[i] = port.wdf.G; },
+                                          ports);
+
+            wdf.G = portG[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.G += portG[i];
+            wdf.R = (T) 1.0 / wdf.G;
+
+            for (int i = 0; i < numPorts; ++i)
+                portReflect[i] = portG[i] * wdf.R;
+        }
+
+        /** Accepts an incident wave into a WDF parallel adaptor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto bPlusX = wdf.b + x;
+            for (int i = 0; i < numPorts; ++i)
+                b_vec[i] = bPlusX - a_vec[i];
+
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { port.incident (b_vec[i]); },
+                                          ports);
+
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF parallel adaptor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { a_vec[i] = port.reflected(); },
+                                          ports);
+
+            wdf.b = portReflect[0] * a_vec[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.b += portReflect[i] * a_vec[i];
+
+            return wdf.b;
+        }
+
+        /** Returns the port connected at the given index. */
+        template <int Index>
+        auto& getPort() noexcept
+        {
+            return std::get<Index> (ports);
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          ports);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        std::tuple<PortTypes&...> ports;
+
+        rtype_detail::AlignedArray<T, numPorts> portG; // port admittances
+        rtype_detail::AlignedArray<T, numPorts> portReflect; // reflection coefficients
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // waves reflected from the ports
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // waves incident to the ports
+    };
+
+    /**
+     * WDF (N+1)-port series adaptor.
+     *
+     * Equivalent to a chain of nested WDFSeriesT adaptors, but the reflection
+     * coefficients for all of the ports are computed with a single division, and
+     * the waves are scattered to all of the ports at once, rather than one level
+     * of the tree at a time.
+     *
+     * Note that all of the ports are connected with the same orientation, whereas in
+     * a chain of WDFSeriesT adaptors, each nested adaptor flips the polarity of the
+     * ports below it.
+     */
+    template <typename T, typename... PortTypes>
+    class WDFSeriesNT final : public BaseWDF
+    {
+    public:
+        /** Number of ports connected "below" this adaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+        static_assert (numPorts >= 2, "WDFSeriesNT needs at least two ports!");
+
+        /** Creates a new WDF series adaptor from the connected ports. */
+        explicit WDFSeriesNT (PortTypes&... ps) : ports (std::tie (ps...))
+        {
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t) { port.connectToParent (this); },
+                                          ports);
+            calcImpedance();
+        }
+
+        /** Computes the impedance for a WDF series adaptor.
+         * Z_s = Z_1 + ... + Z_N
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { portR[i] = port.wdf.R; },
+                                          ports);
+
+            wdf.R = portR[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.R += portR[i];
+            wdf.G = (T) 1.0 / wdf.R;
+
+            for (int i = 0; i < numPorts; ++i)
+                portReflect[i] = portR[i] * wdf.G;
+        }
+
+        /** Accepts an incident wave into a WDF series adaptor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto waveSum = x - wdf.b; // x + a_1 + ... + a_N
+            for (int i = 0; i < numPorts; ++i)
+                b_vec[i] = a_vec[i] - portReflect[i] * waveSum;
+
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { port.incident (b_vec[i]); },
+                                          ports);
+
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF series adaptor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { a_vec[i] = port.reflected(); },
+                                          ports);
+
+            wdf.b = a_vec[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.b += a_vec[i];
+            wdf.b = -wdf.b;
+
+            return wdf.b;
+        }
+
+        /** Returns the port connected at the given index. */
+        template <int Index>
+        auto& getPort() noexcept
+        {
+            return std::get<Index> (ports);
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          ports);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        std::tuple<PortTypes&...> ports;
+
+        rtype_detail::AlignedArray<T, numPorts> portR; // port impedances
+        rtype_detail::AlignedArray<T, numPorts> portReflect; // reflection coefficients
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // waves reflected from the ports
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // waves incident to the ports
+    };
+
+    /** WDF Voltage Polarity Inverter */
+    template <typename T, typename PortType>
+    class PolarityInverterT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF polarity inverter */
+        explicit PolarityInverterT (PortType& p) : port1 (p)
+        {
+            port1.connectToParent (this);
+            calcImpedance();
+        }
+
+        /** Calculates the impedance of the WDF inverter
+         * (same impedance as the connected node).
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = port1.wdf.R;
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Accepts an incident wave into a WDF inverter. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            port1.incident (-x);
+        }
+
+        /** Propogates a reflected wave from a WDF inverter. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -port1.reflected();
+            return wdf.b;
+        }
+
+        /** Calls fn for the port connected to this inverter. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        PortType& port1;
+    };
+
+    /** WDF y-parameter 2-port (short circuit admittance) */
+    template <typename T, typename PortType>
+    class YParameterT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Y-Parameter, with the given coefficients */
+        YParameterT (PortType& port1, T y11, T y12, T y21, T y22) : port1 (port1)
+        {
+            y[0][0] = y11;
+            y[0][1] = y12;
+            y[1][0] = y21;
+            y[1][1] = y22;
+
+            port1.connectToParent (this);
+            calcImpedance();
+        }
+
+        /** Calculates the impedance of the WDF Y-Parameter */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            denominator = y[1][1] + port1.wdf.R * y[0][0] * y[1][1] - port1.wdf.R * y[0][1] * y[1][0];
+            wdf.R = (port1.wdf.R * y[0][0] + (T) 1.0) / denominator;
+            wdf.G = (T) 1.0 / wdf.R;
+
+            T rSq = port1.wdf.R * port1.wdf.R;
+            T num1A = -y[1][1] * rSq * y[0][0] * y[0][0];
+            T num2A = y[0][1] * y[1][0] * rSq * y[0][0];
+
+            A = (num1A + num2A + y[1][1]) / (denominator * (port1.wdf.R * y[0][0] + (T) 1.0));
+            B = -port1.wdf.R * y[0][1] / (port1.wdf.R * y[0][0] + (T) 1.0);
+            C = -y[1][0] / denominator;
+        }
+
+        /** Accepts an incident wave into a WDF Y-Parameter. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            port1.incident (A * port1.wdf.b + B * x);
+        }
+
+        /** Propogates a reflected wave from a WDF Y-Parameter. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = C * port1.reflected();
+            return wdf.b;
+        }
+
+        /** Calls fn for the port connected to this Y-Parameter. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        PortType& port1;
+        T y[2][2] = { { (T) 0.0, (T) 0.0 }, { (T) 0.0, (T) 0.0 } };
+
+        T denominator = (T) 1.0;
+        T A = (T) 1.0;
+        T B = (T) 1.0;
+        T C = (T) 1.0;
+    };
+
+    // useful "factory" functions so you don't have to declare all the template parameters
+
+    /** Factory method for creating a parallel adaptor between two elements. */
+    template <typename T, typename P1Type, typename P2Type>
+    CHOWDSP_WDF_MAYBE_UNUSED WDFParallelT<T, P1Type, P2Type> makeParallel (P1Type& p1, P2Type& p2)
+    {
+        return WDFParallelT<T, P1Type, P2Type> (p1, p2);
+    }
+
+    /** Factory method for creating a series adaptor between two elements. */
+    template <typename T, typename P1Type, typename P2Type>
+    CHOWDSP_WDF_MAYBE_UNUSED WDFSeriesT<T, P1Type, P2Type> makeSeries (P1Type& p1, P2Type& p2)
+    {
+        return WDFSeriesT<T, P1Type, P2Type> (p1, p2);
+    }
+
+    /** Factory method for creating a polarity inverter. */
+    template <typename T, typename PType>
+    CHOWDSP_WDF_MAYBE_UNUSED PolarityInverterT<T, PType> makeInverter (PType& p1)
+    {
+        return PolarityInverterT<T, PType> (p1);
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDFT_ADAPTORS_H
+
+// #include "wdft_fusion.h"
+#ifndef CHOWDSP_WDF_WDFT_FUSION_H
+#define CHOWDSP_WDF_WDFT_FUSION_H
+
+#include <type_traits>
+
+// #include "wdft_one_ports.h"
+
+// #include "wdft_sources.h"
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace fusion_detail
+    {
+        /**
+         * Maps a pair of one-ports connected in series to the fused element
+         * which implements them both. Pairs which can't be fused have no "type".
+         */
+        template <typename T, typename P1Type, typename P2Type>
+        struct FusedSeries
+        {
+        };
+
+        /** Same as FusedSeries, but for one-ports connected in parallel. */
+        template <typename T, typename P1Type, typename P2Type>
+        struct FusedParallel
+        {
+        };
+
+        /** Series and parallel connections are symmetric, so the ports may come in either order. */
+        template <typename Fusion>
+        struct SwapPorts
+        {
+            using type = typename Fusion::type;
+
+            template <typename P1Type, typename P2Type>
+            static type make (const P1Type& p1, const P2Type& p2)
+            {
+                return Fusion::make (p2, p1);
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, CapacitorT<T>>
+        {
+            using type = ResistorCapacitorSeriesT<T>;
+
+            static type make (const ResistorT<T>& r, const CapacitorT<T>& c)
+            {
+                return type { r.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, InductorT<T>>
+        {
+            using type = ResistorInductorSeriesT<T>;
+
+            static type make (const ResistorT<T>& r, const InductorT<T>& l)
+            {
+                return type { r.getResistanceValue(), l.getInductanceValue(), l.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, InductorT<T>, CapacitorT<T>>
+        {
+            using type = InductorCapacitorSeriesT<T>;
+
+            static type make (const InductorT<T>& l, const CapacitorT<T>& c)
+            {
+                return type { l.getInductanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, InductorCapacitorSeriesT<T>>
+        {
+            using type = ResistorInductorCapacitorSeriesT<T>;
+
+            static type make (const ResistorT<T>& r, const InductorCapacitorSeriesT<T>& lc)
+            {
+                return type { r.getResistanceValue(), lc.getInductanceValue(), lc.getCapacitanceValue(), lc.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, ResistorCapacitorParallelT<T>>
+        {
+            using type = CapacitorESRT<T>;
+
+            static type make (const ResistorT<T>& esr, const ResistorCapacitorParallelT<T>& leakyCap)
+            {
+                return type { leakyCap.getCapacitanceValue(), esr.getResistanceValue(), leakyCap.getSampleRate(), leakyCap.getResistanceValue() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistiveVoltageSourceT<T>, CapacitorT<T>>
+        {
+            using type = ResistiveCapacitiveVoltageSourceT<T>;
+
+            static type make (const ResistiveVoltageSourceT<T>& vs, const CapacitorT<T>& c)
+            {
+                type fused { vs.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+                fused.setVoltage (vs.getVoltage());
+                return fused;
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistorT<T>, CapacitorT<T>>
+        {
+            using type = ResistorCapacitorParallelT<T>;
+
+            static type make (const ResistorT<T>& r, const CapacitorT<T>& c)
+            {
+                return type { r.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistorT<T>, InductorT<T>>
+        {
+            using type = ResistorInductorParallelT<T>;
+
+            static type make (const ResistorT<T>& r, const InductorT<T>& l)
+            {
+                return type { r.getResistanceValue(), l.getInductanceValue(), l.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, InductorT<T>, CapacitorT<T>>
+        {
+            using type = InductorCapacitorParallelT<T>;
+
+            static type make (const InductorT<T>& l, const CapacitorT<T>& c)
+            {
+                return type { l.getInductanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistiveCurrentSourceT<T>, CapacitorT<T>>
+        {
+            using type = ResistiveCapacitiveCurrentSourceT<T>;
+
+            static type make (const ResistiveCurrentSourceT<T>& is, const CapacitorT<T>& c)
+            {
+                type fused { is.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+                fused.setCurrent (is.getCurrent());
+                return fused;
+            }
+        };
+
+        // clang-format off
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedSeries<T, InductorT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, InductorT<T>>> {};
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, InductorT<T>> : SwapPorts<FusedSeries<T, InductorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedSeries<T, InductorCapacitorSeriesT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, InductorCapacitorSeriesT<T>>> {};
+        template <typename T> struct FusedSeries<T, ResistorCapacitorParallelT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, ResistorCapacitorParallelT<T>>> {};
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, ResistiveVoltageSourceT<T>> : SwapPorts<FusedSeries<T, ResistiveVoltageSourceT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, ResistorT<T>> : SwapPorts<FusedParallel<T, ResistorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, InductorT<T>, ResistorT<T>> : SwapPorts<FusedParallel<T, ResistorT<T>, InductorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, InductorT<T>> : SwapPorts<FusedParallel<T, InductorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, ResistiveCurrentSourceT<T>> : SwapPorts<FusedParallel<T, ResistiveCurrentSourceT<T>, CapacitorT<T>>> {};
+        // clang-format on
+
+        /** Only temporaries can be fused, since nothing else may be holding a reference to them. */
+        template <typename P1Type, typename P2Type>
+        using EnableIfTemporaries = std::enable_if_t<! std::is_lvalue_reference<P1Type>::value && ! std::is_lvalue_reference<P2Type>::value>;
+    } // namespace fusion_detail
+#endif // DOXYGEN
+
+    /** The fused element which replaces the series connection of P1Type and P2Type. */
+    template <typename T, typename P1Type, typename P2Type>
+    using FusedSeriesT = typename fusion_detail::FusedSeries<T, P1Type, P2Type>::type;
+
+    /** The fused element which replaces the parallel connection of P1Type and P2Type. */
+    template <typename T, typename P1Type, typename P2Type>
+    using FusedParallelT = typename fusion_detail::FusedParallel<T, P1Type, P2Type>::type;
+
+    /**
+     * Factory method for fusing two elements connected in series into a single element.
+     *
+     * When makeSeries() is called with two temporary elements (rather than references to
+     * elements that live elsewhere), the pair is replaced by the equivalent fused element,
+     * chosen at compile-time. Fused elements may be fused again, so that nested factory
+     * calls can collapse a whole sub-tree:
+     * @code
+     * // ResistorInductorCapacitorSeriesT<float>
+     * auto rlc = wdft::makeSeries<float> (wdft::ResistorT<float> { 100.0f },
+     *                                     wdft::makeSeries<float> (wdft::InductorT<float> { 10.0e-3f, fs },
+     *                                                              wdft::CapacitorT<float> { 1.0e-6f, fs }));
+     * rlc.setResistanceValue (220.0f);
+     * @endcode
+     *
+     * The fused element takes its values from the temporary elements, and has the same
+     * setters (setResistanceValue(), setCapacitanceValue(), etc.). Since the temporaries
+     * don't outlive the call, the internal states of the fused element can't be probed
+     * separately. The supported combinations are:
+     *  - Resistor + Capacitor, Resistor + Inductor, Inductor + Capacitor
+     *  - Resistor + (Inductor + Capacitor): ResistorInductorCapacitorSeriesT
+     *  - Resistor + (Capacitor || Resistor): CapacitorESRT
+     *  - ResistiveVoltageSource + Capacitor: ResistiveCapacitiveVoltageSourceT
+     *
+     * Other combinations don't compile, and should use the reference version of makeSeries().
+     */
+    template <typename T, typename P1Type, typename P2Type, typename = fusion_detail::EnableIfTemporaries<P1Type, P2Type>>
+    CHOWDSP_WDF_MAYBE_UNUSED FusedSeriesT<T, std::decay_t<P1Type>, std::decay_t<P2Type>> makeSeries (P1Type&& p1, P2Type&& p2)
+    {
+        return fusion_detail::FusedSeries<T, std::decay_t<P1Type>, std::decay_t<P2Type>>::make (p1, p2);
+    }
+
+    /**
+     * Factory method for fusing two elements connected in parallel into a single element.
+     *
+     * This works the same way as the fusing version of makeSeries(). The supported combinations are:
+     *  - Resistor || Capacitor, Resistor || Inductor, Inductor || Capacitor
+     *  - ResistiveCurrentSource || Capacitor: ResistiveCapacitiveCurrentSourceT
+     */
+    template <typename T, typename P1Type, typename P2Type, typename = fusion_detail::EnableIfTemporaries<P1Type, P2Type>>
+    CHOWDSP_WDF_MAYBE_UNUSED FusedParallelT<T, std::decay_t<P1Type>, std::decay_t<P2Type>> makeParallel (P1Type&& p1, P2Type&& p2)
+    {
+        return fusion_detail::FusedParallel<T, std::decay_t<P1Type>, std::decay_t<P2Type>>::make (p1, p2);
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDFT_FUSION_H
+
+// #include "wdft_nonlinearities.h"
+#ifndef CHOWDSP_WDF_WDFT_NONLINEARITIES_H
+#define CHOWDSP_WDF_WDFT_NONLINEARITIES_H
+
+#include <cmath>
+
+// #include "wdft_base.h"
+
+
+// #include "../math/signum.h"
+
+
+namespace chowdsp
+{
+/** Methods for implementing the signum function */
+namespace signum
+{
+    /** Signum function to determine the sign of the input. */
+    template <typename T>
+    inline int signum (T val)
+    {
+        return (T (0) < val) - (val < T (0));
+    }
+
+#if defined(XSIMD_HPP)
+    /** Signum function to determine the sign of the input. */
+    template <typename T>
+    inline xsimd::batch<T> signum (xsimd::batch<T> val)
+    {
+        using v_type = xsimd::batch<T>;
+        const auto positive = xsimd::select (val > v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
+        const auto negative = xsimd::select (val < v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
+        return positive - negative;
+    }
+#endif
+
+} // namespace signum
+} // namespace chowdsp
+
+// #include "../math/omega.h"
+/*
+ * Copyright (C) 2019 Stefano D'Angelo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * NOTE: code has been modified significantly by Jatin Chowdhury
+ */
+
+#ifndef OMEGA_H_INCLUDED
+#define OMEGA_H_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+// #include "sample_type.h"
+
+
+namespace chowdsp
+{
+/**
+ * Useful approximations for evaluating the Wright Omega function.
+ *
+ * This approach was devloped by Stefano D'Angelo, and adapted from his
+ * original implementation under the MIT license.
+ * - Paper: https://www.dafx.de/paper-archive/2019/DAFx2019_paper_5.pdf
+ * - Original Source: https://www.dangelo.audio/dafx2019-omega.html
+ */
+namespace Omega
+{
+    /**
+     * Evaluates a polynomial of a given order, using Estrin's scheme.
+     * Coefficients should be given in the form { a_n, a_n-1, ..., a_1, a_0 }
+     * https://en.wikipedia.org/wiki/Estrin%27s_scheme
+     */
+    template <int ORDER, typename T, typename X>
+    inline typename std::enable_if<(ORDER == 1), decltype (T {} * X {})>::type estrin (const T (&coeffs)[ORDER + 1], const X& x)
+    {
+        return coeffs[1] + coeffs[0] * x;
+    }
+
+    template <int ORDER, typename T, typename X>
+    inline typename std::enable_if<(ORDER > 1), decltype (T {} * X {})>::type estrin (const T (&coeffs)[ORDER + 1], const X& x)
+    {
+        decltype (T {} * X {}) temp[ORDER / 2 + 1];
+        for (int n = ORDER; n >= 0; n -= 2)
+            temp[n / 2] = coeffs[n] + coeffs[n - 1] * x;
+
+        temp[0] = (ORDER % 2 == 0) ? coeffs[0] : temp[0];
+
+        return estrin<ORDER / 2> (temp, x * x); // recurse!
+    }
+
+    /** approximation for log_2(x), optimized on the range [1, 2] */
+    template <typename T>
+    constexpr T log2_approx (T x)
+    {
+        constexpr auto alpha = (T) 0.1640425613334452;
+        constexpr auto beta = (T) -1.098865286222744;
+        constexpr auto gamma = (T) 3.148297929334117;
+        constexpr auto zeta = (T) -2.213475204444817;
+
+        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
+    }
+
+#if defined(XSIMD_HPP)
+    /** approximation for log_2(x), optimized on the range [1, 2] */
+    template <typename T>
+    inline xsimd::batch<T> log2_approx (const xsimd::batch<T>& x)
+    {
+        static constexpr auto alpha = (NumericType<T>) 0.1640425613334452;
+        static constexpr auto beta = (NumericType<T>) -1.098865286222744;
+        static constexpr auto gamma = (NumericType<T>) 3.148297929334117;
+        static constexpr auto zeta = (NumericType<T>) -2.213475204444817;
+
+        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
+    }
+#endif
+
+    /** approximation for log(x) */
+    template <typename T>
+    constexpr T log_approx (T x);
+
+    /** approximation for log(x) (32-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED constexpr float log_approx (float x)
+    {
+        union
+        {
+            int32_t i;
+            float f;
+        } v {};
+        v.f = x;
+        int32_t ex = v.i & 0x7f800000;
+        int32_t e = (ex >> 23) - 127;
+        v.i = (v.i - ex) | 0x3f800000;
+
+        return 0.693147180559945f * ((float) e + log2_approx<float> (v.f));
+    }
+
+    /** approximation for log(x) (64-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED constexpr double log_approx (double x)
+    {
+        union
+        {
+            int64_t i;
+            double d;
+        } v {};
+        v.d = x;
+        int64_t ex = v.i & 0x7ff0000000000000;
+        int64_t e = (ex >> 53) - 510;
+        v.i = (v.i - ex) | 0x3ff0000000000000;
+
+        return 0.693147180559945 * ((double) e + log2_approx<double> (v.d));
+    }
+
+#if defined(XSIMD_HPP)
+    /** approximation for log(x) (SIMD 32-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<float> log_approx (xsimd::batch<float> x)
+    {
+        union
+        {
+            xsimd::batch<int32_t> i;
+            xsimd::batch<float> f;
+        } v;
+        v.f = x;
+        xsimd::batch<int32_t> ex = v.i & 0x7f800000;
+        xsimd::batch<float> e = xsimd::to_float ((ex >> 23) - 127);
+        v.i = (v.i - ex) | 0x3f800000;
+
+        return 0.693147180559945f * (log2_approx<float> (v.f) + e);
+    }
+
+    /** approximation for log(x) (64-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<double> log_approx (xsimd::batch<double> x)
+    {
+        union
+        {
+            xsimd::batch<int64_t> i;
+            xsimd::batch<double> d;
+        } v {};
+        v.d = x;
+        xsimd::batch<int64_t> ex = v.i & 0x7ff0000000000000;
+        xsimd::batch<double> e = xsimd::to_float ((ex >> 53) - 510);
+        v.i = (v.i - ex) | 0x3ff0000000000000;
+
+        return 0.693147180559945 * (e + log2_approx<double> (v.d));
+    }
+#endif
+
+    /** approximation for 2^x, optimized on the range [0, 1] */
+    template <typename T>
+    constexpr T pow2_approx (T x)
+    {
+        constexpr auto alpha = (T) 0.07944154167983575;
+        constexpr auto beta = (T) 0.2274112777602189;
+        constexpr auto gamma = (T) 0.6931471805599453;
+        constexpr auto zeta = (T) 1.0;
+
+        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
+    }
+
+#if defined(XSIMD_HPP)
+    template <typename T>
+    inline xsimd::batch<T> pow2_approx (const xsimd::batch<T>& x)
+    {
+        static constexpr auto alpha = (NumericType<T>) 0.07944154167983575;
+        static constexpr auto beta = (NumericType<T>) 0.2274112777602189;
+        static constexpr auto gamma = (NumericType<T>) 0.6931471805599453;
+        static constexpr auto zeta = (NumericType<T>) 1.0;
+
+        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
+    }
+#endif
+
+    /** approximation for exp(x) */
+    template <typename T>
+    T exp_approx (T x);
+
+    /** approximation for exp(x) (32-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED constexpr float exp_approx (float x)
+    {
+        x = std::max (-126.0f, 1.442695040888963f * x);
+
+        union
+        {
+            int32_t i;
+            float f;
+        } v {};
+
+        auto xi = (int32_t) x;
+        int32_t l = x < 0.0f ? xi - 1 : xi;
+        float f = x - (float) l;
+        v.i = (l + 127) << 23;
+
+        return v.f * pow2_approx<float> (f);
+    }
+
+    /** approximation for exp(x) (64-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED constexpr double exp_approx (double x)
+    {
+        x = std::max ((double) -126.0, 1.442695040888963 * x);
+
+        union
+        {
+            int64_t i;
+            double d;
+        } v {};
+
+        auto xi = (int64_t) x;
+        int64_t l = x < 0.0 ? xi - 1 : xi;
+        double d = x - (double) l;
+        v.i = (l + 1023) << 52;
+
+        return v.d * pow2_approx<double> (d);
+    }
+
+#if defined(XSIMD_HPP)
+    /** approximation for exp(x) (32-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<float> exp_approx (xsimd::batch<float> x)
+    {
+        x = xsimd::max (xsimd::broadcast (-126.0f), 1.442695040888963f * x);
+
+        union
+        {
+            xsimd::batch<int32_t> i;
+            xsimd::batch<float> f;
+        } v {};
+
+        auto xi = xsimd::to_int (x);
+        xsimd::batch<int32_t> l = xsimd::select (xi < 0, xi - 1, xi);
+        xsimd::batch<float> f = x - xsimd::to_float (l);
+        v.i = (l + 127) << 23;
+
+        return v.f * pow2_approx<float> (f);
+    }
+
+    /** approximation for exp(x) (64-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<double> exp_approx (xsimd::batch<double> x)
+    {
+        x = xsimd::max (xsimd::broadcast (-126.0), 1.442695040888963 * x);
+
+        union
+        {
+            xsimd::batch<int64_t> i;
+            xsimd::batch<double> d;
+        } v {};
+
+        auto xi = xsimd::to_int (x);
+        xsimd::batch<int64_t> l = xsimd::select (xi < 0, xi - 1, xi);
+        xsimd::batch<double> d = x - xsimd::to_float (l);
+        v.i = (l + 1023) << 52;
+
+        return v.d * pow2_approx<double> (d);
+    }
+#endif
+
+    /** First-order approximation of the Wright Omega functions */
+    template <typename T>
+    constexpr T omega1 (T x)
+    {
+#if defined(XSIMD_HPP)
+        using xsimd::max;
+#endif
+        using std::max;
+
+        return max (x, (T) 0);
+    }
+
+    /** Second-order approximation of the Wright Omega functions */
+    template <typename T>
+    constexpr T omega2 (T x)
+    {
+        constexpr auto x1 = (NumericType<T>) -3.684303659906469;
+        constexpr auto x2 = (NumericType<T>) 1.972967391708859;
+        constexpr auto a = (NumericType<T>) 9.451797158780131e-3;
+        constexpr auto b = (NumericType<T>) 1.126446405111627e-1;
+        constexpr auto c = (NumericType<T>) 4.451353886588814e-1;
+        constexpr auto d = (NumericType<T>) 5.836596684310648e-1;
+
+        return select (x < x1, (T) 0, select (x > x2, x, estrin<3> ({ a, b, c, d }, x)));
+    }
+
+    /** Third-order approximation of the Wright Omega functions */
+    template <typename T>
+    constexpr T omega3 (T x)
+    {
+        constexpr auto x1 = (NumericType<T>) -3.341459552768620;
+        constexpr auto x2 = (NumericType<T>) 8.0;
+        constexpr auto a = (NumericType<T>) -1.314293149877800e-3;
+        constexpr auto b = (NumericType<T>) 4.775931364975583e-2;
+        constexpr auto c = (NumericType<T>) 3.631952663804445e-1;
+        constexpr auto d = (NumericType<T>) 6.313183464296682e-1;
+
+        return select (x < x1, (T) 0, select (x < x2, estrin<3> ({ a, b, c, d }, x), x - log_approx<T> (x)));
+    }
+
+    /** Fourth-order approximation of the Wright Omega functions */
+    template <typename T>
+    constexpr T omega4 (T x)
+    {
+        const auto y = omega3<T> (x);
+        return y - (y - exp_approx<T> (x - y)) / (y + (T) 1);
+    }
+
+    struct Omega
+    {
+        template <typename T>
+        static T omega (T x)
+        {
+            return omega4 (x);
+        }
+    };
+} // namespace Omega
+} // namespace chowdsp
+
+#endif //OMEGA_H_INCLUDED
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** Enum to determine which diode approximation eqn. to use */
+    enum DiodeQuality
+    {
+        Good, // see reference eqn (18)
+        Best, // see reference eqn (39)
+    };
+
+    /**
+     * WDF diode pair (non-adaptable)
+     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
+     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
+     */
+    template <typename T, typename Next, DiodeQuality Quality = DiodeQuality::Best, typename OmegaProvider = Omega::Omega>
+    class DiodePairT final : public RootWDF
+    {
+    public:
+        /**
+         * Creates a new WDF diode pair, with the given diode specifications.
+         * @param n: the next element in the WDF connection tree
+         * @param Is: reverse saturation current
+         * @param Vt: thermal voltage
+         * @param nDiodes: the number of series diodes
+         */
+        DiodePairT (Next& n, T Is, T Vt = NumericType<T> (25.85e-3), T nDiodes = 1) : next (n)
+        {
+            n.connectToParent (this);
+            setDiodeParameters (Is, Vt, nDiodes);
+        }
+
+        /** Sets diode specific parameters */
+        void setDiodeParameters (T newIs, T newVt, T nDiodes)
+        {
+            Is = newIs;
+            Vt = nDiodes * newVt;
+            twoVt = (T) 2 * Vt;
+            oneOverVt = (T) 1 / Vt;
+            calcImpedance();
+        }
+
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+#if defined(XSIMD_HPP)
+            using xsimd::log;
+#endif
+            using std::log;
+
+            R_Is = next.wdf.R * Is;
+            R_Is_overVt = R_Is * oneOverVt;
+            logR_Is_overVt = log (R_Is_overVt);
+        }
+
+        /** Accepts an incident wave into a WDF diode pair. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF diode pair. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            reflectedInternal();
+            return wdf.b;
+        }
+
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        /** Implementation for float/double (Good). */
+        template <typename C = T, DiodeQuality Q = Quality>
+        inline typename std::enable_if<Q == Good, void>::type
+            reflectedInternal() noexcept
+        {
+            // See eqn (18) from reference paper
+            T lambda = (T) signum::signum (wdf.a);
+            wdf.b = wdf.a + (T) 2 * lambda * (R_Is - Vt * OmegaProvider::omega (logR_Is_overVt + lambda * wdf.a * oneOverVt + R_Is_overVt));
+        }
+
+        /** Implementation for float/double (Best). */
+        template <typename C = T, DiodeQuality Q = Quality>
+        inline typename std::enable_if<Q == Best, void>::type
+            reflectedInternal() noexcept
+        {
+            // See eqn (39) from reference paper
+            T lambda = (T) signum::signum (wdf.a);
+            T lambda_a_over_vt = lambda * wdf.a * oneOverVt;
+            wdf.b = wdf.a - twoVt * lambda * (Omega::omega4 (logR_Is_overVt + lambda_a_over_vt) - Omega::omega4 (logR_Is_overVt - lambda_a_over_vt));
+        }
+
+        T Is; // reverse saturation current
+        T Vt; // thermal voltage
+
+        // pre-computed vars
+        T twoVt;
+        T oneOverVt;
+        T R_Is;
+        T R_Is_overVt;
+        T logR_Is_overVt;
+
+        Next& next;
+    };
+
+    /**
+     * WDF diode (non-adaptable)
+     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
+     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
+     */
+    template <typename T, typename Next, DiodeQuality Quality = DiodeQuality::Best, typename OmegaProvider = Omega::Omega>
+    class DiodeT final : public RootWDF
+    {
+    public:
+        /**
+         * Creates a new WDF diode, with the given diode specifications.
+         * @param n: the next element in the WDF connection tree
+         * @param Is: reverse saturation current
+         * @param Vt: thermal voltage
+         * @param nDiodes: the number of series diodes
+         */
+        DiodeT (Next& n, T Is, T Vt = NumericType<T> (25.85e-3), T nDiodes = 1) : next (n)
+        {
+            n.connectToParent (this);
+            setDiodeParameters (Is, Vt, nDiodes);
+        }
+
+        /** Sets diode specific parameters */
+        void setDiodeParameters (T newIs, T newVt, T nDiodes)
+        {
+            Is = newIs;
+            Vt = nDiodes * newVt;
+            twoVt = (T) 2 * Vt;
+            oneOverVt = (T) 1 / Vt;
+            calcImpedance();
+        }
+
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+#if defined(XSIMD_HPP)
+            using xsimd::log;
+#endif
+            using std::log;
+
+            twoR_Is = (T) 2 * next.wdf.R * Is;
+            R_Is_overVt = next.wdf.R * Is * oneOverVt;
+            logR_Is_overVt = log (R_Is_overVt);
+        }
+
+        /** Accepts an incident wave into a WDF diode. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF diode. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            // See eqn (10) from reference paper
+            wdf.b = wdf.a + twoR_Is - twoVt * OmegaProvider::omega (logR_Is_overVt + wdf.a * oneOverVt + R_Is_overVt);
+            return wdf.b;
+        }
+
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T Is; // reverse saturation current
+        T Vt; // thermal voltage
+
+        // pre-computed vars
+        T twoVt;
+        T oneOverVt;
+        T twoR_Is;
+        T R_Is_overVt;
+        T logR_Is_overVt;
+
+        Next& next;
+    };
+
+    /** WDF Switch (non-adaptable) */
+    template <typename T, typename Next>
+    class SwitchT final : public RootWDF
+    {
+    public:
+        explicit SwitchT (Next& n) : next (n)
+        {
+            n.connectToParent (this);
+        }
+
+        inline void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
+
+        /** Sets the state of the switch. */
+        void setClosed (bool shouldClose) { closed = shouldClose; }
+
+        /** Accepts an incident wave into a WDF switch. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF switch. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = closed ? -wdf.a : wdf.a;
+            return wdf.b;
+        }
+
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        Next& next;
+
+        bool closed = true;
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDFT_NONLINEARITIES_H
+
+
+#endif // CHOWDSP_WDF_T_INCLUDED
+
+
+namespace chowdsp
+{
+namespace wdf
+{
+    /** Wave digital filter base class */
+    template <typename T>
+    class WDF : public wdft::BaseWDF
+    {
+    public:
+        explicit WDF (std::string type) : type (std::move (type)) {}
+        ~WDF() override = default;
+
+        void connectToNode (WDF<T>* p) { wdfParent = p; }
+
+        /** Sub-classes override this function to propagate
+     * an impedance change to the upstream elements in
+     * the WDF tree.
+     */
+        virtual inline void propagateImpedance()
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
+            calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
+
+            if (wdfParent != nullptr)
+                wdfParent->propagateImpedance();
+        }
+
+        /** Sub-classes override this function to accept an incident wave. */
+        virtual void incident (T x) noexcept = 0;
+
+        /** Sub-classes override this function to propogate a reflected wave. */
+        virtual T reflected() noexcept = 0;
+
+        /** Interface for visiting the ports connected to an element (see visitPorts()). */
+        struct PortVisitor
+        {
+            virtual ~PortVisitor() = default;
+            virtual void visit (WDF<T>& port) = 0;
+        };
+
+        /** Interface for visiting the internal state of an element (see visitState()). */
+        struct StateVisitor
+        {
+            virtual ~StateVisitor() = default;
+            virtual void visit (T& state) = 0;
+        };
+
+        /** Sub-classes override this function to visit each of their connected ports. */
+        virtual void visitConnectedPorts (PortVisitor&) {}
+
+        /** Sub-classes override this function to visit each of their internal state variables. */
+        virtual void visitInternalState (StateVisitor&) {}
+
+        /** Calls fn for each port connected "below" this element in the WDF tree. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            struct Visitor : PortVisitor
+            {
+                explicit Visitor (std::remove_reference_t<Fn>& f) : fn (f) {}
+                void visit (WDF<T>& port) override { fn (port); }
+                std::remove_reference_t<Fn>& fn;
+            } visitor { fn };
+            visitConnectedPorts (visitor);
+        }
+
+        /** Calls visitor with a reference to each of this element's internal state variables. */
+        template <typename Fn>
+        void visitState (Fn&& fn)
+        {
+            struct Visitor : StateVisitor
+            {
+                explicit Visitor (std::remove_reference_t<Fn>& f) : fn (f) {}
+                void visit (T& state) override { fn (state); }
+                std::remove_reference_t<Fn>& fn;
+            } visitor { fn };
+            visitInternalState (visitor);
+        }
+
+        /** Probe the voltage across this circuit element. */
+        inline T voltage() const noexcept
+        {
+            return (wdf.a + wdf.b) / (T) 2.0;
+        }
+
+        /**Probe the current through this circuit element. */
+        inline T current() const noexcept
+        {
+            return (wdf.a - wdf.b) / ((T) 2.0 * wdf.R);
+        }
+
+        // These classes need access to a,b
+        template <typename>
+        friend class YParameter;
+
+        template <typename>
+        friend class WDFParallel;
+
+        template <typename>
+        friend class WDFSeries;
+
+        wdft::WDFMembers<T> wdf;
+
+    private:
+        const std::string type;
+
+        WDF<T>* wdfParent = nullptr;
+    };
+
+    template <typename T, typename WDFType>
+    class WDFWrapper : public WDF<T>
+    {
+    public:
+        template <typename... Args>
+        explicit WDFWrapper (const std::string& name, Args&&... args) : WDF<T> (name),
+                                                                        internalWDF (std::forward<Args> (args)...)
+        {
+            calcImpedance();
+        }
+
+        /** Computes the impedance of the WDF resistor, Z_R = R. */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            internalWDF.calcImpedance();
+            this->wdf.R = internalWDF.wdf.R;
+            this->wdf.G = internalWDF.wdf.G;
+        }
+
+        /** Accepts an incident wave into a WDF resistor. */
+        inline void incident (T x) noexcept override
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            this->wdf.a = x;
+            internalWDF.incident (x);
+        }
+
+        /** Propogates a reflected wave from a WDF resistor. */
+        inline T reflected() noexcept override
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            this->wdf.b = internalWDF.reflected();
+            return this->wdf.b;
+        }
+
+        /** Visits the ports connected to the internal WDF element. */
+        void visitConnectedPorts (typename WDF<T>::PortVisitor& visitor) override
+        {
+            internalWDF.visitPorts ([&visitor] (WDF<T>& port) { visitor.visit (port); });
+        }
+
+        /** Visits the waves and internal state of the internal WDF element. */
+        void visitInternalState (typename WDF<T>::StateVisitor& visitor) override
+        {
+            visitor.visit (internalWDF.wdf.a);
+            visitor.visit (internalWDF.wdf.b);
+            internalWDF.visitState ([&visitor] (T& x) { visitor.visit (x); });
+        }
+
+    protected:
+        WDFType internalWDF;
+    };
+
+    template <typename T, typename WDFType>
+    class WDFRootWrapper : public WDFWrapper<T, WDFType>
+    {
+    public:
+        template <typename Next, typename... Args>
+        WDFRootWrapper (const std::string& name, Next& next, Args&&... args) : WDFWrapper<T, WDFType> (name, std::forward<Args> (args)...)
+        {
+            next.connectToNode (this);
+            calcImpedance();
+        }
+
+        inline void propagateImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
+            this->calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
+        }
+
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            this->internalWDF.calcImpedance();
+        }
+    };
+} // namespace wdf
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDF_BASE_H
+
+
+namespace chowdsp
+{
+namespace wdf
+{
+    /** WDF Resistor Node */
+    template <typename T>
+    class Resistor final : public WDFWrapper<T, wdft::ResistorT<T>>
+    {
+    public:
+        /** Creates a new WDF Resistor with a given resistance.
+         * @param value: resistance in Ohms
+         */
+        explicit Resistor (T value) : WDFWrapper<T, wdft::ResistorT<T>> ("Resistor", value)
+        {
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            this->internalWDF.setResistanceValue (newR);
+            this->propagateImpedance();
+        }
+    };
+
+    /** WDF Capacitor Node */
+    template <typename T>
+    class Capacitor final : public WDFWrapper<T, wdft::CapacitorT<T>>
+    {
+    public:
+        /** Creates a new WDF Capacitor.
+         * @param value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit Capacitor (T value, T fs = (T) 48000.0) : WDFWrapper<T, wdft::CapacitorT<T>> ("Capacitor", value, fs)
+        {
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Capacitor Node with alpha transform parameter */
+    template <typename T>
+    class CapacitorAlpha final : public WDFWrapper<T, wdft::CapacitorAlphaT<T>>
+    {
+    public:
+        /** Creates a new WDF Capacitor.
+         * @param value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         * @param alpha: alpha value to be used for the alpha transform,
+         *               use 0 for Backwards Euler, use 1 for Bilinear Transform.
+         */
+        explicit CapacitorAlpha (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : WDFWrapper<T, wdft::CapacitorAlphaT<T>> ("Capacitor", value, fs, alpha)
+        {
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+
+        /** Sets a new alpha value to use for the alpha transform */
+        void setAlpha (T newAlpha)
+        {
+            this->internalWDF.setAlpha (newAlpha);
+            this->propagateImpedance();
+        }
+    };
+
+    /** WDF Inductor Node */
+    template <typename T>
+    class Inductor final : public WDFWrapper<T, wdft::InductorT<T>>
+    {
+    public:
+        /** Creates a new WDF Inductor.
+     * @param value: Inductance value in Farads
+     * @param fs: WDF sample rate
+     */
+        explicit Inductor (T value, T fs = (T) 48000.0) : WDFWrapper<T, wdft::InductorT<T>> ("Inductor", value, fs)
+        {
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Inductor Node with alpha transform parameter */
+    template <typename T>
+    class InductorAlpha final : public WDFWrapper<T, wdft::InductorAlphaT<T>>
+    {
+    public:
+        /** Creates a new WDF Inductor.
+     * @param value: Inductance value in Farads
+     * @param fs: WDF sample rate
+     * @param alpha: alpha value to be used for the alpha transform,
+     *               use 0 for Backwards Euler, use 1 for Bilinear Transform.
+     */
+        explicit InductorAlpha (T value, T fs = 48000.0, T alpha = 1.0) : WDFWrapper<T, wdft::InductorAlphaT<T>> ("Inductor", value, fs, alpha)
+        {
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+
+        /** Sets a new alpha value to use for the alpha transform */
+        void setAlpha (T newAlpha)
+        {
+            this->internalWDF.setAlpha (newAlpha);
+            this->propagateImpedance();
+        }
+    };
+
+    /** WDF Resistor/Capacitor Series Node */
+    template <typename T>
+    class ResistorCapacitorSeries final : public WDFWrapper<T, wdft::ResistorCapacitorSeriesT<T>>
+    {
+    public:
+        /** Creates a new WDF Resistor/Capacitor Series node.
+         * @param res_value: resistance in Ohms
+         * @param cap_value: capacitance in Farads
+         */
+        explicit ResistorCapacitorSeries (T res_value, T cap_value)
+            : WDFWrapper<T, wdft::ResistorCapacitorSeriesT<T>> ("Resistor/Capacitor Series", res_value, cap_value)
+        {
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            this->internalWDF.setResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Resistor/Capacitor Parallel Node */
+    template <typename T>
+    class ResistorCapacitorParallel final : public WDFWrapper<T, wdft::ResistorCapacitorParallelT<T>>
+    {
+    public:
+        /** Creates a new WDF Resistor/Capacitor Parallel node.
+         * @param res_value: resistance in Ohms
+         * @param cap_value: capacitance in Farads
+         */
+        explicit ResistorCapacitorParallel (T res_value, T cap_value)
+            : WDFWrapper<T, wdft::ResistorCapacitorParallelT<T>> ("Resistor/Capacitor Parallel", res_value, cap_value)
+        {
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            this->internalWDF.setResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Resistor/Inductor Series Node */
+    template <typename T>
+    class ResistorInductorSeries final : public WDFWrapper<T, wdft::ResistorInductorSeriesT<T>>
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor Series node.
+         * @param res_value: resistance in Ohms
+         * @param ind_value: inductance in Henries
+         */
+        explicit ResistorInductorSeries (T res_value, T ind_value)
+            : WDFWrapper<T, wdft::ResistorInductorSeriesT<T>> ("Resistor/Inductor Series", res_value, ind_value)
+        {
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            this->internalWDF.setResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Resistor/Inductor Parallel Node */
+    template <typename T>
+    class ResistorInductorParallel final : public WDFWrapper<T, wdft::ResistorInductorParallelT<T>>
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor Parallel node.
+         * @param res_value: resistance in Ohms
+         * @param ind_value: inductance in Henries
+         */
+        explicit ResistorInductorParallel (T res_value, T ind_value)
+            : WDFWrapper<T, wdft::ResistorInductorParallelT<T>> ("Resistor/Inductor Parallel", res_value, ind_value)
+        {
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            this->internalWDF.setResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Inductor/Capacitor Series Node */
+    template <typename T>
+    class InductorCapacitorSeries final : public WDFWrapper<T, wdft::InductorCapacitorSeriesT<T>>
+    {
+    public:
+        /** Creates a new WDF Inductor/Capacitor Series node.
+         * @param ind_value: inductance in Henries
+         * @param cap_value: capacitance in Farads
+         */
+        explicit InductorCapacitorSeries (T ind_value, T cap_value)
+            : WDFWrapper<T, wdft::InductorCapacitorSeriesT<T>> ("Inductor/Capacitor Series", ind_value, cap_value)
+        {
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Inductor/Capacitor Parallel Node */
+    template <typename T>
+    class InductorCapacitorParallel final : public WDFWrapper<T, wdft::InductorCapacitorParallelT<T>>
+    {
+    public:
+        /** Creates a new WDF Inductor/Capacitor Parallel node.
+         * @param ind_value: inductance in Henries
+         * @param cap_value: capacitance in Farads
+         */
+        explicit InductorCapacitorParallel (T ind_value, T cap_value)
+            : WDFWrapper<T, wdft::InductorCapacitorParallelT<T>> ("Inductor/Capacitor Parallel", ind_value, cap_value)
+        {
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Resistor/Inductor/Capacitor Series Node */
+    template <typename T>
+    class ResistorInductorCapacitorSeries final : public WDFWrapper<T, wdft::ResistorInductorCapacitorSeriesT<T>>
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor/Capacitor Series node.
+         * @param res_value: resistance in Ohms
+         * @param ind_value: inductance in Henries
+         * @param cap_value: capacitance in Farads
+         */
+        explicit ResistorInductorCapacitorSeries (T res_value, T ind_value, T cap_value)
+            : WDFWrapper<T, wdft::ResistorInductorCapacitorSeriesT<T>> ("Resistor/Inductor/Capacitor Series", res_value, ind_value, cap_value)
+        {
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            this->internalWDF.setResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            this->internalWDF.setInductanceValue (newL);
+            this->propagateImpedance();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+
+    /** WDF Capacitor with ESR and leakage resistance */
+    template <typename T>
+    class CapacitorESR final : public WDFWrapper<T, wdft::CapacitorESRT<T>>
+    {
+    public:
+        /** Creates a new WDF Capacitor with ESR.
+         * @param cap_value: capacitance in Farads
+         * @param esr_value: equivalent series resistance in Ohms
+         * @param leakage_value: leakage resistance in Ohms
+         */
+        explicit CapacitorESR (T cap_value, T esr_value, T leakage_value = (NumericType<T>) 1.0e9)
+            : WDFWrapper<T, wdft::CapacitorESRT<T>> ("Capacitor/ESR", cap_value, esr_value, (T) 48000.0, leakage_value)
+        {
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            this->internalWDF.setCapacitanceValue (newC);
+            this->propagateImpedance();
+        }
+
+        /** Sets the equivalent series resistance, in Ohms. */
+        void setESRValue (T newESR)
+        {
+            this->internalWDF.setESRValue (newESR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the leakage resistance, in Ohms. */
+        void setLeakageResistanceValue (T newR)
+        {
+            this->internalWDF.setLeakageResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            this->internalWDF.prepare (sampleRate);
+            this->propagateImpedance();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            this->internalWDF.reset();
+        }
+    };
+} // namespace wdf
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDF_ONE_PORTS_H
+
+// #include "wdf_sources.h"
+#ifndef CHOWDSP_WDF_WDF_SOURCES_H
+#define CHOWDSP_WDF_WDF_SOURCES_H
+
+// #include "wdf_base.h"
+
+
+namespace chowdsp
+{
+namespace wdf
+{
+    /** WDF Voltage source with series resistance */
+    template <typename T>
+    class ResistiveVoltageSource final : public WDFWrapper<T, wdft::ResistiveVoltageSourceT<T>>
+    {
+    public:
+        /** Creates a new resistive voltage source.
+     * @param value: initial resistance value, in Ohms
+     */
+        explicit ResistiveVoltageSource (T value = (NumericType<T>) 1.0e-9) : WDFWrapper<T, wdft::ResistiveVoltageSourceT<T>> ("Resistive Voltage", value)
+        {
+        }
+
+        /** Sets the resistance value of the series resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            this->internalWDF.setResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV) { this->internalWDF.setVoltage (newV); }
+    };
+
+    /** WDF Ideal Voltage source (non-adaptable) */
+    template <typename T>
+    class IdealVoltageSource final : public WDFWrapper<T, wdft::IdealVoltageSourceT<T, WDF<T>>>
+    {
+    public:
+        explicit IdealVoltageSource (WDF<T>* next) : WDFWrapper<T, wdft::IdealVoltageSourceT<T, WDF<T>>> ("IdealVoltage", *next)
+        {
+            next->connectToNode (this);
+        }
+
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV) { this->internalWDF.setVoltage (newV); }
+    };
+
+    /** WDF Current source with parallel resistance */
+    template <typename T>
+    class ResistiveCurrentSource final : public WDFWrapper<T, wdft::ResistiveCurrentSourceT<T>>
+    {
+    public:
+        /** Creates a new resistive current source.
+     * @param value: initial resistance value, in Ohms
+     */
+        explicit ResistiveCurrentSource (T value = (NumericType<T>) 1.0e9) : WDFWrapper<T, wdft::ResistiveCurrentSourceT<T>> ("Resistive Current", value)
+        {
+        }
+
+        /** Sets the resistance value of the parallel resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            this->internalWDF.setResistanceValue (newR);
+            this->propagateImpedance();
+        }
+
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI) { this->internalWDF.setCurrent (newI); }
+    };
+
+    /** WDF Current source (non-adpatable) */
+    template <typename T>
+    class IdealCurrentSource final : public WDFWrapper<T, wdft::IdealCurrentSourceT<T, WDF<T>>>
+    {
+    public:
+        explicit IdealCurrentSource (WDF<T>* next) : WDFWrapper<T, wdft::IdealCurrentSourceT<T, WDF<T>>> ("Ideal Current", *next)
+        {
+            next->connectToNode (this);
+        }
+
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI) { this->internalWDF.setCurrent (newI); }
+    };
+} // namespace wdf
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDF_SOURCES_H
+
+// #include "wdf_adaptors.h"
+#ifndef CHOWDSP_WDF_WDF_ADAPTORS_H
+#define CHOWDSP_WDF_WDF_ADAPTORS_H
+
+// #include "wdf_base.h"
+
+
+namespace chowdsp
+{
+namespace wdf
+{
+    /** WDF Voltage Polarity Inverter */
+    template <typename T>
+    class PolarityInverter final : public WDFWrapper<T, wdft::PolarityInverterT<T, WDF<T>>>
+    {
+    public:
+        /** Creates a new WDF polarity inverter
+         * @param port1: the port to connect to the inverter
+         */
+        explicit PolarityInverter (WDF<T>* port1) : WDFWrapper<T, wdft::PolarityInverterT<T, WDF<T>>> ("Polarity Inverter", *port1)
+        {
+            port1->connectToNode (this);
+        }
+    };
+
+    /** WDF y-parameter 2-port (short circuit admittance) */
+    template <typename T>
+    class YParameter final : public WDFWrapper<T, wdft::YParameterT<T, WDF<T>>>
+    {
+    public:
+        YParameter (WDF<T>* port1, T y11, T y12, T y21, T y22) : WDFWrapper<T, wdft::YParameterT<T, WDF<T>>> ("YParameter", *port1, y11, y12, y21, y22)
+        {
+            port1->connectToNode (this);
+        }
+    };
+
+    /** WDF 3-port parallel adaptor */
+    template <typename T>
+    class WDFParallel final : public WDFWrapper<T, wdft::WDFParallelT<T, WDF<T>, WDF<T>>>
+    {
+    public:
+        /** Creates a new WDF parallel adaptor from two connected ports. */
+        WDFParallel (WDF<T>* port1, WDF<T>* port2) : WDFWrapper<T, wdft::WDFParallelT<T, WDF<T>, WDF<T>>> ("Parallel", *port1, *port2)
+        {
+            port1->connectToNode (this);
+            port2->connectToNode (this);
+        }
+    };
+
+    /** WDF 3-port series adaptor */
+    template <typename T>
+    class WDFSeries final : public WDFWrapper<T, wdft::WDFSeriesT<T, WDF<T>, WDF<T>>>
+    {
+    public:
+        /** Creates a new WDF series adaptor from two connected ports. */
+        WDFSeries (WDF<T>* port1, WDF<T>* port2) : WDFWrapper<T, wdft::WDFSeriesT<T, WDF<T>, WDF<T>>> ("Series", *port1, *port2)
+        {
+            port1->connectToNode (this);
+            port2->connectToNode (this);
+        }
+    };
+} // namespace wdf
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDF_ADAPTORS_H
+
+// #include "wdf_nonlinearities.h"
+#ifndef CHOWDSP_WDF_WDF_NONLINEARITIES_H
+#define CHOWDSP_WDF_WDF_NONLINEARITIES_H
+
+// #include "wdf_base.h"
+
+
+namespace chowdsp
+{
+namespace wdf
+{
+    /** WDF Switch (non-adaptable) */
+    template <typename T>
+    class Switch final : public WDFWrapper<T, wdft::SwitchT<T, WDF<T>>>
+    {
+    public:
+        explicit Switch (WDF<T>* next) : WDFWrapper<T, wdft::SwitchT<T, WDF<T>>> ("Switch", *next)
+        {
+            next->connectToNode (this);
+        }
+
+        /** Sets the state of the switch. */
+        void setClosed (bool shouldClose)
+        {
+            this->internalWDF.setClosed (shouldClose);
+        }
+    };
+
+    /** WDF Open circuit (non-adaptable) */
+    template <typename T>
+    class Open final : public WDF<T>
+    {
+    public:
+        Open() : WDF<T> ("Open")
+        {
+            this->wdf.R = (T) 1.0e15;
+            this->wdf.G = (T) 1.0 / this->wdf.R;
+        }
+
+        inline void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
+
+        /** Accepts an incident wave into a WDF open. */
+        inline void incident (T x) noexcept override
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            this->wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF open. */
+        inline T reflected() noexcept override
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            this->wdf.b = this->wdf.a;
+            return this->wdf.b;
+        }
+    };
+
+    /** WDF Short circuit (non-adaptable) */
+    template <typename T>
+    class Short final : public WDF<T>
+    {
+    public:
+        Short() : WDF<T> ("Short")
+        {
+            this->wdf.R = (T) 1.0e-15;
+            this->wdf.G = (T) 1.0 / this->wdf.R;
+        }
+
+        inline void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
+
+        /** Accepts an incident wave into a WDF short. */
+        inline void incident (T x) noexcept override
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            this->wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF short. */
+        inline T reflected() noexcept override
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            this->wdf.b = -this->wdf.a;
+            return this->wdf.b;
+        }
+    };
+
+    /**
+     * WDF diode pair (non-adaptable)
+     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
+     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
+     */
+    template <typename T, wdft::DiodeQuality Q = wdft::DiodeQuality::Best>
+    class DiodePair final : public WDFRootWrapper<T, wdft::DiodePairT<T, WDF<T>, Q>>
+    {
+    public:
+        /**
+         * Creates a new WDF diode pair, with the given diode specifications.
+         * @param next: the next element in the WDF connection tree
+         * @param Is: reverse saturation current
+         * @param Vt: thermal voltage
+         * @param nDiodes: the number of series diodes
+         */
+        DiodePair (WDF<T>* next, T Is, T Vt = (NumericType<T>) 25.85e-3, T nDiodes = (T) 1) : WDFRootWrapper<T, wdft::DiodePairT<T, WDF<T>, Q>> ("DiodePair", *next, *next, Is, Vt, nDiodes)
+        {
+            next->connectToNode (this);
+        }
+
+        /** Sets diode specific parameters */
+        void setDiodeParameters (T newIs, T newVt, T nDiodes)
+        {
+            this->internalWDF.setDiodeParameters (newIs, newVt, nDiodes);
+        }
+    };
+
+    /**
+     * WDF diode (non-adaptable)
+     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
+     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
+     */
+    template <typename T>
+    class Diode final : public WDFRootWrapper<T, wdft::DiodeT<T, WDF<T>>>
+    {
+    public:
+        /**
+         * Creates a new WDF diode, with the given diode specifications.
+         * @param next: the next element in the WDF connection tree
+         * @param Is: reverse saturation current
+         * @param Vt: thermal voltage
+         * @param nDiodes: the number of series diodes
+         */
+        Diode (WDF<T>* next, T Is, T Vt = (NumericType<T>) 25.85e-3, T nDiodes = 1) : WDFRootWrapper<T, wdft::DiodeT<T, WDF<T>>> ("Diode", *next, *next, Is, Vt, nDiodes)
+        {
+            next->connectToNode (this);
+        }
+
+        /** Sets diode specific parameters */
+        void setDiodeParameters (T newIs, T newVt, T nDiodes)
+        {
+            this->internalWDF.setDiodeParameters (newIs, newVt, nDiodes);
+        }
+    };
+} // namespace wdf
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDF_NONLINEARITIES_H
+
+
+#endif // CHOWDSP_WDF_H_INCLUDED
+
+// #include "rtype/rtype.h"
+#ifndef CHOWDSP_WDF_RTYPE_H_INCLUDED
+#define CHOWDSP_WDF_RTYPE_H_INCLUDED
+
+// #include "rtype_adaptor.h"
+#ifndef CHOWDSP_WDF_RTYPE_ADAPTOR_H
+#define CHOWDSP_WDF_RTYPE_ADAPTOR_H
+
+// #include "../wdft/wdft_base.h"
+#ifndef CHOWDSP_WDF_WDFT_BASE_H
+#define CHOWDSP_WDF_WDFT_BASE_H
+
+#include <type_traits>
+
+// #include "../math/sample_type.h"
+#ifndef CHOWDSP_WDF_SAMPLE_TYPE_H
+#define CHOWDSP_WDF_SAMPLE_TYPE_H
+
+#include <type_traits>
+
+#ifndef DOXYGEN
+
+namespace chowdsp
+{
+#if ! (JUCE_MODULE_AVAILABLE_chowdsp_dsp)
+/** Useful structs for determining the internal data type of SIMD types */
+namespace SampleTypeHelpers
+{
+    template <typename T, bool = std::is_floating_point<T>::value>
+    struct ElementType
+    {
+        using Type = T;
+    };
+
+    template <typename T>
+    struct ElementType<T, false>
+    {
+        using Type = typename T::value_type;
+    };
+} // namespace SampleTypeHelpers
+#endif
+
+/** Type alias for a SIMD numeric type */
+template <typename T>
+using NumericType = typename SampleTypeHelpers::ElementType<T>::Type;
+
+/** Returns true if all the elements in a SIMD vector are equal */
+inline bool all (bool x)
+{
+    return x;
+}
+
+/** Ternary select operation */
+template <typename T>
+inline T select (bool b, const T& t, const T& f)
+{
+    return b ? t : f;
+}
+} // namespace chowdsp
+
+#endif // DOXYGEN
+
+#endif //CHOWDSP_WDF_SAMPLE_TYPE_H
+
+// #include "../util/instrumentation.h"
+#ifndef CHOWDSP_WDF_INSTRUMENTATION_H
+#define CHOWDSP_WDF_INSTRUMENTATION_H
+
+#include <cstdint>
+
+/**
+ * If CHOWDSP_WDF_INSTRUMENTATION is enabled, every WDF element keeps count of
+ * how many times its impedance has been recomputed, how many impedance changes
+ * have been propagated through it, and how many incident/reflected waves it has
+ * processed. The counts can be retrieved with wdft::getInstrumentationCounters().
+ *
+ * When the option is disabled (the default), the counters are compiled out
+ * completely, so there is no runtime or memory cost.
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_INSTRUMENTATION
+#define CHOWDSP_WDF_INSTRUMENTATION 0
+#endif
+
+/**
+ * If CHOWDSP_WDF_INSTRUMENTATION is enabled, CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+ * can be set to a power of two N, in which case every Nth call to each instrumented
+ * method is timed using the CPU cycle counter (rdtsc on x86, cntvct_el0 on ARM64).
+ * Sampling keeps the overhead of reading the counter low, while still giving a good
+ * estimate of the per-call cost.
+ */
+#ifndef CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+#define CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING 0
+#endif
+
+#if CHOWDSP_WDF_INSTRUMENTATION && CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_CNTVCT 1
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** Instrumentation counts for a single WDF element (see CHOWDSP_WDF_INSTRUMENTATION). */
+    struct InstrumentationCounters
+    {
+        uint64_t calcImpedance = 0; /* number of calls to calcImpedance() */
+        uint64_t propagateImpedanceChange = 0; /* number of impedance changes propagated through this element */
+        uint64_t incident = 0; /* number of calls to incident(), or compute() for R-Type root adaptors */
+        uint64_t reflected = 0; /* number of calls to reflected() */
+
+        /**
+         * Total cycles spent in the sampled calls to incident() and reflected(). Note that for
+         * adaptors this includes the time spent in the connected ports, so the cost of an adaptor
+         * itself is roughly its average cycles, minus the average cycles of its ports.
+         */
+        uint64_t cycles = 0;
+        uint64_t cycleSamples = 0; /* number of calls included in the cycle count */
+
+        /** Returns the average number of cycles per sampled call to incident() or reflected() */
+        double getAverageCycles() const noexcept
+        {
+            return cycleSamples == 0 ? 0.0 : (double) cycles / (double) cycleSamples;
+        }
+
+        InstrumentationCounters& operator+= (const InstrumentationCounters& other) noexcept
+        {
+            calcImpedance += other.calcImpedance;
+            propagateImpedanceChange += other.propagateImpedanceChange;
+            incident += other.incident;
+            reflected += other.reflected;
+            cycles += other.cycles;
+            cycleSamples += other.cycleSamples;
+            return *this;
+        }
+    };
+
+#ifndef DOXYGEN
+    namespace instrumentation_detail
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION && CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+        static_assert ((CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING & (CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING - 1)) == 0,
+                       "The cycle sampling interval must be a power of two!");
+
+        inline uint64_t readCycleCounter() noexcept
+        {
+#if CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC
+            return (uint64_t) __rdtsc();
+#elif CHOWDSP_WDF_INSTRUMENTATION_USE_CNTVCT
+            uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0"
+                         : "=r"(ticks));
+            return ticks;
+#else
+            return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+#endif
+
+#if CHOWDSP_WDF_INSTRUMENTATION
+        /** Increments a call counter, and (maybe) measures the cycles spent in the current scope. */
+        class ScopedCounter
+        {
+        public:
+            ScopedCounter (uint64_t& callCount, InstrumentationCounters& counters) noexcept
+#if CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+                : sampledCounters ((callCount++ & (CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING - 1)) == 0 ? &counters : nullptr)
+            {
+                if (sampledCounters != nullptr)
+                    startTime = readCycleCounter();
+            }
+#else
+            {
+                callCount++;
+                (void) counters;
+            }
+#endif
+
+#if CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+            ~ScopedCounter() noexcept
+            {
+                if (sampledCounters != nullptr)
+                {
+                    sampledCounters->cycles += readCycleCounter() - startTime;
+                    sampledCounters->cycleSamples++;
+                }
+            }
+
+        private:
+            InstrumentationCounters* sampledCounters;
+            uint64_t startTime = 0;
+#endif
+        };
+#endif
+    } // namespace instrumentation_detail
+#endif // DOXYGEN
+} // namespace wdft
+} // namespace chowdsp
+
+#if CHOWDSP_WDF_INSTRUMENTATION
+/** Counts a call to the given method of the current WDF element */
+#define CHOWDSP_WDF_INSTRUMENT_COUNT(method) (this->instrumentationCounters.method++)
+
+/** Counts a call to the given method of the current WDF element, and samples the time spent in the method */
+#define CHOWDSP_WDF_INSTRUMENT_TIMED(method) \
+    ::chowdsp::wdft::instrumentation_detail::ScopedCounter chowdsp_wdf_instrumentation_scope { this->instrumentationCounters.method, this->instrumentationCounters }
+#else
+#define CHOWDSP_WDF_INSTRUMENT_COUNT(method)
+#define CHOWDSP_WDF_INSTRUMENT_TIMED(method)
+#endif
+
+#endif //CHOWDSP_WDF_INSTRUMENTATION_H
+
+
+#ifndef CHOWDSP_WDF_TRACING
+#define CHOWDSP_WDF_TRACING 0
+#endif
+
+#if CHOWDSP_WDF_TRACING
+// #include "../util/impedance_trace.h"
+#ifndef CHOWDSP_WDF_IMPEDANCE_TRACE_H
+#define CHOWDSP_WDF_IMPEDANCE_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * If CHOWDSP_WDF_TRACING is enabled, every impedance propagation through the
+ * WDF tree is recorded into the active ImpedanceTracer (if there is one).
+ *
+ * When the option is disabled (the default), the tracing hooks are compiled
+ * out completely, so there is no runtime cost, and this header is not included
+ * by the WDF elements (it can still be included directly, for the tracer classes).
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_TRACING
+#define CHOWDSP_WDF_TRACING 0
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+    class BaseWDF;
+
+    /** A single impedance propagation event, recorded by the ImpedanceTracer. */
+    struct ImpedanceTraceEvent
+    {
+        enum class Type : uint8_t
+        {
+            Propagation, /* the element recomputed its impedance, and (maybe) propagated the change to its parent */
+            Deferred, /* the propagation was stopped by a ScopedDeferImpedancePropagation */
+            DeferredCalc, /* the element recomputed its impedance when a ScopedDeferImpedancePropagation went out of scope */
+        };
+
+        Type type = Type::Propagation;
+        uint32_t depth = 0; /* the number of elements that the change has propagated through before reaching this element */
+        uint64_t propagationId = 0; /* all the events triggered by the same parameter change share an ID */
+        const BaseWDF* element = nullptr; /* the element that this event happened at */
+        const BaseWDF* source = nullptr; /* the element whose impedance change started the propagation */
+        int64_t startNs = 0; /* start time of the event (steady_clock) */
+        int64_t durationNs = 0; /* total duration, including the propagation to the ancestors of this element */
+        int64_t calcImpedanceNs = 0; /* time spent in calcImpedance() for this element */
+    };
+
+    /**
+     * Records impedance propagation events into a lock-free single-producer,
+     * single-consumer ring buffer, so that latency spikes while automating
+     * circuit parameters can be inspected offline.
+     *
+     * The tracer only records events when it is the active tracer and
+     * CHOWDSP_WDF_TRACING is enabled. Parameter changes should come from
+     * one thread at a time (typically the audio thread), while the events
+     * can be read from any other thread.
+     * ```cpp
+     * wdft::ImpedanceTracer tracer { 8192 };
+     * tracer.setElementName (circuit.pot1, "pot1");
+     * wdft::ImpedanceTracer::setActiveTracer (&tracer);
+     *
+     * // ... process and automate the circuit ...
+     *
+     * std::ofstream traceFile { "wdf_trace.json" };
+     * tracer.writeChromeTrace (traceFile); // open in chrome://tracing or https://ui.perfetto.dev
+     * ```
+     */
+    class ImpedanceTracer
+    {
+    public:
+        /** Creates a tracer which can hold at least the given number of (unread) events. */
+        explicit ImpedanceTracer (size_t minCapacity = 4096)
+        {
+            size_t capacity = 2;
+            while (capacity < minCapacity)
+                capacity *= 2;
+            events.resize (capacity);
+        }
+
+        ~ImpedanceTracer()
+        {
+            auto* self = this;
+            activeTracer().compare_exchange_strong (self, nullptr);
+        }
+
+        ImpedanceTracer (const ImpedanceTracer&) = delete;
+        ImpedanceTracer& operator= (const ImpedanceTracer&) = delete;
+
+        /** Sets the tracer that will record impedance propagation events (or nullptr to stop tracing). */
+        static void setActiveTracer (ImpedanceTracer* tracer) noexcept
+        {
+            activeTracer().store (tracer, std::memory_order_release);
+        }
+
+        /** Returns the active tracer, or nullptr if tracing is not active. */
+        static ImpedanceTracer* getActiveTracer() noexcept
+        {
+            return activeTracer().load (std::memory_order_acquire);
+        }
+
+        /** Sets a name to use for an element in the exported trace (not real-time safe). */
+        void setElementName (const BaseWDF& element, std::string name)
+        {
+            elementNames[&element] = std::move (name);
+        }
+
+        /** Adds an event to the buffer. If the buffer is full, the event is dropped and false is returned. */
+        bool push (const ImpedanceTraceEvent& event) noexcept
+        {
+            const auto writeIndex = writePosition.load (std::memory_order_relaxed);
+            if (writeIndex - readPosition.load (std::memory_order_acquire) >= events.size())
+            {
+                numDroppedEvents.fetch_add (1, std::memory_order_relaxed);
+                return false;
+            }
+
+            events[writeIndex & (events.size() - 1)] = event;
+            writePosition.store (writeIndex + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Reads the oldest event from the buffer. Returns false if there are no events to read. */
+        bool pop (ImpedanceTraceEvent& event) noexcept
+        {
+            const auto readIndex = readPosition.load (std::memory_order_relaxed);
+            if (readIndex == writePosition.load (std::memory_order_acquire))
+                return false;
+
+            event = events[readIndex & (events.size() - 1)];
+            readPosition.store (readIndex + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Returns the number of events that were dropped because the buffer was full. */
+        uint64_t getNumDroppedEvents() const noexcept { return numDroppedEvents.load (std::memory_order_relaxed); }
+
+        /**
+         * Reads all the events from the buffer, and writes them out in the Chrome
+         * trace-event JSON format. Propagations are written as "complete" events,
+         * so the propagation through the ancestors of an element appears nested
+         * inside the element's event, and deferred propagations are written as
+         * instant events.
+         */
+        void writeChromeTrace (std::ostream& os)
+        {
+            os << "{\"traceEvents\":[";
+
+            ImpedanceTraceEvent event;
+            bool isFirstEvent = true;
+            while (pop (event))
+            {
+                if (! isFirstEvent)
+                    os << ",";
+                isFirstEvent = false;
+
+                os << "\n{\"name\":\"" << getEventName (event) << "\",\"cat\":\"wdf\""
+                   << ",\"ph\":\"" << (event.type == ImpedanceTraceEvent::Type::Deferred ? "i\",\"s\":\"t" : "X")
+                   << "\",\"pid\":1,\"tid\":1,\"ts\":" << formatMicroseconds (event.startNs);
+
+                if (event.type != ImpedanceTraceEvent::Type::Deferred)
+                    os << ",\"dur\":" << formatMicroseconds (event.durationNs);
+
+                os << ",\"args\":{\"element\":\"" << escapeJson (getElementName (event.element))
+                   << "\",\"source\":\"" << escapeJson (getElementName (event.source))
+                   << "\",\"depth\":" << event.depth
+                   << ",\"propagation\":" << event.propagationId
+                   << ",\"calcImpedance_us\":" << formatMicroseconds (event.calcImpedanceNs)
+                   << "}}";
+            }
+
+            os << "\n],\"otherData\":{\"droppedEvents\":" << getNumDroppedEvents() << "}}\n";
+        }
+
+    private:
+        static std::atomic<ImpedanceTracer*>& activeTracer() noexcept
+        {
+            static std::atomic<ImpedanceTracer*> tracer { nullptr };
+            return tracer;
+        }
+
+        static const char* getEventName (const ImpedanceTraceEvent& event) noexcept
+        {
+            switch (event.type)
+            {
+                case ImpedanceTraceEvent::Type::Deferred:
+                    return "deferred";
+                case ImpedanceTraceEvent::Type::DeferredCalc:
+                    return "deferred calcImpedance";
+                case ImpedanceTraceEvent::Type::Propagation:
+                default:
+                    return "propagateImpedanceChange";
+            }
+        }
+
+        std::string getElementName (const BaseWDF* element) const
+        {
+            const auto nameIter = elementNames.find (element);
+            if (nameIter != elementNames.end())
+                return nameIter->second;
+
+            char pointerName[32];
+            std::snprintf (pointerName, sizeof (pointerName), "%p", (const void*) element);
+            return pointerName;
+        }
+
+        /** Escapes the characters that can't appear as-is in a JSON string */
+        static std::string escapeJson (const std::string& str)
+        {
+            std::string escaped;
+            escaped.reserve (str.size());
+            for (auto c : str)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    escaped += '\\';
+                    escaped += c;
+                }
+                else if ((unsigned char) c < 0x20)
+                {
+                    char code[8];
+                    std::snprintf (code, sizeof (code), "\\u%04x", (unsigned) c);
+                    escaped += code;
+                }
+                else
+                {
+                    escaped += c;
+                }
+            }
+            return escaped;
+        }
+
+        static std::string formatMicroseconds (int64_t ns)
+        {
+            char value[32];
+            std::snprintf (value, sizeof (value), "%.3f", (double) ns * 1.0e-3);
+            return value;
+        }
+
+        std::vector<ImpedanceTraceEvent> events;
+        std::atomic<uint64_t> writePosition { 0 };
+        std::atomic<uint64_t> readPosition { 0 };
+        std::atomic<uint64_t> numDroppedEvents { 0 };
+
+        std::unordered_map<const BaseWDF*, std::string> elementNames;
+    };
+
+#ifndef DOXYGEN
+    namespace trace_detail
+    {
+        inline int64_t nowNs() noexcept
+        {
+            return (int64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /** Keeps track of the propagation that is currently running on this thread */
+        struct PropagationContext
+        {
+            uint32_t depth = 0;
+            uint64_t nextPropagationId = 0;
+            const BaseWDF* source = nullptr;
+        };
+
+        inline PropagationContext& getPropagationContext() noexcept
+        {
+            static thread_local PropagationContext context;
+            return context;
+        }
+
+        /** Records a propagation event covering the lifetime of this object */
+        class PropagationScope
+        {
+        public:
+            explicit PropagationScope (const BaseWDF& element, ImpedanceTraceEvent::Type type = ImpedanceTraceEvent::Type::Propagation) noexcept
+                : tracer (ImpedanceTracer::getActiveTracer())
+            {
+                if (tracer == nullptr)
+                    return;
+
+                auto& context = getPropagationContext();
+                if (context.depth == 0)
+                {
+                    context.nextPropagationId++;
+                    context.source = &element;
+                }
+
+                event.type = type;
+                event.depth = context.depth++;
+                event.propagationId = context.nextPropagationId;
+                event.element = &element;
+                event.source = context.source;
+                event.startNs = nowNs();
+            }
+
+            ~PropagationScope() noexcept
+            {
+                if (tracer == nullptr)
+                    return;
+
+                event.durationNs = nowNs() - event.startNs;
+                getPropagationContext().depth--;
+                tracer->push (event);
+            }
+
+            /** Call this once the element has finished computing its impedance */
+            void calcImpedanceDone() noexcept
+            {
+                if (tracer != nullptr)
+                    event.calcImpedanceNs = nowNs() - event.startNs;
+            }
+
+        private:
+            ImpedanceTracer* tracer;
+            ImpedanceTraceEvent event;
+        };
+
+        /** Records that an impedance propagation was stopped at this element */
+        inline void recordDeferredPropagation (const BaseWDF& element) noexcept
+        {
+            auto* tracer = ImpedanceTracer::getActiveTracer();
+            if (tracer == nullptr)
+                return;
+
+            auto& context = getPropagationContext();
+            ImpedanceTraceEvent event;
+            event.type = ImpedanceTraceEvent::Type::Deferred;
+            event.depth = context.depth;
+            event.propagationId = context.depth == 0 ? ++context.nextPropagationId : context.nextPropagationId;
+            event.element = &element;
+            event.source = context.depth == 0 ? &element : context.source;
+            event.startNs = nowNs();
+            tracer->push (event);
+        }
+    } // namespace trace_detail
+#endif // DOXYGEN
+} // namespace wdft
+} // namespace chowdsp
+
+#if CHOWDSP_WDF_TRACING
+/** Traces an impedance propagation through the current WDF element, until the end of the current scope */
+#define CHOWDSP_WDF_TRACE_PROPAGATION() \
+    ::chowdsp::wdft::trace_detail::PropagationScope chowdsp_wdf_trace_scope { *this }
+
+/** Marks the end of the calcImpedance() call in the current traced propagation */
+#define CHOWDSP_WDF_TRACE_CALC_DONE() chowdsp_wdf_trace_scope.calcImpedanceDone()
+
+/** Records that the impedance propagation was deferred at the current WDF element */
+#define CHOWDSP_WDF_TRACE_DEFERRED() ::chowdsp::wdft::trace_detail::recordDeferredPropagation (*this)
+
+/** Traces the deferred impedance calculation of the given WDF element, until the end of the current scope */
+#define CHOWDSP_WDF_TRACE_DEFERRED_CALC(element) \
+    ::chowdsp::wdft::trace_detail::PropagationScope chowdsp_wdf_trace_scope { element, ::chowdsp::wdft::ImpedanceTraceEvent::Type::DeferredCalc }
+#endif
+
+#endif //CHOWDSP_WDF_IMPEDANCE_TRACE_H
+
+#else
+#define CHOWDSP_WDF_TRACE_PROPAGATION()
+#define CHOWDSP_WDF_TRACE_CALC_DONE()
+#define CHOWDSP_WDF_TRACE_DEFERRED()
+#define CHOWDSP_WDF_TRACE_DEFERRED_CALC(element)
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** Base WDF class for propagating impedance changes between elements */
+    class BaseWDF
+    {
+    public:
+        virtual ~BaseWDF() = default;
+
+        void connectToParent (BaseWDF* p) { parent = p; }
+
+        virtual void calcImpedance() = 0;
+
+        inline virtual void propagateImpedanceChange()
+        {
+            if (dontPropagateImpedance)
+            {
+                CHOWDSP_WDF_TRACE_DEFERRED();
+                return; // the impedance propagation is being deferred until later...
+            }
+
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
+            calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
+
+            if (parent != nullptr)
+                parent->propagateImpedanceChange();
+        }
+
+        /**
+         * Calls fn for each port connected "below" this element in the WDF tree.
+         * Elements with connected ports (adaptors and root elements) hide this method.
+         */
+        template <typename Fn>
+        void visitPorts (Fn&&)
+        {
+        }
+
+        /**
+         * Calls visitor with a reference to each of this element's internal
+         * state variables (not including the wdf.a and wdf.b members).
+         * Elements with internal state hide this method.
+         */
+        template <typename Visitor>
+        void visitState (Visitor&&)
+        {
+        }
+
+#if CHOWDSP_WDF_INSTRUMENTATION
+        /** Instrumentation counts for this element (see getInstrumentationCounters()). */
+        InstrumentationCounters instrumentationCounters;
+#endif
+
+    protected:
+        BaseWDF* parent = nullptr;
+
+    private:
+        bool dontPropagateImpedance = false;
+
+        template <typename... Elements>
+        friend class ScopedDeferImpedancePropagation;
+    };
+
+    /** Base class for propagating impedance changes into root WDF elements */
+    class RootWDF : public BaseWDF
+    {
+    public:
+        inline void propagateImpedanceChange() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
+            calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
+        }
+
+    private:
+        // don't try to connect root nodes!
+        void connectToParent (BaseWDF*) {}
+    };
+
+    /** Helper struct for common WDF member variables */
+    template <typename T>
+    struct WDFMembers
+    {
+        T R = (NumericType<T>) 1.0e-9; /* impedance */
+        T G = (T) 1.0 / R; /* admittance */
+        T a = (T) 0.0; /* incident wave */
+        T b = (T) 0.0; /* reflected wave */
+    };
+
+#ifndef DOXYGEN
+    namespace fixed_detail
+    {
+        template <typename...>
+        using void_t = void;
+
+        /** True if the element's impedance is known at compile-time (see FixedResistorT). */
+        template <typename ElementType, typename = void>
+        struct HasFixedImpedance : std::false_type
+        {
+        };
+
+        template <typename ElementType>
+        struct HasFixedImpedance<ElementType, void_t<decltype (ElementType::getFixedImpedance())>> : std::true_type
+        {
+        };
+
+        /**
+         * Holds an adaptor coefficient, which is replaced by a compile-time constant
+         * when FixedValue::value() can be computed from fixed port impedances.
+         */
+        template <typename T, typename FixedValue, bool isFixed = FixedValue::isFixed>
+        struct Coefficient
+        {
+            void set (T newValue) noexcept { value = newValue; }
+            T get() const noexcept { return value; }
+
+            T value = (T) 1.0;
+        };
+
+        template <typename T, typename FixedValue>
+        struct Coefficient<T, FixedValue, true>
+        {
+            void set (T) noexcept {}
+            static T get() noexcept { return (T) FixedValue::value(); }
+        };
+    } // namespace fixed_detail
+#endif // DOXYGEN
+
+    /**
+     * Calls fn for the given element, and for every element below it in the WDF tree.
+     * Usually this will be called on the root of the tree, to visit the whole circuit.
+     */
+    template <typename ElementType, typename Fn>
+    void forEachElement (ElementType& element, Fn&& fn)
+    {
+        fn (element);
+        element.visitPorts ([&fn] (auto& port) { forEachElement (port, fn); });
+    }
+
+    /**
+     * Returns the instrumentation counts for this element.
+     * If CHOWDSP_WDF_INSTRUMENTATION is disabled, the counts will always be zero.
+     */
+    inline InstrumentationCounters getInstrumentationCounters (const BaseWDF& element) noexcept
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION
+        return element.instrumentationCounters;
+#else
+        (void) element;
+        return {};
+#endif
+    }
+
+    /** Returns the sum of the instrumentation counts for every element in the circuit. */
+    template <typename RootType>
+    InstrumentationCounters getTotalInstrumentationCounters (RootType& root) noexcept
+    {
+        InstrumentationCounters total {};
+        forEachElement (root, [&total] (auto& element) { total += getInstrumentationCounters (element); });
+        return total;
+    }
+
+    /** Resets the instrumentation counts for every element in the circuit. */
+    template <typename RootType>
+    void resetInstrumentationCounters (RootType& root) noexcept
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION
+        forEachElement (root, [] (auto& element) { element.instrumentationCounters = {}; });
+#else
+        (void) root;
+#endif
+    }
+
+    /** Probe the voltage across this circuit element. */
+    template <typename T, typename WDFType>
+    inline T voltage (const WDFType& wdf) noexcept
+    {
+        return (wdf.wdf.a + wdf.wdf.b) * (T) 0.5;
+    }
+
+    /**Probe the current through this circuit element. */
+    template <typename T, typename WDFType>
+    inline T current (const WDFType& wdf) noexcept
+    {
+        return (wdf.wdf.a - wdf.wdf.b) * ((T) 0.5 * wdf.wdf.G);
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif // CHOWDSP_WDF_WDFT_BASE_H
+
+// #include "rtype_detail.h"
+#ifndef CHOWDSP_WDF_RTYPE_DETAIL_H
+#define CHOWDSP_WDF_RTYPE_DETAIL_H
+
+#include <array>
+#include <algorithm>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace chowdsp
+{
+#ifndef DOXYGEN
+namespace wdft
+{
+    /** Utility functions used internally by the R-Type adaptor */
+    namespace rtype_detail
+    {
+        /** Divides two numbers and rounds up if there is a remainder. */
+        template <typename T>
+        constexpr T ceil_div (T num, T den)
+        {
+            return (num + den - 1) / den;
+        }
+
+        template <typename T, size_t base_size>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, size_t>::type array_pad()
+        {
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = v_type::size;
+            constexpr auto num_simd_registers = ceil_div (base_size, simd_size);
+            return num_simd_registers * simd_size;
+#else
+            return base_size;
+#endif
+        }
+
+        template <typename T, size_t base_size>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, size_t>::type array_pad()
+        {
+            return base_size;
+        }
+
+        /** Functions to do a function for each element in the tuple */
+        template <typename Fn, typename Tuple, size_t... Ix>
+        constexpr void forEachInTuple (Fn&& fn, Tuple&& tuple, std::index_sequence<Ix...>) noexcept (noexcept (std::initializer_list<int> { (fn (std::get<Ix> (tuple), Ix), 0)... }))
+        {
+            (void) std::initializer_list<int> { ((void) fn (std::get<Ix> (tuple), Ix), 0)... };
+        }
+
+        template <typename T>
+        using TupleIndexSequence = std::make_index_sequence<std::tuple_size<std::remove_cv_t<std::remove_reference_t<T>>>::value>;
+
+        template <typename Fn, typename Tuple>
+        constexpr void forEachInTuple (Fn&& fn, Tuple&& tuple) noexcept (noexcept (forEachInTuple (std::forward<Fn> (fn), std::forward<Tuple> (tuple), TupleIndexSequence<Tuple> {})))
+        {
+            forEachInTuple (std::forward<Fn> (fn), std::forward<Tuple> (tuple), TupleIndexSequence<Tuple> {});
+        }
+
+        template <typename ElementType, int arraySize, int alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT>
+        struct AlignedArray
+        {
+            template <typename IntType>
+            ElementType& operator[] (IntType index) noexcept
+            {
+                return array[index];
+            }
+            template <typename IntType>
+            const ElementType& operator[] (IntType index) const noexcept
+            {
+                return array[index];
+            }
+
+            ElementType* data() noexcept { return array; }
+            const ElementType* data() const noexcept { return array; }
+
+            void clear() { std::fill (std::begin (array), std::end (array), ElementType {}); }
+            static constexpr int size() noexcept { return arraySize; }
+
+        private:
+            alignas (alignment) ElementType array[array_pad<ElementType, (size_t) arraySize>()] {};
+        };
+
+        template <typename T, int nRows, int nCols = nRows, int alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT>
+        using Matrix = AlignedArray<T, nRows, alignment>[(size_t) nCols];
+
+        /** Implementation for float/double. */
+        template <typename T, int numPorts>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_)
+        {
+            // input matrix (S) of size dim x dim
+            // input vector (a) of size 1 x dim
+            // output vector (b) of size 1 x dim
+
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = (int) v_type::size;
+            constexpr auto vec_size = ceil_div (numPorts, simd_size) * simd_size;
+
+            for (int c = 0; c < vec_size; c += simd_size)
+            {
+                auto b_vec = a_[0] * xsimd::load_aligned (S_[0].data() + c);
+                for (int r = 1; r < numPorts; ++r)
+                    b_vec = xsimd::fma (xsimd::broadcast (a_[r]), xsimd::load_aligned (S_[r].data() + c), b_vec);
+
+                xsimd::store_aligned (b_.data() + c, b_vec);
+            }
+#else // No SIMD
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+#endif // SIMD options
+        }
+
+#if defined(XSIMD_HPP)
+        /** Implementation for SIMD float/double. */
+        template <typename T, int numPorts>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_)
+        {
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+        }
+#endif // XSIMD
+
+        /** Computes a single output of the scattering matrix: b[outIndex] = sum_r S_[r][outIndex] * a_[r]. */
+        template <typename T, int numPorts>
+        constexpr T RtypeScatterSingle (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, int outIndex)
+        {
+            T b = S_[0][outIndex] * a_[0];
+            for (int r = 1; r < numPorts; ++r)
+                b += S_[r][outIndex] * a_[r];
+            return b;
+        }
+    } // namespace rtype_detail
+} // namespace wdft
+
+namespace wdf
+{
+    /** Utility functions used internally by the R-Type adaptor */
+    namespace rtype_detail
+    {
+        using wdft::rtype_detail::ceil_div;
+
+        template <typename Signature>
+        class FunctionRef;
+
+        /**
+         * A non-owning, non-allocating reference to a callable, similar to std::function,
+         * but without the heap allocation or type-erased copies.
+         *
+         * Function pointers (and lambdas without captures) are stored by value, so they
+         * are always safe to use. Any other callable is stored by reference, so it must
+         * outlive the FunctionRef. To catch the most common mistake, temporary callables
+         * which can't be converted to a function pointer are not accepted.
+         */
+        template <typename R, typename... Args>
+        class FunctionRef<R (Args...)>
+        {
+        public:
+            using FunctionPointer = R (*) (Args...);
+
+            /** Wraps a function pointer. */
+            FunctionRef (FunctionPointer fn) noexcept : trampoline (&callFunction) { target.function = fn; }
+
+            /** Wraps a lambda without captures (or anything else convertible to a function pointer). */
+            template <typename Fn,
+                      typename = std::enable_if_t<std::is_convertible<Fn&&, FunctionPointer>::value
+                                                  && ! std::is_same<std::decay_t<Fn>, FunctionRef>::value>>
+            FunctionRef (Fn&& fn) noexcept : FunctionRef (static_cast<FunctionPointer> (fn))
+            {
+            }
+
+            /** Wraps a reference to a callable object, which must outlive the FunctionRef. */
+            template <typename Fn,
+                      typename = std::enable_if_t<! std::is_convertible<Fn&, FunctionPointer>::value
+                                                  && ! std::is_same<std::remove_const_t<Fn>, FunctionRef>::value>,
+                      typename = void>
+            FunctionRef (Fn& fn) noexcept : trampoline (&callObject<Fn>)
+            {
+                target.object = (void*) &fn;
+            }
+
+            R operator() (Args... args) const
+            {
+                return trampoline (target, std::forward<Args> (args)...);
+            }
+
+        private:
+            union Target
+            {
+                void* object;
+                FunctionPointer function;
+            };
+
+            static R callFunction (const Target& target, Args... args)
+            {
+                return target.function (std::forward<Args> (args)...);
+            }
+
+            template <typename Fn>
+            static R callObject (const Target& target, Args... args)
+            {
+                return (*(Fn*) target.object) (std::forward<Args> (args)...);
+            }
+
+            Target target;
+            R (*trampoline) (const Target&, Args...);
+        };
+
+        template <typename T>
+        typename std::enable_if<std::is_floating_point<T>::value, size_t>::type array_pad (size_t base_size)
+        {
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = v_type::size;
+            const auto num_simd_registers = ceil_div (base_size, simd_size);
+            return num_simd_registers * simd_size;
+#else
+            return base_size;
+#endif
+        }
+
+        template <typename T>
+        typename std::enable_if<! std::is_floating_point<T>::value, size_t>::type array_pad (size_t base_size)
+        {
+            return base_size;
+        }
+
+        template <typename ElementType>
+        struct AlignedArray
+        {
+            explicit AlignedArray (size_t size) : m_size ((int) size),
+                                                  vector (array_pad<ElementType> (size), ElementType {})
+            {
+            }
+
+            ElementType& operator[] (int index) noexcept { return vector[index]; }
+            const ElementType& operator[] (int index) const noexcept { return vector[index]; }
+
+            ElementType* data() noexcept { return vector.data(); }
+            const ElementType* data() const noexcept { return vector.data(); }
+
+            void clear() { std::fill (std::begin (vector), std::end (vector), ElementType {}); }
+            int size() const noexcept { return (int) m_size; }
+
+        private:
+            const int m_size;
+#if defined(XSIMD_HPP)
+            std::vector<ElementType, xsimd::default_allocator<ElementType>> vector;
+#else
+            std::vector<ElementType> vector;
+#endif
+        };
+
+        template <typename ElementType>
+        struct Matrix
+        {
+            Matrix (size_t nRows, size_t nCols) : vector (nCols, AlignedArray<ElementType> (nRows))
+            {
+            }
+
+            AlignedArray<ElementType>& operator[] (int index) noexcept { return vector[(size_t) index]; }
+            const AlignedArray<ElementType>& operator[] (int index) const noexcept { return vector[(size_t) index]; }
+
+        private:
+            std::vector<AlignedArray<ElementType>> vector;
+        };
+
+        /** Implementation for float/double. */
+        template <typename T>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T>& S_, const AlignedArray<T>& a_, AlignedArray<T>& b_)
+        {
+            // input matrix (S) of size dim x dim
+            // input vector (a) of size 1 x dim
+            // output vector (b) of size 1 x dim
+
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = (int) v_type::size;
+            const auto numPorts = a_.size();
+            const auto vec_size = ceil_div (numPorts, simd_size) * simd_size;
+
+            for (int c = 0; c < vec_size; c += simd_size)
+            {
+                auto b_vec = a_[0] * xsimd::load_aligned (S_[0].data() + c);
+                for (int r = 1; r < numPorts; ++r)
+                    b_vec = xsimd::fma (xsimd::broadcast (a_[r]), xsimd::load_aligned (S_[r].data() + c), b_vec);
+
+                xsimd::store_aligned (b_.data() + c, b_vec);
+            }
+#else // No SIMD
+            const auto numPorts = a_.size();
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+#endif // SIMD options
+        }
+
+#if defined(XSIMD_HPP)
+        /** Implementation for SIMD float/double. */
+        template <typename T>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T>& S_, const AlignedArray<T>& a_, AlignedArray<T>& b_)
+        {
+            const auto numPorts = a_.size();
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+        }
+#endif // XSIMD
+
+        /** Computes a single output of the scattering matrix: b[outIndex] = sum_r S_[r][outIndex] * a_[r]. */
+        template <typename T>
+        T RtypeScatterSingle (const Matrix<T>& S_, const AlignedArray<T>& a_, int outIndex)
+        {
+            const auto numPorts = a_.size();
+            T b = S_[0][outIndex] * a_[0];
+            for (int r = 1; r < numPorts; ++r)
+                b += S_[r][outIndex] * a_[r];
+            return b;
+        }
+    } // namespace rtype_detail
+} // namespace wdf
+#endif // DOXYGEN
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_RTYPE_DETAIL_H
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /**
+     *  An adaptable R-Type adaptor.
+     *  For more information see: https://searchworks.stanford.edu/view/11891203, chapter 2
+     *
+     *  The upPortIndex argument descibes with port of the scattering matrix is being adapted.
+     *
+     *  The ImpedanceCalculator template argument with a static method of the form:
+     *  @code
+     *  template <typename RType>
+     *  static T calcImpedance (RType& R);
+     *  @endcode
+     */
+    template <typename T, int upPortIndex, typename ImpedanceCalculator, typename... PortTypes>
+    class RtypeAdaptor : public BaseWDF
+    {
+    public:
+        /** Number of ports connected to RtypeAdaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes) + 1);
+
+        explicit RtypeAdaptor (PortTypes&... dps) : downPorts (std::tie (dps...))
+        {
+            b_vec.clear();
+            a_vec.clear();
+
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
+                                          downPorts);
+        }
+
+        [[deprecated ("Prefer the alternative constuctor which accepts the port references directly")]] explicit RtypeAdaptor (std::tuple<PortTypes&...> dps) : downPorts (dps)
+        {
+            b_vec.clear();
+            a_vec.clear();
+
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
+                                          downPorts);
+        }
+
+        /** Re-computes the port impedance at the adapted upward-facing port */
+        void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = ImpedanceCalculator::calcImpedance (*this);
+            wdf.G = (T) 1 / wdf.R;
+        }
+
+        constexpr auto getPortImpedances()
+        {
+            std::array<T, numPorts - 1> portImpedances {};
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { portImpedances[i] = port.wdf.R; },
+                                          downPorts);
+
+            return portImpedances;
+        }
+
+        /** Use this function to set the scattering matrix data. */
+        void setSMatrixData (const T (&mat)[numPorts][numPorts])
+        {
+            for (int i = 0; i < numPorts; ++i)
+                for (int j = 0; j < numPorts; ++j)
+                    S_matrix[j][i] = mat[i][j];
+        }
+
+        /** Computes the incident wave. */
+        inline void incident (T downWave) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = downWave;
+            a_vec[upPortIndex] = wdf.a;
+
+            rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
+                                              auto portIndex = getPortIndex ((int) i);
+                                              port.incident (b_vec[portIndex]); },
+                                          downPorts);
+        }
+
+        /** Computes the reflected wave */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
+                                              auto portIndex = getPortIndex ((int) i);
+                                              a_vec[portIndex] = port.reflected(); },
+                                          downPorts);
+
+            // S_matrix[upPortIndex][upPortIndex] is zero, so this is fine without a fresh a_vec[upPortIndex].
+            wdf.b = rtype_detail::RtypeScatterSingle (S_matrix, a_vec, upPortIndex);
+            return wdf.b;
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          downPorts);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        constexpr auto getPortIndex (int tupleIndex)
+        {
+            return tupleIndex < upPortIndex ? tupleIndex : tupleIndex + 1;
+        }
+
+        std::tuple<PortTypes&...> downPorts; // tuple of ports connected to RtypeAdaptor
+
+        rtype_detail::Matrix<T, numPorts> S_matrix; // square matrix representing S
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_RTYPE_ADAPTOR_H
+
+// #include "root_rtype_adaptor.h"
+#ifndef CHOWDSP_WDF_ROOT_RTYPE_ADAPTOR_H
+#define CHOWDSP_WDF_ROOT_RTYPE_ADAPTOR_H
+
+// #include "../wdft/wdft_base.h"
+
+// #include "rtype_detail.h"
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /**
+     *  A non-adaptable R-Type adaptor.
+     *  For more information see: https://searchworks.stanford.edu/view/11891203, chapter 2
+     *
+     *  The ImpedanceCalculator template argument with a static method of the form:
+     *  @code
+     *  template <typename RType>
+     *  static void calcImpedance (RType& R);
+     *  @endcode
+     */
+    template <typename T, typename ImpedanceCalculator, typename... PortTypes>
+    class RootRtypeAdaptor : public RootWDF
+    {
+    public:
+        /** Number of ports connected to RootRtypeAdaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+
+        explicit RootRtypeAdaptor (PortTypes&... dps) : downPorts (std::tie (dps...))
+        {
+            b_vec.clear();
+            a_vec.clear();
+
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
+                                          downPorts);
+        }
+
+        [[deprecated ("Prefer the alternative constuctor which accepts the port references directly")]] explicit RootRtypeAdaptor (std::tuple<PortTypes&...> dps) : downPorts (dps)
+        {
+            b_vec.clear();
+            a_vec.clear();
+
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
+                                          downPorts);
+        }
+
+        /** Recomputes internal variables based on the incoming impedances */
+        void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            ImpedanceCalculator::calcImpedance (*this);
+        }
+
+        constexpr auto getPortImpedances()
+        {
+            std::array<T, numPorts> portImpedances {};
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { portImpedances[i] = port.wdf.R; },
+                                          downPorts);
+
+            return portImpedances;
+        }
+
+        /** Use this function to set the scattering matrix data. */
+        void setSMatrixData (const T (&mat)[numPorts][numPorts])
+        {
+            for (int i = 0; i < numPorts; ++i)
+                for (int j = 0; j < numPorts; ++j)
+                    S_matrix[j][i] = mat[i][j];
+        }
+
+        /** Computes both the incident and reflected waves at this root node. */
+        inline void compute() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
+                                          port.incident (b_vec[i]);
+                                          a_vec[i] = port.reflected(); },
+                                          downPorts);
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          downPorts);
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            // the incoming waves are stored between calls to compute()
+            for (int i = 0; i < numPorts; ++i)
+                visitor (a_vec[i]);
+        }
+
+    private:
+        std::tuple<PortTypes&...> downPorts; // tuple of ports connected to RtypeAdaptor
+
+        rtype_detail::Matrix<T, numPorts> S_matrix; // square matrix representing S
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_ROOT_RTYPE_ADAPTOR_H
+
+// #include "incremental_rtype_adaptor.h"
+#ifndef CHOWDSP_WDF_INCREMENTAL_RTYPE_ADAPTOR_H
+#define CHOWDSP_WDF_INCREMENTAL_RTYPE_ADAPTOR_H
+
+#include <cmath>
+#include <limits>
+
+// #include "../wdft/wdft_base.h"
+
+// #include "rtype_detail.h"
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** The circuit nodes that an R-Type port is connected between. Node 0 is the datum (or "ground") node. */
+    struct RtypePortNodes
+    {
+        int positive;
+        int negative;
+    };
+
+#ifndef DOXYGEN
+    namespace rtype_detail
+    {
+        /**
+         * Returns true if a scattering matrix with numPorts ports and numNodes (non-datum) nodes
+         * is cheaper to apply as low-rank factors, than as a dense numPorts x numPorts matrix.
+         */
+        constexpr bool useLowRankScattering (int numNodes, int numPorts)
+        {
+            return numNodes + 1 < numPorts;
+        }
+
+        /**
+         * Computes the scattering matrix of an R-Type adaptor from its topology, keeps it up to
+         * date when the port impedances change, and applies it to the incident waves.
+         *
+         * For an R-Type adaptor which only connects its ports together (i.e. with no internal
+         * elements), the nodal admittance matrix is X = Q G Q^T, where Q is the node-port incidence
+         * matrix and G holds the port admittances. The scattering matrix is then S = 2 Q^T Y G - I,
+         * with Y = X^-1 Q. When the admittance of port i changes by dG, X changes by dG q_i q_i^T, so
+         * Y can be updated with the Sherman-Morrison formula, using only column i of Y:
+         *     Y' = Y - dG y_i (q_i^T Y) / (1 + dG q_i^T y_i)
+         * which costs O(numNodes * numPorts), rather than the O(numNodes^3) of a full recomputation.
+         *
+         * S has rank numNodes at most, so when the circuit has few nodes compared to the number of
+         * ports, S is never formed. Instead, the incident waves are scattered as b = 2 Q^T (V a) - a,
+         * with V = Y G: a numNodes x numPorts matrix-vector product, followed by a sparse product with
+         * the incidence matrix, which only takes the difference between the two nodes of each port.
+         * This needs (numNodes + 1) * numPorts multiply-adds, rather than numPorts^2.
+         *
+         * If adaptedPort is a valid port index, that port is adapted: its admittance is left out of X,
+         * and its impedance is chosen so that the port is reflection-free.
+         */
+        template <typename T, typename Topology, int numPorts, int adaptedPort = -1>
+        class NodalScatteringMatrix
+        {
+        public:
+            static constexpr int numNodes = Topology::numNodes;
+            static constexpr bool isLowRank = useLowRankScattering (numNodes, numPorts);
+
+            NodalScatteringMatrix()
+            {
+                for (int i = 0; i < numPorts; ++i)
+                    portNodes[i] = Topology::getPortNodes (i);
+
+                upPortRow.clear();
+            }
+
+            /** Sets the number of incremental updates after which Y is recomputed from scratch. */
+            void setFullUpdateInterval (int numUpdates) noexcept { fullUpdateInterval = numUpdates > 1 ? numUpdates : 1; }
+
+            /** Returns the number of full recomputations of Y (mostly useful for testing). */
+            int getNumFullUpdates() const noexcept { return numFullUpdates; }
+
+            /** Updates the scattering matrix for a new set of port impedances. */
+            void update (const std::array<T, numPorts>& portImpedances)
+            {
+                T newG[numPorts];
+                int numChanged = 0;
+                for (int i = 0; i < numPorts; ++i)
+                {
+                    newG[i] = i == adaptedPort ? (T) 0 : (T) 1 / portImpedances[i];
+                    numChanged += all (newG[i] == G[i]) ? 0 : 1;
+                }
+
+                if (! isInitialised || updatesSinceFullUpdate + numChanged > fullUpdateInterval || numChanged * incrementalCost > fullCost)
+                {
+                    for (int i = 0; i < numPorts; ++i)
+                        G[i] = newG[i];
+                    fullUpdate();
+                }
+                else if (numChanged > 0)
+                {
+                    // several ports changing at once become a sequence of rank-1 updates
+                    bool isWellConditioned = true;
+                    for (int i = 0; i < numPorts && isWellConditioned; ++i)
+                    {
+                        if (! all (newG[i] == G[i]))
+                            isWellConditioned = rankOneUpdate (Y, i, newG[i] - G[i]);
+                        G[i] = newG[i];
+                    }
+
+                    if (isWellConditioned)
+                    {
+                        updatesSinceFullUpdate += numChanged;
+                    }
+                    else
+                    {
+                        for (int i = 0; i < numPorts; ++i)
+                            G[i] = newG[i];
+                        fullUpdate();
+                    }
+                }
+
+                computeScatteringData();
+            }
+
+            /** Returns the impedance of the adapted port. */
+            T getAdaptedImpedance() const noexcept { return adaptedImpedance; }
+
+            /** Computes the reflected waves, b = S a */
+            void scatter (const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_) noexcept
+            {
+                scatter (a_, b_, std::integral_constant<bool, isLowRank> {});
+            }
+
+            /** Computes the reflected wave at the adapted port, using only the corresponding row of S. */
+            T scatterAdaptedPort (const AlignedArray<T, numPorts>& a_) const noexcept
+            {
+                T b = upPortRow[0] * a_[0];
+                for (int c = 1; c < numPorts; ++c)
+                    b += upPortRow[c] * a_[c];
+                return b;
+            }
+
+        private:
+            static constexpr int fullCost = numNodes * numNodes * numNodes / 3 + numNodes * numNodes * numPorts;
+            static constexpr int incrementalCost = numNodes * numPorts;
+
+            /** Returns (q_port^T mat)[col], i.e. the difference between the port's nodes, in column col of mat. */
+            T nodeDifference (const T (*mat)[numPorts], int port, int col) const noexcept
+            {
+                const auto& nodes = portNodes[port];
+                return (nodes.positive > 0 ? mat[nodes.positive - 1][col] : (T) 0)
+                       - (nodes.negative > 0 ? mat[nodes.negative - 1][col] : (T) 0);
+            }
+
+            /**
+             * Applies the Sherman-Morrison update to mat, for port's admittance changing by deltaG.
+             *
+             * The denominator, 1 + dG q_i^T y_i, is the ratio of the determinants of X after and before
+             * the update. It gets close to zero when the port held up most of the admittance between
+             * its nodes, and that admittance is removed (e.g. a pot going from 0 Ohms to its full
+             * resistance), and very large in the opposite case. Either way, the update cancels out most
+             * of mat, leaving mostly rounding error, so then mat is left unchanged, and this returns false,
+             * so that it can be recomputed instead.
+             */
+            bool rankOneUpdate (T (&mat)[numNodes][numPorts], int port, T deltaG) const noexcept
+            {
+                T y_i[numNodes];
+                for (int n = 0; n < numNodes; ++n)
+                    y_i[n] = mat[n][port];
+
+                T qY_i[numPorts];
+                for (int c = 0; c < numPorts; ++c)
+                    qY_i[c] = nodeDifference (mat, port, c);
+
+                const auto denominator = (T) 1 + deltaG * qY_i[port];
+                if (! all (denominator >= (T) minDenominator()) || ! all (denominator <= (T) 1 / (T) minDenominator()))
+                    return false;
+
+                const auto scale = deltaG / denominator;
+                for (int n = 0; n < numNodes; ++n)
+                    for (int c = 0; c < numPorts; ++c)
+                        mat[n][c] -= scale * y_i[n] * qY_i[c];
+
+                return true;
+            }
+
+            /**
+             * The smallest Sherman-Morrison denominator (and the reciprocal of the largest) for which
+             * an update is accepted. Each accepted update can lose up to a quarter of the available
+             * precision, and the periodic full updates stop those losses from adding up further.
+             */
+            static NumericType<T> minDenominator() noexcept
+            {
+                return std::sqrt (std::sqrt (std::numeric_limits<NumericType<T>>::epsilon()));
+            }
+
+            /** Recomputes Y = X^-1 Q, with X = Q G Q^T. */
+            void fullUpdate()
+            {
+                T X[numNodes][numNodes] {};
+                for (int n = 0; n < numNodes; ++n)
+                    for (int i = 0; i < numPorts; ++i)
+                        Y[n][i] = (T) 0;
+
+                for (int i = 0; i < numPorts; ++i)
+                {
+                    const auto p = portNodes[i].positive - 1;
+                    const auto m = portNodes[i].negative - 1;
+                    if (p >= 0)
+                    {
+                        X[p][p] += G[i];
+                        Y[p][i] = (T) 1;
+                    }
+                    if (m >= 0)
+                    {
+                        X[m][m] += G[i];
+                        Y[m][i] = (T) -1;
+                    }
+                    if (p >= 0 && m >= 0)
+                    {
+                        X[p][m] -= G[i];
+                        X[m][p] -= G[i];
+                    }
+                }
+
+                // X is symmetric positive definite (for a connected circuit), so no pivoting is needed.
+                // Solve X Y = Q, by Gaussian elimination...
+                for (int k = 0; k < numNodes; ++k)
+                {
+                    for (int r = k + 1; r < numNodes; ++r)
+                    {
+                        const auto factor = X[r][k] / X[k][k];
+                        for (int c = k; c < numNodes; ++c)
+                            X[r][c] -= factor * X[k][c];
+                        for (int i = 0; i < numPorts; ++i)
+                            Y[r][i] -= factor * Y[k][i];
+                    }
+                }
+
+                // ... and back substitution
+                for (int k = numNodes - 1; k >= 0; --k)
+                {
+                    for (int i = 0; i < numPorts; ++i)
+                    {
+                        for (int c = k + 1; c < numNodes; ++c)
+                            Y[k][i] -= X[k][c] * Y[c][i];
+                        Y[k][i] /= X[k][k];
+                    }
+                }
+
+                isInitialised = true;
+                updatesSinceFullUpdate = 0;
+                numFullUpdates++;
+            }
+
+            /** Computes either S = 2 Q^T Y G - I (transposed, as used by RtypeScatter), or its factors V = Y G. */
+            void computeScatteringData() noexcept
+            {
+                T G_S[numPorts];
+                for (int i = 0; i < numPorts; ++i)
+                    G_S[i] = G[i];
+
+                const T(*Y_S)[numPorts] = Y;
+                if (adaptedPort >= 0)
+                {
+                    // connect the adapted port, with the impedance that makes it reflection-free
+                    const auto upPort = adaptedPort < 0 ? 0 : adaptedPort;
+                    for (int n = 0; n < numNodes; ++n)
+                        for (int c = 0; c < numPorts; ++c)
+                            Y_adapted[n][c] = Y[n][c];
+
+                    adaptedImpedance = nodeDifference (Y, upPort, upPort);
+                    G_S[upPort] = (T) 1 / adaptedImpedance;
+                    rankOneUpdate (Y_adapted, upPort, G_S[upPort]); // the denominator is always 2 here
+                    Y_S = Y_adapted;
+
+                    for (int c = 0; c < numPorts; ++c)
+                        upPortRow[c] = (T) 2 * nodeDifference (Y_adapted, upPort, c) * G_S[c] - (c == upPort ? (T) 1 : (T) 0);
+                }
+
+                for (int c = 0; c < numPorts; ++c)
+                {
+                    for (int r = 0; r < numOutputs; ++r)
+                    {
+                        if (isLowRank)
+                            scatteringData[c][r] = Y_S[r][c] * G_S[c];
+                        else
+                            scatteringData[c][r] = (T) 2 * nodeDifference (Y_S, r, c) * G_S[c] - (r == c ? (T) 1 : (T) 0);
+                    }
+                }
+            }
+
+            void scatter (const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_, std::true_type) noexcept
+            {
+                // V a has only a few outputs, but each has numPorts terms, so the sums are split up
+                // into independent partial sums, rather than waiting on one long chain of additions
+                constexpr int numPartials = 4;
+                T partials[numPartials][numNodes] {};
+                for (int c = 0; c < numPorts; ++c)
+                    for (int n = 0; n < numNodes; ++n)
+                        partials[c % numPartials][n] += scatteringData[c][n] * a_[c];
+
+                for (int n = 0; n < numNodes; ++n)
+                    nodeWaves[n + 1] = (partials[0][n] + partials[1][n]) + (partials[2][n] + partials[3][n]);
+
+                // the topology is known at compile-time, so once this loop is unrolled, the node lookups can be too
+                for (int i = 0; i < numPorts; ++i)
+                {
+                    const auto nodes = Topology::getPortNodes (i);
+                    b_[i] = (T) 2 * (nodeWaves[nodes.positive] - nodeWaves[nodes.negative]) - a_[i];
+                }
+            }
+
+            void scatter (const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_, std::false_type) noexcept
+            {
+                RtypeScatter (scatteringData, a_, b_);
+            }
+
+            static constexpr int numOutputs = isLowRank ? numNodes : numPorts;
+
+            RtypePortNodes portNodes[numPorts] {};
+            T G[numPorts] {}; // port admittances
+            T Y[numNodes][numPorts] {}; // X^-1 Q
+            T Y_adapted[numNodes][numPorts] {}; // Y, including the adapted port
+            T adaptedImpedance {};
+
+            Matrix<T, numOutputs, numPorts> scatteringData; // S (transposed), or its low-rank factors V
+            T nodeWaves[numNodes + 1] {}; // V a, with the datum node first
+            AlignedArray<T, adaptedPort >= 0 ? numPorts : 1> upPortRow; // the row of S for the adapted port
+
+            bool isInitialised = false;
+            int updatesSinceFullUpdate = 0;
+            int fullUpdateInterval = 64;
+            int numFullUpdates = 0;
+        };
+    } // namespace rtype_detail
+#endif // DOXYGEN
+
+    /**
+     *  A non-adaptable R-Type adaptor, which computes its own scattering matrix from the
+     *  circuit topology, and updates it incrementally when only some of the port impedances change.
+     *
+     *  Rather than an ImpedanceCalculator, this adaptor takes a Topology, describing which nodes
+     *  each port is connected between (see RtypePortNodes). Node 0 is the datum node, and the
+     *  other nodes are numbered from 1 to numNodes:
+     *  @code
+     *  struct Topology
+     *  {
+     *      static constexpr int numNodes = 3;
+     *      static wdft::RtypePortNodes getPortNodes (int portIndex)
+     *      {
+     *          constexpr wdft::RtypePortNodes nodes[] = { { 2, 0 }, { 3, 0 }, { 2, 3 }, { 1, 3 }, { 1, 2 }, { 0, 1 } };
+     *          return nodes[portIndex];
+     *      }
+     *  };
+     *  @endcode
+     *
+     *  The R-Type must only connect its ports together, without any internal elements (e.g. a
+     *  controlled source), and every node must be connected to the datum node through the ports.
+     *  When a single port impedance changes (e.g. one pot moving), the scattering matrix is
+     *  updated with a rank-1 (Sherman-Morrison) update, in O(numNodes * numPorts) operations. A few
+     *  ports changing at once become a sequence of rank-1 updates, and if enough ports change that
+     *  a full recomputation would be cheaper, the matrix is recomputed from scratch. To stop
+     *  rounding errors from building up, the matrix is also recomputed from scratch after every
+     *  64 incremental updates, which can be changed with setFullUpdateInterval(), or whenever
+     *  a rank-1 update would be ill-conditioned (e.g. a pot going from 0 Ohms to its full resistance).
+     *
+     *  The rank of the scattering matrix is at most numNodes, so for adaptors with many ports
+     *  but only a few nodes (e.g. a large parallel junction), the scattering matrix is stored
+     *  as its low-rank factors, and applied in O(numNodes * numPorts) operations per sample,
+     *  rather than the O(numPorts^2) of the dense matrix. This is chosen automatically at
+     *  compile-time, whenever numNodes + 1 < numPorts.
+     */
+    template <typename T, typename Topology, typename... PortTypes>
+    class IncrementalRootRtypeAdaptor : public RootWDF
+    {
+    public:
+        /** Number of ports connected to IncrementalRootRtypeAdaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+
+        explicit IncrementalRootRtypeAdaptor (PortTypes&... dps) : downPorts (std::tie (dps...))
+        {
+            b_vec.clear();
+            a_vec.clear();
+
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
+                                          downPorts);
+            calcImpedance();
+        }
+
+        /** Updates the scattering matrix, based on the incoming impedances */
+        void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            scatteringMatrix.update (getPortImpedances());
+        }
+
+        /** Sets the number of incremental updates after which the scattering matrix is recomputed from scratch. */
+        void setFullUpdateInterval (int numUpdates) noexcept { scatteringMatrix.setFullUpdateInterval (numUpdates); }
+
+        /** Returns the number of times the scattering matrix has been recomputed from scratch. */
+        int getNumFullUpdates() const noexcept { return scatteringMatrix.getNumFullUpdates(); }
+
+        constexpr auto getPortImpedances()
+        {
+            std::array<T, numPorts> portImpedances {};
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { portImpedances[i] = port.wdf.R; },
+                                          downPorts);
+
+            return portImpedances;
+        }
+
+        /** Computes both the incident and reflected waves at this root node. */
+        inline void compute() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            scatteringMatrix.scatter (a_vec, b_vec);
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
+                                          port.incident (b_vec[i]);
+                                          a_vec[i] = port.reflected(); },
+                                          downPorts);
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          downPorts);
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            // the incoming waves are stored between calls to compute()
+            for (int i = 0; i < numPorts; ++i)
+                visitor (a_vec[i]);
+        }
+
+    private:
+        std::tuple<PortTypes&...> downPorts; // tuple of ports connected to RtypeAdaptor
+
+        rtype_detail::NodalScatteringMatrix<T, Topology, numPorts> scatteringMatrix;
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
+    };
+
+    /**
+     *  An adaptable R-Type adaptor, which computes its own scattering matrix from the circuit
+     *  topology, and updates it incrementally when only some of the port impedances change.
+     *
+     *  This works the same way as IncrementalRootRtypeAdaptor, except that the Topology also
+     *  includes the upward-facing port, at upPortIndex. The impedance of the upward-facing port
+     *  is the impedance of the rest of the circuit, as seen from that port.
+     */
+    template <typename T, int upPortIndex, typename Topology, typename... PortTypes>
+    class IncrementalRtypeAdaptor : public BaseWDF
+    {
+    public:
+        /** Number of ports connected to IncrementalRtypeAdaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes) + 1);
+
+        explicit IncrementalRtypeAdaptor (PortTypes&... dps) : downPorts (std::tie (dps...))
+        {
+            b_vec.clear();
+            a_vec.clear();
+
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
+                                          downPorts);
+            calcImpedance();
+        }
+
+        /** Updates the scattering matrix, and re-computes the port impedance at the adapted upward-facing port */
+        void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            scatteringMatrix.update (getPortImpedances());
+            wdf.R = scatteringMatrix.getAdaptedImpedance();
+            wdf.G = (T) 1 / wdf.R;
+        }
+
+        /** Sets the number of incremental updates after which the scattering matrix is recomputed from scratch. */
+        void setFullUpdateInterval (int numUpdates) noexcept { scatteringMatrix.setFullUpdateInterval (numUpdates); }
+
+        /** Returns the number of times the scattering matrix has been recomputed from scratch. */
+        int getNumFullUpdates() const noexcept { return scatteringMatrix.getNumFullUpdates(); }
+
+        /** Returns the port impedances, with a placeholder for the (adapted) upward-facing port. */
+        constexpr auto getPortImpedances()
+        {
+            std::array<T, numPorts> portImpedances {};
+            portImpedances[upPortIndex] = (T) 1;
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { portImpedances[getPortIndex ((int) i)] = port.wdf.R; },
+                                          downPorts);
+
+            return portImpedances;
+        }
+
+        /** Computes the incident wave. */
+        inline void incident (T downWave) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = downWave;
+            a_vec[upPortIndex] = wdf.a;
+
+            scatteringMatrix.scatter (a_vec, b_vec);
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
+                                              auto portIndex = getPortIndex ((int) i);
+                                              port.incident (b_vec[portIndex]); },
+                                          downPorts);
+        }
+
+        /** Computes the reflected wave */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) {
+                                              auto portIndex = getPortIndex ((int) i);
+                                              a_vec[portIndex] = port.reflected(); },
+                                          downPorts);
+
+            // S[upPortIndex][upPortIndex] is zero, so this is fine without a fresh a_vec[upPortIndex].
+            wdf.b = scatteringMatrix.scatterAdaptedPort (a_vec);
+            return wdf.b;
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          downPorts);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        constexpr auto getPortIndex (int tupleIndex)
+        {
+            return tupleIndex < upPortIndex ? tupleIndex : tupleIndex + 1;
+        }
+
+        std::tuple<PortTypes&...> downPorts; // tuple of ports connected to RtypeAdaptor
+
+        rtype_detail::NodalScatteringMatrix<T, Topology, numPorts, upPortIndex> scatteringMatrix;
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_INCREMENTAL_RTYPE_ADAPTOR_H
+
+// #include "wdf_rtype.h"
+#ifndef CHOWDSP_WDF_WDF_RTYPE_H
+#define CHOWDSP_WDF_WDF_RTYPE_H
+
+#include <functional>
+// #include "../wdf/wdf_base.h"
+#ifndef CHOWDSP_WDF_WDF_BASE_H
+#define CHOWDSP_WDF_WDF_BASE_H
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// #include "../wdft/wdft.h"
+#ifndef CHOWDSP_WDF_T_INCLUDED
+#define CHOWDSP_WDF_T_INCLUDED
+
+namespace chowdsp
+{
+/** API for constructing Wave Digital Filters with a fixed compile-time architecture */
+namespace wdft
+{
+}
+
+} // namespace chowdsp
+
+// #include "wdft_one_ports.h"
+#ifndef CHOWDSP_WDF_WDFT_ONE_PORTS_H
+#define CHOWDSP_WDF_WDFT_ONE_PORTS_H
+
+#include <ratio>
+
+// #include "wdft_base.h"
+#ifndef CHOWDSP_WDF_WDFT_BASE_H
+#define CHOWDSP_WDF_WDFT_BASE_H
+
+#include <type_traits>
+
+// #include "../math/sample_type.h"
+#ifndef CHOWDSP_WDF_SAMPLE_TYPE_H
+#define CHOWDSP_WDF_SAMPLE_TYPE_H
+
+#include <type_traits>
+
+#ifndef DOXYGEN
+
+namespace chowdsp
+{
+#if ! (JUCE_MODULE_AVAILABLE_chowdsp_dsp)
+/** Useful structs for determining the internal data type of SIMD types */
+namespace SampleTypeHelpers
+{
+    template <typename T, bool = std::is_floating_point<T>::value>
+    struct ElementType
+    {
+        using Type = T;
+    };
+
+    template <typename T>
+    struct ElementType<T, false>
+    {
+        using Type = typename T::value_type;
+    };
+} // namespace SampleTypeHelpers
+#endif
+
+/** Type alias for a SIMD numeric type */
+template <typename T>
+using NumericType = typename SampleTypeHelpers::ElementType<T>::Type;
+
+/** Returns true if all the elements in a SIMD vector are equal */
+inline bool all (bool x)
+{
+    return x;
+}
+
+/** Ternary select operation */
+template <typename T>
+inline T select (bool b, const T& t, const T& f)
+{
+    return b ? t : f;
+}
+} // namespace chowdsp
+
+#endif // DOXYGEN
+
+#endif //CHOWDSP_WDF_SAMPLE_TYPE_H
+
+// #include "../util/instrumentation.h"
+#ifndef CHOWDSP_WDF_INSTRUMENTATION_H
+#define CHOWDSP_WDF_INSTRUMENTATION_H
+
+#include <cstdint>
+
+/**
+ * If CHOWDSP_WDF_INSTRUMENTATION is enabled, every WDF element keeps count of
+ * how many times its impedance has been recomputed, how many impedance changes
+ * have been propagated through it, and how many incident/reflected waves it has
+ * processed. The counts can be retrieved with wdft::getInstrumentationCounters().
+ *
+ * When the option is disabled (the default), the counters are compiled out
+ * completely, so there is no runtime or memory cost.
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_INSTRUMENTATION
+#define CHOWDSP_WDF_INSTRUMENTATION 0
+#endif
+
+/**
+ * If CHOWDSP_WDF_INSTRUMENTATION is enabled, CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+ * can be set to a power of two N, in which case every Nth call to each instrumented
+ * method is timed using the CPU cycle counter (rdtsc on x86, cntvct_el0 on ARM64).
+ * Sampling keeps the overhead of reading the counter low, while still giving a good
+ * estimate of the per-call cost.
+ */
+#ifndef CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+#define CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING 0
+#endif
+
+#if CHOWDSP_WDF_INSTRUMENTATION && CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHOWDSP_WDF_INSTRUMENTATION_USE_CNTVCT 1
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** Instrumentation counts for a single WDF element (see CHOWDSP_WDF_INSTRUMENTATION). */
+    struct InstrumentationCounters
+    {
+        uint64_t calcImpedance = 0; /* number of calls to calcImpedance() */
+        uint64_t propagateImpedanceChange = 0; /* number of impedance changes propagated through this element */
+        uint64_t incident = 0; /* number of calls to incident(), or compute() for R-Type root adaptors */
+        uint64_t reflected = 0; /* number of calls to reflected() */
+
+        /**
+         * Total cycles spent in the sampled calls to incident() and reflected(). Note that for
+         * adaptors this includes the time spent in the connected ports, so the cost of an adaptor
+         * itself is roughly its average cycles, minus the average cycles of its ports.
+         */
+        uint64_t cycles = 0;
+        uint64_t cycleSamples = 0; /* number of calls included in the cycle count */
+
+        /** Returns the average number of cycles per sampled call to incident() or reflected() */
+        double getAverageCycles() const noexcept
+        {
+            return cycleSamples == 0 ? 0.0 : (double) cycles / (double) cycleSamples;
+        }
+
+        InstrumentationCounters& operator+= (const InstrumentationCounters& other) noexcept
+        {
+            calcImpedance += other.calcImpedance;
+            propagateImpedanceChange += other.propagateImpedanceChange;
+            incident += other.incident;
+            reflected += other.reflected;
+            cycles += other.cycles;
+            cycleSamples += other.cycleSamples;
+            return *this;
+        }
+    };
+
+#ifndef DOXYGEN
+    namespace instrumentation_detail
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION && CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+        static_assert ((CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING & (CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING - 1)) == 0,
+                       "The cycle sampling interval must be a power of two!");
+
+        inline uint64_t readCycleCounter() noexcept
+        {
+#if CHOWDSP_WDF_INSTRUMENTATION_USE_RDTSC
+            return (uint64_t) __rdtsc();
+#elif CHOWDSP_WDF_INSTRUMENTATION_USE_CNTVCT
+            uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0"
+                         : "=r"(ticks));
+            return ticks;
+#else
+            return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+#endif
+
+#if CHOWDSP_WDF_INSTRUMENTATION
+        /** Increments a call counter, and (maybe) measures the cycles spent in the current scope. */
+        class ScopedCounter
+        {
+        public:
+            ScopedCounter (uint64_t& callCount, InstrumentationCounters& counters) noexcept
+#if CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+                : sampledCounters ((callCount++ & (CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING - 1)) == 0 ? &counters : nullptr)
+            {
+                if (sampledCounters != nullptr)
+                    startTime = readCycleCounter();
+            }
+#else
+            {
+                callCount++;
+                (void) counters;
+            }
+#endif
+
+#if CHOWDSP_WDF_INSTRUMENTATION_CYCLE_SAMPLING
+            ~ScopedCounter() noexcept
+            {
+                if (sampledCounters != nullptr)
+                {
+                    sampledCounters->cycles += readCycleCounter() - startTime;
+                    sampledCounters->cycleSamples++;
+                }
+            }
+
+        private:
+            InstrumentationCounters* sampledCounters;
+            uint64_t startTime = 0;
+#endif
+        };
+#endif
+    } // namespace instrumentation_detail
+#endif // DOXYGEN
+} // namespace wdft
+} // namespace chowdsp
+
+#if CHOWDSP_WDF_INSTRUMENTATION
+/** Counts a call to the given method of the current WDF element */
+#define CHOWDSP_WDF_INSTRUMENT_COUNT(method) (this->instrumentationCounters.method++)
+
+/** Counts a call to the given method of the current WDF element, and samples the time spent in the method */
+#define CHOWDSP_WDF_INSTRUMENT_TIMED(method) \
+    ::chowdsp::wdft::instrumentation_detail::ScopedCounter chowdsp_wdf_instrumentation_scope { this->instrumentationCounters.method, this->instrumentationCounters }
+#else
+#define CHOWDSP_WDF_INSTRUMENT_COUNT(method)
+#define CHOWDSP_WDF_INSTRUMENT_TIMED(method)
+#endif
+
+#endif //CHOWDSP_WDF_INSTRUMENTATION_H
+
+
+#ifndef CHOWDSP_WDF_TRACING
+#define CHOWDSP_WDF_TRACING 0
+#endif
+
+#if CHOWDSP_WDF_TRACING
+// #include "../util/impedance_trace.h"
+#ifndef CHOWDSP_WDF_IMPEDANCE_TRACE_H
+#define CHOWDSP_WDF_IMPEDANCE_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * If CHOWDSP_WDF_TRACING is enabled, every impedance propagation through the
+ * WDF tree is recorded into the active ImpedanceTracer (if there is one).
+ *
+ * When the option is disabled (the default), the tracing hooks are compiled
+ * out completely, so there is no runtime cost, and this header is not included
+ * by the WDF elements (it can still be included directly, for the tracer classes).
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_TRACING
+#define CHOWDSP_WDF_TRACING 0
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+    class BaseWDF;
+
+    /** A single impedance propagation event, recorded by the ImpedanceTracer. */
+    struct ImpedanceTraceEvent
+    {
+        enum class Type : uint8_t
+        {
+            Propagation, /* the element recomputed its impedance, and (maybe) propagated the change to its parent */
+            Deferred, /* the propagation was stopped by a ScopedDeferImpedancePropagation */
+            DeferredCalc, /* the element recomputed its impedance when a ScopedDeferImpedancePropagation went out of scope */
+        };
+
+        Type type = Type::Propagation;
+        uint32_t depth = 0; /* the number of elements that the change has propagated through before reaching this element */
+        uint64_t propagationId = 0; /* all the events triggered by the same parameter change share an ID */
+        const BaseWDF* element = nullptr; /* the element that this event happened at */
+        const BaseWDF* source = nullptr; /* the element whose impedance change started the propagation */
+        int64_t startNs = 0; /* start time of the event (steady_clock) */
+        int64_t durationNs = 0; /* total duration, including the propagation to the ancestors of this element */
+        int64_t calcImpedanceNs = 0; /* time spent in calcImpedance() for this element */
+    };
+
+    /**
+     * Records impedance propagation events into a lock-free single-producer,
+     * single-consumer ring buffer, so that latency spikes while automating
+     * circuit parameters can be inspected offline.
+     *
+     * The tracer only records events when it is the active tracer and
+     * CHOWDSP_WDF_TRACING is enabled. Parameter changes should come from
+     * one thread at a time (typically the audio thread), while the events
+     * can be read from any other thread.
+     * ```cpp
+     * wdft::ImpedanceTracer tracer { 8192 };
+     * tracer.setElementName (circuit.pot1, "pot1");
+     * wdft::ImpedanceTracer::setActiveTracer (&tracer);
+     *
+     * // ... process and automate the circuit ...
+     *
+     * std::ofstream traceFile { "wdf_trace.json" };
+     * tracer.writeChromeTrace (traceFile); // open in chrome://tracing or https://ui.perfetto.dev
+     * ```
+     */
+    class ImpedanceTracer
+    {
+    public:
+        /** Creates a tracer which can hold at least the given number of (unread) events. */
+        explicit ImpedanceTracer (size_t minCapacity = 4096)
+        {
+            size_t capacity = 2;
+            while (capacity < minCapacity)
+                capacity *= 2;
+            events.resize (capacity);
+        }
+
+        ~ImpedanceTracer()
+        {
+            auto* self = this;
+            activeTracer().compare_exchange_strong (self, nullptr);
+        }
+
+        ImpedanceTracer (const ImpedanceTracer&) = delete;
+        ImpedanceTracer& operator= (const ImpedanceTracer&) = delete;
+
+        /** Sets the tracer that will record impedance propagation events (or nullptr to stop tracing). */
+        static void setActiveTracer (ImpedanceTracer* tracer) noexcept
+        {
+            activeTracer().store (tracer, std::memory_order_release);
+        }
+
+        /** Returns the active tracer, or nullptr if tracing is not active. */
+        static ImpedanceTracer* getActiveTracer() noexcept
+        {
+            return activeTracer().load (std::memory_order_acquire);
+        }
+
+        /** Sets a name to use for an element in the exported trace (not real-time safe). */
+        void setElementName (const BaseWDF& element, std::string name)
+        {
+            elementNames[&element] = std::move (name);
+        }
+
+        /** Adds an event to the buffer. If the buffer is full, the event is dropped and false is returned. */
+        bool push (const ImpedanceTraceEvent& event) noexcept
+        {
+            const auto writeIndex = writePosition.load (std::memory_order_relaxed);
+            if (writeIndex - readPosition.load (std::memory_order_acquire) >= events.size())
+            {
+                numDroppedEvents.fetch_add (1, std::memory_order_relaxed);
+                return false;
+            }
+
+            events[writeIndex & (events.size() - 1)] = event;
+            writePosition.store (writeIndex + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Reads the oldest event from the buffer. Returns false if there are no events to read. */
+        bool pop (ImpedanceTraceEvent& event) noexcept
+        {
+            const auto readIndex = readPosition.load (std::memory_order_relaxed);
+            if (readIndex == writePosition.load (std::memory_order_acquire))
+                return false;
+
+            event = events[readIndex & (events.size() - 1)];
+            readPosition.store (readIndex + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Returns the number of events that were dropped because the buffer was full. */
+        uint64_t getNumDroppedEvents() const noexcept { return numDroppedEvents.load (std::memory_order_relaxed); }
+
+        /**
+         * Reads all the events from the buffer, and writes them out in the Chrome
+         * trace-event JSON format. Propagations are written as "complete" events,
+         * so the propagation through the ancestors of an element appears nested
+         * inside the element's event, and deferred propagations are written as
+         * instant events.
+         */
+        void writeChromeTrace (std::ostream& os)
+        {
+            os << "{\"traceEvents\":[";
+
+            ImpedanceTraceEvent event;
+            bool isFirstEvent = true;
+            while (pop (event))
+            {
+                if (! isFirstEvent)
+                    os << ",";
+                isFirstEvent = false;
+
+                os << "\n{\"name\":\"" << getEventName (event) << "\",\"cat\":\"wdf\""
+                   << ",\"ph\":\"" << (event.type == ImpedanceTraceEvent::Type::Deferred ? "i\",\"s\":\"t" : "X")
+                   << "\",\"pid\":1,\"tid\":1,\"ts\":" << formatMicroseconds (event.startNs);
+
+                if (event.type != ImpedanceTraceEvent::Type::Deferred)
+                    os << ",\"dur\":" << formatMicroseconds (event.durationNs);
+
+                os << ",\"args\":{\"element\":\"" << escapeJson (getElementName (event.element))
+                   << "\",\"source\":\"" << escapeJson (getElementName (event.source))
+                   << "\",\"depth\":" << event.depth
+                   << ",\"propagation\":" << event.propagationId
+                   << ",\"calcImpedance_us\":" << formatMicroseconds (event.calcImpedanceNs)
+                   << "}}";
+            }
+
+            os << "\n],\"otherData\":{\"droppedEvents\":" << getNumDroppedEvents() << "}}\n";
+        }
+
+    private:
+        static std::atomic<ImpedanceTracer*>& activeTracer() noexcept
+        {
+            static std::atomic<ImpedanceTracer*> tracer { nullptr };
+            return tracer;
+        }
+
+        static const char* getEventName (const ImpedanceTraceEvent& event) noexcept
+        {
+            switch (event.type)
+            {
+                case ImpedanceTraceEvent::Type::Deferred:
+                    return "deferred";
+                case ImpedanceTraceEvent::Type::DeferredCalc:
+                    return "deferred calcImpedance";
+                case ImpedanceTraceEvent::Type::Propagation:
+                default:
+                    return "propagateImpedanceChange";
+            }
+        }
+
+        std::string getElementName (const BaseWDF* element) const
+        {
+            const auto nameIter = elementNames.find (element);
+            if (nameIter != elementNames.end())
+                return nameIter->second;
+
+            char pointerName[32];
+            std::snprintf (pointerName, sizeof (pointerName), "%p", (const void*) element);
+            return pointerName;
+        }
+
+        /** Escapes the characters that can't appear as-is in a JSON string */
+        static std::string escapeJson (const std::string& str)
+        {
+            std::string escaped;
+            escaped.reserve (str.size());
+            for (auto c : str)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    escaped += '\\';
+                    escaped += c;
+                }
+                else if ((unsigned char) c < 0x20)
+                {
+                    char code[8];
+                    std::snprintf (code, sizeof (code), "\\u%04x", (unsigned) c);
+                    escaped += code;
+                }
+                else
+                {
+                    escaped += c;
+                }
+            }
+            return escaped;
+        }
+
+        static std::string formatMicroseconds (int64_t ns)
+        {
+            char value[32];
+            std::snprintf (value, sizeof (value), "%.3f", (double) ns * 1.0e-3);
+            return value;
+        }
+
+        std::vector<ImpedanceTraceEvent> events;
+        std::atomic<uint64_t> writePosition { 0 };
+        std::atomic<uint64_t> readPosition { 0 };
+        std::atomic<uint64_t> numDroppedEvents { 0 };
+
+        std::unordered_map<const BaseWDF*, std::string> elementNames;
+    };
+
+#ifndef DOXYGEN
+    namespace trace_detail
+    {
+        inline int64_t nowNs() noexcept
+        {
+            return (int64_t) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /** Keeps track of the propagation that is currently running on this thread */
+        struct PropagationContext
+        {
+            uint32_t depth = 0;
+            uint64_t nextPropagationId = 0;
+            const BaseWDF* source = nullptr;
+        };
+
+        inline PropagationContext& getPropagationContext() noexcept
+        {
+            static thread_local PropagationContext context;
+            return context;
+        }
+
+        /** Records a propagation event covering the lifetime of this object */
+        class PropagationScope
+        {
+        public:
+            explicit PropagationScope (const BaseWDF& element, ImpedanceTraceEvent::Type type = ImpedanceTraceEvent::Type::Propagation) noexcept
+                : tracer (ImpedanceTracer::getActiveTracer())
+            {
+                if (tracer == nullptr)
+                    return;
+
+                auto& context = getPropagationContext();
+                if (context.depth == 0)
+                {
+                    context.nextPropagationId++;
+                    context.source = &element;
+                }
+
+                event.type = type;
+                event.depth = context.depth++;
+                event.propagationId = context.nextPropagationId;
+                event.element = &element;
+                event.source = context.source;
+                event.startNs = nowNs();
+            }
+
+            ~PropagationScope() noexcept
+            {
+                if (tracer == nullptr)
+                    return;
+
+                event.durationNs = nowNs() - event.startNs;
+                getPropagationContext().depth--;
+                tracer->push (event);
+            }
+
+            /** Call this once the element has finished computing its impedance */
+            void calcImpedanceDone() noexcept
+            {
+                if (tracer != nullptr)
+                    event.calcImpedanceNs = nowNs() - event.startNs;
+            }
+
+        private:
+            ImpedanceTracer* tracer;
+            ImpedanceTraceEvent event;
+        };
+
+        /** Records that an impedance propagation was stopped at this element */
+        inline void recordDeferredPropagation (const BaseWDF& element) noexcept
+        {
+            auto* tracer = ImpedanceTracer::getActiveTracer();
+            if (tracer == nullptr)
+                return;
+
+            auto& context = getPropagationContext();
+            ImpedanceTraceEvent event;
+            event.type = ImpedanceTraceEvent::Type::Deferred;
+            event.depth = context.depth;
+            event.propagationId = context.depth == 0 ? ++context.nextPropagationId : context.nextPropagationId;
+            event.element = &element;
+            event.source = context.depth == 0 ? &element : context.source;
+            event.startNs = nowNs();
+            tracer->push (event);
+        }
+    } // namespace trace_detail
+#endif // DOXYGEN
+} // namespace wdft
+} // namespace chowdsp
+
+#if CHOWDSP_WDF_TRACING
+/** Traces an impedance propagation through the current WDF element, until the end of the current scope */
+#define CHOWDSP_WDF_TRACE_PROPAGATION() \
+    ::chowdsp::wdft::trace_detail::PropagationScope chowdsp_wdf_trace_scope { *this }
+
+/** Marks the end of the calcImpedance() call in the current traced propagation */
+#define CHOWDSP_WDF_TRACE_CALC_DONE() chowdsp_wdf_trace_scope.calcImpedanceDone()
+
+/** Records that the impedance propagation was deferred at the current WDF element */
+#define CHOWDSP_WDF_TRACE_DEFERRED() ::chowdsp::wdft::trace_detail::recordDeferredPropagation (*this)
+
+/** Traces the deferred impedance calculation of the given WDF element, until the end of the current scope */
+#define CHOWDSP_WDF_TRACE_DEFERRED_CALC(element) \
+    ::chowdsp::wdft::trace_detail::PropagationScope chowdsp_wdf_trace_scope { element, ::chowdsp::wdft::ImpedanceTraceEvent::Type::DeferredCalc }
+#endif
+
+#endif //CHOWDSP_WDF_IMPEDANCE_TRACE_H
+
+#else
+#define CHOWDSP_WDF_TRACE_PROPAGATION()
+#define CHOWDSP_WDF_TRACE_CALC_DONE()
+#define CHOWDSP_WDF_TRACE_DEFERRED()
+#define CHOWDSP_WDF_TRACE_DEFERRED_CALC(element)
+#endif
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** Base WDF class for propagating impedance changes between elements */
+    class BaseWDF
+    {
+    public:
+        virtual ~BaseWDF() = default;
+
+        void connectToParent (BaseWDF* p) { parent = p; }
+
+        virtual void calcImpedance() = 0;
+
+        inline virtual void propagateImpedanceChange()
+        {
+            if (dontPropagateImpedance)
+            {
+                CHOWDSP_WDF_TRACE_DEFERRED();
+                return; // the impedance propagation is being deferred until later...
+            }
+
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
+            calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
+
+            if (parent != nullptr)
+                parent->propagateImpedanceChange();
+        }
+
+        /**
+         * Calls fn for each port connected "below" this element in the WDF tree.
+         * Elements with connected ports (adaptors and root elements) hide this method.
+         */
+        template <typename Fn>
+        void visitPorts (Fn&&)
+        {
+        }
+
+        /**
+         * Calls visitor with a reference to each of this element's internal
+         * state variables (not including the wdf.a and wdf.b members).
+         * Elements with internal state hide this method.
+         */
+        template <typename Visitor>
+        void visitState (Visitor&&)
+        {
+        }
+
+#if CHOWDSP_WDF_INSTRUMENTATION
+        /** Instrumentation counts for this element (see getInstrumentationCounters()). */
+        InstrumentationCounters instrumentationCounters;
+#endif
+
+    protected:
+        BaseWDF* parent = nullptr;
+
+    private:
+        bool dontPropagateImpedance = false;
+
+        template <typename... Elements>
+        friend class ScopedDeferImpedancePropagation;
+    };
+
+    /** Base class for propagating impedance changes into root WDF elements */
+    class RootWDF : public BaseWDF
+    {
+    public:
+        inline void propagateImpedanceChange() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
+            calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
+        }
+
+    private:
+        // don't try to connect root nodes!
+        void connectToParent (BaseWDF*) {}
+    };
+
+    /** Helper struct for common WDF member variables */
+    template <typename T>
+    struct WDFMembers
+    {
+        T R = (NumericType<T>) 1.0e-9; /* impedance */
+        T G = (T) 1.0 / R; /* admittance */
+        T a = (T) 0.0; /* incident wave */
+        T b = (T) 0.0; /* reflected wave */
+    };
+
+#ifndef DOXYGEN
+    namespace fixed_detail
+    {
+        template <typename...>
+        using void_t = void;
+
+        /** True if the element's impedance is known at compile-time (see FixedResistorT). */
+        template <typename ElementType, typename = void>
+        struct HasFixedImpedance : std::false_type
+        {
+        };
+
+        template <typename ElementType>
+        struct HasFixedImpedance<ElementType, void_t<decltype (ElementType::getFixedImpedance())>> : std::true_type
+        {
+        };
+
+        /**
+         * Holds an adaptor coefficient, which is replaced by a compile-time constant
+         * when FixedValue::value() can be computed from fixed port impedances.
+         */
+        template <typename T, typename FixedValue, bool isFixed = FixedValue::isFixed>
+        struct Coefficient
+        {
+            void set (T newValue) noexcept { value = newValue; }
+            T get() const noexcept { return value; }
+
+            T value = (T) 1.0;
+        };
+
+        template <typename T, typename FixedValue>
+        struct Coefficient<T, FixedValue, true>
+        {
+            void set (T) noexcept {}
+            static T get() noexcept { return (T) FixedValue::value(); }
+        };
+    } // namespace fixed_detail
+#endif // DOXYGEN
+
+    /**
+     * Calls fn for the given element, and for every element below it in the WDF tree.
+     * Usually this will be called on the root of the tree, to visit the whole circuit.
+     */
+    template <typename ElementType, typename Fn>
+    void forEachElement (ElementType& element, Fn&& fn)
+    {
+        fn (element);
+        element.visitPorts ([&fn] (auto& port) { forEachElement (port, fn); });
+    }
+
+    /**
+     * Returns the instrumentation counts for this element.
+     * If CHOWDSP_WDF_INSTRUMENTATION is disabled, the counts will always be zero.
+     */
+    inline InstrumentationCounters getInstrumentationCounters (const BaseWDF& element) noexcept
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION
+        return element.instrumentationCounters;
+#else
+        (void) element;
+        return {};
+#endif
+    }
+
+    /** Returns the sum of the instrumentation counts for every element in the circuit. */
+    template <typename RootType>
+    InstrumentationCounters getTotalInstrumentationCounters (RootType& root) noexcept
+    {
+        InstrumentationCounters total {};
+        forEachElement (root, [&total] (auto& element) { total += getInstrumentationCounters (element); });
+        return total;
+    }
+
+    /** Resets the instrumentation counts for every element in the circuit. */
+    template <typename RootType>
+    void resetInstrumentationCounters (RootType& root) noexcept
+    {
+#if CHOWDSP_WDF_INSTRUMENTATION
+        forEachElement (root, [] (auto& element) { element.instrumentationCounters = {}; });
+#else
+        (void) root;
+#endif
+    }
+
+    /** Probe the voltage across this circuit element. */
+    template <typename T, typename WDFType>
+    inline T voltage (const WDFType& wdf) noexcept
+    {
+        return (wdf.wdf.a + wdf.wdf.b) * (T) 0.5;
+    }
+
+    /**Probe the current through this circuit element. */
+    template <typename T, typename WDFType>
+    inline T current (const WDFType& wdf) noexcept
+    {
+        return (wdf.wdf.a - wdf.wdf.b) * ((T) 0.5 * wdf.wdf.G);
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif // CHOWDSP_WDF_WDFT_BASE_H
+
+// #include "../math/compensated_float.h"
+#ifndef CHOWDSP_WDF_COMPENSATED_FLOAT_H
+#define CHOWDSP_WDF_COMPENSATED_FLOAT_H
+
+namespace chowdsp
+{
+/**
+ * A floating-point accumulator which tracks the rounding error of its running sum
+ * in a second "low" word (i.e. Kahan/TwoSum compensated summation). This gives
+ * close to double-word precision for state variables that integrate many small
+ * increments, while only using operations that are available for SIMD types.
+ *
+ * This type is intended to be used as the StateType for the WDF elements that
+ * support a mixed-precision state (e.g. `wdft::ResistorCapacitorSeriesT<float, CompensatedFloat<float>>`).
+ *
+ * Note that compensated arithmetic relies on strict IEEE semantics, so it will not work
+ * correctly if the code is compiled with `-ffast-math` or similar re-association flags.
+ */
+template <typename T>
+struct CompensatedFloat
+{
+    CompensatedFloat() = default;
+    explicit CompensatedFloat (T value) : hi (value) {}
+
+    /** Returns the value of the accumulator, rounded to the underlying type. */
+    explicit operator T() const noexcept { return hi + lo; }
+
+    CompensatedFloat& operator+= (T x) noexcept
+    {
+        T err;
+        const auto sum = twoSum (hi, x, err);
+        normalise (sum, lo + err);
+        return *this;
+    }
+
+    CompensatedFloat& operator-= (T x) noexcept
+    {
+        return *this += -x;
+    }
+
+    CompensatedFloat& operator+= (const CompensatedFloat& other) noexcept
+    {
+        T err;
+        const auto sum = twoSum (hi, other.hi, err);
+        normalise (sum, err + (lo + other.lo));
+        return *this;
+    }
+
+    CompensatedFloat& operator-= (const CompensatedFloat& other) noexcept
+    {
+        return *this += -other;
+    }
+
+    CompensatedFloat operator-() const noexcept
+    {
+        CompensatedFloat result;
+        result.hi = -hi;
+        result.lo = -lo;
+        return result;
+    }
+
+    /** Scales the accumulator by a (non-compensated) coefficient. */
+    friend inline CompensatedFloat operator* (T k, const CompensatedFloat& x) noexcept
+    {
+        CompensatedFloat result;
+        result.normalise (k * x.hi, k * x.lo);
+        return result;
+    }
+
+    friend inline CompensatedFloat operator+ (CompensatedFloat x, T y) noexcept { return x += y; }
+    friend inline CompensatedFloat operator+ (T x, CompensatedFloat y) noexcept { return y += x; }
+    friend inline CompensatedFloat operator- (CompensatedFloat x, T y) noexcept { return x -= y; }
+
+    T hi {}; /* high word (the rounded running value) */
+    T lo {}; /* low word (the accumulated rounding error) */
+
+private:
+    /** Error-free sum: returns fl(a + b) and stores the rounding error in err. */
+    static inline T twoSum (T a, T b, T& err) noexcept
+    {
+        const auto s = a + b;
+        const auto bb = s - a;
+        err = (a - (s - bb)) + (b - bb);
+        return s;
+    }
+
+    inline void normalise (T sum, T err) noexcept
+    {
+        hi = sum + err;
+        lo = err - (hi - sum);
+    }
+};
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_COMPENSATED_FLOAT_H
+
+// #include "../math/denormals.h"
+#ifndef CHOWDSP_WDF_DENORMALS_H
+#define CHOWDSP_WDF_DENORMALS_H
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+// #include "compensated_float.h"
+
+
+/**
+ * If CHOWDSP_WDF_FLUSH_DENORMALS is enabled, the reactive WDF elements will
+ * flush their internal states to zero whenever those states become denormal.
+ * This costs a compare and select per state write, but protects against
+ * denormal CPU spikes even when the caller has not set the FTZ/DAZ flags.
+ *
+ * Note that this option must be defined consistently across all translation units!
+ */
+#ifndef CHOWDSP_WDF_FLUSH_DENORMALS
+#define CHOWDSP_WDF_FLUSH_DENORMALS 0
+#endif
+
+namespace chowdsp
+{
+/** Methods for dealing with denormal numbers */
+namespace denormals
+{
+    /** Returns zero if the input is denormal, otherwise returns the input. */
+    template <typename T>
+    inline typename std::enable_if<std::is_floating_point<T>::value, T>::type
+        flush (T x) noexcept
+    {
+        return std::abs (x) < std::numeric_limits<T>::min() ? (T) 0 : x;
+    }
+
+#if defined(XSIMD_HPP)
+    /** Returns zero for any denormal elements of the input. */
+    template <typename T>
+    inline xsimd::batch<T> flush (xsimd::batch<T> x) noexcept
+    {
+        using v_type = xsimd::batch<T>;
+        return xsimd::select (xsimd::abs (x) < v_type (std::numeric_limits<T>::min()), v_type ((T) 0), x);
+    }
+#endif
+
+    /** Flushes both words of a compensated accumulator. */
+    template <typename T>
+    inline CompensatedFloat<T> flush (CompensatedFloat<T> x) noexcept
+    {
+        x.hi = flush (x.hi);
+        x.lo = flush (x.lo);
+        return x;
+    }
+
+    /**
+     * Used by the WDF elements when writing their internal state.
+     * Flushes denormals if CHOWDSP_WDF_FLUSH_DENORMALS is enabled, otherwise does nothing.
+     */
+    template <typename T>
+    inline T flushState (T x) noexcept
+    {
+#if CHOWDSP_WDF_FLUSH_DENORMALS
+        return flush (x);
+#else
+        return x;
+#endif
+    }
+} // namespace denormals
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_DENORMALS_H
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** WDF Resistor Node */
+    template <typename T>
+    class ResistorT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor with a given resistance.
+         * @param value: resistance in Ohms
+         */
+        explicit ResistorT (T value) : R_value (value)
+        {
+            calcImpedance();
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
+        /** Computes the impedance of the WDF resistor, Z_R = R. */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Accepts an incident wave into a WDF resistor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF resistor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = 0.0;
+            return wdf.b;
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e-9;
+    };
+
+    /**
+     * WDF Resistor Node, with a resistance that is fixed at compile-time.
+     *
+     * The resistance is given in Ohms as a std::ratio, e.g. FixedResistorT<float, std::ratio<4700>>
+     * or FixedResistorT<float, std::ratio<22, 10>> for 2.2 Ohms. When both ports of a WDFSeriesT or
+     * WDFParallelT adaptor have fixed impedances, the adaptor's reflection coefficient becomes a
+     * compile-time constant, and the adaptor's impedance is fixed as well, so whole sub-trees of
+     * fixed resistors fold into constants.
+     */
+    template <typename T, typename ResistanceRatio>
+    class FixedResistorT final : public BaseWDF
+    {
+    public:
+        FixedResistorT()
+        {
+            calcImpedance();
+        }
+
+        /** Returns the resistance value, in Ohms, at compile-time. */
+        static constexpr double getFixedImpedance() noexcept
+        {
+            return (double) ResistanceRatio::num / (double) ResistanceRatio::den;
+        }
+
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return (T) getFixedImpedance(); }
+
+        /** Computes the impedance of the WDF resistor, Z_R = R. */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) getFixedImpedance();
+            wdf.G = (T) (1.0 / getFixedImpedance());
+        }
+
+        /** Accepts an incident wave into a WDF resistor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF resistor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = 0.0;
+            return wdf.b;
+        }
+
+        WDFMembers<T> wdf;
+    };
+
+    /** WDF Capacitor Node */
+    template <typename T>
+    class CapacitorT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Capacitor.
+         * @param value: Capacitance value in Farads
+         * @param _fs: WDF sample rate
+         */
+        explicit CapacitorT (T value, T _fs = (T) 48000.0) : C_value (value),
+                                                             fs (_fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            fs = sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return fs; }
+
+        /** Computes the impedance of the WDF capacitor,
+         *             1
+         * Z_C = --------------
+         *        2 * f_s * C
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Accepts an incident wave into a WDF capacitor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.a);
+        }
+
+        /** Propogates a reflected wave from a WDF capacitor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = z;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T C_value = (T) 1.0e-6;
+        T z = (T) 0.0;
+
+        T fs;
+    };
+
+    /** WDF Capacitor Node with alpha transform parameter */
+    template <typename T>
+    class CapacitorAlphaT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Capacitor.
+         * @param value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         * @param alpha: alpha value to be used for the alpha transform,
+         *             use 0 for Backwards Euler, use 1 for Bilinear Transform.
+         */
+        explicit CapacitorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : C_value (value),
+                                                                                    fs (fs),
+                                                                                    alpha (alpha),
+                                                                                    b_coef (((T) 1.0 - alpha) / (T) 2.0),
+                                                                                    a_coef (((T) 1.0 + alpha) / (T) 2.0)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            fs = sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+        }
+
+        /** Sets a new alpha value to use for the alpha transform */
+        void setAlpha (T newAlpha)
+        {
+            alpha = newAlpha;
+            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
+            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
+
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF capacitor,
+         *                 1
+         * Z_C = ---------------------
+         *       (1 + alpha) * f_s * C
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) 1.0 / (((T) 1.0 + alpha) * C_value * fs);
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Accepts an incident wave into a WDF capacitor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.a);
+        }
+
+        /** Propogates a reflected wave from a WDF capacitor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = denormals::flushState (b_coef * wdf.b + a_coef * z);
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T C_value = (T) 1.0e-6;
+        T z = (T) 0.0;
+
+        T fs;
+
+        T alpha;
+        T b_coef;
+        T a_coef;
+    };
+
+    /** WDF Inductor Node */
+    template <typename T>
+    class InductorT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Inductor.
+         * @param value: Inductance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit InductorT (T value, T fs = (T) 48000.0) : L_value (value),
+                                                           fs (fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            fs = sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            z = (T) 0.0;
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Returns the inductance value, in Henries. */
+        T getInductanceValue() const noexcept { return L_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return fs; }
+
+        /** Computes the impedance of the WDF inductor,
+         * Z_L = 2 * f_s * L
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) 2.0 * L_value * fs;
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Accepts an incident wave into a WDF inductor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.a);
+        }
+
+        /** Propogates a reflected wave from a WDF inductor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -z;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T L_value = (T) 1.0e-6;
+        T z = (T) 0.0;
+
+        T fs;
+    };
+
+    /** WDF Inductor Node with alpha transform parameter */
+    template <typename T>
+    class InductorAlphaT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Inductor.
+         * @param value: Inductance value in Farads
+         * @param fs: WDF sample rate
+         * @param alpha: alpha value to be used for the alpha transform,
+         *               use 0 for Backwards Euler, use 1 for Bilinear Transform.
+         */
+        explicit InductorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : L_value (value),
+                                                                                   fs (fs),
+                                                                                   alpha (alpha),
+                                                                                   b_coef (((T) 1.0 - alpha) / (T) 2.0),
+                                                                                   a_coef (((T) 1.0 + alpha) / (T) 2.0)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            fs = sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            z = (T) 0.0;
+        }
+
+        /** Sets a new alpha value to use for the alpha transform */
+        void setAlpha (T newAlpha)
+        {
+            alpha = newAlpha;
+            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
+            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
+
+            propagateImpedanceChange();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF inductor,
+         * Z_L = (1 + alpha) * f_s * L
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = ((T) 1.0 + alpha) * L_value * fs;
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Accepts an incident wave into a WDF inductor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.a);
+        }
+
+        /** Propogates a reflected wave from a WDF inductor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = denormals::flushState (b_coef * wdf.b - a_coef * z);
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T L_value = (T) 1.0e-6;
+        T z = (T) 0.0;
+
+        T fs;
+
+        T alpha;
+        T b_coef;
+        T a_coef;
+    };
+
+    /**
+     * WDF Resistor and Capacitor in Series
+     *
+     * For low cutoff frequencies, the capacitor state integrates very small increments,
+     * so the StateType argument may be used to store the state at a higher precision
+     * than the waves and coefficients, e.g. `ResistorCapacitorSeriesT<float, double>`,
+     * or `ResistorCapacitorSeriesT<xsimd::batch<float>, CompensatedFloat<xsimd::batch<float>>>`.
+     */
+    template <typename T, typename StateType = T>
+    class ResistorCapacitorSeriesT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Capacitor Series.
+         * @param cap_value: Resistance value in Ohms
+         * @param res_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorCapacitorSeriesT (T res_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = StateType {};
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF resistor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = tt / ((T) 2.0 * C_value) + R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+            T_over_T_plus_2RC = tt / ((T) 2 * C_value * R_value + tt);
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z -= T_over_T_plus_2RC * (wdf.a + z);
+            z = denormals::flushState (z);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -(T) z;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e3;
+        T C_value = (T) 1.0e-6;
+
+        T T_over_T_plus_2RC = (T) 0.0;
+
+        StateType z {};
+
+        T tt;
+    };
+
+    /** WDF Resistor and Capacitor in parallel */
+    template <typename T>
+    class ResistorCapacitorParallelT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Capacitor Parallel.
+         * @param res_value: Resistance value in Ohms
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorCapacitorParallelT (T res_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return (T) 1 / tt; }
+
+        /** Computes the impedance of the WDF resistor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoRC = (T) 2.0 * C_value * R_value;
+            wdf.R = R_value * tt / (twoRC + tt);
+            wdf.G = (T) 1.0 / wdf.R;
+            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.b + wdf.a - z);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = twoRC_over_twoRC_plus_T * z;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e3;
+        T C_value = (T) 1.0e-6;
+
+        T twoRC_over_twoRC_plus_T = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
+    };
+
+    /** WDF Resistor and Inductor in Series */
+    template <typename T>
+    class ResistorInductorSeriesT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor Series.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorInductorSeriesT (T res_value, T ind_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF resistor/inductor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoL = (T) 2.0 * L_value;
+            wdf.R = twoL / tt + R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+            twoL_over_twoL_plus_RT = twoL / (twoL + R_value * tt);
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (twoL_over_twoL_plus_RT * (z - wdf.a) - z);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = z;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
+
+        T twoL_over_twoL_plus_RT = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
+    };
+
+    /** WDF Resistor and Inductor in parallel */
+    template <typename T>
+    class ResistorInductorParallelT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor Parallel.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorInductorParallelT (T res_value, T ind_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF resistor/inductor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoL = (T) 2.0 * L_value;
+            const auto RT = R_value * tt;
+            wdf.R = twoL * R_value / (RT + twoL);
+            wdf.G = (T) 1.0 / wdf.R;
+            RT_over_RT_plus_twoL = RT / (RT + twoL);
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.b + wdf.a + z);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -RT_over_RT_plus_twoL * z;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
+
+        T RT_over_RT_plus_twoL = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
+    };
+
+    /** WDF Inductor and Capacitor in Series */
+    template <typename T>
+    class InductorCapacitorSeriesT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Inductor/Capacitor Series.
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit InductorCapacitorSeriesT (T ind_value, T cap_value, T fs = (T) 48000.0)
+            : L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Returns the inductance value, in Henries. */
+        T getInductanceValue() const noexcept { return L_value; }
+
+        /** Returns the capacitance value, in Farads. */
+        T getCapacitanceValue() const noexcept { return C_value; }
+
+        /** Returns the sample rate. */
+        T getSampleRate() const noexcept { return (T) 1 / tt; }
+
+        /** Computes the impedance of the WDF inductor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto R_C = tt / ((T) 2.0 * C_value);
+            wdf.R = R_C + (T) 2.0 * L_value / tt;
+            wdf.G = (T) 1.0 / wdf.R;
+            RC_over_Rp = R_C * wdf.G;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            zC = denormals::flushState (zC - RC_over_Rp * (wdf.a - wdf.b));
+            zL = denormals::flushState (-(wdf.a + zC));
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = zL - zC;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (zL);
+            visitor (zC);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T L_value = (T) 1.0e-3;
+        T C_value = (T) 1.0e-6;
+
+        T RC_over_Rp = (T) 0.0;
+
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
+
+        T tt;
+    };
+
+    /** WDF Inductor and Capacitor in parallel */
+    template <typename T>
+    class InductorCapacitorParallelT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Inductor/Capacitor Parallel.
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit InductorCapacitorParallelT (T ind_value, T cap_value, T fs = (T) 48000.0)
+            : L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF inductor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto G_C = (T) 2.0 * C_value / tt;
+            wdf.G = G_C + tt / ((T) 2.0 * L_value);
+            wdf.R = (T) 1.0 / wdf.G;
+            GC_over_Gp = G_C * wdf.R;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            const auto a_plus_b = wdf.a + wdf.b;
+            zL = denormals::flushState (a_plus_b + zL);
+            zC = denormals::flushState (a_plus_b - zC);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = GC_over_Gp * (zL + zC) - zL;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (zL);
+            visitor (zC);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T L_value = (T) 1.0e-3;
+        T C_value = (T) 1.0e-6;
+
+        T GC_over_Gp = (T) 0.0;
+
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
+
+        T tt;
+    };
+
+    /** WDF Resistor, Inductor, and Capacitor in Series */
+    template <typename T>
+    class ResistorInductorCapacitorSeriesT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Inductor/Capacitor Series.
+         * @param res_value: Resistance value in Ohms
+         * @param ind_value: Inductance value in Henries
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistorInductorCapacitorSeriesT (T res_value, T ind_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              L_value (ind_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the inductor and capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the inductor and capacitor states */
+        void reset()
+        {
+            zL = (T) 0.0;
+            zC = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the inductance value of the WDF inductor, in Henries. */
+        void setInductanceValue (T newL)
+        {
+            if (all (newL == L_value))
+                return;
+
+            L_value = newL;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF resistor/inductor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto R_L = (T) 2.0 * L_value / tt;
+            const auto R_C = tt / ((T) 2.0 * C_value);
+            wdf.R = R_value + R_L + R_C;
+            wdf.G = (T) 1.0 / wdf.R;
+            RL_over_Rp = R_L * wdf.G;
+            RC_over_Rp = R_C * wdf.G;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            const auto a_minus_b = wdf.a - wdf.b;
+            zL = denormals::flushState (-(zL + RL_over_Rp * a_minus_b));
+            zC = denormals::flushState (zC - RC_over_Rp * a_minus_b);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = zL - zC;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (zL);
+            visitor (zC);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T R_value = (T) 1.0e3;
+        T L_value = (T) 1.0e-3;
+        T C_value = (T) 1.0e-6;
+
+        T RL_over_Rp = (T) 0.0;
+        T RC_over_Rp = (T) 0.0;
+
+        T zL = (T) 0.0;
+        T zC = (T) 0.0;
+
+        T tt;
+    };
+
+    /**
+     * WDF Capacitor with an equivalent series resistance (ESR),
+     * and a leakage resistance in parallel with the capacitor.
+     *
+     * The default leakage resistance is large enough that the
+     * element behaves like a resistor and capacitor in series.
+     */
+    template <typename T>
+    class CapacitorESRT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Capacitor with ESR.
+         * @param cap_value: Capacitance value in Farads
+         * @param esr_value: Equivalent series resistance in Ohms
+         * @param fs: WDF sample rate
+         * @param leakage_value: Leakage resistance in Ohms
+         */
+        explicit CapacitorESRT (T cap_value, T esr_value, T fs = (T) 48000.0, T leakage_value = NumericType<T> (1.0e9))
+            : C_value (cap_value),
+              ESR_value (esr_value),
+              leakage_value (leakage_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the equivalent series resistance, in Ohms. */
+        void setESRValue (T newESR)
+        {
+            if (all (newESR == ESR_value))
+                return;
+
+            ESR_value = newESR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the leakage resistance, in Ohms. */
+        void setLeakageResistanceValue (T newR)
+        {
+            if (all (newR == leakage_value))
+                return;
+
+            leakage_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF capacitor/ESR/leakage combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoRC = (T) 2.0 * C_value * leakage_value;
+            const auto R_leaky_cap = leakage_value * tt / (twoRC + tt);
+            wdf.R = R_leaky_cap + ESR_value;
+            wdf.G = (T) 1.0 / wdf.R;
+            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
+            Rcap_over_Rp = R_leaky_cap * wdf.G;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (-((T) 2 * wdf.b + z + Rcap_over_Rp * (wdf.a - wdf.b)));
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -twoRC_over_twoRC_plus_T * z;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T C_value = (T) 1.0e-6;
+        T ESR_value = (T) 1.0;
+        T leakage_value = (T) 1.0e9;
+
+        T twoRC_over_twoRC_plus_T = (T) 0.0;
+        T Rcap_over_Rp = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDFT_ONE_PORTS_H
+
+// #include "wdft_sources.h"
+#ifndef CHOWDSP_WDF_WDFT_SOURCES_H
+#define CHOWDSP_WDF_WDFT_SOURCES_H
+
+// #include "wdft_base.h"
+
+// #include "../math/compensated_float.h"
+
+// #include "../math/denormals.h"
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** WDF Ideal Voltage source (non-adaptable) */
+    template <typename T, typename Next>
+    class IdealVoltageSourceT final : public RootWDF
+    {
+    public:
+        explicit IdealVoltageSourceT (Next& n) : next (n)
+        {
+            n.connectToParent (this);
+            calcImpedance();
+        }
+
+        void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
+
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV) { Vs = newV; }
+
+        /** Accepts an incident wave into a WDF ideal voltage source. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF ideal voltage source. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -wdf.a + (T) 2.0 * Vs;
+            return wdf.b;
+        }
+
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        Next& next;
+
+        T Vs = (T) 0.0;
+    };
+
+    /** WDF Voltage source with series resistance */
+    template <typename T>
+    class ResistiveVoltageSourceT final : public BaseWDF
+    {
+    public:
+        /** Creates a new resistive voltage source.
+         * @param value: initial resistance value, in Ohms
+         */
+        explicit ResistiveVoltageSourceT (T value = NumericType<T> (1.0e-9)) : R_value (value)
+        {
+            calcImpedance();
+        }
+
+        /** Sets the resistance value of the series resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
+        /** Computes the impedance for a WDF resistive voltage souce
+         * Z_Vr = Z_R
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV) { Vs = newV; }
+
+        /** Returns the voltage of the voltage source, in Volts */
+        T getVoltage() const noexcept { return Vs; }
+
+        /** Accepts an incident wave into a WDF resistive voltage source. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF resistive voltage source. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = Vs;
+            return wdf.b;
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T Vs = (T) 0.0;
+        T R_value = (T) 1.0e-9;
+    };
+
+    /** WDF Voltage source with series capacitance */
+    template <typename T>
+    class CapacitiveVoltageSourceT final : public BaseWDF
+    {
+    public:
+        /** Creates a new resistive voltage source.
+         * @param value: initial resistance value, in Ohms
+         */
+        explicit CapacitiveVoltageSourceT (T value = NumericType<T> (1.0e-6), T fs = (T) 48000)
+            : C_value (value),
+              fs (fs)
+
+        {
+            calcImpedance();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            fs = sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        void reset()
+        {
+            z = (T) 0;
+            v_1 = (T) 0;
+        }
+
+        /** Sets the capacitance value of the series resistor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Computes the impedance of the WDF capacitor,
+         *             1
+         * Z_C = --------------
+         *        2 * f_s * C
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV)
+        {
+            v_0 = newV;
+        }
+
+        /** Accepts an incident wave into a WDF resistive voltage source. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.a);
+        }
+
+        /** Propogates a reflected wave from a WDF resistive voltage source. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = z + v_0 - v_1;
+            v_1 = v_0;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+            visitor (v_1);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T C_value = (T) 1.0e-6;
+
+        T z {};
+        T v_0 {};
+        T v_1 {};
+
+        T fs;
+    };
+
+    /** WDF Current source (non-adaptable) */
+    template <typename T, typename Next>
+    class IdealCurrentSourceT final : public RootWDF
+    {
+    public:
+        explicit IdealCurrentSourceT (Next& n) : next (n)
+        {
+            n.connectToParent (this);
+            calcImpedance();
+        }
+
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            twoR = (T) 2.0 * next.wdf.R;
+            twoR_Is = twoR * Is;
+        }
+
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI)
+        {
+            Is = newI;
+            twoR_Is = twoR * Is;
+        }
+
+        /** Accepts an incident wave into a WDF ideal current source. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF ideal current source. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = twoR_Is + wdf.a;
+            return wdf.b;
+        }
+
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        Next& next;
+
+        T Is = (T) 0.0;
+        T twoR;
+        T twoR_Is;
+    };
+
+    /** WDF Current source with parallel resistance */
+    template <typename T>
+    class ResistiveCurrentSourceT final : public BaseWDF
+    {
+    public:
+        /** Creates a new resistive current source.
+         * @param value: initial resistance value, in Ohms
+         */
+        explicit ResistiveCurrentSourceT (T value = NumericType<T> (1.0e9)) : R_value (value)
+        {
+            calcImpedance();
+        }
+
+        /** Sets the resistance value of the parallel resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Returns the resistance value, in Ohms. */
+        T getResistanceValue() const noexcept { return R_value; }
+
+        /** Computes the impedance for a WDF resistive current souce
+         * Z_Ir = Z_R
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI) { Is = newI; }
+
+        /** Returns the current of the current source, in Amps */
+        T getCurrent() const noexcept { return Is; }
+
+        /** Accepts an incident wave into a WDF resistive current source. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF resistive current source. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = wdf.R * Is;
+            return wdf.b;
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T Is = (T) 0.0;
+        T R_value = (T) 1.0e9;
+    };
+
+    /**
+     * WDF Resistor and Capacitor and Voltage source in Series
+     *
+     * As with ResistorCapacitorSeriesT, the StateType argument may be used to store the
+     * capacitor state at a higher precision than the waves and coefficients.
+     */
+    template <typename T, typename StateType = T>
+    class ResistiveCapacitiveVoltageSourceT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Capacitor Series.
+         * @param cap_value: Resistance value in Ohms
+         * @param res_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistiveCapacitiveVoltageSourceT (T res_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+            reset();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = StateType {};
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the voltage of the voltage source, in Volts */
+        void setVoltage (T newV) { Vs = newV; }
+
+        /** Computes the impedance of the WDF resistor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = tt / ((T) 2.0 * C_value) + R_value;
+            wdf.G = (T) 1.0 / wdf.R;
+            T_over_T_plus_2RC = tt / ((T) 2 * C_value * R_value + tt);
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z -= T_over_T_plus_2RC * (wdf.a - wdf.b);
+            z = denormals::flushState (z);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -(T) (z + Vs);
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T Vs = (T) 0.0;
+        T R_value = (T) 1.0e3;
+        T C_value = (T) 1.0e-6;
+
+        T T_over_T_plus_2RC = (T) 0.0;
+
+        StateType z {};
+
+        T tt;
+    };
+
+    /** WDF Current source with a resistor and capacitor in parallel */
+    template <typename T>
+    class ResistiveCapacitiveCurrentSourceT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Resistor/Capacitor/Current Source Parallel.
+         * @param res_value: Resistance value in Ohms
+         * @param cap_value: Capacitance value in Farads
+         * @param fs: WDF sample rate
+         */
+        explicit ResistiveCapacitiveCurrentSourceT (T res_value, T cap_value, T fs = (T) 48000.0)
+            : R_value (res_value),
+              C_value (cap_value),
+              tt ((T) 1 / fs)
+        {
+            calcImpedance();
+            reset();
+        }
+
+        /** Prepares the capacitor to operate at a new sample rate */
+        void prepare (T sampleRate)
+        {
+            tt = (T) 1 / sampleRate;
+            propagateImpedanceChange();
+
+            reset();
+        }
+
+        /** Resets the capacitor state */
+        void reset()
+        {
+            z = (T) 0.0;
+            wdf.a = (T) 0;
+            wdf.b = (T) 0;
+        }
+
+        /** Sets the resistance value of the WDF resistor, in Ohms. */
+        void setResistanceValue (T newR)
+        {
+            if (all (newR == R_value))
+                return;
+
+            R_value = newR;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the capacitance value of the WDF capacitor, in Farads. */
+        void setCapacitanceValue (T newC)
+        {
+            if (all (newC == C_value))
+                return;
+
+            C_value = newC;
+            propagateImpedanceChange();
+        }
+
+        /** Sets the current of the current source, in Amps */
+        void setCurrent (T newI)
+        {
+            Is = newI;
+            Rp_Is = wdf.R * Is;
+        }
+
+        /** Computes the impedance of the WDF resistor/capacitor combination */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            const auto twoRC = (T) 2.0 * C_value * R_value;
+            wdf.R = R_value * tt / (twoRC + tt);
+            wdf.G = (T) 1.0 / wdf.R;
+            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
+            Rp_Is = wdf.R * Is;
+        }
+
+        /** Accepts an incident wave into the WDF. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            z = denormals::flushState (wdf.b + wdf.a - z);
+        }
+
+        /** Propogates a reflected wave from the WDF. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = twoRC_over_twoRC_plus_T * z + Rp_Is;
+            return wdf.b;
+        }
+
+        /** Calls visitor for each of the internal state variables. */
+        template <typename Visitor>
+        void visitState (Visitor&& visitor)
+        {
+            visitor (z);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        T Is = (T) 0.0;
+        T R_value = (T) 1.0e3;
+        T C_value = (T) 1.0e-6;
+
+        T twoRC_over_twoRC_plus_T = (T) 0.0;
+        T Rp_Is = (T) 0.0;
+
+        T z = (T) 0.0;
+
+        T tt;
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDFT_SOURCES_H
+
+// #include "wdft_adaptors.h"
+#ifndef CHOWDSP_WDF_WDFT_ADAPTORS_H
+#define CHOWDSP_WDF_WDFT_ADAPTORS_H
+
+// #include "wdft_base.h"
+
+// #include "../rtype/rtype_detail.h"
+#ifndef CHOWDSP_WDF_RTYPE_DETAIL_H
+#define CHOWDSP_WDF_RTYPE_DETAIL_H
+
+#include <array>
+#include <algorithm>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace chowdsp
+{
+#ifndef DOXYGEN
+namespace wdft
+{
+    /** Utility functions used internally by the R-Type adaptor */
+    namespace rtype_detail
+    {
+        /** Divides two numbers and rounds up if there is a remainder. */
+        template <typename T>
+        constexpr T ceil_div (T num, T den)
+        {
+            return (num + den - 1) / den;
+        }
+
+        template <typename T, size_t base_size>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, size_t>::type array_pad()
+        {
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = v_type::size;
+            constexpr auto num_simd_registers = ceil_div (base_size, simd_size);
+            return num_simd_registers * simd_size;
+#else
+            return base_size;
+#endif
+        }
+
+        template <typename T, size_t base_size>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, size_t>::type array_pad()
+        {
+            return base_size;
+        }
+
+        /** Functions to do a function for each element in the tuple */
+        template <typename Fn, typename Tuple, size_t... Ix>
+        constexpr void forEachInTuple (Fn&& fn, Tuple&& tuple, std::index_sequence<Ix...>) noexcept (noexcept (std::initializer_list<int> { (fn (std::get<Ix> (tuple), Ix), 0)... }))
+        {
+            (void) std::initializer_list<int> { ((void) fn (std::get<Ix> (tuple), Ix), 0)... };
+        }
+
+        template <typename T>
+        using TupleIndexSequence = std::make_index_sequence<std::tuple_size<std::remove_cv_t<std::remove_reference_t<T>>>::value>;
+
+        template <typename Fn, typename Tuple>
+        constexpr void forEachInTuple (Fn&& fn, Tuple&& tuple) noexcept (noexcept (forEachInTuple (std::forward<Fn> (fn), std::forward<Tuple> (tuple), TupleIndexSequence<Tuple> {})))
+        {
+            forEachInTuple (std::forward<Fn> (fn), std::forward<Tuple> (tuple), TupleIndexSequence<Tuple> {});
+        }
+
+        template <typename ElementType, int arraySize, int alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT>
+        struct AlignedArray
+        {
+            template <typename IntType>
+            ElementType& operator[] (IntType index) noexcept
+            {
+                return array[index];
+            }
+            template <typename IntType>
+            const ElementType& operator[] (IntType index) const noexcept
+            {
+                return array[index];
+            }
+
+            ElementType* data() noexcept { return array; }
+            const ElementType* data() const noexcept { return array; }
+
+            void clear() { std::fill (std::begin (array), std::end (array), ElementType {}); }
+            static constexpr int size() noexcept { return arraySize; }
+
+        private:
+            alignas (alignment) ElementType array[array_pad<ElementType, (size_t) arraySize>()] {};
+        };
+
+        template <typename T, int nRows, int nCols = nRows, int alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT>
+        using Matrix = AlignedArray<T, nRows, alignment>[(size_t) nCols];
+
+        /** Implementation for float/double. */
+        template <typename T, int numPorts>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_)
+        {
+            // input matrix (S) of size dim x dim
+            // input vector (a) of size 1 x dim
+            // output vector (b) of size 1 x dim
+
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = (int) v_type::size;
+            constexpr auto vec_size = ceil_div (numPorts, simd_size) * simd_size;
+
+            for (int c = 0; c < vec_size; c += simd_size)
+            {
+                auto b_vec = a_[0] * xsimd::load_aligned (S_[0].data() + c);
+                for (int r = 1; r < numPorts; ++r)
+                    b_vec = xsimd::fma (xsimd::broadcast (a_[r]), xsimd::load_aligned (S_[r].data() + c), b_vec);
+
+                xsimd::store_aligned (b_.data() + c, b_vec);
+            }
+#else // No SIMD
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+#endif // SIMD options
+        }
+
+#if defined(XSIMD_HPP)
+        /** Implementation for SIMD float/double. */
+        template <typename T, int numPorts>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, AlignedArray<T, numPorts>& b_)
+        {
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+        }
+#endif // XSIMD
+
+        /** Computes a single output of the scattering matrix: b[outIndex] = sum_r S_[r][outIndex] * a_[r]. */
+        template <typename T, int numPorts>
+        constexpr T RtypeScatterSingle (const Matrix<T, numPorts>& S_, const AlignedArray<T, numPorts>& a_, int outIndex)
+        {
+            T b = S_[0][outIndex] * a_[0];
+            for (int r = 1; r < numPorts; ++r)
+                b += S_[r][outIndex] * a_[r];
+            return b;
+        }
+    } // namespace rtype_detail
+} // namespace wdft
+
+namespace wdf
+{
+    /** Utility functions used internally by the R-Type adaptor */
+    namespace rtype_detail
+    {
+        using wdft::rtype_detail::ceil_div;
+
+        template <typename Signature>
+        class FunctionRef;
+
+        /**
+         * A non-owning, non-allocating reference to a callable, similar to std::function,
+         * but without the heap allocation or type-erased copies.
+         *
+         * Function pointers (and lambdas without captures) are stored by value, so they
+         * are always safe to use. Any other callable is stored by reference, so it must
+         * outlive the FunctionRef. To catch the most common mistake, temporary callables
+         * which can't be converted to a function pointer are not accepted.
+         */
+        template <typename R, typename... Args>
+        class FunctionRef<R (Args...)>
+        {
+        public:
+            using FunctionPointer = R (*) (Args...);
+
+            /** Wraps a function pointer. */
+            FunctionRef (FunctionPointer fn) noexcept : trampoline (&callFunction) { target.function = fn; }
+
+            /** Wraps a lambda without captures (or anything else convertible to a function pointer). */
+            template <typename Fn,
+                      typename = std::enable_if_t<std::is_convertible<Fn&&, FunctionPointer>::value
+                                                  && ! std::is_same<std::decay_t<Fn>, FunctionRef>::value>>
+            FunctionRef (Fn&& fn) noexcept : FunctionRef (static_cast<FunctionPointer> (fn))
+            {
+            }
+
+            /** Wraps a reference to a callable object, which must outlive the FunctionRef. */
+            template <typename Fn,
+                      typename = std::enable_if_t<! std::is_convertible<Fn&, FunctionPointer>::value
+                                                  && ! std::is_same<std::remove_const_t<Fn>, FunctionRef>::value>,
+                      typename = void>
+            FunctionRef (Fn& fn) noexcept : trampoline (&callObject<Fn>)
+            {
+                target.object = (void*) &fn;
+            }
+
+            R operator() (Args... args) const
+            {
+                return trampoline (target, std::forward<Args> (args)...);
+            }
+
+        private:
+            union Target
+            {
+                void* object;
+                FunctionPointer function;
+            };
+
+            static R callFunction (const Target& target, Args... args)
+            {
+                return target.function (std::forward<Args> (args)...);
+            }
+
+            template <typename Fn>
+            static R callObject (const Target& target, Args... args)
+            {
+                return (*(Fn*) target.object) (std::forward<Args> (args)...);
+            }
+
+            Target target;
+            R (*trampoline) (const Target&, Args...);
+        };
+
+        template <typename T>
+        typename std::enable_if<std::is_floating_point<T>::value, size_t>::type array_pad (size_t base_size)
+        {
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = v_type::size;
+            const auto num_simd_registers = ceil_div (base_size, simd_size);
+            return num_simd_registers * simd_size;
+#else
+            return base_size;
+#endif
+        }
+
+        template <typename T>
+        typename std::enable_if<! std::is_floating_point<T>::value, size_t>::type array_pad (size_t base_size)
+        {
+            return base_size;
+        }
+
+        template <typename ElementType>
+        struct AlignedArray
+        {
+            explicit AlignedArray (size_t size) : m_size ((int) size),
+                                                  vector (array_pad<ElementType> (size), ElementType {})
+            {
+            }
+
+            ElementType& operator[] (int index) noexcept { return vector[index]; }
+            const ElementType& operator[] (int index) const noexcept { return vector[index]; }
+
+            ElementType* data() noexcept { return vector.data(); }
+            const ElementType* data() const noexcept { return vector.data(); }
+
+            void clear() { std::fill (std::begin (vector), std::end (vector), ElementType {}); }
+            int size() const noexcept { return (int) m_size; }
+
+        private:
+            const int m_size;
+#if defined(XSIMD_HPP)
+            std::vector<ElementType, xsimd::default_allocator<ElementType>> vector;
+#else
+            std::vector<ElementType> vector;
+#endif
+        };
+
+        template <typename ElementType>
+        struct Matrix
+        {
+            Matrix (size_t nRows, size_t nCols) : vector (nCols, AlignedArray<ElementType> (nRows))
+            {
+            }
+
+            AlignedArray<ElementType>& operator[] (int index) noexcept { return vector[(size_t) index]; }
+            const AlignedArray<ElementType>& operator[] (int index) const noexcept { return vector[(size_t) index]; }
+
+        private:
+            std::vector<AlignedArray<ElementType>> vector;
+        };
+
+        /** Implementation for float/double. */
+        template <typename T>
+        constexpr typename std::enable_if<std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T>& S_, const AlignedArray<T>& a_, AlignedArray<T>& b_)
+        {
+            // input matrix (S) of size dim x dim
+            // input vector (a) of size 1 x dim
+            // output vector (b) of size 1 x dim
+
+#if defined(XSIMD_HPP)
+            using v_type = xsimd::simd_type<T>;
+            constexpr auto simd_size = (int) v_type::size;
+            const auto numPorts = a_.size();
+            const auto vec_size = ceil_div (numPorts, simd_size) * simd_size;
+
+            for (int c = 0; c < vec_size; c += simd_size)
+            {
+                auto b_vec = a_[0] * xsimd::load_aligned (S_[0].data() + c);
+                for (int r = 1; r < numPorts; ++r)
+                    b_vec = xsimd::fma (xsimd::broadcast (a_[r]), xsimd::load_aligned (S_[r].data() + c), b_vec);
+
+                xsimd::store_aligned (b_.data() + c, b_vec);
+            }
+#else // No SIMD
+            const auto numPorts = a_.size();
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+#endif // SIMD options
+        }
+
+#if defined(XSIMD_HPP)
+        /** Implementation for SIMD float/double. */
+        template <typename T>
+        constexpr typename std::enable_if<! std::is_floating_point<T>::value, void>::type
+            RtypeScatter (const Matrix<T>& S_, const AlignedArray<T>& a_, AlignedArray<T>& b_)
+        {
+            const auto numPorts = a_.size();
+            for (int c = 0; c < numPorts; ++c)
+            {
+                b_[c] = S_[0][c] * a_[0];
+                for (int r = 1; r < numPorts; ++r)
+                    b_[c] += S_[r][c] * a_[r];
+            }
+        }
+#endif // XSIMD
+
+        /** Computes a single output of the scattering matrix: b[outIndex] = sum_r S_[r][outIndex] * a_[r]. */
+        template <typename T>
+        T RtypeScatterSingle (const Matrix<T>& S_, const AlignedArray<T>& a_, int outIndex)
+        {
+            const auto numPorts = a_.size();
+            T b = S_[0][outIndex] * a_[0];
+            for (int r = 1; r < numPorts; ++r)
+                b += S_[r][outIndex] * a_[r];
+            return b;
+        }
+    } // namespace rtype_detail
+} // namespace wdf
+#endif // DOXYGEN
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_RTYPE_DETAIL_H
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** WDF 3-port parallel adaptor */
+    template <typename T, typename Port1Type, typename Port2Type>
+    class WDFParallelT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF parallel adaptor from two connected ports. */
+        WDFParallelT (Port1Type& p1, Port2Type& p2) : port1 (p1),
+                                                      port2 (p2)
+        {
+            port1.connectToParent (this);
+            port2.connectToParent (this);
+            calcImpedance();
+        }
+
+        /** Computes the impedance for a WDF parallel adaptor.
+         *  1     1     1
+         * --- = --- + ---
+         * Z_p   Z_1   Z_2
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.G = port1.wdf.G + port2.wdf.G;
+            wdf.R = (T) 1.0 / wdf.G;
+            port1Reflect.set (port1.wdf.G / wdf.G);
+        }
+
+        /** Returns the adaptor impedance at compile-time, if both ports have fixed impedances. */
+        template <bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value,
+                  std::enable_if_t<isFixed, int> = 0>
+        static constexpr double getFixedImpedance() noexcept
+        {
+            return (Port1Type::getFixedImpedance() * Port2Type::getFixedImpedance())
+                   / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance());
+        }
+
+        /** Accepts an incident wave into a WDF parallel adaptor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto b2 = wdf.b - port2.wdf.b + x;
+            port1.incident (b2 + bDiff);
+            port2.incident (b2);
+
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF parallel adaptor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            port1.reflected();
+            port2.reflected();
+
+            bDiff = port2.wdf.b - port1.wdf.b;
+            wdf.b = port2.wdf.b - port1Reflect.get() * bDiff;
+
+            return wdf.b;
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+            fn (port2);
+        }
+
+        Port1Type& port1;
+        Port2Type& port2;
+
+        WDFMembers<T> wdf;
+
+    private:
+        /** G_1 / (G_1 + G_2), for fixed port impedances */
+        struct FixedPort1Reflect
+        {
+            static constexpr bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value;
+            static constexpr double value() noexcept { return Port2Type::getFixedImpedance() / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance()); }
+        };
+
+        fixed_detail::Coefficient<T, FixedPort1Reflect> port1Reflect;
+        T bDiff = (T) 0.0;
+    };
+
+    /** WDF 3-port series adaptor */
+    template <typename T, typename Port1Type, typename Port2Type>
+    class WDFSeriesT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF series adaptor from two connected ports. */
+        WDFSeriesT (Port1Type& p1, Port2Type& p2) : port1 (p1),
+                                                    port2 (p2)
+        {
+            port1.connectToParent (this);
+            port2.connectToParent (this);
+            calcImpedance();
+        }
+
+        /** Computes the impedance for a WDF parallel adaptor.
+         * Z_s = Z_1 + Z_2
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = port1.wdf.R + port2.wdf.R;
+            wdf.G = (T) 1.0 / wdf.R;
+            port1Reflect.set (port1.wdf.R / wdf.R);
+        }
+
+        /** Returns the adaptor impedance at compile-time, if both ports have fixed impedances. */
+        template <bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value,
+                  std::enable_if_t<isFixed, int> = 0>
+        static constexpr double getFixedImpedance() noexcept
+        {
+            return Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance();
+        }
+
+        /** Accepts an incident wave into a WDF series adaptor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto b1 = port1.wdf.b - port1Reflect.get() * (x + port1.wdf.b + port2.wdf.b);
+            port1.incident (b1);
+            port2.incident (-(x + b1));
+
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF series adaptor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -(port1.reflected() + port2.reflected());
+            return wdf.b;
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+            fn (port2);
+        }
+
+        Port1Type& port1;
+        Port2Type& port2;
+
+        WDFMembers<T> wdf;
+
+    private:
+        /** R_1 / (R_1 + R_2), for fixed port impedances */
+        struct FixedPort1Reflect
+        {
+            static constexpr bool isFixed = fixed_detail::HasFixedImpedance<Port1Type>::value && fixed_detail::HasFixedImpedance<Port2Type>::value;
+            static constexpr double value() noexcept { return Port1Type::getFixedImpedance() / (Port1Type::getFixedImpedance() + Port2Type::getFixedImpedance()); }
+        };
+
+        fixed_detail::Coefficient<T, FixedPort1Reflect> port1Reflect;
+    };
+
+    /**
+     * WDF (N+1)-port parallel adaptor.
+     *
+     * Equivalent to a chain of nested WDFParallelT adaptors, but the reflection
+     * coefficients for all of the ports are computed with a single division, and
+     * the waves are scattered to all of the ports at once, rather than one level
+     * of the tree at a time.
+     */
+    template <typename T, typename... PortTypes>
+    class WDFParallelNT final : public BaseWDF
+    {
+    public:
+        /** Number of ports connected "below" this adaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+        static_assert (numPorts >= 2, "WDFParallelNT needs at least two ports!");
+
+        /** Creates a new WDF parallel adaptor from the connected ports. */
+        explicit WDFParallelNT (PortTypes&... ps) : ports (std::tie (ps...))
+        {
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t) { port.connectToParent (this); },
+                                          ports);
+            calcImpedance();
+        }
+
+        /** Computes the impedance for a WDF parallel adaptor.
+         *  1     1           1
+         * --- = --- + ... + ---
+         * Z_p   Z_1         Z_N
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { portG[i] = port.wdf.G; },
+                                          ports);
+
+            wdf.G = portG[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.G += portG[i];
+            wdf.R = (T) 1.0 / wdf.G;
+
+            for (int i = 0; i < numPorts; ++i)
+                portReflect[i] = portG[i] * wdf.R;
+        }
+
+        /** Accepts an incident wave into a WDF parallel adaptor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto bPlusX = wdf.b + x;
+            for (int i = 0; i < numPorts; ++i)
+                b_vec[i] = bPlusX - a_vec[i];
+
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { port.incident (b_vec[i]); },
+                                          ports);
+
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF parallel adaptor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { a_vec[i] = port.reflected(); },
+                                          ports);
+
+            wdf.b = portReflect[0] * a_vec[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.b += portReflect[i] * a_vec[i];
+
+            return wdf.b;
+        }
+
+        /** Returns the port connected at the given index. */
+        template <int Index>
+        auto& getPort() noexcept
+        {
+            return std::get<Index> (ports);
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          ports);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        std::tuple<PortTypes&...> ports;
+
+        rtype_detail::AlignedArray<T, numPorts> portG; // port admittances
+        rtype_detail::AlignedArray<T, numPorts> portReflect; // reflection coefficients
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // waves reflected from the ports
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // waves incident to the ports
+    };
+
+    /**
+     * WDF (N+1)-port series adaptor.
+     *
+     * Equivalent to a chain of nested WDFSeriesT adaptors, but the reflection
+     * coefficients for all of the ports are computed with a single division, and
+     * the waves are scattered to all of the ports at once, rather than one level
+     * of the tree at a time.
+     *
+     * Note that all of the ports are connected with the same orientation, whereas in
+     * a chain of WDFSeriesT adaptors, each nested adaptor flips the polarity of the
+     * ports below it.
+     */
+    template <typename T, typename... PortTypes>
+    class WDFSeriesNT final : public BaseWDF
+    {
+    public:
+        /** Number of ports connected "below" this adaptor */
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+        static_assert (numPorts >= 2, "WDFSeriesNT needs at least two ports!");
+
+        /** Creates a new WDF series adaptor from the connected ports. */
+        explicit WDFSeriesNT (PortTypes&... ps) : ports (std::tie (ps...))
+        {
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t) { port.connectToParent (this); },
+                                          ports);
+            calcImpedance();
+        }
+
+        /** Computes the impedance for a WDF series adaptor.
+         * Z_s = Z_1 + ... + Z_N
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { portR[i] = port.wdf.R; },
+                                          ports);
+
+            wdf.R = portR[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.R += portR[i];
+            wdf.G = (T) 1.0 / wdf.R;
+
+            for (int i = 0; i < numPorts; ++i)
+                portReflect[i] = portR[i] * wdf.G;
+        }
+
+        /** Accepts an incident wave into a WDF series adaptor. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            const auto waveSum = x - wdf.b; // x + a_1 + ... + a_N
+            for (int i = 0; i < numPorts; ++i)
+                b_vec[i] = a_vec[i] - portReflect[i] * waveSum;
+
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { port.incident (b_vec[i]); },
+                                          ports);
+
+            wdf.a = x;
+        }
+
+        /** Propogates a reflected wave from a WDF series adaptor. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            rtype_detail::forEachInTuple ([this] (auto& port, size_t i) { a_vec[i] = port.reflected(); },
+                                          ports);
+
+            wdf.b = a_vec[0];
+            for (int i = 1; i < numPorts; ++i)
+                wdf.b += a_vec[i];
+            wdf.b = -wdf.b;
+
+            return wdf.b;
+        }
+
+        /** Returns the port connected at the given index. */
+        template <int Index>
+        auto& getPort() noexcept
+        {
+            return std::get<Index> (ports);
+        }
+
+        /** Calls fn for each of the ports connected to this adaptor. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            rtype_detail::forEachInTuple ([&fn] (auto& port, size_t) { fn (port); },
+                                          ports);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        std::tuple<PortTypes&...> ports;
+
+        rtype_detail::AlignedArray<T, numPorts> portR; // port impedances
+        rtype_detail::AlignedArray<T, numPorts> portReflect; // reflection coefficients
+        rtype_detail::AlignedArray<T, numPorts> a_vec; // waves reflected from the ports
+        rtype_detail::AlignedArray<T, numPorts> b_vec; // waves incident to the ports
+    };
+
+    /** WDF Voltage Polarity Inverter */
+    template <typename T, typename PortType>
+    class PolarityInverterT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF polarity inverter */
+        explicit PolarityInverterT (PortType& p) : port1 (p)
+        {
+            port1.connectToParent (this);
+            calcImpedance();
+        }
+
+        /** Calculates the impedance of the WDF inverter
+         * (same impedance as the connected node).
+         */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            wdf.R = port1.wdf.R;
+            wdf.G = (T) 1.0 / wdf.R;
+        }
+
+        /** Accepts an incident wave into a WDF inverter. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            port1.incident (-x);
+        }
+
+        /** Propogates a reflected wave from a WDF inverter. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = -port1.reflected();
+            return wdf.b;
+        }
+
+        /** Calls fn for the port connected to this inverter. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        PortType& port1;
+    };
+
+    /** WDF y-parameter 2-port (short circuit admittance) */
+    template <typename T, typename PortType>
+    class YParameterT final : public BaseWDF
+    {
+    public:
+        /** Creates a new WDF Y-Parameter, with the given coefficients */
+        YParameterT (PortType& port1, T y11, T y12, T y21, T y22) : port1 (port1)
+        {
+            y[0][0] = y11;
+            y[0][1] = y12;
+            y[1][0] = y21;
+            y[1][1] = y22;
+
+            port1.connectToParent (this);
+            calcImpedance();
+        }
+
+        /** Calculates the impedance of the WDF Y-Parameter */
+        inline void calcImpedance() override
+        {
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            denominator = y[1][1] + port1.wdf.R * y[0][0] * y[1][1] - port1.wdf.R * y[0][1] * y[1][0];
+            wdf.R = (port1.wdf.R * y[0][0] + (T) 1.0) / denominator;
+            wdf.G = (T) 1.0 / wdf.R;
+
+            T rSq = port1.wdf.R * port1.wdf.R;
+            T num1A = -y[1][1] * rSq * y[0][0] * y[0][0];
+            T num2A = y[0][1] * y[1][0] * rSq * y[0][0];
+
+            A = (num1A + num2A + y[1][1]) / (denominator * (port1.wdf.R * y[0][0] + (T) 1.0));
+            B = -port1.wdf.R * y[0][1] / (port1.wdf.R * y[0][0] + (T) 1.0);
+            C = -y[1][0] / denominator;
+        }
+
+        /** Accepts an incident wave into a WDF Y-Parameter. */
+        inline void incident (T x) noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
+            port1.incident (A * port1.wdf.b + B * x);
+        }
+
+        /** Propogates a reflected wave from a WDF Y-Parameter. */
+        inline T reflected() noexcept
+        {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = C * port1.reflected();
+            return wdf.b;
+        }
+
+        /** Calls fn for the port connected to this Y-Parameter. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (port1);
+        }
+
+        WDFMembers<T> wdf;
+
+    private:
+        PortType& port1;
+        T y[2][2] = { { (T) 0.0, (T) 0.0 }, { (T) 0.0, (T) 0.0 } };
+
+        T denominator = (T) 1.0;
+        T A = (T) 1.0;
+        T B = (T) 1.0;
+        T C = (T) 1.0;
+    };
+
+    // useful "factory" functions so you don't have to declare all the template parameters
+
+    /** Factory method for creating a parallel adaptor between two elements. */
+    template <typename T, typename P1Type, typename P2Type>
+    CHOWDSP_WDF_MAYBE_UNUSED WDFParallelT<T, P1Type, P2Type> makeParallel (P1Type& p1, P2Type& p2)
+    {
+        return WDFParallelT<T, P1Type, P2Type> (p1, p2);
+    }
+
+    /** Factory method for creating a series adaptor between two elements. */
+    template <typename T, typename P1Type, typename P2Type>
+    CHOWDSP_WDF_MAYBE_UNUSED WDFSeriesT<T, P1Type, P2Type> makeSeries (P1Type& p1, P2Type& p2)
+    {
+        return WDFSeriesT<T, P1Type, P2Type> (p1, p2);
+    }
+
+    /** Factory method for creating a polarity inverter. */
+    template <typename T, typename PType>
+    CHOWDSP_WDF_MAYBE_UNUSED PolarityInverterT<T, PType> makeInverter (PType& p1)
+    {
+        return PolarityInverterT<T, PType> (p1);
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDFT_ADAPTORS_H
+
+// #include "wdft_fusion.h"
+#ifndef CHOWDSP_WDF_WDFT_FUSION_H
+#define CHOWDSP_WDF_WDFT_FUSION_H
+
+#include <type_traits>
+
+// #include "wdft_one_ports.h"
+
+// #include "wdft_sources.h"
+
+
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace fusion_detail
+    {
+        /**
+         * Maps a pair of one-ports connected in series to the fused element
+         * which implements them both. Pairs which can't be fused have no "type".
+         */
+        template <typename T, typename P1Type, typename P2Type>
+        struct FusedSeries
+        {
+        };
+
+        /** Same as FusedSeries, but for one-ports connected in parallel. */
+        template <typename T, typename P1Type, typename P2Type>
+        struct FusedParallel
+        {
+        };
+
+        /** Series and parallel connections are symmetric, so the ports may come in either order. */
+        template <typename Fusion>
+        struct SwapPorts
+        {
+            using type = typename Fusion::type;
+
+            template <typename P1Type, typename P2Type>
+            static type make (const P1Type& p1, const P2Type& p2)
+            {
+                return Fusion::make (p2, p1);
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, CapacitorT<T>>
+        {
+            using type = ResistorCapacitorSeriesT<T>;
+
+            static type make (const ResistorT<T>& r, const CapacitorT<T>& c)
+            {
+                return type { r.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, InductorT<T>>
+        {
+            using type = ResistorInductorSeriesT<T>;
+
+            static type make (const ResistorT<T>& r, const InductorT<T>& l)
+            {
+                return type { r.getResistanceValue(), l.getInductanceValue(), l.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, InductorT<T>, CapacitorT<T>>
+        {
+            using type = InductorCapacitorSeriesT<T>;
+
+            static type make (const InductorT<T>& l, const CapacitorT<T>& c)
+            {
+                return type { l.getInductanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, InductorCapacitorSeriesT<T>>
+        {
+            using type = ResistorInductorCapacitorSeriesT<T>;
+
+            static type make (const ResistorT<T>& r, const InductorCapacitorSeriesT<T>& lc)
+            {
+                return type { r.getResistanceValue(), lc.getInductanceValue(), lc.getCapacitanceValue(), lc.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistorT<T>, ResistorCapacitorParallelT<T>>
+        {
+            using type = CapacitorESRT<T>;
+
+            static type make (const ResistorT<T>& esr, const ResistorCapacitorParallelT<T>& leakyCap)
+            {
+                return type { leakyCap.getCapacitanceValue(), esr.getResistanceValue(), leakyCap.getSampleRate(), leakyCap.getResistanceValue() };
+            }
+        };
+
+        template <typename T>
+        struct FusedSeries<T, ResistiveVoltageSourceT<T>, CapacitorT<T>>
+        {
+            using type = ResistiveCapacitiveVoltageSourceT<T>;
+
+            static type make (const ResistiveVoltageSourceT<T>& vs, const CapacitorT<T>& c)
+            {
+                type fused { vs.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+                fused.setVoltage (vs.getVoltage());
+                return fused;
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistorT<T>, CapacitorT<T>>
+        {
+            using type = ResistorCapacitorParallelT<T>;
+
+            static type make (const ResistorT<T>& r, const CapacitorT<T>& c)
+            {
+                return type { r.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistorT<T>, InductorT<T>>
+        {
+            using type = ResistorInductorParallelT<T>;
+
+            static type make (const ResistorT<T>& r, const InductorT<T>& l)
+            {
+                return type { r.getResistanceValue(), l.getInductanceValue(), l.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, InductorT<T>, CapacitorT<T>>
+        {
+            using type = InductorCapacitorParallelT<T>;
+
+            static type make (const InductorT<T>& l, const CapacitorT<T>& c)
+            {
+                return type { l.getInductanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+            }
+        };
+
+        template <typename T>
+        struct FusedParallel<T, ResistiveCurrentSourceT<T>, CapacitorT<T>>
+        {
+            using type = ResistiveCapacitiveCurrentSourceT<T>;
+
+            static type make (const ResistiveCurrentSourceT<T>& is, const CapacitorT<T>& c)
+            {
+                type fused { is.getResistanceValue(), c.getCapacitanceValue(), c.getSampleRate() };
+                fused.setCurrent (is.getCurrent());
+                return fused;
+            }
+        };
+
+        // clang-format off
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedSeries<T, InductorT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, InductorT<T>>> {};
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, InductorT<T>> : SwapPorts<FusedSeries<T, InductorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedSeries<T, InductorCapacitorSeriesT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, InductorCapacitorSeriesT<T>>> {};
+        template <typename T> struct FusedSeries<T, ResistorCapacitorParallelT<T>, ResistorT<T>> : SwapPorts<FusedSeries<T, ResistorT<T>, ResistorCapacitorParallelT<T>>> {};
+        template <typename T> struct FusedSeries<T, CapacitorT<T>, ResistiveVoltageSourceT<T>> : SwapPorts<FusedSeries<T, ResistiveVoltageSourceT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, ResistorT<T>> : SwapPorts<FusedParallel<T, ResistorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, InductorT<T>, ResistorT<T>> : SwapPorts<FusedParallel<T, ResistorT<T>, InductorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, InductorT<T>> : SwapPorts<FusedParallel<T, InductorT<T>, CapacitorT<T>>> {};
+        template <typename T> struct FusedParallel<T, CapacitorT<T>, ResistiveCurrentSourceT<T>> : SwapPorts<FusedParallel<T, ResistiveCurrentSourceT<T>, CapacitorT<T>>> {};
+        // clang-format on
+
+        /** Only temporaries can be fused, since nothing else may be holding a reference to them. */
+        template <typename P1Type, typename P2Type>
+        using EnableIfTemporaries = std::enable_if_t<! std::is_lvalue_reference<P1Type>::value && ! std::is_lvalue_reference<P2Type>::value>;
+    } // namespace fusion_detail
+#endif // DOXYGEN
+
+    /** The fused element which replaces the series connection of P1Type and P2Type. */
+    template <typename T, typename P1Type, typename P2Type>
+    using FusedSeriesT = typename fusion_detail::FusedSeries<T, P1Type, P2Type>::type;
+
+    /** The fused element which replaces the parallel connection of P1Type and P2Type. */
+    template <typename T, typename P1Type, typename P2Type>
+    using FusedParallelT = typename fusion_detail::FusedParallel<T, P1Type, P2Type>::type;
+
+    /**
+     * Factory method for fusing two elements connected in series into a single element.
+     *
+     * When makeSeries() is called with two temporary elements (rather than references to
+     * elements that live elsewhere), the pair is replaced by the equivalent fused element,
+     * chosen at compile-time. Fused elements may be fused again, so that nested factory
+     * calls can collapse a whole sub-tree:
+     * @code
+     * // ResistorInductorCapacitorSeriesT<float>
+     * auto rlc = wdft::makeSeries<float> (wdft::ResistorT<float> { 100.0f },
+     *                                     wdft::makeSeries<float> (wdft::InductorT<float> { 10.0e-3f, fs },
+     *                                                              wdft::CapacitorT<float> { 1.0e-6f, fs }));
+     * rlc.setResistanceValue (220.0f);
+     * @endcode
+     *
+     * The fused element takes its values from the temporary elements, and has the same
+     * setters (setResistanceValue(), setCapacitanceValue(), etc.). Since the temporaries
+     * don't outlive the call, the internal states of the fused element can't be probed
+     * separately. The supported combinations are:
+     *  - Resistor + Capacitor, Resistor + Inductor, Inductor + Capacitor
+     *  - Resistor + (Inductor + Capacitor): ResistorInductorCapacitorSeriesT
+     *  - Resistor + (Capacitor || Resistor): CapacitorESRT
+     *  - ResistiveVoltageSource + Capacitor: ResistiveCapacitiveVoltageSourceT
+     *
+     * Other combinations don't compile, and should use the reference version of makeSeries().
+     */
+    template <typename T, typename P1Type, typename P2Type, typename = fusion_detail::EnableIfTemporaries<P1Type, P2Type>>
+    CHOWDSP_WDF_MAYBE_UNUSED FusedSeriesT<T, std::decay_t<P1Type>, std::decay_t<P2Type>> makeSeries (P1Type&& p1, P2Type&& p2)
+    {
+        return fusion_detail::FusedSeries<T, std::decay_t<P1Type>, std::decay_t<P2Type>>::make (p1, p2);
+    }
+
+    /**
+     * Factory method for fusing two elements connected in parallel into a single element.
+     *
+     * This works the same way as the fusing version of makeSeries(). The supported combinations are:
+     *  - Resistor || Capacitor, Resistor || Inductor, Inductor || Capacitor
+     *  - ResistiveCurrentSource || Capacitor: ResistiveCapacitiveCurrentSourceT
+     */
+    template <typename T, typename P1Type, typename P2Type, typename = fusion_detail::EnableIfTemporaries<P1Type, P2Type>>
+    CHOWDSP_WDF_MAYBE_UNUSED FusedParallelT<T, std::decay_t<P1Type>, std::decay_t<P2Type>> makeParallel (P1Type&& p1, P2Type&& p2)
+    {
+        return fusion_detail::FusedParallel<T, std::decay_t<P1Type>, std::decay_t<P2Type>>::make (p1, p2);
+    }
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_WDFT_FUSION_H
+
+// #include "wdft_nonlinearities.h"
+#ifndef CHOWDSP_WDF_WDFT_NONLINEARITIES_H
+#define CHOWDSP_WDF_WDFT_NONLINEARITIES_H
+
+#include <cmath>
+
+// #include "wdft_base.h"
+
+
+// #include "../math/signum.h"
+
+
+namespace chowdsp
+{
+/** Methods for implementing the signum function */
+namespace signum
+{
+    /** Signum function to determine the sign of the input. */
+    template <typename T>
+    inline int signum (T val)
+    {
+        return (T (0) < val) - (val < T (0));
+    }
+
+#if defined(XSIMD_HPP)
+    /** Signum function to determine the sign of the input. */
+    template <typename T>
+    inline xsimd::batch<T> signum (xsimd::batch<T> val)
+    {
+        using v_type = xsimd::batch<T>;
+        const auto positive = xsimd::select (val > v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
+        const auto negative = xsimd::select (val < v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
+        return positive - negative;
+    }
+#endif
+
+} // namespace signum
+} // namespace chowdsp
+
+// #include "../math/omega.h"
+/*
+ * Copyright (C) 2019 Stefano D'Angelo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * NOTE: code has been modified significantly by Jatin Chowdhury
+ */
+
+#ifndef OMEGA_H_INCLUDED
+#define OMEGA_H_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+// #include "sample_type.h"
+
+
+namespace chowdsp
+{
+/**
+ * Useful approximations for evaluating the Wright Omega function.
+ *
+ * This approach was devloped by Stefano D'Angelo, and adapted from his
+ * original implementation under the MIT license.
+ * - Paper: https://www.dafx.de/paper-archive/2019/DAFx2019_paper_5.pdf
+ * - Original Source: https://www.dangelo.audio/dafx2019-omega.html
+ */
+namespace Omega
+{
+    /**
+     * Evaluates a polynomial of a given order, using Estrin's scheme.
+     * Coefficients should be given in the form { a_n, a_n-1, ..., a_1, a_0 }
+     * https://en.wikipedia.org/wiki/Estrin%27s_scheme
+     */
+    template <int ORDER, typename T, typename X>
+    inline typename std::enable_if<(ORDER == 1), decltype (T {} * X {})>::type estrin (const T (&coeffs)[ORDER + 1], const X& x)
+    {
+        return coeffs[1] + coeffs[0] * x;
+    }
+
+    template <int ORDER, typename T, typename X>
+    inline typename std::enable_if<(ORDER > 1), decltype (T {} * X {})>::type estrin (const T (&coeffs)[ORDER + 1], const X& x)
+    {
+        decltype (T {} * X {}) temp[ORDER / 2 + 1];
+        for (int n = ORDER; n >= 0; n -= 2)
+            temp[n / 2] = coeffs[n] + coeffs[n - 1] * x;
+
+        temp[0] = (ORDER % 2 == 0) ? coeffs[0] : temp[0];
+
+        return estrin<ORDER / 2> (temp, x * x); // recurse!
+    }
+
+    /** approximation for log_2(x), optimized on the range [1, 2] */
+    template <typename T>
+    constexpr T log2_approx (T x)
+    {
+        constexpr auto alpha = (T) 0.1640425613334452;
+        constexpr auto beta = (T) -1.098865286222744;
+        constexpr auto gamma = (T) 3.148297929334117;
+        constexpr auto zeta = (T) -2.213475204444817;
+
+        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
+    }
+
+#if defined(XSIMD_HPP)
+    /** approximation for log_2(x), optimized on the range [1, 2] */
+    template <typename T>
+    inline xsimd::batch<T> log2_approx (const xsimd::batch<T>& x)
+    {
+        static constexpr auto alpha = (NumericType<T>) 0.1640425613334452;
+        static constexpr auto beta = (NumericType<T>) -1.098865286222744;
+        static constexpr auto gamma = (NumericType<T>) 3.148297929334117;
+        static constexpr auto zeta = (NumericType<T>) -2.213475204444817;
+
+        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
+    }
+#endif
+
+    /** approximation for log(x) */
+    template <typename T>
+    constexpr T log_approx (T x);
+
+    /** approximation for log(x) (32-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED constexpr float log_approx (float x)
+    {
+        union
+        {
+            int32_t i;
+            float f;
+        } v {};
+        v.f = x;
+        int32_t ex = v.i & 0x7f800000;
+        int32_t e = (ex >> 23) - 127;
+        v.i = (v.i - ex) | 0x3f800000;
+
+        return 0.693147180559945f * ((float) e + log2_approx<float> (v.f));
+    }
+
+    /** approximation for log(x) (64-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED constexpr double log_approx (double x)
+    {
+        union
+        {
+            int64_t i;
+            double d;
+        } v {};
+        v.d = x;
+        int64_t ex = v.i & 0x7ff0000000000000;
+        int64_t e = (ex >> 53) - 510;
+        v.i = (v.i - ex) | 0x3ff0000000000000;
+
+        return 0.693147180559945 * ((double) e + log2_approx<double> (v.d));
+    }
+
+#if defined(XSIMD_HPP)
+    /** approximation for log(x) (SIMD 32-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<float> log_approx (xsimd::batch<float> x)
+    {
+        union
+        {
+            xsimd::batch<int32_t> i;
+            xsimd::batch<float> f;
+        } v;
+        v.f = x;
+        xsimd::batch<int32_t> ex = v.i & 0x7f800000;
+        xsimd::batch<float> e = xsimd::to_float ((ex >> 23) - 127);
+        v.i = (v.i - ex) | 0x3f800000;
+
+        return 0.693147180559945f * (log2_approx<float> (v.f) + e);
+    }
+
+    /** approximation for log(x) (64-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<double> log_approx (xsimd::batch<double> x)
+    {
+        union
+        {
+            xsimd::batch<int64_t> i;
+            xsimd::batch<double> d;
+        } v {};
+        v.d = x;
+        xsimd::batch<int64_t> ex = v.i & 0x7ff0000000000000;
+        xsimd::batch<double> e = xsimd::to_float ((ex >> 53) - 510);
+        v.i = (v.i - ex) | 0x3ff0000000000000;
 
-        WDFMembers<T> wdf;
+        return 0.693147180559945 * (e + log2_approx<double> (v.d));
+    }
+#endif
 
-    private:
-        T C_value = (T) 1.0e-6;
-        T z = (T) 0.0;
+    /** approximation for 2^x, optimized on the range [0, 1] */
+    template <typename T>
+    constexpr T pow2_approx (T x)
+    {
+        constexpr auto alpha = (T) 0.07944154167983575;
+        constexpr auto beta = (T) 0.2274112777602189;
+        constexpr auto gamma = (T) 0.6931471805599453;
+        constexpr auto zeta = (T) 1.0;
 
-        T fs;
+        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
+    }
 
-        T alpha;
-        T b_coef;
-        T a_coef;
-    };
+#if defined(XSIMD_HPP)
+    template <typename T>
+    inline xsimd::batch<T> pow2_approx (const xsimd::batch<T>& x)
+    {
+        static constexpr auto alpha = (NumericType<T>) 0.07944154167983575;
+        static constexpr auto beta = (NumericType<T>) 0.2274112777602189;
+        static constexpr auto gamma = (NumericType<T>) 0.6931471805599453;
+        static constexpr auto zeta = (NumericType<T>) 1.0;
 
-    /** WDF Inductor Node */
+        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
+    }
+#endif
+
+    /** approximation for exp(x) */
     template <typename T>
-    class InductorT final : public BaseWDF
+    T exp_approx (T x);
+
+    /** approximation for exp(x) (32-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED constexpr float exp_approx (float x)
     {
-    public:
-        /** Creates a new WDF Inductor.
-         * @param value: Inductance value in Farads
-         * @param fs: WDF sample rate
-         */
-        explicit InductorT (T value, T fs = (T) 48000.0) : L_value (value),
-                                                           fs (fs)
-        {
-            calcImpedance();
-        }
+        x = std::max (-126.0f, 1.442695040888963f * x);
 
-        /** Prepares the inductor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        union
         {
-            fs = sampleRate;
-            propagateImpedanceChange();
+            int32_t i;
+            float f;
+        } v {};
 
-            reset();
-        }
+        auto xi = (int32_t) x;
+        int32_t l = x < 0.0f ? xi - 1 : xi;
+        float f = x - (float) l;
+        v.i = (l + 127) << 23;
 
-        /** Resets the inductor state */
-        void reset()
-        {
-            z = (T) 0.0;
-        }
+        return v.f * pow2_approx<float> (f);
+    }
 
-        /** Sets the inductance value of the WDF inductor, in Henries. */
-        void setInductanceValue (T newL)
+    /** approximation for exp(x) (64-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED constexpr double exp_approx (double x)
+    {
+        x = std::max ((double) -126.0, 1.442695040888963 * x);
+
+        union
         {
-            if (all (newL == L_value))
-                return;
+            int64_t i;
+            double d;
+        } v {};
 
-            L_value = newL;
-            propagateImpedanceChange();
-        }
+        auto xi = (int64_t) x;
+        int64_t l = x < 0.0 ? xi - 1 : xi;
+        double d = x - (double) l;
+        v.i = (l + 1023) << 52;
 
-        /** Computes the impedance of the WDF inductor,
-         * Z_L = 2 * f_s * L
-         */
-        inline void calcImpedance() override
-        {
-            wdf.R = (T) 2.0 * L_value * fs;
-            wdf.G = (T) 1.0 / wdf.R;
-        }
+        return v.d * pow2_approx<double> (d);
+    }
 
-        /** Accepts an incident wave into a WDF inductor. */
-        inline void incident (T x) noexcept
-        {
-            wdf.a = x;
-            z = wdf.a;
-        }
+#if defined(XSIMD_HPP)
+    /** approximation for exp(x) (32-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<float> exp_approx (xsimd::batch<float> x)
+    {
+        x = xsimd::max (xsimd::broadcast (-126.0f), 1.442695040888963f * x);
 
-        /** Propogates a reflected wave from a WDF inductor. */
-        inline T reflected() noexcept
+        union
         {
-            wdf.b = -z;
-            return wdf.b;
-        }
-
-        WDFMembers<T> wdf;
+            xsimd::batch<int32_t> i;
+            xsimd::batch<float> f;
+        } v {};
 
-    private:
-        T L_value = (T) 1.0e-6;
-        T z = (T) 0.0;
+        auto xi = xsimd::to_int (x);
+        xsimd::batch<int32_t> l = xsimd::select (xi < 0, xi - 1, xi);
+        xsimd::batch<float> f = x - xsimd::to_float (l);
+        v.i = (l + 127) << 23;
 
-        T fs;
-    };
+        return v.f * pow2_approx<float> (f);
+    }
 
-    /** WDF Inductor Node with alpha transform parameter */
-    template <typename T>
-    class InductorAlphaT final : public BaseWDF
+    /** approximation for exp(x) (64-bit) */
+    template <>
+    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<double> exp_approx (xsimd::batch<double> x)
     {
-    public:
-        /** Creates a new WDF Inductor.
-         * @param value: Inductance value in Farads
-         * @param fs: WDF sample rate
-         * @param alpha: alpha value to be used for the alpha transform,
-         *               use 0 for Backwards Euler, use 1 for Bilinear Transform.
-         */
-        explicit InductorAlphaT (T value, T fs = (T) 48000.0, T alpha = (T) 1.0) : L_value (value),
-                                                                                   fs (fs),
-                                                                                   alpha (alpha),
-                                                                                   b_coef (((T) 1.0 - alpha) / (T) 2.0),
-                                                                                   a_coef (((T) 1.0 + alpha) / (T) 2.0)
-        {
-            calcImpedance();
-        }
+        x = xsimd::max (xsimd::broadcast (-126.0), 1.442695040888963 * x);
 
-        /** Prepares the inductor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        union
         {
-            fs = sampleRate;
-            propagateImpedanceChange();
+            xsimd::batch<int64_t> i;
+            xsimd::batch<double> d;
+        } v {};
 
-            reset();
-        }
+        auto xi = xsimd::to_int (x);
+        xsimd::batch<int64_t> l = xsimd::select (xi < 0, xi - 1, xi);
+        xsimd::batch<double> d = x - xsimd::to_float (l);
+        v.i = (l + 1023) << 52;
 
-        /** Resets the inductor state */
-        void reset()
-        {
-            z = (T) 0.0;
-        }
+        return v.d * pow2_approx<double> (d);
+    }
+#endif
 
-        /** Sets a new alpha value to use for the alpha transform */
-        void setAlpha (T newAlpha)
-        {
-            alpha = newAlpha;
-            b_coef = ((T) 1.0 - alpha) / (T) 2.0;
-            a_coef = ((T) 1.0 + alpha) / (T) 2.0;
+    /** First-order approximation of the Wright Omega functions */
+    template <typename T>
+    constexpr T omega1 (T x)
+    {
+#if defined(XSIMD_HPP)
+        using xsimd::max;
+#endif
+        using std::max;
 
-            propagateImpedanceChange();
-        }
+        return max (x, (T) 0);
+    }
 
-        /** Sets the inductance value of the WDF inductor, in Henries. */
-        void setInductanceValue (T newL)
-        {
-            if (all (newL == L_value))
-                return;
+    /** Second-order approximation of the Wright Omega functions */
+    template <typename T>
+    constexpr T omega2 (T x)
+    {
+        constexpr auto x1 = (NumericType<T>) -3.684303659906469;
+        constexpr auto x2 = (NumericType<T>) 1.972967391708859;
+        constexpr auto a = (NumericType<T>) 9.451797158780131e-3;
+        constexpr auto b = (NumericType<T>) 1.126446405111627e-1;
+        constexpr auto c = (NumericType<T>) 4.451353886588814e-1;
+        constexpr auto d = (NumericType<T>) 5.836596684310648e-1;
 
-            L_value = newL;
-            propagateImpedanceChange();
-        }
+        return select (x < x1, (T) 0, select (x > x2, x, estrin<3> ({ a, b, c, d }, x)));
+    }
 
-        /** Computes the impedance of the WDF inductor,
-         * Z_L = (1 + alpha) * f_s * L
-         */
-        inline void calcImpedance() override
-        {
-            wdf.R = ((T) 1.0 + alpha) * L_value * fs;
-            wdf.G = (T) 1.0 / wdf.R;
-        }
+    /** Third-order approximation of the Wright Omega functions */
+    template <typename T>
+    constexpr T omega3 (T x)
+    {
+        constexpr auto x1 = (NumericType<T>) -3.341459552768620;
+        constexpr auto x2 = (NumericType<T>) 8.0;
+        constexpr auto a = (NumericType<T>) -1.314293149877800e-3;
+        constexpr auto b = (NumericType<T>) 4.775931364975583e-2;
+        constexpr auto c = (NumericType<T>) 3.631952663804445e-1;
+        constexpr auto d = (NumericType<T>) 6.313183464296682e-1;
 
-        /** Accepts an incident wave into a WDF inductor. */
-        inline void incident (T x) noexcept
-        {
-            wdf.a = x;
-            z = wdf.a;
-        }
+        return select (x < x1, (T) 0, select (x < x2, estrin<3> ({ a, b, c, d }, x), x - log_approx<T> (x)));
+    }
+
+    /** Fourth-order approximation of the Wright Omega functions */
+    template <typename T>
+    constexpr T omega4 (T x)
+    {
+        const auto y = omega3<T> (x);
+        return y - (y - exp_approx<T> (x - y)) / (y + (T) 1);
+    }
 
-        /** Propogates a reflected wave from a WDF inductor. */
-        inline T reflected() noexcept
+    struct Omega
+    {
+        template <typename T>
+        static T omega (T x)
         {
-            wdf.b = b_coef * wdf.b - a_coef * z;
-            return wdf.b;
+            return omega4 (x);
         }
+    };
+} // namespace Omega
+} // namespace chowdsp
 
-        WDFMembers<T> wdf;
-
-    private:
-        T L_value = (T) 1.0e-6;
-        T z = (T) 0.0;
+#endif //OMEGA_H_INCLUDED
 
-        T fs;
 
-        T alpha;
-        T b_coef;
-        T a_coef;
+namespace chowdsp
+{
+namespace wdft
+{
+    /** Enum to determine which diode approximation eqn. to use */
+    enum DiodeQuality
+    {
+        Good, // see reference eqn (18)
+        Best, // see reference eqn (39)
     };
 
-    /** WDF Resistor and Capacitor in Series */
-    template <typename T>
-    class ResistorCapacitorSeriesT final : public BaseWDF
+    /**
+     * WDF diode pair (non-adaptable)
+     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
+     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
+     */
+    template <typename T, typename Next, DiodeQuality Quality = DiodeQuality::Best, typename OmegaProvider = Omega::Omega>
+    class DiodePairT final : public RootWDF
     {
     public:
-        /** Creates a new WDF Resistor/Capacitor Series.
-         * @param cap_value: Resistance value in Ohms
-         * @param res_value: Capacitance value in Farads
-         * @param fs: WDF sample rate
+        /**
+         * Creates a new WDF diode pair, with the given diode specifications.
+         * @param n: the next element in the WDF connection tree
+         * @param Is: reverse saturation current
+         * @param Vt: thermal voltage
+         * @param nDiodes: the number of series diodes
          */
-        explicit ResistorCapacitorSeriesT (T res_value, T cap_value, T fs = (T) 48000.0)
-            : R_value (res_value),
-              C_value (cap_value),
-              tt ((T) 1 / fs)
-        {
-            calcImpedance();
-        }
-
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
-        {
-            tt = (T) 1 / sampleRate;
-            propagateImpedanceChange();
-
-            reset();
-        }
-
-        /** Resets the capacitor state */
-        void reset()
-        {
-            z = (T) 0.0;
-            wdf.a = (T) 0;
-            wdf.b = (T) 0;
-        }
-
-        /** Sets the resistance value of the WDF resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        DiodePairT (Next& n, T Is, T Vt = NumericType<T> (25.85e-3), T nDiodes = 1) : next (n)
         {
-            if (all (newR == R_value))
-                return;
-
-            R_value = newR;
-            propagateImpedanceChange();
+            n.connectToParent (this);
+            setDiodeParameters (Is, Vt, nDiodes);
         }
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
+        /** Sets diode specific parameters */
+        void setDiodeParameters (T newIs, T newVt, T nDiodes)
         {
-            if (all (newC == C_value))
-                return;
-
-            C_value = newC;
-            propagateImpedanceChange();
+            Is = newIs;
+            Vt = nDiodes * newVt;
+            twoVt = (T) 2 * Vt;
+            oneOverVt = (T) 1 / Vt;
+            calcImpedance();
         }
 
-        /** Computes the impedance of the WDF resistor/capacitor combination */
         inline void calcImpedance() override
         {
-            wdf.R = tt / ((T) 2.0 * C_value) + R_value;
-            wdf.G = (T) 1.0 / wdf.R;
-            T_over_T_plus_2RC = tt / ((T) 2 * C_value * R_value + tt);
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+#if defined(XSIMD_HPP)
+            using xsimd::log;
+#endif
+            using std::log;
+
+            R_Is = next.wdf.R * Is;
+            R_Is_overVt = R_Is * oneOverVt;
+            logR_Is_overVt = log (R_Is_overVt);
         }
 
-        /** Accepts an incident wave into the WDF. */
+        /** Accepts an incident wave into a WDF diode pair. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z -= T_over_T_plus_2RC * (wdf.a + z);
         }
 
-        /** Propogates a reflected wave from the WDF. */
+        /** Propogates a reflected wave from a WDF diode pair. */
         inline T reflected() noexcept
         {
-            wdf.b = -z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            reflectedInternal();
             return wdf.b;
         }
 
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        T R_value = (T) 1.0e3;
-        T C_value = (T) 1.0e-6;
+        /** Implementation for float/double (Good). */
+        template <typename C = T, DiodeQuality Q = Quality>
+        inline typename std::enable_if<Q == Good, void>::type
+            reflectedInternal() noexcept
+        {
+            // See eqn (18) from reference paper
+            T lambda = (T) signum::signum (wdf.a);
+            wdf.b = wdf.a + (T) 2 * lambda * (R_Is - Vt * OmegaProvider::omega (logR_Is_overVt + lambda * wdf.a * oneOverVt + R_Is_overVt));
+        }
 
-        T T_over_T_plus_2RC = (T) 0.0;
+        /** Implementation for float/double (Best). */
+        template <typename C = T, DiodeQuality Q = Quality>
+        inline typename std::enable_if<Q == Best, void>::type
+            reflectedInternal() noexcept
+        {
+            // See eqn (39) from reference paper
+            T lambda = (T) signum::signum (wdf.a);
+            T lambda_a_over_vt = lambda * wdf.a * oneOverVt;
+            wdf.b = wdf.a - twoVt * lambda * (Omega::omega4 (logR_Is_overVt + lambda_a_over_vt) - Omega::omega4 (logR_Is_overVt - lambda_a_over_vt));
+        }
 
-        T z = (T) 0.0;
+        T Is; // reverse saturation current
+        T Vt; // thermal voltage
 
-        T tt;
+        // pre-computed vars
+        T twoVt;
+        T oneOverVt;
+        T R_Is;
+        T R_Is_overVt;
+        T logR_Is_overVt;
+
+        Next& next;
     };
 
-    /** WDF Resistor and Capacitor in parallel */
-    template <typename T>
-    class ResistorCapacitorParallelT final : public BaseWDF
+    /**
+     * WDF diode (non-adaptable)
+     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
+     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
+     */
+    template <typename T, typename Next, DiodeQuality Quality = DiodeQuality::Best, typename OmegaProvider = Omega::Omega>
+    class DiodeT final : public RootWDF
     {
     public:
-        /** Creates a new WDF Resistor/Capacitor Parallel.
-         * @param res_value: Resistance value in Ohms
-         * @param cap_value: Capacitance value in Farads
-         * @param fs: WDF sample rate
+        /**
+         * Creates a new WDF diode, with the given diode specifications.
+         * @param n: the next element in the WDF connection tree
+         * @param Is: reverse saturation current
+         * @param Vt: thermal voltage
+         * @param nDiodes: the number of series diodes
          */
-        explicit ResistorCapacitorParallelT (T res_value, T cap_value, T fs = (T) 48000.0)
-            : R_value (res_value),
-              C_value (cap_value),
-              tt ((T) 1 / fs)
+        DiodeT (Next& n, T Is, T Vt = NumericType<T> (25.85e-3), T nDiodes = 1) : next (n)
         {
+            n.connectToParent (this);
+            setDiodeParameters (Is, Vt, nDiodes);
+        }
+
+        /** Sets diode specific parameters */
+        void setDiodeParameters (T newIs, T newVt, T nDiodes)
+        {
+            Is = newIs;
+            Vt = nDiodes * newVt;
+            twoVt = (T) 2 * Vt;
+            oneOverVt = (T) 1 / Vt;
             calcImpedance();
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        inline void calcImpedance() override
         {
-            tt = (T) 1 / sampleRate;
-            propagateImpedanceChange();
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+#if defined(XSIMD_HPP)
+            using xsimd::log;
+#endif
+            using std::log;
 
-            reset();
+            twoR_Is = (T) 2 * next.wdf.R * Is;
+            R_Is_overVt = next.wdf.R * Is * oneOverVt;
+            logR_Is_overVt = log (R_Is_overVt);
         }
 
-        /** Resets the capacitor state */
-        void reset()
+        /** Accepts an incident wave into a WDF diode. */
+        inline void incident (T x) noexcept
         {
-            z = (T) 0.0;
-            wdf.a = (T) 0;
-            wdf.b = (T) 0;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdf.a = x;
         }
 
-        /** Sets the resistance value of the WDF resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        /** Propogates a reflected wave from a WDF diode. */
+        inline T reflected() noexcept
         {
-            if (all (newR == R_value))
-                return;
-
-            R_value = newR;
-            propagateImpedanceChange();
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            // See eqn (10) from reference paper
+            wdf.b = wdf.a + twoR_Is - twoVt * OmegaProvider::omega (logR_Is_overVt + wdf.a * oneOverVt + R_Is_overVt);
+            return wdf.b;
         }
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
         {
-            if (all (newC == C_value))
-                return;
-
-            C_value = newC;
-            propagateImpedanceChange();
+            fn (next);
         }
 
-        /** Computes the impedance of the WDF resistor/capacitor combination */
-        inline void calcImpedance() override
+        WDFMembers<T> wdf;
+
+    private:
+        T Is; // reverse saturation current
+        T Vt; // thermal voltage
+
+        // pre-computed vars
+        T twoVt;
+        T oneOverVt;
+        T twoR_Is;
+        T R_Is_overVt;
+        T logR_Is_overVt;
+
+        Next& next;
+    };
+
+    /** WDF Switch (non-adaptable) */
+    template <typename T, typename Next>
+    class SwitchT final : public RootWDF
+    {
+    public:
+        explicit SwitchT (Next& n) : next (n)
         {
-            const auto twoRC = (T) 2.0 * C_value * R_value;
-            wdf.R = R_value * tt / (twoRC + tt);
-            wdf.G = (T) 1.0 / wdf.R;
-            twoRC_over_twoRC_plus_T = twoRC / (twoRC + tt);
+            n.connectToParent (this);
         }
 
-        /** Accepts an incident wave into the WDF. */
+        inline void calcImpedance() override { CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance); }
+
+        /** Sets the state of the switch. */
+        void setClosed (bool shouldClose) { closed = shouldClose; }
+
+        /** Accepts an incident wave into a WDF switch. */
         inline void incident (T x) noexcept
         {
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
             wdf.a = x;
-            z = wdf.b + wdf.a - z;
         }
 
-        /** Propogates a reflected wave from the WDF. */
+        /** Propogates a reflected wave from a WDF switch. */
         inline T reflected() noexcept
         {
-            wdf.b = twoRC_over_twoRC_plus_T * z;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            wdf.b = closed ? -wdf.a : wdf.a;
             return wdf.b;
         }
 
+        /** Calls fn for the element connected to this root. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            fn (next);
+        }
+
         WDFMembers<T> wdf;
 
     private:
-        T R_value = (T) 1.0e3;
-        T C_value = (T) 1.0e-6;
-
-        T twoRC_over_twoRC_plus_T = (T) 0.0;
-
-        T z = (T) 0.0;
+        Next& next;
 
-        T tt;
+        bool closed = true;
     };
 } // namespace wdft
 } // namespace chowdsp
 
-#endif //CHOWDSP_WDF_WDFT_ONE_PORTS_H
+#endif //CHOWDSP_WDF_WDFT_NONLINEARITIES_H
 
-// #include "wdft_sources.h"
-#ifndef CHOWDSP_WDF_WDFT_SOURCES_H
-#define CHOWDSP_WDF_WDFT_SOURCES_H
 
-// #include "wdft_base.h"
+#endif // CHOWDSP_WDF_T_INCLUDED
 
 
 namespace chowdsp
 {
-namespace wdft
+namespace wdf
 {
-    /** WDF Ideal Voltage source (non-adaptable) */
-    template <typename T, typename Next>
-    class IdealVoltageSourceT final : public RootWDF
+    /** Wave digital filter base class */
+    template <typename T>
+    class WDF : public wdft::BaseWDF
     {
     public:
-        explicit IdealVoltageSourceT (Next& next)
+        explicit WDF (std::string type) : type (std::move (type)) {}
+        ~WDF() override = default;
+
+        void connectToNode (WDF<T>* p) { wdfParent = p; }
+
+        /** Sub-classes override this function to propagate
+     * an impedance change to the upstream elements in
+     * the WDF tree.
+     */
+        virtual inline void propagateImpedance()
         {
-            next.connectToParent (this);
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
             calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
+
+            if (wdfParent != nullptr)
+                wdfParent->propagateImpedance();
         }
 
-        void calcImpedance() override {}
+        /** Sub-classes override this function to accept an incident wave. */
+        virtual void incident (T x) noexcept = 0;
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV) { Vs = newV; }
+        /** Sub-classes override this function to propogate a reflected wave. */
+        virtual T reflected() noexcept = 0;
 
-        /** Accepts an incident wave into a WDF ideal voltage source. */
-        inline void incident (T x) noexcept
+        /** Interface for visiting the ports connected to an element (see visitPorts()). */
+        struct PortVisitor
         {
-            wdf.a = x;
+            virtual ~PortVisitor() = default;
+            virtual void visit (WDF<T>& port) = 0;
+        };
+
+        /** Interface for visiting the internal state of an element (see visitState()). */
+        struct StateVisitor
+        {
+            virtual ~StateVisitor() = default;
+            virtual void visit (T& state) = 0;
+        };
+
+        /** Sub-classes override this function to visit each of their connected ports. */
+        virtual void visitConnectedPorts (PortVisitor&) {}
+
+        /** Sub-classes override this function to visit each of their internal state variables. */
+        virtual void visitInternalState (StateVisitor&) {}
+
+        /** Calls fn for each port connected "below" this element in the WDF tree. */
+        template <typename Fn>
+        void visitPorts (Fn&& fn)
+        {
+            struct Visitor : PortVisitor
+            {
+                explicit Visitor (std::remove_reference_t<Fn>& f) : fn (f) {}
+                void visit (WDF<T>& port) override { fn (port); }
+                std::remove_reference_t<Fn>& fn;
+            } visitor { fn };
+            visitConnectedPorts (visitor);
         }
 
-        /** Propogates a reflected wave from a WDF ideal voltage source. */
-        inline T reflected() noexcept
+        /** Calls visitor with a reference to each of this element's internal state variables. */
+        template <typename Fn>
+        void visitState (Fn&& fn)
         {
-            wdf.b = -wdf.a + (T) 2.0 * Vs;
-            return wdf.b;
+            struct Visitor : StateVisitor
+            {
+                explicit Visitor (std::remove_reference_t<Fn>& f) : fn (f) {}
+                void visit (T& state) override { fn (state); }
+                std::remove_reference_t<Fn>& fn;
+            } visitor { fn };
+            visitInternalState (visitor);
         }
 
-        WDFMembers<T> wdf;
+        /** Probe the voltage across this circuit element. */
+        inline T voltage() const noexcept
+        {
+            return (wdf.a + wdf.b) / (T) 2.0;
+        }
+
+        /**Probe the current through this circuit element. */
+        inline T current() const noexcept
+        {
+            return (wdf.a - wdf.b) / ((T) 2.0 * wdf.R);
+        }
+
+        // These classes need access to a,b
+        template <typename>
+        friend class YParameter;
+
+        template <typename>
+        friend class WDFParallel;
+
+        template <typename>
+        friend class WDFSeries;
+
+        wdft::WDFMembers<T> wdf;
 
     private:
-        T Vs = (T) 0.0;
+        const std::string type;
+
+        WDF<T>* wdfParent = nullptr;
     };
 
-    /** WDF Voltage source with series resistance */
-    template <typename T>
-    class ResistiveVoltageSourceT final : public BaseWDF
+    template <typename T, typename WDFType>
+    class WDFWrapper : public WDF<T>
     {
     public:
-        /** Creates a new resistive voltage source.
-         * @param value: initial resistance value, in Ohms
-         */
-        explicit ResistiveVoltageSourceT (T value = NumericType<T> (1.0e-9)) : R_value (value)
+        template <typename... Args>
+        explicit WDFWrapper (const std::string& name, Args&&... args) : WDF<T> (name),
+                                                                        internalWDF (std::forward<Args> (args)...)
         {
             calcImpedance();
         }
 
-        /** Sets the resistance value of the series resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        /** Computes the impedance of the WDF resistor, Z_R = R. */
+        inline void calcImpedance() override
         {
-            if (all (newR == R_value))
-                return;
-
-            R_value = newR;
-            propagateImpedanceChange();
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            internalWDF.calcImpedance();
+            this->wdf.R = internalWDF.wdf.R;
+            this->wdf.G = internalWDF.wdf.G;
         }
 
-        /** Computes the impedance for a WDF resistive voltage souce
-         * Z_Vr = Z_R
-         */
-        inline void calcImpedance() override
+        /** Accepts an incident wave into a WDF resistor. */
+        inline void incident (T x) noexcept override
         {
-            wdf.R = R_value;
-            wdf.G = (T) 1.0 / wdf.R;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            this->wdf.a = x;
+            internalWDF.incident (x);
         }
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV) { Vs = newV; }
-
-        /** Accepts an incident wave into a WDF resistive voltage source. */
-        inline void incident (T x) noexcept
+        /** Propogates a reflected wave from a WDF resistor. */
+        inline T reflected() noexcept override
         {
-            wdf.a = x;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            this->wdf.b = internalWDF.reflected();
+            return this->wdf.b;
         }
 
-        /** Propogates a reflected wave from a WDF resistive voltage source. */
-        inline T reflected() noexcept
+        /** Visits the ports connected to the internal WDF element. */
+        void visitConnectedPorts (typename WDF<T>::PortVisitor& visitor) override
         {
-            wdf.b = Vs;
-            return wdf.b;
+            internalWDF.visitPorts ([&visitor] (WDF<T>& port) { visitor.visit (port); });
         }
 
-        WDFMembers<T> wdf;
+        /** Visits the waves and internal state of the internal WDF element. */
+        void visitInternalState (typename WDF<T>::StateVisitor& visitor) override
+        {
+            visitor.visit (internalWDF.wdf.a);
+            visitor.visit (internalWDF.wdf.b);
+            internalWDF.visitState ([&visitor] (T& x) { visitor.visit (x); });
+        }
 
-    private:
-        T Vs = (T) 0.0;
-        T R_value = (T) 1.0e-9;
+    protected:
+        WDFType internalWDF;
     };
 
-    /** WDF Voltage source with series capacitance */
-    template <typename T>
-    class CapacitiveVoltageSourceT final : public BaseWDF
+    template <typename T, typename WDFType>
+    class WDFRootWrapper : public WDFWrapper<T, WDFType>
     {
     public:
-        /** Creates a new resistive voltage source.
-         * @param value: initial resistance value, in Ohms
-         */
-        explicit CapacitiveVoltageSourceT (T value = NumericType<T> (1.0e-6), T fs = (T) 48000)
-            : C_value (value),
-              fs (fs)
-
+        template <typename Next, typename... Args>
+        WDFRootWrapper (const std::string& name, Next& next, Args&&... args) : WDFWrapper<T, WDFType> (name, std::forward<Args> (args)...)
         {
+            next.connectToNode (this);
             calcImpedance();
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        inline void propagateImpedance() override
         {
-            fs = sampleRate;
-            propagateImpedanceChange();
-
-            reset();
+            CHOWDSP_WDF_INSTRUMENT_COUNT (propagateImpedanceChange);
+            CHOWDSP_WDF_TRACE_PROPAGATION();
+            this->calcImpedance();
+            CHOWDSP_WDF_TRACE_CALC_DONE();
         }
 
-        void reset()
+        inline void calcImpedance() override
         {
-            z = (T) 0;
-            v_1 = (T) 0;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            this->internalWDF.calcImpedance();
         }
+    };
+} // namespace wdf
+} // namespace chowdsp
 
-        /** Sets the capacitance value of the series resistor, in Farads. */
-        void setCapacitanceValue (T newC)
-        {
-            if (all (newC == C_value))
-                return;
+#endif //CHOWDSP_WDF_WDF_BASE_H
 
-            C_value = newC;
-            propagateImpedanceChange();
+// #include "rtype_detail.h"
+
+
+namespace chowdsp
+{
+namespace wdf
+{
+    /**
+     *  A non-adaptable R-Type adaptor.
+     *  For more information see: https://searchworks.stanford.edu/view/11891203, chapter 2
+     */
+    template <typename T>
+    class RootRtypeAdaptor : public WDF<T>
+    {
+    public:
+        RootRtypeAdaptor (std::initializer_list<WDF<T>*> dps)
+            : WDF<T> ("Root R-Type Adaptor"),
+              downPorts (dps),
+              S_matrix (downPorts.size(), downPorts.size()),
+              a_vec (downPorts.size()),
+              b_vec (downPorts.size())
+        {
+            for (auto* port : downPorts)
+                port->connectToParent (this);
         }
 
-        /** Computes the impedance of the WDF capacitor,
-         *             1
-         * Z_C = --------------
-         *        2 * f_s * C
+        /** Returns the number of ports connected to RootRtypeAdaptor */
+        size_t getNumPorts() const noexcept { return downPorts.size(); }
+
+        /**
+         * Returns the port impedance for the given port index.
+         * Note: it is the caller's responsibility to ensure that the portIndex is in range!
          */
-        inline void calcImpedance() override
+        T getPortImpedance (size_t portIndex) const noexcept { return downPorts[portIndex]->wdf.R; }
+
+        /** Recomputes internal variables based on the incoming impedances */
+        void calcImpedance() override
         {
-            wdf.R = (T) 1.0 / ((T) 2.0 * C_value * fs);
-            wdf.G = (T) 1.0 / wdf.R;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            impedanceCalculator (*this);
         }
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV)
+        /** Use this function to set the scattering matrix data. */
+        template <size_t N>
+        void setSMatrixData (const T (&mat)[N][N])
+        {
+            const auto numPorts = a_vec.size();
+            for (int i = 0; i < numPorts; ++i)
+                for (int j = 0; j < numPorts; ++j)
+                    S_matrix[j][i] = mat[i][j];
+        }
+
+        /** Computes both the incident and reflected waves at this root node. */
+        inline void compute() noexcept
         {
-            v_0 = newV;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+
+            int i = 0;
+            for (auto* port : downPorts)
+            {
+                port->incident (b_vec[i]);
+                a_vec[i] = port->reflected();
+                i++;
+            }
         }
 
-        /** Accepts an incident wave into a WDF resistive voltage source. */
-        inline void incident (T x) noexcept
+        /** Implement this function to set the scattering matrix when an incoming impedance changes */
+        std::function<void (RootRtypeAdaptor&)> impedanceCalculator = [] (auto&) {};
+
+        /** Visits each of the ports connected to this adaptor. */
+        void visitConnectedPorts (typename WDF<T>::PortVisitor& visitor) override
         {
-            wdf.a = x;
-            z = wdf.a;
+            for (auto* port : downPorts)
+                visitor.visit (*port);
         }
 
-        /** Propogates a reflected wave from a WDF resistive voltage source. */
-        inline T reflected() noexcept
+        /** Visits the incoming waves, which are stored between calls to compute(). */
+        void visitInternalState (typename WDF<T>::StateVisitor& visitor) override
         {
-            wdf.b = z + v_0 - v_1;
-            v_1 = v_0;
-            return wdf.b;
+            for (int i = 0; i < a_vec.size(); ++i)
+                visitor.visit (a_vec[i]);
         }
 
-        WDFMembers<T> wdf;
-
     private:
-        T C_value = (T) 1.0e-6;
+        void incident (T) noexcept override {}
+        T reflected() noexcept override { return T {}; }
 
-        T z {};
-        T v_0 {};
-        T v_1 {};
+        std::vector<WDF<T>*> downPorts;
 
-        T fs;
+        rtype_detail::Matrix<T> S_matrix; // square matrix representing S
+        rtype_detail::AlignedArray<T> a_vec; // temp matrix of inputs to Rport
+        rtype_detail::AlignedArray<T> b_vec; // temp matrix of outputs from Rport
     };
 
-    /** WDF Current source (non-adaptable) */
-    template <typename T, typename Next>
-    class IdealCurrentSourceT final : public RootWDF
+    /**
+     *  An adaptable R-Type adaptor.
+     *  For more information see: https://searchworks.stanford.edu/view/11891203, chapter 2
+     */
+    template <typename T>
+    class RtypeAdaptor : public WDF<T>
     {
     public:
-        explicit IdealCurrentSourceT (Next& n) : next (n)
+        /** The upPortIndex argument describes with port of the scattering matrix is being adapted. */
+        RtypeAdaptor (std::initializer_list<WDF<T>*> dps, int upPortIndex)
+            : WDF<T> ("R-Type Adaptor"),
+              m_upPortIndex (upPortIndex),
+              downPorts (dps),
+              S_matrix (downPorts.size() + 1, downPorts.size() + 1),
+              a_vec (downPorts.size() + 1),
+              b_vec (downPorts.size() + 1)
         {
-            n.connectToParent (this);
-            calcImpedance();
+            for (auto* port : downPorts)
+                port->connectToParent (this);
         }
 
-        inline void calcImpedance() override
+        /** Returns the number of ports connected to RtypeAdaptor */
+        size_t getNumPorts() const noexcept { return downPorts.size() + 1; }
+
+        /**
+         * Returns the port impedance for the given port index.
+         * Note: it is the caller's responsibility to ensure that the portIndex is in range!
+         */
+        T getPortImpedance (size_t portIndex) const noexcept { return downPorts[portIndex]->wdf.R; }
+
+        /** Recomputes internal variables based on the incoming impedances */
+        void calcImpedance() override
         {
-            twoR = (T) 2.0 * next.wdf.R;
-            twoR_Is = twoR * Is;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            this->wdf.R = impedanceCalculator (*this);
+            this->wdf.G = (T) 1 / this->wdf.R;
         }
 
-        /** Sets the current of the current source, in Amps */
-        void setCurrent (T newI)
+        /** Use this function to set the scattering matrix data. */
+        template <size_t N>
+        void setSMatrixData (const T (&mat)[N][N])
         {
-            Is = newI;
-            twoR_Is = twoR * Is;
+            const auto numPorts = a_vec.size();
+            for (int i = 0; i < numPorts; ++i)
+                for (int j = 0; j < numPorts; ++j)
+                    S_matrix[j][i] = mat[i][j];
         }
 
-        /** Accepts an incident wave into a WDF ideal current source. */
-        inline void incident (T x) noexcept
+        /** Computes the incident wave. */
+        inline void incident (T downWave) noexcept override
         {
-            wdf.a = x;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            this->wdf.a = downWave;
+            a_vec[m_upPortIndex] = this->wdf.a;
+
+            rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+
+            int i = 0;
+            for (auto* port : downPorts)
+            {
+                auto portIndex = getPortIndex (i);
+                port->incident (b_vec[portIndex]);
+                i++;
+            }
         }
 
-        /** Propogates a reflected wave from a WDF ideal current source. */
-        inline T reflected() noexcept
+        /** Computes the reflected wave */
+        inline T reflected() noexcept override
         {
-            wdf.b = twoR_Is + wdf.a;
-            return wdf.b;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            int i = 0;
+            for (auto* port : downPorts)
+            {
+                auto portIndex = getPortIndex (i);
+                a_vec[portIndex] = port->reflected();
+                i++;
+            }
+
+            // S_matrix[m_upPortIndex][m_upPortIndex] is zero, so this is fine without a fresh a_vec[m_upPortIndex].
+            this->wdf.b = rtype_detail::RtypeScatterSingle (S_matrix, a_vec, m_upPortIndex);
+            return this->wdf.b;
         }
 
-        WDFMembers<T> wdf;
+        /** Implement this function to set the scattering matrix when an incoming impedance changes */
+        std::function<T (RtypeAdaptor&)> impedanceCalculator = [] (auto&) { return (T) 1; };
+
+        /** Visits each of the ports connected to this adaptor. */
+        void visitConnectedPorts (typename WDF<T>::PortVisitor& visitor) override
+        {
+            for (auto* port : downPorts)
+                visitor.visit (*port);
+        }
 
     private:
-        const Next& next;
+        int getPortIndex (int vectorIndex)
+        {
+            return vectorIndex < m_upPortIndex ? vectorIndex : vectorIndex + 1;
+        }
 
-        T Is = (T) 0.0;
-        T twoR;
-        T twoR_Is;
+        std::vector<WDF<T>*> downPorts;
+
+        const int m_upPortIndex;
+
+        rtype_detail::Matrix<T> S_matrix; // square matrix representing S
+        rtype_detail::AlignedArray<T> a_vec; // temp matrix of inputs to Rport
+        rtype_detail::AlignedArray<T> b_vec; // temp matrix of outputs from Rport
     };
+} // namespace wdf
+} // namespace chowdsp
 
-    /** WDF Current source with parallel resistance */
-    template <typename T>
-    class ResistiveCurrentSourceT final : public BaseWDF
+#endif //CHOWDSP_WDF_WDF_RTYPE_H
+
+// #include "wdf_fixed_size_rtype.h"
+#ifndef CHOWDSP_WDF_WDF_FIXED_SIZE_RTYPE_H
+#define CHOWDSP_WDF_WDF_FIXED_SIZE_RTYPE_H
+
+#include <algorithm>
+#include <stdexcept>
+// #include "../wdf/wdf_base.h"
+
+// #include "rtype_detail.h"
+
+
+namespace chowdsp
+{
+namespace wdf
+{
+    /**
+     *  A non-adaptable R-Type adaptor, with the number of ports known at compile-time.
+     *
+     *  This works the same way as RootRtypeAdaptor, and can be used in the same run-time
+     *  WDF trees, but the scattering matrix and wave vectors are stored inline (rather
+     *  than on the heap), and the scattering is done with the same fixed-size routines as
+     *  wdft::RootRtypeAdaptor. The impedance calculator is a non-allocating FunctionRef
+     *  rather than a std::function, so a lambda without captures (or a function pointer)
+     *  can be assigned directly. A callable with captures must outlive the adaptor.
+     *
+     *  The list of ports must contain numPorts ports.
+     */
+    template <typename T, int numPorts>
+    class FixedSizeRootRtypeAdaptor : public WDF<T>
     {
     public:
-        /** Creates a new resistive current source.
-         * @param value: initial resistance value, in Ohms
-         */
-        explicit ResistiveCurrentSourceT (T value = NumericType<T> (1.0e9)) : R_value (value)
-        {
-            calcImpedance();
-        }
+        using ImpedanceCalculator = rtype_detail::FunctionRef<void (FixedSizeRootRtypeAdaptor&)>;
 
-        /** Sets the resistance value of the parallel resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        /** Throws std::invalid_argument unless the list contains numPorts (non-null) ports. */
+        FixedSizeRootRtypeAdaptor (std::initializer_list<WDF<T>*> dps)
+            : WDF<T> ("Root R-Type Adaptor")
         {
-            if (all (newR == R_value))
-                return;
+            if ((int) dps.size() != numPorts || std::find (dps.begin(), dps.end(), nullptr) != dps.end())
+                throw std::invalid_argument ("FixedSizeRootRtypeAdaptor needs a list of exactly numPorts ports!");
 
-            R_value = newR;
-            propagateImpedanceChange();
+            std::copy (dps.begin(), dps.end(), downPorts);
+            for (auto* port : downPorts)
+                port->connectToParent (this);
+
+            a_vec.clear();
+            b_vec.clear();
         }
 
-        /** Computes the impedance for a WDF resistive current souce
-         * Z_Ir = Z_R
+        /** Returns the number of ports connected to FixedSizeRootRtypeAdaptor */
+        static constexpr size_t getNumPorts() noexcept { return (size_t) numPorts; }
+
+        /**
+         * Returns the port impedance for the given port index.
+         * Note: it is the caller's responsibility to ensure that the portIndex is in range!
          */
-        inline void calcImpedance() override
+        T getPortImpedance (size_t portIndex) const noexcept { return downPorts[portIndex]->wdf.R; }
+
+        /** Recomputes internal variables based on the incoming impedances */
+        void calcImpedance() override
         {
-            wdf.R = R_value;
-            wdf.G = (T) 1.0 / wdf.R;
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            impedanceCalculator (*this);
         }
 
-        /** Sets the current of the current source, in Amps */
-        void setCurrent (T newI) { Is = newI; }
+        /** Use this function to set the scattering matrix data. */
+        void setSMatrixData (const T (&mat)[numPorts][numPorts])
+        {
+            for (int i = 0; i < numPorts; ++i)
+                for (int j = 0; j < numPorts; ++j)
+                    S_matrix[j][i] = mat[i][j];
+        }
 
-        /** Accepts an incident wave into a WDF resistive current source. */
-        inline void incident (T x) noexcept
+        /** Computes both the incident and reflected waves at this root node. */
+        inline void compute() noexcept
         {
-            wdf.a = x;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            wdft::rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+
+            for (int i = 0; i < numPorts; ++i)
+            {
+                downPorts[i]->incident (b_vec[i]);
+                a_vec[i] = downPorts[i]->reflected();
+            }
         }
 
-        /** Propogates a reflected wave from a WDF resistive current source. */
-        inline T reflected() noexcept
+        /** Implement this function to set the scattering matrix when an incoming impedance changes */
+        ImpedanceCalculator impedanceCalculator = [] (FixedSizeRootRtypeAdaptor&) {};
+
+        /** Visits each of the ports connected to this adaptor. */
+        void visitConnectedPorts (typename WDF<T>::PortVisitor& visitor) override
         {
-            wdf.b = wdf.R * Is;
-            return wdf.b;
+            for (auto* port : downPorts)
+                visitor.visit (*port);
         }
 
-        WDFMembers<T> wdf;
+        /** Visits the incoming waves, which are stored between calls to compute(). */
+        void visitInternalState (typename WDF<T>::StateVisitor& visitor) override
+        {
+            for (int i = 0; i < numPorts; ++i)
+                visitor.visit (a_vec[i]);
+        }
 
     private:
-        T Is = (T) 0.0;
-        T R_value = (T) 1.0e9;
+        void incident (T) noexcept override {}
+        T reflected() noexcept override { return T {}; }
+
+        WDF<T>* downPorts[numPorts] {};
+
+        wdft::rtype_detail::Matrix<T, numPorts> S_matrix; // square matrix representing S
+        wdft::rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
+        wdft::rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
     };
 
-    /** WDF Resistor and Capacitor and Voltage source in Series */
-    template <typename T>
-    class ResistiveCapacitiveVoltageSourceT final : public BaseWDF
+    /**
+     *  An adaptable R-Type adaptor, with the number of ports known at compile-time.
+     *
+     *  This works the same way as RtypeAdaptor, with the same storage as FixedSizeRootRtypeAdaptor.
+     *  numPorts is the size of the scattering matrix, including the upward-facing port, so the list
+     *  of ports must contain numPorts - 1 ports.
+     */
+    template <typename T, int numPorts>
+    class FixedSizeRtypeAdaptor : public WDF<T>
     {
     public:
-        /** Creates a new WDF Resistor/Capacitor Series.
-         * @param cap_value: Resistance value in Ohms
-         * @param res_value: Capacitance value in Farads
-         * @param fs: WDF sample rate
+        using ImpedanceCalculator = rtype_detail::FunctionRef<T (FixedSizeRtypeAdaptor&)>;
+
+        /**
+         * The upPortIndex argument describes with port of the scattering matrix is being adapted.
+         * Throws std::invalid_argument unless the list contains numPorts - 1 (non-null) ports,
+         * and upPortIndex is in the range [0, numPorts).
          */
-        explicit ResistiveCapacitiveVoltageSourceT (T res_value, T cap_value, T fs = (T) 48000.0)
-            : R_value (res_value),
-              C_value (cap_value),
-              tt ((T) 1 / fs)
+        FixedSizeRtypeAdaptor (std::initializer_list<WDF<T>*> dps, int upPortIndex)
+            : WDF<T> ("R-Type Adaptor"),
+              m_upPortIndex (upPortIndex)
         {
-            calcImpedance();
-            reset();
+            if ((int) dps.size() != numDownPorts || std::find (dps.begin(), dps.end(), nullptr) != dps.end())
+                throw std::invalid_argument ("FixedSizeRtypeAdaptor needs a list of exactly numPorts - 1 ports!");
+            if (upPortIndex < 0 || upPortIndex >= numPorts)
+                throw std::invalid_argument ("FixedSizeRtypeAdaptor upPortIndex is out of range!");
+
+            std::copy (dps.begin(), dps.end(), downPorts);
+            for (auto* port : downPorts)
+                port->connectToParent (this);
+
+            a_vec.clear();
+            b_vec.clear();
         }
 
-        /** Prepares the capacitor to operate at a new sample rate */
-        void prepare (T sampleRate)
+        /** Returns the number of ports connected to FixedSizeRtypeAdaptor */
+        static constexpr size_t getNumPorts() noexcept { return (size_t) numPorts; }
+
+        /**
+         * Returns the port impedance for the given port index.
+         * Note: it is the caller's responsibility to ensure that the portIndex is in range!
+         */
+        T getPortImpedance (size_t portIndex) const noexcept { return downPorts[portIndex]->wdf.R; }
+
+        /** Recomputes internal variables based on the incoming impedances */
+        void calcImpedance() override
         {
-            tt = (T) 1 / sampleRate;
-            propagateImpedanceChange();
-
-            reset();
+            CHOWDSP_WDF_INSTRUMENT_COUNT (calcImpedance);
+            this->wdf.R = impedanceCalculator (*this);
+            this->wdf.G = (T) 1 / this->wdf.R;
         }
 
-        /** Resets the capacitor state */
-        void reset()
+        /** Use this function to set the scattering matrix data. */
+        void setSMatrixData (const T (&mat)[numPorts][numPorts])
         {
-            z = 0.0f;
+            for (int i = 0; i < numPorts; ++i)
+                for (int j = 0; j < numPorts; ++j)
+                    S_matrix[j][i] = mat[i][j];
         }
 
-        /** Sets the resistance value of the WDF resistor, in Ohms. */
-        void setResistanceValue (T newR)
+        /** Computes the incident wave. */
+        inline void incident (T downWave) noexcept override
         {
-            if (all (newR == R_value))
-                return;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (incident);
+            this->wdf.a = downWave;
+            a_vec[m_upPortIndex] = this->wdf.a;
 
-            R_value = newR;
-            propagateImpedanceChange();
+            wdft::rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+            for (int i = 0; i < numDownPorts; ++i)
+                downPorts[i]->incident (b_vec[getPortIndex (i)]);
         }
 
-        /** Sets the capacitance value of the WDF capacitor, in Farads. */
-        void setCapacitanceValue (T newC)
+        /** Computes the reflected wave */
+        inline T reflected() noexcept override
         {
-            if (all (newC == C_value))
-                return;
+            CHOWDSP_WDF_INSTRUMENT_TIMED (reflected);
+            for (int i = 0; i < numDownPorts; ++i)
+                a_vec[getPortIndex (i)] = downPorts[i]->reflected();
 
-            C_value = newC;
-            propagateImpedanceChange();
+            // S_matrix[m_upPortIndex][m_upPortIndex] is zero, so this is fine without a fresh a_vec[m_upPortIndex].
+            this->wdf.b = wdft::rtype_detail::RtypeScatterSingle (S_matrix, a_vec, m_upPortIndex);
+            return this->wdf.b;
         }
 
-        /** Sets the voltage of the voltage source, in Volts */
-        void setVoltage (T newV) { Vs = newV; }
+        /** Implement this function to set the scattering matrix when an incoming impedance changes */
+        ImpedanceCalculator impedanceCalculator = [] (FixedSizeRtypeAdaptor&) { return (T) 1; };
 
-        /** Computes the impedance of the WDF resistor/capacitor combination */
-        inline void calcImpedance() override
+        /** Visits each of the ports connected to this adaptor. */
+        void visitConnectedPorts (typename WDF<T>::PortVisitor& visitor) override
         {
-            wdf.R = tt / ((T) 2.0 * C_value) + R_value;
-            wdf.G = (T) 1.0 / wdf.R;
-            T_over_2RC = tt / ((T) 2 * C_value * R_value);
+            for (auto* port : downPorts)
+                visitor.visit (*port);
         }
 
-        /** Accepts an incident wave into the WDF. */
-        inline void incident (T x) noexcept
-        {
-            wdf.a = x;
-            z -= T_over_2RC * (wdf.a - wdf.b);
-        }
+    private:
+        static constexpr int numDownPorts = numPorts - 1;
 
-        /** Propogates a reflected wave from the WDF. */
-        inline T reflected() noexcept
+        int getPortIndex (int arrayIndex) const noexcept
         {
-            wdf.b = -(z + Vs);
-            return wdf.b;
+            return arrayIndex < m_upPortIndex ? arrayIndex : arrayIndex + 1;
         }
 
-        WDFMembers<T> wdf;
-
-    private:
-        T Vs = (T) 0.0;
-        T R_value = (T) 1.0e3;
-        T C_value = (T) 1.0e-6;
-
-        T T_over_2RC = (T) 0.0;
-
-        T z = (T) 0.0;
+        const int m_upPortIndex;
+        WDF<T>* downPorts[numDownPorts] {};
 
-        T tt;
+        wdft::rtype_detail::Matrix<T, numPorts> S_matrix; // square matrix representing S
+        wdft::rtype_detail::AlignedArray<T, numPorts> a_vec; // temp matrix of inputs to Rport
+        wdft::rtype_detail::AlignedArray<T, numPorts> b_vec; // temp matrix of outputs from Rport
     };
-} // namespace wdft
+} // namespace wdf
 } // namespace chowdsp
 
-#endif //CHOWDSP_WDF_WDFT_SOURCES_H
+#endif //CHOWDSP_WDF_WDF_FIXED_SIZE_RTYPE_H
 
-// #include "wdft_adaptors.h"
-#ifndef CHOWDSP_WDF_WDFT_ADAPTORS_H
-#define CHOWDSP_WDF_WDFT_ADAPTORS_H
 
-// #include "wdft_base.h"
+#endif // CHOWDSP_WDF_RTYPE_H_INCLUDED
 
 
+// #include "util/defer_impedance.h"
+#ifndef WAVEDIGITALFILTERS_DEFER_IMPEDANCE_H
+#define WAVEDIGITALFILTERS_DEFER_IMPEDANCE_H
+
 namespace chowdsp
 {
 namespace wdft
 {
-    /** WDF 3-port parallel adaptor */
-    template <typename T, typename Port1Type, typename Port2Type>
-    class WDFParallelT final : public BaseWDF
+    /**
+ * Let's say that you've got some fancy adaptor in your WDF (e.g. an R-Type adaptor),
+ * which requires a somewhat expensive computation to re-calculate the adaptor's impedance.
+ * In that case, you may not want to re-calculate the impedance every time a downstream element
+ * changes its impedance, since the impedance might need to be re-calculated several times.
+ * For that purpose, you can use this class as follows:
+ * ```cpp
+ * class MyWDF
+ * {
+ *   // ...
+ *
+ *   Resistor pot1 {};
+ *   WDFSeries S1 { pot1, ... };
+ *
+ *   Resistor pot2 {};
+ *   WDFParallel P1 { pot2, ... };
+ *
+ *   FancyAdaptor adaptor { std::tie (S1, P1, ...); }; // this adaptor does heavy computation when re-calculating the impedance
+ *
+ * public:
+ *   void setParameters (float pot1Value, float pot2Value)
+ *   {
+ *     {
+ *       // while this object is alive, any impedance changes that are propagated
+ *       // to S1 will cause S1 to recompute its impedance, but will not allow impeance
+ *       // changes to be propagated any further up the tree, and the same for P1.
+ *
+ *       ScopedDeferImpedancePropagation deferImpedance { S1, P1 };
+ *       pot1.setResistanceValue (pot1Value);
+ *       pot2.setResistanceValue (pot2Value);
+ *     }
+ *
+ *     // Now we must manually tell the fancyAdaptor that downstream impedances have changed:
+ *     fancyAdaptor.propagateImpedanceChange();
+ *   }
+ * }
+ * ```
+ */
+    template <typename... Elements>
+    class ScopedDeferImpedancePropagation
     {
     public:
-        /** Creates a new WDF parallel adaptor from two connected ports. */
-        WDFParallelT (Port1Type& p1, Port2Type& p2) : port1 (p1),
-                                                      port2 (p2)
+        explicit ScopedDeferImpedancePropagation (Elements&... elems) : elements (std::tie (elems...))
         {
-            port1.connectToParent (this);
-            port2.connectToParent (this);
-            calcImpedance();
-        }
+#if __cplusplus >= 201703L // With C++17 and later, it's easy to assert that all the elements are derived from BaseWDF
+            static_assert ((std::is_base_of<BaseWDF, Elements>::value && ...), "All element types must be derived from BaseWDF");
+#endif
 
-        /** Computes the impedance for a WDF parallel adaptor.
-         *  1     1     1
-         * --- = --- + ---
-         * Z_p   Z_1   Z_2
-         */
-        inline void calcImpedance() override
-        {
-            wdf.G = port1.wdf.G + port2.wdf.G;
-            wdf.R = (T) 1.0 / wdf.G;
-            port1Reflect = port1.wdf.G / wdf.G;
+            rtype_detail::forEachInTuple (
+                [] (auto& el, size_t) {
+                    el.dontPropagateImpedance = true;
+                },
+                elements);
         }
 
-        /** Accepts an incident wave into a WDF parallel adaptor. */
-        inline void incident (T x) noexcept
+        ~ScopedDeferImpedancePropagation()
         {
-            const auto b2 = wdf.b - port2.wdf.b + x;
-            port1.incident (b2 + bDiff);
-            port2.incident (b2);
-
-            wdf.a = x;
+            rtype_detail::forEachInTuple (
+                [] (auto& el, size_t) {
+                    el.dontPropagateImpedance = false;
+                    CHOWDSP_WDF_TRACE_DEFERRED_CALC (el);
+                    el.calcImpedance();
+                    CHOWDSP_WDF_TRACE_CALC_DONE();
+                },
+                elements);
         }
 
-        /** Propogates a reflected wave from a WDF parallel adaptor. */
-        inline T reflected() noexcept
-        {
-            port1.reflected();
-            port2.reflected();
+    private:
+        std::tuple<Elements&...> elements;
+    };
+} // namespace wdft
+} // namespace chowdsp
 
-            bDiff = port2.wdf.b - port1.wdf.b;
-            wdf.b = port2.wdf.b - port1Reflect * bDiff;
+#endif //WAVEDIGITALFILTERS_DEFER_IMPEDANCE_H
 
-            return wdf.b;
-        }
+// #include "util/circuit_state.h"
+#ifndef CHOWDSP_WDF_CIRCUIT_STATE_H
+#define CHOWDSP_WDF_CIRCUIT_STATE_H
 
-        Port1Type& port1;
-        Port2Type& port2;
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-        WDFMembers<T> wdf;
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace state_detail
+    {
+        template <typename...>
+        using void_t = void;
 
-    private:
-        T port1Reflect = (T) 1.0;
-        T bDiff = (T) 0.0;
-    };
+        template <typename ElementType, typename = void>
+        struct HasWDFMembers : std::false_type
+        {
+        };
 
-    /** WDF 3-port series adaptor */
-    template <typename T, typename Port1Type, typename Port2Type>
-    class WDFSeriesT final : public BaseWDF
-    {
-    public:
-        /** Creates a new WDF series adaptor from two connected ports. */
-        WDFSeriesT (Port1Type& p1, Port2Type& p2) : port1 (p1),
-                                                    port2 (p2)
+        template <typename ElementType>
+        struct HasWDFMembers<ElementType, void_t<decltype (std::declval<ElementType&>().wdf.a)>> : std::true_type
         {
-            port1.connectToParent (this);
-            port2.connectToParent (this);
-            calcImpedance();
-        }
+        };
 
-        /** Computes the impedance for a WDF parallel adaptor.
-         * Z_s = Z_1 + Z_2
-         */
-        inline void calcImpedance() override
+        template <typename ElementType, typename Visitor>
+        std::enable_if_t<HasWDFMembers<ElementType>::value> visitWaves (ElementType& element, Visitor& visitor)
         {
-            wdf.R = port1.wdf.R + port2.wdf.R;
-            wdf.G = (T) 1.0 / wdf.R;
-            port1Reflect = port1.wdf.R / wdf.R;
+            visitor (element.wdf.a);
+            visitor (element.wdf.b);
         }
 
-        /** Accepts an incident wave into a WDF series adaptor. */
-        inline void incident (T x) noexcept
+        template <typename ElementType, typename Visitor>
+        std::enable_if_t<! HasWDFMembers<ElementType>::value> visitWaves (ElementType&, Visitor&)
         {
-            const auto b1 = port1.wdf.b - port1Reflect * (x + port1.wdf.b + port2.wdf.b);
-            port1.incident (b1);
-            port2.incident (-(x + b1));
-
-            wdf.a = x;
         }
 
-        /** Propogates a reflected wave from a WDF series adaptor. */
-        inline T reflected() noexcept
+        /** Rounds the offset up to the alignment of the state variable type */
+        template <typename StateType>
+        constexpr size_t alignOffset (size_t offset) noexcept
         {
-            wdf.b = -(port1.reflected() + port2.reflected());
-            return wdf.b;
+            return (offset + alignof (StateType) - 1) / alignof (StateType) * alignof (StateType);
         }
+    } // namespace state_detail
+#endif // DOXYGEN
 
-        Port1Type& port1;
-        Port2Type& port2;
+    /**
+     * Calls visitor with a reference to every state variable in the circuit:
+     * that is, the incident and reflected waves of each element, plus any internal
+     * state variables (capacitor states, R-Type adaptor inputs, etc.).
+     *
+     * The variables are always visited in the same order for a given circuit.
+     * Note that circuit inputs (e.g. source voltages) are not considered to be state.
+     */
+    template <typename RootType, typename Visitor>
+    void visitCircuitState (RootType& root, Visitor&& visitor)
+    {
+        forEachElement (root,
+                        [&visitor] (auto& element)
+                        {
+                            state_detail::visitWaves (element, visitor);
+                            element.visitState (visitor);
+                        });
+    }
 
-        WDFMembers<T> wdf;
+    /** Returns the number of bytes needed to store the state of the circuit. */
+    template <typename RootType>
+    size_t getStateSizeBytes (RootType& root)
+    {
+        size_t numBytes = 0;
+        visitCircuitState (root,
+                           [&numBytes] (auto& x)
+                           {
+                               using StateType = std::remove_reference_t<decltype (x)>;
+                               numBytes = state_detail::alignOffset<StateType> (numBytes) + sizeof (StateType);
+                           });
+        return numBytes;
+    }
 
-    private:
-        T port1Reflect = (T) 1.0;
-    };
+    /**
+     * Copies the state of the circuit into the given memory,
+     * which must be at least getStateSizeBytes (root) bytes long.
+     */
+    template <typename RootType>
+    void saveState (RootType& root, void* data) noexcept
+    {
+        auto* bytes = static_cast<unsigned char*> (data);
+        size_t offset = 0;
+        visitCircuitState (root,
+                           [bytes, &offset] (auto& x)
+                           {
+                               using StateType = std::remove_reference_t<decltype (x)>;
+                               static_assert (std::is_trivially_copyable<StateType>::value, "State variables must be trivially copyable!");
+
+                               offset = state_detail::alignOffset<StateType> (offset);
+                               std::memcpy (bytes + offset, &x, sizeof (StateType));
+                               offset += sizeof (StateType);
+                           });
+    }
 
-    /** WDF Voltage Polarity Inverter */
-    template <typename T, typename PortType>
-    class PolarityInverterT final : public BaseWDF
+    /** Restores the state of the circuit from memory that was written by saveState(). */
+    template <typename RootType>
+    void loadState (RootType& root, const void* data) noexcept
     {
-    public:
-        /** Creates a new WDF polarity inverter */
-        explicit PolarityInverterT (PortType& p) : port1 (p)
-        {
-            port1.connectToParent (this);
-            calcImpedance();
-        }
+        const auto* bytes = static_cast<const unsigned char*> (data);
+        size_t offset = 0;
+        visitCircuitState (root,
+                           [bytes, &offset] (auto& x)
+                           {
+                               using StateType = std::remove_reference_t<decltype (x)>;
+                               static_assert (std::is_trivially_copyable<StateType>::value, "State variables must be trivially copyable!");
+
+                               offset = state_detail::alignOffset<StateType> (offset);
+                               std::memcpy (&x, bytes + offset, sizeof (StateType));
+                               offset += sizeof (StateType);
+                           });
+    }
+
+    /**
+     * A SIMD-aligned block of memory for storing the state of a circuit.
+     *
+     * The buffer should be allocated when preparing the circuit, after which
+     * the state can be saved and loaded without any memory allocation, e.g.
+     * ```cpp
+     * // in prepare()...
+     * for (auto& voiceState : voiceStates)
+     *     voiceState.allocate (circuit.root);
+     *
+     * // on the audio thread...
+     * saveState (circuit.root, voiceStates[oldVoice]);
+     * loadState (circuit.root, voiceStates[newVoice]);
+     * ```
+     */
+    class CircuitStateBuffer
+    {
+    public:
+        CircuitStateBuffer() = default;
 
-        /** Calculates the impedance of the WDF inverter
-         * (same impedance as the connected node).
-         */
-        inline void calcImpedance() override
+        /** Allocates a buffer large enough for the state of the given circuit. */
+        template <typename RootType>
+        explicit CircuitStateBuffer (RootType& root)
         {
-            wdf.R = port1.wdf.R;
-            wdf.G = (T) 1.0 / wdf.R;
+            allocate (root);
         }
 
-        /** Accepts an incident wave into a WDF inverter. */
-        inline void incident (T x) noexcept
+        /** Copies the state data into a new (aligned) allocation. */
+        CircuitStateBuffer (const CircuitStateBuffer& other)
         {
-            wdf.a = x;
-            port1.incident (-x);
+            copyFrom (other);
         }
 
-        /** Propogates a reflected wave from a WDF inverter. */
-        inline T reflected() noexcept
+        /** Copies the state data into a new (aligned) allocation. */
+        CircuitStateBuffer& operator= (const CircuitStateBuffer& other)
         {
-            wdf.b = -port1.reflected();
-            return wdf.b;
+            if (this != &other)
+                copyFrom (other);
+            return *this;
         }
 
-        WDFMembers<T> wdf;
-
-    private:
-        PortType& port1;
-    };
-
-    /** WDF y-parameter 2-port (short circuit admittance) */
-    template <typename T, typename PortType>
-    class YParameterT final : public BaseWDF
-    {
-    public:
-        /** Creates a new WDF Y-Parameter, with the given coefficients */
-        YParameterT (PortType& port1, T y11, T y12, T y21, T y22) : port1 (port1)
+        CircuitStateBuffer (CircuitStateBuffer&& other) noexcept
+            : storage (std::move (other.storage)),
+              offset (std::exchange (other.offset, (size_t) 0)),
+              numBytes (std::exchange (other.numBytes, (size_t) 0))
         {
-            y[0][0] = y11;
-            y[0][1] = y12;
-            y[1][0] = y21;
-            y[1][1] = y22;
-
-            port1.connectToParent (this);
-            calcImpedance();
         }
 
-        /** Calculates the impedance of the WDF Y-Parameter */
-        inline void calcImpedance() override
+        CircuitStateBuffer& operator= (CircuitStateBuffer&& other) noexcept
         {
-            denominator = y[1][1] + port1.wdf.R * y[0][0] * y[1][1] - port1.wdf.R * y[0][1] * y[1][0];
-            wdf.R = (port1.wdf.R * y[0][0] + (T) 1.0) / denominator;
-            wdf.G = (T) 1.0 / wdf.R;
-
-            T rSq = port1.wdf.R * port1.wdf.R;
-            T num1A = -y[1][1] * rSq * y[0][0] * y[0][0];
-            T num2A = y[0][1] * y[1][0] * rSq * y[0][0];
-
-            A = (num1A + num2A + y[1][1]) / (denominator * (port1.wdf.R * y[0][0] + (T) 1.0));
-            B = -port1.wdf.R * y[0][1] / (port1.wdf.R * y[0][0] + (T) 1.0);
-            C = -y[1][0] / denominator;
+            storage = std::move (other.storage);
+            offset = std::exchange (other.offset, (size_t) 0);
+            numBytes = std::exchange (other.numBytes, (size_t) 0);
+            return *this;
         }
 
-        /** Accepts an incident wave into a WDF Y-Parameter. */
-        inline void incident (T x) noexcept
+        /** Allocates a buffer large enough for the state of the given circuit. */
+        template <typename RootType>
+        void allocate (RootType& root)
         {
-            wdf.a = x;
-            port1.incident (A * port1.wdf.b + B * x);
+            allocateBytes (getStateSizeBytes (root));
         }
 
-        /** Propogates a reflected wave from a WDF Y-Parameter. */
-        inline T reflected() noexcept
+        /** Allocates a zero-initialised buffer with the given number of bytes. */
+        void allocateBytes (size_t numBytesToAllocate)
         {
-            wdf.b = C * port1.reflected();
-            return wdf.b;
+            numBytes = numBytesToAllocate;
+            storage.assign (numBytes + (size_t) alignment, 0);
+
+            const auto address = reinterpret_cast<uintptr_t> (storage.data());
+            offset = (size_t) ((alignment - address % alignment) % alignment);
         }
 
-        WDFMembers<T> wdf;
+        /** Returns a pointer to the (aligned) state data. */
+        void* data() noexcept { return storage.data() + offset; }
 
-    private:
-        PortType& port1;
-        T y[2][2] = { { (T) 0.0, (T) 0.0 }, { (T) 0.0, (T) 0.0 } };
+        /** Returns a pointer to the (aligned) state data. */
+        const void* data() const noexcept { return storage.data() + offset; }
 
-        T denominator = (T) 1.0;
-        T A = (T) 1.0;
-        T B = (T) 1.0;
-        T C = (T) 1.0;
-    };
+        /** Returns the size of the state data in bytes. */
+        size_t size() const noexcept { return numBytes; }
 
-    // useful "factory" functions so you don't have to declare all the template parameters
+        /** The alignment of the state data. */
+        static constexpr uintptr_t alignment = CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT > alignof (std::max_align_t)
+                                                   ? (uintptr_t) CHOWDSP_WDF_DEFAULT_SIMD_ALIGNMENT
+                                                   : (uintptr_t) alignof (std::max_align_t);
 
-    /** Factory method for creating a parallel adaptor between two elements. */
-    template <typename T, typename P1Type, typename P2Type>
-    CHOWDSP_WDF_MAYBE_UNUSED WDFParallelT<T, P1Type, P2Type> makeParallel (P1Type& p1, P2Type& p2)
-    {
-        return WDFParallelT<T, P1Type, P2Type> (p1, p2);
-    }
+    private:
+        /** The offset of the aligned data depends on the address of the allocation, so it can't be copied as-is */
+        void copyFrom (const CircuitStateBuffer& other)
+        {
+            allocateBytes (other.numBytes);
+            if (numBytes > 0)
+                std::memcpy (data(), other.data(), numBytes);
+        }
 
-    /** Factory method for creating a series adaptor between two elements. */
-    template <typename T, typename P1Type, typename P2Type>
-    CHOWDSP_WDF_MAYBE_UNUSED WDFSeriesT<T, P1Type, P2Type> makeSeries (P1Type& p1, P2Type& p2)
+        std::vector<unsigned char> storage;
+        size_t offset = 0;
+        size_t numBytes = 0;
+    };
+
+    /** Copies the state of the circuit into the state buffer. */
+    template <typename RootType>
+    void saveState (RootType& root, CircuitStateBuffer& buffer) noexcept
     {
-        return WDFSeriesT<T, P1Type, P2Type> (p1, p2);
+        saveState (root, buffer.data());
     }
 
-    /** Factory method for creating a polarity inverter. */
-    template <typename T, typename PType>
-    CHOWDSP_WDF_MAYBE_UNUSED PolarityInverterT<T, PType> makeInverter (PType& p1)
+    /** Restores the state of the circuit from the state buffer. */
+    template <typename RootType>
+    void loadState (RootType& root, const CircuitStateBuffer& buffer) noexcept
     {
-        return PolarityInverterT<T, PType> (p1);
+        loadState (root, buffer.data());
     }
 } // namespace wdft
 } // namespace chowdsp
 
-#endif //CHOWDSP_WDF_WDFT_ADAPTORS_H
+#endif //CHOWDSP_WDF_CIRCUIT_STATE_H
 
-// #include "wdft_nonlinearities.h"
-#ifndef CHOWDSP_WDF_WDFT_NONLINEARITIES_H
-#define CHOWDSP_WDF_WDFT_NONLINEARITIES_H
+// #include "util/dc_operating_point.h"
+#ifndef CHOWDSP_WDF_DC_OPERATING_POINT_H
+#define CHOWDSP_WDF_DC_OPERATING_POINT_H
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-// #include "wdft_base.h"
-
-
-// #include "../math/signum.h"
+// #include "circuit_state.h"
 
 
 namespace chowdsp
 {
-/** Methods for implementing the signum function */
-namespace signum
+namespace wdft
 {
-    /** Signum function to determine the sign of the input. */
-    template <typename T>
-    inline int signum (T val)
-    {
-        return (T (0) < val) - (val < T (0));
-    }
-
-#if defined(XSIMD_HPP)
-    /** Signum function to determine the sign of the input. */
-    template <typename T>
-    inline xsimd::batch<T> signum (xsimd::batch<T> val)
+#ifndef DOXYGEN
+    namespace dc_detail
     {
-        using v_type = xsimd::batch<T>;
-        const auto positive = xsimd::select (val > v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
-        const auto negative = xsimd::select (val < v_type ((T) 0), v_type ((T) 1), v_type ((T) 0));
-        return positive - negative;
-    }
-#endif
+        template <typename T>
+        std::enable_if_t<std::is_arithmetic<T>::value, double> getValue (const T& x) noexcept
+        {
+            return (double) x;
+        }
 
-} // namespace signum
-} // namespace chowdsp
+        template <typename T>
+        std::enable_if_t<std::is_arithmetic<T>::value> setValue (T& x, double value) noexcept
+        {
+            x = (T) value;
+        }
 
-// #include "../math/omega.h"
-/*
- * Copyright (C) 2019 Stefano D'Angelo
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
- * 
- * NOTE: code has been modified significantly by Jatin Chowdhury
- */
+        template <typename T>
+        double getValue (const CompensatedFloat<T>& x) noexcept
+        {
+            return (double) x.hi + (double) x.lo;
+        }
 
-#ifndef OMEGA_H_INCLUDED
-#define OMEGA_H_INCLUDED
+        template <typename T>
+        void setValue (CompensatedFloat<T>& x, double value) noexcept
+        {
+            x.hi = (T) value;
+            x.lo = (T) (value - (double) x.hi);
+        }
 
-#include <algorithm>
-#include <cstdint>
-#include <cstddef>
-// #include "sample_type.h"
+        /**
+         * The finite-difference step size for a given state variable type (relative to the state value).
+         * We use a larger step than usual, since the rounding errors in the circuit can be amplified
+         * by the slow modes of the circuit (e.g. large capacitors), and the Jacobian is exact for linear circuits.
+         */
+        template <typename T>
+        std::enable_if_t<std::is_arithmetic<T>::value, double> perturbationSize (const T&) noexcept
+        {
+            return std::cbrt ((double) std::numeric_limits<std::conditional_t<std::is_floating_point<T>::value, T, double>>::epsilon());
+        }
 
+        template <typename T>
+        double perturbationSize (const CompensatedFloat<T>&) noexcept
+        {
+            return std::cbrt ((double) std::numeric_limits<T>::epsilon() * std::numeric_limits<T>::epsilon());
+        }
+    } // namespace dc_detail
+#endif // DOXYGEN
 
-namespace chowdsp
-{
-/**
- * Useful approximations for evaluating the Wright Omega function.
- *
- * This approach was devloped by Stefano D'Angelo, and adapted from his
- * original implementation under the MIT license.
- * - Paper: https://www.dafx.de/paper-archive/2019/DAFx2019_paper_5.pdf
- * - Original Source: https://www.dangelo.audio/dafx2019-omega.html
- */
-namespace Omega
-{
     /**
-     * Evaluates a polynomial of a given order, using Estrin's scheme.
-     * Coefficients should be given in the form { a_n, a_n-1, ..., a_1, a_0 }
-     * https://en.wikipedia.org/wiki/Estrin%27s_scheme
+     * Computes the DC operating point of a circuit, and initialises the states of
+     * the circuit elements to that operating point, so that the circuit does not
+     * need to be "warmed up" by processing audio.
+     *
+     * With the bilinear transform, a capacitor with a constant voltage reflects its
+     * incident wave (i.e. an open circuit), and an inductor with a constant current
+     * inverts its incident wave (i.e. a short circuit). So the DC operating point is
+     * exactly the fixed point of the circuit's per-sample processing with a constant
+     * input. The fixed point is found using Newton's method, with the Jacobian of the
+     * per-sample processing computed by perturbing the circuit state.
+     *
+     * For linear circuits the solver converges in a single iteration, while circuits
+     * with nonlinear root elements (e.g. diodes) typically converge in a handful
+     * of iterations.
+     *
+     * The solver only supports circuits with scalar (i.e. non-SIMD) state variables.
+     * All memory is allocated in prepare(), so settle() may be called from the audio thread,
+     * although the cost is roughly (N + 1) samples of processing per iteration for a
+     * circuit with N state variables, plus an N x N linear solve.
+     *
+     * ```cpp
+     * DCOperatingPointSolver dcSolver;
+     * dcSolver.prepare (circuit.root);
+     *
+     * // later...
+     * circuit.reset();
+     * dcSolver.settle (circuit.root, [&] { circuit.processSample (0.0f); });
+     * ```
      */
-    template <int ORDER, typename T, typename X>
-    inline typename std::enable_if<(ORDER == 1), decltype (T {} * X {})>::type estrin (const T (&coeffs)[ORDER + 1], const X& x)
+    class DCOperatingPointSolver
     {
-        return coeffs[1] + coeffs[0] * x;
-    }
+    public:
+        DCOperatingPointSolver() = default;
+
+        /** Allocates the memory needed to solve for the operating point of this circuit. */
+        template <typename RootType>
+        void prepare (RootType& root)
+        {
+            size_t numStates = 0;
+            perturbationSize = 0.0;
+            visitCircuitState (root,
+                               [this, &numStates] (auto& s)
+                               {
+                                   numStates++;
+                                   perturbationSize = std::max (perturbationSize, dc_detail::perturbationSize (s));
+                               });
+
+            // if the residual stops improving, we accept the solution as long as the
+            // change in state over one sample is roughly within the rounding noise
+            noiseTolerance = perturbationSize * perturbationSize;
+
+            x.resize (numStates, 0.0);
+            trial.resize (numStates, 0.0);
+            residual.resize (numStates, 0.0);
+            trialResidual.resize (numStates, 0.0);
+            step.resize (numStates, 0.0);
+            jacobian.resize (numStates * numStates, 0.0);
+            pivotColumns.resize (numStates, 0);
+            originalState.allocate (root);
+        }
 
-    template <int ORDER, typename T, typename X>
-    inline typename std::enable_if<(ORDER > 1), decltype (T {} * X {})>::type estrin (const T (&coeffs)[ORDER + 1], const X& x)
+        /**
+         * Solves for the DC operating point, and sets the circuit state to that operating point.
+         *
+         * @param root              the root of the WDF tree.
+         * @param processSample     a function which processes one sample of the circuit, with
+         *                          the input (and bias) voltages/currents set to their DC values.
+         * @return                  true if the solver converged. If the solver fails to converge,
+         *                          the circuit state is restored to what it was before the call.
+         */
+        template <typename RootType, typename ProcessFunc>
+        bool settle (RootType& root, ProcessFunc&& processSample) noexcept
+        {
+            saveState (root, originalState);
+            readState (root, x);
+
+            auto residualNorm = computeResidual (root, processSample, x, residual);
+            for (int iter = 0; iter < maxIterations; ++iter)
+            {
+                const auto scale = 1.0 + maxAbs (x);
+                if (residualNorm == 0.0)
+                {
+                    writeState (root, x);
+                    return true;
+                }
+
+                computeJacobian (root, processSample);
+                solveNewtonStep();
+
+                // take the Newton step, backtracking if the residual doesn't decrease
+                auto stepScale = 1.0;
+                auto foundBetterState = false;
+                for (int backtrack = 0; backtrack <= maxBacktracks; ++backtrack)
+                {
+                    for (size_t i = 0; i < x.size(); ++i)
+                        trial[i] = x[i] + stepScale * step[i];
+
+                    const auto trialResidualNorm = computeResidual (root, processSample, trial, trialResidual);
+                    if (trialResidualNorm < residualNorm)
+                    {
+                        residualNorm = trialResidualNorm;
+                        std::swap (x, trial);
+                        std::swap (residual, trialResidual);
+                        foundBetterState = true;
+                        break;
+                    }
+
+                    stepScale *= 0.5;
+                }
+
+                // The step was either small enough that we've converged, or we've
+                // hit the limit of what the circuit's floating-point precision can resolve.
+                const auto stepNorm = stepScale * maxAbs (step);
+                if ((foundBetterState && stepNorm <= tolerance * scale)
+                    || (! foundBetterState && residualNorm <= noiseTolerance * scale))
+                {
+                    writeState (root, x);
+                    return true;
+                }
+
+                if (! foundBetterState)
+                    break;
+            }
+
+            loadState (root, originalState);
+            return false;
+        }
+
+        /** Returns the number of state variables in the prepared circuit. */
+        size_t getNumStates() const noexcept { return x.size(); }
+
+        /** The maximum number of Newton iterations */
+        int maxIterations = 50;
+
+        /** The maximum number of times that a Newton step can be halved */
+        int maxBacktracks = 8;
+
+        /** The solver has converged when the Newton step is smaller than tolerance * (1 + max(|state|)) */
+        double tolerance = 1.0e-9;
+
+    private:
+        template <typename RootType>
+        static void readState (RootType& root, std::vector<double>& dest) noexcept
+        {
+            size_t index = 0;
+            visitCircuitState (root, [&dest, &index] (auto& s)
+                               { dest[index++] = dc_detail::getValue (s); });
+        }
+
+        template <typename RootType>
+        static void writeState (RootType& root, const std::vector<double>& source) noexcept
+        {
+            size_t index = 0;
+            visitCircuitState (root, [&source, &index] (auto& s)
+                               { dc_detail::setValue (s, source[index++]); });
+        }
+
+        static double maxAbs (const std::vector<double>& vec) noexcept
+        {
+            double result = 0.0;
+            for (auto v : vec)
+                result = std::max (result, std::abs (v));
+            return result;
+        }
+
+        /** Computes F(state) = step(state) - state, and returns max |F| */
+        template <typename RootType, typename ProcessFunc>
+        static double computeResidual (RootType& root, ProcessFunc& processSample, const std::vector<double>& state, std::vector<double>& result) noexcept
+        {
+            writeState (root, state);
+            processSample();
+            readState (root, result);
+
+            double norm = 0.0;
+            for (size_t i = 0; i < state.size(); ++i)
+            {
+                result[i] -= state[i];
+                if (! std::isfinite (result[i]))
+                    return std::numeric_limits<double>::infinity();
+                norm = std::max (norm, std::abs (result[i]));
+            }
+
+            return norm;
+        }
+
+        /** Computes J = dF/dx column by column, using forward differences */
+        template <typename RootType, typename ProcessFunc>
+        void computeJacobian (RootType& root, ProcessFunc& processSample) noexcept
+        {
+            const auto N = x.size();
+            for (size_t j = 0; j < N; ++j)
+            {
+                const auto xj = x[j];
+                const auto h = perturbationSize * std::max (1.0, std::abs (xj));
+                x[j] = xj + h;
+                computeResidual (root, processSample, x, trialResidual);
+                x[j] = xj;
+
+                for (size_t i = 0; i < N; ++i)
+                    jacobian[i * N + j] = (trialResidual[i] - residual[i]) / h;
+            }
+        }
+
+        /**
+         * Solves J * step = -F with Gaussian elimination and partial pivoting.
+         * State variables that the DC solution does not depend on (e.g. the voltage
+         * of a floating capacitor) lead to singular columns, so those variables are
+         * left unchanged.
+         */
+        void solveNewtonStep() noexcept
+        {
+            const auto N = x.size();
+            auto* M = jacobian.data();
+            for (size_t i = 0; i < N; ++i)
+                trial[i] = -residual[i];
+
+            double scale = 0.0;
+            for (size_t i = 0; i < N * N; ++i)
+                scale = std::max (scale, std::abs (M[i]));
+            const auto pivotThreshold = scale * 1.0e-10;
+
+            size_t rank = 0;
+            for (size_t k = 0; k < N && rank < N; ++k)
+            {
+                auto pivotRow = rank;
+                for (auto i = rank + 1; i < N; ++i)
+                    if (std::abs (M[i * N + k]) > std::abs (M[pivotRow * N + k]))
+                        pivotRow = i;
+
+                if (std::abs (M[pivotRow * N + k]) <= pivotThreshold)
+                    continue; // singular column
+
+                if (pivotRow != rank)
+                {
+                    for (size_t c = 0; c < N; ++c)
+                        std::swap (M[rank * N + c], M[pivotRow * N + c]);
+                    std::swap (trial[rank], trial[pivotRow]);
+                }
+
+                for (auto i = rank + 1; i < N; ++i)
+                {
+                    const auto factor = M[i * N + k] / M[rank * N + k];
+                    if (factor == 0.0)
+                        continue;
+
+                    for (auto c = k; c < N; ++c)
+                        M[i * N + c] -= factor * M[rank * N + c];
+                    trial[i] -= factor * trial[rank];
+                }
+
+                pivotColumns[rank++] = k;
+            }
+
+            // back-substitution, with the variables in singular columns left unchanged
+            std::fill (step.begin(), step.end(), 0.0);
+            for (auto r = rank; r-- > 0;)
+            {
+                const auto k = pivotColumns[r];
+                auto sum = trial[r];
+                for (auto c = k + 1; c < N; ++c)
+                    sum -= M[r * N + c] * step[c];
+                step[k] = sum / M[r * N + k];
+            }
+        }
+
+        double perturbationSize = 0.0;
+        double noiseTolerance = 0.0;
+
+        std::vector<double> x;
+        std::vector<double> trial;
+        std::vector<double> residual;
+        std::vector<double> trialResidual;
+        std::vector<double> step;
+        std::vector<double> jacobian;
+        std::vector<size_t> pivotColumns;
+
+        CircuitStateBuffer originalState;
+    };
+
+    /**
+     * Sets the circuit state to its DC operating point. This is a convenience
+     * wrapper around DCOperatingPointSolver, which allocates memory for the solver.
+     */
+    template <typename RootType, typename ProcessFunc>
+    bool settleToDC (RootType& root, ProcessFunc&& processSample)
     {
-        decltype (T {} * X {}) temp[ORDER / 2 + 1];
-        for (int n = ORDER; n >= 0; n -= 2)
-            temp[n / 2] = coeffs[n] + coeffs[n - 1] * x;
+        DCOperatingPointSolver solver;
+        solver.prepare (root);
+        return solver.settle (root, std::forward<ProcessFunc> (processSample));
+    }
+} // namespace wdft
+} // namespace chowdsp
 
-        temp[0] = (ORDER % 2 == 0) ? coeffs[0] : temp[0];
+#endif //CHOWDSP_WDF_DC_OPERATING_POINT_H
 
-        return estrin<ORDER / 2> (temp, x * x); // recurse!
-    }
+// #include "util/scoped_no_denormals.h"
+#ifndef CHOWDSP_WDF_SCOPED_NO_DENORMALS_H
+#define CHOWDSP_WDF_SCOPED_NO_DENORMALS_H
 
-    /** approximation for log_2(x), optimized on the range [1, 2] */
-    template <typename T>
-    constexpr T log2_approx (T x)
-    {
-        constexpr auto alpha = (T) 0.1640425613334452;
-        constexpr auto beta = (T) -1.098865286222744;
-        constexpr auto gamma = (T) 3.148297929334117;
-        constexpr auto zeta = (T) -2.213475204444817;
+#include <cstdint>
 
-        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
-    }
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP > 0)
+#include <xmmintrin.h>
+#define CHOWDSP_WDF_DENORMALS_USE_MXCSR 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHOWDSP_WDF_DENORMALS_USE_FPCR 1
+#endif
 
-#if defined(XSIMD_HPP)
-    /** approximation for log_2(x), optimized on the range [1, 2] */
-    template <typename T>
-    inline xsimd::batch<T> log2_approx (const xsimd::batch<T>& x)
+namespace chowdsp
+{
+namespace wdft
+{
+    /**
+     * While an object of this type is in scope, the CPU will flush denormal
+     * floating-point numbers to zero (i.e. the FTZ/DAZ flags are set on x86,
+     * and the FZ flag is set on ARM64). The previous floating-point control
+     * state is restored when the object is destroyed.
+     *
+     * WDF models with reactive elements can decay into the denormal range once
+     * the input falls silent, which can cause large CPU spikes on some platforms.
+     * If you don't already have something like this in your audio callback,
+     * you probably want to do something like:
+     * ```cpp
+     * void processBlock (float* data, int numSamples)
+     * {
+     *     wdft::ScopedNoDenormals noDenormals;
+     *     for (int n = 0; n < numSamples; ++n)
+     *         data[n] = myWDF.processSample (data[n]);
+     * }
+     * ```
+     *
+     * On platforms where the flags are not supported, this class does nothing,
+     * in which case you may want to enable CHOWDSP_WDF_FLUSH_DENORMALS instead.
+     */
+    class ScopedNoDenormals
     {
-        static constexpr auto alpha = (NumericType<T>) 0.1640425613334452;
-        static constexpr auto beta = (NumericType<T>) -1.098865286222744;
-        static constexpr auto gamma = (NumericType<T>) 3.148297929334117;
-        static constexpr auto zeta = (NumericType<T>) -2.213475204444817;
+    public:
+        ScopedNoDenormals() noexcept
+        {
+#if CHOWDSP_WDF_DENORMALS_USE_MXCSR
+            prevState = (intptr_t) _mm_getcsr();
+            _mm_setcsr ((unsigned int) prevState | 0x8040u); // FTZ | DAZ
+#elif CHOWDSP_WDF_DENORMALS_USE_FPCR
+            prevState = getFPCR();
+            setFPCR (prevState | (intptr_t) (1 << 24)); // FZ
+#endif
+        }
 
-        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
-    }
+        ~ScopedNoDenormals() noexcept
+        {
+#if CHOWDSP_WDF_DENORMALS_USE_MXCSR
+            _mm_setcsr ((unsigned int) prevState);
+#elif CHOWDSP_WDF_DENORMALS_USE_FPCR
+            setFPCR (prevState);
 #endif
+        }
 
-    /** approximation for log(x) */
-    template <typename T>
-    constexpr T log_approx (T x);
+        ScopedNoDenormals (const ScopedNoDenormals&) = delete;
+        ScopedNoDenormals& operator= (const ScopedNoDenormals&) = delete;
 
-    /** approximation for log(x) (32-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED constexpr float log_approx (float x)
-    {
-        union
+        /** Returns true if this class is able to flush denormals on the current platform */
+        static constexpr bool isSupported() noexcept
         {
-            int32_t i;
-            float f;
-        } v {};
-        v.f = x;
-        int32_t ex = v.i & 0x7f800000;
-        int32_t e = (ex >> 23) - 127;
-        v.i = (v.i - ex) | 0x3f800000;
+#if CHOWDSP_WDF_DENORMALS_USE_MXCSR || CHOWDSP_WDF_DENORMALS_USE_FPCR
+            return true;
+#else
+            return false;
+#endif
+        }
 
-        return 0.693147180559945f * ((float) e + log2_approx<float> (v.f));
-    }
+    private:
+#if CHOWDSP_WDF_DENORMALS_USE_FPCR
+        static inline intptr_t getFPCR() noexcept
+        {
+            intptr_t fpcr;
+            asm volatile("mrs %0, fpcr"
+                         : "=r"(fpcr));
+            return fpcr;
+        }
 
-    /** approximation for log(x) (64-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED constexpr double log_approx (double x)
-    {
-        union
+        static inline void setFPCR (intptr_t fpcr) noexcept
         {
-            int64_t i;
-            double d;
-        } v {};
-        v.d = x;
-        int64_t ex = v.i & 0x7ff0000000000000;
-        int64_t e = (ex >> 53) - 510;
-        v.i = (v.i - ex) | 0x3ff0000000000000;
+            asm volatile("msr fpcr, %0"
+                         :
+                         : "ri"(fpcr));
+        }
+#endif
 
-        return 0.693147180559945 * ((double) e + log2_approx<double> (v.d));
-    }
+#if CHOWDSP_WDF_DENORMALS_USE_MXCSR || CHOWDSP_WDF_DENORMALS_USE_FPCR
+        intptr_t prevState = 0;
+#endif
+    };
+} // namespace wdft
+} // namespace chowdsp
 
-#if defined(XSIMD_HPP)
-    /** approximation for log(x) (SIMD 32-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<float> log_approx (xsimd::batch<float> x)
-    {
-        union
-        {
-            xsimd::batch<int32_t> i;
-            xsimd::batch<float> f;
-        } v;
-        v.f = x;
-        xsimd::batch<int32_t> ex = v.i & 0x7f800000;
-        xsimd::batch<float> e = xsimd::to_float ((ex >> 23) - 127);
-        v.i = (v.i - ex) | 0x3f800000;
+#endif //CHOWDSP_WDF_SCOPED_NO_DENORMALS_H
 
-        return 0.693147180559945f * (log2_approx<float> (v.f) + e);
-    }
+// #include "util/multichannel.h"
+#ifndef CHOWDSP_WDF_MULTICHANNEL_H
+#define CHOWDSP_WDF_MULTICHANNEL_H
 
-    /** approximation for log(x) (64-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<double> log_approx (xsimd::batch<double> x)
-    {
-        union
-        {
-            xsimd::batch<int64_t> i;
-            xsimd::batch<double> d;
-        } v {};
-        v.d = x;
-        xsimd::batch<int64_t> ex = v.i & 0x7ff0000000000000;
-        xsimd::batch<double> e = xsimd::to_float ((ex >> 53) - 510);
-        v.i = (v.i - ex) | 0x3ff0000000000000;
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
 
-        return 0.693147180559945 * (e + log2_approx<double> (v.d));
-    }
-#endif
+// #include "../math/sample_type.h"
+#ifndef CHOWDSP_WDF_SAMPLE_TYPE_H
+#define CHOWDSP_WDF_SAMPLE_TYPE_H
 
-    /** approximation for 2^x, optimized on the range [0, 1] */
-    template <typename T>
-    constexpr T pow2_approx (T x)
-    {
-        constexpr auto alpha = (T) 0.07944154167983575;
-        constexpr auto beta = (T) 0.2274112777602189;
-        constexpr auto gamma = (T) 0.6931471805599453;
-        constexpr auto zeta = (T) 1.0;
+#include <type_traits>
 
-        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
-    }
+#ifndef DOXYGEN
 
-#if defined(XSIMD_HPP)
-    template <typename T>
-    inline xsimd::batch<T> pow2_approx (const xsimd::batch<T>& x)
+namespace chowdsp
+{
+#if ! (JUCE_MODULE_AVAILABLE_chowdsp_dsp)
+/** Useful structs for determining the internal data type of SIMD types */
+namespace SampleTypeHelpers
+{
+    template <typename T, bool = std::is_floating_point<T>::value>
+    struct ElementType
     {
-        static constexpr auto alpha = (NumericType<T>) 0.07944154167983575;
-        static constexpr auto beta = (NumericType<T>) 0.2274112777602189;
-        static constexpr auto gamma = (NumericType<T>) 0.6931471805599453;
-        static constexpr auto zeta = (NumericType<T>) 1.0;
+        using Type = T;
+    };
 
-        return estrin<3> ({ alpha, beta, gamma, zeta }, x);
-    }
+    template <typename T>
+    struct ElementType<T, false>
+    {
+        using Type = typename T::value_type;
+    };
+} // namespace SampleTypeHelpers
 #endif
 
-    /** approximation for exp(x) */
-    template <typename T>
-    T exp_approx (T x);
+/** Type alias for a SIMD numeric type */
+template <typename T>
+using NumericType = typename SampleTypeHelpers::ElementType<T>::Type;
 
-    /** approximation for exp(x) (32-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED constexpr float exp_approx (float x)
-    {
-        x = std::max (-126.0f, 1.442695040888963f * x);
+/** Returns true if all the elements in a SIMD vector are equal */
+inline bool all (bool x)
+{
+    return x;
+}
 
-        union
-        {
-            int32_t i;
-            float f;
-        } v {};
+/** Ternary select operation */
+template <typename T>
+inline T select (bool b, const T& t, const T& f)
+{
+    return b ? t : f;
+}
+} // namespace chowdsp
 
-        auto xi = (int32_t) x;
-        int32_t l = x < 0.0f ? xi - 1 : xi;
-        float f = x - (float) l;
-        v.i = (l + 127) << 23;
+#endif // DOXYGEN
 
-        return v.f * pow2_approx<float> (f);
-    }
+#endif //CHOWDSP_WDF_SAMPLE_TYPE_H
 
-    /** approximation for exp(x) (64-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED constexpr double exp_approx (double x)
+
+namespace chowdsp
+{
+namespace wdft
+{
+#ifndef DOXYGEN
+    namespace multichannel_detail
     {
-        x = std::max ((double) -126.0, 1.442695040888963 * x);
+        /** Number of samples per channel which are transposed at a time */
+        constexpr int subBlockSize = 32;
 
-        union
+        template <typename VectorType>
+        constexpr int numLanes() noexcept
         {
-            int64_t i;
-            double d;
-        } v {};
-
-        auto xi = (int64_t) x;
-        int64_t l = x < 0.0 ? xi - 1 : xi;
-        double d = x - (double) l;
-        v.i = (l + 1023) << 52;
+            return (int) (sizeof (VectorType) / sizeof (NumericType<VectorType>));
+        }
 
-        return v.d * pow2_approx<double> (d);
-    }
+        /**
+         * Loads a vector from numLanes() contiguous samples. This uses memcpy, rather than an XSIMD
+         * load, so that this header doesn't depend on XSIMD. Compilers usually turn a fixed-size
+         * memcpy into a single unaligned vector load.
+         */
+        template <typename VectorType>
+        inline VectorType load (const NumericType<VectorType>* data) noexcept
+        {
+            VectorType x;
+            std::memcpy (&x, data, sizeof (VectorType));
+            return x;
+        }
 
-#if defined(XSIMD_HPP)
-    /** approximation for exp(x) (32-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<float> exp_approx (xsimd::batch<float> x)
-    {
-        x = xsimd::max (xsimd::broadcast (-126.0f), 1.442695040888963f * x);
+        /** Stores a vector to numLanes() contiguous samples (see load()) */
+        template <typename VectorType>
+        inline void store (NumericType<VectorType>* data, const VectorType& x) noexcept
+        {
+            std::memcpy (data, &x, sizeof (VectorType));
+        }
 
-        union
+        /**
+         * Buffer for transposing a sub-block of planar channels into vectors, and back again.
+         * The transpose is done with plain scalar copies, not with SIMD shuffles.
+         */
+        template <typename VectorType>
+        struct TransposeBuffer
         {
-            xsimd::batch<int32_t> i;
-            xsimd::batch<float> f;
-        } v {};
+            using T = NumericType<VectorType>;
+            static constexpr int lanes = numLanes<VectorType>();
 
-        auto xi = xsimd::to_int (x);
-        xsimd::batch<int32_t> l = xsimd::select (xi < 0, xi - 1, xi);
-        xsimd::batch<float> f = x - xsimd::to_float (l);
-        v.i = (l + 127) << 23;
+            /** Copies numChannels (<= lanes) planar channels into the buffer, leaving any unused lanes zeroed. */
+            void interleave (T* const* channelData, int numChannels, int startSample, int numSamples) noexcept
+            {
+                if (numChannels == lanes)
+                {
+                    // with a compile-time number of lanes, the compiler may vectorise these copies (but this isn't guaranteed)
+                    for (int n = 0; n < numSamples; ++n)
+                        for (int lane = 0; lane < lanes; ++lane)
+                            data[n * lanes + lane] = channelData[lane][startSample + n];
+                    return;
+                }
+
+                std::fill (std::begin (data), std::end (data), (T) 0);
+                for (int lane = 0; lane < numChannels; ++lane)
+                    for (int n = 0; n < numSamples; ++n)
+                        data[n * lanes + lane] = channelData[lane][startSample + n];
+            }
 
-        return v.f * pow2_approx<float> (f);
-    }
+            /** Copies the buffer back out to numChannels (<= lanes) planar channels. */
+            void deinterleave (T* const* channelData, int numChannels, int startSample, int numSamples) const noexcept
+            {
+                if (numChannels == lanes)
+                {
+                    for (int n = 0; n < numSamples; ++n)
+                        for (int lane = 0; lane < lanes; ++lane)
+                            channelData[lane][startSample + n] = data[n * lanes + lane];
+                    return;
+                }
+
+                for (int lane = 0; lane < numChannels; ++lane)
+                    for (int n = 0; n < numSamples; ++n)
+                        channelData[lane][startSample + n] = data[n * lanes + lane];
+            }
 
-    /** approximation for exp(x) (64-bit) */
-    template <>
-    CHOWDSP_WDF_MAYBE_UNUSED inline xsimd::batch<double> exp_approx (xsimd::batch<double> x)
-    {
-        x = xsimd::max (xsimd::broadcast (-126.0), 1.442695040888963 * x);
+            alignas (alignof (VectorType)) T data[subBlockSize * lanes];
+        };
+
+        /**
+         * Number of vectors which are processed together. The circuits for different vectors
+         * are independent, so processing them in the same loop gives the CPU more to do while
+         * it waits on the latency of each circuit.
+         */
+        constexpr int maxGroupsPerBatch = 4;
 
-        union
+        /** Processes numGroups (<= maxGroupsPerBatch) vectors, starting from the first channel in channelData */
+        template <typename VectorType, typename VectorProcessor>
+        void processPlanarBatch (NumericType<VectorType>* const* channelData, int numChannels, int numSamples, int firstGroup, int numGroups, VectorProcessor& vectorProcessor)
         {
-            xsimd::batch<int64_t> i;
-            xsimd::batch<double> d;
-        } v {};
+            constexpr auto lanes = numLanes<VectorType>();
+            if (lanes == 1)
+            {
+                // nothing to transpose!
+                for (int n = 0; n < numSamples; ++n)
+                    for (int group = 0; group < numGroups; ++group)
+                        store (channelData[group] + n, vectorProcessor (firstGroup + group, load<VectorType> (channelData[group] + n)));
+                return;
+            }
 
-        auto xi = xsimd::to_int (x);
-        xsimd::batch<int64_t> l = xsimd::select (xi < 0, xi - 1, xi);
-        xsimd::batch<double> d = x - xsimd::to_float (l);
-        v.i = (l + 1023) << 52;
+            TransposeBuffer<VectorType> buffers[maxGroupsPerBatch];
+            for (int startSample = 0; startSample < numSamples; startSample += subBlockSize)
+            {
+                const auto subBlockSamples = std::min (subBlockSize, numSamples - startSample);
+                for (int group = 0; group < numGroups; ++group)
+                    buffers[group].interleave (channelData + group * lanes, std::min (lanes, numChannels - group * lanes), startSample, subBlockSamples);
+
+                for (int n = 0; n < subBlockSamples; ++n)
+                {
+                    for (int group = 0; group < numGroups; ++group)
+                    {
+                        auto* frame = buffers[group].data + n * lanes;
+                        store (frame, vectorProcessor (firstGroup + group, load<VectorType> (frame)));
+                    }
+                }
+
+                for (int group = 0; group < numGroups; ++group)
+                    buffers[group].deinterleave (channelData + group * lanes, std::min (lanes, numChannels - group * lanes), startSample, subBlockSamples);
+            }
+        }
 
-        return v.d * pow2_approx<double> (d);
-    }
-#endif
+        /** Processes numGroups vectors, in batches of maxGroupsPerBatch */
+        template <typename VectorType, typename VectorProcessor>
+        void processPlanarGroups (NumericType<VectorType>* const* channelData, int numChannels, int numSamples, int numGroups, VectorProcessor& vectorProcessor)
+        {
+            constexpr auto lanes = numLanes<VectorType>();
+            for (int firstGroup = 0; firstGroup < numGroups; firstGroup += maxGroupsPerBatch)
+            {
+                processPlanarBatch<VectorType> (channelData + firstGroup * lanes,
+                                                numChannels - firstGroup * lanes,
+                                                numSamples,
+                                                firstGroup,
+                                                std::min (maxGroupsPerBatch, numGroups - firstGroup),
+                                                vectorProcessor);
+            }
+        }
+    } // namespace multichannel_detail
+#endif // DOXYGEN
 
-    /** First-order approximation of the Wright Omega functions */
-    template <typename T>
-    constexpr T omega1 (T x)
+    /** Returns the number of channels processed by each vector (e.g. 4 for an SSE xsimd::batch<float>, or 1 for float). */
+    template <typename VectorType>
+    constexpr int getNumChannelsPerVector() noexcept
     {
-#if defined(XSIMD_HPP)
-        using xsimd::max;
-#endif
-        using std::max;
+        return multichannel_detail::numLanes<VectorType>();
+    }
 
-        return max (x, (T) 0);
+    /**
+     * Returns the number of vectors needed to process numChannels, i.e. the number of
+     * circuits needed by the vector processor. If padLeftoverChannels is false, the leftover
+     * channels are not counted, since they are processed by the scalar processor.
+     */
+    template <typename VectorType>
+    constexpr int getNumVectorGroups (int numChannels, bool padLeftoverChannels = true) noexcept
+    {
+        return padLeftoverChannels ? (numChannels + getNumChannelsPerVector<VectorType>() - 1) / getNumChannelsPerVector<VectorType>()
+                                   : numChannels / getNumChannelsPerVector<VectorType>();
     }
 
-    /** Second-order approximation of the Wright Omega functions */
-    template <typename T>
-    constexpr T omega2 (T x)
+    /**
+     * Processes a planar buffer (one pointer per channel) in-place, with the channels mapped
+     * to the lanes of VectorType (e.g. xsimd::batch<float>): channels [0, lanes) go to the
+     * first vector, [lanes, 2 * lanes) to the second vector, and so on.
+     *
+     * vectorProcessor is called as vectorProcessor (int groupIndex, VectorType x) for each
+     * sample, and should return the processed vector (e.g. by calling processSample() on the
+     * circuit for that group). The channels are transposed to and from vectors a few samples
+     * at a time, rather than gathering one sample from each channel per vector, and a few
+     * groups are processed side-by-side, so that their circuits can overlap in the CPU.
+     * The transpose itself is done with scalar copies, through a small buffer on the stack.
+     * The time saved comes from keeping the circuit processing in a tight loop, rather than
+     * from a faster transpose.
+     *
+     * scalarProcessor is called as scalarProcessor (int channelIndex, T x) for each sample of
+     * the channels left over after the last full vector.
+     */
+    template <typename VectorType, typename VectorProcessor, typename ScalarProcessor>
+    void processPlanar (NumericType<VectorType>* const* channelData, int numChannels, int numSamples, VectorProcessor&& vectorProcessor, ScalarProcessor&& scalarProcessor)
     {
-        constexpr auto x1 = (NumericType<T>) -3.684303659906469;
-        constexpr auto x2 = (NumericType<T>) 1.972967391708859;
-        constexpr auto a = (NumericType<T>) 9.451797158780131e-3;
-        constexpr auto b = (NumericType<T>) 1.126446405111627e-1;
-        constexpr auto c = (NumericType<T>) 4.451353886588814e-1;
-        constexpr auto d = (NumericType<T>) 5.836596684310648e-1;
+        constexpr auto lanes = getNumChannelsPerVector<VectorType>();
+        const auto numGroups = getNumVectorGroups<VectorType> (numChannels, false);
 
-        return select (x < x1, (T) 0, select (x > x2, x, estrin<3> ({ a, b, c, d }, x)));
+        multichannel_detail::processPlanarGroups<VectorType> (channelData, numGroups * lanes, numSamples, numGroups, vectorProcessor);
+
+        for (int n = 0; n < numSamples; ++n)
+            for (int channel = numGroups * lanes; channel < numChannels; ++channel)
+                channelData[channel][n] = scalarProcessor (channel, channelData[channel][n]);
     }
 
-    /** Third-order approximation of the Wright Omega functions */
-    template <typename T>
-    constexpr T omega3 (T x)
+    /**
+     * Processes a planar buffer in-place, as above, except that any leftover channels are
+     * processed by one more (partially filled) vector, with the unused lanes set to zero.
+     * For example, a stereo buffer uses two lanes of a single SSE vector.
+     */
+    template <typename VectorType, typename VectorProcessor>
+    void processPlanar (NumericType<VectorType>* const* channelData, int numChannels, int numSamples, VectorProcessor&& vectorProcessor)
     {
-        constexpr auto x1 = (NumericType<T>) -3.341459552768620;
-        constexpr auto x2 = (NumericType<T>) 8.0;
-        constexpr auto a = (NumericType<T>) -1.314293149877800e-3;
-        constexpr auto b = (NumericType<T>) 4.775931364975583e-2;
-        constexpr auto c = (NumericType<T>) 3.631952663804445e-1;
-        constexpr auto d = (NumericType<T>) 6.313183464296682e-1;
-
-        return select (x < x1, (T) 0, select (x < x2, estrin<3> ({ a, b, c, d }, x), x - log_approx<T> (x)));
+        const auto numGroups = getNumVectorGroups<VectorType> (numChannels);
+        multichannel_detail::processPlanarGroups<VectorType> (channelData, numChannels, numSamples, numGroups, vectorProcessor);
     }
 
-    /** Fourth-order approximation of the Wright Omega functions */
-    template <typename T>
-    constexpr T omega4 (T x)
+    /**
+     * Processes an interleaved buffer (numSamples frames of numChannels samples) in-place,
+     * with the same channel mapping and processor arguments as processPlanar(). Since the
+     * channels of each frame are already contiguous, each vector is loaded straight from
+     * the buffer, without a transpose.
+     */
+    template <typename VectorType, typename VectorProcessor, typename ScalarProcessor>
+    void processInterleaved (NumericType<VectorType>* data, int numChannels, int numSamples, VectorProcessor&& vectorProcessor, ScalarProcessor&& scalarProcessor)
     {
-        const auto y = omega3<T> (x);
-        return y - (y - exp_approx<T> (x - y)) / (y + (T) 1);
+        using namespace multichannel_detail;
+        constexpr auto lanes = getNumChannelsPerVector<VectorType>();
+        const auto numGroups = getNumVectorGroups<VectorType> (numChannels, false);
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            auto* frame = data + n * numChannels;
+            for (int group = 0; group < numGroups; ++group)
+                store (frame + group * lanes, vectorProcessor (group, load<VectorType> (frame + group * lanes)));
+
+            for (int channel = numGroups * lanes; channel < numChannels; ++channel)
+                frame[channel] = scalarProcessor (channel, frame[channel]);
+        }
     }
 
-    struct Omega
+    /**
+     * Processes an interleaved buffer in-place, with any leftover channels processed by
+     * one more (partially filled) vector, with the unused lanes set to zero.
+     */
+    template <typename VectorType, typename VectorProcessor>
+    void processInterleaved (NumericType<VectorType>* data, int numChannels, int numSamples, VectorProcessor&& vectorProcessor)
     {
-        template <typename T>
-        static T omega (T x)
+        using namespace multichannel_detail;
+        using T = NumericType<VectorType>;
+        constexpr auto lanes = getNumChannelsPerVector<VectorType>();
+        const auto numFullGroups = getNumVectorGroups<VectorType> (numChannels, false);
+        const auto numLeftoverChannels = numChannels - numFullGroups * lanes;
+
+        alignas (alignof (VectorType)) T leftovers[lanes];
+        for (int n = 0; n < numSamples; ++n)
         {
-            return omega4 (x);
+            auto* frame = data + n * numChannels;
+            for (int group = 0; group < numFullGroups; ++group)
+                store (frame + group * lanes, vectorProcessor (group, load<VectorType> (frame + group * lanes)));
+
+            if (numLeftoverChannels > 0)
+            {
+                std::copy (frame + numFullGroups * lanes, frame + numChannels, leftovers);
+                std::fill (leftovers + numLeftoverChannels, leftovers + lanes, (T) 0);
+                store (leftovers, vectorProcessor (numFullGroups, load<VectorType> (leftovers)));
+                std::copy (leftovers, leftovers + numLeftoverChannels, frame + numFullGroups * lanes);
+            }
         }
-    };
-} // namespace Omega
+    }
+} // namespace wdft
 } // namespace chowdsp
 
-#endif //OMEGA_H_INCLUDED
+#endif //CHOWDSP_WDF_MULTICHANNEL_H
+
+// #include "util/circuit_sleep.h"
+#ifndef CHOWDSP_WDF_CIRCUIT_SLEEP_H
+#define CHOWDSP_WDF_CIRCUIT_SLEEP_H
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+// #include "circuit_state.h"
 
 
 namespace chowdsp
 {
 namespace wdft
 {
-    /** Enum to determine which diode approximation eqn. to use */
-    enum DiodeQuality
-    {
-        Good, // see reference eqn (18)
-        Best, // see reference eqn (39)
-    };
-
-    /**
-     * WDF diode pair (non-adaptable)
-     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
-     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
-     */
-    template <typename T, typename Next, DiodeQuality Quality = DiodeQuality::Best, typename OmegaProvider = Omega::Omega>
-    class DiodePairT final : public RootWDF
+#ifndef DOXYGEN
+    namespace sleep_detail
     {
-    public:
-        /**
-         * Creates a new WDF diode pair, with the given diode specifications.
-         * @param n: the next element in the WDF connection tree
-         * @param Is: reverse saturation current
-         * @param Vt: thermal voltage
-         * @param nDiodes: the number of series diodes
-         */
-        DiodePairT (Next& n, T Is, T Vt = NumericType<T> (25.85e-3), T nDiodes = 1) : next (n)
+        template <typename T>
+        std::enable_if_t<std::is_arithmetic<T>::value, bool> isBelow (const T& x, double threshold) noexcept
         {
-            n.connectToParent (this);
-            setDiodeParameters (Is, Vt, nDiodes);
+            return std::abs ((double) x) <= threshold;
         }
 
-        /** Sets diode specific parameters */
-        void setDiodeParameters (T newIs, T newVt, T nDiodes)
+        template <typename T>
+        bool isBelow (const CompensatedFloat<T>& x, double threshold) noexcept
         {
-            Is = newIs;
-            Vt = nDiodes * newVt;
-            twoVt = (T) 2 * Vt;
-            oneOverVt = (T) 1 / Vt;
-            calcImpedance();
+            return isBelow (x.hi, threshold) && isBelow (x.lo, threshold);
         }
 
-        inline void calcImpedance() override
-        {
 #if defined(XSIMD_HPP)
-            using xsimd::log;
-#endif
-            using std::log;
-
-            R_Is = next.wdf.R * Is;
-            R_Is_overVt = R_Is * oneOverVt;
-            logR_Is_overVt = log (R_Is_overVt);
-        }
-
-        /** Accepts an incident wave into a WDF diode pair. */
-        inline void incident (T x) noexcept
-        {
-            wdf.a = x;
-        }
-
-        /** Propogates a reflected wave from a WDF diode pair. */
-        inline T reflected() noexcept
+        template <typename T>
+        bool isBelow (const xsimd::batch<T>& x, double threshold) noexcept
         {
-            reflectedInternal();
-            return wdf.b;
+            return xsimd::all (xsimd::abs (x) <= xsimd::batch<T> ((T) threshold));
         }
+#endif
+    } // namespace sleep_detail
+#endif // DOXYGEN
 
-        WDFMembers<T> wdf;
-
-    private:
-        /** Implementation for float/double (Good). */
-        template <typename C = T, DiodeQuality Q = Quality>
-        inline typename std::enable_if<Q == Good, void>::type
-            reflectedInternal() noexcept
-        {
-            // See eqn (18) from reference paper
-            T lambda = (T) signum::signum (wdf.a);
-            wdf.b = wdf.a + (T) 2 * lambda * (R_Is - Vt * OmegaProvider::omega (logR_Is_overVt + lambda * wdf.a * oneOverVt + R_Is_overVt));
-        }
+    /**
+     * Skips the processing for a circuit while it is silent.
+     *
+     * Once a block of input is silent, and every state variable in the circuit (the waves
+     * and internal states of every element, as visited by visitCircuitState()) has decayed
+     * below the threshold, the circuit goes to sleep: its state is set to zero, and while
+     * the input stays silent, the output is filled with zeros, without running the circuit.
+     * As soon as a block of input contains a sample above the threshold, the circuit wakes
+     * up and processes that whole block, starting from the zeroed state.
+     *
+     * Note that a circuit whose state does not decay to zero with a silent input (e.g. a
+     * circuit with a bias voltage) will never go to sleep. Input signals which are set on
+     * the circuit outside of the processed buffer (e.g. a modulation source) are not
+     * checked, so call wake() whenever one of those becomes non-zero.
+     *
+     * The circuit state is only checked at the end of a silent block, and checking it
+     * does not allocate any memory, so process() may be called from the audio thread.
+     * ```cpp
+     * wdft::CircuitSleepMode sleepMode { 1.0e-6 };
+     *
+     * // in the audio callback...
+     * sleepMode.process (circuit.root, buffer, numSamples, [&] (float* data, int n) { circuit.processBlock (data, n); });
+     * ```
+     */
+    class CircuitSleepMode
+    {
+    public:
+        /** Creates a sleep mode with the given threshold (linear gain) for the input and circuit state. */
+        explicit CircuitSleepMode (double thresholdToUse = 1.0e-6) : threshold (thresholdToUse) {}
 
-        /** Implementation for float/double (Best). */
-        template <typename C = T, DiodeQuality Q = Quality>
-        inline typename std::enable_if<Q == Best, void>::type
-            reflectedInternal() noexcept
-        {
-            // See eqn (39) from reference paper
-            T lambda = (T) signum::signum (wdf.a);
-            T lambda_a_over_vt = lambda * wdf.a * oneOverVt;
-            wdf.b = wdf.a - twoVt * lambda * (Omega::omega4 (logR_Is_overVt + lambda_a_over_vt) - Omega::omega4 (logR_Is_overVt - lambda_a_over_vt));
-        }
+        /** Sets the threshold (linear gain) for the input and circuit state. */
+        void setThreshold (double newThreshold) noexcept { threshold = newThreshold; }
 
-        T Is; // reverse saturation current
-        T Vt; // thermal voltage
+        /** Returns the threshold for the input and circuit state. */
+        double getThreshold() const noexcept { return threshold; }
 
-        // pre-computed vars
-        T twoVt;
-        T oneOverVt;
-        T R_Is;
-        T R_Is_overVt;
-        T logR_Is_overVt;
+        /** Returns true if the circuit is currently asleep. */
+        bool isAsleep() const noexcept { return asleep; }
 
-        const Next& next;
-    };
+        /** Wakes the circuit up, so that the next block is processed. */
+        void wake() noexcept { asleep = false; }
 
-    /**
-     * WDF diode (non-adaptable)
-     * See Werner et al., "An Improved and Generalized Diode Clipper Model for Wave Digital Filters"
-     * https://www.researchgate.net/publication/299514713_An_Improved_and_Generalized_Diode_Clipper_Model_for_Wave_Digital_Filters
-     */
-    template <typename T, typename Next, DiodeQuality Quality = DiodeQuality::Best, typename OmegaProvider = Omega::Omega>
-    class DiodeT final : public RootWDF
-    {
-    public:
         /**
-         * Creates a new WDF diode, with the given diode specifications.
-         * @param n: the next element in the WDF connection tree
-         * @param Is: reverse saturation current
-         * @param Vt: thermal voltage
-         * @param nDiodes: the number of series diodes
+         * Processes a block of samples in-place, by calling processBlock (buffer, numSamples),
+         * unless the circuit is asleep and the block is silent, in which case the block is
+         * filled with zeros.
+         *
+         * @param root          the root of the WDF tree.
+         * @param buffer        the input buffer, which is processed in-place.
+         * @param numSamples    the number of samples in the buffer.
+         * @param processBlock  a function which processes the buffer through the circuit.
+         * @return              true if the circuit was processed, or false if it was asleep.
          */
-        DiodeT (Next& n, T Is, T Vt = NumericType<T> (25.85e-3), T nDiodes = 1) : next (n)
+        template <typename RootType, typename SampleType, typename ProcessFunc>
+        bool process (RootType& root, SampleType* buffer, int numSamples, ProcessFunc&& processBlock) noexcept
         {
-            n.connectToParent (this);
-            setDiodeParameters (Is, Vt, nDiodes);
-        }
+            const auto inputIsSilent = isSilent (buffer, numSamples);
+            if (asleep && inputIsSilent)
+            {
+                std::fill (buffer, buffer + numSamples, SampleType {});
+                return false;
+            }
 
-        /** Sets diode specific parameters */
-        void setDiodeParameters (T newIs, T newVt, T nDiodes)
-        {
-            Is = newIs;
-            Vt = nDiodes * newVt;
-            twoVt = (T) 2 * Vt;
-            oneOverVt = (T) 1 / Vt;
-            calcImpedance();
-        }
+            asleep = false;
+            processBlock (buffer, numSamples);
 
-        inline void calcImpedance() override
-        {
-#if defined(XSIMD_HPP)
-            using xsimd::log;
-#endif
-            using std::log;
+            if (inputIsSilent && stateIsSilent (root))
+            {
+                visitCircuitState (root, [] (auto& x) { x = std::remove_reference_t<decltype (x)> {}; });
+                asleep = true;
+            }
 
-            twoR_Is = (T) 2 * next.wdf.R * Is;
-            R_Is_overVt = next.wdf.R * Is * oneOverVt;
-            logR_Is_overVt = log (R_Is_overVt);
+            return true;
         }
 
-        /** Accepts an incident wave into a WDF diode. */
-        inline void incident (T x) noexcept
+    private:
+        template <typename SampleType>
+        bool isSilent (const SampleType* buffer, int numSamples) const noexcept
         {
-            wdf.a = x;
+            for (int n = 0; n < numSamples; ++n)
+                if (! sleep_detail::isBelow (buffer[n], threshold))
+                    return false;
+            return true;
         }
 
-        /** Propogates a reflected wave from a WDF diode. */
-        inline T reflected() noexcept
+        template <typename RootType>
+        bool stateIsSilent (RootType& root) const noexcept
         {
-            // See eqn (10) from reference paper
-            wdf.b = wdf.a + twoR_Is - twoVt * OmegaProvider::omega (logR_Is_overVt + wdf.a * oneOverVt + R_Is_overVt);
-            return wdf.b;
+            bool isSilent = true;
+            visitCircuitState (root, [this, &isSilent] (const auto& x)
+                               { isSilent = isSilent && sleep_detail::isBelow (x, threshold); });
+            return isSilent;
         }
 
-        WDFMembers<T> wdf;
+        double threshold;
+        bool asleep = false;
+    };
+} // namespace wdft
+} // namespace chowdsp
+
+#endif //CHOWDSP_WDF_CIRCUIT_SLEEP_H
+
+// #include "util/probe_recorder.h"
+#ifndef CHOWDSP_WDF_PROBE_RECORDER_H
+#define CHOWDSP_WDF_PROBE_RECORDER_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace chowdsp
+{
+namespace wdft
+{
+    /** Probes the voltage across a circuit element, for use with ProbeRecorder. */
+    template <typename T, typename ElementType>
+    struct VoltageProbe
+    {
+        const ElementType* element;
 
-    private:
-        T Is; // reverse saturation current
-        T Vt; // thermal voltage
+        inline T operator()() const noexcept { return voltage<T> (*element); }
+    };
 
-        // pre-computed vars
-        T twoVt;
-        T oneOverVt;
-        T twoR_Is;
-        T R_Is_overVt;
-        T logR_Is_overVt;
+    /** Probes the current through a circuit element, for use with ProbeRecorder. */
+    template <typename T, typename ElementType>
+    struct CurrentProbe
+    {
+        const ElementType* element;
 
-        const Next& next;
+        inline T operator()() const noexcept { return current<T> (*element); }
     };
 
-    /** WDF Switch (non-adaptable) */
-    template <typename T, typename Next>
-    class SwitchT final : public RootWDF
+    /** Creates a probe for the voltage across a circuit element. */
+    template <typename T, typename ElementType>
+    VoltageProbe<T, ElementType> voltageProbe (const ElementType& element) noexcept
     {
-    public:
-        explicit SwitchT (Next& next)
-        {
-            next.connectToParent (this);
-        }
+        return { &element };
+    }
 
-        inline void calcImpedance() override {}
+    /** Creates a probe for the current through a circuit element. */
+    template <typename T, typename ElementType>
+    CurrentProbe<T, ElementType> currentProbe (const ElementType& element) noexcept
+    {
+        return { &element };
+    }
 
-        /** Sets the state of the switch. */
-        void setClosed (bool shouldClose) { closed = shouldClose; }
+    /**
+     * Records the voltages and/or currents of several circuit elements, for every
+     * sample of a block, into one contiguous buffer per probe.
+     *
+     * The probes are fixed when the recorder is created, so recording a sample is
+     * just a few loads from the (already cached) element waves, and a store to each
+     * probe's buffer, with no virtual calls or branches. The buffers are allocated
+     * in prepare(), so the recorder can be used on the audio thread:
+     * ```cpp
+     * auto probes = wdft::makeProbeRecorder (wdft::voltageProbe<float> (C1), wdft::currentProbe<float> (R2));
+     * probes.prepare (maxBlockSize);
+     *
+     * // in the audio callback...
+     * probes.startBlock();
+     * for (int n = 0; n < numSamples; ++n)
+     * {
+     *     buffer[n] = processSample (buffer[n]);
+     *     probes.record();
+     * }
+     * meter.process (probes.getProbeData (0), probes.getNumSamples());
+     * ```
+     *
+     * Probes work with elements from both the wdft and wdf APIs.
+     */
+    template <typename T, typename... Probes>
+    class ProbeRecorder
+    {
+    public:
+        /** The number of probes */
+        static constexpr int numProbes = (int) sizeof...(Probes);
 
-        /** Accepts an incident wave into a WDF switch. */
-        inline void incident (T x) noexcept
+        explicit ProbeRecorder (Probes... probesToRecord) : probes (probesToRecord...) {}
+
+        /** Allocates the probe buffers, for blocks of up to maxBlockSize samples. */
+        void prepare (int maxBlockSize)
         {
-            wdf.a = x;
+            bufferSize = maxBlockSize;
+            data.assign ((size_t) (numProbes * maxBlockSize), T {});
+            numSamples = 0;
         }
 
-        /** Propogates a reflected wave from a WDF switch. */
-        inline T reflected() noexcept
+        /** Starts recording a new block, from the start of the probe buffers. */
+        void startBlock() noexcept { numSamples = 0; }
+
+        /**
+         * Records one sample from each probe.
+         * Note: it is the caller's responsibility not to record more than maxBlockSize samples per block!
+         */
+        inline void record() noexcept
         {
-            wdf.b = closed ? -wdf.a : wdf.a;
-            return wdf.b;
+            recordProbes (std::make_index_sequence<sizeof...(Probes)> {});
+            numSamples++;
         }
 
-        WDFMembers<T> wdf;
+        /** Returns the number of samples recorded since the start of the block. */
+        int getNumSamples() const noexcept { return numSamples; }
+
+        /** Returns the samples recorded for the given probe (in the order that the probes were given to the constructor). */
+        const T* getProbeData (int probeIndex) const noexcept { return data.data() + probeIndex * bufferSize; }
 
     private:
-        bool closed = true;
+        template <size_t... Ix>
+        inline void recordProbes (std::index_sequence<Ix...>) noexcept
+        {
+            auto* samples = data.data() + numSamples;
+            (void) std::initializer_list<int> { ((void) (samples[(int) Ix * bufferSize] = std::get<Ix> (probes)()), 0)... };
+        }
+
+        std::tuple<Probes...> probes;
+        std::vector<T> data;
+        int bufferSize = 0;
+        int numSamples = 0;
     };
+
+    /** Creates a ProbeRecorder from a list of probes (see voltageProbe() and currentProbe()). */
+    template <typename FirstProbe, typename... OtherProbes>
+    auto makeProbeRecorder (FirstProbe firstProbe, OtherProbes... otherProbes)
+    {
+        using T = decltype (firstProbe());
+        return ProbeRecorder<T, FirstProbe, OtherProbes...> { firstProbe, otherProbes... };
+    }
 } // namespace wdft
 } // namespace chowdsp
 
-#endif //CHOWDSP_WDF_WDFT_NONLINEARITIES_H
+#endif //CHOWDSP_WDF_PROBE_RECORDER_H
 
+// #include "util/linear_state_space.h"
+#ifndef CHOWDSP_WDF_LINEAR_STATE_SPACE_H
+#define CHOWDSP_WDF_LINEAR_STATE_SPACE_H
 
-#endif // CHOWDSP_WDF_T_INCLUDED
+#include <algorithm>
+#include <vector>
+
+// #include "circuit_state.h"
+
+// #include "dc_operating_point.h"
 
 
 namespace chowdsp
 {
-namespace wdf
+namespace wdft
 {
-    /** Wave digital filter base class */
-    template <typename T>
-    class WDF : public wdft::BaseWDF
+    /**
+     * The state-space model of a linear circuit:
+     * x[n+1] = A x[n] + B u[n], y[n] = C x[n] + D u[n].
+     *
+     * update() measures the model for the circuit's current parameters, by processing
+     * one sample from each unit state (as in DCOperatingPointSolver), with every state
+     * variable visited by visitCircuitState(). The state variables which can be dropped
+     * without changing the input-output behaviour (from a zero initial state) are then
+     * removed: those which never affect the output or the other states (e.g. waves which
+     * are always overwritten before they are read), and those which are never affected by
+     * the input or the other states (e.g. waves from resistors). The model is stored in
+     * double precision, whatever the sample type of the circuit.
+     *
+     * The circuit must not have any non-zero inputs other than the processed signal (e.g.
+     * bias voltages), since the model assumes that the circuit is linear, not affine.
+     */
+    template <typename T = float>
+    class LinearStateSpace
     {
     public:
-        explicit WDF (std::string type) : type (std::move (type)) {}
-        ~WDF() override = default;
+        LinearStateSpace() = default;
 
-        void connectToNode (WDF<T>* p) { wdfParent = p; }
+        /** Allocates the memory needed to measure this circuit. */
+        template <typename RootType>
+        void prepare (RootType& root)
+        {
+            size_t numCircuitStates = 0;
+            visitCircuitState (root, [&numCircuitStates] (auto&) { numCircuitStates++; });
 
-        /** Sub-classes override this function to propagate
-     * an impedance change to the upstream elements in
-     * the WDF tree.
-     */
-        virtual inline void propagateImpedance()
+            fullA.assign (numCircuitStates * numCircuitStates, 0.0);
+            fullB.assign (numCircuitStates, 0.0);
+            fullC.assign (numCircuitStates, 0.0);
+            state.assign (numCircuitStates, 0.0);
+            activeStates.assign (numCircuitStates, 0);
+
+            A.assign (numCircuitStates * numCircuitStates, 0.0);
+            B.assign (numCircuitStates, 0.0);
+            C.assign (numCircuitStates, 0.0);
+            D = 0.0;
+            numStates = 0;
+
+            originalState.allocate (root);
+        }
+
+        /**
+         * Measures the model for the circuit's current parameters.
+         * The circuit state is restored afterwards.
+         *
+         * @param root              the root of the WDF tree.
+         * @param processSample     a function which processes one sample of the circuit, and
+         *                          returns the output sample, i.e. T processSample (T x).
+         */
+        template <typename RootType, typename ProcessFunc>
+        void update (RootType& root, ProcessFunc&& processSample) noexcept
         {
-            calcImpedance();
+            saveState (root, originalState);
+            measure (root, processSample);
+            loadState (root, originalState);
 
-            if (wdfParent != nullptr)
-                wdfParent->propagateImpedance();
+            reduce();
         }
 
-        /** Sub-classes override this function to accept an incident wave. */
-        virtual void incident (T x) noexcept = 0;
+        /** Returns the number of state variables in the (reduced) model. */
+        int getNumStates() const noexcept { return numStates; }
 
-        /** Sub-classes override this function to propogate a reflected wave. */
-        virtual T reflected() noexcept = 0;
+        /** Returns the number of state variables in the circuit, i.e. before the model is reduced. */
+        int getNumCircuitStates() const noexcept { return (int) activeStates.size(); }
 
-        /** Probe the voltage across this circuit element. */
-        inline T voltage() const noexcept
+        /**
+         * Returns a flag for each of the circuit's state variables (in the order visited by
+         * visitCircuitState()), which is 1 if the variable is kept in the reduced model, or 0
+         * if it was removed. The model's states are the kept variables, in the same order.
+         */
+        const int* getUsedCircuitStates() const noexcept { return activeStates.data(); }
+
+        /** Returns the state-transition matrix A, as a row-major getNumStates() x getNumStates() matrix. */
+        const double* getA() const noexcept { return A.data(); }
+
+        /** Returns the input vector B. */
+        const double* getB() const noexcept { return B.data(); }
+
+        /** Returns the output vector C. */
+        const double* getC() const noexcept { return C.data(); }
+
+        /** Returns the feed-through term D. */
+        double getD() const noexcept { return D; }
+
+    private:
+        template <typename RootType>
+        void readState (RootType& root) noexcept
         {
-            return (wdf.a + wdf.b) / (T) 2.0;
+            size_t index = 0;
+            visitCircuitState (root, [this, &index] (auto& s)
+                               { state[index++] = dc_detail::getValue (s); });
         }
 
-        /**Probe the current through this circuit element. */
-        inline T current() const noexcept
+        template <typename RootType>
+        void writeState (RootType& root) noexcept
         {
-            return (wdf.a - wdf.b) / ((T) 2.0 * wdf.R);
+            size_t index = 0;
+            visitCircuitState (root, [this, &index] (auto& s)
+                               { dc_detail::setValue (s, state[index++]); });
         }
 
-        // These classes need access to a,b
-        template <typename>
-        friend class YParameter;
+        template <typename RootType, typename ProcessFunc>
+        void measure (RootType& root, ProcessFunc& processSample) noexcept
+        {
+            const auto N = state.size();
+            for (size_t j = 0; j < N; ++j)
+            {
+                std::fill (state.begin(), state.end(), 0.0);
+                state[j] = 1.0;
+                writeState (root);
+                fullC[j] = (double) processSample ((T) 0);
+                readState (root);
+                for (size_t i = 0; i < N; ++i)
+                    fullA[i * N + j] = state[i];
+            }
 
-        template <typename>
-        friend class WDFParallel;
+            std::fill (state.begin(), state.end(), 0.0);
+            writeState (root);
+            D = (double) processSample ((T) 1);
+            readState (root);
+            std::copy (state.begin(), state.end(), fullB.begin());
+        }
 
-        template <typename>
-        friend class WDFSeries;
+        void reduce() noexcept
+        {
+            const auto N = state.size();
+            std::fill (activeStates.begin(), activeStates.end(), 1);
 
-        wdft::WDFMembers<T> wdf;
+            auto isActive = [this] (size_t i) { return activeStates[i] != 0; };
+            bool changed = true;
+            while (changed)
+            {
+                changed = false;
+                for (size_t j = 0; j < N; ++j)
+                {
+                    if (! isActive (j))
+                        continue;
+
+                    bool readByOthers = fullC[j] != 0.0;
+                    bool writtenByOthers = fullB[j] != 0.0;
+                    for (size_t i = 0; i < N; ++i)
+                    {
+                        if (! isActive (i))
+                            continue;
+                        readByOthers = readByOthers || fullA[i * N + j] != 0.0;
+                        writtenByOthers = writtenByOthers || fullA[j * N + i] != 0.0;
+                    }
+
+                    if (! readByOthers || ! writtenByOthers)
+                    {
+                        activeStates[j] = 0;
+                        changed = true;
+                    }
+                }
+            }
 
-    private:
-        const std::string type;
+            numStates = 0;
+            for (size_t i = 0; i < N; ++i)
+                numStates += activeStates[i];
 
-        WDF<T>* wdfParent = nullptr;
+            const auto M = (size_t) numStates;
+            size_t row = 0;
+            for (size_t i = 0; i < N; ++i)
+            {
+                if (! isActive (i))
+                    continue;
+
+                size_t col = 0;
+                for (size_t j = 0; j < N; ++j)
+                    if (isActive (j))
+                        A[row * M + col++] = fullA[i * N + j];
+
+                B[row] = fullB[i];
+                C[row] = fullC[i];
+                row++;
+            }
+        }
+
+        std::vector<double> fullA, fullB, fullC;
+        std::vector<double> state;
+        std::vector<int> activeStates;
+        CircuitStateBuffer originalState;
+
+        std::vector<double> A, B, C;
+        double D = 0.0;
+        int numStates = 0;
     };
 
-    template <typename T, typename WDFType>
-    class WDFWrapper : public WDF<T>
+    /**
+     * Runs a linear circuit through its state-space model, computing a block of samples
+     * at a time.
+     *
+     * Processing a circuit sample-by-sample is limited by the dependency of each sample
+     * on the previous one. With the state-space model (see LinearStateSpace), a sub-block
+     * of K samples can instead be computed from the state at the start of the sub-block:
+     * y = O x + T u, and the state at the end of the sub-block is A^K x + G u, where the
+     * rows of O are C A^k, T is the (lower-triangular Toeplitz) matrix of the impulse
+     * response, and the columns of G are A^(K-1-j) B. Those matrices are precomputed in
+     * update(), and processBlock() then works in three passes over the buffer:
+     *
+     * 1. G u for every sub-block (a matrix-matrix product),
+     * 2. the state at the start of every sub-block (the only sequential pass, with one
+     *    step per sub-block rather than per sample),
+     * 3. O x + T u for every sub-block (another matrix-matrix product).
+     *
+     * The products have no dependencies between samples, so they vectorise well, which
+     * makes this a good fit for offline rendering, or other long blocks. Any samples left
+     * over after the last complete sub-block are processed sample-by-sample.
+     *
+     * The processor starts from a zero state. All memory is allocated in prepare(), so
+     * update() may be called from the audio thread when the parameters change, although
+     * it costs roughly one sample of circuit processing per circuit state variable, plus
+     * O(K M^2 + M^3 log K) for the precomputed matrices (for M states in the reduced model).
+     * The processor state carries over to the new model, as long as it keeps the same circuit
+     * state variables, otherwise the processor is reset.
+     * ```cpp
+     * wdft::StateSpaceBlockProcessor<float> processor;
+     * processor.prepare (circuit.getRoot(), maxBlockSize);
+     *
+     * // whenever the parameters change...
+     * processor.update (circuit.getRoot(), [&] (float x) { return circuit.processSample (x); });
+     *
+     * // when rendering...
+     * processor.processBlock (buffer, numSamples);
+     * ```
+     */
+    template <typename T = float>
+    class StateSpaceBlockProcessor
     {
     public:
-        template <typename... Args>
-        explicit WDFWrapper (const std::string& name, Args&&... args) : WDF<T> (name),
-                                                                        internalWDF (std::forward<Args> (args)...)
+        StateSpaceBlockProcessor() = default;
+
+        /**
+         * Allocates the memory needed for this circuit.
+         *
+         * @param root              the root of the WDF tree.
+         * @param maxBlockSize      the largest number of samples processed in one pass (larger blocks are split up).
+         * @param subBlockSizeToUse the number of samples computed from each state (K), which must be at least 1.
+         */
+        template <typename RootType>
+        void prepare (RootType& root, int maxBlockSize, int subBlockSizeToUse = 32)
         {
-            calcImpedance();
+            model.prepare (root);
+
+            size_t maxStates = 0;
+            visitCircuitState (root, [&maxStates] (auto&) { maxStates++; });
+
+            subBlockSize = std::max (subBlockSizeToUse, 1);
+            maxSubBlocks = std::max (maxBlockSize / subBlockSize, 1);
+
+            const auto M = maxStates;
+            const auto K = (size_t) subBlockSize;
+            powerScratch.assign (3 * M * M, 0.0);
+            vectorScratch.assign (2 * M, 0.0);
+
+            A.assign (M * M, (T) 0);
+            B.assign (M, (T) 0);
+            C.assign (M, (T) 0);
+            AK.assign (M * M, (T) 0);
+            outputMatrix.assign (M * K, (T) 0);
+            impulseResponse.assign (K, (T) 0);
+            inputMatrix.assign (K * M, (T) 0);
+
+            state.assign (M, (T) 0);
+            nextState.assign (M, (T) 0);
+            blockInputs.assign ((size_t) maxSubBlocks * M, (T) 0);
+            blockStates.assign ((size_t) maxSubBlocks * M, (T) 0);
+            subBlockOutput.assign (K, (T) 0);
+            usedCircuitStates.assign (M, 0);
+
+            numStates = 0;
+            D = (T) 0;
         }
 
-        /** Computes the impedance of the WDF resistor, Z_R = R. */
-        inline void calcImpedance() override
+        /**
+         * Re-measures the circuit's state-space model for its current parameters, and
+         * updates the precomputed matrices. The circuit state is restored afterwards.
+         *
+         * @param root              the root of the WDF tree.
+         * @param processSample     a function which processes one sample of the circuit, and
+         *                          returns the output sample, i.e. T processSample (T x).
+         */
+        template <typename RootType, typename ProcessFunc>
+        void update (RootType& root, ProcessFunc&& processSample) noexcept
         {
-            internalWDF.calcImpedance();
-            this->wdf.R = internalWDF.wdf.R;
-            this->wdf.G = internalWDF.wdf.G;
+            model.update (root, processSample);
+
+            // the processor state only carries over if the model keeps the same circuit states
+            const auto* modelStates = model.getUsedCircuitStates();
+            numStates = model.getNumStates();
+            if (! std::equal (usedCircuitStates.begin(), usedCircuitStates.end(), modelStates))
+            {
+                std::copy (modelStates, modelStates + usedCircuitStates.size(), usedCircuitStates.begin());
+                reset();
+            }
+
+            computeMatrices();
         }
 
-        /** Accepts an incident wave into a WDF resistor. */
-        inline void incident (T x) noexcept override
+        /** Resets the processor state. */
+        void reset() noexcept
         {
-            this->wdf.a = x;
-            internalWDF.incident (x);
+            std::fill (state.begin(), state.end(), (T) 0);
         }
 
-        /** Propogates a reflected wave from a WDF resistor. */
-        inline T reflected() noexcept override
+        /** Processes a block of samples in-place. */
+        void processBlock (T* buffer, int numSamples) noexcept
         {
-            this->wdf.b = internalWDF.reflected();
-            return this->wdf.b;
-        }
+            const auto maxSamplesPerPass = maxSubBlocks * subBlockSize;
+            while (numSamples >= subBlockSize)
+            {
+                const auto numSubBlocks = std::min (numSamples, maxSamplesPerPass) / subBlockSize;
+                processSubBlocks (buffer, numSubBlocks);
+                buffer += numSubBlocks * subBlockSize;
+                numSamples -= numSubBlocks * subBlockSize;
+            }
 
-    protected:
-        WDFType internalWDF;
-    };
+            for (int n = 0; n < numSamples; ++n)
+                buffer[n] = processSample (buffer[n]);
+        }
 
-    template <typename T, typename WDFType>
-    class WDFRootWrapper : public WDFWrapper<T, WDFType>
-    {
-    public:
-        template <typename Next, typename... Args>
-        WDFRootWrapper (const std::string& name, Next& next, Args&&... args) : WDFWrapper<T, WDFType> (name, std::forward<Args> (args)...)
+        /** Processes a single sample, with the state-space recursion. */
+        inline T processSample (T x) noexcept
         {
-            next.connectToNode (this);
-            calcImpedance();
+            const auto M = numStates;
+            auto y = D * x;
+            for (int i = 0; i < M; ++i)
+                y += C[(size_t) i] * state[(size_t) i];
+
+            for (int i = 0; i < M; ++i)
+            {
+                auto sum = B[(size_t) i] * x;
+                for (int j = 0; j < M; ++j)
+                    sum += A[(size_t) (i * M + j)] * state[(size_t) j];
+                nextState[(size_t) i] = sum;
+            }
+            std::copy (nextState.begin(), nextState.begin() + M, state.begin());
+
+            return y;
         }
 
-        inline void propagateImpedance() override
+        /** Returns the number of state variables in the circuit's (reduced) state-space model. */
+        int getNumStates() const noexcept { return numStates; }
+
+        /** Returns the circuit's state-space model. */
+        const LinearStateSpace<T>& getModel() const noexcept { return model; }
+
+    private:
+        /** Computes the matrices used to process each sub-block (in double precision) */
+        void computeMatrices() noexcept
+        {
+            const auto M = (size_t) numStates;
+            const auto K = (size_t) subBlockSize;
+            const auto* modelA = model.getA();
+            const auto* modelB = model.getB();
+            const auto* modelC = model.getC();
+
+            for (size_t i = 0; i < M * M; ++i)
+                A[i] = (T) modelA[i];
+            for (size_t i = 0; i < M; ++i)
+            {
+                B[i] = (T) modelB[i];
+                C[i] = (T) modelC[i];
+            }
+            D = (T) model.getD();
+
+            // O: row-major (M x K), with column k = (C A^k)^T, and the impulse response C A^(k-1) B
+            auto* rowVec = vectorScratch.data();
+            auto* tempVec = vectorScratch.data() + M;
+            std::copy (modelC, modelC + M, rowVec);
+            impulseResponse[0] = D;
+            for (size_t k = 0; k < K; ++k)
+            {
+                double h = 0.0;
+                for (size_t i = 0; i < M; ++i)
+                {
+                    outputMatrix[i * K + k] = (T) rowVec[i];
+                    h += rowVec[i] * modelB[i];
+                }
+                if (k + 1 < K)
+                    impulseResponse[k + 1] = (T) h;
+
+                for (size_t j = 0; j < M; ++j)
+                {
+                    double sum = 0.0;
+                    for (size_t i = 0; i < M; ++i)
+                        sum += rowVec[i] * modelA[i * M + j];
+                    tempVec[j] = sum;
+                }
+                std::copy (tempVec, tempVec + M, rowVec);
+            }
+
+            // G: stored transposed (K x M), with row j = (A^(K-1-j) B)^T
+            auto* colVec = vectorScratch.data();
+            std::copy (modelB, modelB + M, colVec);
+            for (size_t k = 0; k < K; ++k)
+            {
+                for (size_t i = 0; i < M; ++i)
+                    inputMatrix[(K - 1 - k) * M + i] = (T) colVec[i];
+
+                for (size_t i = 0; i < M; ++i)
+                {
+                    double sum = 0.0;
+                    for (size_t j = 0; j < M; ++j)
+                        sum += modelA[i * M + j] * colVec[j];
+                    tempVec[i] = sum;
+                }
+                std::copy (tempVec, tempVec + M, colVec);
+            }
+
+            // A^K, by repeated squaring
+            auto* power = powerScratch.data();
+            auto* square = powerScratch.data() + M * M;
+            auto* temp = powerScratch.data() + 2 * M * M;
+            std::fill (power, power + M * M, 0.0);
+            for (size_t i = 0; i < M; ++i)
+                power[i * M + i] = 1.0;
+            std::copy (modelA, modelA + M * M, square);
+            for (auto k = K; k > 0; k >>= 1)
+            {
+                if ((k & 1) != 0)
+                {
+                    multiply (power, square, temp, M);
+                    std::copy (temp, temp + M * M, power);
+                }
+
+                if (k > 1)
+                {
+                    multiply (square, square, temp, M);
+                    std::copy (temp, temp + M * M, square);
+                }
+            }
+            for (size_t i = 0; i < M * M; ++i)
+                AK[i] = (T) power[i];
+        }
+
+        /** result = left * right, for M x M row-major matrices */
+        static void multiply (const double* left, const double* right, double* result, size_t M) noexcept
         {
-            this->calcImpedance();
+            for (size_t i = 0; i < M; ++i)
+            {
+                for (size_t j = 0; j < M; ++j)
+                {
+                    double sum = 0.0;
+                    for (size_t l = 0; l < M; ++l)
+                        sum += left[i * M + l] * right[l * M + j];
+                    result[i * M + j] = sum;
+                }
+            }
         }
 
-        inline void calcImpedance() override
+        void processSubBlocks (T* buffer, int numSubBlocks) noexcept
         {
-            this->internalWDF.calcImpedance();
+            const auto M = numStates;
+            const auto K = subBlockSize;
+
+            // 1. the contribution of each sub-block's input to the state at the end of the sub-block
+            for (int b = 0; b < numSubBlocks; ++b)
+            {
+                auto* g = blockInputs.data() + b * M;
+                const auto* u = buffer + b * K;
+                std::fill (g, g + M, (T) 0);
+                for (int j = 0; j < K; ++j)
+                {
+                    const auto* G = inputMatrix.data() + j * M;
+                    for (int i = 0; i < M; ++i)
+                        g[i] += G[i] * u[j];
+                }
+            }
+
+            // 2. the state at the start of each sub-block
+            for (int b = 0; b < numSubBlocks; ++b)
+            {
+                auto* x = blockStates.data() + b * M;
+                std::copy (state.begin(), state.begin() + M, x);
+
+                const auto* g = blockInputs.data() + b * M;
+                for (int i = 0; i < M; ++i)
+                {
+                    auto sum = g[i];
+                    for (int j = 0; j < M; ++j)
+                        sum += AK[(size_t) (i * M + j)] * x[j];
+                    state[(size_t) i] = sum;
+                }
+            }
+
+            // 3. the output of each sub-block, from its initial state and input
+            auto* y = subBlockOutput.data();
+            const auto* h = impulseResponse.data();
+            for (int b = 0; b < numSubBlocks; ++b)
+            {
+                const auto* x = blockStates.data() + b * M;
+                auto* u = buffer + b * K;
+
+                std::fill (y, y + K, (T) 0);
+                for (int i = 0; i < M; ++i)
+                {
+                    const auto* O = outputMatrix.data() + i * K;
+                    for (int k = 0; k < K; ++k)
+                        y[k] += O[k] * x[i];
+                }
+
+                for (int j = 0; j < K; ++j)
+                    for (int k = j; k < K; ++k)
+                        y[k] += h[k - j] * u[j];
+
+                std::copy (y, y + K, u);
+            }
         }
+
+        LinearStateSpace<T> model;
+        std::vector<double> powerScratch, vectorScratch;
+
+        std::vector<T> A, B, C, AK;
+        T D = (T) 0;
+        std::vector<T> outputMatrix, impulseResponse, inputMatrix;
+
+        std::vector<T> state, nextState;
+        std::vector<T> blockInputs, blockStates, subBlockOutput;
+        std::vector<int> usedCircuitStates;
+
+        int numStates = 0;
+        int subBlockSize = 32;
+        int maxSubBlocks = 1;
     };
-} // namespace wdf
+} // namespace wdft
 } // namespace chowdsp
 
-#endif //CHOWDSP_WDF_WDF_BASE_H
+#endif //CHOWDSP_WDF_LINEAR_STATE_SPACE_H
 
-// #include "rtype_detail.h"
+// #include "util/linear_circuit_filter.h"
+#ifndef CHOWDSP_WDF_LINEAR_CIRCUIT_FILTER_H
+#define CHOWDSP_WDF_LINEAR_CIRCUIT_FILTER_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// #include "linear_state_space.h"
 
 
 namespace chowdsp
 {
-namespace wdf
+namespace wdft
 {
-    /**
-     *  A non-adaptable R-Type adaptor.
-     *  For more information see: https://searchworks.stanford.edu/view/11891203, chapter 2
-     */
-    template <typename T>
-    class RootRtypeAdaptor : public WDF<T>
+#ifndef DOXYGEN
+    namespace iir_detail
     {
-    public:
-        RootRtypeAdaptor (std::initializer_list<WDF<T>*> dps)
-            : WDF<T> ("Root R-Type Adaptor"),
-              downPorts (dps),
-              S_matrix (downPorts.size(), downPorts.size()),
-              a_vec (downPorts.size()),
-              b_vec (downPorts.size())
+        /** Row-major access to an n x n matrix */
+        struct MatrixRef
         {
-            for (auto* port : downPorts)
-                port->connectToParent (this);
+            double* data;
+            int n;
+
+            double& operator() (int row, int col) noexcept { return data[row * n + col]; }
+        };
+
+        /**
+         * Balances the matrix with a diagonal similarity transform D^-1 A D, to improve the
+         * accuracy of the eigenvalues. Each diagonal element of D is a power of 2 (so the
+         * scaling is exact), chosen to bring the off-diagonal norms of the matching row and
+         * column close together.
+         */
+        inline void balance (MatrixRef a) noexcept
+        {
+            constexpr int maxSweeps = 32;
+            for (int sweep = 0; sweep < maxSweeps; ++sweep)
+            {
+                bool changed = false;
+                for (int i = 0; i < a.n; ++i)
+                {
+                    double rowNorm = 0.0, colNorm = 0.0;
+                    for (int j = 0; j < a.n; ++j)
+                    {
+                        if (j != i)
+                        {
+                            rowNorm += std::abs (a (i, j));
+                            colNorm += std::abs (a (j, i));
+                        }
+                    }
+
+                    if (rowNorm == 0.0 || colNorm == 0.0)
+                        continue;
+
+                    // scaling the row by 1/f and the column by f balances the norms when f = sqrt (rowNorm / colNorm)
+                    const auto f = std::exp2 (std::round (0.5 * std::log2 (rowNorm / colNorm)));
+                    if (colNorm * f + rowNorm / f >= 0.95 * (colNorm + rowNorm))
+                        continue;
+
+                    changed = true;
+                    for (int j = 0; j < a.n; ++j)
+                    {
+                        a (i, j) /= f;
+                        a (j, i) *= f;
+                    }
+                }
+
+                if (! changed)
+                    break;
+            }
         }
 
-        /** Returns the number of ports connected to RootRtypeAdaptor */
-        size_t getNumPorts() const noexcept { return downPorts.size(); }
-
         /**
-         * Returns the port impedance for the given port index.
-         * Note: it is the caller's responsibility to ensure that the portIndex is in range!
+         * A Householder reflection P = I - beta v v^T, of size 2 or 3, which maps the vector
+         * it was made from onto the first axis.
          */
-        T getPortImpedance (size_t portIndex) const noexcept { return downPorts[portIndex]->wdf.R; }
+        struct Reflector
+        {
+            double v[3] {};
+            double beta = 0.0;
+            double alpha = 0.0; // the first element of the reflected vector
+            int size = 0;
 
-        /** Recomputes internal variables based on the incoming impedances */
-        void calcImpedance() override
+            Reflector (const double* x, int vectorSize) noexcept : size (vectorSize)
+            {
+                double norm = 0.0;
+                for (int i = 0; i < size; ++i)
+                    norm += x[i] * x[i];
+                norm = std::sqrt (norm);
+                if (norm == 0.0)
+                    return; // identity
+
+                // reflect away from x[0], to avoid cancellation
+                alpha = x[0] >= 0.0 ? -norm : norm;
+                std::copy (x, x + size, v);
+                v[0] -= alpha;
+
+                double vNormSq = 0.0;
+                for (int i = 0; i < size; ++i)
+                    vNormSq += v[i] * v[i];
+                beta = 2.0 / vNormSq;
+            }
+
+            /** a := P a, for rows [row, row + size) and columns [firstCol, lastCol] */
+            void applyLeft (MatrixRef a, int row, int firstCol, int lastCol) const noexcept
+            {
+                for (int j = firstCol; j <= lastCol; ++j)
+                {
+                    double dot = 0.0;
+                    for (int i = 0; i < size; ++i)
+                        dot += v[i] * a (row + i, j);
+                    dot *= beta;
+                    for (int i = 0; i < size; ++i)
+                        a (row + i, j) -= dot * v[i];
+                }
+            }
+
+            /** a := a P, for columns [col, col + size) and rows [firstRow, lastRow] */
+            void applyRight (MatrixRef a, int col, int firstRow, int lastRow) const noexcept
+            {
+                for (int i = firstRow; i <= lastRow; ++i)
+                {
+                    double dot = 0.0;
+                    for (int j = 0; j < size; ++j)
+                        dot += a (i, col + j) * v[j];
+                    dot *= beta;
+                    for (int j = 0; j < size; ++j)
+                        a (i, col + j) -= dot * v[j];
+                }
+            }
+        };
+
+        /** Reduces the matrix to upper Hessenberg form, with Householder similarity transforms */
+        inline void reduceToHessenberg (MatrixRef a) noexcept
         {
-            impedanceCalculator (*this);
+            const auto n = a.n;
+            for (int k = 0; k < n - 2; ++k)
+            {
+                // zero column k below the sub-diagonal from the bottom up, reflecting
+                // each element against the element above it
+                for (int row = n - 2; row > k; --row)
+                {
+                    const double x[2] { a (row, k), a (row + 1, k) };
+                    if (x[1] == 0.0)
+                        continue;
+
+                    const Reflector p { x, 2 };
+                    p.applyLeft (a, row, k, n - 1);
+                    p.applyRight (a, row, 0, n - 1);
+                    a (row, k) = p.alpha;
+                    a (row + 1, k) = 0.0;
+                }
+            }
         }
 
-        /** Use this function to set the scattering matrix data. */
-        template <size_t N>
-        void setSMatrixData (const T (&mat)[N][N])
+        /** Computes the eigenvalues of a real 2x2 matrix [[p, q], [r, s]] */
+        inline void eigenvalues2x2 (double p, double q, double r, double s, double* re, double* im) noexcept
         {
-            const auto numPorts = a_vec.size();
-            for (int i = 0; i < numPorts; ++i)
-                for (int j = 0; j < numPorts; ++j)
-                    S_matrix[j][i] = mat[i][j];
+            const auto halfDiff = 0.5 * (p - s);
+            const auto discriminant = halfDiff * halfDiff + q * r;
+            if (discriminant >= 0.0)
+            {
+                // the larger root is found directly, and the other from the product of the roots, to avoid cancellation
+                const auto z = halfDiff + std::copysign (std::sqrt (discriminant), halfDiff);
+                re[0] = s + z;
+                re[1] = z != 0.0 ? s - q * r / z : s;
+                im[0] = im[1] = 0.0;
+            }
+            else
+            {
+                re[0] = re[1] = s + halfDiff;
+                im[0] = std::sqrt (-discriminant);
+                im[1] = -im[0];
+            }
         }
 
-        /** Computes both the incident and reflected waves at this root node. */
-        inline void compute() noexcept
+        /**
+         * One implicit double-shift (Francis) QR step on the active block [lo, hi] of an
+         * upper Hessenberg matrix, with the shifts at the eigenvalues of the trailing 2x2
+         * block (given by their sum and product). Only the active block is updated, since
+         * that is all that is needed for the eigenvalues.
+         */
+        inline void francisStep (MatrixRef a, int lo, int hi, double shiftSum, double shiftProduct) noexcept
         {
-            rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+            // the first column of (H - mu1 I) (H - mu2 I), which only has 3 non-zero elements
+            double x[3] {
+                a (lo, lo) * a (lo, lo) + a (lo, lo + 1) * a (lo + 1, lo) - shiftSum * a (lo, lo) + shiftProduct,
+                a (lo + 1, lo) * (a (lo, lo) + a (lo + 1, lo + 1) - shiftSum),
+                a (lo + 1, lo) * a (lo + 2, lo + 1),
+            };
 
-            int i = 0;
-            for (auto* port : downPorts)
+            // chase the bulge down the sub-diagonal
+            for (int k = lo; k < hi - 1; ++k)
             {
-                port->incident (b_vec[i]);
-                a_vec[i] = port->reflected();
-                i++;
+                const Reflector p { x, 3 };
+                const auto firstCol = std::max (k - 1, lo);
+                p.applyLeft (a, k, firstCol, hi);
+                p.applyRight (a, k, lo, std::min (k + 3, hi));
+                if (k > lo)
+                {
+                    a (k, k - 1) = p.alpha;
+                    a (k + 1, k - 1) = a (k + 2, k - 1) = 0.0;
+                }
+
+                x[0] = a (k + 1, k);
+                x[1] = a (k + 2, k);
+                x[2] = k + 3 <= hi ? a (k + 3, k) : 0.0;
             }
+
+            const Reflector p { x, 2 };
+            p.applyLeft (a, hi - 1, hi - 2, hi);
+            p.applyRight (a, hi - 1, lo, hi);
+            a (hi - 1, hi - 2) = p.alpha;
+            a (hi, hi - 2) = 0.0;
         }
 
-        /** Implement this function to set the scattering matrix when an incoming impedance changes */
-        std::function<void (RootRtypeAdaptor&)> impedanceCalculator = [] (auto&) {};
+        /**
+         * Computes the eigenvalues of an upper Hessenberg matrix (which is overwritten), using
+         * the implicit double-shift QR algorithm, so that complex eigenvalues come out in exact
+         * conjugate pairs. Returns false if the algorithm fails to converge.
+         */
+        inline bool hessenbergEigenvalues (MatrixRef a, double* re, double* im) noexcept
+        {
+            constexpr auto eps = std::numeric_limits<double>::epsilon();
+            constexpr int maxIterationsPerEigenvalue = 64;
 
-    private:
-        void incident (T) noexcept override {}
-        T reflected() noexcept override { return T {}; }
+            double norm = 0.0;
+            for (int i = 0; i < a.n; ++i)
+                for (int j = std::max (i - 1, 0); j < a.n; ++j)
+                    norm += std::abs (a (i, j));
 
-        std::vector<WDF<T>*> downPorts;
+            int hi = a.n - 1;
+            int iterations = 0;
+            while (hi >= 0)
+            {
+                // look for a negligible sub-diagonal element, which splits off the block [lo, hi]
+                int lo = hi;
+                while (lo > 0)
+                {
+                    auto scale = std::abs (a (lo - 1, lo - 1)) + std::abs (a (lo, lo));
+                    if (scale == 0.0)
+                        scale = norm;
+                    if (std::abs (a (lo, lo - 1)) <= eps * scale)
+                    {
+                        a (lo, lo - 1) = 0.0;
+                        break;
+                    }
+                    --lo;
+                }
+
+                if (lo == hi)
+                {
+                    re[hi] = a (hi, hi);
+                    im[hi] = 0.0;
+                    hi -= 1;
+                    iterations = 0;
+                    continue;
+                }
+
+                if (lo == hi - 1)
+                {
+                    eigenvalues2x2 (a (hi - 1, hi - 1), a (hi - 1, hi), a (hi, hi - 1), a (hi, hi), re + hi - 1, im + hi - 1);
+                    hi -= 2;
+                    iterations = 0;
+                    continue;
+                }
+
+                if (++iterations > maxIterationsPerEigenvalue)
+                    return false;
+
+                if (iterations % 16 == 0)
+                {
+                    // every so often, shift by a complex pair at centre + radius * exp (+/-j) instead,
+                    // in case the standard shifts have settled into a cycle (e.g. for a permutation
+                    // matrix). The angle is arbitrary, but must not be a multiple of pi / 2, so that
+                    // the shifts separate eigenvalues which are symmetric about the centre.
+                    const auto centre = a (hi, hi);
+                    const auto radius = std::abs (a (hi, hi - 1)) + std::abs (a (hi - 1, hi - 2));
+                    const auto shiftReal = centre + radius * std::cos (1.0);
+                    const auto shiftImag = radius * std::sin (1.0);
+                    francisStep (a, lo, hi, 2.0 * shiftReal, shiftReal * shiftReal + shiftImag * shiftImag);
+                }
+                else
+                {
+                    const auto shiftSum = a (hi - 1, hi - 1) + a (hi, hi);
+                    const auto shiftProduct = a (hi - 1, hi - 1) * a (hi, hi) - a (hi - 1, hi) * a (hi, hi - 1);
+                    francisStep (a, lo, hi, shiftSum, shiftProduct);
+                }
+            }
 
-        rtype_detail::Matrix<T> S_matrix; // square matrix representing S
-        rtype_detail::AlignedArray<T> a_vec; // temp matrix of inputs to Rport
-        rtype_detail::AlignedArray<T> b_vec; // temp matrix of outputs from Rport
-    };
+            return true;
+        }
+
+        /**
+         * Solves the least-squares problem min |phi * x - h|, for a (column-major) numRows x numCols
+         * matrix phi, using Householder QR. phi and h are overwritten. Returns false if phi is rank-deficient.
+         */
+        inline bool solveLeastSquares (double* phi, double* h, double* x, int numRows, int numCols) noexcept
+        {
+            auto Phi = [phi, numRows] (int row, int col) -> double& { return phi[col * numRows + row]; };
+
+            for (int k = 0; k < numCols; ++k)
+            {
+                double norm = 0.0;
+                for (int i = k; i < numRows; ++i)
+                    norm += Phi (i, k) * Phi (i, k);
+                norm = std::sqrt (norm);
+                if (norm == 0.0)
+                    return false;
+
+                // Householder vector v = phi[k:, k] + sign (phi[k, k]) * |phi[k:, k]| * e_k, stored in-place
+                const auto alpha = Phi (k, k) >= 0.0 ? -norm : norm;
+                Phi (k, k) -= alpha;
+                double vNormSq = 0.0;
+                for (int i = k; i < numRows; ++i)
+                    vNormSq += Phi (i, k) * Phi (i, k);
+
+                auto reflect = [&] (auto&& column)
+                {
+                    double dot = 0.0;
+                    for (int i = k; i < numRows; ++i)
+                        dot += Phi (i, k) * column (i);
+                    const auto scale = 2.0 * dot / vNormSq;
+                    for (int i = k; i < numRows; ++i)
+                        column (i) -= scale * Phi (i, k);
+                };
+
+                for (int j = k + 1; j < numCols; ++j)
+                    reflect ([&Phi, j] (int i) -> double& { return Phi (i, j); });
+                reflect ([h] (int i) -> double& { return h[i]; });
+
+                // the diagonal of R
+                x[k] = alpha;
+            }
+
+            // back-substitution, with R stored above the diagonal of phi
+            for (int k = numCols - 1; k >= 0; --k)
+            {
+                const auto diagonal = x[k];
+                if (std::abs (diagonal) == 0.0)
+                    return false;
+
+                auto sum = h[k];
+                for (int j = k + 1; j < numCols; ++j)
+                    sum -= Phi (k, j) * x[j];
+                x[k] = sum / diagonal;
+            }
+
+            return true;
+        }
+    } // namespace iir_detail
+#endif // DOXYGEN
 
     /**
-     *  An adaptable R-Type adaptor.
-     *  For more information see: https://searchworks.stanford.edu/view/11891203, chapter 2
+     * Runs a linear circuit as an equivalent IIR filter.
+     *
+     * A circuit made up of only linear elements (resistors, capacitors, inductors, linear
+     * sources, and adaptors, including R-Type adaptors) is a linear time-invariant filter,
+     * for fixed parameter values. update() analyses the circuit for its current parameters,
+     * and derives a bank of second-order sections, running in parallel, with the same
+     * impulse response:
+     *
+     * - The state-space model of the circuit is measured (see LinearStateSpace), and the
+     *   poles are found from the eigenvalues of its state-transition matrix.
+     * - The poles are paired into second-order sections (complex conjugate pairs, or
+     *   neighbouring real poles), and the section numerators are fit to the impulse
+     *   response of the model with least squares. Poles at (or very close to) zero,
+     *   which come from wave variables that are only delayed by a sample, become the
+     *   taps of a short FIR filter.
+     *
+     * Since the sections run in parallel, rather than in cascade, they can be processed
+     * side-by-side, which vectorises well. The analysis restores the circuit state when
+     * it is done, and all memory is allocated in prepare(), so update() does not allocate.
+     * However, the impulse response fit makes update() much more expensive than a sample
+     * of circuit processing (hundreds of microseconds for a tone stack), so it is best
+     * run from a background thread, or for occasional parameter changes, rather than for
+     * every block of a modulated parameter.
+     *
+     * The circuit must not have any non-zero inputs other than the processed signal (e.g.
+     * bias voltages), since the analysis assumes that the circuit is linear, not affine.
+     * ```cpp
+     * wdft::LinearCircuitFilter<float> filter;
+     * filter.prepare (circuit.getRoot());
+     *
+     * // whenever the parameters change...
+     * circuit.setParams (bass, treble);
+     * filter.update (circuit.getRoot(), [&] (float x) { return circuit.processSample (x); });
+     *
+     * // in the audio callback...
+     * filter.processBlock (buffer, numSamples);
+     * ```
      */
-    template <typename T>
-    class RtypeAdaptor : public WDF<T>
+    template <typename T = float>
+    class LinearCircuitFilter
     {
     public:
-        /** The upPortIndex argument describes with port of the scattering matrix is being adapted. */
-        RtypeAdaptor (std::initializer_list<WDF<T>*> dps, int upPortIndex)
-            : WDF<T> ("R-Type Adaptor"),
-              m_upPortIndex (upPortIndex),
-              downPorts (dps),
-              S_matrix (downPorts.size() + 1, downPorts.size() + 1),
-              a_vec (downPorts.size() + 1),
-              b_vec (downPorts.size() + 1)
+        LinearCircuitFilter() = default;
+
+        /** Allocates the memory needed to analyse this circuit. */
+        template <typename RootType>
+        void prepare (RootType& root)
         {
-            for (auto* port : downPorts)
-                port->connectToParent (this);
-        }
+            model.prepare (root);
 
-        /** Returns the number of ports connected to RtypeAdaptor */
-        size_t getNumPorts() const noexcept { return downPorts.size() + 1; }
+            size_t numStates = 0;
+            visitCircuitState (root, [&numStates] (auto&) { numStates++; });
+
+            const auto N = (int) numStates;
+            impulseState.assign (2 * numStates, 0.0);
+            eigenMatrix.assign (numStates * numStates, 0.0);
+            polesReal.assign (numStates, 0.0);
+            polesImag.assign (numStates, 0.0);
+            denominators.assign (2 * numStates, 0.0);
+
+            const auto maxUnknowns = N + 1;
+            const auto maxImpulseLength = getImpulseLength (maxUnknowns);
+            impulseResponse.assign ((size_t) maxImpulseLength, 0.0);
+            fitTarget.assign ((size_t) maxImpulseLength, 0.0);
+            basis.assign ((size_t) (maxImpulseLength * maxUnknowns), 0.0);
+            fitCoefs.assign ((size_t) maxUnknowns, 0.0);
+
+            b0.assign (numStates, (T) 0);
+            b1.assign (numStates, (T) 0);
+            a1.assign (numStates, (T) 0);
+            a2.assign (numStates, (T) 0);
+            s1.assign (numStates, (T) 0);
+            s2.assign (numStates, (T) 0);
+            firTaps.assign (numStates + 1, (T) 0);
+            firState.assign (numStates + 1, (T) 0);
+
+            numSections = 0;
+            numFirTaps = 0;
+        }
 
         /**
-         * Returns the port impedance for the given port index.
-         * Note: it is the caller's responsibility to ensure that the portIndex is in range!
+         * Re-analyses the circuit for its current parameters, and updates the filter coefficients.
+         *
+         * @param root              the root of the WDF tree.
+         * @param processSample     a function which processes one sample of the circuit, and
+         *                          returns the output sample, i.e. T processSample (T x).
+         * @return                  true if the analysis succeeded. If the analysis fails, the
+         *                          previous filter coefficients are kept.
          */
-        T getPortImpedance (size_t portIndex) const noexcept { return downPorts[portIndex]->wdf.R; }
-
-        /** Recomputes internal variables based on the incoming impedances */
-        void calcImpedance() override
+        template <typename RootType, typename ProcessFunc>
+        bool update (RootType& root, ProcessFunc&& processSample) noexcept
         {
-            this->wdf.R = impedanceCalculator (*this);
-            this->wdf.G = (T) 1 / this->wdf.R;
+            model.update (root, processSample);
+            if (! findPoles())
+                return false;
+
+            // every pole adds one unknown to the fit, plus the feed-through term
+            impulseLength = getImpulseLength (numPoles + 1);
+            computeImpulseResponse();
+
+            return fitSections();
         }
 
-        /** Use this function to set the scattering matrix data. */
-        template <size_t N>
-        void setSMatrixData (const T (&mat)[N][N])
+        /** Resets the filter state. */
+        void reset() noexcept
         {
-            const auto numPorts = a_vec.size();
-            for (int i = 0; i < numPorts; ++i)
-                for (int j = 0; j < numPorts; ++j)
-                    S_matrix[j][i] = mat[i][j];
+            std::fill (s1.begin(), s1.end(), (T) 0);
+            std::fill (s2.begin(), s2.end(), (T) 0);
+            std::fill (firState.begin(), firState.end(), (T) 0);
         }
 
-        /** Computes the incident wave. */
-        inline void incident (T downWave) noexcept override
+        /** Processes a single sample through the filter. */
+        inline T processSample (T x) noexcept
         {
-            this->wdf.a = downWave;
-            a_vec[m_upPortIndex] = this->wdf.a;
+            // FIR part
+            for (int i = numFirTaps - 1; i > 0; --i)
+                firState[(size_t) i] = firState[(size_t) i - 1];
+            firState[0] = x;
 
-            rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+            T y = (T) 0;
+            for (int i = 0; i < numFirTaps; ++i)
+                y += firTaps[(size_t) i] * firState[(size_t) i];
 
-            int i = 0;
-            for (auto* port : downPorts)
+            // parallel second-order sections (transposed direct form II)
+            auto* b0Data = b0.data();
+            auto* b1Data = b1.data();
+            auto* a1Data = a1.data();
+            auto* a2Data = a2.data();
+            auto* s1Data = s1.data();
+            auto* s2Data = s2.data();
+            for (int k = 0; k < numSections; ++k)
             {
-                auto portIndex = getPortIndex (i);
-                port->incident (b_vec[i]);
-                i++;
+                const auto yk = b0Data[k] * x + s1Data[k];
+                s1Data[k] = b1Data[k] * x - a1Data[k] * yk + s2Data[k];
+                s2Data[k] = -a2Data[k] * yk;
+                y += yk;
             }
+
+            return y;
         }
 
-        /** Computes the reflected wave */
-        inline T reflected() noexcept override
+        /** Processes a block of samples in-place. */
+        void processBlock (T* buffer, int numSamples) noexcept
         {
-            int i = 0;
-            for (auto* port : downPorts)
-            {
-                auto portIndex = getPortIndex (i);
-                a_vec[portIndex] = port->reflected();
-                i++;
-            }
-
-            // S_matrix[m_upPortIndex][m_upPortIndex] is zero, so this is fine without a fresh a_vec[m_upPortIndex].
-            this->wdf.b = rtype_detail::RtypeScatterSingle (S_matrix, a_vec, m_upPortIndex);
-            return this->wdf.b;
+            for (int n = 0; n < numSamples; ++n)
+                buffer[n] = processSample (buffer[n]);
         }
 
-        /** Implement this function to set the scattering matrix when an incoming impedance changes */
-        std::function<T (RtypeAdaptor&)> impedanceCalculator = [] (auto&) { return (T) 1; };
+        /** Returns the number of second-order sections in the filter. */
+        int getNumSections() const noexcept { return numSections; }
+
+        /** Returns the number of FIR taps in the filter (including the feed-through term). */
+        int getNumFirTaps() const noexcept { return numFirTaps; }
+
+        /** Returns the RMS error of the fitted impulse response, relative to the RMS of the circuit's impulse response. */
+        double getFitError() const noexcept { return fitError; }
+
+        /** Poles with a magnitude smaller than this are treated as FIR taps */
+        double zeroPoleThreshold = 1.0e-3;
 
     private:
-        int getPortIndex (int vectorIndex)
+        /** The length of impulse response used to fit the given number of unknowns */
+        static int getImpulseLength (int numUnknowns) noexcept { return 16 * numUnknowns + 128; }
+
+        /** Computes the impulse response of the circuit from its state-space model */
+        void computeImpulseResponse() noexcept
+        {
+            const auto M = (size_t) model.getNumStates();
+            const auto* A = model.getA();
+            const auto* B = model.getB();
+            const auto* C = model.getC();
+
+            auto* x = impulseState.data();
+            auto* nextX = impulseState.data() + M;
+            std::copy (B, B + M, x);
+            impulseResponse[0] = model.getD();
+            for (int n = 1; n < impulseLength; ++n)
+            {
+                double y = 0.0;
+                for (size_t i = 0; i < M; ++i)
+                {
+                    y += C[i] * x[i];
+
+                    double sum = 0.0;
+                    for (size_t j = 0; j < M; ++j)
+                        sum += A[i * M + j] * x[j];
+                    nextX[i] = sum;
+                }
+                impulseResponse[(size_t) n] = y;
+                std::swap (x, nextX);
+            }
+        }
+
+        bool findPoles() noexcept
         {
-            return vectorIndex < m_upPortIndex ? vectorIndex : vectorIndex + 1;
+            numPoles = model.getNumStates();
+            std::copy (model.getA(), model.getA() + numPoles * numPoles, eigenMatrix.begin());
+
+            iir_detail::MatrixRef a { eigenMatrix.data(), numPoles };
+            if (numPoles == 0)
+                return true;
+
+            iir_detail::balance (a);
+            iir_detail::reduceToHessenberg (a);
+            return iir_detail::hessenbergEigenvalues (a, polesReal.data(), polesImag.data());
         }
 
-        std::vector<WDF<T>*> downPorts;
+        /** Pairs up the poles into second-order denominators, and fits the numerators to the impulse response */
+        bool fitSections() noexcept
+        {
+            int numZeroPoles = 0;
+            int numSectionsFound = 0;
+            int numRealPoles = 0;
+            for (int i = 0; i < numPoles; ++i)
+            {
+                if (std::hypot (polesReal[(size_t) i], polesImag[(size_t) i]) < zeroPoleThreshold)
+                {
+                    numZeroPoles++;
+                }
+                else if (polesImag[(size_t) i] > 0.0)
+                {
+                    // complex conjugate pair: 1 - 2 Re(p) z^-1 + |p|^2 z^-2
+                    denominators[(size_t) (2 * numSectionsFound)] = -2.0 * polesReal[(size_t) i];
+                    denominators[(size_t) (2 * numSectionsFound + 1)] = polesReal[(size_t) i] * polesReal[(size_t) i] + polesImag[(size_t) i] * polesImag[(size_t) i];
+                    numSectionsFound++;
+                }
+                else if (polesImag[(size_t) i] == 0.0)
+                {
+                    // collect the real poles at the front of the array, to be paired up below
+                    polesReal[(size_t) numRealPoles++] = polesReal[(size_t) i];
+                }
+            }
 
-        const int m_upPortIndex;
+            // pair neighbouring real poles, so that nearly-repeated poles share a section
+            std::sort (polesReal.begin(), polesReal.begin() + numRealPoles);
+            for (int i = 0; i < numRealPoles; i += 2)
+            {
+                const auto p1 = polesReal[(size_t) i];
+                const auto p2 = i + 1 < numRealPoles ? polesReal[(size_t) i + 1] : 0.0;
+                denominators[(size_t) (2 * numSectionsFound)] = -(p1 + p2);
+                denominators[(size_t) (2 * numSectionsFound + 1)] = p1 * p2;
+                numSectionsFound++;
+            }
+            const auto lastSectionIsFirstOrder = numRealPoles % 2 == 1;
 
-        rtype_detail::Matrix<T> S_matrix; // square matrix representing S
-        rtype_detail::AlignedArray<T> a_vec; // temp matrix of inputs to Rport
-        rtype_detail::AlignedArray<T> b_vec; // temp matrix of outputs from Rport
-    };
-} // namespace wdf
-} // namespace chowdsp
+            // unknowns: FIR taps, then (b0, b1) for each section (b0 only for a first-order section)
+            const auto numTaps = numZeroPoles + 1;
+            const auto numUnknowns = numTaps + 2 * numSectionsFound - (lastSectionIsFirstOrder ? 1 : 0);
+            const auto L = impulseLength;
+            auto column = [this, L] (int col) { return basis.data() + col * L; };
 
-#endif //CHOWDSP_WDF_WDF_RTYPE_H
+            for (int tap = 0; tap < numTaps; ++tap)
+            {
+                std::fill (column (tap), column (tap) + L, 0.0);
+                column (tap)[tap] = 1.0;
+            }
 
+            for (int k = 0; k < numSectionsFound; ++k)
+            {
+                const auto den1 = denominators[(size_t) (2 * k)];
+                const auto den2 = denominators[(size_t) (2 * k + 1)];
+
+                // impulse response of 1 / (1 + den1 z^-1 + den2 z^-2), and the same delayed by one sample
+                auto* g = column (numTaps + 2 * k);
+                g[0] = 1.0;
+                g[1] = -den1;
+                for (int n = 2; n < L; ++n)
+                    g[n] = -den1 * g[n - 1] - den2 * g[n - 2];
+
+                if (numTaps + 2 * k + 1 < numUnknowns)
+                {
+                    auto* gDelayed = column (numTaps + 2 * k + 1);
+                    gDelayed[0] = 0.0;
+                    std::copy (g, g + L - 1, gDelayed + 1);
+                }
+            }
 
-#endif // CHOWDSP_WDF_RTYPE_H_INCLUDED
+            std::copy (impulseResponse.begin(), impulseResponse.end(), fitTarget.begin());
+            if (! iir_detail::solveLeastSquares (basis.data(), fitTarget.data(), fitCoefs.data(), L, numUnknowns))
+                return false;
 
+            // the least-squares residual is left in the bottom of fitTarget
+            double residualPower = 0.0, signalPower = 0.0;
+            for (int n = 0; n < L; ++n)
+            {
+                residualPower += n >= numUnknowns ? fitTarget[(size_t) n] * fitTarget[(size_t) n] : 0.0;
+                signalPower += impulseResponse[(size_t) n] * impulseResponse[(size_t) n];
+            }
+            fitError = signalPower > 0.0 ? std::sqrt (residualPower / signalPower) : 0.0;
 
-// #include "util/defer_impedance.h"
-#ifndef WAVEDIGITALFILTERS_DEFER_IMPEDANCE_H
-#define WAVEDIGITALFILTERS_DEFER_IMPEDANCE_H
+            // the FIR taps beyond the last significant one are just the delayed wave variables,
+            // which the least-squares fit only zeros up to rounding errors
+            double maxTap = 0.0;
+            for (int tap = 0; tap < numTaps; ++tap)
+                maxTap = std::max (maxTap, std::abs (fitCoefs[(size_t) tap]));
 
-namespace chowdsp
-{
-namespace wdft
-{
-    /**
- * Let's say that you've got some fancy adaptor in your WDF (e.g. an R-Type adaptor),
- * which requires a somewhat expensive computation to re-calculate the adaptor's impedance.
- * In that case, you may not want to re-calculate the impedance every time a downstream element
- * changes its impedance, since the impedance might need to be re-calculated several times.
- * For that purpose, you can use this class as follows:
- * ```cpp
- * class MyWDF
- * {
- *   // ...
- *
- *   Resistor pot1 {};
- *   WDFSeries S1 { pot1, ... };
- *
- *   Resistor pot2 {};
- *   WDFParallel P1 { pot2, ... };
- *
- *   FancyAdaptor adaptor { std::tie (S1, P1, ...); }; // this adaptor does heavy computation when re-calculating the impedance
- *
- * public:
- *   void setParameters (float pot1Value, float pot2Value)
- *   {
- *     {
- *       // while this object is alive, any impedance changes that are propagated
- *       // to S1 will cause S1 to recompute its impedance, but will not allow impeance
- *       // changes to be propagated any further up the tree, and the same for P1.
- *
- *       ScopedDeferImpedancePropagation deferImpedance { S1, P1 };
- *       pot1.setResistanceValue (pot1Value);
- *       pot2.setResistanceValue (pot2Value);
- *     }
- *
- *     // Now we must manually tell the fancyAdaptor that downstream impedances have changed:
- *     fancyAdaptor.propagateImpedanceChange();
- *   }
- * }
- * ```
- */
-    template <typename... Elements>
-    class ScopedDeferImpedancePropagation
-    {
-    public:
-        explicit ScopedDeferImpedancePropagation (Elements&... elems) : elements (std::tie (elems...))
-        {
-#if __cplusplus >= 201703L // With C++17 and later, it's easy to assert that all the elements are derived from BaseWDF
-            static_assert ((std::is_base_of<BaseWDF, Elements>::value && ...), "All element types must be derived from BaseWDF");
-#endif
+            const auto tapTolerance = std::sqrt (std::numeric_limits<double>::epsilon()) * maxTap;
+            auto numTapsUsed = numTaps;
+            while (numTapsUsed > 1 && std::abs (fitCoefs[(size_t) numTapsUsed - 1]) <= tapTolerance)
+                numTapsUsed--;
 
-            rtype_detail::forEachInTuple (
-                [] (auto& el, size_t) {
-                    el.dontPropagateImpedance = true;
-                },
-                elements);
-        }
+            // the filter state only carries over if the structure of the filter is unchanged
+            if (numSectionsFound != numSections || numTapsUsed != numFirTaps)
+                reset();
+            numFirTaps = numTapsUsed;
 
-        ~ScopedDeferImpedancePropagation()
-        {
-            rtype_detail::forEachInTuple (
-                [] (auto& el, size_t) {
-                    el.dontPropagateImpedance = false;
-                    el.calcImpedance();
-                },
-                elements);
+            for (int tap = 0; tap < numTaps; ++tap)
+                firTaps[(size_t) tap] = (T) fitCoefs[(size_t) tap];
+
+            for (int k = 0; k < numSectionsFound; ++k)
+            {
+                b0[(size_t) k] = (T) fitCoefs[(size_t) (numTaps + 2 * k)];
+                b1[(size_t) k] = numTaps + 2 * k + 1 < numUnknowns ? (T) fitCoefs[(size_t) (numTaps + 2 * k + 1)] : (T) 0;
+                a1[(size_t) k] = (T) denominators[(size_t) (2 * k)];
+                a2[(size_t) k] = (T) denominators[(size_t) (2 * k + 1)];
+            }
+            numSections = numSectionsFound;
+
+            return true;
         }
 
-    private:
-        std::tuple<Elements&...> elements;
+        // circuit analysis (in double precision)
+        LinearStateSpace<T> model;
+        std::vector<double> impulseState;
+        std::vector<double> eigenMatrix, polesReal, polesImag, denominators;
+        int numPoles = 0;
+        int impulseLength = 0;
+        std::vector<double> impulseResponse, fitTarget, basis, fitCoefs;
+        double fitError = 0.0;
+
+        // filter coefficients and state
+        std::vector<T> b0, b1, a1, a2, s1, s2;
+        std::vector<T> firTaps, firState;
+        int numSections = 0;
+        int numFirTaps = 0;
     };
 } // namespace wdft
 } // namespace chowdsp
 
-#endif //WAVEDIGITALFILTERS_DEFER_IMPEDANCE_H
+#endif //CHOWDSP_WDF_LINEAR_CIRCUIT_FILTER_H
 
 
 #if defined(_MSC_VER)
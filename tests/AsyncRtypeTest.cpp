@@ -0,0 +1,213 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <catch2/catch2.hpp>
+#include <chowdsp_wdf/chowdsp_wdf.h>
+#include <chowdsp_wdf/rtype/async_root_rtype_adaptor.h>
+#include <chowdsp_wdf/util/realtime_safety.h>
+
+#include "BassmanToneStack.h"
+
+namespace
+{
+constexpr double fs = 48000.0;
+
+/** While this is false, the background thread is stuck computing the scattering matrix */
+std::atomic<bool> allowMatrixUpdates { true };
+
+/** Scattering matrix for three ports connected in parallel */
+struct GatedParallelImpedanceCalc
+{
+    template <typename RType>
+    static void calcImpedance (RType& R)
+    {
+        while (! allowMatrixUpdates.load())
+            std::this_thread::yield();
+
+        const auto impedances = R.getPortImpedances();
+        const auto G0 = 1.0f / impedances[0];
+        const auto G1 = 1.0f / impedances[1];
+        const auto G2 = 1.0f / impedances[2];
+        const auto twoOverGSum = 2.0f / (G0 + G1 + G2);
+
+        R.setSMatrixData ({ { twoOverGSum * G0 - 1.0f, twoOverGSum * G1, twoOverGSum * G2 },
+                            { twoOverGSum * G0, twoOverGSum * G1 - 1.0f, twoOverGSum * G2 },
+                            { twoOverGSum * G0, twoOverGSum * G1, twoOverGSum * G2 - 1.0f } });
+    }
+};
+
+/** A voltage divider, with two resistors in parallel on the bottom */
+struct ParallelDivider
+{
+    ParallelDivider()
+    {
+        R.calcImpedanceNow();
+        process (1.0f); // the source voltage reaches the R-Type on the following sample
+    }
+
+    float process (float x)
+    {
+        Vs.setVoltage (x);
+        R.compute();
+        return wdft::voltage<float> (R1);
+    }
+
+    static float expectedOutput (float x, float rs, float r1, float r2)
+    {
+        const auto rp = r1 * r2 / (r1 + r2);
+        return x * rp / (rs + rp);
+    }
+
+    wdft::ResistiveVoltageSourceT<float> Vs { 1000.0f };
+    wdft::ResistorT<float> R1 { 1000.0f };
+    wdft::ResistorT<float> R2 { 1000.0f };
+    wdft::AsyncRootRtypeAdaptor<float, GatedParallelImpedanceCalc, decltype (Vs), decltype (R1), decltype (R2)> R { Vs, R1, R2 };
+};
+
+template <typename RType>
+void waitForUpdate (RType& R)
+{
+    while (R.hasPendingUpdate())
+        std::this_thread::yield();
+}
+} // namespace
+
+TEST_CASE ("Async R-Type Test")
+{
+    SECTION ("Matches Synchronous R-Type")
+    {
+        Tonestack<float> syncTonestack;
+        Tonestack<float, wdft::AsyncRootRtypeAdaptor> asyncTonestack;
+        syncTonestack.prepare (fs);
+        asyncTonestack.prepare (fs);
+        asyncTonestack.getRoot().calcImpedanceNow();
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const auto param = 0.2f * (float) (i + 1);
+            syncTonestack.setParams (param, 1.0f - param, 0.5f);
+            asyncTonestack.setParams (param, 1.0f - param, 0.5f);
+            waitForUpdate (asyncTonestack.getRoot());
+
+            for (int n = 0; n < 256; ++n)
+            {
+                const auto x = (n & 32) == 0 ? 1.0f : -1.0f;
+                REQUIRE (asyncTonestack.processSample (x) == Approx (syncTonestack.processSample (x)).margin (1.0e-6));
+            }
+        }
+    }
+
+    SECTION ("Old Matrix Is Used Until Update")
+    {
+        ParallelDivider circuit;
+        REQUIRE (circuit.process (1.0f) == Approx (ParallelDivider::expectedOutput (1.0f, 1000.0f, 1000.0f, 1000.0f)));
+
+        allowMatrixUpdates = false;
+        circuit.R2.setResistanceValue (3000.0f);
+        REQUIRE (circuit.R.hasPendingUpdate());
+        for (int n = 0; n < 100; ++n)
+            REQUIRE (circuit.process (1.0f) == Approx (ParallelDivider::expectedOutput (1.0f, 1000.0f, 1000.0f, 1000.0f)));
+
+        allowMatrixUpdates = true;
+        waitForUpdate (circuit.R);
+        REQUIRE (circuit.process (1.0f) == Approx (ParallelDivider::expectedOutput (1.0f, 1000.0f, 1000.0f, 3000.0f)));
+    }
+
+    SECTION ("Only The Latest Update Is Computed")
+    {
+        ParallelDivider circuit;
+
+        allowMatrixUpdates = false;
+        for (auto r2 : { 2000.0f, 3000.0f, 4000.0f, 5000.0f })
+            circuit.R2.setResistanceValue (r2);
+
+        allowMatrixUpdates = true;
+        waitForUpdate (circuit.R);
+        REQUIRE (circuit.process (1.0f) == Approx (ParallelDivider::expectedOutput (1.0f, 1000.0f, 1000.0f, 5000.0f)));
+    }
+
+    SECTION ("Updates Wake Up An Idle Background Thread")
+    {
+        ParallelDivider circuit;
+        for (auto r2 : { 2000.0f, 3000.0f, 4000.0f })
+        {
+            // give the background thread time to park, before sending the next update
+            std::this_thread::sleep_for (std::chrono::milliseconds (5));
+            circuit.R2.setResistanceValue (r2);
+            waitForUpdate (circuit.R);
+            REQUIRE (circuit.process (1.0f) == Approx (ParallelDivider::expectedOutput (1.0f, 1000.0f, 1000.0f, r2)));
+        }
+    }
+
+    SECTION ("Synchronous Update Overrides Pending Updates")
+    {
+        ParallelDivider circuit;
+
+        allowMatrixUpdates = false;
+        circuit.R2.setResistanceValue (2000.0f);
+        std::thread unblocker ([]
+                               {
+                                   std::this_thread::sleep_for (std::chrono::milliseconds (5));
+                                   allowMatrixUpdates = true; });
+
+        // the background thread is still stuck computing the first update...
+        circuit.R2.setResistanceValue (3000.0f);
+        circuit.R.calcImpedanceNow();
+        unblocker.join();
+
+        // ... so its results should be ignored, once they arrive
+        waitForUpdate (circuit.R);
+        for (int n = 0; n < 10; ++n)
+            REQUIRE (circuit.process (1.0f) == Approx (ParallelDivider::expectedOutput (1.0f, 1000.0f, 1000.0f, 3000.0f)));
+    }
+
+    SECTION ("Crossfade")
+    {
+        constexpr int crossfadeSamples = 64;
+        ParallelDivider circuit;
+        circuit.R.setCrossfadeSamples (crossfadeSamples);
+
+        const auto startOutput = ParallelDivider::expectedOutput (1.0f, 1000.0f, 1000.0f, 1000.0f);
+        const auto endOutput = ParallelDivider::expectedOutput (1.0f, 1000.0f, 1000.0f, 100.0f);
+        REQUIRE (circuit.process (1.0f) == Approx (startOutput));
+
+        circuit.R2.setResistanceValue (100.0f);
+        waitForUpdate (circuit.R);
+
+        auto prevOutput = startOutput;
+        for (int n = 0; n < crossfadeSamples - 1; ++n)
+        {
+            const auto y = circuit.process (1.0f);
+            REQUIRE (circuit.R.isCrossfading());
+            REQUIRE (y < prevOutput);
+            REQUIRE (y > endOutput);
+            prevOutput = y;
+        }
+
+        REQUIRE (circuit.process (1.0f) == Approx (endOutput));
+        REQUIRE (! circuit.R.isCrossfading());
+        REQUIRE (circuit.process (1.0f) == Approx (endOutput));
+    }
+
+    SECTION ("Real-Time Safety")
+    {
+        Tonestack<float, wdft::AsyncRootRtypeAdaptor> tonestack;
+        tonestack.prepare (fs);
+        tonestack.getRoot().calcImpedanceNow();
+        tonestack.getRoot().setCrossfadeSamples (32);
+
+        wdft::resetRealtimeSafetyViolations();
+        {
+            wdft::ScopedAudioThread audioThread;
+            for (int i = 0; i < 100; ++i)
+            {
+                const auto param = 0.01f * (float) i;
+                tonestack.setParams (param, 1.0f - param, param);
+                for (int n = 0; n < 64; ++n)
+                    tonestack.processSample ((n & 16) == 0 ? 1.0f : -1.0f);
+            }
+        }
+        REQUIRE (wdft::getRealtimeSafetyViolations().total() == 0);
+    }
+}
@@ -8,8 +8,11 @@
 
 using namespace chowdsp;
 
-/** Fender Bassman tonestack circuit */
-template <typename FloatType>
+/**
+ * Fender Bassman tonestack circuit
+ * (RtypeAdaptorType can be used to swap in a different root R-Type adaptor implementation)
+ */
+template <typename FloatType, template <typename, typename, typename...> class RtypeAdaptorType = wdft::RootRtypeAdaptor>
 class Tonestack
 {
 public:
@@ -30,25 +33,43 @@ public:
         return wdft::voltage<FloatType> (Res1m) + wdft::voltage<FloatType> (S2) + wdft::voltage<FloatType> (Res3m);
     }
 
-    void setParams (FloatType highPot, FloatType lowPot, FloatType midPot)
+    /**
+     * Sets the circuit parameters. With deferImpedance = false, each pot change
+     * propagates through the R-Type adaptor separately (useful for benchmarking).
+     */
+    void setParams (FloatType highPot, FloatType lowPot, FloatType midPot, bool deferImpedance = true)
     {
+        if (deferImpedance)
         {
-            using DeferImpedance = chowdsp::wdft::ScopedDeferImpedancePropagation<decltype (S1), decltype (S3), decltype (S4)>;
-            DeferImpedance deferImpedance { S1, S3, S4 };
+            {
+                using DeferImpedance = chowdsp::wdft::ScopedDeferImpedancePropagation<decltype (S1), decltype (S3), decltype (S4)>;
+                DeferImpedance deferScope { S1, S3, S4 };
+                setPots (highPot, lowPot, midPot);
+            }
 
-            Res1m.setResistanceValue (highPot * R1);
-            Res1p.setResistanceValue (((FloatType) 1 - highPot) * R1);
+            S2.propagateImpedanceChange();
+        }
+        else
+        {
+            setPots (highPot, lowPot, midPot);
+        }
+    }
 
-            Res2.setResistanceValue (((FloatType) 1 - lowPot) * R2);
+    /** Returns the root of the WDF tree */
+    auto& getRoot() noexcept { return R; }
 
-            Res3m.setResistanceValue (midPot * R3);
-            Res3p.setResistanceValue (((FloatType) 1 - midPot) * R3);
-        }
+private:
+    void setPots (FloatType highPot, FloatType lowPot, FloatType midPot)
+    {
+        Res1m.setResistanceValue (highPot * R1);
+        Res1p.setResistanceValue (((FloatType) 1 - highPot) * R1);
+
+        Res2.setResistanceValue (((FloatType) 1 - lowPot) * R2);
 
-        S2.propagateImpedanceChange();
+        Res3m.setResistanceValue (midPot * R3);
+        Res3p.setResistanceValue (((FloatType) 1 - midPot) * R3);
     }
 
-private:
     wdft::CapacitorAlphaT<FloatType> Cap1 { 250e-12 };
     wdft::CapacitorAlphaT<FloatType> Cap2 { 20e-9 }; // Port D
     wdft::CapacitorAlphaT<FloatType> Cap3 { 20e-9 }; // Port F
@@ -78,6 +99,14 @@ private:
 
     struct ImpedanceCalc
     {
+        // the R-Type topology, for adaptors which compute their own scattering matrix
+        static constexpr int numNodes = 3;
+        static wdft::RtypePortNodes getPortNodes (int portIndex)
+        {
+            constexpr wdft::RtypePortNodes nodes[] = { { 2, 0 }, { 3, 0 }, { 2, 3 }, { 1, 3 }, { 1, 2 }, { 0, 1 } };
+            return nodes[portIndex];
+        }
+
         template <typename RType>
         static void calcImpedance (RType& R)
         {
@@ -106,6 +135,6 @@ private:
         }
     };
 
-    using RType = wdft::RootRtypeAdaptor<FloatType, ImpedanceCalc, decltype (S1), decltype (S3), decltype (S2), decltype (Cap2), decltype (Res4), decltype (Cap3)>;
+    using RType = RtypeAdaptorType<FloatType, ImpedanceCalc, decltype (S1), decltype (S3), decltype (S2), decltype (Cap2), decltype (Res4), decltype (Cap3)>;
     RType R { S1, S3, S2, Cap2, Res4, Cap3 };
 };
@@ -8,8 +8,12 @@
 
 using namespace chowdsp;
 
-/** Fender Bassman tonestack circuit */
-template <typename FloatType>
+/**
+ * Fender Bassman tonestack circuit.
+ * The R-Type adaptor can be any of the run-time root R-Type adaptors
+ * (e.g. wdf::RootRtypeAdaptor or wdf::FixedSizeRootRtypeAdaptor).
+ */
+template <typename FloatType, typename RtypeAdaptorType = wdf::RootRtypeAdaptor<FloatType>>
 class TonestackPoly
 {
 public:
@@ -55,25 +59,42 @@ public:
         return wdft::voltage<FloatType> (Res1m) + wdft::voltage<FloatType> (S2) + wdft::voltage<FloatType> (Res3m);
     }
 
-    void setParams (FloatType highPot, FloatType lowPot, FloatType midPot)
+    /**
+     * Sets the circuit parameters. With deferImpedance = false, each pot change
+     * propagates up the tree separately (useful for benchmarking).
+     */
+    void setParams (FloatType highPot, FloatType lowPot, FloatType midPot, bool deferImpedance = true)
     {
+        if (deferImpedance)
         {
             using DeferImpedance = chowdsp::wdft::ScopedDeferImpedancePropagation<decltype (S1), decltype (S3), decltype (S4)>;
-            DeferImpedance deferImpedance { S1, S3, S4 };
-
-            Res1m.setResistanceValue (highPot * R1);
-            Res1p.setResistanceValue (((FloatType) 1 - highPot) * R1);
-
-            Res2.setResistanceValue (((FloatType) 1 - lowPot) * R2);
-
-            Res3m.setResistanceValue (midPot * R3);
-            Res3p.setResistanceValue (((FloatType) 1 - midPot) * R3);
+            DeferImpedance deferScope { S1, S3, S4 };
+            setPots (highPot, lowPot, midPot);
+        }
+        else
+        {
+            setPots (highPot, lowPot, midPot);
         }
 
+        // the wdf impedance propagation stops at the R-Type adaptor ports, so this is always needed
         S2.propagateImpedanceChange();
     }
 
+    /** Returns the root of the WDF tree */
+    auto& getRoot() noexcept { return R; }
+
 private:
+    void setPots (FloatType highPot, FloatType lowPot, FloatType midPot)
+    {
+        Res1m.setResistanceValue (highPot * R1);
+        Res1p.setResistanceValue (((FloatType) 1 - highPot) * R1);
+
+        Res2.setResistanceValue (((FloatType) 1 - lowPot) * R2);
+
+        Res3m.setResistanceValue (midPot * R3);
+        Res3p.setResistanceValue (((FloatType) 1 - midPot) * R3);
+    }
+
     wdf::CapacitorAlpha<FloatType> Cap1 { 250e-12 };
     wdf::CapacitorAlpha<FloatType> Cap2 { 20e-9 }; // Port D
     wdf::CapacitorAlpha<FloatType> Cap3 { 20e-9 }; // Port F
@@ -101,5 +122,5 @@ private:
     static constexpr double R2 = 1e6;
     static constexpr double R3 = 25e3;
 
-    wdf::RootRtypeAdaptor<FloatType> R;
+    RtypeAdaptorType R;
 };
@@ -47,20 +47,25 @@ public:
         Ce.prepare ((float) fs);
     }
 
-    void setParams (float bassParam, float trebleParam)
+    /**
+     * Sets the circuit parameters. With deferImpedance = false, each pot change
+     * propagates up the tree separately (useful for benchmarking).
+     */
+    void setParams (float bassParam, float trebleParam, bool deferImpedance = true)
     {
+        if (deferImpedance)
         {
             using DeferImpedance = chowdsp::wdft::ScopedDeferImpedancePropagation<decltype (P1), decltype (S2), decltype (S3), decltype (S4)>;
-            DeferImpedance deferImpedance { P1, S2, S3, S4 };
-
-            Pb_plus.setResistanceValue (Pb * bassParam);
-            Pb_minus.setResistanceValue (Pb * (1.0f - bassParam));
-
-            Pt_plus.setResistanceValue (Pt * trebleParam);
-            Pt_minus.setResistanceValue (Pt * (1.0f - trebleParam));
+            DeferImpedance deferScope { P1, S2, S3, S4 };
+            setPots (bassParam, trebleParam);
+        }
+        else
+        {
+            setPots (bassParam, trebleParam);
         }
 
-        // propagate impedance change through R-type adaptor
+        // propagate impedance change through R-type adaptor (the wdf impedance
+        // propagation stops at the R-Type adaptor ports, so this is always needed)
         R.propagateImpedanceChange();
     }
 
@@ -74,7 +79,19 @@ public:
         return wdft::voltage<float> (Rl);
     }
 
+    /** Returns the root of the WDF tree */
+    auto& getRoot() noexcept { return Vin; }
+
 private:
+    void setPots (float bassParam, float trebleParam)
+    {
+        Pb_plus.setResistanceValue (Pb * bassParam);
+        Pb_minus.setResistanceValue (Pb * (1.0f - bassParam));
+
+        Pt_plus.setResistanceValue (Pt * trebleParam);
+        Pt_minus.setResistanceValue (Pt * (1.0f - trebleParam));
+    }
+
     static constexpr auto Pt = 100.0e3f;
     static constexpr auto Pb = 100.0e3f;
 
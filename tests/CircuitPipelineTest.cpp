@@ -0,0 +1,166 @@
+#include <cmath>
+#include <vector>
+
+#include <catch2/catch2.hpp>
+#include <chowdsp_wdf/chowdsp_wdf.h>
+#include <chowdsp_wdf/util/circuit_pipeline.h>
+#include <chowdsp_wdf/util/realtime_safety.h>
+
+namespace wdft = chowdsp::wdft;
+
+namespace
+{
+constexpr float fs = 48000.0f;
+constexpr int maxBlockSize = 64;
+
+struct LowpassStage
+{
+    LowpassStage() { C1.prepare (fs); }
+
+    void processBlock (float* buffer, int numSamples)
+    {
+        for (int n = 0; n < numSamples; ++n)
+        {
+            Vs.setVoltage (buffer[n]);
+            open.incident (P1.reflected());
+            P1.incident (open.reflected());
+            buffer[n] = wdft::voltage<float> (C1);
+        }
+    }
+
+    wdft::ResistiveVoltageSourceT<float> Vs { 1.0e3f };
+    wdft::CapacitorT<float> C1 { 1.0e-6f };
+    wdft::WDFParallelT<float, decltype (Vs), decltype (C1)> P1 { Vs, C1 };
+    wdft::IdealCurrentSourceT<float, decltype (P1)> open { P1 };
+};
+
+struct ClipperStage
+{
+    ClipperStage() { C1.prepare (fs); }
+
+    void processBlock (float* buffer, int numSamples)
+    {
+        for (int n = 0; n < numSamples; ++n)
+        {
+            Vs.setVoltage (10.0f * buffer[n]);
+            dp.incident (P1.reflected());
+            P1.incident (dp.reflected());
+            buffer[n] = wdft::voltage<float> (C1);
+        }
+    }
+
+    wdft::ResistiveVoltageSourceT<float> Vs { 4700.0f };
+    wdft::CapacitorT<float> C1 { 47.0e-9f };
+    wdft::WDFParallelT<float, decltype (Vs), decltype (C1)> P1 { Vs, C1 };
+    wdft::DiodePairT<float, decltype (P1)> dp { P1, 2.52e-9f };
+};
+
+struct HighpassStage
+{
+    HighpassStage() { C1.prepare (fs); }
+
+    void processBlock (float* buffer, int numSamples)
+    {
+        for (int n = 0; n < numSamples; ++n)
+        {
+            Vs.setVoltage (buffer[n]);
+            open.incident (S1.reflected());
+            S1.incident (open.reflected());
+            buffer[n] = wdft::voltage<float> (R1);
+        }
+    }
+
+    wdft::ResistiveVoltageSourceT<float> Vs { 100.0f };
+    wdft::CapacitorT<float> C1 { 1.0e-6f };
+    wdft::ResistorT<float> R1 { 1.0e3f };
+    wdft::WDFSeriesT<float, decltype (C1), decltype (R1)> S0 { C1, R1 };
+    wdft::WDFParallelT<float, decltype (Vs), decltype (S0)> S1 { Vs, S0 };
+    wdft::IdealCurrentSourceT<float, decltype (S1)> open { S1 };
+};
+
+float testSignal (int n)
+{
+    return std::sin (2.0f * (float) M_PI * 100.0f * (float) n / fs);
+}
+} // namespace
+
+TEST_CASE ("Circuit Pipeline Test")
+{
+    SECTION ("Pipeline Output")
+    {
+        LowpassStage lpf, lpfRef;
+        ClipperStage clipper, clipperRef;
+        HighpassStage hpf, hpfRef;
+
+        wdft::CircuitPipeline<float> pipeline { maxBlockSize, 2 };
+        REQUIRE (pipeline.addStage (lpf));
+        REQUIRE (pipeline.addStage (clipper));
+        REQUIRE (pipeline.addStage (hpf));
+        REQUIRE (pipeline.getNumStages() == 3);
+        REQUIRE (pipeline.getLatencySamples() == 5 * maxBlockSize);
+
+        pipeline.start();
+        REQUIRE (pipeline.isRunning());
+        REQUIRE (! pipeline.addStage (hpf)); // can't add stages while running!
+
+        constexpr int numSamples = 4096;
+        std::vector<float> reference ((size_t) numSamples);
+        for (int n = 0; n < numSamples; ++n)
+            reference[(size_t) n] = testSignal (n);
+        lpfRef.processBlock (reference.data(), numSamples);
+        clipperRef.processBlock (reference.data(), numSamples);
+        hpfRef.processBlock (reference.data(), numSamples);
+
+        const auto latency = pipeline.getLatencySamples();
+        std::vector<float> block ((size_t) maxBlockSize);
+        int sampleIndex = 0;
+        for (int blockIndex = 0; sampleIndex < numSamples; ++blockIndex)
+        {
+            const auto blockSize = std::min (1 + (blockIndex * 37) % maxBlockSize, numSamples - sampleIndex);
+            for (int n = 0; n < blockSize; ++n)
+                block[(size_t) n] = testSignal (sampleIndex + n);
+
+            pipeline.process (block.data(), blockSize);
+
+            // the output should be the same as processing the stages in series, delayed by the latency
+            for (int n = 0; n < blockSize; ++n)
+            {
+                const auto refIndex = sampleIndex + n - latency;
+                REQUIRE (block[(size_t) n] == (refIndex < 0 ? 0.0f : reference[(size_t) refIndex]));
+            }
+
+            sampleIndex += blockSize;
+        }
+
+        pipeline.stop();
+        REQUIRE (! pipeline.isRunning());
+
+        block.assign (block.size(), 1.0f);
+        pipeline.process (block.data(), maxBlockSize);
+        for (auto x : block)
+            REQUIRE (x == 0.0f);
+    }
+
+    SECTION ("Real-Time Safety")
+    {
+        LowpassStage lpf;
+        ClipperStage clipper;
+        wdft::CircuitPipeline<float> pipeline { maxBlockSize };
+        pipeline.addStage (lpf);
+        pipeline.addStage (clipper);
+        pipeline.start();
+
+        std::vector<float> block ((size_t) maxBlockSize);
+        wdft::resetRealtimeSafetyViolations();
+        {
+            wdft::ScopedAudioThread audioThread;
+            for (int i = 0; i < 200; ++i)
+            {
+                for (int n = 0; n < maxBlockSize; ++n)
+                    block[(size_t) n] = testSignal (i * maxBlockSize + n);
+                pipeline.process (block.data(), maxBlockSize);
+            }
+        }
+        REQUIRE (wdft::getRealtimeSafetyViolations().total() == 0);
+    }
+}
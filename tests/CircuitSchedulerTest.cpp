@@ -0,0 +1,170 @@
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch2.hpp>
+#include <chowdsp_wdf/chowdsp_wdf.h>
+#include <chowdsp_wdf/util/circuit_scheduler.h>
+#include <chowdsp_wdf/util/realtime_safety.h>
+
+namespace wdft = chowdsp::wdft;
+
+namespace
+{
+constexpr float fs = 48000.0f;
+constexpr int maxBlockSize = 256;
+
+/** A diode clipper with a per-voice cutoff, processing its own buffer */
+struct Voice
+{
+    Voice() = default;
+
+    void prepare (int voiceIndex)
+    {
+        C1.setCapacitanceValue (10.0e-9f + 1.0e-9f * (float) voiceIndex);
+        C1.prepare (fs);
+        phase = 0.01f * (float) voiceIndex;
+    }
+
+    void processBlock (int numSamples)
+    {
+        for (int n = 0; n < numSamples; ++n)
+        {
+            phase += 0.01f;
+            Vs.setVoltage (std::sin (phase));
+            dp.incident (P1.reflected());
+            P1.incident (dp.reflected());
+            buffer[n] = wdft::voltage<float> (C1);
+        }
+    }
+
+    wdft::ResistiveVoltageSourceT<float> Vs { 4700.0f };
+    wdft::CapacitorT<float> C1 { 47.0e-9f };
+    wdft::WDFParallelT<float, decltype (Vs), decltype (C1)> P1 { Vs, C1 };
+    wdft::DiodePairT<float, decltype (P1)> dp { P1, 2.52e-9f };
+
+    float phase = 0.0f;
+    float buffer[maxBlockSize] {};
+};
+
+/** Checks that the scheduler produces the same output as processing the voices on one thread */
+void checkScheduler (int numWorkerThreads, size_t numVoices)
+{
+    wdft::CacheLineSeparatedArray<Voice> voices { numVoices };
+    std::vector<Voice> referenceVoices (numVoices);
+
+    wdft::CircuitScheduler scheduler { numWorkerThreads, numVoices };
+    for (size_t i = 0; i < numVoices; ++i)
+    {
+        voices[i].prepare ((int) i);
+        referenceVoices[i].prepare ((int) i);
+        REQUIRE (scheduler.addProcessor (voices[i]));
+    }
+    REQUIRE (scheduler.getNumProcessors() == numVoices);
+    REQUIRE (scheduler.getNumThreads() == (size_t) numWorkerThreads + 1);
+
+    for (int blockSize : { 64, 256, 1, 100, 256, 17 })
+    {
+        scheduler.process (blockSize);
+        for (size_t i = 0; i < numVoices; ++i)
+        {
+            referenceVoices[i].processBlock (blockSize);
+            for (int n = 0; n < blockSize; ++n)
+                REQUIRE (voices[i].buffer[n] == referenceVoices[i].buffer[n]);
+        }
+    }
+}
+} // namespace
+
+TEST_CASE ("Circuit Scheduler Test")
+{
+    SECTION ("Cache Line Separated Array")
+    {
+        wdft::CacheLineSeparatedArray<float> array { 5, 2.0f };
+        REQUIRE (array.size() == 5);
+        for (size_t i = 0; i < array.size(); ++i)
+        {
+            REQUIRE (array[i] == 2.0f);
+            REQUIRE (reinterpret_cast<uintptr_t> (&array[i]) % 64 == 0);
+        }
+    }
+
+    SECTION ("Single Thread")
+    {
+        checkScheduler (0, 7);
+    }
+
+    SECTION ("Worker Threads")
+    {
+        checkScheduler (1, 2);
+        checkScheduler (3, 64);
+        checkScheduler (4, 3); // more threads than voices
+    }
+
+    SECTION ("Adding and Removing Processors")
+    {
+        wdft::CacheLineSeparatedArray<Voice> voices { 4 };
+        wdft::CircuitScheduler scheduler { 2, 2 };
+        REQUIRE (scheduler.addProcessor (voices[0]));
+        REQUIRE (scheduler.addProcessor (voices[1]));
+        REQUIRE (! scheduler.addProcessor (voices[2])); // full!
+        scheduler.process (maxBlockSize);
+
+        scheduler.clearProcessors();
+        REQUIRE (scheduler.getNumProcessors() == 0);
+        scheduler.process (maxBlockSize);
+
+        REQUIRE (scheduler.addProcessor (voices[2]));
+        REQUIRE (scheduler.addProcessor (voices[3]));
+        scheduler.process (maxBlockSize);
+
+        // voices 0 and 1 processed one block, and voices 2 and 3 processed one block
+        for (size_t i = 0; i < 2; ++i)
+            REQUIRE (voices[i].phase == voices[i + 2].phase);
+    }
+
+    SECTION ("Reconfiguring After Idle Workers")
+    {
+        // a trivial processor, so that process() finishes the block before the workers wake up
+        struct EmptyProcessor
+        {
+            void processBlock (int) {}
+        };
+
+        EmptyProcessor processors[2];
+        wdft::CircuitScheduler scheduler { 3, 2 };
+        REQUIRE (scheduler.addProcessor (processors[0]));
+        REQUIRE (scheduler.addProcessor (processors[1]));
+        for (int i = 0; i < 20; ++i)
+        {
+            // let the workers go idle, then reconfigure straight after a block, while they are waking up
+            std::this_thread::sleep_for (std::chrono::milliseconds (2));
+            scheduler.process (maxBlockSize);
+            for (int j = 0; j < 1000; ++j)
+            {
+                scheduler.clearProcessors();
+                scheduler.addProcessor (processors[0]);
+                scheduler.addProcessor (processors[1]);
+            }
+            REQUIRE (scheduler.getNumProcessors() == 2);
+        }
+    }
+
+    SECTION ("Real-Time Safety")
+    {
+        constexpr size_t numVoices = 32;
+        wdft::CacheLineSeparatedArray<Voice> voices { numVoices };
+        wdft::CircuitScheduler scheduler { 3, numVoices };
+        for (size_t i = 0; i < numVoices; ++i)
+            scheduler.addProcessor (voices[i]);
+
+        wdft::resetRealtimeSafetyViolations();
+        {
+            wdft::ScopedAudioThread audioThread;
+            for (int i = 0; i < 100; ++i)
+                scheduler.process (maxBlockSize);
+        }
+        REQUIRE (wdft::getRealtimeSafetyViolations().total() == 0);
+    }
+}
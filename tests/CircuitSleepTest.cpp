@@ -0,0 +1,144 @@
+#include <cmath>
+#include <vector>
+
+#include <catch2/catch2.hpp>
+#include "BassmanToneStack.h"
+#include "BassmanToneStackPoly.h"
+
+namespace
+{
+constexpr double fs = 48000.0;
+constexpr int blockSize = 64;
+constexpr double threshold = 1.0e-6;
+
+/** A short burst of signal, followed by a long silence, and another burst */
+std::vector<float> makeTestSignal()
+{
+    std::vector<float> signal ((size_t) (400 * blockSize), 0.0f);
+    for (int n = 0; n < 4 * blockSize; ++n)
+    {
+        signal[(size_t) n] = std::sin (0.05f * (float) n);
+        signal[(size_t) (300 * blockSize + n)] = std::sin (0.05f * (float) n);
+    }
+    return signal;
+}
+
+template <typename CircuitType>
+void prepareCircuit (CircuitType& circuit)
+{
+    circuit.prepare (fs);
+    circuit.setParams (0.5f, 0.5f, 0.5f);
+}
+
+/** Checks that the circuit goes to sleep during the silence, and wakes up for the second burst */
+template <typename CircuitType>
+void checkSleep()
+{
+    CircuitType reference;
+    CircuitType circuit;
+    prepareCircuit (reference);
+    prepareCircuit (circuit);
+
+    auto expected = makeTestSignal();
+    for (auto& x : expected)
+        x = reference.processSample (x);
+
+    auto actual = makeTestSignal();
+    wdft::CircuitSleepMode sleepMode { threshold };
+    int numBlocksProcessed = 0;
+    for (size_t start = 0; start < actual.size(); start += blockSize)
+    {
+        const auto wasProcessed = sleepMode.process (circuit.getRoot(),
+                                                     actual.data() + start,
+                                                     blockSize,
+                                                     [&circuit] (float* data, int numSamples)
+                                                     {
+                                                         for (int n = 0; n < numSamples; ++n)
+                                                             data[n] = circuit.processSample (data[n]);
+                                                     });
+        numBlocksProcessed += wasProcessed ? 1 : 0;
+
+        // during the second burst, the circuit must be awake
+        if (start >= 300 * blockSize && start < 304 * blockSize)
+        {
+            REQUIRE (wasProcessed);
+            REQUIRE (! sleepMode.isAsleep());
+        }
+    }
+
+    // most of the silence is skipped
+    REQUIRE (numBlocksProcessed < 200);
+    REQUIRE (sleepMode.isAsleep());
+
+    for (size_t n = 0; n < actual.size(); ++n)
+        REQUIRE (actual[n] == Approx (expected[n]).margin (1.0e-4));
+}
+} // namespace
+
+TEST_CASE ("Circuit Sleep Test")
+{
+    SECTION ("Sleep and Wake")
+    {
+        checkSleep<Tonestack<float>>();
+    }
+
+    SECTION ("Sleep and Wake (wdf)")
+    {
+        checkSleep<TonestackPoly<float>>();
+    }
+
+    SECTION ("State is Zeroed While Asleep")
+    {
+        Tonestack<float> circuit;
+        prepareCircuit (circuit);
+
+        std::vector<float> buffer ((size_t) blockSize, 0.0f);
+        buffer[0] = 1.0f;
+
+        wdft::CircuitSleepMode sleepMode { threshold };
+        auto processBlock = [&circuit] (float* data, int numSamples)
+        {
+            for (int n = 0; n < numSamples; ++n)
+                data[n] = circuit.processSample (data[n]);
+        };
+
+        for (int i = 0; i < 1000 && ! sleepMode.isAsleep(); ++i)
+        {
+            sleepMode.process (circuit.getRoot(), buffer.data(), blockSize, processBlock);
+            std::fill (buffer.begin(), buffer.end(), 0.0f);
+        }
+
+        REQUIRE (sleepMode.isAsleep());
+        wdft::visitCircuitState (circuit.getRoot(), [] (auto& x)
+                                 { REQUIRE (x == 0.0f); });
+
+        // silence below the threshold is replaced with zeros
+        std::fill (buffer.begin(), buffer.end(), (float) threshold * 0.5f);
+        REQUIRE (! sleepMode.process (circuit.getRoot(), buffer.data(), blockSize, processBlock));
+        for (auto x : buffer)
+            REQUIRE (x == 0.0f);
+
+        // wake() forces the next block to be processed
+        sleepMode.wake();
+        REQUIRE (sleepMode.process (circuit.getRoot(), buffer.data(), blockSize, processBlock));
+    }
+
+    SECTION ("Biased Circuit Stays Awake")
+    {
+        Tonestack<float> circuit;
+        prepareCircuit (circuit);
+
+        std::vector<float> buffer ((size_t) blockSize, 0.0f);
+        wdft::CircuitSleepMode sleepMode { threshold };
+        for (int i = 0; i < 1000; ++i)
+        {
+            // the input is silent, but the circuit is driven by a DC bias
+            REQUIRE (sleepMode.process (circuit.getRoot(), buffer.data(), blockSize, [&circuit] (float* data, int numSamples)
+                                        {
+                                            for (int n = 0; n < numSamples; ++n)
+                                                data[n] = circuit.processSample (data[n] + 1.0f);
+                                        }));
+            std::fill (buffer.begin(), buffer.end(), 0.0f);
+        }
+    }
+}
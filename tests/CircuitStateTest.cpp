@@ -0,0 +1,159 @@
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <catch2/catch2.hpp>
+#include "BassmanToneStack.h"
+#include "BassmanToneStackPoly.h"
+#include "BaxandallEQ.h"
+#include "BaxandallEQPoly.h"
+#include "DiodeClipper.h"
+
+namespace
+{
+constexpr double fs = 48000.0;
+constexpr int numSamples = 512;
+
+float testSignal (int n)
+{
+    return std::sin (2.0f * (float) M_PI * 200.0f * (float) n / (float) fs) + 0.25f;
+}
+
+/** Runs the circuit for a while, then checks that restoring a snapshot reproduces the output exactly. */
+template <typename CircuitType>
+void checkSnapshotRestore (CircuitType& circuit, CircuitType& otherCircuit)
+{
+    for (int n = 0; n < numSamples; ++n)
+        circuit.processSample ((decltype (circuit.processSample (0.0f))) testSignal (n));
+
+    wdft::CircuitStateBuffer state { circuit.getRoot() };
+    REQUIRE (state.size() == wdft::getStateSizeBytes (circuit.getRoot()));
+    REQUIRE (reinterpret_cast<uintptr_t> (state.data()) % wdft::CircuitStateBuffer::alignment == 0);
+    wdft::saveState (circuit.getRoot(), state);
+
+    std::vector<double> expected ((size_t) numSamples);
+    for (int n = 0; n < numSamples; ++n)
+        expected[(size_t) n] = (double) circuit.processSample ((decltype (circuit.processSample (0.0f))) testSignal (n + numSamples));
+
+    // restore into the same circuit
+    wdft::loadState (circuit.getRoot(), state);
+    for (int n = 0; n < numSamples; ++n)
+        REQUIRE ((double) circuit.processSample ((decltype (circuit.processSample (0.0f))) testSignal (n + numSamples)) == expected[(size_t) n]);
+
+    // restore into a different instance of the same circuit (i.e. "voice stealing")
+    wdft::loadState (otherCircuit.getRoot(), state);
+    for (int n = 0; n < numSamples; ++n)
+        REQUIRE ((double) otherCircuit.processSample ((decltype (circuit.processSample (0.0f))) testSignal (n + numSamples)) == expected[(size_t) n]);
+}
+} // namespace
+
+TEST_CASE ("Circuit State Test")
+{
+    SECTION ("Static Diode Clipper")
+    {
+        DiodeClipper<float> clipper, otherClipper;
+        for (auto* c : { &clipper, &otherClipper })
+            c->Vb.setVoltage (0.5f);
+        checkSnapshotRestore (clipper, otherClipper);
+    }
+
+    SECTION ("Static Diode Clipper (Compensated State)")
+    {
+        DiodeClipper<float, chowdsp::CompensatedFloat<float>> clipper, otherClipper;
+        for (auto* c : { &clipper, &otherClipper })
+            c->Vb.setVoltage (0.5f);
+        checkSnapshotRestore (clipper, otherClipper);
+    }
+
+    SECTION ("Dynamic Diode Clipper")
+    {
+        DiodeClipperPoly<double> clipper, otherClipper;
+        checkSnapshotRestore (clipper, otherClipper);
+    }
+
+    SECTION ("Static R-Type")
+    {
+        BaxandallWDF baxandall, otherBaxandall;
+        for (auto* eq : { &baxandall, &otherBaxandall })
+        {
+            eq->prepare (fs);
+            eq->setParams (0.25f, 0.75f);
+        }
+        checkSnapshotRestore (baxandall, otherBaxandall);
+    }
+
+    SECTION ("Dynamic R-Type")
+    {
+        BaxandallWDFPoly baxandall, otherBaxandall;
+        for (auto* eq : { &baxandall, &otherBaxandall })
+        {
+            eq->prepare (fs);
+            eq->setParams (0.25f, 0.75f);
+        }
+        checkSnapshotRestore (baxandall, otherBaxandall);
+    }
+
+    SECTION ("Static Root R-Type")
+    {
+        Tonestack<double> tonestack, otherTonestack;
+        for (auto* ts : { &tonestack, &otherTonestack })
+        {
+            ts->prepare (fs);
+            ts->setParams (0.5, 0.25, 0.75);
+        }
+        checkSnapshotRestore (tonestack, otherTonestack);
+    }
+
+    SECTION ("Dynamic Root R-Type")
+    {
+        TonestackPoly<double> tonestack, otherTonestack;
+        for (auto* ts : { &tonestack, &otherTonestack })
+        {
+            ts->prepare (fs);
+            ts->setParams (0.5, 0.25, 0.75);
+        }
+        checkSnapshotRestore (tonestack, otherTonestack);
+    }
+
+    SECTION ("Copied State Buffers")
+    {
+        DiodeClipperPoly<double> clipper;
+        for (int n = 0; n < numSamples; ++n)
+            clipper.processSample ((double) testSignal (n));
+
+        wdft::CircuitStateBuffer state { clipper.getRoot() };
+        wdft::saveState (clipper.getRoot(), state);
+
+        // e.g. one state buffer per voice
+        std::vector<wdft::CircuitStateBuffer> voiceStates (8, state);
+        voiceStates.push_back (voiceStates.front());
+        voiceStates[1] = voiceStates.back();
+        for (auto& voiceState : voiceStates)
+        {
+            REQUIRE (voiceState.size() == state.size());
+            REQUIRE (reinterpret_cast<uintptr_t> (voiceState.data()) % wdft::CircuitStateBuffer::alignment == 0);
+            REQUIRE (std::memcmp (voiceState.data(), state.data(), state.size()) == 0);
+        }
+
+        const auto* movedData = voiceStates.back().data();
+        wdft::CircuitStateBuffer movedState { std::move (voiceStates.back()) };
+        REQUIRE (movedState.data() == movedData);
+        REQUIRE (voiceStates.back().size() == 0);
+    }
+
+    SECTION ("State Size")
+    {
+        // voltage source, resistor, capacitor, series adaptor, and polarity inverter
+        // each have 2 waves, the capacitor also has an internal state.
+        wdft::ResistorT<float> r1 { 1000.0f };
+        wdft::CapacitorT<float> c1 { 1.0e-6f };
+        auto s1 = wdft::makeSeries<float> (r1, c1);
+        auto i1 = wdft::makeInverter<float> (s1);
+        wdft::IdealVoltageSourceT<float, decltype (i1)> vs { i1 };
+
+        int numElements = 0;
+        wdft::forEachElement (vs, [&numElements] (auto&) { numElements++; });
+        REQUIRE (numElements == 5);
+        REQUIRE (wdft::getStateSizeBytes (vs) == 11 * sizeof (float));
+    }
+}
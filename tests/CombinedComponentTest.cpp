@@ -1,9 +1,35 @@
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
 #include <catch2/catch2.hpp>
 #include <chowdsp_wdf/chowdsp_wdf.h>
 #include <iostream>
 
 using namespace chowdsp::wdft;
 
+namespace
+{
+/** Checks that a fused element matches the equivalent tree of adaptors */
+template <typename RefType, typename FusedType>
+void checkFusedElement (RefType& ref, FusedType& fused, int numSamples = 1000)
+{
+    REQUIRE (fused.wdf.R == Approx { ref.wdf.R });
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const auto a = std::sin (0.05 * (double) n) + ((n / 100) % 2 == 0 ? 0.5 : -0.5);
+
+        const auto expected = ref.reflected();
+        ref.incident (a);
+
+        const auto actual = fused.reflected();
+        fused.incident (a);
+
+        REQUIRE (actual == Approx { expected }.margin (1.0e-9));
+    }
+}
+} // namespace
+
 TEST_CASE ("Combined Component Test")
 {
     SECTION ("Resistor/Capacitor Series")
@@ -82,6 +108,34 @@ TEST_CASE ("Combined Component Test")
         }
     }
 
+    SECTION ("Resistor/Capacitor/Voltage Source Step Response")
+    {
+        // with T close to 2RC, so that the state update coefficient must be
+        // T / (T + 2RC), rather than T / 2RC
+        static constexpr double fs = 48000.0;
+        static constexpr double r_val = 100.0;
+        static constexpr double c_val = 100.0e-9;
+        static constexpr double source_v = 1.0;
+
+        ResistiveCapacitiveVoltageSourceT<double> rc1 { r_val, c_val, fs };
+        IdealVoltageSourceT<double, decltype (rc1)> v0 { rc1 };
+        rc1.setVoltage (source_v);
+
+        // bilinear-transform solution of a series RC circuit, shorted, with a voltage step
+        const auto k = 1.0 / (2.0 * r_val * c_val * fs);
+        const auto pole = (1.0 - k) / (1.0 + k);
+        auto expectedCurrent = source_v / (r_val * (1.0 + k));
+        for (int n = 0; n < 100; ++n)
+        {
+            v0.incident (rc1.reflected());
+            rc1.incident (v0.reflected());
+
+            REQUIRE (voltage<double> (v0) == Approx { 0.0 }.margin (1.0e-12));
+            REQUIRE (current<double> (rc1) == Approx { expectedCurrent }.margin (1.0e-12));
+            expectedCurrent *= pole;
+        }
+    }
+
     SECTION ("Capacitive Voltage Source")
     {
         static constexpr auto c_val = 2.0e-6f;
@@ -145,4 +199,295 @@ TEST_CASE ("Combined Component Test")
             REQUIRE (ref == Approx { actual }.margin (1.0e-4f));
         }
     }
+
+    SECTION ("Mixed-Precision State")
+    {
+        static constexpr auto r_val = 100.0;
+        static constexpr auto c_val = 470.0e-6;
+        static constexpr auto fs = 96000.0;
+
+        auto getMaxError = [] (auto&& rc) {
+            using FloatType = float;
+            ResistorCapacitorSeriesT<double> ref { r_val, c_val, fs };
+
+            double maxError = 0.0;
+            for (int n = 0; n < (int) fs; ++n)
+            {
+                const auto x = 0.5 + std::sin (2.0 * M_PI * 5.0 * (double) n / fs);
+
+                ref.incident (x);
+                const auto expected = ref.reflected();
+
+                rc.incident ((FloatType) x);
+                const auto actual = (double) rc.reflected();
+
+                maxError = std::max (maxError, std::abs (actual - expected));
+            }
+
+            return maxError;
+        };
+
+        const auto floatError = getMaxError (ResistorCapacitorSeriesT<float> { (float) r_val, (float) c_val, (float) fs });
+        const auto doubleStateError = getMaxError (ResistorCapacitorSeriesT<float, double> { (float) r_val, (float) c_val, (float) fs });
+        const auto compensatedStateError = getMaxError (ResistorCapacitorSeriesT<float, chowdsp::CompensatedFloat<float>> { (float) r_val, (float) c_val, (float) fs });
+
+        REQUIRE (doubleStateError < 0.1 * floatError);
+        REQUIRE (compensatedStateError < 0.1 * floatError);
+    }
+
+    SECTION ("Mixed-Precision Resistor/Capacitor/Voltage Source Series")
+    {
+        static constexpr auto r_val = 2000.0f;
+        static constexpr auto c_val = 2.0e-6f;
+        static constexpr auto source_v = 1.5f;
+
+        ResistiveCapacitiveVoltageSourceT<float> ref { r_val, c_val };
+        ref.setVoltage (source_v);
+
+        ResistiveCapacitiveVoltageSourceT<float, double> rc1 { r_val, c_val };
+        rc1.setVoltage (source_v);
+
+        ResistiveCapacitiveVoltageSourceT<float, chowdsp::CompensatedFloat<float>> rc2 { r_val, c_val };
+        rc2.setVoltage (source_v);
+
+        float inputs[] = { 0.0f, 1.0f, -1.0f, 2.0f, -3.0f };
+        for (auto& a : inputs)
+        {
+            ref.incident (a);
+            const auto expected = ref.reflected();
+
+            rc1.incident (a);
+            REQUIRE (rc1.reflected() == Approx { expected }.margin (1.0e-4f));
+
+            rc2.incident (a);
+            REQUIRE (rc2.reflected() == Approx { expected }.margin (1.0e-4f));
+        }
+    }
+
+    SECTION ("Resistor/Inductor Series")
+    {
+        ResistorT<double> r1 { 1000.0 };
+        InductorT<double> l1 { 10.0e-3 };
+        WDFSeriesT<double, decltype (r1), decltype (l1)> s1 { r1, l1 };
+
+        ResistorInductorSeriesT<double> rl1 { 1000.0, 10.0e-3 };
+        checkFusedElement (s1, rl1);
+
+        r1.setResistanceValue (47.0);
+        rl1.setResistanceValue (47.0);
+        l1.setInductanceValue (1.0e-3);
+        rl1.setInductanceValue (1.0e-3);
+        checkFusedElement (s1, rl1);
+    }
+
+    SECTION ("Resistor/Inductor Parallel")
+    {
+        ResistorT<double> r1 { 1000.0 };
+        InductorT<double> l1 { 10.0e-3 };
+        WDFParallelT<double, decltype (r1), decltype (l1)> p1 { r1, l1 };
+
+        ResistorInductorParallelT<double> rl1 { 1000.0, 10.0e-3 };
+        checkFusedElement (p1, rl1);
+
+        r1.setResistanceValue (47.0);
+        rl1.setResistanceValue (47.0);
+        l1.setInductanceValue (1.0e-3);
+        rl1.setInductanceValue (1.0e-3);
+        checkFusedElement (p1, rl1);
+    }
+
+    SECTION ("Inductor/Capacitor Series")
+    {
+        InductorT<double> l1 { 10.0e-3 };
+        CapacitorT<double> c1 { 1.0e-6 };
+        WDFSeriesT<double, decltype (l1), decltype (c1)> s1 { l1, c1 };
+
+        InductorCapacitorSeriesT<double> lc1 { 10.0e-3, 1.0e-6 };
+        checkFusedElement (s1, lc1);
+
+        l1.setInductanceValue (1.0e-3);
+        lc1.setInductanceValue (1.0e-3);
+        c1.setCapacitanceValue (47.0e-9);
+        lc1.setCapacitanceValue (47.0e-9);
+        checkFusedElement (s1, lc1);
+    }
+
+    SECTION ("Inductor/Capacitor Parallel")
+    {
+        InductorT<double> l1 { 10.0e-3 };
+        CapacitorT<double> c1 { 1.0e-6 };
+        WDFParallelT<double, decltype (l1), decltype (c1)> p1 { l1, c1 };
+
+        InductorCapacitorParallelT<double> lc1 { 10.0e-3, 1.0e-6 };
+        checkFusedElement (p1, lc1);
+
+        l1.setInductanceValue (1.0e-3);
+        lc1.setInductanceValue (1.0e-3);
+        c1.setCapacitanceValue (47.0e-9);
+        lc1.setCapacitanceValue (47.0e-9);
+        checkFusedElement (p1, lc1);
+    }
+
+    SECTION ("Resistor/Inductor/Capacitor Series")
+    {
+        ResistorT<double> r1 { 100.0 };
+        InductorT<double> l1 { 10.0e-3 };
+        CapacitorT<double> c1 { 1.0e-6 };
+        WDFSeriesT<double, decltype (l1), decltype (c1)> s1 { l1, c1 };
+        WDFSeriesT<double, decltype (r1), decltype (s1)> s2 { r1, s1 };
+
+        ResistorInductorCapacitorSeriesT<double> rlc1 { 100.0, 10.0e-3, 1.0e-6 };
+        checkFusedElement (s2, rlc1);
+
+        r1.setResistanceValue (2200.0);
+        rlc1.setResistanceValue (2200.0);
+        l1.setInductanceValue (1.0e-3);
+        rlc1.setInductanceValue (1.0e-3);
+        c1.setCapacitanceValue (47.0e-9);
+        rlc1.setCapacitanceValue (47.0e-9);
+        checkFusedElement (s2, rlc1);
+    }
+
+    SECTION ("Resistor/Capacitor/Current Source Parallel")
+    {
+        ResistiveCurrentSourceT<double> ri1 { 2000.0 };
+        ri1.setCurrent (1.5e-3);
+        CapacitorT<double> c1 { 2.0e-6 };
+        WDFParallelT<double, decltype (ri1), decltype (c1)> p1 { ri1, c1 };
+
+        ResistiveCapacitiveCurrentSourceT<double> rci1 { 2000.0, 2.0e-6 };
+        rci1.setCurrent (1.5e-3);
+        checkFusedElement (p1, rci1);
+
+        ri1.setResistanceValue (470.0);
+        rci1.setResistanceValue (470.0);
+        ri1.setCurrent (-2.0e-3);
+        rci1.setCurrent (-2.0e-3);
+        checkFusedElement (p1, rci1);
+    }
+
+    SECTION ("Capacitor With ESR")
+    {
+        ResistorT<double> esr { 0.5 };
+        CapacitorT<double> c1 { 100.0e-6 };
+        ResistorT<double> leakage { 10.0e3 };
+        WDFParallelT<double, decltype (c1), decltype (leakage)> p1 { c1, leakage };
+        WDFSeriesT<double, decltype (esr), decltype (p1)> s1 { esr, p1 };
+
+        CapacitorESRT<double> cesr1 { 100.0e-6, 0.5, 48000.0, 10.0e3 };
+        checkFusedElement (s1, cesr1);
+
+        esr.setResistanceValue (2.0);
+        cesr1.setESRValue (2.0);
+        leakage.setResistanceValue (1.0e6);
+        cesr1.setLeakageResistanceValue (1.0e6);
+        c1.setCapacitanceValue (10.0e-6);
+        cesr1.setCapacitanceValue (10.0e-6);
+        checkFusedElement (s1, cesr1);
+
+        // with the default leakage resistance, this is just a resistor and capacitor in series
+        ResistorCapacitorSeriesT<double> rc1 { 0.5, 100.0e-6 };
+        CapacitorESRT<double> cesr2 { 100.0e-6, 0.5 };
+        for (int n = 0; n < 1000; ++n)
+        {
+            REQUIRE (cesr2.reflected() == Approx { rc1.reflected() }.margin (1.0e-6));
+
+            const auto a = std::sin (0.05 * (double) n);
+            rc1.incident (a);
+            cesr2.incident (a);
+        }
+    }
+
+    SECTION ("Polymorphic Fused Elements")
+    {
+        ResistorInductorCapacitorSeriesT<double> rlc1 { 100.0, 10.0e-3, 1.0e-6 };
+        chowdsp::wdf::ResistorInductorCapacitorSeries<double> rlc2 { 100.0, 10.0e-3, 1.0e-6 };
+
+        CapacitorESRT<double> cesr1 { 100.0e-6, 0.5, 48000.0, 10.0e3 };
+        chowdsp::wdf::CapacitorESR<double> cesr2 { 100.0e-6, 0.5, 10.0e3 };
+
+        for (int n = 0; n < 100; ++n)
+        {
+            REQUIRE (rlc2.reflected() == rlc1.reflected());
+            REQUIRE (cesr2.reflected() == cesr1.reflected());
+
+            const auto a = std::sin (0.05 * (double) n);
+            rlc1.incident (a);
+            rlc2.incident (a);
+            cesr1.incident (a);
+            cesr2.incident (a);
+        }
+    }
+
+    SECTION ("Automatic Fusion")
+    {
+        static_assert (std::is_same<decltype (makeSeries<double> (CapacitorT<double> { 1.0e-6 }, ResistorT<double> { 1.0 })),
+                                    ResistorCapacitorSeriesT<double>>::value,
+                       "Capacitor + Resistor should fuse to ResistorCapacitorSeriesT");
+        static_assert (std::is_same<FusedParallelT<double, InductorT<double>, ResistorT<double>>, ResistorInductorParallelT<double>>::value,
+                       "Inductor || Resistor should fuse to ResistorInductorParallelT");
+
+        constexpr double fs = 96000.0;
+
+        // nested fusion: R + (L + C)
+        ResistorT<double> r1 { 100.0 };
+        InductorT<double> l1 { 10.0e-3, fs };
+        CapacitorT<double> c1 { 1.0e-6, fs };
+        WDFSeriesT<double, decltype (l1), decltype (c1)> s1 { l1, c1 };
+        WDFSeriesT<double, decltype (r1), decltype (s1)> s2 { r1, s1 };
+
+        auto rlc1 = makeSeries<double> (ResistorT<double> { 100.0 },
+                                        makeSeries<double> (InductorT<double> { 10.0e-3, fs },
+                                                            CapacitorT<double> { 1.0e-6, fs }));
+        static_assert (std::is_same<decltype (rlc1), ResistorInductorCapacitorSeriesT<double>>::value,
+                       "R + (L + C) should fuse to ResistorInductorCapacitorSeriesT");
+        checkFusedElement (s2, rlc1);
+
+        r1.setResistanceValue (47.0);
+        rlc1.setResistanceValue (47.0);
+        c1.setCapacitanceValue (47.0e-9);
+        rlc1.setCapacitanceValue (47.0e-9);
+        checkFusedElement (s2, rlc1);
+
+        // nested fusion: ESR + (C || leakage)
+        ResistorT<double> esr { 0.5 };
+        CapacitorT<double> c2 { 100.0e-6, fs };
+        ResistorT<double> leakage { 10.0e3 };
+        WDFParallelT<double, decltype (c2), decltype (leakage)> p1 { c2, leakage };
+        WDFSeriesT<double, decltype (esr), decltype (p1)> s3 { esr, p1 };
+
+        auto cesr1 = makeSeries<double> (makeParallel<double> (CapacitorT<double> { 100.0e-6, fs }, ResistorT<double> { 10.0e3 }),
+                                         ResistorT<double> { 0.5 });
+        static_assert (std::is_same<decltype (cesr1), CapacitorESRT<double>>::value,
+                       "(C || R) + R should fuse to CapacitorESRT");
+        checkFusedElement (s3, cesr1);
+
+        // sources keep their voltage/current
+        ResistiveVoltageSourceT<double> vs1 { 1.0e3 };
+        vs1.setVoltage (0.5);
+        CapacitorT<double> c3 { 1.0e-6, fs };
+        WDFSeriesT<double, decltype (vs1), decltype (c3)> s4 { vs1, c3 };
+
+        ResistiveVoltageSourceT<double> vs2 { 1.0e3 };
+        vs2.setVoltage (0.5);
+        auto rcv1 = makeSeries<double> (std::move (vs2), CapacitorT<double> { 1.0e-6, fs });
+        checkFusedElement (s4, rcv1);
+
+        ResistiveCurrentSourceT<double> is1 { 2.0e3 };
+        is1.setCurrent (1.0e-3);
+        CapacitorT<double> c4 { 1.0e-6, fs };
+        WDFParallelT<double, decltype (c4), decltype (is1)> p2 { c4, is1 };
+
+        ResistiveCurrentSourceT<double> is2 { 2.0e3 };
+        is2.setCurrent (1.0e-3);
+        auto rci1 = makeParallel<double> (CapacitorT<double> { 1.0e-6, fs }, std::move (is2));
+        checkFusedElement (p2, rci1);
+
+        // elements passed by reference are still connected with an adaptor
+        ResistorT<double> r2 { 1.0e3 };
+        CapacitorT<double> c5 { 1.0e-6 };
+        auto s5 = makeSeries<double> (r2, c5);
+        static_assert (std::is_same<decltype (s5), WDFSeriesT<double, ResistorT<double>, CapacitorT<double>>>::value,
+                       "References should not be fused");
+    }
 }
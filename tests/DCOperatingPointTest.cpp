@@ -0,0 +1,194 @@
+#include <catch2/catch2.hpp>
+#include <chowdsp_wdf/chowdsp_wdf.h>
+
+using namespace chowdsp;
+
+namespace
+{
+constexpr double fs = 48000.0;
+
+/** A biased coupling network: Vbias -> R1 -> (C1 || R2) */
+template <typename T>
+struct BiasNetwork
+{
+    BiasNetwork()
+    {
+        C1.prepare ((T) fs);
+        Vbias.setVoltage ((T) 4.5);
+    }
+
+    void processSample()
+    {
+        Vbias.incident (I1.reflected());
+        I1.incident (Vbias.reflected());
+    }
+
+    wdft::CapacitorT<T> C1 { (T) 10.0e-6 };
+    wdft::ResistorT<T> R2 { (T) 10.0e3 };
+    wdft::WDFParallelT<T, decltype (C1), decltype (R2)> P1 { C1, R2 };
+    wdft::ResistorT<T> R1 { (T) 30.0e3 };
+    wdft::WDFSeriesT<T, decltype (R1), decltype (P1)> S1 { R1, P1 };
+    wdft::PolarityInverterT<T, decltype (S1)> I1 { S1 };
+    wdft::IdealVoltageSourceT<T, decltype (I1)> Vbias { I1 };
+};
+
+/** Vin -> R1 -> L1 -> (C1 || R2), with a DC current source in parallel with C1 */
+struct InductorNetwork
+{
+    InductorNetwork()
+    {
+        L1.prepare ((double) fs);
+        C1.prepare ((double) fs);
+        Vs.setVoltage (2.0);
+        Is.setCurrent (1.0e-3);
+    }
+
+    void processSample()
+    {
+        Vs.incident (I1.reflected());
+        I1.incident (Vs.reflected());
+    }
+
+    wdft::ResistiveCurrentSourceT<double> Is { 1.0e3 };
+    wdft::CapacitorT<double> C1 { 1.0e-6 };
+    wdft::WDFParallelT<double, decltype (Is), decltype (C1)> P1 { Is, C1 };
+    wdft::InductorT<double> L1 { 0.1 };
+    wdft::WDFSeriesT<double, decltype (L1), decltype (P1)> S1 { L1, P1 };
+    wdft::ResistorT<double> R1 { 500.0 };
+    wdft::WDFSeriesT<double, decltype (R1), decltype (S1)> S2 { R1, S1 };
+    wdft::PolarityInverterT<double, decltype (S2)> I1 { S2 };
+    wdft::IdealVoltageSourceT<double, decltype (I1)> Vs { I1 };
+};
+
+/** Biased diode clipper, with a coupling capacitor at the input */
+template <typename T>
+struct BiasedClipper
+{
+    BiasedClipper()
+    {
+        Vin.prepare ((T) fs);
+        C2.prepare ((T) fs);
+        Vin.setVoltage ((T) 0.5);
+        Vb.setVoltage ((T) 1.0);
+    }
+
+    void processSample()
+    {
+        dp.incident (P2.reflected());
+        P2.incident (dp.reflected());
+    }
+
+    wdft::ResistiveCapacitiveVoltageSourceT<T> Vin { (T) 1.0e3, (T) 1.0e-6 };
+    wdft::ResistiveVoltageSourceT<T> Vb { (T) 10.0e3 };
+    wdft::WDFParallelT<T, decltype (Vin), decltype (Vb)> P1 { Vin, Vb };
+    wdft::CapacitorT<T> C2 { (T) 47.0e-9 };
+    wdft::WDFParallelT<T, decltype (P1), decltype (C2)> P2 { P1, C2 };
+    wdft::DiodePairT<T, decltype (P2)> dp { P2, (T) 2.52e-9 };
+};
+
+template <typename T>
+struct BiasedClipperPoly
+{
+    BiasedClipperPoly()
+    {
+        C1.prepare ((T) fs);
+        C2.prepare ((T) fs);
+        Vs.setVoltage ((T) 1.0);
+    }
+
+    void processSample()
+    {
+        dp.incident (P2.reflected());
+        P2.incident (dp.reflected());
+    }
+
+    wdf::ResistiveVoltageSource<T> Vs { (T) 1.0e3 };
+    wdf::Capacitor<T> C1 { (T) 1.0e-6 };
+    wdf::ResistorCapacitorParallel<T> RC1 { (T) 10.0e3, (T) 1.0e-6 };
+    wdf::WDFParallel<T> P1 { &C1, &RC1 };
+    wdf::WDFSeries<T> S1 { &Vs, &P1 };
+    wdf::Capacitor<T> C2 { (T) 47.0e-9 };
+    wdf::WDFParallel<T> P2 { &S1, &C2 };
+    wdf::DiodePair<T> dp { &P2, (T) 2.52e-9 };
+};
+
+/** Checks that the circuit output doesn't change after the circuit has been settled */
+template <typename ProcessFunc, typename OutputFunc>
+void checkStationary (ProcessFunc&& process, OutputFunc&& output, double tolerance)
+{
+    const auto settledOutput = (double) output();
+    for (int n = 0; n < 1000; ++n)
+    {
+        process();
+        REQUIRE ((double) output() == Approx (settledOutput).margin (tolerance));
+    }
+}
+} // namespace
+
+TEST_CASE ("DC Operating Point Test")
+{
+    SECTION ("Bias Network")
+    {
+        BiasNetwork<double> circuit;
+        REQUIRE (wdft::settleToDC (circuit.Vbias, [&] { circuit.processSample(); }));
+
+        // capacitor is open circuit at DC
+        REQUIRE (wdft::voltage<double> (circuit.C1) == Approx (4.5 * 10.0 / 40.0).margin (1.0e-6));
+        checkStationary ([&] { circuit.processSample(); }, [&] { return wdft::voltage<double> (circuit.C1); }, 1.0e-6);
+    }
+
+    SECTION ("Bias Network (float)")
+    {
+        BiasNetwork<float> circuit;
+        REQUIRE (wdft::settleToDC (circuit.Vbias, [&] { circuit.processSample(); }));
+
+        // with single precision, the slow capacitor mode can only be resolved to roughly eps * tau * fs
+        REQUIRE (wdft::voltage<float> (circuit.C1) == Approx (4.5 * 10.0 / 40.0).margin (5.0e-3));
+        checkStationary ([&] { circuit.processSample(); }, [&] { return wdft::voltage<float> (circuit.C1); }, 1.0e-3);
+    }
+
+    SECTION ("Inductor Network")
+    {
+        InductorNetwork circuit;
+        wdft::DCOperatingPointSolver solver;
+        solver.prepare (circuit.Vs);
+        REQUIRE (solver.settle (circuit.Vs, [&] { circuit.processSample(); }));
+
+        // inductor is short circuit, capacitor is open circuit at DC
+        const auto expectedCurrent = (2.0 + 1.0e-3 * 1.0e3) / (500.0 + 1.0e3);
+        REQUIRE (wdft::current<double> (circuit.R1) == Approx (expectedCurrent).margin (1.0e-8));
+        REQUIRE (wdft::current<double> (circuit.C1) == Approx (0.0).margin (1.0e-8));
+        REQUIRE (wdft::voltage<double> (circuit.L1) == Approx (0.0).margin (1.0e-8));
+        checkStationary ([&] { circuit.processSample(); }, [&] { return wdft::current<double> (circuit.L1); }, 1.0e-8);
+    }
+
+    SECTION ("Biased Diode Clipper")
+    {
+        // reference: pre-roll the circuit for a long time
+        BiasedClipper<double> reference;
+        for (int n = 0; n < (int) fs * 5; ++n)
+            reference.processSample();
+
+        BiasedClipper<double> circuit;
+        wdft::DCOperatingPointSolver solver;
+        solver.prepare (circuit.dp);
+        REQUIRE (solver.settle (circuit.dp, [&] { circuit.processSample(); }));
+
+        REQUIRE (wdft::voltage<double> (circuit.C2) == Approx (wdft::voltage<double> (reference.C2)).margin (1.0e-6));
+        REQUIRE (wdft::voltage<double> (circuit.C2) > 0.1);
+        checkStationary ([&] { circuit.processSample(); }, [&] { return wdft::voltage<double> (circuit.C2); }, 1.0e-6);
+    }
+
+    SECTION ("Biased Diode Clipper (dynamic)")
+    {
+        BiasedClipperPoly<double> reference;
+        for (int n = 0; n < (int) fs * 5; ++n)
+            reference.processSample();
+
+        BiasedClipperPoly<double> circuit;
+        REQUIRE (wdft::settleToDC (circuit.dp, [&] { circuit.processSample(); }));
+
+        REQUIRE (circuit.C2.voltage() == Approx (reference.C2.voltage()).margin (1.0e-6));
+        checkStationary ([&] { circuit.processSample(); }, [&] { return circuit.C2.voltage(); }, 1.0e-6);
+    }
+}
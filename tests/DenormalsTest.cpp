@@ -0,0 +1,128 @@
+#include <cmath>
+#include <limits>
+
+#include <catch2/catch2.hpp>
+#include <chowdsp_wdf/chowdsp_wdf.h>
+
+using namespace chowdsp::wdft;
+
+namespace
+{
+/** An RC lowpass, excited with a tiny impulse so that it decays through the denormal range */
+template <typename T, typename Func>
+void runDenormalDecay (Func&& checkOutput)
+{
+    ResistiveVoltageSourceT<T> vs { (T) 1.0e3 };
+    CapacitorT<T> c1 { (T) 1.0e-6 };
+    auto p1 = makeParallel<T> (vs, c1);
+    IdealCurrentSourceT<T, decltype (p1)> is { p1 };
+    c1.prepare ((T) 48000);
+
+    for (int n = 0; n < 2000; ++n)
+    {
+        vs.setVoltage (n == 0 ? (T) 100 * std::numeric_limits<T>::min() : (T) 0);
+        is.incident (p1.reflected());
+        p1.incident (is.reflected());
+
+        checkOutput (voltage<T> (c1));
+    }
+}
+
+/** Drives a reactive element (in parallel with a resistive source) with a tiny impulse, and checks its state after every sample */
+template <typename T, typename ElementType, typename Func>
+void runElementDecay (ElementType& element, Func&& checkState)
+{
+    ResistiveVoltageSourceT<T> vs { (T) 1.0e3 };
+    auto p1 = makeParallel<T> (vs, element);
+    IdealCurrentSourceT<T, decltype (p1)> is { p1 };
+
+    for (int n = 0; n < 4000; ++n)
+    {
+        vs.setVoltage (n == 0 ? (T) 100 * std::numeric_limits<T>::min() : (T) 0);
+        is.incident (p1.reflected());
+        p1.incident (is.reflected());
+
+        element.visitState (checkState);
+    }
+}
+
+template <typename ElementType>
+void checkStateIsFlushed (ElementType&& element)
+{
+    runElementDecay<float> (element, [] (float x)
+                            { REQUIRE (std::fpclassify (x) != FP_SUBNORMAL); });
+}
+} // namespace
+
+TEST_CASE ("Denormals Test")
+{
+    SECTION ("Flush Test")
+    {
+        using chowdsp::denormals::flush;
+
+        REQUIRE (flush (1.0f) == 1.0f);
+        REQUIRE (flush (-std::numeric_limits<float>::min()) == -std::numeric_limits<float>::min());
+        REQUIRE (flush (std::numeric_limits<float>::denorm_min()) == 0.0f);
+        REQUIRE (flush (-0.5 * std::numeric_limits<double>::min()) == 0.0);
+        REQUIRE (flush (0.0) == 0.0);
+
+        chowdsp::CompensatedFloat<float> x { 1.0f };
+        x.lo = std::numeric_limits<float>::denorm_min();
+        const auto xFlushed = flush (x);
+        REQUIRE (xFlushed.hi == 1.0f);
+        REQUIRE (xFlushed.lo == 0.0f);
+    }
+
+    SECTION ("Scoped No Denormals Test")
+    {
+        if (! ScopedNoDenormals::isSupported())
+            return;
+
+        volatile float smallest = std::numeric_limits<float>::min();
+        volatile float half = 0.5f;
+        {
+            ScopedNoDenormals noDenormals;
+            REQUIRE (smallest * half == 0.0f);
+        }
+        REQUIRE (smallest * half > 0.0f);
+    }
+
+    SECTION ("Denormal Decay Test")
+    {
+        // Without flushing, this circuit produces denormal outputs...
+        int numDenormals = 0;
+        runDenormalDecay<float> ([&numDenormals] (float y)
+                                 { numDenormals += std::fpclassify (y) == FP_SUBNORMAL ? 1 : 0; });
+
+#if ! CHOWDSP_WDF_FLUSH_DENORMALS
+        REQUIRE (numDenormals > 0);
+#endif
+
+        // ... and with the FTZ/DAZ flags set, the circuit never produces denormals.
+        if (ScopedNoDenormals::isSupported())
+        {
+            ScopedNoDenormals noDenormals;
+            runDenormalDecay<float> ([] (float y)
+                                     { REQUIRE (std::fpclassify (y) != FP_SUBNORMAL); });
+        }
+    }
+
+#if CHOWDSP_WDF_FLUSH_DENORMALS
+    SECTION ("Reactive State Flush Test")
+    {
+        // the FTZ/DAZ flags are not set, so the elements must flush their own states
+        checkStateIsFlushed (CapacitorT<float> { 1.0e-6f });
+        checkStateIsFlushed (CapacitorAlphaT<float> { 1.0e-6f, 48000.0f, 0.5f });
+        checkStateIsFlushed (InductorT<float> { 1.0e-3f });
+        checkStateIsFlushed (InductorAlphaT<float> { 1.0e-3f, 48000.0f, 0.5f });
+        checkStateIsFlushed (ResistorCapacitorSeriesT<float> { 100.0f, 1.0e-6f });
+        checkStateIsFlushed (ResistorCapacitorParallelT<float> { 1.0e3f, 1.0e-6f });
+        checkStateIsFlushed (ResistorInductorSeriesT<float> { 100.0f, 1.0e-3f });
+        checkStateIsFlushed (ResistorInductorParallelT<float> { 1.0e3f, 1.0e-3f });
+        checkStateIsFlushed (InductorCapacitorSeriesT<float> { 1.0e-3f, 1.0e-6f });
+        checkStateIsFlushed (InductorCapacitorParallelT<float> { 1.0e-3f, 1.0e-6f });
+        checkStateIsFlushed (ResistorInductorCapacitorSeriesT<float> { 100.0f, 1.0e-3f, 1.0e-6f });
+        checkStateIsFlushed (CapacitorESRT<float> { 1.0e-6f, 10.0f });
+    }
+#endif
+}
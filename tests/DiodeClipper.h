@@ -0,0 +1,124 @@
+#pragma once
+
+#if CHOWDSP_WDF_TEST_WITH_XSIMD
+#include <xsimd/xsimd.hpp>
+#endif
+
+#include <chowdsp_wdf/chowdsp_wdf.h>
+
+using namespace chowdsp;
+
+/**
+ * Diode clipper circuit: an RC-coupled input, with a (0 V, unless set) bias source,
+ * driving an RC/inductor load, clipped by a diode pair.
+ * (StateType can be used to store the input coupling capacitor state at a higher precision)
+ */
+template <typename T, typename StateType = T>
+class DiodeClipper
+{
+public:
+    explicit DiodeClipper (double sampleRate = 48000.0)
+    {
+        prepare (sampleRate);
+    }
+
+    void prepare (double sampleRate)
+    {
+        Vs.prepare ((T) sampleRate);
+        Vb.prepare ((T) sampleRate);
+        C1.prepare ((T) sampleRate);
+        L1.prepare ((T) sampleRate);
+    }
+
+    /** Sets the circuit parameters, from a single control in [0, 1] */
+    void setParams (float param)
+    {
+        wdft::ScopedDeferImpedancePropagation<decltype (S2)> deferImpedance { S2 };
+        R1.setResistanceValue ((T) 1.0e3 + (T) 9.0e3 * (T) param);
+        C1.setCapacitanceValue ((T) 10.0e-9 + (T) 90.0e-9 * (T) param);
+        L1.setInductanceValue ((T) 0.1 + (T) param);
+        dp.setDiodeParameters ((T) 2.52e-9, (T) 0.02585, (T) 1 + (T) param);
+    }
+
+    T processSample (T x) noexcept
+    {
+        Vs.setVoltage (x);
+        dp.incident (P1.reflected());
+        P1.incident (dp.reflected());
+        return wdft::voltage<T> (C1);
+    }
+
+    void processBlock (T* buffer, int numSamples) noexcept
+    {
+        for (int n = 0; n < numSamples; ++n)
+            buffer[n] = processSample (buffer[n]);
+    }
+
+    /** Returns the root of the WDF tree */
+    auto& getRoot() noexcept { return dp; }
+
+    wdft::ResistiveCapacitiveVoltageSourceT<T, StateType> Vs { (T) 4700, (T) 1.0e-6 };
+    wdft::CapacitiveVoltageSourceT<T> Vb { (T) 4.7e-6 };
+    wdft::WDFSeriesT<T, decltype (Vs), decltype (Vb)> S1 { Vs, Vb };
+    wdft::ResistorT<T> R1 { (T) 1.0e3 };
+    wdft::CapacitorAlphaT<T> C1 { (T) 47.0e-9, (T) 48000, (T) 0.8 };
+    wdft::WDFSeriesT<T, decltype (R1), decltype (C1)> S2 { R1, C1 };
+    wdft::InductorT<T> L1 { (T) 0.5 };
+    wdft::WDFParallelT<T, decltype (S2), decltype (L1)> P0 { S2, L1 };
+    wdft::WDFParallelT<T, decltype (S1), decltype (P0)> P1 { S1, P0 };
+    wdft::DiodePairT<T, decltype (P1)> dp { P1, (T) 2.52e-9 };
+};
+
+/** Diode clipper circuit, using the run-time wdf API */
+template <typename T>
+class DiodeClipperPoly
+{
+public:
+    explicit DiodeClipperPoly (double sampleRate = 48000.0)
+    {
+        prepare (sampleRate);
+    }
+
+    void prepare (double sampleRate)
+    {
+        C1.prepare ((T) sampleRate);
+        RC1.prepare ((T) sampleRate);
+    }
+
+    /** Sets the circuit parameters, from a single control in [0, 1] */
+    void setParams (float param)
+    {
+        R1.setResistanceValue ((T) 1.0e3 + (T) 9.0e3 * (T) param);
+        C1.setCapacitanceValue ((T) 10.0e-9 + (T) 90.0e-9 * (T) param);
+        RC1.setResistanceValue ((T) 100 + (T) 900 * (T) param);
+    }
+
+    T processSample (T x) noexcept
+    {
+        Vs.setVoltage (x);
+        dp.incident (P1.reflected());
+        P1.incident (dp.reflected());
+        return C1.voltage();
+    }
+
+    void processBlock (T* buffer, int numSamples) noexcept
+    {
+        for (int n = 0; n < numSamples; ++n)
+            buffer[n] = processSample (buffer[n]);
+    }
+
+    /** Returns the root of the WDF tree */
+    auto& getRoot() noexcept { return dp; }
+
+    wdf::ResistiveVoltageSource<T> Vs { (T) 4700 };
+    wdf::ResistorCapacitorParallel<T> RC1 { (T) 1.0e3, (T) 1.0e-6 };
+    wdf::WDFSeries<T> S1 { &Vs, &RC1 };
+    wdf::PolarityInverter<T> I1 { &S1 };
+    wdf::Resistor<T> R1 { (T) 1.0e3 };
+    wdf::Capacitor<T> C1 { (T) 47.0e-9 };
+    wdf::WDFSeries<T> S2 { &R1, &C1 };
+    wdf::WDFParallel<T> P0 { &I1, &S2 };
+    wdf::Resistor<T> R2 { (T) 10.0e3 };
+    wdf::WDFParallel<T> P1 { &P0, &R2 };
+    wdf::DiodePair<T> dp { &P1, (T) 2.52e-9 };
+};
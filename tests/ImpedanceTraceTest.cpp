@@ -0,0 +1,140 @@
+#include <sstream>
+
+#include <catch2/catch2.hpp>
+#include <chowdsp_wdf/chowdsp_wdf.h>
+#include <chowdsp_wdf/util/impedance_trace.h> // only included by the WDF elements when tracing is enabled
+
+/**
+ * The tracing hooks are only compiled in when CHOWDSP_WDF_TRACING is enabled,
+ * which can be done for the whole test suite with -DCHOWDSP_WDF_TEST_WITH_TRACING=ON.
+ * The chowdsp_wdf_tracing_tests target always builds this test with tracing enabled.
+ */
+TEST_CASE ("Impedance Trace Test")
+{
+    using namespace chowdsp;
+
+    SECTION ("Ring Buffer")
+    {
+        wdft::ImpedanceTracer tracer { 3 }; // rounded up to 4
+        for (int i = 0; i < 6; ++i)
+        {
+            wdft::ImpedanceTraceEvent event;
+            event.propagationId = (uint64_t) i;
+            REQUIRE (tracer.push (event) == (i < 4));
+        }
+        REQUIRE (tracer.getNumDroppedEvents() == 2);
+
+        wdft::ImpedanceTraceEvent event;
+        for (uint64_t i = 0; i < 4; ++i)
+        {
+            REQUIRE (tracer.pop (event));
+            REQUIRE (event.propagationId == i);
+        }
+        REQUIRE (! tracer.pop (event));
+
+        // the buffer should keep working after it wraps around
+        event.propagationId = 100;
+        REQUIRE (tracer.push (event));
+        REQUIRE (tracer.pop (event));
+        REQUIRE (event.propagationId == 100);
+    }
+
+    SECTION ("Escaped Element Names")
+    {
+        wdft::ResistorT<float> r1 { 1000.0f };
+        wdft::ResistorT<float> r2 { 1000.0f };
+
+        wdft::ImpedanceTracer tracer;
+        tracer.setElementName (r1, "\"quoted\" C:\\pot");
+        tracer.setElementName (r2, "tab\there");
+
+        wdft::ImpedanceTraceEvent event;
+        event.element = &r1;
+        event.source = &r2;
+        REQUIRE (tracer.push (event));
+
+        std::ostringstream trace;
+        tracer.writeChromeTrace (trace);
+        const auto traceString = trace.str();
+        REQUIRE (traceString.find ("\"element\":\"\\\"quoted\\\" C:\\\\pot\",\"source\":\"tab\\u0009here\"") != std::string::npos);
+    }
+
+    SECTION ("Propagation Trace")
+    {
+        wdft::ResistorT<float> r1 { 1000.0f };
+        wdft::CapacitorT<float> c1 { 1.0e-6f };
+        wdft::WDFSeriesT<float, decltype (r1), decltype (c1)> s1 { r1, c1 };
+        wdft::ResistorT<float> r2 { 1000.0f };
+        wdft::WDFParallelT<float, decltype (s1), decltype (r2)> p1 { s1, r2 };
+        wdft::IdealVoltageSourceT<float, decltype (p1)> vs { p1 };
+
+        wdft::ImpedanceTracer tracer;
+        tracer.setElementName (r1, "r1");
+        tracer.setElementName (s1, "s1");
+        wdft::ImpedanceTracer::setActiveTracer (&tracer);
+
+        r1.setResistanceValue (2000.0f);
+        {
+            wdft::ScopedDeferImpedancePropagation<decltype (s1)> deferImpedance { s1 };
+            c1.setCapacitanceValue (2.0e-6f);
+        }
+
+        wdft::ImpedanceTracer::setActiveTracer (nullptr);
+        r2.setResistanceValue (2000.0f); // not traced
+
+#if CHOWDSP_WDF_TRACING
+        using EventType = wdft::ImpedanceTraceEvent::Type;
+
+        // events are recorded when the propagation leaves each element, so the root comes first
+        const std::vector<std::pair<const wdft::BaseWDF*, EventType>> expectedEvents {
+            { &vs, EventType::Propagation },
+            { &p1, EventType::Propagation },
+            { &s1, EventType::Propagation },
+            { &r1, EventType::Propagation },
+            { &s1, EventType::Deferred },
+            { &c1, EventType::Propagation },
+            { &s1, EventType::DeferredCalc },
+        };
+
+        wdft::ImpedanceTraceEvent event;
+        for (size_t i = 0; i < expectedEvents.size(); ++i)
+        {
+            REQUIRE (tracer.pop (event));
+            REQUIRE (event.element == expectedEvents[i].first);
+            REQUIRE (event.type == expectedEvents[i].second);
+
+            if (i < 4)
+            {
+                REQUIRE (event.source == &r1);
+                REQUIRE (event.depth == (uint32_t) (3 - i));
+                REQUIRE (event.propagationId == 1);
+                REQUIRE (event.calcImpedanceNs <= event.durationNs);
+            }
+            else if (i < 6)
+            {
+                REQUIRE (event.source == &c1);
+                REQUIRE (event.propagationId == 2);
+            }
+        }
+        REQUIRE (! tracer.pop (event));
+
+        // export a trace, and check that it looks sensible
+        r1.setResistanceValue (3000.0f);
+        wdft::ImpedanceTracer::setActiveTracer (&tracer);
+        r1.setResistanceValue (4000.0f);
+        wdft::ImpedanceTracer::setActiveTracer (nullptr);
+
+        std::ostringstream trace;
+        tracer.writeChromeTrace (trace);
+        const auto traceString = trace.str();
+        REQUIRE (traceString.find ("{\"traceEvents\":[") == 0);
+        REQUIRE (traceString.find ("\"element\":\"r1\",\"source\":\"r1\",\"depth\":0") != std::string::npos);
+        REQUIRE (traceString.find ("\"element\":\"s1\",\"source\":\"r1\",\"depth\":1") != std::string::npos);
+        REQUIRE (traceString.find ("\"droppedEvents\":0") != std::string::npos);
+        REQUIRE (! tracer.pop (event));
+#else
+        wdft::ImpedanceTraceEvent event;
+        REQUIRE (! tracer.pop (event));
+#endif
+    }
+}
@@ -0,0 +1,212 @@
+#include <catch2/catch2.hpp>
+#include <chowdsp_wdf/chowdsp_wdf.h>
+
+#include "BassmanToneStack.h"
+
+namespace
+{
+constexpr double fs = 48000.0;
+
+/** Any number of ports connected in parallel */
+struct ParallelTopology
+{
+    static constexpr int numNodes = 1;
+    static wdft::RtypePortNodes getPortNodes (int) { return { 1, 0 }; }
+};
+
+/** Three ports connected in series (around a loop), with the upward-facing port first */
+struct SeriesTopology
+{
+    static constexpr int numNodes = 2;
+    static wdft::RtypePortNodes getPortNodes (int portIndex)
+    {
+        constexpr wdft::RtypePortNodes nodes[] = { { 1, 0 }, { 1, 2 }, { 0, 2 } };
+        return nodes[portIndex];
+    }
+};
+
+/** A resistive voltage source, loaded by numResistors resistors, all connected in parallel */
+template <typename Indices>
+struct ParallelJunction;
+
+template <size_t... I>
+struct ParallelJunction<std::index_sequence<I...>>
+{
+    static constexpr int numPorts = 1 + (int) sizeof...(I);
+
+    double expectedVoltage (double x) const
+    {
+        double Gsum = vs.wdf.G;
+        for (auto& r : rs)
+            Gsum += r.wdf.G;
+        return x * vs.wdf.G / Gsum;
+    }
+
+    wdft::ResistiveVoltageSourceT<double> vs { 100.0 };
+    std::array<wdft::ResistorT<double>, sizeof...(I)> rs { { wdft::ResistorT<double> { 1000.0 + 100.0 * (double) I }... } };
+    wdft::IncrementalRootRtypeAdaptor<double, ParallelTopology, decltype (vs), std::tuple_element_t<I, decltype (rs)>...> R { vs, std::get<I> (rs)... };
+};
+
+/** Compares an adapted R-Type, connecting a resistor and a capacitor, with the equivalent 3-port adaptor */
+template <typename Topology, template <typename, typename, typename> class ReferenceAdaptor>
+void checkAdaptedPort()
+{
+    wdft::ResistorT<double> r1 { 1000.0 };
+    wdft::CapacitorT<double> c1 { 1.0e-6 };
+    wdft::IncrementalRtypeAdaptor<double, 0, Topology, decltype (r1), decltype (c1)> rtype { r1, c1 };
+    wdft::IdealVoltageSourceT<double, decltype (rtype)> vs { rtype };
+
+    wdft::ResistorT<double> r2 { 1000.0 };
+    wdft::CapacitorT<double> c2 { 1.0e-6 };
+    ReferenceAdaptor<double, decltype (r2), decltype (c2)> adaptor { r2, c2 };
+    wdft::IdealVoltageSourceT<double, decltype (adaptor)> vsRef { adaptor };
+
+    for (int n = 0; n < 1000; ++n)
+    {
+        if (n == 500)
+        {
+            r1.setResistanceValue (47.0);
+            r2.setResistanceValue (47.0);
+        }
+
+        REQUIRE (rtype.wdf.R == Approx (adaptor.wdf.R));
+
+        const auto x = std::sin (0.05 * (double) n);
+        vs.setVoltage (x);
+        vs.incident (rtype.reflected());
+        rtype.incident (vs.reflected());
+
+        vsRef.setVoltage (x);
+        vsRef.incident (adaptor.reflected());
+        adaptor.incident (vsRef.reflected());
+
+        REQUIRE (wdft::current<double> (c1) == Approx (wdft::current<double> (c2)).margin (1.0e-12));
+    }
+}
+
+template <typename TonestackType>
+void checkTonestacks (Tonestack<double>& reference, TonestackType& tonestack, int numSamples)
+{
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const auto x = (n & 32) == 0 ? 1.0 : -1.0;
+        REQUIRE (tonestack.processSample (x) == Approx (reference.processSample (x)).margin (1.0e-9));
+    }
+}
+} // namespace
+
+TEST_CASE ("Incremental R-Type Test")
+{
+    SECTION ("Matches Hand-Derived Scattering Matrix")
+    {
+        Tonestack<double> reference;
+        Tonestack<double, wdft::IncrementalRootRtypeAdaptor> tonestack;
+        reference.prepare (fs);
+        tonestack.prepare (fs);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const auto param = 0.2 * (double) (i + 1);
+            reference.setParams (param, 1.0 - param, 0.5);
+            tonestack.setParams (param, 1.0 - param, 0.5);
+            checkTonestacks (reference, tonestack, 256);
+        }
+    }
+
+    SECTION ("Incremental Updates")
+    {
+        Tonestack<double> reference;
+        Tonestack<double, wdft::IncrementalRootRtypeAdaptor> tonestack;
+        reference.prepare (fs);
+        tonestack.prepare (fs);
+        tonestack.getRoot().setFullUpdateInterval (1000);
+        const auto numFullUpdatesStart = tonestack.getRoot().getNumFullUpdates();
+
+        // each pot change only changes one or two port impedances
+        for (int i = 0; i < 100; ++i)
+        {
+            const auto param = 0.5 + 0.49 * std::sin (0.1 * (double) i);
+            reference.setParams (param, 1.0 - param, 0.5 * param, false);
+            tonestack.setParams (param, 1.0 - param, 0.5 * param, false);
+            checkTonestacks (reference, tonestack, 16);
+        }
+
+        REQUIRE (tonestack.getRoot().getNumFullUpdates() == numFullUpdatesStart);
+    }
+
+    SECTION ("Periodic Full Updates")
+    {
+        Tonestack<double, wdft::IncrementalRootRtypeAdaptor> tonestack;
+        tonestack.prepare (fs);
+        tonestack.getRoot().setFullUpdateInterval (10);
+        const auto numFullUpdatesStart = tonestack.getRoot().getNumFullUpdates();
+
+        for (int i = 0; i < 20; ++i)
+            tonestack.getRoot().propagateImpedanceChange(); // no impedance changes
+        REQUIRE (tonestack.getRoot().getNumFullUpdates() == numFullUpdatesStart);
+
+        for (int i = 0; i < 50; ++i)
+            tonestack.setParams (0.01 * (double) i, 0.5, 0.5, false);
+        REQUIRE (tonestack.getRoot().getNumFullUpdates() > numFullUpdatesStart);
+    }
+
+    SECTION ("Adapted Port")
+    {
+        // the parallel junction has one node, so it uses the low-rank factors of S...
+        static_assert (wdft::rtype_detail::useLowRankScattering (ParallelTopology::numNodes, 3), "Parallel junction should use low-rank scattering!");
+        checkAdaptedPort<ParallelTopology, wdft::WDFParallelT>();
+
+        // ... but the series loop has two nodes, so it uses the dense S
+        static_assert (! wdft::rtype_detail::useLowRankScattering (SeriesTopology::numNodes, 3), "Series loop should use dense scattering!");
+        checkAdaptedPort<SeriesTopology, wdft::WDFSeriesT>();
+    }
+
+    SECTION ("Low-Rank Scattering")
+    {
+        using Junction = ParallelJunction<std::make_index_sequence<15>>;
+        static_assert (wdft::rtype_detail::useLowRankScattering (ParallelTopology::numNodes, Junction::numPorts), "Parallel junction should use low-rank scattering!");
+
+        Junction junction;
+        for (int n = 0; n < 100; ++n)
+        {
+            if (n == 50)
+                junction.rs[3].setResistanceValue (10.0);
+
+            const auto x = (n & 8) == 0 ? 1.0 : -1.0;
+            junction.vs.setVoltage (x);
+            junction.R.compute(); // the source voltage reaches the R-Type on the following call to compute()
+            junction.R.compute();
+
+            for (auto& r : junction.rs)
+                REQUIRE (wdft::voltage<double> (r) == Approx (junction.expectedVoltage (x)).margin (1.0e-12));
+        }
+    }
+
+    SECTION ("Extreme Impedance Changes")
+    {
+        using Junction = ParallelJunction<std::make_index_sequence<15>>;
+        Junction junction;
+        junction.R.setFullUpdateInterval (1000);
+
+        // a nearly-shorted port holds up almost all of the junction's admittance, so removing it
+        // would leave the rank-1 update with a denominator close to zero
+        const double resistances[] = { 1.0e-9, 1.0e6, 1.0e-6, 1.0e9, 1.0e-9, 10.0, 1.0e-3, 1.0e3 };
+        int numFullUpdatesStart = junction.R.getNumFullUpdates();
+        for (auto resistance : resistances)
+        {
+            junction.rs[3].setResistanceValue (resistance);
+            for (int n = 0; n < 8; ++n)
+            {
+                const auto x = (n & 2) == 0 ? 1.0 : -1.0;
+                junction.vs.setVoltage (x);
+                junction.R.compute();
+                junction.R.compute();
+
+                for (auto& r : junction.rs)
+                    REQUIRE (wdft::voltage<double> (r) == Approx (junction.expectedVoltage (x)).margin (1.0e-12));
+            }
+        }
+
+        REQUIRE (junction.R.getNumFullUpdates() > numFullUpdatesStart);
+    }
+}
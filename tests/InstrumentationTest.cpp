@@ -0,0 +1,81 @@
+#include <catch2/catch2.hpp>
+#include <chowdsp_wdf/chowdsp_wdf.h>
+
+/**
+ * The instrumentation counters are only compiled in when CHOWDSP_WDF_INSTRUMENTATION is enabled,
+ * which can be done for the whole test suite with -DCHOWDSP_WDF_TEST_WITH_INSTRUMENTATION=ON.
+ * The chowdsp_wdf_instrumentation_tests target always builds this test with the counters enabled.
+ */
+TEST_CASE ("Instrumentation Test")
+{
+    using namespace chowdsp;
+
+    wdft::ResistorT<float> r1 { 1000.0f };
+    wdft::CapacitorT<float> c1 { 1.0e-6f };
+    wdft::WDFSeriesT<float, decltype (r1), decltype (c1)> s1 { r1, c1 };
+    wdft::ResistorT<float> r2 { 1000.0f };
+    wdft::WDFParallelT<float, decltype (s1), decltype (r2)> p1 { s1, r2 };
+    wdft::PolarityInverterT<float, decltype (p1)> i1 { p1 };
+    wdft::IdealVoltageSourceT<float, decltype (i1)> vs { i1 };
+
+    constexpr int numSamples = 100;
+    const auto processCircuit = [&]
+    {
+        for (int n = 0; n < numSamples; ++n)
+        {
+            vs.setVoltage ((float) n);
+            vs.incident (i1.reflected());
+            i1.incident (vs.reflected());
+        }
+    };
+
+    SECTION ("Wave Counts")
+    {
+        wdft::resetInstrumentationCounters (vs);
+        processCircuit();
+
+#if CHOWDSP_WDF_INSTRUMENTATION
+        wdft::forEachElement (vs,
+                              [] (auto& element)
+                              {
+                                  const auto counters = wdft::getInstrumentationCounters (element);
+                                  REQUIRE (counters.incident == (uint64_t) numSamples);
+                                  REQUIRE (counters.reflected == (uint64_t) numSamples);
+                                  REQUIRE (counters.calcImpedance == 0);
+                              });
+#else
+        const auto total = wdft::getTotalInstrumentationCounters (vs);
+        REQUIRE (total.incident == 0);
+        REQUIRE (total.reflected == 0);
+#endif
+    }
+
+    SECTION ("Impedance Propagation Counts")
+    {
+        wdft::resetInstrumentationCounters (vs);
+        r1.setResistanceValue (2000.0f); // propagates r1 -> s1 -> p1 -> i1 -> vs
+
+        const auto total = wdft::getTotalInstrumentationCounters (vs);
+#if CHOWDSP_WDF_INSTRUMENTATION
+        REQUIRE (total.calcImpedance == 5);
+        REQUIRE (total.propagateImpedanceChange == 5);
+        REQUIRE (wdft::getInstrumentationCounters (r2).calcImpedance == 0);
+        REQUIRE (wdft::getInstrumentationCounters (vs).propagateImpedanceChange == 1);
+
+        // deferred propagation only recomputes each impedance once
+        wdft::resetInstrumentationCounters (vs);
+        {
+            wdft::ScopedDeferImpedancePropagation<decltype (s1)> deferImpedance { s1 };
+            r1.setResistanceValue (3000.0f);
+            c1.setCapacitanceValue (2.0e-6f);
+        }
+        REQUIRE (wdft::getInstrumentationCounters (r1).calcImpedance == 1);
+        REQUIRE (wdft::getInstrumentationCounters (c1).calcImpedance == 1);
+        REQUIRE (wdft::getInstrumentationCounters (s1).calcImpedance == 1);
+        REQUIRE (wdft::getInstrumentationCounters (vs).calcImpedance == 0);
+#else
+        REQUIRE (total.calcImpedance == 0);
+        REQUIRE (total.propagateImpedanceChange == 0);
+#endif
+    }
+}
@@ -0,0 +1,92 @@
+#include <cmath>
+#include <vector>
+
+#include <catch2/catch2.hpp>
+#include "BassmanToneStack.h"
+#include "BaxandallEQ.h"
+
+namespace
+{
+constexpr double fs = 48000.0;
+
+std::vector<double> makeTestSignal()
+{
+    std::vector<double> signal (4096, 0.0);
+    for (size_t n = 0; n < signal.size(); ++n)
+        signal[n] = std::sin (0.01 * (double) n) + 0.5 * std::sin (0.3 * (double) n + 1.0) + (n % 200 == 0 ? 1.0 : 0.0);
+    return signal;
+}
+
+/** Checks that the filter matches the circuit, over the test signal */
+template <typename T, typename CircuitType, typename FilterType>
+void checkFilter (CircuitType& circuit, FilterType& filter, double margin)
+{
+    REQUIRE (filter.update (circuit.getRoot(), [&circuit] (T x) { return circuit.processSample (x); }));
+    REQUIRE (filter.getFitError() < 1.0e-4);
+
+    for (auto x : makeTestSignal())
+    {
+        const auto expected = circuit.processSample ((T) x);
+        const auto actual = filter.processSample ((T) x);
+        REQUIRE (actual == Approx (expected).margin (margin));
+    }
+}
+} // namespace
+
+TEST_CASE ("Linear Circuit Filter Test")
+{
+    SECTION ("Bassman Tone Stack")
+    {
+        Tonestack<double> circuit;
+        circuit.prepare (fs);
+        circuit.setParams (0.25, 0.5, 0.75);
+
+        wdft::LinearCircuitFilter<double> filter;
+        filter.prepare (circuit.getRoot());
+        checkFilter<double> (circuit, filter, 1.0e-8);
+
+        // the Bassman tone stack has three capacitors
+        REQUIRE (filter.getNumSections() == 2);
+    }
+
+    SECTION ("Baxandall EQ")
+    {
+        BaxandallWDF circuit;
+        circuit.prepare (fs);
+        circuit.setParams (0.3f, 0.8f);
+
+        wdft::LinearCircuitFilter<float> filter;
+        filter.prepare (circuit.getRoot());
+        checkFilter<float> (circuit, filter, 1.0e-4);
+    }
+
+    SECTION ("Parameter Change")
+    {
+        Tonestack<double> circuit, twinCircuit;
+        for (auto* c : { &circuit, &twinCircuit })
+        {
+            c->prepare (fs);
+            c->setParams (0.5, 0.5, 0.5);
+        }
+
+        wdft::LinearCircuitFilter<double> filter;
+        filter.prepare (circuit.getRoot());
+        checkFilter<double> (circuit, filter, 1.0e-8);
+        for (auto x : makeTestSignal())
+            twinCircuit.processSample (x);
+
+        // updating the filter leaves the circuit state untouched
+        circuit.setParams (0.9, 0.1, 0.2);
+        twinCircuit.setParams (0.9, 0.1, 0.2);
+        REQUIRE (filter.update (circuit.getRoot(), [&circuit] (double x) { return circuit.processSample (x); }));
+        for (auto x : makeTestSignal())
+            REQUIRE (circuit.processSample (x) == Approx (twinCircuit.processSample (x)).margin (1.0e-12));
+
+        // the filter state is not equivalent to the circuit state, so compare against a fresh circuit
+        Tonestack<double> freshCircuit;
+        freshCircuit.prepare (fs);
+        freshCircuit.setParams (0.9, 0.1, 0.2);
+        filter.reset();
+        checkFilter<double> (freshCircuit, filter, 1.0e-8);
+    }
+}
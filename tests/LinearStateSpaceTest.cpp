@@ -0,0 +1,155 @@
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <catch2/catch2.hpp>
+#include "BassmanToneStack.h"
+#include "BaxandallEQ.h"
+
+namespace
+{
+constexpr double fs = 48000.0;
+constexpr int maxBlockSize = 256;
+
+template <typename T>
+std::vector<T> makeTestSignal()
+{
+    std::vector<T> signal (4096, (T) 0);
+    for (size_t n = 0; n < signal.size(); ++n)
+        signal[n] = (T) (std::sin (0.01 * (double) n) + 0.5 * std::sin (0.3 * (double) n + 1.0) + (n % 200 == 0 ? 1.0 : 0.0));
+    return signal;
+}
+
+/**
+ * Checks that the block processor matches the circuit over the test signal, processed
+ * in blocks of varying sizes (including blocks that are not a multiple of the sub-block
+ * size, and blocks that are larger than the maximum block size).
+ */
+template <typename T, typename CircuitType>
+void checkProcessor (CircuitType& circuit, wdft::StateSpaceBlockProcessor<T>& processor, double margin)
+{
+    processor.update (circuit.getRoot(), [&circuit] (T x) { return circuit.processSample (x); });
+
+    auto expected = makeTestSignal<T>();
+    for (auto& x : expected)
+        x = circuit.processSample (x);
+
+    auto actual = makeTestSignal<T>();
+    const int blockSizes[] = { 1, 37, 16, maxBlockSize, 3 * maxBlockSize + 5, 100 };
+    size_t start = 0;
+    for (int i = 0; start < actual.size(); ++i)
+    {
+        const auto numSamples = std::min ((size_t) blockSizes[i % 6], actual.size() - start);
+        processor.processBlock (actual.data() + start, (int) numSamples);
+        start += numSamples;
+    }
+
+    for (size_t n = 0; n < actual.size(); ++n)
+        REQUIRE (actual[n] == Approx (expected[n]).margin (margin));
+}
+} // namespace
+
+TEST_CASE ("Linear State Space Test")
+{
+    SECTION ("Reduced Model")
+    {
+        Tonestack<double> circuit;
+        circuit.prepare (fs);
+        circuit.setParams (0.25, 0.5, 0.75);
+
+        wdft::LinearStateSpace<double> model;
+        model.prepare (circuit.getRoot());
+
+        // the circuit state is left untouched
+        for (int n = 0; n < 100; ++n)
+            circuit.processSample (1.0);
+        wdft::CircuitStateBuffer stateBefore { circuit.getRoot() };
+        model.update (circuit.getRoot(), [&circuit] (double x) { return circuit.processSample (x); });
+        wdft::CircuitStateBuffer stateAfter { circuit.getRoot() };
+        REQUIRE (std::memcmp (stateBefore.data(), stateAfter.data(), stateBefore.size()) == 0);
+
+        // the model (from a zero state) matches the circuit (from a zero state)
+        Tonestack<double> freshCircuit;
+        freshCircuit.prepare (fs);
+        freshCircuit.setParams (0.25, 0.5, 0.75);
+
+        const auto M = (size_t) model.getNumStates();
+        REQUIRE (M >= 3); // at least one state per capacitor
+        std::vector<double> x (M, 0.0), nextX (M, 0.0);
+        for (auto u : makeTestSignal<double>())
+        {
+            auto y = model.getD() * u;
+            for (size_t i = 0; i < M; ++i)
+            {
+                y += model.getC()[i] * x[i];
+                nextX[i] = model.getB()[i] * u;
+                for (size_t j = 0; j < M; ++j)
+                    nextX[i] += model.getA()[i * M + j] * x[j];
+            }
+            std::swap (x, nextX);
+
+            REQUIRE (y == Approx (freshCircuit.processSample (u)).margin (1.0e-10));
+        }
+    }
+
+    SECTION ("Bassman Tone Stack")
+    {
+        Tonestack<double> circuit;
+        circuit.prepare (fs);
+        circuit.setParams (0.25, 0.5, 0.75);
+
+        wdft::StateSpaceBlockProcessor<double> processor;
+        processor.prepare (circuit.getRoot(), maxBlockSize);
+        checkProcessor (circuit, processor, 1.0e-8);
+    }
+
+    SECTION ("Parameter Change")
+    {
+        Tonestack<double> circuit;
+        circuit.prepare (fs);
+        circuit.setParams (0.25, 0.5, 0.75);
+
+        wdft::StateSpaceBlockProcessor<double> processor;
+        processor.prepare (circuit.getRoot(), maxBlockSize);
+        processor.update (circuit.getRoot(), [&circuit] (double x) { return circuit.processSample (x); });
+
+        // the parameters change mid-stream, in the middle of a sub-block
+        const auto signal = makeTestSignal<double>();
+        constexpr size_t blockSize = 100;
+        constexpr size_t changeIndex = 1000;
+        auto actual = signal;
+        for (size_t n = 0; n < signal.size(); n += blockSize)
+        {
+            const auto blockEnd = std::min (n + blockSize, signal.size());
+            if (n == changeIndex)
+            {
+                circuit.setParams (0.9, 0.1, 0.3);
+                processor.update (circuit.getRoot(), [&circuit] (double x) { return circuit.processSample (x); });
+            }
+
+            std::vector<double> expected (signal.begin() + (long) n, signal.begin() + (long) blockEnd);
+            for (auto& x : expected)
+                x = circuit.processSample (x);
+            processor.processBlock (actual.data() + n, (int) (blockEnd - n));
+
+            // the processor state carries over, so the processor keeps matching the circuit
+            for (size_t i = 0; i < expected.size(); ++i)
+                REQUIRE (actual[n + i] == Approx (expected[i]).margin (1.0e-8));
+        }
+    }
+
+    SECTION ("Baxandall EQ")
+    {
+        // (a sub-block size of 0 is clamped to 1)
+        for (auto subBlockSize : { 0, 1, 4, 7, 16, 32 })
+        {
+            BaxandallWDF circuit;
+            circuit.prepare (fs);
+            circuit.setParams (0.3f, 0.8f);
+
+            wdft::StateSpaceBlockProcessor<float> processor;
+            processor.prepare (circuit.getRoot(), maxBlockSize, subBlockSize);
+            checkProcessor (circuit, processor, 1.0e-4);
+        }
+    }
+}
@@ -0,0 +1,207 @@
+#include <catch2/catch2.hpp>
+#include <cmath>
+#include <vector>
+
+#include "BassmanToneStack.h"
+
+namespace
+{
+constexpr double fs = 48000.0;
+constexpr int numSamples = 100; // not a multiple of the transpose sub-block size
+
+/** Stand-in for a 4-lane SIMD type, so the channel mapping can be tested without XSIMD */
+struct FourLanes
+{
+    using value_type = float;
+    float lanes[4];
+};
+
+template <typename FloatType>
+std::vector<Tonestack<FloatType>> makeCircuits (int numCircuits)
+{
+    std::vector<Tonestack<FloatType>> circuits ((size_t) numCircuits);
+    for (auto& circuit : circuits)
+    {
+        circuit.prepare (fs);
+        circuit.setParams ((FloatType) 0.25, (FloatType) 0.75, (FloatType) 0.5);
+    }
+    return circuits;
+}
+
+std::vector<std::vector<float>> makeInput (int numChannels)
+{
+    std::vector<std::vector<float>> buffer ((size_t) numChannels, std::vector<float> ((size_t) numSamples));
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int n = 0; n < numSamples; ++n)
+            buffer[(size_t) ch][(size_t) n] = std::sin (0.01f * (float) ((ch + 1) * n)) + 0.1f * (float) ch;
+    return buffer;
+}
+
+/** Processes each channel on its own, for reference */
+std::vector<std::vector<float>> processReference (int numChannels)
+{
+    auto buffer = makeInput (numChannels);
+    auto circuits = makeCircuits<float> (numChannels);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (auto& x : buffer[(size_t) ch])
+            x = circuits[(size_t) ch].processSample (x);
+    return buffer;
+}
+
+/** Processes each lane of a FourLanes with its own scalar circuit, and checks that the padded lanes are zero */
+struct FourLaneProcessor
+{
+    FourLaneProcessor (int numChannelsIn, bool padded)
+        : numChannels (numChannelsIn),
+          circuits (makeCircuits<float> (4 * chowdsp::wdft::getNumVectorGroups<FourLanes> (numChannelsIn, padded)))
+    {
+    }
+
+    FourLanes operator() (int group, FourLanes x)
+    {
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            if (group * 4 + lane >= numChannels)
+                REQUIRE (x.lanes[lane] == 0.0f);
+            x.lanes[lane] = circuits[(size_t) (group * 4 + lane)].processSample (x.lanes[lane]);
+        }
+        return x;
+    }
+
+    const int numChannels;
+    std::vector<Tonestack<float>> circuits;
+};
+
+struct ScalarProcessor
+{
+    explicit ScalarProcessor (int numChannels) : circuits (makeCircuits<float> (numChannels)) {}
+
+    float operator() (int channel, float x) { return circuits[(size_t) channel].processSample (x); }
+
+    std::vector<Tonestack<float>> circuits;
+};
+
+std::vector<float*> getChannelPointers (std::vector<std::vector<float>>& buffer)
+{
+    std::vector<float*> channels;
+    for (auto& channel : buffer)
+        channels.push_back (channel.data());
+    return channels;
+}
+
+std::vector<float> interleave (const std::vector<std::vector<float>>& buffer)
+{
+    const auto numChannels = buffer.size();
+    std::vector<float> interleaved (numChannels * (size_t) numSamples);
+    for (size_t ch = 0; ch < numChannels; ++ch)
+        for (size_t n = 0; n < (size_t) numSamples; ++n)
+            interleaved[n * numChannels + ch] = buffer[ch][n];
+    return interleaved;
+}
+
+void checkPlanar (const std::vector<std::vector<float>>& buffer, const std::vector<std::vector<float>>& reference)
+{
+    for (size_t ch = 0; ch < reference.size(); ++ch)
+        for (size_t n = 0; n < (size_t) numSamples; ++n)
+            REQUIRE (buffer[ch][n] == reference[ch][n]);
+}
+
+void checkInterleaved (const std::vector<float>& buffer, const std::vector<std::vector<float>>& reference)
+{
+    REQUIRE (buffer == interleave (reference));
+}
+} // namespace
+
+TEST_CASE ("Multichannel Test")
+{
+    using namespace chowdsp;
+
+    SECTION ("Vector Groups")
+    {
+        STATIC_REQUIRE (wdft::getNumChannelsPerVector<float>() == 1);
+        STATIC_REQUIRE (wdft::getNumChannelsPerVector<FourLanes>() == 4);
+        STATIC_REQUIRE (wdft::getNumVectorGroups<FourLanes> (6) == 2);
+        STATIC_REQUIRE (wdft::getNumVectorGroups<FourLanes> (6, false) == 1);
+        STATIC_REQUIRE (wdft::getNumVectorGroups<FourLanes> (8, false) == 2);
+    }
+
+    SECTION ("Scalar")
+    {
+        const auto reference = processReference (3);
+
+        auto planar = makeInput (3);
+        auto channels = getChannelPointers (planar);
+        wdft::processPlanar<float> (channels.data(), 3, numSamples, ScalarProcessor { 3 });
+        checkPlanar (planar, reference);
+
+        auto interleaved = interleave (makeInput (3));
+        wdft::processInterleaved<float> (interleaved.data(), 3, numSamples, ScalarProcessor { 3 });
+        checkInterleaved (interleaved, reference);
+    }
+
+    SECTION ("Planar")
+    {
+        for (int numChannels = 1; numChannels <= 18; ++numChannels) // up to 5 groups, so more than one batch
+        {
+            const auto reference = processReference (numChannels);
+
+            auto withScalarLeftovers = makeInput (numChannels);
+            auto channels = getChannelPointers (withScalarLeftovers);
+            wdft::processPlanar<FourLanes> (channels.data(), numChannels, numSamples, FourLaneProcessor { numChannels, false }, ScalarProcessor { numChannels });
+            checkPlanar (withScalarLeftovers, reference);
+
+            auto padded = makeInput (numChannels);
+            channels = getChannelPointers (padded);
+            wdft::processPlanar<FourLanes> (channels.data(), numChannels, numSamples, FourLaneProcessor { numChannels, true });
+            checkPlanar (padded, reference);
+        }
+    }
+
+    SECTION ("Interleaved")
+    {
+        for (int numChannels = 1; numChannels <= 18; ++numChannels) // up to 5 groups, so more than one batch
+        {
+            const auto reference = processReference (numChannels);
+
+            auto withScalarLeftovers = interleave (makeInput (numChannels));
+            wdft::processInterleaved<FourLanes> (withScalarLeftovers.data(), numChannels, numSamples, FourLaneProcessor { numChannels, false }, ScalarProcessor { numChannels });
+            checkInterleaved (withScalarLeftovers, reference);
+
+            auto padded = interleave (makeInput (numChannels));
+            wdft::processInterleaved<FourLanes> (padded.data(), numChannels, numSamples, FourLaneProcessor { numChannels, true });
+            checkInterleaved (padded, reference);
+        }
+    }
+
+#if CHOWDSP_WDF_TEST_WITH_XSIMD
+    SECTION ("SIMD Planar")
+    {
+        using v_type = xsimd::batch<float>;
+        constexpr int numChannels = 2 * (int) v_type::size + 1;
+        const auto reference = processReference (numChannels);
+
+        auto vectorCircuits = makeCircuits<v_type> (wdft::getNumVectorGroups<v_type> (numChannels));
+        auto buffer = makeInput (numChannels);
+        auto channels = getChannelPointers (buffer);
+        wdft::processPlanar<v_type> (channels.data(), numChannels, numSamples, [&vectorCircuits] (int group, v_type x) { return vectorCircuits[(size_t) group].processSample (x); });
+
+        for (size_t ch = 0; ch < (size_t) numChannels; ++ch)
+            for (size_t n = 0; n < (size_t) numSamples; ++n)
+                REQUIRE (buffer[ch][n] == Approx (reference[ch][n]).margin (1.0e-6));
+    }
+
+    SECTION ("SIMD Interleaved")
+    {
+        using v_type = xsimd::batch<float>;
+        constexpr int numChannels = 2 * (int) v_type::size + 1;
+        const auto reference = interleave (processReference (numChannels));
+
+        auto vectorCircuits = makeCircuits<v_type> (wdft::getNumVectorGroups<v_type> (numChannels));
+        auto buffer = interleave (makeInput (numChannels));
+        wdft::processInterleaved<v_type> (buffer.data(), numChannels, numSamples, [&vectorCircuits] (int group, v_type x) { return vectorCircuits[(size_t) group].processSample (x); });
+
+        for (size_t i = 0; i < reference.size(); ++i)
+            REQUIRE (buffer[i] == Approx (reference[i]).margin (1.0e-6));
+    }
+#endif
+}
@@ -0,0 +1,81 @@
+#include <cmath>
+#include <vector>
+
+#include <catch2/catch2.hpp>
+#include "DiodeClipper.h"
+
+namespace
+{
+constexpr int maxBlockSize = 128;
+
+/** Checks that the recorded probes match calling voltage()/current() directly */
+template <typename CircuitType>
+void checkProbes (int numBlocks, int blockSize)
+{
+    CircuitType circuit;
+    CircuitType reference;
+
+    auto probes = wdft::makeProbeRecorder (wdft::voltageProbe<float> (circuit.C1),
+                                           wdft::currentProbe<float> (circuit.C1),
+                                           wdft::currentProbe<float> (circuit.Vs));
+    STATIC_REQUIRE (decltype (probes)::numProbes == 3);
+    probes.prepare (maxBlockSize);
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        std::vector<float> expectedVoltage, expectedCurrent, expectedSourceCurrent;
+
+        probes.startBlock();
+        for (int n = 0; n < blockSize; ++n)
+        {
+            const auto x = 2.0f * std::sin (0.05f * (float) (block * blockSize + n));
+            circuit.processSample (x);
+            probes.record();
+
+            reference.processSample (x);
+            expectedVoltage.push_back (wdft::voltage<float> (reference.C1));
+            expectedCurrent.push_back (wdft::current<float> (reference.C1));
+            expectedSourceCurrent.push_back (wdft::current<float> (reference.Vs));
+        }
+
+        REQUIRE (probes.getNumSamples() == blockSize);
+        for (int n = 0; n < blockSize; ++n)
+        {
+            REQUIRE (probes.getProbeData (0)[n] == expectedVoltage[(size_t) n]);
+            REQUIRE (probes.getProbeData (1)[n] == expectedCurrent[(size_t) n]);
+            REQUIRE (probes.getProbeData (2)[n] == expectedSourceCurrent[(size_t) n]);
+        }
+    }
+}
+} // namespace
+
+TEST_CASE ("Probe Recorder Test")
+{
+    SECTION ("Static Circuit")
+    {
+        checkProbes<DiodeClipper<float>> (4, maxBlockSize);
+        checkProbes<DiodeClipper<float>> (5, 37);
+    }
+
+    SECTION ("Dynamic Circuit")
+    {
+        checkProbes<DiodeClipperPoly<float>> (4, maxBlockSize);
+        checkProbes<DiodeClipperPoly<float>> (5, 37);
+    }
+
+    SECTION ("Matches Element Probes")
+    {
+        DiodeClipperPoly<float> circuit;
+        auto probes = wdft::makeProbeRecorder (wdft::voltageProbe<float> (circuit.C1), wdft::currentProbe<float> (circuit.C1));
+        probes.prepare (maxBlockSize);
+
+        probes.startBlock();
+        for (int n = 0; n < 10; ++n)
+        {
+            circuit.processSample ((float) n * 0.1f);
+            probes.record();
+            REQUIRE (probes.getProbeData (0)[n] == Approx (circuit.C1.voltage()));
+            REQUIRE (probes.getProbeData (1)[n] == Approx (circuit.C1.current()));
+        }
+    }
+}
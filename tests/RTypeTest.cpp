@@ -27,9 +27,10 @@ void bassmanFreqTest (float lowPot, float highPot, float sineFreq, float expGain
     REQUIRE (actualGainDB == Approx (expGainDB).margin (maxErr));
 }
 
+template <typename TonestackType = TonestackPoly<double>>
 void bassmanPolyFreqTest (float lowPot, float highPot, float sineFreq, float expGainDB, float maxErr)
 {
-    TonestackPoly<double> tonestack;
+    TonestackType tonestack;
     tonestack.prepare (fs);
     tonestack.setParams ((double) highPot, (double) lowPot, 1.0);
 
@@ -47,6 +48,25 @@ void bassmanPolyFreqTest (float lowPot, float highPot, float sineFreq, float exp
     REQUIRE (actualGainDB == Approx (expGainDB).margin (maxErr));
 }
 
+/** Scattering matrix for two ports connected in parallel, adapted at upPortIndex */
+template <typename RtypeType>
+double parallelJunctionImpedance (RtypeType& R, int upPortIndex)
+{
+    double G[3];
+    for (int i = 0, downPort = 0; i < 3; ++i)
+        G[i] = i == upPortIndex ? 0.0 : 1.0 / R.getPortImpedance ((size_t) downPort++);
+    G[upPortIndex] = G[0] + G[1] + G[2];
+    const auto Gsum = 2.0 * G[upPortIndex];
+
+    double S[3][3];
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            S[i][j] = 2.0 * G[j] / Gsum - (i == j ? 1.0 : 0.0);
+    R.setSMatrixData (S);
+
+    return 1.0 / G[upPortIndex];
+}
+
 void baxandallFreqTest (float bassParam, float trebleParam, float sineFreq, float expGainDB, float maxErr)
 {
     BaxandallWDF baxandall;
@@ -128,4 +148,130 @@ TEST_CASE ("RType Test")
     {
         baxandallPolyFreqTest (0.1f, 0.015f, 20000.0f, -8.0f, 0.5f);
     }
+
+    SECTION ("Adaptable R-Type Port Order Test")
+    {
+        // each down port must receive the wave from its own row of S, which is offset past the up port
+        for (int upPortIndex = 0; upPortIndex < 3; ++upPortIndex)
+        {
+            wdf::Resistor<double> r1 { 1000.0 };
+            wdf::Capacitor<double> c1 { 1.0e-6 };
+            wdf::WDFParallel<double> P1 { &r1, &c1 };
+            wdf::IdealVoltageSource<double> vs1 { &P1 };
+
+            wdf::Resistor<double> r2 { 1000.0 };
+            wdf::Capacitor<double> c2 { 1.0e-6 };
+            wdf::RtypeAdaptor<double> R2 { { &r2, &c2 }, upPortIndex };
+            R2.impedanceCalculator = [upPortIndex] (auto& R) { return parallelJunctionImpedance (R, upPortIndex); };
+            wdf::IdealVoltageSource<double> vs2 { &R2 };
+
+            // the wdf impedance propagation stops at the R-Type adaptor ports
+            c2.propagateImpedanceChange();
+            REQUIRE (R2.wdf.R == Approx (P1.wdf.R));
+
+            for (int n = 0; n < 500; ++n)
+            {
+                const auto x = std::sin (0.05 * (double) n);
+                vs1.setVoltage (x);
+                vs1.incident (P1.reflected());
+                P1.incident (vs1.reflected());
+
+                vs2.setVoltage (x);
+                vs2.incident (R2.reflected());
+                R2.incident (vs2.reflected());
+
+                REQUIRE (r2.current() == Approx (r1.current()).margin (1.0e-12));
+                REQUIRE (c2.current() == Approx (c1.current()).margin (1.0e-12));
+            }
+        }
+    }
+
+    SECTION ("Fixed-Size Bassman Poly Test")
+    {
+        using FixedSizeTonestack = TonestackPoly<double, wdf::FixedSizeRootRtypeAdaptor<double, 6>>;
+        bassmanPolyFreqTest<FixedSizeTonestack> (0.5f, 0.001f, 60.0f, -9.0f, 0.5f);
+        bassmanPolyFreqTest<FixedSizeTonestack> (0.999f, 0.999f, 15000.0f, 5.0f, 0.5f);
+
+        TonestackPoly<double> reference;
+        FixedSizeTonestack tonestack;
+        reference.prepare (fs);
+        tonestack.prepare (fs);
+        reference.setParams (0.3, 0.6, 0.9);
+        tonestack.setParams (0.3, 0.6, 0.9);
+        for (int n = 0; n < 1000; ++n)
+        {
+            const auto x = (n & 32) == 0 ? 1.0 : -1.0;
+            REQUIRE (tonestack.processSample (x) == Approx (reference.processSample (x)).margin (1.0e-12));
+        }
+    }
+
+    SECTION ("Fixed-Size Adaptable R-Type Test")
+    {
+        for (int upPortIndex = 0; upPortIndex < 3; ++upPortIndex)
+        {
+            wdf::Resistor<double> r1 { 1000.0 };
+            wdf::Capacitor<double> c1 { 1.0e-6 };
+            wdf::RtypeAdaptor<double> R1 { { &r1, &c1 }, upPortIndex };
+            R1.impedanceCalculator = [upPortIndex] (auto& R) { return parallelJunctionImpedance (R, upPortIndex); };
+            wdf::IdealVoltageSource<double> vs1 { &R1 };
+
+            // a callable with captures is only referenced, so it needs to outlive the adaptor
+            const auto calcImpedance = [upPortIndex] (auto& R) { return parallelJunctionImpedance (R, upPortIndex); };
+            wdf::Resistor<double> r2 { 1000.0 };
+            wdf::Capacitor<double> c2 { 1.0e-6 };
+            wdf::FixedSizeRtypeAdaptor<double, 3> R2 { { &r2, &c2 }, upPortIndex };
+            R2.impedanceCalculator = calcImpedance;
+            wdf::IdealVoltageSource<double> vs2 { &R2 };
+
+            // the wdf impedance propagation stops at the R-Type adaptor ports
+            c1.propagateImpedanceChange();
+            c2.propagateImpedanceChange();
+            REQUIRE (R1.wdf.R == Approx (1.0 / (1.0 / r1.wdf.R + 1.0 / c1.wdf.R)));
+
+            for (int n = 0; n < 500; ++n)
+            {
+                if (n == 250)
+                {
+                    r1.setResistanceValue (47.0);
+                    r2.setResistanceValue (47.0);
+                    r1.propagateImpedanceChange();
+                    r2.propagateImpedanceChange();
+                }
+
+                REQUIRE (R2.wdf.R == Approx (R1.wdf.R));
+
+                const auto x = std::sin (0.05 * (double) n);
+                vs1.setVoltage (x);
+                vs1.incident (R1.reflected());
+                R1.incident (vs1.reflected());
+
+                vs2.setVoltage (x);
+                vs2.incident (R2.reflected());
+                R2.incident (vs2.reflected());
+
+                REQUIRE (c2.current() == Approx (c1.current()).margin (1.0e-12));
+                REQUIRE (c2.voltage() == Approx (r2.voltage()).margin (1.0e-12));
+            }
+        }
+    }
+
+    SECTION ("Fixed-Size R-Type Port Checks")
+    {
+        wdf::Resistor<double> r1 { 1000.0 };
+        wdf::Resistor<double> r2 { 1000.0 };
+        wdf::Capacitor<double> c1 { 1.0e-6 };
+
+        using RootRtype = wdf::FixedSizeRootRtypeAdaptor<double, 3>;
+        REQUIRE_THROWS_AS (RootRtype ({ &r1, &c1 }), std::invalid_argument);
+        REQUIRE_THROWS_AS (RootRtype ({ &r1, &r2, &c1, &r1 }), std::invalid_argument);
+        REQUIRE_THROWS_AS (RootRtype ({ &r1, nullptr, &c1 }), std::invalid_argument);
+        REQUIRE_NOTHROW (RootRtype ({ &r1, &r2, &c1 }));
+
+        using Rtype = wdf::FixedSizeRtypeAdaptor<double, 3>;
+        REQUIRE_THROWS_AS (Rtype ({ &r1 }, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS (Rtype ({ &r1, &r2, &c1 }, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS (Rtype ({ &r1, &c1 }, -1), std::invalid_argument);
+        REQUIRE_THROWS_AS (Rtype ({ &r1, &c1 }, 3), std::invalid_argument);
+        REQUIRE_NOTHROW (Rtype ({ &r1, &c1 }, 2));
+    }
 }
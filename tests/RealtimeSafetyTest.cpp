@@ -0,0 +1,214 @@
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#include <catch2/catch2.hpp>
+#include "BassmanToneStack.h"
+#include "BassmanToneStackPoly.h"
+#include "BaxandallEQ.h"
+#include "BaxandallEQPoly.h"
+#include "DiodeClipper.h"
+
+#define CHOWDSP_WDF_REALTIME_SAFETY_CHECKER_IMPLEMENTATION 1
+#include <chowdsp_wdf/util/realtime_safety.h>
+
+namespace
+{
+constexpr double fs = 48000.0;
+constexpr int numSamples = 2048;
+constexpr int paramInterval = 16;
+
+/** Sweeps the parameter between 0 and 1 (exclusive) */
+float paramSweep (int n)
+{
+    return 0.5f + 0.45f * std::sin (2.0f * (float) M_PI * (float) n / (float) numSamples);
+}
+
+/**
+ * Processes the circuit, while updating the parameters, and saving/loading the circuit
+ * state, inside a ScopedAudioThread region, then checks that none of this was flagged.
+ */
+template <typename CircuitType, typename ParamSetter>
+void checkRealtimeSafety (CircuitType& circuit, ParamSetter&& setParams)
+{
+    wdft::CircuitStateBuffer state { circuit.getRoot() };
+
+    wdft::resetRealtimeSafetyViolations();
+    double y = 0.0;
+    {
+        wdft::ScopedAudioThread audioThread;
+        for (int n = 0; n < numSamples; ++n)
+        {
+            if (n % paramInterval == 0)
+                setParams (circuit, paramSweep (n));
+
+            y += (double) circuit.processSample ((n & 32) == 0 ? 0.5f : -0.5f);
+        }
+
+        wdft::saveState (circuit.getRoot(), state);
+        wdft::loadState (circuit.getRoot(), state);
+    }
+
+    const auto violations = wdft::getRealtimeSafetyViolations();
+    REQUIRE (std::isfinite (y));
+    REQUIRE (violations.allocations == 0);
+    REQUIRE (violations.deallocations == 0);
+    REQUIRE (violations.mutexLocks == 0);
+}
+} // namespace
+
+TEST_CASE ("Real-Time Safety Test")
+{
+    SECTION ("Checker Test")
+    {
+        static int* volatile sink = nullptr;
+        std::mutex mutex;
+
+        wdft::resetRealtimeSafetyViolations();
+        {
+            // outside of the audio thread, nothing should be flagged
+            sink = new int[16];
+            delete[] sink;
+            std::lock_guard<std::mutex> lock { mutex };
+        }
+        REQUIRE (wdft::getRealtimeSafetyViolations().total() == 0);
+
+        {
+            wdft::ScopedAudioThread audioThread;
+            REQUIRE (wdft::ScopedAudioThread::isActive());
+
+            sink = new int[16];
+            delete[] sink;
+
+#if defined(__linux__)
+            std::lock_guard<std::mutex> lock { mutex };
+#endif
+        }
+        REQUIRE (! wdft::ScopedAudioThread::isActive());
+
+        const auto violations = wdft::getRealtimeSafetyViolations();
+        REQUIRE (violations.allocations == 1);
+        REQUIRE (violations.deallocations == 1);
+#if defined(__linux__)
+        REQUIRE (violations.mutexLocks == 1);
+#endif
+
+        wdft::resetRealtimeSafetyViolations();
+        REQUIRE (wdft::getRealtimeSafetyViolations().total() == 0);
+    }
+
+#if defined(__cpp_aligned_new)
+    SECTION ("Aligned Allocation Test")
+    {
+        struct alignas (64) OverAligned
+        {
+            float data[16];
+        };
+        static OverAligned* volatile sink = nullptr;
+        static OverAligned* volatile arraySink = nullptr;
+        static OverAligned* volatile nothrowSink = nullptr;
+
+        wdft::resetRealtimeSafetyViolations();
+        {
+            wdft::ScopedAudioThread audioThread;
+            sink = new OverAligned;
+            arraySink = new OverAligned[4];
+            nothrowSink = new (std::nothrow) OverAligned;
+        }
+
+        REQUIRE ((uintptr_t) sink % alignof (OverAligned) == 0);
+        REQUIRE ((uintptr_t) arraySink % alignof (OverAligned) == 0);
+        REQUIRE ((uintptr_t) nothrowSink % alignof (OverAligned) == 0);
+
+        {
+            wdft::ScopedAudioThread audioThread;
+            delete sink;
+            delete[] arraySink;
+            delete nothrowSink;
+        }
+
+        const auto violations = wdft::getRealtimeSafetyViolations();
+        REQUIRE (violations.allocations == 3);
+        REQUIRE (violations.deallocations == 3);
+    }
+#endif
+
+    SECTION ("Violation Handler Test")
+    {
+        static int numHandlerCalls = 0;
+        numHandlerCalls = 0;
+        wdft::setRealtimeSafetyViolationHandler ([] (wdft::RealtimeSafetyViolation violation)
+                                                 {
+                                                     if (violation == wdft::RealtimeSafetyViolation::Allocation)
+                                                         numHandlerCalls++;
+                                                 });
+
+        {
+            wdft::ScopedAudioThread audioThread;
+            std::vector<float> vec (8);
+        }
+
+        wdft::setRealtimeSafetyViolationHandler (nullptr);
+        REQUIRE (numHandlerCalls == 1);
+    }
+
+    SECTION ("Static Diode Clipper")
+    {
+        DiodeClipper<float> clipper;
+        checkRealtimeSafety (clipper, [] (auto& c, float param) { c.setParams (param); });
+    }
+
+    SECTION ("Dynamic Diode Clipper")
+    {
+        DiodeClipperPoly<double> clipper;
+        checkRealtimeSafety (clipper, [] (auto& c, float param) { c.setParams (param); });
+    }
+
+    SECTION ("Static Baxandall EQ")
+    {
+        BaxandallWDF baxandall;
+        baxandall.prepare (fs);
+        checkRealtimeSafety (baxandall, [] (auto& c, float param) { c.setParams (param, 1.0f - param); });
+        checkRealtimeSafety (baxandall, [] (auto& c, float param) { c.setParams (param, 1.0f - param, false); });
+    }
+
+    SECTION ("Dynamic Baxandall EQ")
+    {
+        BaxandallWDFPoly baxandall;
+        baxandall.prepare (fs);
+        checkRealtimeSafety (baxandall, [] (auto& c, float param) { c.setParams (param, 1.0f - param); });
+        checkRealtimeSafety (baxandall, [] (auto& c, float param) { c.setParams (param, 1.0f - param, false); });
+    }
+
+    SECTION ("Static Bassman Tonestack")
+    {
+        Tonestack<float> tonestack;
+        tonestack.prepare (fs);
+        checkRealtimeSafety (tonestack, [] (auto& c, float param) { c.setParams (param, 1.0f - param, 0.5f * param); });
+        checkRealtimeSafety (tonestack, [] (auto& c, float param) { c.setParams (param, 1.0f - param, 0.5f * param, false); });
+    }
+
+    SECTION ("Dynamic Bassman Tonestack")
+    {
+        TonestackPoly<float> tonestack;
+        tonestack.prepare (fs);
+        checkRealtimeSafety (tonestack, [] (auto& c, float param) { c.setParams (param, 1.0f - param, 0.5f * param); });
+        checkRealtimeSafety (tonestack, [] (auto& c, float param) { c.setParams (param, 1.0f - param, 0.5f * param, false); });
+    }
+
+    SECTION ("Incremental Bassman Tonestack")
+    {
+        Tonestack<float, wdft::IncrementalRootRtypeAdaptor> tonestack;
+        tonestack.prepare (fs);
+        checkRealtimeSafety (tonestack, [] (auto& c, float param) { c.setParams (param, 1.0f - param, 0.5f * param); });
+        checkRealtimeSafety (tonestack, [] (auto& c, float param) { c.setParams (param, 1.0f - param, 0.5f * param, false); });
+    }
+
+    SECTION ("Fixed-Size Bassman Tonestack")
+    {
+        TonestackPoly<float, wdf::FixedSizeRootRtypeAdaptor<float, 6>> tonestack;
+        tonestack.prepare (fs);
+        checkRealtimeSafety (tonestack, [] (auto& c, float param) { c.setParams (param, 1.0f - param, 0.5f * param); });
+        checkRealtimeSafety (tonestack, [] (auto& c, float param) { c.setParams (param, 1.0f - param, 0.5f * param, false); });
+    }
+}
@@ -1,3 +1,5 @@
+#include <ratio>
+
 #include <catch2/catch2.hpp>
 #include <chowdsp_wdf/chowdsp_wdf.h>
 
@@ -38,6 +40,33 @@ TEST_CASE ("Static Basic Circuits Test")
         REQUIRE (iOut == 0.5f);
     }
 
+    SECTION ("Fixed Resistors")
+    {
+        FixedResistorT<float, std::ratio<4700>> r1;
+        FixedResistorT<float, std::ratio<10000>> r2;
+        FixedResistorT<float, std::ratio<10000>> r3;
+        auto p1 = makeParallel<float> (r2, r3);
+        auto s1 = makeSeries<float> (r1, p1);
+        auto i1 = makeInverter<float> (s1);
+        IdealVoltageSourceT<float, decltype (i1)> vs { i1 };
+
+        static_assert (decltype (p1)::getFixedImpedance() == 5000.0, "Parallel impedance should be known at compile-time");
+        static_assert (decltype (s1)::getFixedImpedance() == 9700.0, "Series impedance should be known at compile-time");
+        REQUIRE (s1.wdf.R == 9700.0f);
+
+        vs.setVoltage (9.7f);
+        vs.incident (i1.reflected());
+        i1.incident (vs.reflected());
+        REQUIRE (voltage<float> (r3) == Approx (5.0f));
+        REQUIRE (voltage<float> (r1) == Approx (4.7f));
+
+        // adaptors with a port that can change are not fixed
+        CapacitorT<float> c1 { 1.0e-6f };
+        auto s2 = makeSeries<float> (r1, c1);
+        static_assert (! fixed_detail::HasFixedImpedance<decltype (s2)>::value, "Series impedance should not be fixed");
+        REQUIRE (s2.wdf.R == Approx (4700.0f + 1.0f / (2.0f * 1.0e-6f * 48000.0f)));
+    }
+
     SECTION ("Shockley Diode")
     {
         constexpr auto saturationCurrent = 1.0e-7;
@@ -338,3 +367,80 @@ TEST_CASE ("Static Impedance Change Test")
         });
     }
 }
+
+namespace
+{
+/**
+ * A string of elements, connected with a single N-port adaptor, or a chain of 3-port adaptors.
+ * A chain of series adaptors flips the polarity of every other level, so c2 ends up reversed.
+ */
+template <template <typename, typename, typename> class AdaptorType,
+          template <typename, typename...> class NPortAdaptorType,
+          int c2Polarity>
+struct NPortCircuit
+{
+    NPortCircuit() { vs.setVoltage (1.0); }
+
+    ResistiveVoltageSourceT<double> vs { 1.0e3 };
+    CapacitorT<double> c1 { 1.0e-6 };
+    InductorT<double> l1 { 10.0e-3 };
+    ResistorT<double> r1 { 4.7e3 };
+    CapacitorT<double> c2 { 47.0e-9 };
+
+    AdaptorType<double, decltype (c2), decltype (r1)> a1 { c2, r1 };
+    AdaptorType<double, decltype (l1), decltype (a1)> a2 { l1, a1 };
+    AdaptorType<double, decltype (c1), decltype (a2)> a3 { c1, a2 };
+    AdaptorType<double, decltype (vs), decltype (a3)> chain { vs, a3 };
+
+    ResistiveVoltageSourceT<double> vsN { 1.0e3 };
+    CapacitorT<double> c1N { 1.0e-6 };
+    InductorT<double> l1N { 10.0e-3 };
+    ResistorT<double> r1N { 4.7e3 };
+    CapacitorT<double> c2N { 47.0e-9 };
+    NPortAdaptorType<double, decltype (vsN), decltype (c1N), decltype (l1N), decltype (r1N), decltype (c2N)> nPort { vsN, c1N, l1N, r1N, c2N };
+
+    void checkOutputs()
+    {
+        vsN.setVoltage (1.0);
+        REQUIRE (nPort.wdf.R == Approx (chain.wdf.R));
+        for (int n = 0; n < 1000; ++n)
+        {
+            const auto a = std::sin (0.05 * (double) n);
+            REQUIRE (nPort.reflected() == Approx (chain.reflected()).margin (1.0e-9));
+            chain.incident (a);
+            nPort.incident (a);
+
+            REQUIRE (voltage<double> (c2N) == Approx ((double) c2Polarity * voltage<double> (c2)).margin (1.0e-9));
+            REQUIRE (current<double> (l1N) == Approx (current<double> (l1)).margin (1.0e-9));
+        }
+    }
+};
+
+template <typename CircuitType>
+void checkNPortAdaptor()
+{
+    CircuitType circuit;
+    circuit.checkOutputs();
+
+    circuit.r1.setResistanceValue (100.0);
+    circuit.r1N.setResistanceValue (100.0);
+    circuit.c1.setCapacitanceValue (10.0e-6);
+    circuit.c1N.setCapacitanceValue (10.0e-6);
+    circuit.checkOutputs();
+
+    REQUIRE (&circuit.nPort.template getPort<3>() == &circuit.r1N);
+}
+} // namespace
+
+TEST_CASE ("N-Port Adaptors Test")
+{
+    SECTION ("Series")
+    {
+        checkNPortAdaptor<NPortCircuit<WDFSeriesT, WDFSeriesNT, -1>>();
+    }
+
+    SECTION ("Parallel")
+    {
+        checkNPortAdaptor<NPortCircuit<WDFParallelT, WDFParallelNT, 1>>();
+    }
+}